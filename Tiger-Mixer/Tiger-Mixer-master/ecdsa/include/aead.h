@@ -0,0 +1,38 @@
+/**
+ * ChaCha20-Poly1305 AEAD（RFC 8439）
+ *
+ * 混合分享模式用它加密载荷：VSS 只分享 32 字节的对称密钥，载荷加密一次后作为单个密文随分片发送。
+ * RELIC 只提供 AES-CBC 与 HMAC，这里给出自包含的实现，不依赖 OpenSSL。
+ */
+
+#ifndef AEAD_H
+#define AEAD_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define AEAD_KEY_SIZE    32
+#define AEAD_NONCE_SIZE  12
+#define AEAD_TAG_SIZE    16
+
+/**
+ * 加密并认证
+ * @param out 输出 [密文(len)][tag(16)]，容量至少 len + AEAD_TAG_SIZE，可与 in 相同
+ * @param ad  附加认证数据，可为 NULL（ad_len 为 0）
+ * @return RLC_OK 成功，RLC_ERR 参数错误
+ */
+int aead_encrypt(uint8_t *out, const uint8_t *in, size_t len,
+                 const uint8_t *ad, size_t ad_len,
+                 const uint8_t nonce[AEAD_NONCE_SIZE], const uint8_t key[AEAD_KEY_SIZE]);
+
+/**
+ * 校验并解密
+ * @param in     [密文][tag(16)]，in_len >= AEAD_TAG_SIZE
+ * @param out    输出明文，容量至少 in_len - AEAD_TAG_SIZE；tag 不匹配时不写入
+ * @return RLC_OK 成功，RLC_ERR tag 不匹配或参数错误
+ */
+int aead_decrypt(uint8_t *out, const uint8_t *in, size_t in_len,
+                 const uint8_t *ad, size_t ad_len,
+                 const uint8_t nonce[AEAD_NONCE_SIZE], const uint8_t key[AEAD_KEY_SIZE]);
+
+#endif // AEAD_H
@@ -12,6 +12,16 @@
 // Auditor 的主要功能是审计和重构秘密分享
 // 它不需要处理复杂的协议消息，主要是读取和解析数据
 
+// 监控模式的并行审计：多个审计线程同时处理可疑交易，每个线程持有独立的审计状态与 PARI 栈
+#define AUDITOR_DEFAULT_WORKERS       4
+#define AUDITOR_MAX_WORKERS           32
+#define AUDITOR_WORKER_PARI_STACK     10000000
+// 按 msgid 取分片时等待接收者应答的上限（毫秒），超时后用已收到的分片继续
+#define AUDITOR_FETCH_TIMEOUT_MS      30000
+// 凑齐分片后关闭未应答接收者的 socket 时保留的 linger（毫秒）：连接尚未建立时请求还在本地队列中，
+// 给它一点时间发出，接收者才能记录决策（参与度统计依赖这些决策）
+#define AUDITOR_UNANSWERED_LINGER_MS  2000
+
 typedef struct {
   ec_public_key_t alice_ec_pk;
   ec_public_key_t bob_ec_pk;
@@ -163,6 +173,8 @@ int read_alice_bob_tumbler_public_keys(auditor_state_t state);
 
 // VSS 相关函数
 int verify_share_with_stored_commitment(auditor_state_t state, const secret_share_t* share, const char* msgid);
+int verify_shares_with_stored_commitment(auditor_state_t state, const secret_share_t* shares, size_t num_shares,
+                                         const char* msgid, size_t* bad_index);
 int start_vss_commitment_server(auditor_state_t state);
 
 #endif // A2L_ECDSA_INCLUDE_AUDITOR 
\ No newline at end of file
@@ -0,0 +1,68 @@
+/**
+ * BN254（alt_bn128）曲线上的群运算与配对检查
+ *
+ * Tornado 的 Groth16 证明建立在 BN254 上。RELIC 在本项目中以 FP_PRIME=256 编译（secp256k1 与
+ * BN-P256），同一个构建里无法再提供 BN254 的配对，因此这里单独实现：
+ *   - Fp 为 4×64 位 Montgomery 表示，Fp2 = Fp[u]/(u^2+1)，Fp6 = Fp2[v]/(v^3-(9+u))，Fp12 = Fp6[w]/(w^2-v)；
+ *   - G1: y^2 = x^3 + 3，G2 为 D 型扭曲线 y^2 = x^3 + 3/(9+u)，均使用仿射坐标；
+ *   - 最优 ate 配对，多个配对共用一次 Miller 循环的平方与一次最终幂。
+ *
+ * 坐标的十进制字符串格式与 snarkjs 的 JSON 相同：G2 坐标写作 [c0, c1]。
+ * 所有函数在首次调用时初始化常量，可在多线程中直接使用。
+ */
+
+#ifndef BN254_H
+#define BN254_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 标量（群阶 r 以内的整数）与坐标的字节长度
+#define BN254_BYTES  32
+
+typedef struct {
+  uint64_t v[4];
+} bn254_fp_t;
+
+typedef struct {
+  bn254_fp_t c0, c1;
+} bn254_fp2_t;
+
+typedef struct {
+  bn254_fp_t x, y;
+  int inf;                // 1 表示无穷远点
+} bn254_g1_t;
+
+typedef struct {
+  bn254_fp2_t x, y;
+  int inf;
+} bn254_g2_t;
+
+/**
+ * 由十进制坐标构造 G1 点，检查坐标小于 p 且在曲线上；(0, 0) 表示无穷远点
+ * @return RLC_OK 成功，RLC_ERR 格式错误或不在曲线上
+ */
+int bn254_g1_from_dec(bn254_g1_t *p, const char *x, const char *y);
+
+/**
+ * 由十进制坐标构造 G2 点，额外检查点在阶为 r 的子群中
+ */
+int bn254_g2_from_dec(bn254_g2_t *q, const char *x0, const char *x1, const char *y0, const char *y1);
+
+/**
+ * 十进制字符串（也接受 0x 开头的十六进制）转成 32 字节大端整数
+ * @param below_r 非零时要求数值小于群阶 r
+ */
+int bn254_scalar_from_dec(uint8_t out[BN254_BYTES], const char *dec, int below_r);
+
+void bn254_g1_add(bn254_g1_t *r, const bn254_g1_t *a, const bn254_g1_t *b);
+void bn254_g1_neg(bn254_g1_t *r, const bn254_g1_t *a);
+void bn254_g1_mul(bn254_g1_t *r, const bn254_g1_t *a, const uint8_t k[BN254_BYTES]);
+
+/**
+ * 检查 e(p[0], q[0]) · ... · e(p[n-1], q[n-1]) == 1
+ * @return 1 成立，0 不成立
+ */
+int bn254_pairing_check(const bn254_g1_t *p, const bn254_g2_t *q, size_t n);
+
+#endif // BN254_H
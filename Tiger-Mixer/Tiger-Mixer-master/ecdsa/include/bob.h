@@ -113,6 +113,7 @@ typedef struct {
   char commitment[67];        // commitment (32 bytes hex string with 0x prefix)
   char escrow_tx_hash[67];   // escrow transaction hash (从 Alice 接收)
   char pool_contract[43];    // pool contract address (从 Alice 接收)
+  char mix_session_id[67];   // Tumbler 侧的会话 ID（即 Alice 的托管 ID，从 Alice 接收）
   
   // Tornado Cash zkSNARK 证明数据（Bob 生成，转发给 Tumbler）
   char tornado_proof_data[4608]; // proofData JSON: {"proof":{...},"publicSignals":[...]}
@@ -173,6 +174,7 @@ typedef bob_state_st *bob_state_t;
     zk_proof_puzzle_relation_new((state)->puzzle_relation_zk_proof); \
     cl_ciphertext_new((state)->enc_beta); \
     cl_ciphertext_new((state)->enc_beta_aud); \
+    (state)->mix_session_id[0] = '\0'; \
   } while (0)
 
 #define bob_state_free(state)                               \
@@ -0,0 +1,30 @@
+/**
+ * 检查程序（src 下的 *_check.c）共用的断言与汇总
+ *
+ * 每个检查程序是单独的可执行文件，只包含一次本头文件，失败计数是该程序内的静态变量。
+ * 逐项打印 [OK] / [FAIL]，最后由 check_summary 打印汇总并给出退出码（有失败时非 0）。
+ */
+
+#ifndef A2L_ECDSA_INCLUDE_CHECK
+#define A2L_ECDSA_INCLUDE_CHECK
+
+#include <stdio.h>
+
+static int check_failures = 0;
+
+#define EXPECT(cond, what)                                  \
+  do {                                                     \
+    if (cond) {                                            \
+      printf("  [OK]   %s\n", what);                       \
+    } else {                                               \
+      printf("  [FAIL] %s\n", what);                       \
+      check_failures++;                                    \
+    }                                                      \
+  } while (0)
+
+static inline int check_summary(void) {
+  printf("%s（%d 项失败）\n", check_failures == 0 ? "全部通过" : "存在失败", check_failures);
+  return check_failures == 0 ? 0 : 1;
+}
+
+#endif // A2L_ECDSA_INCLUDE_CHECK
@@ -0,0 +1,72 @@
+/**
+ * Class Group 元素与整数的二进制线格式编码
+ *
+ * 代替 GENtostr / gp_read_str 的十进制文本格式：
+ *   整数   : [sign:1][len:2, 大端][|x| 大端字节]
+ *   槽位   : [tag:1][编码体]，tag 为 CL_CODEC_TAG_INT / CL_CODEC_TAG_QFB / CL_CODEC_TAG_NONE
+ *   二次型 : 只传 (a, b)，c 由判别式 Delta = Delta_K * q^2 重算：c = (b^2 - Delta) / (4a)
+ *
+ * 固定长度槽位不足的部分补零，全零槽位表示"无值"（解码为 NULL）。
+ */
+
+#ifndef CL_CODEC_H
+#define CL_CODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "pari/pari.h"
+#include "types.h"
+
+#define CL_CODEC_TAG_NONE 0x00
+#define CL_CODEC_TAG_INT  'I'
+#define CL_CODEC_TAG_QFB  'Q'
+
+// 单个整数编码：sign + 2 字节长度 + 数值字节
+#define CL_CODEC_INT_BYTES(n)   (3 + (n))
+// 约化形式 |b| <= a <= sqrt(|Delta|/3)，Delta 约 2339 位，a、b 不超过 1170 位
+#define CL_CODEC_QFB_COMPONENT  160
+// 槽位大小（含 tag）
+#define CL_CODEC_INT_SIZE(n)    (1 + CL_CODEC_INT_BYTES(n))
+#define CL_CODEC_QFB_SIZE       (1 + 2 * CL_CODEC_INT_BYTES(CL_CODEC_QFB_COMPONENT))
+
+/**
+ * 计算编码后的长度（含 tag）
+ * @param x t_INT 或 t_QFB，NULL 表示无值
+ * @return 字节数；不支持的类型返回 0
+ */
+size_t cl_codec_size(GEN x);
+
+/**
+ * 在 dst + *off 处写入 x 的变长编码，并推进 *off
+ * @param cap dst 的总容量
+ * @return RLC_OK 成功，RLC_ERR 容量不足或类型不支持
+ */
+int cl_codec_put(uint8_t *dst, size_t cap, size_t *off, GEN x);
+
+/**
+ * 从 src + *off 处读取一个变长编码，并推进 *off
+ * @param len src 的总长度
+ * @param params CL 参数（用于重算二次型的 c）
+ * @return 解码结果（PARI 栈上分配）；无值或格式错误返回 NULL
+ */
+GEN cl_codec_get(const uint8_t *src, size_t len, size_t *off, const cl_params_t params);
+
+/**
+ * 把 x 写入固定长度槽位（补零）
+ * @return RLC_OK 成功，RLC_ERR 槽位放不下
+ */
+int cl_codec_write(uint8_t *dst, size_t slot, GEN x);
+
+/**
+ * 从固定长度槽位读取
+ * @return 解码结果；无值或格式错误返回 NULL
+ */
+GEN cl_codec_read(const uint8_t *src, size_t slot, const cl_params_t params);
+
+/**
+ * 按槽位写入/读取密文 (c1, c2)，并推进 *off
+ */
+int cl_codec_write_ct(uint8_t *dst, size_t *off, const cl_ciphertext_t ct);
+int cl_codec_read_ct(cl_ciphertext_t ct, const uint8_t *src, size_t *off, const cl_params_t params);
+
+#endif // CL_CODEC_H
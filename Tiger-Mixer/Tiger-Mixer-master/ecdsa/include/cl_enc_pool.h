@@ -0,0 +1,50 @@
+/**
+ * CL 加密的离线/在线拆分：后台随机数池
+ *
+ * cl_enc 的开销几乎全在 g_q^r 与 pk^r 两次幂运算上，而它们与明文无关。
+ * 池为登记过的公钥在后台线程中预先计算三元组 (r, g_q^r, pk^r)，
+ * 在线加密只剩 f^m 的构造与一次合成：c1 = g_q^r，c2 = pk^r * f^m。
+ *
+ * 每个三元组只使用一次（取出即从池中删除）。池空或公钥未登记时 cl_enc 退回在线计算。
+ * 三元组以 copy_bin 的二进制副本在线程间传递，后台线程拥有独立的 PARI 栈，
+ * 因此要求 RELIC 以 -DMULTI=PTHREAD、PARI 以 --mt=pthread 编译；否则 cl_enc_pool_start 返回 RLC_ERR。
+ */
+
+#ifndef CL_ENC_POOL_H
+#define CL_ENC_POOL_H
+
+#include "pari/pari.h"
+#include "types.h"
+
+// 最多登记的公钥数
+#define CL_ENC_POOL_MAX_KEYS    4
+// 每个公钥保留的三元组数
+#define CL_ENC_POOL_DEPTH       32
+// 后台线程的 PARI 栈大小
+#define CL_ENC_POOL_PARI_STACK  10000000
+
+/**
+ * 启动后台填充线程
+ * @param params CL 参数（须在 cl_enc_pool_stop 之前一直有效）
+ * @return RLC_OK 成功，RLC_ERR 失败或当前构建不支持多线程 PARI
+ */
+int cl_enc_pool_start(const cl_params_t params);
+
+/**
+ * 停止后台线程并丢弃池中所有三元组
+ */
+void cl_enc_pool_stop(void);
+
+/**
+ * 登记一个公钥，后台线程开始为其预计算三元组（重复登记无副作用）
+ * @return RLC_OK 成功，RLC_ERR 池未启动或已满
+ */
+int cl_enc_pool_register(const cl_public_key_t public_key);
+
+/**
+ * 为 public_key 取出一个预计算的三元组（结果复制到调用方的 PARI 栈上）
+ * @return RLC_OK 取到，RLC_ERR 池中没有可用的三元组
+ */
+int cl_enc_pool_take(GEN *r, GEN *g_q_r, GEN *pk_r, const cl_public_key_t public_key);
+
+#endif // CL_ENC_POOL_H
@@ -0,0 +1,79 @@
+/**
+ * Class Group 固定基幂运算（Lim–Lee 梳形法）
+ *
+ * 对固定底 g（如 g_q）预计算 w 个“梳齿” G_j = g^(2^(j*d))，以及它们所有子集的乘积
+ * T[s] = prod_{j in s} G_j（共 2^w - 1 项）。指数 e 按 d 列、w 行排列后，
+ * g^e 只需 d 次平方和至多 d 次合成，而 nupow 需要约 bits 次平方。
+ *
+ * 表以 copy_bin 的二进制副本存放在 malloc 内存中，不受 avma 回收影响，可被多个线程只读共享、由任意线程释放。
+ */
+
+#ifndef CL_FIXED_BASE_H
+#define CL_FIXED_BASE_H
+
+#include "pari/pari.h"
+#include "types.h"
+
+// 默认梳齿数 w：表大小 2^w - 1 个二次型（w = 8 时约 128 KB）
+#define CL_FIXED_BASE_WINDOW  8
+// 表覆盖的指数位数 = bound 的位数 + 余量（覆盖 zk_cldl 中 r1 < bound * 2^40 及 u1 = r1 + k*r）
+#define CL_FIXED_BASE_MARGIN  128
+// 设置该环境变量时，generate_cl_params 从此路径加载 g_q 的表（不存在则构建后写入）
+#define CL_FIXED_BASE_PATH_ENV "A2L_CL_GQ_TABLE"
+
+/**
+ * 为底 base 构建固定基表
+ * @param out 输出表（调用方用 cl_fixed_base_free 释放）
+ * @param base 固定底（已约化的 t_QFB）
+ * @param bits 表覆盖的最大指数位数
+ * @param window 梳齿数 w（1..16）
+ * @return RLC_OK 成功，RLC_ERR 失败
+ */
+int cl_fixed_base_build(cl_fixed_base_t *out, GEN base, long bits, long window);
+
+/**
+ * 用固定基表计算 base^e
+ * 表为 NULL、底不匹配或 |e| 超出表的覆盖范围时退回 nupow
+ * @return base^e（PARI 栈上分配）
+ */
+GEN cl_fixed_base_pow(const cl_fixed_base_t table, GEN base, GEN e);
+
+/**
+ * g_q^e 的便捷入口：使用 params->g_q_table（若有）
+ */
+GEN cl_gq_pow(const cl_params_t params, GEN e);
+
+/**
+ * 为 params->g_q 构建固定基表并挂到 params 上
+ * @param path 表文件路径；非 NULL 时先尝试加载，加载失败则构建后写回
+ */
+int cl_params_precompute(cl_params_t params, const char *path);
+
+/**
+ * 公钥固定基表缓存
+ *
+ * 加密与证明中的 pk^r 几乎总是落在少数几个长期公钥上（tumbler、auditor、auditor2）。
+ * 缓存按公钥值记录使用次数，达到 CL_PK_CACHE_THRESHOLD 次后为其构建固定基表；
+ * 最多保留 CL_PK_CACHE_CAPACITY 个公钥，满时按 LRU 淘汰（正在使用的表不会被淘汰）。
+ * 内存上限约为 CL_PK_CACHE_CAPACITY 张表。线程安全。
+ */
+#define CL_PK_CACHE_CAPACITY   8
+#define CL_PK_CACHE_THRESHOLD  3
+
+/**
+ * 计算 public_key^e，必要时使用（或构建）该公钥的固定基表
+ */
+GEN cl_pk_pow(const cl_public_key_t public_key, GEN e, const cl_params_t params);
+
+/**
+ * 清空公钥表缓存（释放所有未在使用中的表）
+ */
+void cl_pk_cache_clear(void);
+
+/**
+ * 表的磁盘格式：[magic:4][window:2][spacing:4][count:4] 之后为 count 个 cl_codec 编码的二次型
+ */
+int cl_fixed_base_save(const cl_fixed_base_t table, const char *path);
+int cl_fixed_base_load(cl_fixed_base_t *out, GEN base, const char *path, const cl_params_t params);
+
+#endif // CL_FIXED_BASE_H
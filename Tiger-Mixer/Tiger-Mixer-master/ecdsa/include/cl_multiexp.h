@@ -0,0 +1,32 @@
+/**
+ * Class Group 多重幂运算 prod_i b_i^{e_i}
+ *
+ * 逐项 nupow 再 gmul 时每个底各自做一遍约 bits 次平方。这里所有底共享同一串平方：
+ *   - 底较少时用 Straus 交错窗口法：每个底预计算 b^1..b^(2^w-1)，每个窗口一次 w 次平方 + 每底至多一次合成；
+ *   - 底较多时用 Pippenger 桶方法：每个窗口把底按数字放入桶中，再用前缀和合并，不需要逐底预计算。
+ *
+ * 所有底须属于同一判别式。负指数通过取逆处理。
+ */
+
+#ifndef CL_MULTIEXP_H
+#define CL_MULTIEXP_H
+
+#include "pari/pari.h"
+
+// 底的个数达到该值时改用 Pippenger
+#define CL_MULTIEXP_PIPPENGER_MIN  32
+
+/**
+ * 计算 prod_i bases[i]^exps[i]
+ * @param bases t_VEC，元素为 t_QFB（至少一个）
+ * @param exps t_VEC，元素为 t_INT，长度与 bases 相同
+ * @return 乘积（PARI 栈上分配）；指数全为 0 时返回单位元
+ */
+GEN cl_multiexp(GEN bases, GEN exps);
+
+/**
+ * b1^e1 * b2^e2 的便捷入口
+ */
+GEN cl_multiexp2(GEN b1, GEN e1, GEN b2, GEN e2);
+
+#endif // CL_MULTIEXP_H
@@ -0,0 +1,60 @@
+/**
+ * 类群运算的工作线程池
+ *
+ * PARI 只在主线程 pari_init 一次，此前所有类群运算都在调用线程上串行执行。池中每个线程都有独立的
+ * PARI 栈（pari_thread_start）与 RELIC 上下文，可以把互相独立的验证（例如 zk_cldl_verify 的两个
+ * 类群等式、complete_nizk_verify 的各个子证明）分发出去并行计算。
+ *
+ * cl_worker_run 把一组任务交给池，调用线程自己也领取任务，直到全部完成才返回；因此任务可以只读地
+ * 引用调用方 PARI 栈上的 GEN，任务中再次调用 cl_worker_run 也不会死锁。池线程的结果以 copy_bin
+ * 的二进制副本传回，复制到调用方的 PARI 栈上。
+ *
+ * 要求 RELIC 以 -DMULTI=PTHREAD、PARI 以 --mt=pthread 编译；否则 cl_worker_pool_start 返回 RLC_ERR，
+ * cl_worker_run 在调用线程上依次执行所有任务。
+ */
+
+#ifndef CL_WORKER_POOL_H
+#define CL_WORKER_POOL_H
+
+#include <stddef.h>
+#include "pari/pari.h"
+
+// 池线程数上限
+#define CL_WORKER_POOL_MAX_THREADS  64
+// 每个池线程的 PARI 栈大小
+#define CL_WORKER_POOL_PARI_STACK   10000000
+
+/**
+ * 任务：fn(arg) 返回结果 GEN，返回 NULL 或抛出 PARI 异常表示失败
+ * fn 不得修改调用方栈上的 GEN；只返回真假的任务可以返回 gen_1 / gen_0
+ */
+typedef struct {
+  GEN (*fn)(void *arg);
+  void *arg;
+  GEN result;       // cl_worker_run 返回后有效（调用方 PARI 栈上），失败为 NULL
+  GENbin *bin;      // 内部使用：池线程结果的二进制副本
+} cl_worker_task_t;
+
+/**
+ * 启动 n_threads 个池线程（已启动时直接返回 RLC_OK）
+ * @return RLC_OK 成功，RLC_ERR 参数无效、线程创建失败或当前构建不支持多线程 PARI
+ */
+int cl_worker_pool_start(size_t n_threads);
+
+/**
+ * 停止并回收所有池线程；调用时不得有正在执行的 cl_worker_run
+ */
+void cl_worker_pool_stop(void);
+
+/**
+ * 当前池线程数（未启动为 0）
+ */
+size_t cl_worker_pool_size(void);
+
+/**
+ * 并行执行 tasks[0..n)，全部完成后返回
+ * @return RLC_OK 所有任务都返回了非 NULL 结果，否则 RLC_ERR
+ */
+int cl_worker_run(cl_worker_task_t *tasks, size_t n);
+
+#endif // CL_WORKER_POOL_H
@@ -0,0 +1,46 @@
+/**
+ * 进程内 DBSCAN 聚类（欧氏距离，k-d 树邻域索引）
+ *
+ * 取代 auditor_detection 经临时 JSON 文件调用 dbscan_clustering.py（scikit-learn）的做法，
+ * 结果与 sklearn.cluster.DBSCAN(eps, min_samples) 一致：
+ *   - 距离 <= eps 的点是邻居，邻域包含点自身，邻居数 >= min_samples 的点是核心点；
+ *   - 按下标顺序从尚未归类的核心点开始扩展簇，簇编号按其第一个核心点的下标递增；
+ *   - 边界点归属最先扩展到它的簇，其余点为噪声（DBSCAN_NOISE）。
+ *
+ * 每个点只做一次计数查询（达到 min_samples 即停止）和至多一次扩展查询，不保存完整邻域表。
+ * 不依赖其它模块，auditor_detection 单独链接本文件。
+ */
+
+#ifndef DBSCAN_H
+#define DBSCAN_H
+
+#include <stddef.h>
+
+#define DBSCAN_NOISE     (-1)
+#define DBSCAN_LEAF_SIZE 16    // k-d 树中不再划分、直接线性比较的区间大小
+
+// 可疑判定的异常分数：离群点最高；所在簇小于总点数的 DBSCAN_SMALL_CLUSTER_RATIO 时次之
+#define DBSCAN_NOISE_SCORE          1.0
+#define DBSCAN_SMALL_CLUSTER_SCORE  0.7
+#define DBSCAN_SMALL_CLUSTER_RATIO  0.05
+
+/**
+ * 对 n 个 dim 维点聚类
+ * @param points 行优先存放的 n * dim 个坐标
+ * @param labels 输出，长度 n：簇编号（从 0 开始）或 DBSCAN_NOISE
+ * @return 簇的个数，参数错误或内存不足返回 -1
+ */
+int dbscan_fit(const double *points, size_t n, size_t dim, double eps, size_t min_samples, int *labels);
+
+/**
+ * 按聚类结果计算每个点的异常分数（auditor_detection 的可疑判定规则）
+ *   - 离群点：DBSCAN_NOISE_SCORE；
+ *   - 所在簇的大小 < max(1, (int)(n * DBSCAN_SMALL_CLUSTER_RATIO))：DBSCAN_SMALL_CLUSTER_SCORE；
+ *   - 其它：0，分数大于 0 的点即为可疑。
+ * @param labels dbscan_fit 输出的 n 个标签
+ * @param scores 输出，长度 n
+ * @return 可疑点的个数，内存不足返回 -1
+ */
+int dbscan_anomaly_scores(const int *labels, size_t n, double *scores);
+
+#endif // DBSCAN_H
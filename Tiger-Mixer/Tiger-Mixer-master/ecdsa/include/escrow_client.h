@@ -0,0 +1,147 @@
+/**
+ * FixedMixerEscrow 合约的 JSON-RPC 客户端
+ *
+ * 取代每次托管操作都 popen 一次 `npx truffle exec scripts/xxx.js`（每次都要冷启动 Node 与 Truffle、
+ * 重新编译/加载 artifacts）。客户端常驻进程内：
+ *   - 一个 keep-alive 的 curl 句柄直接向节点发送 JSON-RPC（默认 http://127.0.0.1:7545，
+ *     可用环境变量 A2L_ESCROW_RPC 覆盖）；
+ *   - 函数选择器与 ABI 编码在本地完成（keccak256 在本文件实现）；
+ *   - confirm 所需的 v 值在本地做公钥恢复得到，不再逐个调用 recoverSignerFromSHA256；
+ *   - 默认用节点已解锁的账户 eth_sendTransaction 发送（与 truffle 脚本行为一致）；
+ *     设置 A2L_ESCROW_LOCAL_SIGN=1 时改为用调用方的 ECDSA 私钥在本地签名 EIP-155 交易，
+ *     通过 eth_sendRawTransaction 发送，发送方为该私钥对应的地址；
+ *   - 发送后轮询回执，status 不是 0x1 视为失败（与 truffle 抛出 revert 一致）。
+ *
+ * 请求在客户端互斥锁内串行执行，tumbler 的多个工作线程可以共享同一个客户端；等待回执时
+ * 两次轮询之间释放锁，一个会话等待出块不会阻塞其它会话的托管操作。
+ */
+
+#ifndef ESCROW_CLIENT_H
+#define ESCROW_CLIENT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "/home/zxx/Config/relic/include/relic.h"
+
+#define ESCROW_CLIENT_DEFAULT_RPC      "http://127.0.0.1:7545"
+// 与 truffle-config.js 中 private 网络一致
+#define ESCROW_CLIENT_GAS              6721975
+#define ESCROW_CLIENT_GAS_PRICE        1
+// 固定面额池地址簿（可用环境变量 A2L_ESCROW_ADDRESS_BOOK 覆盖）与 deposit 交易哈希文件（与 truffle 脚本共用）
+#define ESCROW_CLIENT_ADDRESS_BOOK     "/home/zxx/Config/truffleProject/truffletest/scripts/deployed-addresses.json"
+#define ESCROW_CLIENT_DEPOSIT_TX_FILE  "/home/zxx/Config/truffleProject/truffletest/deposit_tx_hashes.json"
+// 等待回执的最长时间（毫秒）与轮询间隔
+#define ESCROW_CLIENT_RECEIPT_TIMEOUT_MS  120000
+#define ESCROW_CLIENT_RECEIPT_POLL_MS     200
+
+// 以太坊字符串长度（含 0x 与结尾 '\0'）
+#define ESCROW_HASH_STR_LEN     67
+#define ESCROW_ADDRESS_STR_LEN  43
+// 未压缩 secp256k1 公钥长度
+#define ESCROW_PUBKEY_LEN       65
+
+typedef struct escrow_client_st *escrow_client_t;
+
+// openEscrow 的参数；十六进制串允许不足 32 字节（左补零，与脚本的 toBytes32 一致）
+typedef struct {
+  const char *pool_label;   // 固定面额池标识（"0.1"/"0_1"/"1"/"10"/"100"）
+  const char *escrow_id;
+  const char *party1;
+  const char *party2;
+  long deadline;            // 不晚于链上时间 + 5 秒时改为链上时间 + 3600（与脚本一致）
+  const char *meta_hash;
+  uint8_t party1_key[ESCROW_PUBKEY_LEN];  // 写入合约的未压缩公钥 0x04||X||Y
+  uint8_t party2_key[ESCROW_PUBKEY_LEN];
+  const char *commitment;   // Tornado commitment，必须是 0x + 64 位十六进制
+} escrow_open_args_t;
+
+/**
+ * 创建客户端
+ * @param rpc_url 节点地址，NULL 时取 A2L_ESCROW_RPC，未设置则为 ESCROW_CLIENT_DEFAULT_RPC
+ * @return 客户端，失败返回 NULL
+ */
+escrow_client_t escrow_client_new(const char *rpc_url);
+
+void escrow_client_free(escrow_client_t client);
+
+/**
+ * 进程内共享的客户端（首次调用时创建）；进程退出前可调用 escrow_client_shared_close 释放
+ */
+escrow_client_t escrow_client_shared(void);
+void escrow_client_shared_close(void);
+
+/**
+ * 从地址簿解析固定面额池合约地址
+ * @return RLC_OK 成功，RLC_ERR 地址簿不可读或没有该池
+ */
+int escrow_pool_address(char out[ESCROW_ADDRESS_STR_LEN], const char *pool_label);
+
+/**
+ * 调用 openEscrow（value 为池的 denomination()），等待回执，并把交易哈希追加到 deposit 交易哈希文件
+ * @param from 节点已解锁的发送账户；启用本地签名时忽略
+ * @param sk   发送方私钥，启用本地签名时使用，可为 NULL
+ * @param tx_hash 输出交易哈希
+ * @return RLC_OK 成功，RLC_ERR 参数无效、RPC 失败或交易 revert
+ */
+int escrow_open(escrow_client_t client, const escrow_open_args_t *args, const char *from, const bn_t sk,
+                char tx_hash[ESCROW_HASH_STR_LEN]);
+
+/**
+ * 调用 setDataHash(escrowId, dataHash)
+ * @param tx_hash 输出交易哈希，可为 NULL
+ */
+int escrow_set_data_hash(escrow_client_t client, const char *pool_label, const char *escrow_id,
+                         const char *data_hash, const char *from, const bn_t sk,
+                         char tx_hash[ESCROW_HASH_STR_LEN]);
+
+/**
+ * 调用 confirm：读取 escrows(escrowId) 得到签名消息 escrowIdCopy||dataHash 与双方公钥，
+ * 把 s 归一化为低 s，本地恢复出与双方公钥匹配的 v，然后发送交易
+ * @param r1,s1 party1 对消息的 ECDSA 签名（SHA-256）
+ * @param r2,s2 party2 的签名
+ * @param tx_hash 输出交易哈希，可为 NULL
+ */
+int escrow_confirm(escrow_client_t client, const char *pool_label, const char *escrow_id,
+                   const bn_t r1, const bn_t s1, const bn_t r2, const bn_t s2,
+                   const char *from, const bn_t sk, char tx_hash[ESCROW_HASH_STR_LEN]);
+
+/* ---------------- 编码（客户端内部使用，也供已知答案检查） ---------------- */
+
+// EIP-155 交易字段
+typedef struct {
+  uint64_t nonce;
+  uint64_t gas_price;
+  uint64_t gas;
+  uint8_t to[20];
+  uint8_t value[32];        // 大端
+  const uint8_t *data;
+  size_t data_len;
+  uint64_t chain_id;
+} escrow_tx_t;
+
+/**
+ * 以太坊 Keccak-256
+ */
+void escrow_keccak256(uint8_t out[32], const uint8_t *in, size_t len);
+
+/**
+ * 函数选择器：keccak256(signature) 的前 4 字节，例如 "transfer(address,uint256)" 为 a9059cbb
+ */
+void escrow_selector(uint8_t out[4], const char *signature);
+
+/**
+ * EIP-155 签名哈希 keccak256(rlp([nonce, gasPrice, gas, to, value, data, chainId, 0, 0]))
+ * @return RLC_OK 成功，RLC_ERR 内存不足
+ */
+int escrow_tx_signing_hash(uint8_t digest[32], const escrow_tx_t *tx);
+
+/**
+ * 已签名交易 rlp([nonce, gasPrice, gas, to, value, data, v, r, s])：s 归一化为低 s，
+ * v = chainId * 2 + 35 + recid，recid 由 (r, s) 恢复出 pk 得到
+ * @param out 输出，由调用方 free
+ * @return RLC_OK 成功，RLC_ERR 签名与 pk 不匹配或内存不足
+ */
+int escrow_tx_encode_signed(uint8_t **out, size_t *out_len, const escrow_tx_t *tx,
+                            const bn_t r, const bn_t s, const ec_t pk);
+
+#endif // ESCROW_CLIENT_H
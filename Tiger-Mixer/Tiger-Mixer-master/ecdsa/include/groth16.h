@@ -0,0 +1,70 @@
+/**
+ * BN254 上的 Groth16 验证（Tornado 提款证明）
+ *
+ * 取代每次 promise 都 fork/exec `node scripts/verify_proof_locally.js`：验证密钥在启动时载入一次，
+ * 之后直接解析 {proof, publicSignals} 并在进程内检查
+ *   e(-A, B) · e(alpha, beta) · e(vk_x, gamma) · e(C, delta) == 1，vk_x = IC[0] + Σ s_i · IC[i]
+ * 四个配对共用一次 Miller 循环与最终幂（见 bn254.h）。
+ *
+ * JSON 格式与 snarkjs 一致：验证密钥的 vk_alpha_1（旧版 snarkjs 为 vk_alfa_1）、vk_beta_2、vk_gamma_2、
+ * vk_delta_2、IC；证明的 pi_a、pi_b、pi_c 为射影坐标，最后一个分量必须是 1（pi_b 为 ["1","0"]）。
+ * 公开输入必须小于群阶 r（与 Verifier 合约一致）。
+ */
+
+#ifndef GROTH16_H
+#define GROTH16_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "bn254.h"
+
+// 支持的公开输入个数上限（Tornado withdraw 电路为 6 个）
+#define GROTH16_MAX_PUBLIC  16
+
+typedef struct {
+  size_t n_public;
+  bn254_g1_t alpha;
+  bn254_g2_t beta, gamma, delta;
+  bn254_g1_t ic[GROTH16_MAX_PUBLIC + 1];
+} groth16_vk_st;
+
+typedef groth16_vk_st *groth16_vk_t;
+
+typedef struct {
+  bn254_g1_t a;
+  bn254_g2_t b;
+  bn254_g1_t c;
+  size_t n_public;
+  uint8_t signals[GROTH16_MAX_PUBLIC][BN254_BYTES];  // 公开输入，32 字节大端
+} groth16_proof_st;
+
+/**
+ * 解析验证密钥 JSON（snarkjs 的 verification_key.json）
+ * @return RLC_OK 成功，RLC_ERR 字段缺失、点不在曲线/子群上或公开输入过多
+ */
+int groth16_vk_parse(groth16_vk_t vk, const char *json);
+
+/**
+ * 从文件读取并解析验证密钥
+ */
+int groth16_vk_load(groth16_vk_t vk, const char *path);
+
+/**
+ * 解析 {"proof": {...}, "publicSignals": [...]}
+ * @return RLC_OK 成功，RLC_ERR 格式错误、点不合法或公开输入不小于 r
+ */
+int groth16_proof_parse(groth16_proof_st *proof, const char *json);
+
+/**
+ * 公开输入 i 的十六进制形式（0x + 64 位小写十六进制）
+ * @return RLC_OK 成功，RLC_ERR 下标越界
+ */
+int groth16_signal_hex(char out[2 * BN254_BYTES + 3], const groth16_proof_st *proof, size_t i);
+
+/**
+ * 验证证明
+ * @return RLC_OK 证明有效，RLC_ERR 公开输入个数不符或配对检查失败
+ */
+int groth16_verify(const groth16_vk_st *vk, const groth16_proof_st *proof);
+
+#endif // GROTH16_H
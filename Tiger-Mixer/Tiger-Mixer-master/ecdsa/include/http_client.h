@@ -0,0 +1,51 @@
+/**
+ * 进程内共享的异步 HTTP 客户端（libcurl multi）
+ *
+ * 取代 ZK 证明服务与 judge API 每次调用都 popen 一个 curl 进程（或每次 curl_global_init/easy_init）：
+ *   - 一个后台线程驱动 curl multi 句柄，连接缓存常驻，同一 host:port 的请求复用 keep-alive 连接；
+ *   - 每个 host:port 的并发连接数受 HTTP_CLIENT_MAX_PER_HOST 限制（环境变量 A2L_HTTP_MAX_PER_HOST 覆盖），
+ *     超出的请求在 libcurl 内排队，不会压垮单个服务；
+ *   - 请求体与响应都在内存中，不再经过 /tmp 临时文件；
+ *   - http_post_json_async 提交后立即返回，处理函数在需要结果时调用 http_request_wait 等待。
+ *
+ * 首次提交请求时自动启动后台线程，进程退出前可调用 http_client_shutdown。
+ */
+
+#ifndef HTTP_CLIENT_H
+#define HTTP_CLIENT_H
+
+#include <stddef.h>
+
+#define HTTP_CLIENT_MAX_PER_HOST        4
+#define HTTP_CLIENT_MAX_TOTAL           32
+#define HTTP_CLIENT_CONNECT_TIMEOUT_MS  5000
+#define HTTP_CLIENT_DEFAULT_TIMEOUT_MS  30000
+
+typedef struct http_request_st *http_request_t;
+
+/**
+ * 提交一个 Content-Type: application/json 的 POST 请求
+ * @param timeout_ms 整个请求的超时（毫秒），<= 0 时为 HTTP_CLIENT_DEFAULT_TIMEOUT_MS
+ * @return 请求句柄，必须且只能传给 http_request_wait 一次；失败返回 NULL
+ */
+http_request_t http_post_json_async(const char *url, const char *body, long timeout_ms);
+
+/**
+ * 等待请求完成并释放句柄
+ * @param status   输出 HTTP 状态码（传输失败时为 0），可为 NULL
+ * @param response 输出以 '\0' 结尾的响应体（调用方 free），可为 NULL
+ * @return RLC_OK 收到响应（任意状态码），RLC_ERR 连接失败、超时或客户端已关闭
+ */
+int http_request_wait(http_request_t req, long *status, char **response);
+
+/**
+ * 同步调用：提交并等待
+ */
+int http_post_json(const char *url, const char *body, long timeout_ms, long *status, char **response);
+
+/**
+ * 停止后台线程，未完成的请求以失败结束；之后再提交请求会重新启动
+ */
+void http_client_shutdown(void);
+
+#endif // HTTP_CLIENT_H
@@ -1,6 +1,11 @@
 #ifndef HTTP_ZK_CLIENT_H
 #define HTTP_ZK_CLIENT_H
 
+#include "http_client.h"
+
+// 零知识证明服务地址
+#define ZK_PROOF_SERVICE_URL  "http://127.0.0.1:8080/generate-proof"
+
 // 调用零知识证明 HTTP 服务
 // 参数：
 //   alpha_str: alpha 的字符串表示
@@ -11,4 +16,12 @@
 //   -1: 失败
 int call_zk_proof_service(const char *alpha_str, const char *g_alpha_x_str, const char *g_alpha_y_str);
 
+// 异步提交证明请求（通过共享 HTTP 客户端），用 zk_proof_request_wait 等待结果
+// proof_type 为 NULL 时为 "alpha_knowledge"
+http_request_t zk_proof_request_start(const char *alpha_str, const char *g_alpha_x_str,
+                                      const char *g_alpha_y_str, const char *proof_type);
+
+// 等待证明请求完成；返回 0 表示服务返回 200，-1 表示失败
+int zk_proof_request_wait(http_request_t req, const char *proof_type);
+
 #endif // HTTP_ZK_CLIENT_H
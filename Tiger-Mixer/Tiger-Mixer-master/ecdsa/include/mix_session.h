@@ -0,0 +1,42 @@
+#ifndef A2L_ECDSA_INCLUDE_MIX_SESSION
+#define A2L_ECDSA_INCLUDE_MIX_SESSION
+
+#include <stddef.h>
+#include <string.h>
+#include "/home/zxx/Config/relic/include/relic.h"
+#include "zmq.h"
+
+/**
+ * 混币会话标识（session id）
+ *
+ * 一次混币会话横跨 Alice 与 Bob 发给 Tumbler 的多条消息
+ * （registration → promise_init → payment_init → layered_proof_share → bob_confirm_done），
+ * 以 Alice 随机生成的托管 ID（0x + 64 hex）作为会话标识。
+ *
+ * 线格式：客户端（REQ）在协议消息之前先发送一帧会话 ID（ZMQ_SNDMORE），
+ * 即 [session_id][serialized message]。只有一帧的旧格式请求归入默认会话。
+ */
+#define MIX_SESSION_ID_SIZE     67
+#define MIX_SESSION_DEFAULT_ID  "default"
+
+/**
+ * 在协议消息之前发送会话 ID 帧
+ * @param socket 连接到 Tumbler 的 REQ socket
+ * @param session_id 会话 ID；为空串时不发送（走默认会话）
+ * @return RLC_OK 成功，RLC_ERR 失败
+ */
+static inline int mix_session_send_id(void *socket, const char *session_id) {
+  if (session_id == NULL || session_id[0] == '\0') {
+    return RLC_OK;
+  }
+  size_t len = strlen(session_id);
+  if (len >= MIX_SESSION_ID_SIZE) {
+    return RLC_ERR;
+  }
+  if (zmq_send(socket, session_id, len, ZMQ_SNDMORE) != (int) len) {
+    return RLC_ERR;
+  }
+  return RLC_OK;
+}
+
+#endif // A2L_ECDSA_INCLUDE_MIX_SESSION
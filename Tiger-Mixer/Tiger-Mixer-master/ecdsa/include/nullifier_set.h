@@ -0,0 +1,60 @@
+/**
+ * 已使用 nullifierHash 的内存索引（防止 Tornado 提款证明被重复使用）
+ *
+ * 启动时从快照与追加日志载入一次，之后：
+ *   - 查询为 O(1) 的开放寻址哈希查找，不加锁（槽位以原子标志发布，扩容时整表替换）；
+ *   - 插入在互斥锁内完成“检查 + 写日志 + fsync + 放入哈希表”，并发会话不会把同一个 nullifier 插入两次；
+ *   - 日志为文本，每行一个 0x 开头的 64 位十六进制数，兼容原先的 nullifier_hashes.txt；
+ *   - 日志条目达到 NULLIFIER_SET_COMPACT_THRESHOLD 时压缩为排好序的二进制快照，然后清空日志。
+ *
+ * nullifier 统一按 256 位整数比较：忽略 0x 前缀、大小写与前导零。
+ */
+
+#ifndef NULLIFIER_SET_H
+#define NULLIFIER_SET_H
+
+#include <stddef.h>
+
+#define NULLIFIER_SET_KEY_LEN            32
+// 日志中累计的条目数达到该值时自动压缩为快照
+#define NULLIFIER_SET_COMPACT_THRESHOLD  4096
+
+typedef struct nullifier_set_st *nullifier_set_t;
+
+/**
+ * 打开索引：载入 snapshot_path（不存在则跳过）并重放 log_path（不存在则创建）
+ * 日志末尾写了一半的行会被修复；快照损坏或截断、日志中间有无法解析的行都视为失败，
+ * 调用方不应在没有索引的情况下接受提款
+ * @return 索引，失败返回 NULL
+ */
+nullifier_set_t nullifier_set_open(const char *log_path, const char *snapshot_path);
+
+/**
+ * 关闭日志并释放索引；调用时不得有并发的查询或插入
+ */
+void nullifier_set_close(nullifier_set_t set);
+
+/**
+ * 查询 nullifier 是否已使用（无锁）
+ * @return 1 已使用，0 未使用，-1 不是合法的十六进制 nullifier
+ */
+int nullifier_set_contains(const nullifier_set_t set, const char *nullifier_hex);
+
+/**
+ * 记录 nullifier：先追加到日志并 fsync，再放入哈希表
+ * @return 1 新插入，0 已存在（重复使用），-1 格式错误或写日志失败
+ */
+int nullifier_set_insert(nullifier_set_t set, const char *nullifier_hex);
+
+/**
+ * 把当前全部 nullifier 排序写成二进制快照（先写临时文件再 rename），然后清空日志
+ * @return RLC_OK 成功，RLC_ERR 失败（日志保持不变）
+ */
+int nullifier_set_compact(nullifier_set_t set);
+
+/**
+ * 已记录的 nullifier 数
+ */
+size_t nullifier_set_size(const nullifier_set_t set);
+
+#endif // NULLIFIER_SET_H
@@ -0,0 +1,34 @@
+/**
+ * 按请求回收 PARI 栈
+ *
+ * 长期运行的服务（tumbler、auditor 监控模式）在请求开始时记下 avma，结束时把需要跨请求保留的 GEN
+ * （会话中的密文与证明）复制到 malloc 内存，再把 avma 恢复到请求开始处。这样 PARI 栈只需容纳单个请求的
+ * 峰值，不随处理过的会话数增长。
+ *
+ * 需要保留的 GEN 以槽位（GEN*）列表给出：pari_arena_persist 把它们整体复制成一个 GENbin，
+ * 并把每个槽位改写为指向副本；上一次的 GENbin 随后释放。值为 NULL 的槽位保持不变。
+ */
+
+#ifndef PARI_ARENA_H
+#define PARI_ARENA_H
+
+#include <stddef.h>
+#include "pari/pari.h"
+
+/**
+ * 把 slots 指向的 GEN 复制到 *store（替换并释放旧副本），并改写各槽位
+ * 调用后可以安全地把 avma 恢复到这些 GEN 分配之前的位置
+ */
+void pari_arena_persist(GENbin **store, GEN *const slots[], size_t n);
+
+/**
+ * 释放 *store（槽位中指向它的 GEN 随之失效）
+ */
+void pari_arena_release(GENbin **store);
+
+/**
+ * 当前线程 PARI 栈已使用的字节数
+ */
+size_t pari_arena_stack_used(void);
+
+#endif // PARI_ARENA_H
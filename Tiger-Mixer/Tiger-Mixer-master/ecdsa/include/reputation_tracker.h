@@ -14,6 +14,9 @@ int reputation_tracker_record_decision(const char* request_id, const char* user_
                                       const char* participant_address, int judge_result,
                                       const char* actual_decision);
 int reputation_tracker_calculate_and_save_stats(void);
+
+// 用全量重算校验增量聚合，返回不一致的地址数（-1=未初始化）
+int reputation_tracker_verify_stats(void);
 void reputation_tracker_cleanup(void);
 
 // 工具函数
@@ -8,11 +8,15 @@
 #include "relic.h"
 #include "util.h"  // 包含 RLC_EC_SIZE_COMPRESSED 定义
 #include "committee_integration.h"  // 添加委员会集成
+#include "aead.h"
 
 // 宏定义
 #define SECRET_SHARES 3
 #define THRESHOLD 2
-#define SHARE_SIZE 100000
+// 分享值是椭圆曲线阶上的标量，序列化后不超过 32 字节；
+// y 的格式为 [长度(4字节，小端)][大整数字节]
+#define SHARE_VALUE_MAX 32
+#define SHARE_Y_SIZE (4 + SHARE_VALUE_MAX)
 #define MAX_MESSAGE_SIZE 100000
 #define MSG_ID_MAXLEN 128
 #define BLOCK_SIZE 30  // 每个块30字节（留2字节余量，确保不超过椭圆曲线阶）
@@ -34,7 +38,7 @@ typedef struct {
     size_t block_index;  // 块索引（从0开始）
     // y值：椭圆曲线阶上的分享值（序列化为字节数组）
     // 格式：[长度(4字节)][大整数字节]
-    uint8_t y[SHARE_SIZE];  // 分享点的y坐标（bn_t的序列化形式）
+    uint8_t y[SHARE_Y_SIZE];  // 分享点的y坐标（bn_t的序列化形式）
     size_t data_length;  // 原始秘密总长度（字节数）
     size_t block_size;  // 当前块的大小（字节数）
     // receiver专用
@@ -105,12 +109,51 @@ int create_vss_commitments(const uint8_t* secret, size_t secret_len,
                           secret_share_t* shares, vss_commitment_t* commitment, const char* msgid);
 int verify_share_with_commitment(const secret_share_t* share, 
                                 const vss_commitment_t* commitment);
+// 批量验证同一承诺下的多个分片（可跨块、跨参与者），一次多标量乘法完成；
+// 失败时逐块回退，bad_index 输出第一个不合法分片的下标（可为 NULL）
+#define VSS_BATCH_WEIGHT_BITS 128
+int verify_shares_with_commitment_batch(const secret_share_t* shares, size_t num_shares,
+                                        const vss_commitment_t* commitment, size_t* bad_index);
 int send_vss_commitment_to_auditor(const vss_commitment_t* commitment);
 
-// 基于文件的 VSS 承诺存储
+// 基于文件的 VSS 承诺存储（二进制归档，见 vss_archive.h）
+#define VSS_JSON_EXPORT_ENV "A2L_VSS_JSON_EXPORT"  // 取值 "1" 时保存承诺的同时导出 JSON
 int save_vss_commitment_to_file(const vss_commitment_t* commitment);
 int load_vss_commitment_from_file(const char* msgid, vss_commitment_t* commitment);
 int list_vss_commitment_files(void);
+// 导出为 JSON（原文件格式），path 为 NULL 时写到 vss_commitments/vss_commitment_<msgid>.json
+int export_vss_commitment_json(const vss_commitment_t* commitment, const char* path);
+
+// ================= 混合模式：VSS 分享对称密钥 + AEAD 加密载荷 =================
+// 只对 32 字节密钥做 Feldman 分享（2 个块），载荷用 ChaCha20-Poly1305 加密一次，
+// 信封 [nonce(12)][密文][tag(16)] 以 msg_id 为附加数据，作为尾部随每个接收者的分片消息发送：
+//   ... 块数据 ... | SHARE_ENVELOPE_MAGIC(4) | 信封长度(4) | 信封
+// 不认识尾部的旧解析器按块数读完后忽略剩余字节
+#define SHARE_KEY_SIZE AEAD_KEY_SIZE
+#define SHARE_KEY_BLOCKS ((SHARE_KEY_SIZE + BLOCK_SIZE - 1) / BLOCK_SIZE)
+#define SHARE_ENVELOPE_MAGIC 0x31564e45u  // "ENV1"
+#define SHARE_ENVELOPE_TRAILER_HDR 8
+#define SHARE_ENVELOPE_OVERHEAD (AEAD_NONCE_SIZE + AEAD_TAG_SIZE)
+#define SHARE_MODE_ENV "A2L_SHARE_MODE"  // 取值 "hybrid" 时发送方启用混合模式
+
+// 环境变量 A2L_SHARE_MODE=hybrid 时返回 1
+int share_mode_hybrid(void);
+// 生成随机密钥并分享，加密 secret 得到信封（调用方 free）；commitment 非空时同时创建密钥的 VSS 承诺
+int create_hybrid_shares(const uint8_t* secret, size_t secret_len, const char* msgid,
+                         secret_share_t* shares, size_t* num_shares_out, vss_commitment_t* commitment,
+                         uint8_t** envelope_out, size_t* envelope_len_out);
+int send_hybrid_shares_to_receivers(secret_share_t* shares, size_t num_shares,
+                                    const uint8_t* envelope, size_t envelope_len,
+                                    const char* msg_id, const char** receiver_endpoints);
+// 由密钥分片重构密钥，依次尝试解密各接收者返回的不同信封，第一个通过认证的即为载荷；
+// 分片已对承诺验证过，伪造的信封无法通过 tag 校验。reconstructed_data 至少 MAX_MESSAGE_SIZE 字节
+int reconstruct_hybrid_secret(secret_share_t* shares, int share_count,
+                              const uint8_t* const* envelopes, const size_t* envelope_lens, int envelope_count,
+                              const char* msgid, uint8_t* reconstructed_data, size_t* data_length);
+// 写入信封尾部，返回写入字节数（SHARE_ENVELOPE_TRAILER_HDR + envelope_len）
+size_t write_share_envelope_trailer(uint8_t* out, const uint8_t* envelope, size_t envelope_len);
+// 解析 data 起始处的信封尾部，envelope 指向 data 内部；没有尾部或格式错误返回 -1
+int parse_share_envelope_trailer(const uint8_t* data, size_t size, const uint8_t** envelope, size_t* envelope_len);
 
 // 委员会相关函数
 int get_dynamic_endpoints(char endpoints[SECRET_SHARES][64]);
@@ -0,0 +1,40 @@
+/**
+ * 秘密分享并发分发器：常驻 ZMQ 上下文 + 持久 DEALER 连接
+ *
+ * 取代 send_shares_to_receivers 中"每次新建 context、逐个接收者 REQ 发送并阻塞等 ACK"的做法：
+ *   - 进程内一个 ZMQ 上下文和一个后台线程，按端点缓存 DEALER 套接字，连接跨调用复用；
+ *   - 一次分发中发往各接收者的消息同时发出（DEALER 向 REP 发送 [空帧][载荷]），
+ *     延迟变为最快 quorum 个接收者中的最大值，而不是所有接收者之和；
+ *   - share_dispatch 在收到 quorum 个 ACK（或全部结束）后立即返回，其余接收者由后台线程继续完成；
+ *   - 超过 SHARE_DISPATCH_ACK_TIMEOUT_MS 未应答时重建该端点的连接并重发，
+ *     最多 SHARE_DISPATCH_MAX_ATTEMPTS 次。
+ *
+ * 分发器持有载荷副本，调用方返回后即可释放自己的缓冲区。
+ * 发送方进程退出前应调用 share_dispatch_shutdown，让后台发送有机会完成。
+ */
+
+#ifndef SHARE_DISPATCH_H
+#define SHARE_DISPATCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SHARE_DISPATCH_ACK_TIMEOUT_MS   30000
+#define SHARE_DISPATCH_MAX_ATTEMPTS     3
+#define SHARE_DISPATCH_MAX_PEERS        16
+#define SHARE_DISPATCH_DRAIN_MS         60000
+
+/**
+ * 并发发送 n 条消息：payloads[i] 发往 endpoints[i]（端点为 NULL 或空串、载荷为 NULL 的项跳过）
+ * @param quorum 需要的 ACK 数，达到后立即返回
+ * @return 返回时已收到的 ACK 数；分发器不可用时返回 -1
+ */
+int share_dispatch(const char **endpoints, uint8_t **payloads, const size_t *lens, size_t n, size_t quorum);
+
+/**
+ * 等待后台未完成的发送（最多 drain_ms 毫秒，<= 0 时为 SHARE_DISPATCH_DRAIN_MS），
+ * 然后关闭所有连接与上下文；之后再分发会重新启动
+ */
+void share_dispatch_shutdown(long drain_ms);
+
+#endif // SHARE_DISPATCH_H
@@ -0,0 +1,73 @@
+/**
+ * 接收者分片存储：追加写的二进制日志 + mmap 的磁盘哈希索引
+ *
+ * 取代 SliceMessage/receiver_N.json（每块一行 JSON，审计时整文件 fgets + sscanf）：
+ *   - 一条分享消息（同一 msg_id、同一 x 的全部块）写成日志中的一条记录，带校验和；
+ *     混合模式的加密载荷信封原样附在记录末尾；同一 msg_id 的记录通过记录头中的 prev 偏移串成链；
+ *   - 索引文件是开放寻址哈希表，msg_id 的 64 位哈希 -> 最新记录偏移，直接 mmap 使用，
+ *     审计查询只读索引槽和链上的记录，与历史分片总数无关；
+ *   - 索引头记录"正常关闭"标志：打开时标志缺失（崩溃或掉电）则扫描日志重建索引，
+ *     只有日志尾部写了一半的最后一条记录被截掉，中间的记录损坏时拒绝打开、不改动日志；
+ *   - 日志 fsync 成批进行：累计 SHARE_STORE_SYNC_BATCH 条记录或距上次超过 SHARE_STORE_SYNC_MS 时同步；
+ *     追加时只检查条数和时间，调用方空闲等待时用 share_store_sync_timeout 作为超时，到期调用 share_store_sync；
+ *   - 日志为空且旧的 JSON 文件存在时，打开时一次性导入。
+ *
+ * 所有操作在内部互斥锁内完成。
+ */
+
+#ifndef SHARE_STORE_H
+#define SHARE_STORE_H
+
+#include <stddef.h>
+#include "secret_share.h"
+
+#define SHARE_STORE_SYNC_BATCH     16
+#define SHARE_STORE_SYNC_MS        1000
+#define SHARE_STORE_MIN_CAPACITY   1024
+
+typedef struct share_store_st *share_store_t;
+
+/**
+ * 打开存储：日志不存在则创建；索引缺失、损坏或上次未正常关闭时从日志重建
+ * 日志中间有损坏的记录时返回 NULL（不截断，避免丢掉其后的有效分片）
+ * @param legacy_json_path 旧格式 JSON 文件，日志为空时导入，可为 NULL
+ * @return 存储句柄，失败返回 NULL
+ */
+share_store_t share_store_open(const char *log_path, const char *index_path, const char *legacy_json_path);
+
+/**
+ * 同步日志、标记索引为正常关闭并释放句柄
+ */
+void share_store_close(share_store_t store);
+
+/**
+ * 追加一条分享消息（count 个块，x 取 shares[0].x），按批量策略 fsync
+ * @param envelope 混合模式的加密载荷信封，随记录原样保存，可为 NULL
+ * @return RLC_OK 成功，RLC_ERR 参数错误或写日志失败
+ */
+int share_store_append(share_store_t store, const char *msg_id, const char *address,
+                       const secret_share_t *shares, size_t count,
+                       const uint8_t *envelope, size_t envelope_len);
+
+/**
+ * 读取 msg_id、x 对应的全部块，按 block_index 升序输出；同一块出现多次时以最新记录为准
+ * 只输出 block_index < max_shares 的块
+ * @param envelope_out 输出最新的非空信封（调用方 free），没有时为 NULL；可为 NULL
+ * @return RLC_OK 至少找到一个块，RLC_ERR 未找到或读取失败
+ */
+int share_store_load(share_store_t store, const char *msg_id, int x,
+                     secret_share_t *shares, size_t max_shares, size_t *num_shares_out,
+                     uint8_t **envelope_out, size_t *envelope_len_out);
+
+/**
+ * 立即 fsync 日志
+ */
+int share_store_sync(share_store_t store);
+
+/**
+ * 距下一次必须 fsync 还有多少毫秒
+ * @return 没有未同步的记录时返回 -1（可无限等待），已到期返回 0
+ */
+long share_store_sync_timeout(share_store_t store);
+
+#endif // SHARE_STORE_H
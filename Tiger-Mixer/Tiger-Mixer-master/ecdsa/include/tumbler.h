@@ -4,8 +4,10 @@
 
 #include <stddef.h>
 #include <string.h>
+#include <time.h>
 #include "/home/zxx/Config/relic/include/relic.h"
 #include "zmq.h"
+#include "mix_session.h"
 #include "types.h"
 #include "gs.h"
 #include "util.h"
@@ -16,6 +18,18 @@
 
 #define TUMBLER_ENDPOINT  "tcp://*:8181"
 
+// 多会话服务：ROUTER 前端按会话 ID 把消息分派给工作线程，每个工作线程维护自己的会话表
+#define TUMBLER_DEFAULT_WORKERS       4
+#define TUMBLER_MAX_WORKERS           64
+#define TUMBLER_WORKER_PARI_STACK     10000000
+#define TUMBLER_SESSION_IDLE_TIMEOUT  1800 // 秒：超过该时间无消息的会话被回收
+
+// 已使用的 Tornado nullifierHash：追加日志（每行一个十六进制值）与压缩后的二进制快照
+#define TUMBLER_NULLIFIER_LOG       "/home/zxx/Config/truffleProject/truffletest/nullifier_hashes.txt"
+#define TUMBLER_NULLIFIER_SNAPSHOT  "/home/zxx/Config/truffleProject/truffletest/nullifier_hashes.snap"
+// Tornado withdraw 电路的 Groth16 验证密钥（snarkjs 格式），可用环境变量 A2L_GROTH16_VKEY 覆盖
+#define TUMBLER_GROTH16_VKEY        "/home/zxx/tornado-core-master/build/circuits/withdraw_verification_key.json"
+
 typedef enum {
   REGISTRATION,
   PROMISE_INIT,
@@ -96,6 +110,8 @@ typedef struct {
   
   // Tornado Cash zkSNARK 证明数据（从 Bob 接收，用于验证）
   char tornado_proof_data[4608]; // proofData JSON: {"proof":{...},"publicSignals":[...]}
+
+  GENbin *pari_store; // 会话 GEN 字段的堆上副本（见 tumbler_state_persist），每个请求结束时更新
 } tumbler_state_st;
 
 typedef tumbler_state_st *tumbler_state_t;
@@ -146,6 +162,7 @@ typedef tumbler_state_st *tumbler_state_t;
     ec_new((state)->alice_g_to_the_alpha_times_beta);     \
     cl_ciphertext_new((state)->alice_ctx_alpha_times_beta); \
     cl_ciphertext_new((state)->alice_auditor_ctx_alpha_times_beta); \
+    (state)->pari_store = NULL;                           \
   } while (0)
 
 #define tumbler_state_free(state)                         \
@@ -190,10 +207,21 @@ typedef tumbler_state_st *tumbler_state_t;
     ec_free((state)->alice_g_to_the_alpha_times_beta);    \
     cl_ciphertext_free((state)->alice_ctx_alpha_times_beta); \
     cl_ciphertext_free((state)->alice_auditor_ctx_alpha_times_beta); \
+    pari_arena_release(&(state)->pari_store);             \
     free(state);                                          \
     state = NULL;                                         \
   } while (0)
 
+// 单个混币会话：会话 ID（Alice 的托管 ID）及其独立的协议状态
+typedef struct tumbler_session_st {
+  char id[MIX_SESSION_ID_SIZE];
+  tumbler_state_t state;
+  time_t last_active;
+  struct tumbler_session_st *next;
+} tumbler_session_st;
+
+typedef tumbler_session_st *tumbler_session_t;
+
 typedef int (*msg_handler_t)(tumbler_state_t, void*, uint8_t*);
 
 int get_message_type(char *key);
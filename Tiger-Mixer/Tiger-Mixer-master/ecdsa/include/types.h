@@ -86,6 +86,10 @@ typedef zk_proof_cldl_st *zk_proof_cldl_t;
       RLC_THROW(ERR_NO_MEMORY);               \
     }                                         \
     ec_new((proof)->t2);                      \
+    (proof)->t1 = NULL;                       \
+    (proof)->t3 = NULL;                       \
+    (proof)->u1 = NULL;                       \
+    (proof)->u2 = NULL;                       \
   } while (0)
 
 #define zk_proof_cldl_free(proof)             \
@@ -300,6 +304,25 @@ typedef pedersen_com_zk_proof_st *pedersen_com_zk_proof_t;
     proof = NULL;                                     \
   } while (0)
 
+typedef struct {
+  GENbin *data;  // malloc'd binary copy of [L, base, T_1, ..., T_{2^w - 1}], usable from any thread
+  long window;   // number of comb teeth w
+  long spacing;  // distance d between teeth (covers w * d exponent bits)
+} cl_fixed_base_st;
+
+typedef cl_fixed_base_st *cl_fixed_base_t;
+
+#define cl_fixed_base_null(table) table = NULL;
+
+#define cl_fixed_base_free(table)                     \
+  do {                                                \
+    if ((table) != NULL) {                            \
+      pari_free((table)->data);                       \
+      free(table);                                    \
+      table = NULL;                                   \
+    }                                                 \
+  } while (0)
+
 typedef struct {
   GEN Delta_K;  // fundamental discriminant
   GEN E;        // the secp256k1 elliptic curve
@@ -307,6 +330,7 @@ typedef struct {
   GEN G;        // the generator of the elliptic curve group
   GEN g_q;      // the generator of G^q
   GEN bound;    // the bound for exponentiation
+  cl_fixed_base_t g_q_table;  // optional fixed-base table for g_q (NULL if absent)
 } cl_params_st;
 
 typedef cl_params_st *cl_params_t;
@@ -325,10 +349,12 @@ typedef cl_params_st *cl_params_t;
     (params)->G = gen_0;                              \
     (params)->g_q = gen_0;                            \
     (params)->bound = gen_0;                          \
+    (params)->g_q_table = NULL;                       \
   } while (0)
 
 #define cl_params_free(params)                        \
   do {                                                \
+    cl_fixed_base_free((params)->g_q_table);          \
     free(params);                                     \
     params = NULL;                                    \
   } while (0)
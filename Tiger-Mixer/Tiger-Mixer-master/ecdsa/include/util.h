@@ -7,6 +7,12 @@
 #include "/home/zxx/Config/relic/include/relic.h"
 #include "types.h"
 #include "gs.h"
+#include "cl_codec.h"
+#include "cl_fixed_base.h"
+#include "cl_enc_pool.h"
+#include "cl_multiexp.h"
+#include "pari_arena.h"
+#include "cl_worker_pool.h"
 
 // 时间测量结构
 typedef struct {
@@ -32,6 +38,20 @@ extern int timing_count;
     printf("[TIMER] %s 耗时: %.2f ms\n", #name, duration_##name); \
     record_timing(#name, duration_##name);
 
+// 多线程（tumbler 工作线程、审计线程、类群运算线程池、CL 加密池）要求 RELIC 以 -DMULTI=PTHREAD 编译、
+// PARI 以 --mt=pthread 编译（ENABLE_TLS），每个线程才有独立的 RELIC 上下文与 PARI 栈；否则各模块退回单线程
+#if defined(MULTI) && MULTI == PTHREAD && defined(ENABLE_TLS)
+#define TIGER_MT_ENABLED 1
+#else
+#define TIGER_MT_ENABLED 0
+#endif
+
+/**
+ * 未启用多线程时的统一告警
+ * @param fallback 退回单线程后的行为，如 "CL 加密池不启用"
+ */
+void tiger_mt_warn(const char *fallback);
+
 // 函数声明
 void record_timing(const char* name, double duration_ms);
 void output_timing_to_excel(const char* filename);
@@ -43,12 +63,13 @@ double get_timer_value(const char* timer_name);
 #define RLC_G2_SIZE_COMPRESSED 65
 #define RLC_CL_SECRET_KEY_SIZE 290
 #define RLC_CL_PUBLIC_KEY_SIZE 1070
-#define RLC_CL_CIPHERTEXT_SIZE 1500
-#define RLC_CLDL_PROOF_T1_SIZE 1070
+// 以下消息槽位使用 cl_codec 的二进制编码（密钥文件仍为上面的十进制文本长度）
+#define RLC_CL_CIPHERTEXT_SIZE CL_CODEC_QFB_SIZE
+#define RLC_CLDL_PROOF_T1_SIZE CL_CODEC_QFB_SIZE
 #define RLC_CLDL_PROOF_T2_SIZE 33
-#define RLC_CLDL_PROOF_T3_SIZE 1070
-#define RLC_CLDL_PROOF_U1_SIZE 315
-#define RLC_CLDL_PROOF_U2_SIZE 80
+#define RLC_CLDL_PROOF_T3_SIZE CL_CODEC_QFB_SIZE
+#define RLC_CLDL_PROOF_U1_SIZE CL_CODEC_INT_SIZE(136) // u1 = r1 + r*k，约 1000 位
+#define RLC_CLDL_PROOF_U2_SIZE CL_CODEC_INT_SIZE(40)  // u2 < q
 
 #define CLOCK_PRECISION 1E9
 
@@ -202,11 +223,22 @@ int zk_cldl_prove(zk_proof_cldl_t proof,
 									const cl_ciphertext_t ciphertext,
 									const cl_public_key_t public_key,
 									const cl_params_t params);
+// Q 为 NULL 时跳过椭圆曲线条件 g^u2 == t2 * Q^k，只验证两个类群等式
 int zk_cldl_verify(const zk_proof_cldl_t proof,
 									 const ec_t Q,
 									 const cl_ciphertext_t ciphertext,
 									 const cl_public_key_t public_key,
 									 const cl_params_t params);
+// 批量验证 n 个 CLDL 证明，第 i 个证明针对 public_keys[i]：用随机 40 位指数把 CL 等式合并，
+// 右侧每把不同的公钥只需一次 pk 幂，g_q 幂只需一次。批量失败时退回逐个验证。
+// Qs 为 NULL 时跳过椭圆曲线条件；results（可为 NULL）返回每个证明的结果。
+int zk_cldl_verify_batch(const zk_proof_cldl_t *proofs,
+												 ec_t *Qs,
+												 const cl_ciphertext_t *ciphertexts,
+												 size_t n,
+												 const cl_public_key_t *public_keys,
+												 const cl_params_t params,
+												 int *results);
 
 int zk_dlog_prove(zk_proof_t proof, const ec_t h, const bn_t w);
 int zk_dlog_verify(const zk_proof_t proof, const ec_t h);
@@ -281,6 +313,10 @@ typedef zk_proof_comprehensive_puzzle_st *zk_proof_comprehensive_puzzle_t;
     }                                                          \
     ec_new(proof->alpha_enc_proof.t2);                        \
     ec_new(proof->r0_enc_proof.t2);                           \
+    proof->alpha_enc_proof.t1 = proof->alpha_enc_proof.t3 = NULL; \
+    proof->alpha_enc_proof.u1 = proof->alpha_enc_proof.u2 = NULL; \
+    proof->r0_enc_proof.t1 = proof->r0_enc_proof.t3 = NULL;   \
+    proof->r0_enc_proof.u1 = proof->r0_enc_proof.u2 = NULL;   \
   } while (0)
 
 #define zk_proof_comprehensive_puzzle_free(proof)               \
@@ -337,7 +373,7 @@ int zk_comprehensive_puzzle_verify(const zk_proof_comprehensive_puzzle_t proof,
 // 综合谜题零知识证明序列化函数
 size_t zk_comprehensive_puzzle_serialized_size();
 int zk_comprehensive_puzzle_serialize(uint8_t *dst, size_t *written, const zk_proof_comprehensive_puzzle_t proof);
-int zk_comprehensive_puzzle_deserialize(zk_proof_comprehensive_puzzle_t proof, const uint8_t *src, size_t *read);
+int zk_comprehensive_puzzle_deserialize(zk_proof_comprehensive_puzzle_t proof, const uint8_t *src, size_t *read, const cl_params_t params);
 
 // Bob谜题关系零知识证明结构
 // 简化版谜题关系证明：直接复用两份 CLDL 证明
@@ -400,7 +436,7 @@ int zk_puzzle_relation_verify(const zk_proof_puzzle_relation_t proof,
 // 序列化和反序列化puzzle_relation证明
 size_t zk_puzzle_relation_serialized_size();
 int zk_puzzle_relation_serialize(uint8_t *dst, size_t *written, const zk_proof_puzzle_relation_t proof);
-int zk_puzzle_relation_deserialize(zk_proof_puzzle_relation_t out, const uint8_t *src, size_t *read);
+int zk_puzzle_relation_deserialize(zk_proof_puzzle_relation_t out, const uint8_t *src, size_t *read, const cl_params_t params);
 
 // ========== 新增：Bob的承诺证明（不需要原始数据） ==========
 int zk_bob_commitment_prove(zk_proof_malleability_t proof,
@@ -523,7 +559,7 @@ int zk_sigma_link_verify(
 // 序列化辅助（固定槽位，和现有 GENtostr 写入方式一致）
 size_t zk_sigma_link_serialized_size();
 int zk_sigma_link_serialize(uint8_t *dst, size_t *written, const zk_sigma_link_proof_t proof);
-int zk_sigma_link_deserialize(zk_sigma_link_proof_t out, const uint8_t *src, size_t *read);
+int zk_sigma_link_deserialize(zk_sigma_link_proof_t out, const uint8_t *src, size_t *read, const cl_params_t params);
 
 // ===== 承诺层联合证明（不公开 β′）：证明 E(β′′) = E(β′) + τ =====
 typedef struct {
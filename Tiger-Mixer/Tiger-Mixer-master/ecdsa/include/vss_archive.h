@@ -0,0 +1,50 @@
+/**
+ * VSS 承诺归档：分段的二进制追加文件 + 进程内 msgid 索引
+ *
+ * 取代 vss_commitments/vss_commitment_<msgid>.json（每次保存 system("mkdir -p") 再逐点 fprintf 十六进制，
+ * 加载时逐行解析回 66 KB 的 vss_commitment_t）：
+ *   - 承诺写成 VSS_ARCHIVE_DIR 下分段文件中的一条长度前缀记录，只包含实际的 num_blocks 个块，带校验和；
+ *     当前分段超过 VSS_ARCHIVE_SEGMENT_MAX 时开新分段；
+ *   - 多个进程追加时用目录下的锁文件（flock）串行化，持锁时发现上一个写者留下的半条记录则截掉；
+ *     尾部不是半条记录（记录头无效，或校验和不符的记录不在文件末尾）时视为损坏，拒绝追加；
+ *   - 读取方 mmap 分段文件，增量扫描新记录并维护 msgid -> (分段, 偏移) 的哈希索引，
+ *     同一 msgid 以最新记录为准；未完成的尾部记录视为尚未写入；
+ *   - 日志 fdatasync 成批进行：累计 VSS_ARCHIVE_SYNC_BATCH 条记录或关闭时同步。
+ *
+ * 进程内只有一个归档实例，首次使用时打开，所有操作在内部互斥锁内完成。
+ */
+
+#ifndef VSS_ARCHIVE_H
+#define VSS_ARCHIVE_H
+
+#include <stddef.h>
+#include "secret_share.h"
+
+#define VSS_ARCHIVE_DIR           "vss_commitments"
+#define VSS_ARCHIVE_SEGMENT_MAX   (64u << 20)
+#define VSS_ARCHIVE_MAX_SEGMENTS  1024
+#define VSS_ARCHIVE_SYNC_BATCH    16
+
+/**
+ * 追加一条承诺记录
+ * @return RLC_OK 成功，RLC_ERR 参数错误、当前分段尾部损坏或写入失败
+ */
+int vss_archive_put(const vss_commitment_t *commitment);
+
+/**
+ * 按 msgid 读取最新的承诺；只写入 commitment 的头部字段和前 num_blocks 个块
+ * @return RLC_OK 找到，RLC_ERR 未找到
+ */
+int vss_archive_get(const char *msgid, vss_commitment_t *commitment);
+
+/**
+ * 输出当前可见的分段数与不同 msgid 数（均可为 NULL）
+ */
+int vss_archive_stats(size_t *segments, size_t *entries);
+
+/**
+ * 同步、解除映射并关闭归档；之后再次调用其它函数会重新打开
+ */
+void vss_archive_close(void);
+
+#endif // VSS_ARCHIVE_H
@@ -0,0 +1,129 @@
+#!/usr/bin/env python3
+"""
+生成 DBSCAN 聚类与可疑判定的测试夹具，供 dbscan_vector_check 使用。
+
+auditor_detection 原先把特征写成 JSON 交给 dbscan_clustering.py（scikit-learn）聚类，
+现在改为进程内的 dbscan_fit。这里用 sklearn.cluster.DBSCAN 给出期望的簇标签，
+参数与 auditor_detection 相同（eps=0.3、min_samples=3、8 维特征、按列 min-max 归一化，
+某列取值范围过小时取 0.5）。
+
+异常分数按 auditor_detection 的判定规则计算（dbscan_anomaly_scores）：
+    离群点 1.0；所在簇小于 max(1, int(n * 0.05)) 个点 0.7；其它 0，分数大于 0 即为可疑。
+原来的 dbscan_clustering.py 不在仓库中，这两条规则以 C 实现为准，这里独立重写一遍用于对照。
+
+夹具格式（文本，# 开头为注释）：
+    n dim eps min_samples
+    每个点一行：地址 期望标签 期望异常分数 dim 个归一化坐标（repr，可精确还原为 double）
+
+输出：
+    blobs_small.txt   60 个点：3 个簇 + 均匀分布的离群点
+    blobs_kdtree.txt  600 个点：大小不一的簇（含一个小于 5% 的小簇）+ 离群点，覆盖 k-d 树的多层划分
+    duplicates.txt    重复地址特征与常数列（归一化为 0.5），距离为 0 的邻居
+
+用法：python3 gen_dbscan_vectors.py [输出目录]（依赖 numpy、scikit-learn）
+"""
+
+import os
+import sys
+
+import numpy as np
+from sklearn.cluster import DBSCAN
+
+EPS = 0.3
+MIN_SAMPLES = 3
+FEATURE_DIM = 8
+SEED = 20240917
+BOUNDARY_MARGIN = 1e-9     # 与 eps 的距离差小于该值的点对会让结果依赖舍入，生成时拒绝
+
+
+def normalize(raw):
+    """与 auditor_detection.c 的 normalize_features 相同"""
+    lo = raw.min(axis=0)
+    hi = raw.max(axis=0)
+    out = np.empty_like(raw)
+    for j in range(raw.shape[1]):
+        rng = hi[j] - lo[j]
+        out[:, j] = (raw[:, j] - lo[j]) / rng if rng > 1e-10 else 0.5
+    return out
+
+
+def anomaly_scores(labels):
+    """与 dbscan.c 的 dbscan_anomaly_scores 相同"""
+    n = len(labels)
+    threshold = max(1, int(n * 0.05))
+    sizes = {}
+    for label in labels:
+        if label >= 0:
+            sizes[label] = sizes.get(label, 0) + 1
+    scores = []
+    for label in labels:
+        if label == -1:
+            scores.append(1.0)
+        elif sizes[label] < threshold:
+            scores.append(0.7)
+        else:
+            scores.append(0.0)
+    return scores
+
+
+def check_margin(points):
+    diff = points[:, None, :] - points[None, :, :]
+    dist = np.sqrt((diff ** 2).sum(axis=2))
+    if np.any(np.abs(dist - EPS) < BOUNDARY_MARGIN):
+        raise SystemExit("存在与 eps 过近的点对，换一个种子")
+
+
+def blobs(rng, sizes, spread, n_noise):
+    """各簇在 [0, 1]^8 中随机取中心、按 spread 抖动，再加上均匀分布的离群点"""
+    parts = []
+    for size, s in zip(sizes, spread):
+        center = rng.uniform(0.1, 0.9, FEATURE_DIM)
+        parts.append(center + rng.normal(0.0, s, (size, FEATURE_DIM)))
+    parts.append(rng.uniform(-0.2, 1.2, (n_noise, FEATURE_DIM)))
+    raw = np.vstack(parts)
+    return raw[rng.permutation(len(raw))]
+
+
+def duplicates(rng):
+    """交易数、时间窗口计数等整数特征，很多地址完全相同；第 6 列（金额）为常数"""
+    base = rng.integers(0, 4, (8, FEATURE_DIM)).astype(float)
+    rows = [base[rng.integers(0, len(base))] for _ in range(40)]
+    rows += [rng.integers(0, 12, FEATURE_DIM).astype(float) for _ in range(4)]
+    raw = np.array(rows)
+    raw[:, 6] = 1.5
+    return raw
+
+
+def write_vector(path, comment, raw):
+    points = normalize(raw)
+    check_margin(points)
+    labels = DBSCAN(eps=EPS, min_samples=MIN_SAMPLES).fit(points).labels_
+    scores = anomaly_scores(labels)
+    n_clusters = len(set(labels) - {-1})
+    with open(path, "w") as f:
+        f.write("# %s\n" % comment)
+        f.write("# %d 个簇，%d 个离群点，%d 个可疑\n"
+                % (n_clusters, int((labels == -1).sum()), sum(1 for s in scores if s > 0)))
+        f.write("%d %d %r %d\n" % (len(points), FEATURE_DIM, EPS, MIN_SAMPLES))
+        for i, (p, label, score) in enumerate(zip(points, labels, scores)):
+            address = "0x%040x" % (0xd000 + i)
+            coords = " ".join(repr(float(x)) for x in p)
+            f.write("%s %d %r %s\n" % (address, label, score, coords))
+    print("%s: %d 个点，%d 个簇" % (path, len(points), n_clusters))
+
+
+def main():
+    out_dir = sys.argv[1] if len(sys.argv) > 1 else "."
+    os.makedirs(out_dir, exist_ok=True)
+    rng = np.random.default_rng(SEED)
+
+    write_vector(os.path.join(out_dir, "blobs_small.txt"), "3 个簇 + 离群点",
+                 blobs(rng, [20, 18, 16], [0.03, 0.04, 0.03], 6))
+    write_vector(os.path.join(out_dir, "blobs_kdtree.txt"), "大小不一的簇（含小簇）+ 离群点",
+                 blobs(rng, [220, 160, 120, 60, 8], [0.02, 0.02, 0.02, 0.015, 0.005], 32))
+    write_vector(os.path.join(out_dir, "duplicates.txt"), "重复特征与常数列",
+                 duplicates(rng))
+
+
+if __name__ == "__main__":
+    main()
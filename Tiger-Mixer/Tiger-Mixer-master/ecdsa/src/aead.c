@@ -0,0 +1,225 @@
+/**
+ * ChaCha20-Poly1305 AEAD 实现（RFC 8439）
+ */
+
+#include <string.h>
+#include <stdint.h>
+#include "/home/zxx/Config/relic/include/relic.h"
+#include "aead.h"
+
+static inline uint32_t load32_le(const uint8_t *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void store32_le(uint8_t *p, uint32_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  p[2] = (uint8_t)(v >> 16);
+  p[3] = (uint8_t)(v >> 24);
+}
+
+static inline void store64_le(uint8_t *p, uint64_t v) {
+  store32_le(p, (uint32_t)v);
+  store32_le(p + 4, (uint32_t)(v >> 32));
+}
+
+// ================= ChaCha20 =================
+
+#define ROTL32(v, n) (((v) << (n)) | ((v) >> (32 - (n))))
+#define QUARTER_ROUND(a, b, c, d) do {           \
+    a += b; d ^= a; d = ROTL32(d, 16);           \
+    c += d; b ^= c; b = ROTL32(b, 12);           \
+    a += b; d ^= a; d = ROTL32(d, 8);            \
+    c += d; b ^= c; b = ROTL32(b, 7);            \
+  } while (0)
+
+static void chacha20_block(const uint8_t key[32], uint32_t counter,
+                           const uint8_t nonce[12], uint8_t out[64]) {
+  uint32_t in[16], x[16];
+  in[0] = 0x61707865; in[1] = 0x3320646e; in[2] = 0x79622d32; in[3] = 0x6b206574;
+  for (int i = 0; i < 8; i++) in[4 + i] = load32_le(key + 4 * i);
+  in[12] = counter;
+  for (int i = 0; i < 3; i++) in[13 + i] = load32_le(nonce + 4 * i);
+
+  memcpy(x, in, sizeof(x));
+  for (int i = 0; i < 10; i++) {
+    QUARTER_ROUND(x[0], x[4], x[8],  x[12]);
+    QUARTER_ROUND(x[1], x[5], x[9],  x[13]);
+    QUARTER_ROUND(x[2], x[6], x[10], x[14]);
+    QUARTER_ROUND(x[3], x[7], x[11], x[15]);
+    QUARTER_ROUND(x[0], x[5], x[10], x[15]);
+    QUARTER_ROUND(x[1], x[6], x[11], x[12]);
+    QUARTER_ROUND(x[2], x[7], x[8],  x[13]);
+    QUARTER_ROUND(x[3], x[4], x[9],  x[14]);
+  }
+  for (int i = 0; i < 16; i++) store32_le(out + 4 * i, x[i] + in[i]);
+}
+
+static void chacha20_xor(const uint8_t key[32], uint32_t counter, const uint8_t nonce[12],
+                         uint8_t *out, const uint8_t *in, size_t len) {
+  uint8_t ks[64];
+  while (len > 0) {
+    size_t n = len < 64 ? len : 64;
+    chacha20_block(key, counter++, nonce, ks);
+    for (size_t i = 0; i < n; i++) out[i] = in[i] ^ ks[i];
+    out += n;
+    in += n;
+    len -= n;
+  }
+  memset(ks, 0, sizeof(ks));
+}
+
+// ================= Poly1305（5 个 26 位 limb） =================
+
+typedef struct {
+  uint32_t r[5];
+  uint32_t h[5];
+  uint32_t pad[4];
+} poly1305_st;
+
+static void poly1305_init(poly1305_st *st, const uint8_t key[32]) {
+  st->r[0] = (load32_le(key + 0)) & 0x3ffffff;
+  st->r[1] = (load32_le(key + 3) >> 2) & 0x3ffff03;
+  st->r[2] = (load32_le(key + 6) >> 4) & 0x3ffc0ff;
+  st->r[3] = (load32_le(key + 9) >> 6) & 0x3f03fff;
+  st->r[4] = (load32_le(key + 12) >> 8) & 0x00fffff;
+  memset(st->h, 0, sizeof(st->h));
+  for (int i = 0; i < 4; i++) st->pad[i] = load32_le(key + 16 + 4 * i);
+}
+
+// 处理一个 16 字节块；不足 16 字节的块由调用方补零（AEAD 中各段都按 16 字节对齐填充）
+static void poly1305_block(poly1305_st *st, const uint8_t m[16]) {
+  const uint32_t r0 = st->r[0], r1 = st->r[1], r2 = st->r[2], r3 = st->r[3], r4 = st->r[4];
+  const uint32_t s1 = r1 * 5, s2 = r2 * 5, s3 = r3 * 5, s4 = r4 * 5;
+  uint32_t h0 = st->h[0], h1 = st->h[1], h2 = st->h[2], h3 = st->h[3], h4 = st->h[4];
+  uint64_t d0, d1, d2, d3, d4;
+  uint32_t c;
+
+  h0 += (load32_le(m + 0)) & 0x3ffffff;
+  h1 += (load32_le(m + 3) >> 2) & 0x3ffffff;
+  h2 += (load32_le(m + 6) >> 4) & 0x3ffffff;
+  h3 += (load32_le(m + 9) >> 6) & 0x3ffffff;
+  h4 += (load32_le(m + 12) >> 8) | (1u << 24);
+
+  d0 = (uint64_t)h0 * r0 + (uint64_t)h1 * s4 + (uint64_t)h2 * s3 + (uint64_t)h3 * s2 + (uint64_t)h4 * s1;
+  d1 = (uint64_t)h0 * r1 + (uint64_t)h1 * r0 + (uint64_t)h2 * s4 + (uint64_t)h3 * s3 + (uint64_t)h4 * s2;
+  d2 = (uint64_t)h0 * r2 + (uint64_t)h1 * r1 + (uint64_t)h2 * r0 + (uint64_t)h3 * s4 + (uint64_t)h4 * s3;
+  d3 = (uint64_t)h0 * r3 + (uint64_t)h1 * r2 + (uint64_t)h2 * r1 + (uint64_t)h3 * r0 + (uint64_t)h4 * s4;
+  d4 = (uint64_t)h0 * r4 + (uint64_t)h1 * r3 + (uint64_t)h2 * r2 + (uint64_t)h3 * r1 + (uint64_t)h4 * r0;
+
+  c = (uint32_t)(d0 >> 26); h0 = (uint32_t)d0 & 0x3ffffff;
+  d1 += c; c = (uint32_t)(d1 >> 26); h1 = (uint32_t)d1 & 0x3ffffff;
+  d2 += c; c = (uint32_t)(d2 >> 26); h2 = (uint32_t)d2 & 0x3ffffff;
+  d3 += c; c = (uint32_t)(d3 >> 26); h3 = (uint32_t)d3 & 0x3ffffff;
+  d4 += c; c = (uint32_t)(d4 >> 26); h4 = (uint32_t)d4 & 0x3ffffff;
+  h0 += c * 5; c = h0 >> 26; h0 &= 0x3ffffff;
+  h1 += c;
+
+  st->h[0] = h0; st->h[1] = h1; st->h[2] = h2; st->h[3] = h3; st->h[4] = h4;
+}
+
+static void poly1305_update_padded(poly1305_st *st, const uint8_t *m, size_t len) {
+  uint8_t last[16];
+  while (len >= 16) {
+    poly1305_block(st, m);
+    m += 16;
+    len -= 16;
+  }
+  if (len > 0) {
+    memset(last, 0, sizeof(last));
+    memcpy(last, m, len);
+    poly1305_block(st, last);
+  }
+}
+
+static void poly1305_finish(poly1305_st *st, uint8_t tag[16]) {
+  uint32_t h0 = st->h[0], h1 = st->h[1], h2 = st->h[2], h3 = st->h[3], h4 = st->h[4];
+  uint32_t g0, g1, g2, g3, g4, c, mask;
+  uint64_t f;
+
+  c = h1 >> 26; h1 &= 0x3ffffff;
+  h2 += c; c = h2 >> 26; h2 &= 0x3ffffff;
+  h3 += c; c = h3 >> 26; h3 &= 0x3ffffff;
+  h4 += c; c = h4 >> 26; h4 &= 0x3ffffff;
+  h0 += c * 5; c = h0 >> 26; h0 &= 0x3ffffff;
+  h1 += c;
+
+  // 计算 h - p，若不为负则取之（常量时间选择）
+  g0 = h0 + 5; c = g0 >> 26; g0 &= 0x3ffffff;
+  g1 = h1 + c; c = g1 >> 26; g1 &= 0x3ffffff;
+  g2 = h2 + c; c = g2 >> 26; g2 &= 0x3ffffff;
+  g3 = h3 + c; c = g3 >> 26; g3 &= 0x3ffffff;
+  g4 = h4 + c - (1u << 26);
+
+  mask = (g4 >> 31) - 1;
+  g0 &= mask; g1 &= mask; g2 &= mask; g3 &= mask; g4 &= mask;
+  mask = ~mask;
+  h0 = (h0 & mask) | g0;
+  h1 = (h1 & mask) | g1;
+  h2 = (h2 & mask) | g2;
+  h3 = (h3 & mask) | g3;
+  h4 = (h4 & mask) | g4;
+
+  h0 = (h0) | (h1 << 26);
+  h1 = (h1 >> 6) | (h2 << 20);
+  h2 = (h2 >> 12) | (h3 << 14);
+  h3 = (h3 >> 18) | (h4 << 8);
+
+  f = (uint64_t)h0 + st->pad[0];             store32_le(tag + 0, (uint32_t)f);
+  f = (uint64_t)h1 + st->pad[1] + (f >> 32); store32_le(tag + 4, (uint32_t)f);
+  f = (uint64_t)h2 + st->pad[2] + (f >> 32); store32_le(tag + 8, (uint32_t)f);
+  f = (uint64_t)h3 + st->pad[3] + (f >> 32); store32_le(tag + 12, (uint32_t)f);
+
+  memset(st, 0, sizeof(*st));
+}
+
+// tag = Poly1305(otk, ad | pad16 | ct | pad16 | len(ad) | len(ct))
+static void aead_compute_tag(const uint8_t key[32], const uint8_t nonce[12],
+                             const uint8_t *ad, size_t ad_len,
+                             const uint8_t *ct, size_t ct_len, uint8_t tag[16]) {
+  uint8_t block0[64];
+  uint8_t lens[16];
+  poly1305_st st;
+
+  chacha20_block(key, 0, nonce, block0);
+  poly1305_init(&st, block0);
+  memset(block0, 0, sizeof(block0));
+
+  if (ad_len > 0) poly1305_update_padded(&st, ad, ad_len);
+  if (ct_len > 0) poly1305_update_padded(&st, ct, ct_len);
+  store64_le(lens, (uint64_t)ad_len);
+  store64_le(lens + 8, (uint64_t)ct_len);
+  poly1305_block(&st, lens);
+  poly1305_finish(&st, tag);
+}
+
+int aead_encrypt(uint8_t *out, const uint8_t *in, size_t len,
+                 const uint8_t *ad, size_t ad_len,
+                 const uint8_t nonce[AEAD_NONCE_SIZE], const uint8_t key[AEAD_KEY_SIZE]) {
+  if (out == NULL || key == NULL || nonce == NULL || (len > 0 && in == NULL) || (ad_len > 0 && ad == NULL)) {
+    return RLC_ERR;
+  }
+  chacha20_xor(key, 1, nonce, out, in, len);
+  aead_compute_tag(key, nonce, ad, ad_len, out, len, out + len);
+  return RLC_OK;
+}
+
+int aead_decrypt(uint8_t *out, const uint8_t *in, size_t in_len,
+                 const uint8_t *ad, size_t ad_len,
+                 const uint8_t nonce[AEAD_NONCE_SIZE], const uint8_t key[AEAD_KEY_SIZE]) {
+  uint8_t tag[AEAD_TAG_SIZE];
+  uint8_t diff = 0;
+
+  if (out == NULL || in == NULL || key == NULL || nonce == NULL ||
+      in_len < AEAD_TAG_SIZE || (ad_len > 0 && ad == NULL)) {
+    return RLC_ERR;
+  }
+  size_t ct_len = in_len - AEAD_TAG_SIZE;
+  aead_compute_tag(key, nonce, ad, ad_len, in, ct_len, tag);
+  for (int i = 0; i < AEAD_TAG_SIZE; i++) diff |= tag[i] ^ in[ct_len + i];
+  if (diff != 0) {
+    return RLC_ERR;
+  }
+  chacha20_xor(key, 1, nonce, out, in, ct_len);
+  return RLC_OK;
+}
@@ -0,0 +1,130 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "/home/zxx/Config/relic/include/relic.h"
+#include "aead.h"
+#include "secret_share.h"
+#include "check.h"
+
+// 混合分享模式的检查：
+//   1. ChaCha20-Poly1305 的 RFC 8439 §2.8.2 已知答案（密文与 tag），以及篡改后拒绝解密；
+//   2. 接收者返回不同信封时，重构密钥后逐个尝试，伪造的信封排在前面也能解出真实载荷，
+//      只有伪造信封时失败。
+// 用法：aead_vector_check，任何一项不符合预期时返回非 0
+
+static size_t from_hex(uint8_t *out, const char *hex) {
+  size_t n = strlen(hex) / 2;
+  for (size_t i = 0; i < n; i++) sscanf(hex + 2 * i, "%2hhx", &out[i]);
+  return n;
+}
+
+// RFC 8439 §2.8.2
+static void check_rfc8439_vector(void) {
+  printf("RFC 8439 §2.8.2 ChaCha20-Poly1305:\n");
+  static const char *PLAINTEXT =
+      "Ladies and Gentlemen of the class of '99: If I could offer you only one tip for the future, "
+      "sunscreen would be it.";
+  static const char *KEY = "808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f";
+  static const char *NONCE = "070000004041424344454647";
+  static const char *AAD = "50515253c0c1c2c3c4c5c6c7";
+  static const char *CIPHERTEXT =
+      "d31a8d34648e60db7b86afbc53ef7ec2a4aded51296e08fea9e2b5a736ee62d6"
+      "3dbea45e8ca9671282fafb69da92728b1a71de0a9e060b2905d6a5b67ecd3b36"
+      "92ddbd7f2d778b8c9803aee328091b58fab324e4fad675945585808b4831d7bc"
+      "3ff4def08e4b7a9de576d26586cec64b6116";
+  static const char *TAG = "1ae10b594f09e26a7e902ecbd0600691";
+
+  uint8_t key[AEAD_KEY_SIZE], nonce[AEAD_NONCE_SIZE], aad[12], expected[256], out[256], plain[256];
+  const size_t len = strlen(PLAINTEXT);
+  from_hex(key, KEY);
+  from_hex(nonce, NONCE);
+  from_hex(aad, AAD);
+  size_t ct_len = from_hex(expected, CIPHERTEXT);
+  from_hex(expected + ct_len, TAG);
+
+  EXPECT(ct_len == len, "明文与密文长度一致（114 字节）");
+  EXPECT(aead_encrypt(out, (const uint8_t *) PLAINTEXT, len, aad, sizeof(aad), nonce, key) == RLC_OK, "加密");
+  EXPECT(memcmp(out, expected, len) == 0, "密文与 RFC 一致");
+  EXPECT(memcmp(out + len, expected + len, AEAD_TAG_SIZE) == 0, "tag 与 RFC 一致");
+
+  EXPECT(aead_decrypt(plain, expected, len + AEAD_TAG_SIZE, aad, sizeof(aad), nonce, key) == RLC_OK
+             && memcmp(plain, PLAINTEXT, len) == 0,
+         "解密 RFC 密文得到原文");
+
+  expected[len + AEAD_TAG_SIZE - 1] ^= 1;
+  EXPECT(aead_decrypt(plain, expected, len + AEAD_TAG_SIZE, aad, sizeof(aad), nonce, key) == RLC_ERR,
+         "tag 被篡改时拒绝");
+  expected[len + AEAD_TAG_SIZE - 1] ^= 1;
+  expected[0] ^= 1;
+  EXPECT(aead_decrypt(plain, expected, len + AEAD_TAG_SIZE, aad, sizeof(aad), nonce, key) == RLC_ERR,
+         "密文被篡改时拒绝");
+  expected[0] ^= 1;
+  aad[0] ^= 1;
+  EXPECT(aead_decrypt(plain, expected, len + AEAD_TAG_SIZE, aad, sizeof(aad), nonce, key) == RLC_ERR,
+         "附加数据不同时拒绝");
+}
+
+// 真实信封之外混入一个伪造的信封（同样长度、同样格式，但不是用分享的密钥加密的）
+static void check_hybrid_envelopes(void) {
+  printf("混合模式多信封:\n");
+  static const char *MSG_ID = "0x00000000000000000000000000000000000000000000000000000000000000a1";
+  static const char *PAYLOAD = "hybrid payload for the auditor";
+  const size_t payload_len = strlen(PAYLOAD);
+
+  secret_share_t *shares = calloc(SECRET_SHARES * SHARE_KEY_BLOCKS, sizeof(secret_share_t));
+  uint8_t *reconstructed = malloc(MAX_MESSAGE_SIZE);
+  uint8_t *envelope = NULL, *forged = NULL, forged_key[AEAD_KEY_SIZE];
+  size_t num_shares = 0, envelope_len = 0, data_length = 0;
+  if (shares == NULL || reconstructed == NULL) {
+    EXPECT(0, "分配内存");
+    goto out;
+  }
+
+  EXPECT(create_hybrid_shares((const uint8_t *) PAYLOAD, payload_len, MSG_ID, shares, &num_shares, NULL,
+                              &envelope, &envelope_len) == 0,
+         "生成密钥分片与信封");
+  if (envelope == NULL) goto out;
+
+  forged = malloc(envelope_len);
+  if (forged == NULL) goto out;
+  rand_bytes(forged_key, sizeof(forged_key));
+  rand_bytes(forged, AEAD_NONCE_SIZE);
+  aead_encrypt(forged + AEAD_NONCE_SIZE, (const uint8_t *) PAYLOAD, payload_len,
+               (const uint8_t *) MSG_ID, strlen(MSG_ID), forged, forged_key);
+  forged[AEAD_NONCE_SIZE] ^= 0x20;
+
+  int share_count = (int) num_shares;
+
+  const uint8_t *both[2] = { forged, envelope };
+  const size_t both_lens[2] = { envelope_len, envelope_len };
+  memset(reconstructed, 0, MAX_MESSAGE_SIZE);
+  EXPECT(reconstruct_hybrid_secret(shares, share_count, both, both_lens, 2, MSG_ID, reconstructed, &data_length) == 0
+             && data_length == payload_len && memcmp(reconstructed, PAYLOAD, payload_len) == 0,
+         "伪造信封在前时仍解出真实载荷");
+
+  const uint8_t *only_forged[1] = { forged };
+  EXPECT(reconstruct_hybrid_secret(shares, share_count, only_forged, both_lens, 1, MSG_ID, reconstructed,
+                                   &data_length) != 0,
+         "只有伪造信封时失败");
+
+out:
+  free(forged);
+  free(envelope);
+  free(reconstructed);
+  free(shares);
+}
+
+int main(void) {
+  if (core_init() != RLC_OK) {
+    fprintf(stderr, "RELIC 初始化失败\n");
+    return 1;
+  }
+  // 分片在 secp256k1 的阶上计算，与 util.c 的 init() 一致
+  ep_param_set(SECG_K256);
+
+  check_rfc8439_vector();
+  check_hybrid_envelopes();
+
+  core_clean();
+  return check_summary();
+}
@@ -10,6 +10,8 @@
 #include "types.h"
 #include "util.h"
 #include "secret_share.h"
+#include "mix_session.h"
+#include "escrow_client.h"
 
 // 临时禁用 Alice 的秘密分享发送
 #define DISABLE_SECRET_SHARES 1
@@ -58,197 +60,43 @@ static void bn_to_0x_padded_hex(bn_t in, char out67[67]) {
 }
 
 static int open_escrow_sync_with_tid(alice_state_t state, const char *escrow_id) {
-  // 直接使用固定值，不再从环境变量读取
-  const char *rpc = "http://127.0.0.1:7545";
-  // 改为使用固定面额池脚本，通过 --pool 从地址簿解析合约地址
-  
-  // 使用结构体中的Alice地址
-  const char *p1 = state->alice_address;  // Alice 地址
-  const char *p2 = "0x9483ba82278fd651ed64d5b2cc2d4d2bbfa94025";  // Tumbler 地址
-  const char *benef = "0x9483ba82278fd651ed64d5b2cc2d4d2bbfa94025"; // 受益人地址
-  const char *refund = state->alice_address; // 退款给 Alice
-  
-  long deadline = (long)time(NULL) + 3600; // 1小时后过期
-
- 
-  char meta_hash[67];
-  memcpy(meta_hash, escrow_id, sizeof(meta_hash));
-
-  // 以 tid 作为 escrowId 和 metaHash
-  // char escrow_id[67];
-  // bn_to_0x_padded_hex(state->tid, escrow_id);
-  // char meta_hash[67];
-  // memcpy(meta_hash, escrow_id, sizeof(escrow_id));
-
-  // 只使用 Truffle 方式
-  const char *truffle_project = "/home/zxx/Config/truffleProject/truffletest";
-  
   // 使用结构体中的Alice地址
   const char *alice_from = state->alice_address;
-  
-  // 生成未压缩公钥（0x04||X||Y）并转为十六进制字符串（与 test_a2l_verifier.js 一致：若132则截到130）
-  // 从结构体中读取 alice_ec_pk 和 tumbler_ec_pk 的公钥点（通过 ->pk 字段访问）
-  uint8_t alice_pk_bytes[RLC_EC_SIZE_COMPRESSED * 2];
-  uint8_t tumbler_pk_bytes[RLC_EC_SIZE_COMPRESSED * 2];
-  char alice_pk_hex[(RLC_EC_SIZE_COMPRESSED * 2) * 2 + 1];
-  char tumbler_pk_hex[(RLC_EC_SIZE_COMPRESSED * 2) * 2 + 1];
-  size_t i_pk;
-  ec_write_bin(alice_pk_bytes, RLC_EC_SIZE_COMPRESSED * 2, state->alice_ec_pk->pk, 0);
-  ec_write_bin(tumbler_pk_bytes, RLC_EC_SIZE_COMPRESSED * 2, state->tumbler_ec_pk->pk, 0);
-  // 生成纯十六进制字符串，不加 "0x" 前缀（JS 脚本会统一处理前缀）
-  for (i_pk = 0; i_pk < (size_t)(RLC_EC_SIZE_COMPRESSED * 2); i_pk++) {
-    sprintf(alice_pk_hex + 2*i_pk, "%02x", alice_pk_bytes[i_pk]);
-    sprintf(tumbler_pk_hex + 2*i_pk, "%02x", tumbler_pk_bytes[i_pk]);
+  const char *tumbler_address = "0x9483ba82278fd651ed64d5b2cc2d4d2bbfa94025";  // Tumbler 地址
+
+  // 以 escrowId 作为 metaHash；Alice 为 party1，Tumbler 为 party2
+  escrow_open_args_t args;
+  memset(&args, 0, sizeof(args));
+  args.pool_label = state->pool_label;
+  args.escrow_id = escrow_id;
+  args.party1 = alice_from;
+  args.party2 = tumbler_address;
+  args.deadline = (long)time(NULL) + 3600; // 1小时后过期
+  args.meta_hash = escrow_id;
+  args.commitment = state->commitment;
+
+  // 未压缩公钥（0x04||X||Y）写入合约，confirm 时由合约记录恢复双方地址
+  ec_write_bin(args.party1_key, ESCROW_PUBKEY_LEN, state->alice_ec_pk->pk, 0);
+  ec_write_bin(args.party2_key, ESCROW_PUBKEY_LEN, state->tumbler_ec_pk->pk, 0);
+  char alice_pk_hex[2 * ESCROW_PUBKEY_LEN + 1];
+  char tumbler_pk_hex[2 * ESCROW_PUBKEY_LEN + 1];
+  for (size_t i_pk = 0; i_pk < ESCROW_PUBKEY_LEN; i_pk++) {
+    sprintf(alice_pk_hex + 2*i_pk, "%02x", args.party1_key[i_pk]);
+    sprintf(tumbler_pk_hex + 2*i_pk, "%02x", args.party2_key[i_pk]);
   }
-  alice_pk_hex[(RLC_EC_SIZE_COMPRESSED * 2) * 2] = '\0';
-  tumbler_pk_hex[(RLC_EC_SIZE_COMPRESSED * 2) * 2] = '\0';
-  
-  // 打印输出两个公钥（打印时加上前缀以便阅读）
   printf("[ESCROW] Alice公钥 (未压缩): 0x%s\n", alice_pk_hex);
   printf("[ESCROW] Tumbler公钥 (未压缩): 0x%s\n", tumbler_pk_hex);
+  printf("[ESCROW] openEscrow: pool=%s id=%s from=%s commitment=%s\n",
+         state->pool_label, escrow_id, alice_from, state->commitment);
+
   START_TIMER(alice_blockchain_escrow_interaction)
-  char *cmd = (char *)malloc(4096);
-  if (!cmd) return -1;
-  
-  // 修改命令：使用 2>&1 捕获 stderr 和 stdout，移除 | cat
-  // 添加 Tornado Cash commitment 参数
-  snprintf(cmd, 4096,
-           "cd %s && npx truffle exec scripts/openEscrow_fixed.js --network private "
-           "--pool %s --id %s --p1 %s --p2 %s --benef %s --refund %s --deadline %ld --meta %s --from %s --p1key %s --p2key %s --commitment %s 2>&1",
-           truffle_project, state->pool_label, escrow_id, p1, p2, benef, refund, deadline, meta_hash, alice_from, alice_pk_hex, tumbler_pk_hex, state->commitment);
-
-  printf("[ESCROW] openEscrow sync cmd: %s\n", cmd);
-  
-  // 测量区块链交互时间
-  
-  // 执行命令并捕获输出
-  FILE *fp = popen(cmd, "r");
-  if (!fp) {
-    fprintf(stderr, "[ESCROW] Failed to execute command\n");
-    free(cmd);
-    return -1;
-  }
-  
-  // 增加buffer大小，收集完整输出
-  char buffer[4096];
-  char tx_hash[67] = {0};
-  char *error_buffer = NULL;
-  size_t error_buffer_size = 0;
-  int has_error = 0;
-  
-  // 读取命令输出，寻找交易哈希
-  while (fgets(buffer, sizeof(buffer), fp) != NULL) {
-    const char *disable_io = getenv("A2L_DISABLE_IO");
-    if (!disable_io || strcmp(disable_io, "1") != 0) {
-      printf("[ESCROW] Output: %s", buffer);
-    }
-    
-    // 检测错误信息（排除已知的非致命警告）
-    if ((strstr(buffer, "Error:") != NULL || strstr(buffer, "ERROR") != NULL || 
-         strstr(buffer, "error") != NULL || strstr(buffer, "Error") != NULL) &&
-        strstr(buffer, "Cannot find module") == NULL &&  // 忽略 uws 模块警告
-        strstr(buffer, "Falling back to") == NULL) {     // 忽略回退提示
-      has_error = 1;
-      
-      // 收集错误信息到缓冲区
-      size_t line_len = strlen(buffer);
-      error_buffer = realloc(error_buffer, error_buffer_size + line_len + 1);
-      if (error_buffer) {
-        memcpy(error_buffer + error_buffer_size, buffer, line_len);
-        error_buffer_size += line_len;
-        error_buffer[error_buffer_size] = '\0';
-      }
-    }
-    
-    // 查找包含交易哈希的行
-    if (strstr(buffer, "Transaction hash:") != NULL || strstr(buffer, "txHash:") != NULL) {
-      // 提取交易哈希
-      char *hash_start = strstr(buffer, "0x");
-      if (hash_start) {
-        strncpy(tx_hash, hash_start, 66);
-        tx_hash[66] = '\0';
-        printf("[ESCROW] Captured transaction hash: %s\n", tx_hash);
-        break;
-      }
-    }
-    
-    // 查找JSON格式的交易哈希 {"txHash":"0x...", "contract":"0x..."}
-    if (strstr(buffer, "\"txHash\"") != NULL) {
-      printf("[ESCROW] Found JSON txHash line, attempting to extract...\n");
-      char *hash_start = strstr(buffer, "\"0x");
-      if (hash_start) {
-        printf("[ESCROW] Found 0x pattern at position %ld\n", hash_start - buffer);
-        // 跳过开头的引号
-        hash_start += 1;
-        
-        // 找到哈希的结束位置（下一个引号）
-        char *hash_end = strchr(hash_start, '"');
-        if (hash_end) {
-          int hash_len = hash_end - hash_start;
-          printf("[ESCROW] Hash length: %d\n", hash_len);
-          if (hash_len <= 66) {
-            strncpy(tx_hash, hash_start, hash_len);
-            tx_hash[hash_len] = '\0';
-            printf("[ESCROW] Captured JSON transaction hash: %s\n", tx_hash);
-            strncpy(state->escrow_tx_hash, tx_hash, sizeof(state->escrow_tx_hash) - 1);
-            state->escrow_tx_hash[sizeof(state->escrow_tx_hash) - 1] = '\0';
-            printf("[ESCROW] Stored escrow transaction hash: %s\n", state->escrow_tx_hash);
-            
-            query_and_save_transaction_details(state->escrow_tx_hash);
-            
-            // 继续提取合约地址字段（若存在）
-            char *contract_key = strstr(hash_end, "\"contract\"");
-            if (contract_key) {
-              char *addr_start = strstr(contract_key, "\"0x");
-              if (addr_start) {
-                addr_start += 1; // 跳过引号
-                char *addr_end = strchr(addr_start, '"');
-                if (addr_end) {
-                  int addr_len = addr_end - addr_start;
-                  if (addr_len >= 42) addr_len = 42; // 0x + 40
-                  strncpy(state->pool_contract, addr_start, addr_len);
-                  state->pool_contract[addr_len] = '\0';
-                  printf("[ESCROW] Captured pool contract: %s\n", state->pool_contract);
-                }
-              }
-            }
-            break;
-          } else {
-            printf("[ESCROW] Hash too long: %d > 66\n", hash_len);
-          }
-        } else {
-          printf("[ESCROW] Could not find closing quote\n");
-        }
-      } else {
-        printf("[ESCROW] Could not find 0x pattern in JSON line\n");
-      }
-    }
-  }
-  
-  int rc = pclose(fp);
-  free(cmd);
-  
-  
-  // 如果成功提取到交易哈希，说明交易已成功提交，即使有警告也视为成功
-  int tx_hash_extracted = (strlen(tx_hash) > 0);
-  
-  // 显示完整的错误信息（只有在没有提取到交易哈希且确实有错误时才报错）
-  if (!tx_hash_extracted && (has_error || rc != 0)) {
+  escrow_client_t client = escrow_client_shared();
+  char tx_hash[ESCROW_HASH_STR_LEN] = {0};
+  if (client == NULL || escrow_open(client, &args, alice_from, state->alice_ec_sk->sk, tx_hash) != RLC_OK) {
     printf("\n");
     printf("========================================\n");
     printf("[ESCROW] ❌ 交易执行失败！\n");
     printf("========================================\n");
-    printf("返回码: %d\n", rc);
-    
-    if (error_buffer && error_buffer_size > 0) {
-      printf("\n完整错误信息:\n");
-      printf("----------------------------------------\n");
-      printf("%s", error_buffer);
-      printf("----------------------------------------\n");
-    } else {
-      printf("未捕获到详细错误信息\n");
-    }
-    
     printf("\n可能的原因:\n");
     printf("  1. 账户余额不足 (需要 ~0.11 ETH)\n");
     printf("  2. 账户未解锁\n");
@@ -263,70 +111,42 @@ static int open_escrow_sync_with_tid(alice_state_t state, const char *escrow_id)
            "/home/zxx/Config/blockchain/consortium_blockchain/myblockchain/geth.ipc");
     printf("========================================\n");
     printf("\n");
-    
-    // 清理错误缓冲区
-    if (error_buffer) {
-      free(error_buffer);
-    }
-    
     return -1;
   }
-  
-  // 清理错误缓冲区（成功情况）
-  if (error_buffer) {
-    free(error_buffer);
+
+  ESCROW_OPENED = 1;
+  strncpy(state->escrow_tx_hash, tx_hash, sizeof(state->escrow_tx_hash) - 1);
+  state->escrow_tx_hash[sizeof(state->escrow_tx_hash) - 1] = '\0';
+  printf("[ESCROW] Stored escrow transaction hash: %s\n", state->escrow_tx_hash);
+  if (escrow_pool_address(state->pool_contract, state->pool_label) == RLC_OK) {
+    printf("[ESCROW] Captured pool contract: %s\n", state->pool_contract);
   }
-  
-  // 如果成功提取到交易哈希或返回码为0，视为成功
-  if (tx_hash_extracted || rc == 0) {
-    ESCROW_OPENED = 1;
-    
-    // 如果成功捕获到交易哈希，确保存储到state中（可能在提取时已存储，这里确保不遗漏）
-    if (strlen(tx_hash) > 0 && strlen(state->escrow_tx_hash) == 0) {
-      strncpy(state->escrow_tx_hash, tx_hash, sizeof(state->escrow_tx_hash) - 1);
-      state->escrow_tx_hash[sizeof(state->escrow_tx_hash) - 1] = '\0';
-      printf("[ESCROW] Stored escrow transaction hash: %s\n", state->escrow_tx_hash);
-    }
-
-    // 将交易哈希作为 dataHash 写入合约（bytes32），便于后续签名校验使用
-    if (strlen(state->escrow_tx_hash) > 0) {
-      const char *truffle_project = "/home/zxx/Config/truffleProject/truffletest";
-      const char *from_addr = state->alice_address;
-      char cmd_set[4096];
-      // 使用 state->escrow_tx_hash（已在提取时设置）
-      snprintf(cmd_set, sizeof(cmd_set),
-               "cd %s && npx truffle exec scripts/setDataHash.js --network private --pool %s --id %s --hash %s --from %s 2>&1",
-               truffle_project, state->pool_label, escrow_id, state->escrow_tx_hash, from_addr);
-      printf("[ESCROW] setDataHash cmd: %s\n", cmd_set);
-      int rc_set = system(cmd_set);
-      if (rc_set == 0) {
-        printf("[ESCROW] Wrote dataHash (txHash) to escrow successfully.\n");
-      } else {
-        printf("[ESCROW] Failed to write dataHash to escrow, rc=%d.\n", rc_set);
-      }
-    }
-    
-    // 将托管交易哈希写入文件
-    FILE *hash_file = fopen("escrow_transaction_hashes.txt", "a");
-    if (hash_file != NULL) {
-      // 获取当前时间戳
-      time_t now = time(NULL);
-      char timestamp[64];
-      strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", localtime(&now));
-      
-      // 写入格式：时间戳 | Alice地址 | 托管交易哈希
-      fprintf(hash_file, "%s | %s | %s\n", timestamp, state->alice_address, state->escrow_tx_hash);
-      fclose(hash_file);
-      printf("[ESCROW] Transaction hash saved to file: escrow_transaction_hashes.txt\n");
-    } else {
-      fprintf(stderr, "[ESCROW] Warning: Could not open file to save transaction hash\n");
-    }
-    
-    // 查询并保存交易详情（已在提取交易哈希时调用）
-    // query_and_save_transaction_details(state->escrow_tx_hash);
+  query_and_save_transaction_details(state->escrow_tx_hash);
+
+  // 将交易哈希作为 dataHash 写入合约（bytes32），便于后续签名校验使用
+  if (escrow_set_data_hash(client, state->pool_label, escrow_id, state->escrow_tx_hash,
+                           alice_from, state->alice_ec_sk->sk, NULL) == RLC_OK) {
+    printf("[ESCROW] Wrote dataHash (txHash) to escrow successfully.\n");
+  } else {
+    printf("[ESCROW] Failed to write dataHash to escrow.\n");
+  }
+
+  // 将托管交易哈希写入文件
+  FILE *hash_file = fopen("escrow_transaction_hashes.txt", "a");
+  if (hash_file != NULL) {
+    // 获取当前时间戳
+    time_t now = time(NULL);
+    char timestamp[64];
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", localtime(&now));
+
+    // 写入格式：时间戳 | Alice地址 | 托管交易哈希
+    fprintf(hash_file, "%s | %s | %s\n", timestamp, state->alice_address, state->escrow_tx_hash);
+    fclose(hash_file);
+    printf("[ESCROW] Transaction hash saved to file: escrow_transaction_hashes.txt\n");
+  } else {
+    fprintf(stderr, "[ESCROW] Warning: Could not open file to save transaction hash\n");
   }
   END_TIMER(alice_blockchain_escrow_interaction)
-  // 返回0表示成功（无论是否提取到交易哈希，只要命令执行成功或提取到哈希就成功）
   return 0;
 }
 
@@ -619,6 +439,10 @@ int registration(alice_state_t state, void *socket, const char *alice_escrow_id)
     }
 
     memcpy(zmq_msg_data(&registration), serialized_message, total_msg_length);
+    if (mix_session_send_id(socket, alice_escrow_id) != RLC_OK) {
+      fprintf(stderr, "Error: could not send the session id (%s).\n", msg_type);
+      RLC_THROW(ERR_CAUGHT);
+    }
     rc = zmq_msg_send(&registration, socket, ZMQ_DONTWAIT);
     if (rc != total_msg_length) {
       fprintf(stderr, "Error: could not send the message (%s).\n", msg_type);
@@ -1107,16 +931,19 @@ int token_share(alice_state_t state, void *socket,const char *alice_escrow_id) {
     // 4. escrow_tx_hash (null-terminated string, 67 bytes max)
     // 5. pool_label (null-terminated string)
     // 6. pool_contract (null-terminated string, 43 bytes max)
+    // 7. alice_escrow_id (null-terminated string)，即 Tumbler 侧的会话 ID
     const unsigned nullifier_length = 31;
     const unsigned secret_length = 31;
     const unsigned commitment_length = strlen(state->commitment) + 1;
     const unsigned escrow_tx_hash_length = strlen(state->escrow_tx_hash) + 1;
     const unsigned pool_label_length = strlen(state->pool_label) + 1;
     const unsigned pool_contract_length = strlen(state->pool_contract) + 1;
+    const unsigned session_id_length = strlen(alice_escrow_id) + 1;
     
     const unsigned msg_data_length = nullifier_length + secret_length + 
                                      commitment_length + escrow_tx_hash_length + 
-                                     pool_label_length + pool_contract_length;
+                                     pool_label_length + pool_contract_length +
+                                     session_id_length;
     const int total_msg_length = msg_type_length + msg_data_length + (2 * sizeof(unsigned));
     message_new(token_share_msg, msg_type_length, msg_data_length);
     
@@ -1148,6 +975,10 @@ int token_share(alice_state_t state, void *socket,const char *alice_escrow_id) {
     
     // 6. pool_contract (null-terminated string)
     memcpy(token_share_msg->data + offset, state->pool_contract, pool_contract_length);
+    offset += pool_contract_length;
+    
+    // 7. alice_escrow_id (null-terminated string)
+    memcpy(token_share_msg->data + offset, alice_escrow_id, session_id_length);
 
     // 打印序列化后的数据（前100字节）
     printf("[DEBUG] Alice token_share: 序列化后的数据前100字节 (hex): ");
@@ -1227,32 +1058,16 @@ int puzzle_share_handler(alice_state_t state, void *socket, uint8_t *data, trans
     offset += RLC_EC_SIZE_COMPRESSED;
     printf("[ALICE] 反序列化g_to_the_alpha_times_beta，当前offset: %zu\n", offset);
     
-    char ctx_c1_str[RLC_CL_CIPHERTEXT_SIZE + 1];
-    char ctx_c2_str[RLC_CL_CIPHERTEXT_SIZE + 1];
-    memcpy(ctx_c1_str, data + offset, RLC_CL_CIPHERTEXT_SIZE);
-    ctx_c1_str[RLC_CL_CIPHERTEXT_SIZE] = 0;
-    offset += RLC_CL_CIPHERTEXT_SIZE;
-    printf("[ALICE] 读取ctx_c1，当前offset: %zu\n", offset);
-    memcpy(ctx_c2_str, data + offset, RLC_CL_CIPHERTEXT_SIZE);
-    ctx_c2_str[RLC_CL_CIPHERTEXT_SIZE] = 0;
-    offset += RLC_CL_CIPHERTEXT_SIZE;
-    printf("[ALICE] 读取ctx_c2，当前offset: %zu\n", offset);
-    printf("[ALICE] ctx_c1_str: %.20s...\n", ctx_c1_str);
-    printf("[ALICE] ctx_c2_str: %.20s...\n", ctx_c2_str);
-    state->ctx_alpha_times_beta->c1 = gp_read_str(ctx_c1_str);
-    state->ctx_alpha_times_beta->c2 = gp_read_str(ctx_c2_str);
+    if (cl_codec_read_ct(state->ctx_alpha_times_beta, data, &offset, state->cl_params) != RLC_OK) {
+      fprintf(stderr, "[ERROR] 密文解码失败\n");
+      RLC_THROW(ERR_CAUGHT);
+    }
 
     // 解析auditor随机化密文
-    char auditor_c1_rand_str[RLC_CL_CIPHERTEXT_SIZE + 1];
-    char auditor_c2_rand_str[RLC_CL_CIPHERTEXT_SIZE + 1];
-    memcpy(auditor_c1_rand_str, data + offset, RLC_CL_CIPHERTEXT_SIZE);
-    auditor_c1_rand_str[RLC_CL_CIPHERTEXT_SIZE] = 0;
-    offset += RLC_CL_CIPHERTEXT_SIZE;
-    memcpy(auditor_c2_rand_str, data + offset, RLC_CL_CIPHERTEXT_SIZE);
-    auditor_c2_rand_str[RLC_CL_CIPHERTEXT_SIZE] = 0;
-    offset += RLC_CL_CIPHERTEXT_SIZE;
-    state->auditor_ctx_alpha_times_beta->c1 = gp_read_str(auditor_c1_rand_str);
-    state->auditor_ctx_alpha_times_beta->c2 = gp_read_str(auditor_c2_rand_str);
+    if (cl_codec_read_ct(state->auditor_ctx_alpha_times_beta, data, &offset, state->cl_params) != RLC_OK) {
+      fprintf(stderr, "[ERROR] 密文解码失败\n");
+      RLC_THROW(ERR_CAUGHT);
+    }
     printf("[ALICE] 反序列化auditor密文完成\n");
     
     // 2. 反序列化原始谜题数据
@@ -1260,33 +1075,21 @@ int puzzle_share_handler(alice_state_t state, void *socket, uint8_t *data, trans
     offset += RLC_EC_SIZE_COMPRESSED;
     printf("[ALICE] 反序列化g_alpha\n");
     
-    char ctx_alpha_c1_str[RLC_CL_CIPHERTEXT_SIZE + 1];
-    char ctx_alpha_c2_str[RLC_CL_CIPHERTEXT_SIZE + 1];
-    memcpy(ctx_alpha_c1_str, data + offset, RLC_CL_CIPHERTEXT_SIZE);
-    ctx_alpha_c1_str[RLC_CL_CIPHERTEXT_SIZE] = 0;
-    offset += RLC_CL_CIPHERTEXT_SIZE;
-    memcpy(ctx_alpha_c2_str, data + offset, RLC_CL_CIPHERTEXT_SIZE);
-    ctx_alpha_c2_str[RLC_CL_CIPHERTEXT_SIZE] = 0;
-    offset += RLC_CL_CIPHERTEXT_SIZE;
-    ctx_alpha->c1 = gp_read_str(ctx_alpha_c1_str);
-    ctx_alpha->c2 = gp_read_str(ctx_alpha_c2_str);
-    
-    char auditor_ctx_alpha_c1_str[RLC_CL_CIPHERTEXT_SIZE + 1];
-    char auditor_ctx_alpha_c2_str[RLC_CL_CIPHERTEXT_SIZE + 1];
-    memcpy(auditor_ctx_alpha_c1_str, data + offset, RLC_CL_CIPHERTEXT_SIZE);
-    auditor_ctx_alpha_c1_str[RLC_CL_CIPHERTEXT_SIZE] = 0;
-    offset += RLC_CL_CIPHERTEXT_SIZE;
-    memcpy(auditor_ctx_alpha_c2_str, data + offset, RLC_CL_CIPHERTEXT_SIZE);
-    auditor_ctx_alpha_c2_str[RLC_CL_CIPHERTEXT_SIZE] = 0;
-    offset += RLC_CL_CIPHERTEXT_SIZE;
-    auditor_ctx_alpha->c1 = gp_read_str(auditor_ctx_alpha_c1_str);
-    auditor_ctx_alpha->c2 = gp_read_str(auditor_ctx_alpha_c2_str);
+    if (cl_codec_read_ct(ctx_alpha, data, &offset, state->cl_params) != RLC_OK) {
+      fprintf(stderr, "[ERROR] 密文解码失败\n");
+      RLC_THROW(ERR_CAUGHT);
+    }
+    
+    if (cl_codec_read_ct(auditor_ctx_alpha, data, &offset, state->cl_params) != RLC_OK) {
+      fprintf(stderr, "[ERROR] 密文解码失败\n");
+      RLC_THROW(ERR_CAUGHT);
+    }
     printf("[ALICE] 反序列化原始谜题数据完成\n");
     
     // 3. 反序列化零知识证明
     printf("[ALICE] 开始反序列化零知识证明，当前offset: %zu\n", offset);
     size_t proof_read = 0;
-    if (zk_puzzle_relation_deserialize(puzzle_proof, data + offset, &proof_read) != RLC_OK) {
+    if (zk_puzzle_relation_deserialize(puzzle_proof, data + offset, &proof_read, state->cl_params) != RLC_OK) {
       printf("[ERROR] Alice: 无法反序列化puzzle_relation证明!\n");
       RLC_THROW(ERR_CAUGHT);
     }
@@ -1659,16 +1462,10 @@ int payment_init(alice_state_t state, void *socket, transaction_t *tx_data) {
     ec_write_bin(payment_init_msg->data + offset, RLC_EC_SIZE_COMPRESSED, state->g_to_the_alpha_times_beta_times_tau, 1); offset += RLC_EC_SIZE_COMPRESSED;
     // 修复：使用正确的tau版本密文
     {
-      char *s1 = GENtostr(state->ctx_alpha_times_beta_times_tau->c1);
-      char *s2 = GENtostr(state->ctx_alpha_times_beta_times_tau->c2);
-      size_t l1 = strlen(s1), l2 = strlen(s2);
-      uint8_t *d1 = payment_init_msg->data + offset;
-      uint8_t *d2 = payment_init_msg->data + offset + RLC_CL_CIPHERTEXT_SIZE;
-      memset(d1, 0, RLC_CL_CIPHERTEXT_SIZE);
-      memset(d2, 0, RLC_CL_CIPHERTEXT_SIZE);
-      memcpy(d1, s1, l1);
-      memcpy(d2, s2, l2);
-      offset += 2 * RLC_CL_CIPHERTEXT_SIZE;
+      if (cl_codec_write_ct(payment_init_msg->data, &offset, state->ctx_alpha_times_beta_times_tau) != RLC_OK) {
+        fprintf(stderr, "[ERROR] 密文编码失败\n");
+        RLC_THROW(ERR_CAUGHT);
+      }
     }
     // 附加auditor密文
     {
@@ -1699,15 +1496,10 @@ int payment_init(alice_state_t state, void *socket, transaction_t *tx_data) {
       // 打印当前offset位置
       printf("[ALICE DEBUG] 当前offset（序列化auditor密文前）: %zu\n", offset);
 
-      uint8_t *d1 = payment_init_msg->data + offset;
-      uint8_t *d2 = payment_init_msg->data + offset + RLC_CL_CIPHERTEXT_SIZE;
-      memset(d1, 0, RLC_CL_CIPHERTEXT_SIZE);
-      memset(d2, 0, RLC_CL_CIPHERTEXT_SIZE);
-      if (l1 > RLC_CL_CIPHERTEXT_SIZE - 1) l1 = RLC_CL_CIPHERTEXT_SIZE - 1;
-      if (l2 > RLC_CL_CIPHERTEXT_SIZE - 1) l2 = RLC_CL_CIPHERTEXT_SIZE - 1;
-      memcpy(d1, s1, l1);
-      memcpy(d2, s2, l2);
-      offset += 2 * RLC_CL_CIPHERTEXT_SIZE;
+      if (cl_codec_write_ct(payment_init_msg->data, &offset, auditor_ctx_alpha_times_beta_times_tau) != RLC_OK) {
+        fprintf(stderr, "[ERROR] 密文编码失败\n");
+        RLC_THROW(ERR_CAUGHT);
+      }
       
       printf("[ALICE DEBUG] auditor密文序列化完成，当前offset: %zu\n", offset);
     }
@@ -1735,35 +1527,19 @@ int payment_init(alice_state_t state, void *socket, transaction_t *tx_data) {
     
     // 2. 序列化 ctx_α+β (从Bob收到的Tumbler密文)
     {
-      char *s1 = GENtostr(state->ctx_alpha_times_beta->c1);
-      char *s2 = GENtostr(state->ctx_alpha_times_beta->c2);
-      size_t l1 = strlen(s1), l2 = strlen(s2);
-      uint8_t *d1 = payment_init_msg->data + offset;
-      uint8_t *d2 = payment_init_msg->data + offset + RLC_CL_CIPHERTEXT_SIZE;
-      memset(d1, 0, RLC_CL_CIPHERTEXT_SIZE);
-      memset(d2, 0, RLC_CL_CIPHERTEXT_SIZE);
-      if (l1 > RLC_CL_CIPHERTEXT_SIZE - 1) l1 = RLC_CL_CIPHERTEXT_SIZE - 1;
-      if (l2 > RLC_CL_CIPHERTEXT_SIZE - 1) l2 = RLC_CL_CIPHERTEXT_SIZE - 1;
-      memcpy(d1, s1, l1);
-      memcpy(d2, s2, l2);
-      offset += 2 * RLC_CL_CIPHERTEXT_SIZE;
+      if (cl_codec_write_ct(payment_init_msg->data, &offset, state->ctx_alpha_times_beta) != RLC_OK) {
+        fprintf(stderr, "[ERROR] 密文编码失败\n");
+        RLC_THROW(ERR_CAUGHT);
+      }
       printf("[ALICE] 序列化 ctx_α+β，当前offset: %zu\n", offset);
     }
     
     // 3. 序列化 auditor_ctx_α+β (从Bob收到的Auditor密文)
     {
-      char *s1 = GENtostr(state->auditor_ctx_alpha_times_beta->c1);
-      char *s2 = GENtostr(state->auditor_ctx_alpha_times_beta->c2);
-      size_t l1 = strlen(s1), l2 = strlen(s2);
-      uint8_t *d1 = payment_init_msg->data + offset;
-      uint8_t *d2 = payment_init_msg->data + offset + RLC_CL_CIPHERTEXT_SIZE;
-      memset(d1, 0, RLC_CL_CIPHERTEXT_SIZE);
-      memset(d2, 0, RLC_CL_CIPHERTEXT_SIZE);
-      if (l1 > RLC_CL_CIPHERTEXT_SIZE - 1) l1 = RLC_CL_CIPHERTEXT_SIZE - 1;
-      if (l2 > RLC_CL_CIPHERTEXT_SIZE - 1) l2 = RLC_CL_CIPHERTEXT_SIZE - 1;
-      memcpy(d1, s1, l1);
-      memcpy(d2, s2, l2);
-      offset += 2 * RLC_CL_CIPHERTEXT_SIZE;
+      if (cl_codec_write_ct(payment_init_msg->data, &offset, state->auditor_ctx_alpha_times_beta) != RLC_OK) {
+        fprintf(stderr, "[ERROR] 密文编码失败\n");
+        RLC_THROW(ERR_CAUGHT);
+      }
       printf("[ALICE] 序列化 auditor_ctx_α+β，最终offset: %zu\n", offset);
     }
     
@@ -1781,6 +1557,10 @@ int payment_init(alice_state_t state, void *socket, transaction_t *tx_data) {
     }
 
     memcpy(zmq_msg_data(&payment_init), serialized_message, total_msg_length);
+    if (mix_session_send_id(socket, state->alice_escrow_id) != RLC_OK) {
+      fprintf(stderr, "Error: could not send the session id (%s).\n", msg_type);
+      RLC_THROW(ERR_CAUGHT);
+    }
     rc = zmq_msg_send(&payment_init, socket, ZMQ_DONTWAIT);
     if (rc != total_msg_length) {
       fprintf(stderr, "Error: could not send the message (%s).\n", msg_type);
@@ -2263,6 +2043,7 @@ int main(int argc, char* argv[])
     double pure_computation_time = (get_timer_value("alice_total_computation_time") - get_timer_value("alice_blockchain_escrow_interaction")) / 1000.0;
     printf("Alice 纯计算时间（排除区块链交互）: %.5f 秒\n", pure_computation_time);
     
+    escrow_client_shared_close();
     clean();
     
     // 输出时间测量结果
@@ -3,6 +3,14 @@
 #include <string.h>
 #include <zmq.h>
 #include <unistd.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
 #include "auditor.h"
 #include "types.h"
 #include "util.h"
@@ -40,6 +48,29 @@ int verify_share_with_stored_commitment(auditor_state_t state, const secret_shar
     return result;
 }
 
+// 批量验证同一 msgid 的全部分片：承诺只加载一次，所有块合并为一次多标量乘法
+int verify_shares_with_stored_commitment(auditor_state_t state, const secret_share_t* shares, size_t num_shares,
+                                         const char* msgid, size_t* bad_index) {
+    vss_commitment_t* commitment = malloc(sizeof(vss_commitment_t));
+    if (commitment == NULL) {
+        return -1;
+    }
+    if (load_vss_commitment_from_file(msgid, commitment) != 0) {
+        printf("[VSS][Auditor] Error: Cannot load VSS commitment from file for msgid: %s\n", msgid);
+        free(commitment);
+        return -1;
+    }
+    
+    int result = verify_shares_with_commitment_batch(shares, num_shares, commitment, bad_index);
+    if (result == 0) {
+        printf("[VSS][Auditor] Batch verification of %zu shares successful for msgid: %s\n", num_shares, msgid);
+    } else {
+        printf("[VSS][Auditor] Batch verification failed for msgid: %s\n", msgid);
+    }
+    free(commitment);
+    return result;
+}
+
 // 不再需要 ZMQ 服务器，因为现在使用文件存储
 int start_vss_commitment_server(auditor_state_t state) {
     printf("[VSS][Auditor] VSS commitment server disabled - using file-based storage\n");
@@ -208,7 +239,168 @@ int read_alice_bob_tumbler_public_keys(auditor_state_t state) {
     return result_status;
 }
 
+// 所有取分片请求共用的 ZMQ 上下文（线程安全），进程内只创建一次
+static pthread_once_t auditor_zmq_once = PTHREAD_ONCE_INIT;
+static void *auditor_zmq_ctx = NULL;
+
+static void auditor_zmq_init(void) {
+    auditor_zmq_ctx = zmq_ctx_new();
+}
+
+static void *auditor_zmq_context(void) {
+    pthread_once(&auditor_zmq_once, auditor_zmq_init);
+    return auditor_zmq_ctx;
+}
+
+static long long auditor_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+// 一次按 msgid 取分片收集到的分片与信封
+typedef struct {
+    secret_share_t *shares;
+    int share_count;
+    size_t shares_capacity;
+    // 混合模式：分片是对称密钥的分享，载荷在信封中。各接收者返回的信封可能不同（某个接收者
+    // 可能返回伪造的信封），保留所有不同的信封，重构密钥后逐个尝试
+    uint8_t *envelopes[SECRET_SHARES];
+    size_t envelope_lens[SECRET_SHARES];
+    int envelope_count;
+} audit_share_set_t;
+
+// 解析接收者 receiver 的应答并加入 set；返回加入的分片数（NO_AUDIT_NEEDED 与错误应答为 0）
+static int collect_receiver_shares(audit_share_set_t *set, int receiver, const uint8_t *data, size_t size) {
+    // 检查是否是 "NO_AUDIT_NEEDED" 响应（用户身份合法，不需要审计）
+    // 请求已同时发给所有成员，每个成员都会记录自己的决策，这对于计算一致性和完整的决策历史很重要
+    if (size > 0 && strncmp((const char*)data, "NO_AUDIT_NEEDED", 15) == 0) {
+        printf("[AUDITOR] Receiver %d: ✅ 用户身份合法，无需审计\n", receiver + 1);
+        return 0;
+    }
+
+    // 检查是否是错误响应
+    if (size == 0 || strncmp((const char*)data, "NOT_FOUND", 9) == 0 ||
+        strncmp((const char*)data, "INSUFFICIENT", 12) == 0 ||
+        strncmp((const char*)data, "MEMORY_ERROR", 12) == 0) {
+        return 0;
+    }
+
+    int before = set->share_count;
+    // 解析新格式：participant_id || num_blocks || (block_index || block_size || data_length || share_value)...
+    if (size >= sizeof(int) + sizeof(size_t)) {
+        int participant_id;
+        size_t num_blocks;
+        memcpy(&participant_id, data, sizeof(int));
+        memcpy(&num_blocks, data + sizeof(int), sizeof(size_t));
+
+        printf("[AUDITOR] Received %zu blocks from participant %d\n", num_blocks, participant_id);
+
+        // 确保有足够的空间
+        if (set->share_count + num_blocks > set->shares_capacity) {
+            size_t capacity = set->share_count + num_blocks + 100;  // 额外100个作为缓冲
+            secret_share_t *grown = realloc(set->shares, capacity * sizeof(secret_share_t));
+            if (!grown) {
+                printf("[AUDITOR ERROR] Memory allocation failed\n");
+                return 0;
+            }
+            set->shares = grown;
+            set->shares_capacity = capacity;
+        }
+
+        // 解析每个块的分享
+        size_t offset = sizeof(int) + sizeof(size_t);
+        for (size_t block_idx = 0; block_idx < num_blocks && offset < size; block_idx++) {
+            if (offset + sizeof(size_t) * 3 + 4 > size) {
+                printf("[AUDITOR ERROR] Insufficient data for block %zu\n", block_idx);
+                break;
+            }
+
+            secret_share_t *share = &set->shares[set->share_count];
+            memset(share, 0, sizeof(secret_share_t));
+            share->x = participant_id;
+
+            memcpy(&share->block_index, data + offset, sizeof(size_t));
+            offset += sizeof(size_t);
+            memcpy(&share->block_size, data + offset, sizeof(size_t));
+            offset += sizeof(size_t);
+            memcpy(&share->data_length, data + offset, sizeof(size_t));
+            offset += sizeof(size_t);
+
+            // 读取share_value的大小
+            size_t share_data_size = data[offset] |
+                                    (data[offset + 1] << 8) |
+                                    (data[offset + 2] << 16) |
+                                    (data[offset + 3] << 24);
+            offset += 4;
+
+            if (offset + share_data_size > size) {
+                printf("[AUDITOR ERROR] Insufficient data for block %zu share value\n", block_idx);
+                break;
+            }
+
+            if (share_data_size > SHARE_VALUE_MAX) {
+                printf("[AUDITOR ERROR] Share value too large for block %zu\n", block_idx);
+                break;
+            }
+
+            memcpy(share->y, data + offset - 4, 4 + share_data_size);
+            offset += share_data_size;
+            share->is_valid = 1;
+            set->share_count++;
+        }
+
+        const uint8_t *trailer = NULL;
+        size_t trailer_len = 0;
+        if (offset < size && parse_share_envelope_trailer(data + offset, size - offset, &trailer, &trailer_len) == 0) {
+            int known = 0;
+            for (int e = 0; e < set->envelope_count && !known; e++) {
+                known = set->envelope_lens[e] == trailer_len && memcmp(set->envelopes[e], trailer, trailer_len) == 0;
+            }
+            if (!known && set->envelope_count < SECRET_SHARES &&
+                (set->envelopes[set->envelope_count] = malloc(trailer_len)) != NULL) {
+                memcpy(set->envelopes[set->envelope_count], trailer, trailer_len);
+                set->envelope_lens[set->envelope_count] = trailer_len;
+                set->envelope_count++;
+            }
+            printf("[AUDITOR] Participant %d returned %zu-byte payload envelope (hybrid mode, %s)\n",
+                   participant_id, trailer_len, known ? "same as an earlier one" : "new");
+        }
+    } else {
+        // 尝试旧格式（兼容性）
+        if ((size_t)set->share_count >= set->shares_capacity) {
+            size_t capacity = set->share_count + 10;
+            secret_share_t *grown = realloc(set->shares, capacity * sizeof(secret_share_t));
+            if (!grown) {
+                printf("[AUDITOR ERROR] Memory allocation failed\n");
+                return 0;
+            }
+            set->shares = grown;
+            set->shares_capacity = capacity;
+        }
+        secret_share_t *share = &set->shares[set->share_count];
+        memset(share, 0, sizeof(secret_share_t));
+        memcpy(&share->x, data, sizeof(int));
+        memcpy(&share->data_length, data + sizeof(int), sizeof(size_t));
+        if (share->data_length > sizeof(share->y) || sizeof(int) + sizeof(size_t) + share->data_length > size) {
+            printf("[AUDITOR ERROR] Legacy share too large (%zu bytes)\n", share->data_length);
+            return 0;
+        }
+        memcpy(share->y, data + sizeof(int) + sizeof(size_t), share->data_length);
+        share->block_index = 0;  // 默认值
+        share->block_size = share->data_length;  // 默认值
+        share->is_valid = 1;
+        set->share_count++;
+    }
+    return set->share_count - before;
+}
+
 // ========== 新增：按 msgid 请求并重构分片 ==========
+// 请求同时发给所有接收者，应答按到达顺序处理；凑齐 THRESHOLD 个成员的分片即开始重构，
+// 不再等待其余成员。其余成员的 socket 以 AUDITOR_UNANSWERED_LINGER_MS 的 linger 关闭：请求可能还排在
+// 尚未建立的连接上，linger 期间仍会发出；连接在此期间仍未建立的成员收不到请求，也不会记录决策。
+// 只有所有成员都应答后才能判断是否
+// 全部返回了 NO_AUDIT_NEEDED。
 static int fetch_shares_by_msgid(const char *msg_id, int tag, const char *pairs_summary_json, uint8_t **out_buf, size_t *out_len, auditor_state_t state) {
     if (msg_id == NULL || out_buf == NULL || out_len == NULL) return RLC_ERR;
     if (tag != 0 && tag != 1) {
@@ -218,216 +410,137 @@ static int fetch_shares_by_msgid(const char *msg_id, int tag, const char *pairs_
     *out_buf = NULL;
     *out_len = 0;
 
-    void* context = zmq_ctx_new();
+    void* context = auditor_zmq_context();
     if (!context) {
         printf("[AUDITOR ERROR] zmq_ctx_new failed\n");
         return RLC_ERR;
     }
 
-    // 动态分配数组以存储所有块的分享（每个参与者可能有多个块）
-    secret_share_t *shares = NULL;
-    int share_count = 0;
-    size_t shares_capacity = 0;
-
+    // 构造请求数据：tag(1字节) + msg_id(字符串) + '\0' + pairs_summary_json(字符串) + '\0'
+    // 所有接收者收到的请求相同，只构造一次
+    size_t msg_id_len = strlen(msg_id);
+    size_t json_len = (pairs_summary_json != NULL) ? strlen(pairs_summary_json) : 0;
+    size_t data_len = 1 + msg_id_len + 1 + json_len + 1;  // tag(1) + msg_id + '\0' + json + '\0'
+
+    message_t request; message_null(request);
+    message_new(request, strlen("AUDIT_REQUEST") + 1, data_len);
+    strcpy(request->type, "AUDIT_REQUEST");
+
+    // 初始化data为0，确保所有字节都被正确设置
+    memset(request->data, 0, data_len);
+
+    // 数据格式: [tag(1字节)] [msg_id(字符串)] ['\0'] [pairs_summary_json(字符串)] ['\0']
+    size_t offset = 0;
+    request->data[offset++] = (uint8_t)tag;  // tag
+    memcpy(request->data + offset, msg_id, msg_id_len);
+    offset += msg_id_len;
+    request->data[offset++] = '\0';  // msg_id结束符
+    if (pairs_summary_json != NULL && json_len > 0) {
+        memcpy(request->data + offset, pairs_summary_json, json_len);
+        offset += json_len;
+    }
+    request->data[offset] = '\0';  // json结束符
+
+    // 添加调试信息：打印构造的数据
+    printf("[AUDITOR] ========== 构造请求数据 ==========\n");
+    printf("[AUDITOR] msg_id=%s (length: %zu)\n", msg_id, msg_id_len);
+    printf("[AUDITOR] tag=%d, json_len=%zu, data_len=%zu\n", tag, json_len, data_len);
+    if (pairs_summary_json != NULL) {
+        printf("[AUDITOR] pairs_summary_json: %s\n", pairs_summary_json);
+    }
+    printf("[AUDITOR] ===================================\n");
+    uint8_t *serialized = NULL;
+    unsigned msg_type_length = strlen(request->type) + 1;
+    unsigned msg_data_length = data_len;  // 使用计算好的数据长度
+    serialize_message(&serialized, request, msg_type_length, msg_data_length);
+    size_t serialized_len = msg_type_length + msg_data_length + 2 * sizeof(unsigned);
+
+    // 同时向所有接收者发出请求
+    void *sockets[SECRET_SHARES];
+    int receivers[SECRET_SHARES];
+    zmq_pollitem_t items[SECRET_SHARES];
+    int pending = 0;
+    const int linger = 0;
     for (int i = 0; i < SECRET_SHARES; i++) {
         void* socket = zmq_socket(context, ZMQ_REQ);
         if (!socket) {
             printf("[AUDITOR ERROR] zmq_socket failed at %d\n", i);
             continue;
         }
-        int rc = zmq_connect(socket, RECEIVER_ENDPOINTS[i]);
-        if (rc != 0) {
+        zmq_setsockopt(socket, ZMQ_LINGER, &linger, sizeof(linger));
+        if (zmq_connect(socket, RECEIVER_ENDPOINTS[i]) != 0) {
             printf("[AUDITOR ERROR] connect %s failed: %s\n", RECEIVER_ENDPOINTS[i], zmq_strerror(zmq_errno()));
             zmq_close(socket);
             continue;
         }
-
-        // 构造请求数据：tag(1字节) + msg_id(字符串) + '\0' + pairs_summary_json(字符串) + '\0'
-        size_t msg_id_len = strlen(msg_id);
-        size_t json_len = (pairs_summary_json != NULL) ? strlen(pairs_summary_json) : 0;
-        size_t data_len = 1 + msg_id_len + 1 + json_len + 1;  // tag(1) + msg_id + '\0' + json + '\0'
-
-        message_t request; message_null(request);
-        message_new(request, strlen("AUDIT_REQUEST") + 1, data_len);
-        strcpy(request->type, "AUDIT_REQUEST");
-        
-        // 初始化data为0，确保所有字节都被正确设置
-        memset(request->data, 0, data_len);
-        
-        // 数据格式: [tag(1字节)] [msg_id(字符串)] ['\0'] [pairs_summary_json(字符串)] ['\0']
-        size_t offset = 0;
-        request->data[offset++] = (uint8_t)tag;  // tag
-        memcpy(request->data + offset, msg_id, msg_id_len);
-        offset += msg_id_len;
-        request->data[offset++] = '\0';  // msg_id结束符
-        if (pairs_summary_json != NULL && json_len > 0) {
-            memcpy(request->data + offset, pairs_summary_json, json_len);
-            offset += json_len;
-        }
-        request->data[offset] = '\0';  // json结束符
-        
-        // 添加调试信息：打印构造的数据
-        printf("[AUDITOR] ========== 构造请求数据 ==========\n");
-        printf("[AUDITOR] msg_id=%s (length: %zu)\n", msg_id, msg_id_len);
-        printf("[AUDITOR] tag=%d, json_len=%zu, data_len=%zu\n", tag, json_len, data_len);
-        printf("[AUDITOR] First 100 bytes of request->data: ");
-        size_t debug_len = (data_len < 100) ? data_len : 100;
-        for (size_t i = 0; i < debug_len; i++) {
-            if (request->data[i] >= 32 && request->data[i] < 127) {
-                printf("%c", request->data[i]);
-            } else {
-                printf("\\x%02x", (unsigned char)request->data[i]);
-            }
-        }
-        printf("\n");
-        if (pairs_summary_json != NULL) {
-            printf("[AUDITOR] pairs_summary_json: %s\n", pairs_summary_json);
-        }
-        printf("[AUDITOR] ===================================\n");
-        uint8_t *serialized = NULL;
-        unsigned msg_type_length = strlen(request->type) + 1;
-        unsigned msg_data_length = data_len;  // 使用计算好的数据长度
-        serialize_message(&serialized, request, msg_type_length, msg_data_length);
-        size_t serialized_len = msg_type_length + msg_data_length + 2 * sizeof(unsigned);
-
-        int send_rc = zmq_send(socket, serialized, serialized_len, 0);
-        if (send_rc != (int)serialized_len) {
+        if (zmq_send(socket, serialized, serialized_len, 0) != (int)serialized_len) {
             printf("[AUDITOR ERROR] send request failed to %s: %s\n", RECEIVER_ENDPOINTS[i], zmq_strerror(zmq_errno()));
             zmq_close(socket);
-            free(serialized);
-            message_free(request);
             continue;
         }
-
-        zmq_msg_t response; zmq_msg_init(&response);
-        int recv_rc = zmq_msg_recv(&response, socket, 0);
-        if (recv_rc < 0) {
-            printf("[AUDITOR ERROR] recv response failed from %s: %s\n", RECEIVER_ENDPOINTS[i], zmq_strerror(zmq_errno()));
-            zmq_msg_close(&response);
-            zmq_close(socket);
-            free(serialized);
-            message_free(request);
-            continue;
+        sockets[pending] = socket;
+        receivers[pending] = i;
+        pending++;
+    }
+    free(serialized);
+    message_free(request);
+
+    // 按到达顺序处理应答，直到凑齐 THRESHOLD 个成员的分片、全部应答或超时
+    audit_share_set_t set;
+    memset(&set, 0, sizeof(set));
+    int contributors = 0;
+    long long deadline = auditor_now_ms() + AUDITOR_FETCH_TIMEOUT_MS;
+    while (pending > 0 && contributors < THRESHOLD) {
+        long long wait_ms = deadline - auditor_now_ms();
+        if (wait_ms <= 0) {
+            printf("[AUDITOR ERROR] %d receiver(s) did not respond within %d ms\n", pending, AUDITOR_FETCH_TIMEOUT_MS);
+            break;
         }
-
-        uint8_t *data = zmq_msg_data(&response);
-        size_t size = zmq_msg_size(&response);
-        
-        // 检查是否是 "NO_AUDIT_NEEDED" 响应（用户身份合法，不需要审计）
-        // 注意：即使收到NO_AUDIT_NEEDED，我们仍然继续向其他成员发送请求，以便记录所有成员的决策
-        // 这对于计算一致性和完整的决策历史很重要
-        int is_no_audit_needed = (size > 0 && strncmp((char*)data, "NO_AUDIT_NEEDED", 15) == 0);
-        if (is_no_audit_needed) {
-            printf("[AUDITOR] Receiver %d: ✅ 用户身份合法，无需审计（但继续收集其他成员的决策）\n", i + 1);
-            // 不直接返回，继续处理其他receiver，以便记录所有成员的决策
-            // 标记为"不需要审计"，但继续循环
-            zmq_msg_close(&response);
-            zmq_close(socket);
-            free(serialized);
-            message_free(request);
-            continue;  // 继续处理下一个receiver，而不是直接返回
+        for (int j = 0; j < pending; j++) {
+            items[j].socket = sockets[j];
+            items[j].fd = 0;
+            items[j].events = ZMQ_POLLIN;
+            items[j].revents = 0;
         }
-        
-        // 检查是否是错误响应
-        if (size > 0 && strncmp((char*)data, "NOT_FOUND", 9) != 0 && 
-            strncmp((char*)data, "INSUFFICIENT", 12) != 0 &&
-            strncmp((char*)data, "MEMORY_ERROR", 12) != 0) {
-            
-            // 解析新格式：participant_id || num_blocks || (block_index || block_size || data_length || share_value)...
-            if (size >= sizeof(int) + sizeof(size_t)) {
-                int participant_id;
-                size_t num_blocks;
-                memcpy(&participant_id, data, sizeof(int));
-                memcpy(&num_blocks, data + sizeof(int), sizeof(size_t));
-                
-                printf("[AUDITOR] Received %zu blocks from participant %d\n", num_blocks, participant_id);
-                
-                // 确保有足够的空间
-                if (share_count + num_blocks > shares_capacity) {
-                    shares_capacity = share_count + num_blocks + 100;  // 额外100个作为缓冲
-                    shares = realloc(shares, shares_capacity * sizeof(secret_share_t));
-                    if (!shares) {
-                        printf("[AUDITOR ERROR] Memory allocation failed\n");
-                        zmq_msg_close(&response);
-                        zmq_close(socket);
-                        free(serialized);
-                        message_free(request);
-                        continue;
-                    }
-                }
-                
-                // 解析每个块的分享
-                size_t offset = sizeof(int) + sizeof(size_t);
-                for (size_t block_idx = 0; block_idx < num_blocks && offset < size; block_idx++) {
-                    if (offset + sizeof(size_t) * 3 + 4 > size) {
-                        printf("[AUDITOR ERROR] Insufficient data for block %zu\n", block_idx);
-                        break;
-                    }
-                    
-                    secret_share_t *share = &shares[share_count];
-                    memset(share, 0, sizeof(secret_share_t));
-                    share->x = participant_id;
-                    
-                    memcpy(&share->block_index, data + offset, sizeof(size_t));
-                    offset += sizeof(size_t);
-                    memcpy(&share->block_size, data + offset, sizeof(size_t));
-                    offset += sizeof(size_t);
-                    memcpy(&share->data_length, data + offset, sizeof(size_t));
-                    offset += sizeof(size_t);
-                    
-                    // 读取share_value的大小
-                    size_t share_data_size = data[offset] |
-                                            (data[offset + 1] << 8) |
-                                            (data[offset + 2] << 16) |
-                                            (data[offset + 3] << 24);
-                    offset += 4;
-                    
-                    if (offset + share_data_size > size) {
-                        printf("[AUDITOR ERROR] Insufficient data for block %zu share value\n", block_idx);
-                        break;
-                    }
-                    
-                    if (share_data_size + 4 > SHARE_SIZE) {
-                        printf("[AUDITOR ERROR] Share value too large for block %zu\n", block_idx);
-                        break;
-                    }
-                    
-                    memcpy(share->y, data + offset - 4, 4 + share_data_size);
-                    offset += share_data_size;
-                    share->is_valid = 1;
-                    share_count++;
-                }
-            } else {
-                // 尝试旧格式（兼容性）
-                secret_share_t *share;
-                if (share_count >= shares_capacity) {
-                    shares_capacity = share_count + 10;
-                    shares = realloc(shares, shares_capacity * sizeof(secret_share_t));
-                    if (!shares) {
-                        printf("[AUDITOR ERROR] Memory allocation failed\n");
-                        zmq_msg_close(&response);
-                        zmq_close(socket);
-                        free(serialized);
-                        message_free(request);
-                        continue;
-                    }
-                }
-                share = &shares[share_count];
-                memcpy(&share->x, data, sizeof(int));
-                memcpy(&share->data_length, data + sizeof(int), sizeof(size_t));
-                memcpy(share->y, data + sizeof(int) + sizeof(size_t), share->data_length);
-                share->block_index = 0;  // 默认值
-                share->block_size = share->data_length;  // 默认值
-                share->is_valid = 1;
-                share_count++;
+        if (zmq_poll(items, pending, (long)wait_ms) < 0) {
+            if (zmq_errno() == EINTR) {
+                continue;
             }
+            printf("[AUDITOR ERROR] zmq_poll failed: %s\n", zmq_strerror(zmq_errno()));
+            break;
+        }
+        // 从后往前处理，已应答的 socket 用末尾元素填补
+        for (int j = pending - 1; j >= 0; j--) {
+            if (!(items[j].revents & ZMQ_POLLIN)) {
+                continue;
+            }
+            int i = receivers[j];
+            zmq_msg_t response; zmq_msg_init(&response);
+            if (zmq_msg_recv(&response, sockets[j], ZMQ_DONTWAIT) < 0) {
+                printf("[AUDITOR ERROR] recv response failed from %s: %s\n", RECEIVER_ENDPOINTS[i], zmq_strerror(zmq_errno()));
+            } else if (collect_receiver_shares(&set, i, zmq_msg_data(&response), zmq_msg_size(&response)) > 0) {
+                contributors++;
+            }
+            zmq_msg_close(&response);
+            zmq_close(sockets[j]);
+            pending--;
+            sockets[j] = sockets[pending];
+            receivers[j] = receivers[pending];
         }
-
-        zmq_msg_close(&response);
-        zmq_close(socket);
-        free(serialized);
-        message_free(request);
     }
+    if (pending > 0 && contributors >= THRESHOLD) {
+        printf("[AUDITOR] 已收到 %d 个成员的分片，不再等待其余 %d 个成员\n", contributors, pending);
+    }
+    const int unanswered_linger = AUDITOR_UNANSWERED_LINGER_MS;
+    for (int j = 0; j < pending; j++) {
+        zmq_setsockopt(sockets[j], ZMQ_LINGER, &unanswered_linger, sizeof(unanswered_linger));
+        zmq_close(sockets[j]);
+    }
+    int all_responded = (pending == 0);
+
+    secret_share_t *shares = set.shares;
+    int share_count = set.share_count;
+    int hybrid = (set.envelope_count > 0);
 
     // 检查是否所有成员都返回了NO_AUDIT_NEEDED（用于判断是否真的不需要审计）
     // 如果所有成员都返回NO_AUDIT_NEEDED，则返回特殊状态
@@ -439,13 +552,11 @@ static int fetch_shares_by_msgid(const char *msg_id, int tag, const char *pairs_
         // ===== VSS: 验证所有分片 =====
         printf("[VSS][Auditor] Verifying %d shares before reconstruction\n", share_count);
         int all_shares_valid = 1;
-        for (int i = 0; i < share_count; i++) {
-            if (verify_share_with_stored_commitment(state, &shares[i], msg_id) != 0) {
-                printf("[VSS][Auditor] Share %d (x=%d, block_index=%zu) verification failed\n", 
-                       i, shares[i].x, shares[i].block_index);
-                all_shares_valid = 0;
-                break;
-            }
+        size_t bad_index = 0;
+        if (verify_shares_with_stored_commitment(state, shares, (size_t)share_count, msg_id, &bad_index) != 0) {
+            printf("[VSS][Auditor] Share %zu (x=%d, block_index=%zu) verification failed\n", 
+                   bad_index, shares[bad_index].x, shares[bad_index].block_index);
+            all_shares_valid = 0;
         }
         
         if (all_shares_valid) {
@@ -473,7 +584,11 @@ static int fetch_shares_by_msgid(const char *msg_id, int tag, const char *pairs_
             
             uint8_t *reconstructed = (uint8_t*)malloc(MAX_MESSAGE_SIZE);
             size_t data_length = 0;
-            if (reconstruct_secret_from_shares(shares, share_count, reconstructed, &data_length) == 0) {
+            int reconstruct_result = hybrid
+                ? reconstruct_hybrid_secret(shares, share_count, (const uint8_t *const *)set.envelopes, set.envelope_lens,
+                                            set.envelope_count, msg_id, reconstructed, &data_length)
+                : reconstruct_secret_from_shares(shares, share_count, reconstructed, &data_length);
+            if (reconstruct_result == 0) {
                 printf("[VSS][Auditor] 重构成功，数据长度: %zu\n", data_length);
                 printf("[VSS][Auditor] 重构数据前64字节: ");
                 for (size_t i = 0; i < 64 && i < data_length; i++) {
@@ -528,7 +643,8 @@ static int fetch_shares_by_msgid(const char *msg_id, int tag, const char *pairs_
                 ret = RLC_OK;
             } else {
                 free(reconstructed);
-                printf("[AUDITOR ERROR] reconstruct_secret_from_shares failed\n");
+                printf("[AUDITOR ERROR] %s failed\n",
+                       hybrid ? "reconstruct_hybrid_secret" : "reconstruct_secret_from_shares");
             }
         } else {
             printf("[VSS][Auditor] Share verification failed, skipping reconstruction\n");
@@ -536,8 +652,8 @@ static int fetch_shares_by_msgid(const char *msg_id, int tag, const char *pairs_
     } else {
         printf("[AUDITOR ERROR] Insufficient shares: %d < %d\n", share_count, THRESHOLD);
         // 如果share_count == 0，可能是所有成员都返回了NO_AUDIT_NEEDED
-        // 这种情况下，我们返回特殊状态表示用户身份合法
-        if (share_count == 0) {
+        // 这种情况下，我们返回特殊状态表示用户身份合法（有成员超时未应答时不能下此结论）
+        if (share_count == 0 && all_responded) {
             printf("[AUDITOR] 所有成员都判断用户身份合法，无需审计\n");
             *out_buf = NULL;
             *out_len = 0;
@@ -548,7 +664,9 @@ static int fetch_shares_by_msgid(const char *msg_id, int tag, const char *pairs_
     if (shares) {
         free(shares);
     }
-    zmq_ctx_destroy(context);
+    for (int e = 0; e < set.envelope_count; e++) {
+        free(set.envelopes[e]);
+    }
     return ret;
 }
 
@@ -590,7 +708,7 @@ static void parse_tumbler_second_share(const uint8_t *buf, size_t len, auditor_s
     printf("[AUDITOR] 使用标准反序列化函数解析ZK证明...\n");
     
     size_t zk_parsed = 0;
-    if (zk_comprehensive_puzzle_deserialize(state->tumbler_zk_proof, buf + off, &zk_parsed) != RLC_OK) {
+    if (zk_comprehensive_puzzle_deserialize(state->tumbler_zk_proof, buf + off, &zk_parsed, state->cl_params) != RLC_OK) {
         printf("[AUDITOR ERROR] ZK证明反序列化失败!\n");
         return;
     }
@@ -711,33 +829,31 @@ static void parse_tumbler_second_share(const uint8_t *buf, size_t len, auditor_s
     
     // 解密 ctx_r0_auditor
     {
-        // 验证格式是否像 Qfb(...)
-        int looks_qfb_1 = (strncmp(ctx_r0_c1, "Qfb(", 4) == 0);
-        int looks_qfb_2 = (strncmp(ctx_r0_c2, "Qfb(", 4) == 0);
-        if (!(looks_qfb_1 && looks_qfb_2)) {
-            printf("[AUDITOR ERROR] ctx_r0 c1/c2 not in Qfb(...) format. Skip decrypt to avoid PARI error.\n");
-            printf("[AUDITOR DEBUG] ctx_r0.c1 raw: %.64s...\n", ctx_r0_c1);
-            printf("[AUDITOR DEBUG] ctx_r0.c2 raw: %.64s...\n", ctx_r0_c2);
+        cl_ciphertext_t ctx_r0;
+        cl_ciphertext_new(ctx_r0);
+        ctx_r0->c1 = cl_codec_read((const uint8_t *) ctx_r0_c1, ctx_r0_c1_len, state->cl_params);
+        ctx_r0->c2 = cl_codec_read((const uint8_t *) ctx_r0_c2, ctx_r0_c2_len, state->cl_params);
+        if (ctx_r0->c1 == NULL || ctx_r0->c2 == NULL) {
+            printf("[AUDITOR ERROR] ctx_r0 c1/c2 解码失败，跳过解密\n");
         } else {
-            cl_ciphertext_t ctx_r0;
-            cl_ciphertext_new(ctx_r0);
-            ctx_r0->c1 = gcopy(gp_read_str(ctx_r0_c1));  // ⚠️ 使用 gcopy 创建永久副本
-            ctx_r0->c2 = gcopy(gp_read_str(ctx_r0_c2));  // ⚠️ 使用 gcopy 创建永久副本
+            ctx_r0->c1 = gcopy(ctx_r0->c1);  // ⚠️ 使用 gcopy 创建永久副本
+            ctx_r0->c2 = gcopy(ctx_r0->c2);  // ⚠️ 使用 gcopy 创建永久副本
             
             GEN r0_plain;
             if (cl_dec(&r0_plain, ctx_r0, state->auditor_cl_sk, state->cl_params) == RLC_OK) {
                 printf("[AUDITOR] ✅ ctx_r0_auditor 解密成功: r0 = %s\n", GENtostr(r0_plain));
                 // 保存 r0 供后续验证
                 if (!has_saved_r0) {
-                    saved_r0 = r0_plain;
+                    // 跨审计保留：复制到堆上，不受监控模式回收 PARI 栈影响
+                    saved_r0 = gclone(r0_plain);
                     has_saved_r0 = 1;
                     printf("[AUDITOR] 已保存 r0 供后续验证\n");
                 }
             } else {
                 printf("[AUDITOR ERROR] ctx_r0_auditor 解密失败\n");
             }
-            cl_ciphertext_free(ctx_r0);
         }
+        cl_ciphertext_free(ctx_r0);
     }
     
     // 4) 预签名完整结构：r|s|R|pi.a|pi.b|pi.z
@@ -862,14 +978,14 @@ static void parse_tumbler_second_share(const uint8_t *buf, size_t len, auditor_s
     // 2. ctx_alpha (从第二个分片解析得到)
     cl_ciphertext_t ctx_alpha_pt;
     cl_ciphertext_new(ctx_alpha_pt);
-    ctx_alpha_pt->c1 = gcopy(gp_read_str(ctx_alpha_c1));
-    ctx_alpha_pt->c2 = gcopy(gp_read_str(ctx_alpha_c2));
+    ctx_alpha_pt->c1 = cl_codec_read((const uint8_t *) ctx_alpha_c1, ctx_alpha_c1_len, state->cl_params);
+    ctx_alpha_pt->c2 = cl_codec_read((const uint8_t *) ctx_alpha_c2, ctx_alpha_c2_len, state->cl_params);
     
     // 3. ctx_r0_auditor (从第二个分片解析得到)
     cl_ciphertext_t ctx_r0_auditor_pt;
     cl_ciphertext_new(ctx_r0_auditor_pt);
-    ctx_r0_auditor_pt->c1 = gcopy(gp_read_str(ctx_r0_c1));
-    ctx_r0_auditor_pt->c2 = gcopy(gp_read_str(ctx_r0_c2));
+    ctx_r0_auditor_pt->c1 = cl_codec_read((const uint8_t *) ctx_r0_c1, ctx_r0_c1_len, state->cl_params);
+    ctx_r0_auditor_pt->c2 = cl_codec_read((const uint8_t *) ctx_r0_c2, ctx_r0_c2_len, state->cl_params);
     
     // 4. 重新计算g^r0
     char *r0_str_verify = GENtostr(saved_r0);
@@ -898,7 +1014,9 @@ static void parse_tumbler_second_share(const uint8_t *buf, size_t len, auditor_s
     printf("\n");
     
     // 执行验证
-    if (zk_comprehensive_puzzle_verify(state->tumbler_zk_proof, g_alpha_pt, ctx_alpha_pt, ctx_r0_auditor_pt,
+    if (ctx_alpha_pt->c1 == NULL || ctx_alpha_pt->c2 == NULL
+        || ctx_r0_auditor_pt->c1 == NULL || ctx_r0_auditor_pt->c2 == NULL
+        || zk_comprehensive_puzzle_verify(state->tumbler_zk_proof, g_alpha_pt, ctx_alpha_pt, ctx_r0_auditor_pt,
                                        state->tumbler_cl_pk, state->auditor_cl_pk, state->cl_params) != RLC_OK) {
         printf("[AUDITOR ERROR] 综合谜题零知识证明验证失败!\n");
     } else {
@@ -1061,8 +1179,7 @@ static void parse_tumbler_share(const uint8_t *buf, size_t len, auditor_state_t
     if (!ctx_c2) { printf("[AUDITOR ERROR] malloc failed for ctx_c2\n"); goto cleanup; }
     memcpy(ctx_c2, buf + off, ctx_c2_len); ctx_c2[ctx_c2_len] = 0; off += ctx_c2_len;
     
-    printf("[AUDITOR] ctx_alpha_beta_tau.c1 (len=%zu, head32): %.32s\n", ctx_c1_len, ctx_c1);
-    printf("[AUDITOR] ctx_alpha_beta_tau.c2 (len=%zu, head32): %.32s\n", ctx_c2_len, ctx_c2);
+    printf("[AUDITOR] ctx_alpha_beta_tau.c1 len=%zu, c2 len=%zu\n", ctx_c1_len, ctx_c2_len);
 
     // 3) auditor 最终密文 (+tau) - 使用长度前缀格式
     // 读取auditor c1长度和数据
@@ -1083,19 +1200,17 @@ static void parse_tumbler_share(const uint8_t *buf, size_t len, auditor_state_t
     if (!aud_c2) { printf("[AUDITOR ERROR] malloc failed for aud_c2\n"); goto cleanup; }
     memcpy(aud_c2, buf + off, aud_c2_len); aud_c2[aud_c2_len] = 0; off += aud_c2_len;
     
-    printf("[AUDITOR] auditor(+tau).c1 (len=%zu, head32): %.32s\n", aud_c1_len, aud_c1);
-    printf("[AUDITOR] auditor(+tau).c2 (len=%zu, head32): %.32s\n", aud_c2_len, aud_c2);
+    printf("[AUDITOR] auditor(+tau).c1 len=%zu, c2 len=%zu\n", aud_c1_len, aud_c2_len);
     
     // 解密 auditor(+tau) 密文得到 (r0+β+τ)
     {
-        // 验证格式是否像 Qfb(...)
-        int looks_qfb_1 = (strncmp(aud_c1, "Qfb(", 4) == 0);
-        int looks_qfb_2 = (strncmp(aud_c2, "Qfb(", 4) == 0);
-        if (looks_qfb_1 && looks_qfb_2) {
+        GEN aud_c1_form = cl_codec_read((const uint8_t *) aud_c1, aud_c1_len, state->cl_params);
+        GEN aud_c2_form = cl_codec_read((const uint8_t *) aud_c2, aud_c2_len, state->cl_params);
+        if (aud_c1_form != NULL && aud_c2_form != NULL) {
             cl_ciphertext_t aud_ct;
             cl_ciphertext_new(aud_ct);
-            aud_ct->c1 = gcopy(gp_read_str(aud_c1));  // ⚠️ 使用 gcopy 创建永久副本
-            aud_ct->c2 = gcopy(gp_read_str(aud_c2));  // ⚠️ 使用 gcopy 创建永久副本
+            aud_ct->c1 = gcopy(aud_c1_form);  // ⚠️ 使用 gcopy 创建永久副本
+            aud_ct->c2 = gcopy(aud_c2_form);  // ⚠️ 使用 gcopy 创建永久副本
             
             GEN r0_beta_tau_plain;
             if (cl_dec(&r0_beta_tau_plain, aud_ct, state->auditor_cl_sk, state->cl_params) == RLC_OK) {
@@ -1110,7 +1225,7 @@ static void parse_tumbler_share(const uint8_t *buf, size_t len, auditor_state_t
                 bn_free(qhex); bn_free(r0bt_bn);
                 // 保存 (r0+β+τ) 供后续验证
                 if (!has_saved_r0_beta_tau) {
-                    saved_r0_beta_tau = r0_beta_tau_plain;
+                    saved_r0_beta_tau = gclone(r0_beta_tau_plain);
                     has_saved_r0_beta_tau = 1;
                     printf("[AUDITOR] 已保存 (r0+β+τ) 供后续验证\n");
                 }
@@ -1121,7 +1236,7 @@ static void parse_tumbler_share(const uint8_t *buf, size_t len, auditor_state_t
             }
             cl_ciphertext_free(aud_ct);
         } else {
-            printf("[AUDITOR ERROR] auditor(+tau) c1/c2 not in Qfb(...) format. Skip decrypt.\n");
+            printf("[AUDITOR ERROR] auditor(+tau) c1/c2 解码失败，跳过解密\n");
         }
     }
 
@@ -1232,32 +1347,16 @@ static void parse_tumbler_share(const uint8_t *buf, size_t len, auditor_state_t
         printf("[AUDITOR ERROR] buffer too small for ctx_α+β from Bob\n"); 
         goto cleanup; 
     }
-    char bob_ctx_c1[RLC_CL_CIPHERTEXT_SIZE + 1];
-    char bob_ctx_c2[RLC_CL_CIPHERTEXT_SIZE + 1];
-    memcpy(bob_ctx_c1, buf + off, RLC_CL_CIPHERTEXT_SIZE); 
-    bob_ctx_c1[RLC_CL_CIPHERTEXT_SIZE] = 0; 
-    off += RLC_CL_CIPHERTEXT_SIZE;
-    memcpy(bob_ctx_c2, buf + off, RLC_CL_CIPHERTEXT_SIZE); 
-    bob_ctx_c2[RLC_CL_CIPHERTEXT_SIZE] = 0; 
-    off += RLC_CL_CIPHERTEXT_SIZE;
-    printf("[AUDITOR] ctx_α+β from Bob.c1 (前32字符): %.32s\n", bob_ctx_c1);
-    printf("[AUDITOR] ctx_α+β from Bob.c2 (前32字符): %.32s\n", bob_ctx_c2);
+    const uint8_t *bob_ctx_slot = buf + off;
+    off += 2 * RLC_CL_CIPHERTEXT_SIZE;
     
     // 3) auditor_ctx_α+β (从Bob收到的Auditor密文)
     if (off + 2 * RLC_CL_CIPHERTEXT_SIZE > len) { 
         printf("[AUDITOR ERROR] buffer too small for auditor_ctx_α+β from Bob\n"); 
         goto cleanup; 
     }
-    char bob_aud_c1[RLC_CL_CIPHERTEXT_SIZE + 1];
-    char bob_aud_c2[RLC_CL_CIPHERTEXT_SIZE + 1];
-    memcpy(bob_aud_c1, buf + off, RLC_CL_CIPHERTEXT_SIZE); 
-    bob_aud_c1[RLC_CL_CIPHERTEXT_SIZE] = 0; 
-    off += RLC_CL_CIPHERTEXT_SIZE;
-    memcpy(bob_aud_c2, buf + off, RLC_CL_CIPHERTEXT_SIZE); 
-    bob_aud_c2[RLC_CL_CIPHERTEXT_SIZE] = 0; 
-    off += RLC_CL_CIPHERTEXT_SIZE;
-    printf("[AUDITOR] auditor_ctx_α+β from Bob.c1 (前32字符): %.32s\n", bob_aud_c1);
-    printf("[AUDITOR] auditor_ctx_α+β from Bob.c2 (前32字符): %.32s\n", bob_aud_c2);
+    const uint8_t *bob_aud_slot = buf + off;
+    off += 2 * RLC_CL_CIPHERTEXT_SIZE;
     
     // ========== 新增：解析Alice的零知识证明 ==========
     printf("[AUDITOR] ========== 开始解析Alice的零知识证明 ==========\n");
@@ -1276,7 +1375,7 @@ static void parse_tumbler_share(const uint8_t *buf, size_t len, auditor_state_t
     zk_proof_puzzle_relation_t alice_zk_proof;
     zk_proof_puzzle_relation_new(alice_zk_proof);
     size_t proof_read = 0;
-    if (zk_puzzle_relation_deserialize(alice_zk_proof, buf + off, &proof_read) != RLC_OK) {
+    if (zk_puzzle_relation_deserialize(alice_zk_proof, buf + off, &proof_read, state->cl_params) != RLC_OK) {
         printf("[AUDITOR ERROR] 无法反序列化Alice的零知识证明!\n");
         zk_proof_puzzle_relation_free(alice_zk_proof);
         goto cleanup;
@@ -1295,14 +1394,20 @@ static void parse_tumbler_share(const uint8_t *buf, size_t len, auditor_state_t
     cl_ciphertext_new(auditor_ctx_alpha_beta_tau);
     
     // 设置密文数据
-    bob_ctx_alpha_beta->c1 = gp_read_str(bob_ctx_c1);
-    bob_ctx_alpha_beta->c2 = gp_read_str(bob_ctx_c2);
-    ctx_alpha_beta_tau->c1 = gp_read_str(ctx_c1);
-    ctx_alpha_beta_tau->c2 = gp_read_str(ctx_c2);
-    bob_auditor_ctx_alpha_beta->c1 = gp_read_str(bob_aud_c1);
-    bob_auditor_ctx_alpha_beta->c2 = gp_read_str(bob_aud_c2);
-    auditor_ctx_alpha_beta_tau->c1 = gp_read_str(aud_c1);
-    auditor_ctx_alpha_beta_tau->c2 = gp_read_str(aud_c2);
+    size_t bob_ctx_off = 0, bob_aud_off = 0;
+    int ct_ok = RLC_OK;
+    if (cl_codec_read_ct(bob_ctx_alpha_beta, bob_ctx_slot, &bob_ctx_off, state->cl_params) != RLC_OK
+        || cl_codec_read_ct(bob_auditor_ctx_alpha_beta, bob_aud_slot, &bob_aud_off, state->cl_params) != RLC_OK) {
+        ct_ok = RLC_ERR;
+    }
+    ctx_alpha_beta_tau->c1 = cl_codec_read((const uint8_t *) ctx_c1, ctx_c1_len, state->cl_params);
+    ctx_alpha_beta_tau->c2 = cl_codec_read((const uint8_t *) ctx_c2, ctx_c2_len, state->cl_params);
+    auditor_ctx_alpha_beta_tau->c1 = cl_codec_read((const uint8_t *) aud_c1, aud_c1_len, state->cl_params);
+    auditor_ctx_alpha_beta_tau->c2 = cl_codec_read((const uint8_t *) aud_c2, aud_c2_len, state->cl_params);
+    if (ctx_alpha_beta_tau->c1 == NULL || ctx_alpha_beta_tau->c2 == NULL
+        || auditor_ctx_alpha_beta_tau->c1 == NULL || auditor_ctx_alpha_beta_tau->c2 == NULL) {
+        ct_ok = RLC_ERR;
+    }
     
     // 构建椭圆曲线点
     ec_t g_alpha_beta_pt, g_alpha_beta_tau_pt;
@@ -1311,7 +1416,7 @@ static void parse_tumbler_share(const uint8_t *buf, size_t len, auditor_state_t
     ec_read_bin(g_alpha_beta_pt, g_alpha_beta, RLC_EC_SIZE_COMPRESSED);
     ec_read_bin(g_alpha_beta_tau_pt, g_abt, RLC_EC_SIZE_COMPRESSED);
     
-    if (zk_puzzle_relation_verify(alice_zk_proof,
+    if (ct_ok != RLC_OK || zk_puzzle_relation_verify(alice_zk_proof,
                                  g_alpha_beta_pt, // g^(α+β)
                                  g_alpha_beta_tau_pt, // g^(α+β+τ)
                                  bob_ctx_alpha_beta, // ctx_α+β
@@ -2534,120 +2639,585 @@ static int request_dkg_shares_and_reconstruct(auditor_state_t state) {
 
 // ========== CSV监控模式相关函数 ==========
 
-// 存储已处理的交易哈希
+// 监控方式：
+//   - 记住已读到的字节偏移，每次只读取新增的完整行；
+//   - 用 inotify 监听 CSV 所在目录，文件有变化时立即唤醒，inotify 不可用时退化为定时轮询；
+//   - 检测程序更新交易状态时会原地重写整个文件（fopen "w"），因此 inode 改变、文件变短
+//     或最后读到的那一行内容不再位于原偏移时，从头重新扫描（去重集合保证不会重复审计）；
+//   - 已审计的交易哈希保存在哈希集合中，审计完成后追加到 <csv>.audited，重启时加载。
+#define MONITOR_FALLBACK_INTERVAL_MS 5000
+#define MONITOR_AUDITED_SUFFIX ".audited"
+#define MONITOR_LAST_LINE_MAX 512
+
+// 已处理交易哈希的集合（开放寻址），并持久化到审计日志
+typedef struct {
+    char **slots;
+    size_t capacity;   // 2 的幂
+    size_t count;
+    FILE *log;         // 已审计哈希，一行一个
+} processed_txhash_set_t;
+
+// CSV 追踪状态
 typedef struct {
-    char **hashes;
-    int count;
-    int capacity;
-} processed_txhash_list_t;
-
-// 初始化已处理列表
-static void init_processed_list(processed_txhash_list_t *list) {
-    list->capacity = 100;
-    list->count = 0;
-    list->hashes = (char**)malloc(list->capacity * sizeof(char*));
-    for (int i = 0; i < list->capacity; i++) {
-        list->hashes[i] = NULL;
+    const char *path;
+    char dir[512];
+    char name[256];
+    int inotify_fd;
+    int watch_fd;
+    int has_file;
+    dev_t dev;
+    ino_t inode;
+    off_t offset;                           // 已消费的字节数（只包含完整行）
+    char last_line[MONITOR_LAST_LINE_MAX];  // 偏移之前最后一行的末尾部分，用于识别文件被重写
+    size_t last_line_len;
+} csv_follower_t;
+
+static uint64_t txhash_hash(const char *s) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (const unsigned char *p = (const unsigned char *)s; *p; p++) {
+        h ^= *p;
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+static int processed_set_grow(processed_txhash_set_t *set) {
+    size_t capacity = set->capacity ? set->capacity * 2 : 1024;
+    char **slots = (char **)calloc(capacity, sizeof(char *));
+    if (!slots) {
+        return -1;
+    }
+    for (size_t i = 0; i < set->capacity; i++) {
+        if (set->slots[i]) {
+            size_t j = (size_t)txhash_hash(set->slots[i]) & (capacity - 1);
+            while (slots[j]) {
+                j = (j + 1) & (capacity - 1);
+            }
+            slots[j] = set->slots[i];
+        }
     }
+    free(set->slots);
+    set->slots = slots;
+    set->capacity = capacity;
+    return 0;
 }
 
-// 释放已处理列表
-static void free_processed_list(processed_txhash_list_t *list) {
-    for (int i = 0; i < list->count; i++) {
-        if (list->hashes[i]) {
-            free(list->hashes[i]);
+// 加入集合；已存在返回 0，新加入返回 1，失败返回 -1
+static int processed_set_add(processed_txhash_set_t *set, const char *txhash) {
+    if ((set->count + 1) * 2 > set->capacity && processed_set_grow(set) != 0) {
+        return -1;
+    }
+    size_t i = (size_t)txhash_hash(txhash) & (set->capacity - 1);
+    while (set->slots[i]) {
+        if (strcmp(set->slots[i], txhash) == 0) {
+            return 0;
         }
+        i = (i + 1) & (set->capacity - 1);
     }
-    free(list->hashes);
+    set->slots[i] = strdup(txhash);
+    if (!set->slots[i]) {
+        return -1;
+    }
+    set->count++;
+    return 1;
 }
 
-// 检查是否已处理
-static int is_processed(processed_txhash_list_t *list, const char *txhash) {
-    for (int i = 0; i < list->count; i++) {
-        if (list->hashes[i] && strcmp(list->hashes[i], txhash) == 0) {
-            return 1;
+// 初始化集合并加载 <csv>.audited 中已审计的哈希
+static void init_processed_set(processed_txhash_set_t *set, const char *csv_file) {
+    char log_path[1024];
+    snprintf(log_path, sizeof(log_path), "%s%s", csv_file, MONITOR_AUDITED_SUFFIX);
+    memset(set, 0, sizeof(*set));
+
+    FILE *fp = fopen(log_path, "r");
+    if (fp) {
+        char line[256];
+        while (fgets(line, sizeof(line), fp)) {
+            line[strcspn(line, "\r\n")] = '\0';
+            if (line[0] != '\0') {
+                processed_set_add(set, line);
+            }
         }
+        fclose(fp);
     }
-    return 0;
+
+    set->log = fopen(log_path, "a");
+    if (!set->log) {
+        fprintf(stderr, "[MONITOR] 警告: 无法打开审计日志 %s，重启后会重新审计\n", log_path);
+    }
+    printf("[MONITOR] 已加载 %zu 个已审计交易\n", set->count);
 }
 
-// 添加到已处理列表
-static void add_to_processed(processed_txhash_list_t *list, const char *txhash) {
-    if (list->count >= list->capacity) {
-        // 扩容
-        list->capacity *= 2;
-        list->hashes = (char**)realloc(list->hashes, list->capacity * sizeof(char*));
+// 审计完成后持久化
+static void mark_audited(processed_txhash_set_t *set, const char *txhash) {
+    if (set->log) {
+        fprintf(set->log, "%s\n", txhash);
+        fflush(set->log);
+    }
+}
+
+static void free_processed_set(processed_txhash_set_t *set) {
+    for (size_t i = 0; i < set->capacity; i++) {
+        free(set->slots[i]);
+    }
+    free(set->slots);
+    if (set->log) {
+        fclose(set->log);
     }
-    list->hashes[list->count] = (char*)malloc(strlen(txhash) + 1);
-    strcpy(list->hashes[list->count], txhash);
-    list->count++;
+    memset(set, 0, sizeof(*set));
 }
 
-// 读取CSV文件中的新交易
-static int read_new_transactions(const char *csv_file, processed_txhash_list_t *processed, 
+static void follower_watch(csv_follower_t *follower) {
+    if (follower->inotify_fd < 0) {
+        follower->inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (follower->inotify_fd < 0) {
+            return;
+        }
+    }
+    if (follower->watch_fd < 0) {
+        // 监听目录而不是文件本身：文件可能尚未创建或被替换
+        follower->watch_fd = inotify_add_watch(follower->inotify_fd, follower->dir,
+                                               IN_MODIFY | IN_CLOSE_WRITE | IN_CREATE | IN_MOVED_TO |
+                                               IN_DELETE | IN_MOVED_FROM);
+    }
+}
+
+static void init_follower(csv_follower_t *follower, const char *csv_file) {
+    memset(follower, 0, sizeof(*follower));
+    follower->path = csv_file;
+    follower->inotify_fd = -1;
+    follower->watch_fd = -1;
+
+    const char *slash = strrchr(csv_file, '/');
+    if (slash) {
+        snprintf(follower->dir, sizeof(follower->dir), "%.*s", (int)(slash - csv_file), csv_file);
+        snprintf(follower->name, sizeof(follower->name), "%s", slash + 1);
+    } else {
+        snprintf(follower->dir, sizeof(follower->dir), ".");
+        snprintf(follower->name, sizeof(follower->name), "%s", csv_file);
+    }
+    follower_watch(follower);
+    if (follower->watch_fd < 0) {
+        printf("[MONITOR] inotify 不可用，退化为每 %d ms 轮询\n", MONITOR_FALLBACK_INTERVAL_MS);
+    }
+}
+
+static void free_follower(csv_follower_t *follower) {
+    if (follower->inotify_fd >= 0) {
+        close(follower->inotify_fd);
+    }
+    follower->inotify_fd = -1;
+    follower->watch_fd = -1;
+}
+
+// 等待 CSV 变化；超时（兜底轮询）也返回
+static void follower_wait(csv_follower_t *follower) {
+    follower_watch(follower);
+    if (follower->watch_fd < 0) {
+        usleep(MONITOR_FALLBACK_INTERVAL_MS * 1000);
+        return;
+    }
+
+    struct pollfd pfd = { .fd = follower->inotify_fd, .events = POLLIN };
+    while (1) {
+        int ready = poll(&pfd, 1, MONITOR_FALLBACK_INTERVAL_MS);
+        if (ready <= 0) {
+            return;  // 超时或被信号打断，照常检查一次
+        }
+
+        char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+        int relevant = 0;
+        ssize_t len;
+        while ((len = read(follower->inotify_fd, buf, sizeof(buf))) > 0) {
+            for (char *p = buf; p < buf + len; ) {
+                const struct inotify_event *ev = (const struct inotify_event *)p;
+                if (ev->mask & IN_IGNORED) {
+                    follower->watch_fd = -1;  // 目录被删除，之后重新添加监听
+                    relevant = 1;
+                } else if (ev->len > 0 && strcmp(ev->name, follower->name) == 0) {
+                    relevant = 1;
+                }
+                p += sizeof(struct inotify_event) + ev->len;
+            }
+        }
+        if (relevant || follower->watch_fd < 0) {
+            return;
+        }
+    }
+}
+
+// 检查上次的偏移是否仍然有效；无效时从头扫描
+static void follower_check_offset(csv_follower_t *follower, int fd, const struct stat *st) {
+    int reset = 0;
+    if (!follower->has_file || st->st_dev != follower->dev || st->st_ino != follower->inode) {
+        reset = 1;  // 新文件或被替换
+    } else if (st->st_size < follower->offset) {
+        reset = 1;  // 被截断
+    } else if (follower->last_line_len > 0) {
+        char check[MONITOR_LAST_LINE_MAX];
+        ssize_t n = pread(fd, check, follower->last_line_len,
+                          follower->offset - (off_t)follower->last_line_len);
+        if (n != (ssize_t)follower->last_line_len ||
+            memcmp(check, follower->last_line, follower->last_line_len) != 0) {
+            reset = 1;  // 被原地重写（状态更新）
+        }
+    }
+
+    if (reset) {
+        follower->has_file = 1;
+        follower->dev = st->st_dev;
+        follower->inode = st->st_ino;
+        follower->offset = 0;
+        follower->last_line_len = 0;
+    }
+}
+
+// 读取CSV文件中的新交易（从上次的偏移开始，只处理完整行）
+static int read_new_transactions(csv_follower_t *follower, processed_txhash_set_t *processed,
                                  char ***new_txhashes, int *new_count) {
-    FILE *file = fopen(csv_file, "r");
-    if (!file) {
+    *new_count = 0;
+    *new_txhashes = NULL;
+
+    int fd = open(follower->path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        follower->has_file = 0;
         return 0;  // 文件不存在或无法打开
     }
-    
-    char line[512];
-    int capacity = 10;
-    *new_count = 0;
-    *new_txhashes = (char**)malloc(capacity * sizeof(char*));
-    
-    while (fgets(line, sizeof(line), file) != NULL) {
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return 0;
+    }
+    follower_check_offset(follower, fd, &st);
+    if (st.st_size == follower->offset) {
+        close(fd);
+        return 0;
+    }
+
+    FILE *file = fdopen(fd, "r");
+    if (!file) {
+        close(fd);
+        return 0;
+    }
+    if (fseeko(file, follower->offset, SEEK_SET) != 0) {
+        fclose(file);
+        return 0;
+    }
+
+    char *line = NULL;
+    size_t line_cap = 0;
+    ssize_t line_len;
+    int capacity = 0;
+
+    while ((line_len = getline(&line, &line_cap, file)) > 0) {
+        if (line[line_len - 1] != '\n') {
+            break;  // 写了一半的行，下次再读
+        }
+        follower->offset += line_len;
+        size_t keep = (size_t)line_len < sizeof(follower->last_line) ? (size_t)line_len : sizeof(follower->last_line);
+        memcpy(follower->last_line, line + line_len - keep, keep);
+        follower->last_line_len = keep;
+
         // 跳过表头
         if (strncmp(line, "txhash", 6) == 0) {
             continue;
         }
-        
+
         // 解析CSV行：txhash,address,time
         char txhash[128] = {0};
         char *p = line;
-        
+
         // 跳过开始的引号
         if (*p == '"') p++;
-        
+
         // 读取txhash（到第一个引号或逗号）
         int i = 0;
         while (*p && *p != '"' && *p != ',' && i < 127) {
             txhash[i++] = *p++;
         }
         txhash[i] = '\0';
-        
+
         // 检查是否有效且未处理
-        if (strlen(txhash) > 10 && !is_processed(processed, txhash)) {
+        if (strlen(txhash) > 10 && processed_set_add(processed, txhash) == 1) {
             // 扩容
             if (*new_count >= capacity) {
-                capacity *= 2;
+                capacity = capacity ? capacity * 2 : 10;
                 *new_txhashes = (char**)realloc(*new_txhashes, capacity * sizeof(char*));
             }
-            
+
             // 添加新交易
-            (*new_txhashes)[*new_count] = (char*)malloc(strlen(txhash) + 1);
-            strcpy((*new_txhashes)[*new_count], txhash);
+            (*new_txhashes)[*new_count] = strdup(txhash);
             (*new_count)++;
-            
-            // 添加到已处理列表
-            add_to_processed(processed, txhash);
         }
     }
-    
+
+    free(line);
     fclose(file);
     return *new_count;
 }
 
+// ========== 并行审计调度 ==========
+
+// 监控模式下多个审计线程并行处理可疑交易：
+//   - 监控线程把新交易放入先进先出队列，审计线程各自取出审计，不同交易的取分片、重构与验证互不等待；
+//   - 每个审计线程持有独立的审计状态（长期密钥从模板复制，GEN 只读共享）与 PARI 栈，
+//     每笔审计前清除上一笔的解析缓存，审计后回收 PARI 栈；
+//   - 审计完成后才追加到 <csv>.audited，进程退出时仍在队列中的交易重启后会重新审计。
+// 未启用多线程（TIGER_MT_ENABLED，见 util.h）时在监控线程上逐个审计。
+
+typedef struct audit_job_st {
+    char *txhash;
+    struct audit_job_st *next;
+} audit_job_t;
+
+struct audit_scheduler_st;
+
+typedef struct {
+    int index;
+    pthread_t thread;
+    struct audit_scheduler_st *scheduler;
+#if TIGER_MT_ENABLED
+    struct pari_thread pari_thread;
+#endif
+} audit_worker_t;
+
+typedef struct audit_scheduler_st {
+    pthread_mutex_t mutex;
+    pthread_cond_t work;                // 有新交易或需要退出
+    int stop;
+    audit_job_t *head;
+    audit_job_t *tail;
+    size_t queued;                      // 等待审计的交易数
+    size_t active;                      // 正在审计的交易数
+    auditor_state_t tmpl;               // 只读模板：长期密钥与 CL 参数
+    processed_txhash_set_t *processed;  // 审计日志，持锁写入
+    size_t n_workers;
+    audit_worker_t workers[AUDITOR_MAX_WORKERS];
+} audit_scheduler_t;
+
+// 清除上一笔审计解析出的缓存，避免下一笔交易沿用旧数据
+static void auditor_state_reset(auditor_state_t state) {
+    free(state->second_msgid);
+    state->second_msgid = NULL;
+    state->has_alice_g_abt = 0;
+    state->has_alice_presig = 0;
+    state->has_alice_final = 0;
+    state->has_bob_g_alpha = 0;
+    state->has_bob_presig = 0;
+    state->has_bob_final = 0;
+    state->has_tumbler_presig = 0;
+    state->has_tumbler_final = 0;
+    state->has_alice_escrow_info = 0;
+    state->has_tumbler_escrow_info = 0;
+    memset(state->alice_escrow_id, 0, sizeof(state->alice_escrow_id));
+    memset(state->alice_escrow_tx_hash, 0, sizeof(state->alice_escrow_tx_hash));
+    memset(state->tumbler_escrow_id, 0, sizeof(state->tumbler_escrow_id));
+    memset(state->tumbler_escrow_tx_hash, 0, sizeof(state->tumbler_escrow_tx_hash));
+}
+
+#if TIGER_MT_ENABLED
+// 为审计线程创建状态：长期密钥从模板复制（GEN 只读共享），解析缓存由每笔审计填充
+static auditor_state_t auditor_worker_state_new(const auditor_state_t tmpl) {
+    auditor_state_t state;
+    auditor_state_null(state);
+
+    RLC_TRY {
+        auditor_state_new(state);
+
+        ec_copy(state->alice_ec_pk->pk, tmpl->alice_ec_pk->pk);
+        ec_copy(state->bob_ec_pk->pk, tmpl->bob_ec_pk->pk);
+        ec_copy(state->tumbler_ec_pk->pk, tmpl->tumbler_ec_pk->pk);
+        state->tumbler_cl_pk->pk = tmpl->tumbler_cl_pk->pk;
+        state->auditor_cl_sk->sk = tmpl->auditor_cl_sk->sk;
+        state->auditor_cl_pk->pk = tmpl->auditor_cl_pk->pk;
+        state->auditor2_cl_pk->pk = tmpl->auditor2_cl_pk->pk;
+        state->auditor2_cl_sk->sk = tmpl->auditor2_cl_sk->sk;
+        *state->cl_params = *tmpl->cl_params;  // g_q_table 为只读共享
+    } RLC_CATCH_ANY {
+        if (state != NULL) auditor_state_free(state);
+    }
+
+    return state;
+}
+
+static void auditor_worker_state_free(auditor_state_t state) {
+    // 固定基表借用自模板状态，不随审计线程释放
+    state->cl_params->g_q_table = NULL;
+    auditor_state_free(state);
+}
+
+static void *audit_worker_main(void *arg) {
+    audit_worker_t *worker = (audit_worker_t *) arg;
+    audit_scheduler_t *scheduler = worker->scheduler;
+
+    // 每个线程独立的 PARI 栈与 RELIC 上下文
+    pari_thread_start(&worker->pari_thread);
+    core_init();
+    pc_param_set_any();
+    ec_param_set_any();
+    ep_param_set(SECG_K256);
+    {
+        uint8_t seed[sizeof(ulong)];
+        ulong s;
+        rand_bytes(seed, sizeof(seed));
+        memcpy(&s, seed, sizeof(s));
+        setrand(utoi(s));
+    }
+
+    auditor_state_t state = auditor_worker_state_new(scheduler->tmpl);
+    if (state == NULL) {
+        fprintf(stderr, "[MONITOR][A%d] 无法分配审计状态，线程退出\n", worker->index);
+    }
+
+    pthread_mutex_lock(&scheduler->mutex);
+    while (state != NULL) {
+        while (!scheduler->stop && scheduler->head == NULL) {
+            pthread_cond_wait(&scheduler->work, &scheduler->mutex);
+        }
+        if (scheduler->stop) {
+            break;
+        }
+        audit_job_t *job = scheduler->head;
+        scheduler->head = job->next;
+        if (scheduler->head == NULL) {
+            scheduler->tail = NULL;
+        }
+        scheduler->queued--;
+        scheduler->active++;
+        pthread_mutex_unlock(&scheduler->mutex);
+
+        printf("[MONITOR][A%d] 开始审计交易: %s\n", worker->index, job->txhash);
+        auditor_state_reset(state);
+        pari_sp av = avma;
+        audit_message(job->txhash, state);
+        set_avma(av);
+
+        pthread_mutex_lock(&scheduler->mutex);
+        mark_audited(scheduler->processed, job->txhash);
+        scheduler->active--;
+        printf("[MONITOR][A%d] 交易 %s 审计完成（排队 %zu，进行中 %zu）\n",
+               worker->index, job->txhash, scheduler->queued, scheduler->active);
+        free(job->txhash);
+        free(job);
+    }
+    pthread_mutex_unlock(&scheduler->mutex);
+
+    if (state != NULL) {
+        auditor_worker_state_free(state);
+    }
+    core_clean();
+    pari_thread_close();
+    return NULL;
+}
+#endif
+
+// 启动 n_workers 个审计线程；当前构建不支持多线程 PARI/RELIC 时返回 RLC_ERR
+static int audit_scheduler_start(audit_scheduler_t *scheduler, auditor_state_t tmpl,
+                                 processed_txhash_set_t *processed, size_t n_workers) {
+    memset(scheduler, 0, sizeof(*scheduler));
+#if TIGER_MT_ENABLED
+    if (n_workers == 0 || n_workers > AUDITOR_MAX_WORKERS) {
+        return RLC_ERR;
+    }
+    pthread_mutex_init(&scheduler->mutex, NULL);
+    pthread_cond_init(&scheduler->work, NULL);
+    scheduler->tmpl = tmpl;
+    scheduler->processed = processed;
+
+    for (size_t i = 0; i < n_workers; i++) {
+        audit_worker_t *worker = &scheduler->workers[i];
+        worker->index = (int) i;
+        worker->scheduler = scheduler;
+        pari_thread_alloc(&worker->pari_thread, AUDITOR_WORKER_PARI_STACK, NULL);
+        if (pthread_create(&worker->thread, NULL, audit_worker_main, worker) != 0) {
+            fprintf(stderr, "[MONITOR] 无法启动审计线程 %zu\n", i);
+            pari_thread_free(&worker->pari_thread);
+            break;
+        }
+        scheduler->n_workers++;
+    }
+    if (scheduler->n_workers == 0) {
+        pthread_cond_destroy(&scheduler->work);
+        pthread_mutex_destroy(&scheduler->mutex);
+        return RLC_ERR;
+    }
+    return RLC_OK;
+#else
+    (void) tmpl;
+    (void) processed;
+    (void) n_workers;
+    tiger_mt_warn("审计在监控线程上串行执行");
+    return RLC_ERR;
+#endif
+}
+
+// 交易放入队列，txhash 的所有权转交给调度器
+static int audit_scheduler_submit(audit_scheduler_t *scheduler, char *txhash) {
+    audit_job_t *job = (audit_job_t *) malloc(sizeof(audit_job_t));
+    if (job == NULL) {
+        return RLC_ERR;
+    }
+    job->txhash = txhash;
+    job->next = NULL;
+
+    pthread_mutex_lock(&scheduler->mutex);
+    if (scheduler->tail != NULL) {
+        scheduler->tail->next = job;
+    } else {
+        scheduler->head = job;
+    }
+    scheduler->tail = job;
+    scheduler->queued++;
+    pthread_cond_signal(&scheduler->work);
+    pthread_mutex_unlock(&scheduler->mutex);
+    return RLC_OK;
+}
+
+// 等正在进行的审计结束后停止所有审计线程；队列中未开始的交易丢弃（未写入审计日志）
+static void audit_scheduler_stop(audit_scheduler_t *scheduler) {
+    if (scheduler->n_workers == 0) {
+        return;
+    }
+    pthread_mutex_lock(&scheduler->mutex);
+    scheduler->stop = 1;
+    pthread_cond_broadcast(&scheduler->work);
+    pthread_mutex_unlock(&scheduler->mutex);
+
+    for (size_t i = 0; i < scheduler->n_workers; i++) {
+        pthread_join(scheduler->workers[i].thread, NULL);
+#if TIGER_MT_ENABLED
+        pari_thread_free(&scheduler->workers[i].pari_thread);
+#endif
+    }
+    while (scheduler->head != NULL) {
+        audit_job_t *job = scheduler->head;
+        scheduler->head = job->next;
+        free(job->txhash);
+        free(job);
+    }
+    scheduler->tail = NULL;
+    scheduler->queued = 0;
+    scheduler->n_workers = 0;
+    pthread_cond_destroy(&scheduler->work);
+    pthread_mutex_destroy(&scheduler->mutex);
+}
+
 // 监控模式主循环
-static void monitor_mode(auditor_state_t state) {
+static void monitor_mode(auditor_state_t state, int workers) {
     const char *csv_file = "/home/zxx/A2L/A2L-master/ecdsa/bin/detect_transaction/suspicious_transactions.csv";
-    processed_txhash_list_t processed;
-    init_processed_list(&processed);
+    processed_txhash_set_t processed;
+    csv_follower_t follower;
+    audit_scheduler_t scheduler;
+    init_processed_set(&processed, csv_file);
+    init_follower(&follower, csv_file);
+    int parallel = (audit_scheduler_start(&scheduler, state, &processed, (size_t) workers) == RLC_OK);
     
     printf("========================================\n");
     printf("审计员监控模式启动\n");
     printf("========================================\n");
     printf("[MONITOR] 监控文件: %s\n", csv_file);
+    if (parallel) {
+        printf("[MONITOR] 审计线程: %zu\n", scheduler.n_workers);
+    }
     printf("[MONITOR] 等待可疑交易...\n\n");
     
     while (1) {
@@ -2655,32 +3225,47 @@ static void monitor_mode(auditor_state_t state) {
         int new_count = 0;
         
         // 读取新交易
-        if (read_new_transactions(csv_file, &processed, &new_txhashes, &new_count) > 0) {
+        if (read_new_transactions(&follower, &processed, &new_txhashes, &new_count) > 0) {
             printf("\n========================================\n");
             printf("⚠️  检测到 %d 个新的可疑交易\n", new_count);
             printf("========================================\n\n");
             
-            // 逐个审计
             for (int i = 0; i < new_count; i++) {
+                // 并行：交给审计线程，哈希的所有权随之转交
+                if (parallel) {
+                    if (audit_scheduler_submit(&scheduler, new_txhashes[i]) != RLC_OK) {
+                        fprintf(stderr, "[MONITOR] 无法加入审计队列: %s（重启后重新审计）\n", new_txhashes[i]);
+                        free(new_txhashes[i]);
+                    }
+                    continue;
+                }
+
+                // 串行：逐个审计
                 printf("[MONITOR] 开始审计交易: %s\n", new_txhashes[i]);
                 printf("========================================\n");
                 
+                // 每笔审计结束后回收其 PARI 栈，监控进程的栈占用不随审计次数增长
+                auditor_state_reset(state);
+                pari_sp av = avma;
                 audit_message(new_txhashes[i], state);
+                set_avma(av);
+                mark_audited(&processed, new_txhashes[i]);
                 
                 printf("\n[MONITOR] 交易 %s 审计完成\n", new_txhashes[i]);
                 printf("========================================\n\n");
                 
                 free(new_txhashes[i]);
             }
-            
-            free(new_txhashes);
         }
+        free(new_txhashes);
         
-        // 等待5秒后继续检查
-        sleep(5);
+        // 等待文件变化（兜底每 5 秒检查一次）
+        follower_wait(&follower);
     }
     
-    free_processed_list(&processed);
+    audit_scheduler_stop(&scheduler);
+    free_follower(&follower);
+    free_processed_set(&processed);
 }
 
 int main(int argc, char* argv[]) {
@@ -2689,6 +3274,7 @@ int main(int argc, char* argv[]) {
     
     // 判断运行模式
     int is_monitor_mode = 0;
+    int audit_workers = AUDITOR_DEFAULT_WORKERS;
     char *message_id = NULL;
     char *sender_address = NULL;
     char *pairs_summary_line = NULL;
@@ -2699,6 +3285,14 @@ int main(int argc, char* argv[]) {
         } else {
             message_id = argv[1];
         }
+    } else if (argc == 3 && (strcmp(argv[1], "--monitor") == 0 || strcmp(argv[1], "-m") == 0)) {
+        // 监控模式：auditor --monitor <workers>
+        is_monitor_mode = 1;
+        audit_workers = atoi(argv[2]);
+        if (audit_workers <= 0 || audit_workers > AUDITOR_MAX_WORKERS) {
+            fprintf(stderr, "Error: Invalid worker count. Must be between 1 and %d.\n", AUDITOR_MAX_WORKERS);
+            return 1;
+        }
     } else if (argc == 3) {
         // 新格式：auditor <tx_hash> <sender_address>
         message_id = argv[1];
@@ -2712,13 +3306,13 @@ int main(int argc, char* argv[]) {
         fprintf(stderr, "Usage: \n");
         fprintf(stderr, "  手动模式（旧格式）: %s <message_id>\n", argv[0]);
         fprintf(stderr, "  手动模式（新格式）: %s <tx_hash> <sender_address> [pairs_summary_line]\n", argv[0]);
-        fprintf(stderr, "  监控模式: %s --monitor 或 %s -m\n", argv[0], argv[0]);
+        fprintf(stderr, "  监控模式: %s --monitor [workers] 或 %s -m [workers]（默认 %d 个审计线程）\n", argv[0], argv[0], AUDITOR_DEFAULT_WORKERS);
         return 1;
     } else {
         fprintf(stderr, "Usage: \n");
         fprintf(stderr, "  手动模式（旧格式）: %s <message_id>\n", argv[0]);
         fprintf(stderr, "  手动模式（新格式）: %s <tx_hash> <sender_address> [pairs_summary_line]\n", argv[0]);
-        fprintf(stderr, "  监控模式: %s --monitor 或 %s -m\n", argv[0], argv[0]);
+        fprintf(stderr, "  监控模式: %s --monitor [workers] 或 %s -m [workers]（默认 %d 个审计线程）\n", argv[0], argv[0], AUDITOR_DEFAULT_WORKERS);
         return 1;
     }
     
@@ -2789,7 +3383,7 @@ int main(int argc, char* argv[]) {
         // 根据模式执行不同的操作
         if (is_monitor_mode) {
             // 监控模式：持续监控CSV文件
-            monitor_mode(state);
+            monitor_mode(state, audit_workers);
         } else {
             // 手动模式：执行单次审计
             if (sender_address != NULL || pairs_summary_line != NULL) {
@@ -2811,6 +3405,9 @@ int main(int argc, char* argv[]) {
     }
     
     // 清理库
+    if (auditor_zmq_ctx != NULL) {
+        zmq_ctx_destroy(auditor_zmq_ctx);
+    }
     clean();
     return 0;
 }
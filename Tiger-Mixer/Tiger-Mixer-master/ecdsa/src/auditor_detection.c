@@ -6,9 +6,9 @@
 #include <signal.h>
 #include <sys/wait.h>
 #include <math.h>
-
-// Python脚本路径
-#define PYTHON_DBSCAN_SCRIPT "/home/zxx/A2L/A2L-master/ecdsa/bin/dbscan_clustering.py"
+#include <stdint.h>
+#include <sys/stat.h>
+#include "dbscan.h"
 
 // ========== 可疑地址信息结构 ==========
 typedef struct {
@@ -29,18 +29,51 @@ typedef struct {
     time_t parsed_time;
 } transaction_record_t;
 
-// ========== 地址统计结构 ==========
+// ========== 地址统计结构（随交易流增量维护） ==========
+#define TX_WINDOW_COUNT 3
+static const int TX_WINDOW_SECONDS[TX_WINDOW_COUNT] = {60, 300, 3600};  // 1分钟 / 5分钟 / 1小时
+
 typedef struct {
     char address[43];
     int tx_count;
     double total_value;
-    time_t *tx_times;
-    int tx_times_size;
-    int tx_times_capacity;
     time_t first_tx_time;
     time_t last_tx_time;
+    char latest_tx_hash[67];  // 最新一笔交易的哈希
+    time_t prev_tx_time;      // 文件顺序上的上一笔交易时间
+    double interval_mean;     // 相邻交易间隔的均值
+    double interval_m2;       // 相邻交易间隔与均值之差的平方和
+    int window_counts[TX_WINDOW_COUNT];  // 各时间窗口内的交易数
 } address_stat_t;
 
+// ========== 交易流状态 ==========
+typedef struct {
+    time_t time;
+    int address;
+} window_event_t;
+
+typedef struct {
+    window_event_t *items;  // 按交易时间的最小堆
+    size_t size;
+    size_t capacity;
+} window_heap_t;
+
+typedef struct {
+    int has_file;
+    dev_t dev;
+    ino_t inode;
+    off_t offset;             // 已消费的字节数（只包含完整行）
+    long long record_count;
+    address_stat_t *stats;
+    int count;
+    int capacity;
+    int *slots;               // 地址 -> 统计下标 + 1 的开放寻址哈希表
+    size_t slot_capacity;
+    window_heap_t windows[TX_WINDOW_COUNT];  // 每个窗口内的交易，用于过期
+} tx_stream_t;
+
+static tx_stream_t g_tx_stream;
+
 // ========== 地址特征结构 ==========
 typedef struct {
     char address[43];
@@ -51,251 +84,255 @@ typedef struct {
 } address_feature_t;
 
 // ========== 延迟队列项结构 ==========
-typedef struct delay_queue_item {
+typedef struct {
     char tx_hash[67];
     char address[43];
     time_t detection_time;
     time_t ready_time;  // 可以发送给auditor的时间
-    int status;         // 0=等待中, 1=已发送, 2=已过期
-    struct delay_queue_item *next;
+    unsigned long seq;  // 加入顺序，ready_time 相同时先进先出
 } delay_queue_item_t;
 
 // ========== 延迟队列管理 ==========
+// 按 ready_time 的最小堆：每秒只查看堆顶，取出已到期的项；队列项出堆即完成，不再需要清理遍历
 typedef struct {
-    delay_queue_item_t *head;
-    delay_queue_item_t *tail;
+    delay_queue_item_t *items;
     int count;
+    int capacity;
+    unsigned long next_seq;
 } delay_queue_t;
 
+// 一个处理周期内到期项的审计结果，周期结束时一次性写回 CSV
+typedef struct {
+    const char *tx_hash;
+    const char *status;
+} status_update_t;
+
 // 全局延迟队列
-static delay_queue_t g_delay_queue = {NULL, NULL, 0};
+static delay_queue_t g_delay_queue = {NULL, 0, 0, 0};
 static const int DELAY_SECONDS = 30;  // 延迟30秒
 
 // 函数声明
-static int update_transaction_status(const char *tx_hash, const char *status);
-static int get_pairs_summary_line(const char *address, char *line_buffer, size_t buffer_size);
+static int update_transaction_statuses(const status_update_t *updates, int count);
+static int get_pairs_summary_lines(const delay_queue_item_t *items, int count, char (*lines)[2048]);
 
 // ========== 延迟队列管理函数 ==========
-static delay_queue_item_t* create_delay_item(const char *tx_hash, const char *address) {
-    delay_queue_item_t *item = (delay_queue_item_t*)malloc(sizeof(delay_queue_item_t));
-    if (!item) return NULL;
-    
-    strncpy(item->tx_hash, tx_hash, sizeof(item->tx_hash) - 1);
-    item->tx_hash[sizeof(item->tx_hash) - 1] = '\0';
-    
-    strncpy(item->address, address, sizeof(item->address) - 1);
-    item->address[sizeof(item->address) - 1] = '\0';
-    
-    item->detection_time = time(NULL);
-    item->ready_time = item->detection_time + DELAY_SECONDS;
-    item->status = 0;  // 等待中
-    item->next = NULL;
+static int delay_item_before(const delay_queue_item_t *a, const delay_queue_item_t *b) {
+    return a->ready_time < b->ready_time || (a->ready_time == b->ready_time && a->seq < b->seq);
+}
+
+static delay_queue_item_t* delay_queue_push(const delay_queue_item_t *item) {
+    if (g_delay_queue.count >= g_delay_queue.capacity) {
+        int capacity = g_delay_queue.capacity ? g_delay_queue.capacity * 2 : 64;
+        delay_queue_item_t *grown = (delay_queue_item_t*)realloc(g_delay_queue.items, capacity * sizeof(delay_queue_item_t));
+        if (!grown) return NULL;
+        g_delay_queue.items = grown;
+        g_delay_queue.capacity = capacity;
+    }
     
-    return item;
+    delay_queue_item_t *heap = g_delay_queue.items;
+    int i = g_delay_queue.count++;
+    while (i > 0 && delay_item_before(item, &heap[(i - 1) / 2])) {
+        heap[i] = heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    heap[i] = *item;
+    return &heap[i];
+}
+
+static void delay_queue_pop(delay_queue_item_t *out) {
+    delay_queue_item_t *heap = g_delay_queue.items;
+    *out = heap[0];
+    delay_queue_item_t last = heap[--g_delay_queue.count];
+    int i = 0;
+    while (1) {
+        int child = 2 * i + 1;
+        if (child >= g_delay_queue.count) break;
+        if (child + 1 < g_delay_queue.count && delay_item_before(&heap[child + 1], &heap[child])) child++;
+        if (!delay_item_before(&heap[child], &last)) break;
+        heap[i] = heap[child];
+        i = child;
+    }
+    if (g_delay_queue.count > 0) {
+        heap[i] = last;
+    }
 }
 
 static void add_to_delay_queue(const char *tx_hash, const char *address) {
-    delay_queue_item_t *item = create_delay_item(tx_hash, address);
-    if (!item) {
+    delay_queue_item_t item;
+    memset(&item, 0, sizeof(item));
+    strncpy(item.tx_hash, tx_hash, sizeof(item.tx_hash) - 1);
+    strncpy(item.address, address, sizeof(item.address) - 1);
+    item.detection_time = time(NULL);
+    item.ready_time = item.detection_time + DELAY_SECONDS;
+    item.seq = g_delay_queue.next_seq++;
+    
+    if (!delay_queue_push(&item)) {
         printf("[DETECTION ERROR] 无法创建延迟队列项\n");
         return;
     }
     
-    if (g_delay_queue.tail) {
-        g_delay_queue.tail->next = item;
-        g_delay_queue.tail = item;
-    } else {
-        g_delay_queue.head = g_delay_queue.tail = item;
-    }
-    g_delay_queue.count++;
-    
     printf("[DETECTION] 📝 可疑交易已加入延迟队列\n");
     printf("[DETECTION]    交易哈希: %s\n", tx_hash);
     printf("[DETECTION]    地址: %s\n", address);
-    printf("[DETECTION]    检测时间: %s", ctime(&item->detection_time));
-    printf("[DETECTION]    预计发送时间: %s", ctime(&item->ready_time));
+    printf("[DETECTION]    检测时间: %s", ctime(&item.detection_time));
+    printf("[DETECTION]    预计发送时间: %s", ctime(&item.ready_time));
     printf("[DETECTION]    队列长度: %d\n", g_delay_queue.count);
 }
 
-static void process_ready_items() {
-    time_t current_time = time(NULL);
-    delay_queue_item_t *current = g_delay_queue.head;
-    int processed_count = 0;
-    
-    printf("[DETECTION] 🔍 检查延迟队列中的项目...\n");
-    
-    while (current) {
-        printf("[DETECTION]   检查项目: %s\n", current->tx_hash);
-        printf("[DETECTION]     状态: %d (0=等待中, 1=已发送, 2=已过期)\n", current->status);
-        printf("[DETECTION]     检测时间: %s", ctime(&current->detection_time));
-        printf("[DETECTION]     预计发送时间: %s", ctime(&current->ready_time));
-        printf("[DETECTION]     当前时间: %s", ctime(&current_time));
-        printf("[DETECTION]     时间差: %ld 秒 (需要 >= 0)\n", current_time - current->ready_time);
+// 调用auditor审计一个到期项，返回写回文件的状态
+static const char* dispatch_to_auditor(const delay_queue_item_t *current, char *pairs_summary_line, time_t current_time) {
+    printf("\n[DETECTION] ========== 发送给审计员 ==========\n");
+    printf("[DETECTION] 交易哈希: %s\n", current->tx_hash);
+    printf("[DETECTION] 地址: %s\n", current->address);
+    printf("[DETECTION] 延迟时间: %ld 秒\n", current_time - current->detection_time);
+    
+    if (pairs_summary_line[0] != '\0') {
+        printf("[DETECTION] pairs_summary行: %s\n", pairs_summary_line);
+    } else {
+        printf("[DETECTION] ⚠️  无法获取pairs_summary行，使用空字符串\n");
+    }
+    
+    // 调用auditor进行审计（传入三个参数：交易哈希、地址、pairs_summary行）
+    // 使用单引号包裹参数，更安全地处理特殊字符
+    char auditor_cmd[4096];
+    
+    // 转义pairs_summary_line中的单引号（在单引号字符串中，单引号需要特殊处理）
+    // 方法：将单引号替换为 '\''（结束当前单引号字符串，插入转义的单引号，开始新的单引号字符串）
+    char escaped_pairs[4096];
+    size_t escaped_idx = 0;
+    for (size_t i = 0; i < strlen(pairs_summary_line) && escaped_idx < sizeof(escaped_pairs) - 4; i++) {
+        if (pairs_summary_line[i] == '\'') {
+            // 单引号在单引号字符串中需要特殊处理：结束当前字符串，插入转义单引号，开始新字符串
+            escaped_pairs[escaped_idx++] = '\'';
+            escaped_pairs[escaped_idx++] = '\\';
+            escaped_pairs[escaped_idx++] = '\'';
+            escaped_pairs[escaped_idx++] = '\'';
+        } else {
+            escaped_pairs[escaped_idx++] = pairs_summary_line[i];
+        }
+    }
+    escaped_pairs[escaped_idx] = '\0';
+    
+    // 使用单引号包裹所有参数，更安全
+    snprintf(auditor_cmd, sizeof(auditor_cmd), 
+            "/home/zxx/A2L/A2L-master/ecdsa/bin/auditor '%s' '%s' '%s' 2>&1", 
+            current->tx_hash, current->address, escaped_pairs);
+    
+    printf("[DETECTION] 执行审计命令: %s\n", auditor_cmd);
+    
+    const char *status;
+    
+    // 使用popen来捕获auditor的输出
+    FILE *auditor_pipe = popen(auditor_cmd, "r");
+    if (!auditor_pipe) {
+        printf("[DETECTION] ❌ 无法启动审计员进程\n");
+        status = "FAILED";
+    } else {
+        char output_line[1024];
+        int found_result = 0;
+        char all_output[8192] = {0};  // 保存所有输出用于错误诊断
+        size_t output_len = 0;
         
-        if (current->status == 0 && current->ready_time <= current_time) {
-            // 时间到了，发送给auditor
-            printf("\n[DETECTION] ========== 发送给审计员 ==========\n");
-            printf("[DETECTION] 交易哈希: %s\n", current->tx_hash);
-            printf("[DETECTION] 地址: %s\n", current->address);
-            printf("[DETECTION] 延迟时间: %ld 秒\n", current_time - current->detection_time);
-            
-            // 从pairs_summary.csv获取对应地址的行
-            char pairs_summary_line[2048];
-            int pairs_result = get_pairs_summary_line(current->address, pairs_summary_line, sizeof(pairs_summary_line));
-            if (pairs_result == 0) {
-                printf("[DETECTION] pairs_summary行: %s\n", pairs_summary_line);
-            } else {
-                printf("[DETECTION] ⚠️  无法获取pairs_summary行，使用空字符串\n");
-                pairs_summary_line[0] = '\0';
+        // 读取auditor的所有输出
+        while (fgets(output_line, sizeof(output_line), auditor_pipe) != NULL) {
+            // 保存所有输出
+            size_t line_len = strlen(output_line);
+            if (output_len + line_len < sizeof(all_output) - 1) {
+                strcat(all_output, output_line);
+                output_len += line_len;
             }
             
-            // 调用auditor进行审计（传入三个参数：交易哈希、地址、pairs_summary行）
-            // 使用单引号包裹参数，更安全地处理特殊字符
-            char auditor_cmd[4096];
-            
-            // 转义pairs_summary_line中的单引号（在单引号字符串中，单引号需要特殊处理）
-            // 方法：将单引号替换为 '\''（结束当前单引号字符串，插入转义的单引号，开始新的单引号字符串）
-            char escaped_pairs[4096];
-            size_t escaped_idx = 0;
-            for (size_t i = 0; i < strlen(pairs_summary_line) && escaped_idx < sizeof(escaped_pairs) - 4; i++) {
-                if (pairs_summary_line[i] == '\'') {
-                    // 单引号在单引号字符串中需要特殊处理：结束当前字符串，插入转义单引号，开始新字符串
-                    escaped_pairs[escaped_idx++] = '\'';
-                    escaped_pairs[escaped_idx++] = '\\';
-                    escaped_pairs[escaped_idx++] = '\'';
-                    escaped_pairs[escaped_idx++] = '\'';
-                } else {
-                    escaped_pairs[escaped_idx++] = pairs_summary_line[i];
-                }
+            // 显示包含确认信息的行，并保持原始格式
+            if (strstr(output_line, "confirm txHash") != NULL) {
+                // 直接输出，不添加额外前缀，保持auditor的原始格式
+                printf("%s", output_line);
+                found_result = 1;
             }
-            escaped_pairs[escaped_idx] = '\0';
-            
-            // 使用单引号包裹所有参数，更安全
-            snprintf(auditor_cmd, sizeof(auditor_cmd), 
-                    "/home/zxx/A2L/A2L-master/ecdsa/bin/auditor '%s' '%s' '%s' 2>&1", 
-                    current->tx_hash, current->address, escaped_pairs);
-            
-            printf("[DETECTION] 执行审计命令: %s\n", auditor_cmd);
-            
-            // 使用popen来捕获auditor的输出
-            FILE *auditor_pipe = popen(auditor_cmd, "r");
-            if (!auditor_pipe) {
-                printf("[DETECTION] ❌ 无法启动审计员进程\n");
-                current->status = 2;  // 标记为过期
-                update_transaction_status(current->tx_hash, "FAILED");
-            } else {
-                char output_line[1024];
-                int found_result = 0;
-                char all_output[8192] = {0};  // 保存所有输出用于错误诊断
-                size_t output_len = 0;
-                
-                // 读取auditor的所有输出
-                while (fgets(output_line, sizeof(output_line), auditor_pipe) != NULL) {
-                    // 保存所有输出
-                    size_t line_len = strlen(output_line);
-                    if (output_len + line_len < sizeof(all_output) - 1) {
-                        strcat(all_output, output_line);
-                        output_len += line_len;
-                    }
-                    
-                    // 显示包含确认信息的行，并保持原始格式
-                    if (strstr(output_line, "confirm txHash") != NULL) {
-                        // 直接输出，不添加额外前缀，保持auditor的原始格式
-                        printf("%s", output_line);
-                        found_result = 1;
-                    }
-                }
-                
-                int result = pclose(auditor_pipe);
-                
-                if (result == 0 && found_result) {
-                    printf("[DETECTION] ✅ 审计员执行成功\n");
-                    current->status = 1;  // 已发送
-                    // 更新文件状态为 AUDITED
-                    update_transaction_status(current->tx_hash, "AUDITED");
-                } else {
-                    printf("[DETECTION] ❌ 审计员执行失败 (返回码: %d, 找到结果: %d)\n", result, found_result);
-                    if (output_len > 0) {
-                        printf("[DETECTION] 审计员输出:\n%s", all_output);
-                    } else {
-                        printf("[DETECTION] 审计员无输出\n");
-                    }
-                    current->status = 2;  // 标记为过期，避免重复尝试
-                    // 更新文件状态为 FAILED
-                    update_transaction_status(current->tx_hash, "FAILED");
-                }
-            }
-            
-            printf("[DETECTION] ========================================\n\n");
-            processed_count++;
+        }
+        
+        int result = pclose(auditor_pipe);
+        
+        if (result == 0 && found_result) {
+            printf("[DETECTION] ✅ 审计员执行成功\n");
+            status = "AUDITED";
         } else {
-            if (current->status != 0) {
-                printf("[DETECTION]     跳过: 状态不是等待中 (%d)\n", current->status);
+            printf("[DETECTION] ❌ 审计员执行失败 (返回码: %d, 找到结果: %d)\n", result, found_result);
+            if (output_len > 0) {
+                printf("[DETECTION] 审计员输出:\n%s", all_output);
             } else {
-                printf("[DETECTION]     跳过: 时间未到 (还需要 %ld 秒)\n", current->ready_time - current_time);
+                printf("[DETECTION] 审计员无输出\n");
             }
+            // 失败的项同样出队，避免重复尝试
+            status = "FAILED";
         }
-        
-        // 移动到下一个
-        current = current->next;
     }
     
-    printf("[DETECTION] 🔍 队列检查完成，处理了 %d 个项目\n", processed_count);
+    printf("[DETECTION] ========================================\n\n");
+    return status;
 }
 
-static void cleanup_expired_items() {
-    delay_queue_item_t *current = g_delay_queue.head;
-    delay_queue_item_t *prev = NULL;
-    
-    while (current) {
-        if (current->status == 1 || current->status == 2) {
-            // 已发送或已过期，从队列中移除
-            if (prev) {
-                prev->next = current->next;
-            } else {
-                g_delay_queue.head = current->next;
-            }
-            
-            if (current == g_delay_queue.tail) {
-                g_delay_queue.tail = prev;
-            }
-            
-            delay_queue_item_t *to_free = current;
-            current = current->next;
-            free(to_free);
-            g_delay_queue.count--;
-        } else {
-            prev = current;
-            current = current->next;
-        }
+// 取出所有到期项并审计；pairs_summary 只扫描一次，交易状态在本周期结束时一次写回
+static void process_ready_items() {
+    time_t current_time = time(NULL);
+    if (g_delay_queue.count == 0 || g_delay_queue.items[0].ready_time > current_time) {
+        return;
     }
-}
-
-static void print_queue_status() {
-    printf("[DETECTION] 📊 延迟队列状态: %d 项\n", g_delay_queue.count);
     
-    delay_queue_item_t *current = g_delay_queue.head;
-    int index = 1;
-    time_t current_time = time(NULL);
+    // 堆顶到期就弹出，数组按需倍增，不再扫描整个队列统计到期数
+    delay_queue_item_t *due = NULL;
+    int due_count = 0, due_capacity = 0;
+    while (g_delay_queue.count > 0 && g_delay_queue.items[0].ready_time <= current_time) {
+        if (due_count >= due_capacity) {
+            int capacity = due_capacity ? due_capacity * 2 : 16;
+            delay_queue_item_t *grown = (delay_queue_item_t*)realloc(due, capacity * sizeof(delay_queue_item_t));
+            if (!grown) break;  // 已弹出的先处理，其余留在队列中下个周期再取
+            due = grown;
+            due_capacity = capacity;
+        }
+        delay_queue_pop(&due[due_count++]);
+    }
     
-    while (current && index <= 5) {  // 只显示前5项
-        int remaining = current->ready_time - current_time;
-        if (remaining < 0) remaining = 0;
-        
-        printf("[DETECTION]   [%d] %s (剩余: %d秒, 状态: %s)\n", 
-               index, 
-               current->tx_hash,
-               remaining,
-               current->status == 0 ? "等待中" : 
-               current->status == 1 ? "已发送" : "已过期");
-        
-        current = current->next;
-        index++;
+    char (*pairs_lines)[2048] = due_count ? malloc(due_count * sizeof(*pairs_lines)) : NULL;
+    status_update_t *updates = due_count ? (status_update_t*)malloc(due_count * sizeof(status_update_t)) : NULL;
+    if (!due || !pairs_lines || !updates) {
+        printf("[DETECTION ERROR] 内存分配失败，下个周期再处理到期项\n");
+        // 放回队列（保留原序号，出队顺序不变）
+        for (int i = 0; i < due_count; i++) {
+            delay_queue_push(&due[i]);
+        }
+        free(due);
+        free(pairs_lines);
+        free(updates);
+        return;
     }
     
-    if (g_delay_queue.count > 5) {
-        printf("[DETECTION]   ... 还有 %d 项未显示\n", g_delay_queue.count - 5);
+    printf("[DETECTION] 🔍 延迟队列中有 %d 个项目到期\n", due_count);
+    
+    // 从pairs_summary.csv获取对应地址的行
+    get_pairs_summary_lines(due, due_count, pairs_lines);
+    
+    for (int i = 0; i < due_count; i++) {
+        updates[i].tx_hash = due[i].tx_hash;
+        updates[i].status = dispatch_to_auditor(&due[i], pairs_lines[i], current_time);
     }
+    
+    // 更新文件状态为 AUDITED / FAILED
+    update_transaction_statuses(updates, due_count);
+    
+    printf("[DETECTION] 🔍 队列检查完成，处理了 %d 个项目\n", due_count);
+    
+    free(updates);
+    free(pairs_lines);
+    free(due);
+}
+
+static void print_queue_status() {
+    const delay_queue_item_t *next = &g_delay_queue.items[0];
+    int remaining = next->ready_time - time(NULL);
+    if (remaining < 0) remaining = 0;
+    
+    printf("[DETECTION] 📊 延迟队列状态: %d 项，最早到期: %s (剩余: %d秒)\n", 
+           g_delay_queue.count, next->tx_hash, remaining);
 }
 
 // ========== 时间戳解析函数 ==========
@@ -509,99 +546,108 @@ static int save_suspicious_transaction_to_file(const char *tx_hash, const char *
 }
 
 // ========== 从pairs_summary.csv获取对应地址的行 ==========
-static int get_pairs_summary_line(const char *address, char *line_buffer, size_t buffer_size) {
+// 一次扫描为本周期所有到期项查找对应行；未找到的置为空字符串
+static int get_pairs_summary_lines(const delay_queue_item_t *items, int count, char (*lines)[2048]) {
     const char *pairs_summary_file = "/home/zxx/A2L/A2L-master/ecdsa/bin/log_game/pairs_summary.csv";
     
+    for (int i = 0; i < count; i++) {
+        lines[i][0] = '\0';
+    }
+    
     FILE *file = fopen(pairs_summary_file, "r");
     if (!file) {
         printf("[DETECTION] ⚠️  无法打开pairs_summary.csv文件: %s\n", pairs_summary_file);
-        line_buffer[0] = '\0';
         return -1;
     }
     
     char line[2048];
     int found = 0;
     
-    while (fgets(line, sizeof(line), file) != NULL) {
-        // 检查行是否以该地址开头
-        if (strncmp(line, address, strlen(address)) == 0) {
-            // 找到匹配的行，复制到缓冲区
-            size_t line_len = strlen(line);
-            // 去除末尾的换行符
-            if (line_len > 0 && line[line_len - 1] == '\n') {
-                line[line_len - 1] = '\0';
-                line_len--;
-            }
-            
-            if (line_len < buffer_size) {
-                strncpy(line_buffer, line, buffer_size - 1);
-                line_buffer[buffer_size - 1] = '\0';
-                found = 1;
-            } else {
-                // 行太长，截断
-                strncpy(line_buffer, line, buffer_size - 1);
-                line_buffer[buffer_size - 1] = '\0';
-                found = 1;
+    while (found < count && fgets(line, sizeof(line), file) != NULL) {
+        // 去除末尾的换行符
+        size_t line_len = strlen(line);
+        if (line_len > 0 && line[line_len - 1] == '\n') {
+            line[line_len - 1] = '\0';
+        }
+        
+        // 检查行是否以某个到期地址开头（每个地址取第一条匹配的行）
+        for (int i = 0; i < count; i++) {
+            if (lines[i][0] == '\0' && strncmp(line, items[i].address, strlen(items[i].address)) == 0) {
+                strncpy(lines[i], line, sizeof(lines[i]) - 1);
+                lines[i][sizeof(lines[i]) - 1] = '\0';
+                found++;
             }
-            break;
         }
     }
     
     fclose(file);
     
-    if (!found) {
-        printf("[DETECTION] ⚠️  在pairs_summary.csv中未找到地址: %s\n", address);
-        line_buffer[0] = '\0';
-        return -1;
+    for (int i = 0; i < count; i++) {
+        if (lines[i][0] == '\0') {
+            printf("[DETECTION] ⚠️  在pairs_summary.csv中未找到地址: %s\n", items[i].address);
+        }
     }
     
-    return 0;
+    return found;
 }
 
 // ========== 更新文件中的交易状态 ==========
-static int update_transaction_status(const char *tx_hash, const char *status) {
+// 一个周期的所有状态更新合并为一次读取和一次写回；写到临时文件后 rename，读者不会看到写了一半的文件
+static int update_transaction_statuses(const status_update_t *updates, int count) {
+    if (count <= 0) {
+        return 0;
+    }
+    
     const char *detect_dir = "/home/zxx/A2L/A2L-master/ecdsa/bin/detect_transaction";
     char file_path[1024];
+    char temp_path[1100];
     snprintf(file_path, sizeof(file_path), "%s/suspicious_transactions.csv", detect_dir);
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", file_path);
     
-    // 读取文件内容
     FILE *file = fopen(file_path, "r");
     if (!file) {
         return -1;
     }
-    
-    char lines[1000][1024];  // 假设最多1000行
-    int line_count = 0;
-    char line[1024];
-    
-    while (fgets(line, sizeof(line), file) && line_count < 1000) {
-        strcpy(lines[line_count], line);
-        line_count++;
+    FILE *out = fopen(temp_path, "w");
+    if (!out) {
+        fclose(file);
+        return -1;
     }
-    fclose(file);
     
-    // 更新状态
-    for (int i = 0; i < line_count; i++) {
-        if (strstr(lines[i], tx_hash) != NULL) {
-            // 找到对应的行，更新状态
-            char *comma_pos = strrchr(lines[i], ',');
+    char *applied = (char*)calloc(count, 1);
+    char *line = NULL;
+    size_t line_cap = 0;
+    ssize_t line_len;
+    
+    while ((line_len = getline(&line, &line_cap, file)) > 0) {
+        // 找到对应的行，更新状态（每个交易哈希只更新第一条匹配的行）
+        for (int i = 0; applied && i < count; i++) {
+            if (applied[i] || strstr(line, updates[i].tx_hash) == NULL) {
+                continue;
+            }
+            applied[i] = 1;
+            char *comma_pos = strrchr(line, ',');
             if (comma_pos) {
-                snprintf(comma_pos + 1, sizeof(lines[i]) - (comma_pos - lines[i]), "%s\n", status);
+                *(comma_pos + 1) = '\0';
+                fputs(line, out);
+                fprintf(out, "%s\n", updates[i].status);
+                line_len = 0;  // 已写出
             }
             break;
         }
+        if (line_len > 0) {
+            fputs(line, out);
+        }
     }
     
-    // 写回文件
-    file = fopen(file_path, "w");
-    if (!file) {
-        return -1;
-    }
+    free(line);
+    free(applied);
+    fclose(file);
     
-    for (int i = 0; i < line_count; i++) {
-        fputs(lines[i], file);
+    if (fclose(out) != 0 || rename(temp_path, file_path) != 0) {
+        unlink(temp_path);
+        return -1;
     }
-    fclose(file);
     
     return 0;
 }
@@ -609,13 +655,11 @@ static int update_transaction_status(const char *tx_hash, const char *status) {
 // ========== 处理可疑交易（保存到文件 + 加入延迟队列） ==========
 static int handle_suspicious_transaction(const char *tx_hash, const char *address, int count, time_t latest_time) {
     // 检查该交易哈希是否已在延迟队列中
-    delay_queue_item_t *current = g_delay_queue.head;
-    while (current) {
-        if (strcmp(current->tx_hash, tx_hash) == 0) {
+    for (int i = 0; i < g_delay_queue.count; i++) {
+        if (strcmp(g_delay_queue.items[i].tx_hash, tx_hash) == 0) {
             printf("[DETECTION] ⏭️  交易哈希 %s 已在延迟队列中，跳过\n", tx_hash);
             return 0;
         }
-        current = current->next;
     }
     
     // 1. 保存到文件（用于记录和调试）
@@ -637,337 +681,234 @@ static int handle_suspicious_transaction(const char *tx_hash, const char *addres
     return 0;
 }
 
-// DBSCAN参数（仅用于显示，实际在Python中）
+// DBSCAN参数
 #define DBSCAN_EPS 0.3              // 邻域半径
 #define DBSCAN_MIN_SAMPLES 3         // 最小样本数
 #define FEATURE_DIM 8                // 特征维度
 
-// ========== 解析Python输出的JSON结果 ==========
-static int parse_suspicious_addresses_json(const char *json_str, suspicious_address_t *suspicious_list, int max_count) {
-    int count = 0;
-    const char *p = json_str;
-    
-    // 查找 "suspicious_addresses": [ 的位置
-    const char *array_start = strstr(p, "\"suspicious_addresses\"");
-    if (!array_start) {
-        printf("[CLUSTERING ERROR] 未找到suspicious_addresses字段\n");
-        return 0;
+// ========== 交易流：增量读取交易文件并维护地址统计 ==========
+// 记住已读到的字节偏移，每个检测周期只解析新增的完整行；每笔交易 O(1) 更新所属地址的统计，
+// 时间窗口计数由每个窗口一个按时间的最小堆在周期开始时过期。周期内的工作量与新增交易数和
+// 地址数相关，与历史交易总数无关。文件被替换或截断时从头重建。
+static uint64_t address_hash(const char *s) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (const unsigned char *p = (const unsigned char *)s; *p; p++) {
+        h ^= *p;
+        h *= 0x100000001b3ULL;
     }
-    
-    // 找到数组开始位置 [
-    array_start = strchr(array_start, '[');
-    if (!array_start) {
-        printf("[CLUSTERING ERROR] 未找到数组开始标记\n");
-        return 0;
+    return h;
+}
+
+static void tx_stream_reset(tx_stream_t *s) {
+    free(s->stats);
+    free(s->slots);
+    for (int k = 0; k < TX_WINDOW_COUNT; k++) {
+        free(s->windows[k].items);
     }
-    
-    p = array_start + 1;  // 跳过 [
-    
-    // 解析数组中的每个对象
-    while (*p && count < max_count) {
-        // 跳过空格、逗号、换行符
-        while (*p == ' ' || *p == ',' || *p == '\n' || *p == '\r' || *p == '\t') p++;
-        
-        if (*p == ']') break;  // 数组结束
-        
-        if (*p != '{') {
-            p++;
-            continue;
-        }
-        
-        // 解析一个对象
-        suspicious_address_t *item = &suspicious_list[count];
-        memset(item, 0, sizeof(suspicious_address_t));
-        
-        p++;  // 跳过 {
-        
-        // 解析字段
-        while (*p && *p != '}') {
-            // 跳过空格
-            while (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t') p++;
-            
-            if (*p == '}') break;
-            
-            // 解析字段名
-            if (*p == '"') {
-                p++;  // 跳过开始引号
-                const char *field_start = p;
-                while (*p && *p != '"') p++;
-                if (*p != '"') break;
-                
-                size_t field_len = p - field_start;
-                p++;  // 跳过结束引号
-                
-                // 跳过 : 和空格
-                while (*p == ' ' || *p == ':') p++;
-                
-                // 解析字段值
-                if (strncmp(field_start, "address", field_len) == 0 && *p == '"') {
-                    p++;  // 跳过开始引号
-                    const char *val_start = p;
-                    while (*p && *p != '"') p++;
-                    size_t val_len = p - val_start;
-                    if (val_len < sizeof(item->address)) {
-                        strncpy(item->address, val_start, val_len);
-                        item->address[val_len] = '\0';
-                    }
-                    if (*p == '"') p++;
-                } else if (strncmp(field_start, "tx_hash", field_len) == 0 && *p == '"') {
-                    p++;  // 跳过开始引号
-                    const char *val_start = p;
-                    while (*p && *p != '"') p++;
-                    size_t val_len = p - val_start;
-                    if (val_len < sizeof(item->tx_hash)) {
-                        strncpy(item->tx_hash, val_start, val_len);
-                        item->tx_hash[val_len] = '\0';
-                    }
-                    if (*p == '"') p++;
-                } else if (strncmp(field_start, "timestamp", field_len) == 0) {
-                    // 解析时间戳（数字）
-                    item->timestamp = 0;
-                    while (*p >= '0' && *p <= '9') {
-                        item->timestamp = item->timestamp * 10 + (*p - '0');
-                        p++;
-                    }
-                } else if (strncmp(field_start, "anomaly_score", field_len) == 0) {
-                    // 解析异常分数（浮点数）
-                    item->anomaly_score = strtod(p, (char**)&p);
-                } else if (strncmp(field_start, "cluster_id", field_len) == 0) {
-                    // 解析簇ID（可能是负数）
-                    int sign = 1;
-                    if (*p == '-') {
-                        sign = -1;
-                        p++;
-                    }
-                    item->cluster_id = 0;
-                    while (*p >= '0' && *p <= '9') {
-                        item->cluster_id = item->cluster_id * 10 + (*p - '0');
-                        p++;
-                    }
-                    item->cluster_id *= sign;
-                } else {
-                    // 跳过未知字段的值
-                    if (*p == '"') {
-                        p++;
-                        while (*p && *p != '"') p++;
-                        if (*p == '"') p++;
-                    } else if (*p == '{') {
-                        // 嵌套对象，跳过
-                        int depth = 1;
-                        p++;
-                        while (*p && depth > 0) {
-                            if (*p == '{') depth++;
-                            else if (*p == '}') depth--;
-                            p++;
-                        }
-                    } else {
-                        // 数字或其他，跳过到下一个逗号或}
-                        while (*p && *p != ',' && *p != '}') p++;
-                    }
-                }
-            } else {
-                p++;
-            }
-            
-            // 跳过逗号
-            while (*p == ' ' || *p == ',') p++;
-        }
-        
-        if (*p == '}') {
-            p++;
-            count++;
+    memset(s, 0, sizeof(*s));
+}
+
+static int window_heap_push(window_heap_t *h, time_t t, int address) {
+    if (h->size == h->capacity) {
+        size_t capacity = h->capacity ? h->capacity * 2 : 1024;
+        window_event_t *grown = (window_event_t*)realloc(h->items, capacity * sizeof(window_event_t));
+        if (!grown) {
+            return -1;
         }
+        h->items = grown;
+        h->capacity = capacity;
     }
-    
-    return count;
+    size_t i = h->size++;
+    while (i > 0 && h->items[(i - 1) / 2].time > t) {
+        h->items[i] = h->items[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    h->items[i].time = t;
+    h->items[i].address = address;
+    return 0;
 }
 
-// ========== 聚类分析检测函数（调用Python脚本） ==========
-static int detect_high_frequency_transactions(const char *csv_file) {
-    printf("\n[DETECTION] ========== 开始聚类分析检测 ==========\n");
-    printf("[DETECTION] 调用Python脚本: %s\n", PYTHON_DBSCAN_SCRIPT);
-    printf("[DETECTION] CSV文件: %s\n", csv_file);
-    
-    // 构建Python命令
-    char python_cmd[2048];
-    char temp_output_file[512];
-    snprintf(temp_output_file, sizeof(temp_output_file), "/tmp/dbscan_output_%d.json", getpid());
-    
-    // 调用Python脚本（Python脚本内部使用固定的CSV文件路径，输出到临时文件）
-    snprintf(python_cmd, sizeof(python_cmd), 
-             "python3 %s > %s 2>&1", 
-             PYTHON_DBSCAN_SCRIPT, temp_output_file);
-    
-    printf("[DETECTION] 执行命令: %s\n", python_cmd);
-    
-    int ret = system(python_cmd);
-    if (ret != 0) {
-        printf("[DETECTION ERROR] Python脚本执行失败，返回码: %d\n", ret);
-        // 读取错误输出
-        FILE *err_file = fopen(temp_output_file, "r");
-        if (err_file) {
-            char err_buf[1024];
-            while (fgets(err_buf, sizeof(err_buf), err_file)) {
-                printf("[DETECTION ERROR] %s", err_buf);
-            }
-            fclose(err_file);
+static void window_heap_pop(window_heap_t *h) {
+    window_event_t last = h->items[--h->size];
+    size_t i = 0;
+    while (1) {
+        size_t child = 2 * i + 1;
+        if (child >= h->size) break;
+        if (child + 1 < h->size && h->items[child + 1].time < h->items[child].time) child++;
+        if (h->items[child].time >= last.time) break;
+        h->items[i] = h->items[child];
+        i = child;
+    }
+    if (h->size > 0) {
+        h->items[i] = last;
+    }
+}
+
+// 查找或创建地址统计，返回下标；内存不足返回 -1
+static int tx_stream_address(tx_stream_t *s, const char *address) {
+    if ((size_t)(s->count + 1) * 2 > s->slot_capacity) {
+        size_t capacity = s->slot_capacity ? s->slot_capacity * 2 : 1024;
+        int *slots = (int*)calloc(capacity, sizeof(int));
+        if (!slots) {
+            return -1;
         }
-        unlink(temp_output_file);
-        return 0;
+        for (int i = 0; i < s->count; i++) {
+            size_t h = (size_t)address_hash(s->stats[i].address) & (capacity - 1);
+            while (slots[h]) h = (h + 1) & (capacity - 1);
+            slots[h] = i + 1;
+        }
+        free(s->slots);
+        s->slots = slots;
+        s->slot_capacity = capacity;
     }
-    
-    // 读取Python脚本的输出
-    FILE *output_file = fopen(temp_output_file, "r");
-    if (!output_file) {
-        printf("[DETECTION ERROR] 无法读取Python脚本输出\n");
-        unlink(temp_output_file);
-        return 0;
+
+    size_t h = (size_t)address_hash(address) & (s->slot_capacity - 1);
+    while (s->slots[h]) {
+        if (strcmp(s->stats[s->slots[h] - 1].address, address) == 0) {
+            return s->slots[h] - 1;
+        }
+        h = (h + 1) & (s->slot_capacity - 1);
     }
-    
-    char json_output[1024 * 1024] = {0};
-    size_t output_len = 0;
-    char line[4096];
-    
-    while (fgets(line, sizeof(line), output_file) && output_len < sizeof(json_output) - 1) {
-        size_t line_len = strlen(line);
-        if (output_len + line_len < sizeof(json_output) - 1) {
-            strcat(json_output, line);
-            output_len += line_len;
+
+    if (s->count >= s->capacity) {
+        int capacity = s->capacity ? s->capacity * 2 : 256;
+        address_stat_t *grown = (address_stat_t*)realloc(s->stats, capacity * sizeof(address_stat_t));
+        if (!grown) {
+            return -1;
         }
+        s->stats = grown;
+        s->capacity = capacity;
     }
-    fclose(output_file);
-    
-    // 清理临时文件
-    unlink(temp_output_file);
-    
-    // 解析可疑地址列表
-    suspicious_address_t suspicious_list[1000];
-    int suspicious_count = parse_suspicious_addresses_json(json_output, suspicious_list, 1000);
-    
-    if (suspicious_count == 0) {
-        printf("[DETECTION] 未检测到可疑地址\n");
-        printf("[DETECTION] ========== 聚类分析检测完成 ==========\n\n");
-        return 0;
+    address_stat_t *stat = &s->stats[s->count];
+    memset(stat, 0, sizeof(*stat));
+    snprintf(stat->address, sizeof(stat->address), "%s", address);
+    s->slots[h] = ++s->count;
+    return s->count - 1;
+}
+
+static void tx_stream_add(tx_stream_t *s, const transaction_record_t *record, time_t now) {
+    int idx = tx_stream_address(s, record->from_address);
+    if (idx < 0) {
+        printf("[CLUSTERING ERROR] 内存分配失败，跳过交易 %s\n", record->tx_hash);
+        return;
     }
-    
-    printf("[DETECTION] Python脚本识别了 %d 个可疑地址\n", suspicious_count);
-    
-    // ========== 处理可疑交易 ==========
-    int saved_count = 0;
-    
-    for (int i = 0; i < suspicious_count; i++) {
-        printf("\n[DETECTION] ⚠️  检测到可疑地址（聚类分析）!\n");
-        printf("[DETECTION] 地址: %s\n", suspicious_list[i].address);
-        printf("[DETECTION] 最新交易哈希: %s\n", suspicious_list[i].tx_hash);
-        printf("[DETECTION] 异常分数: %.2f\n", suspicious_list[i].anomaly_score);
-        printf("[DETECTION] 簇ID: %d\n", suspicious_list[i].cluster_id);
-        char time_str[64];
-        strftime(time_str, sizeof(time_str), "%Y-%m-%d %H:%M:%S", 
-                localtime(&suspicious_list[i].timestamp));
-        printf("[DETECTION] 最新交易时间: %s\n", time_str);
-        
-        // 直接处理可疑交易（加入延迟队列）
-        if (handle_suspicious_transaction(suspicious_list[i].tx_hash, 
-                                         suspicious_list[i].address, 
-                                         0,  // count参数不再使用
-                                         suspicious_list[i].timestamp) == 0) {
-            saved_count++;
+    address_stat_t *stat = &s->stats[idx];
+    time_t t = record->parsed_time;
+
+    stat->tx_count++;
+    stat->total_value += record->value;
+
+    if (stat->tx_count == 1) {
+        stat->first_tx_time = t;
+        stat->last_tx_time = t;
+        strcpy(stat->latest_tx_hash, record->tx_hash);
+    } else {
+        // 交易间隔（相邻两笔，按文件顺序）的均值和方差：Welford 递推
+        double interval = (double)(t - stat->prev_tx_time);
+        int n = stat->tx_count - 1;
+        double delta = interval - stat->interval_mean;
+        stat->interval_mean += delta / n;
+        stat->interval_m2 += delta * (interval - stat->interval_mean);
+
+        if (t < stat->first_tx_time) {
+            stat->first_tx_time = t;
+        }
+        // 同一时间取最先出现的交易作为最新交易
+        if (t > stat->last_tx_time) {
+            stat->last_tx_time = t;
+            strcpy(stat->latest_tx_hash, record->tx_hash);
+        }
+    }
+    stat->prev_tx_time = t;
+
+    for (int k = 0; k < TX_WINDOW_COUNT; k++) {
+        if (now - t <= TX_WINDOW_SECONDS[k] && window_heap_push(&s->windows[k], t, idx) == 0) {
+            stat->window_counts[k]++;
         }
     }
-    
-    printf("[DETECTION] 共检测到 %d 个可疑地址，全部已处理\n", suspicious_count);
-    
-    printf("[DETECTION] ========== 聚类分析检测完成 ==========\n\n");
-    
-    return saved_count;
 }
 
-// ========== 信号处理函数 ==========
-static void cleanup_and_exit(int sig) {
-    printf("\n[DETECTION] 收到退出信号 (%d)，正在清理...\n", sig);
-    
-    // 清理延迟队列
-    delay_queue_item_t *current = g_delay_queue.head;
-    while (current) {
-        delay_queue_item_t *next = current->next;
-        free(current);
-        current = next;
+// 把已滑出窗口的交易从计数中减去
+static void tx_stream_expire(tx_stream_t *s, time_t now) {
+    for (int k = 0; k < TX_WINDOW_COUNT; k++) {
+        window_heap_t *h = &s->windows[k];
+        while (h->size > 0 && now - h->items[0].time > TX_WINDOW_SECONDS[k]) {
+            s->stats[h->items[0].address].window_counts[k]--;
+            window_heap_pop(h);
+        }
     }
-    
-    printf("[DETECTION] 清理完成，程序退出\n");
-    exit(0);
 }
 
-// ========== 步骤1：统计地址信息 ==========
-static int aggregate_address_statistics(transaction_record_t *records, int record_count,
-                                       address_stat_t **address_stats, int *address_count) {
-    if (records == NULL || record_count <= 0) {
+// 读取上次之后追加的完整行，并把窗口计数推进到 now
+static int tx_stream_update(tx_stream_t *s, const char *csv_file, time_t now) {
+    FILE *file = fopen(csv_file, "r");
+    if (!file) {
+        printf("[DETECTION] ⚠️  无法打开交易文件: %s\n", csv_file);
         return -1;
     }
-    
-    // 使用简单的哈希表或数组来统计唯一地址
-    address_stat_t stats[10000];
-    int count = 0;
-    
-    for (int i = 0; i < record_count; i++) {
-        // 查找或创建地址统计
-        int found = 0;
-        int idx = -1;
-        for (int j = 0; j < count; j++) {
-            if (strcmp(stats[j].address, records[i].from_address) == 0) {
-                found = 1;
-                idx = j;
-                break;
-            }
-        }
-        
-        if (!found) {
-            if (count >= 10000) {
-                printf("[CLUSTERING ERROR] 地址数量超过限制\n");
-                return -1;
-            }
-            idx = count++;
-            memset(&stats[idx], 0, sizeof(address_stat_t));
-            strncpy(stats[idx].address, records[i].from_address, sizeof(stats[idx].address) - 1);
-            stats[idx].address[sizeof(stats[idx].address) - 1] = '\0';
-            stats[idx].tx_times_capacity = 16;
-            stats[idx].tx_times = (time_t*)malloc(stats[idx].tx_times_capacity * sizeof(time_t));
+
+    struct stat st;
+    int reset = fstat(fileno(file), &st) != 0 || !s->has_file ||
+                st.st_dev != s->dev || st.st_ino != s->inode || st.st_size < s->offset;
+    if (!reset && s->offset > 0) {
+        // 上次读到的最后一个字节必须仍是换行符，否则文件被重写过
+        reset = fseeko(file, s->offset - 1, SEEK_SET) != 0 || fgetc(file) != '\n';
+    }
+    if (reset) {
+        if (s->has_file) {
+            printf("[DETECTION] 交易文件被替换或截断，重新统计\n");
         }
-        
-        address_stat_t *stat = &stats[idx];
-        stat->tx_count++;
-        double value = records[i].value;
-        stat->total_value += value;
-        
-        // 更新交易时间
-        if (stat->tx_times_size >= stat->tx_times_capacity) {
-            stat->tx_times_capacity *= 2;
-            stat->tx_times = (time_t*)realloc(stat->tx_times, 
-                                             stat->tx_times_capacity * sizeof(time_t));
+        tx_stream_reset(s);
+        s->has_file = 1;
+        s->dev = st.st_dev;
+        s->inode = st.st_ino;
+    }
+    if (fseeko(file, s->offset, SEEK_SET) != 0) {
+        fclose(file);
+        return -1;
+    }
+
+    char *line = NULL;
+    size_t line_cap = 0;
+    ssize_t line_len;
+    int new_records = 0;
+    transaction_record_t record;
+
+    while ((line_len = getline(&line, &line_cap, file)) > 0) {
+        if (line[line_len - 1] != '\n') {
+            break;  // 写了一半的行，下个周期再读
         }
-        stat->tx_times[stat->tx_times_size++] = records[i].parsed_time;
-        
-        // 更新首次和最后交易时间
-        if (stat->tx_count == 1) {
-            stat->first_tx_time = records[i].parsed_time;
-            stat->last_tx_time = records[i].parsed_time;
-        } else {
-            if (records[i].parsed_time < stat->first_tx_time) {
-                stat->first_tx_time = records[i].parsed_time;
-            }
-            if (records[i].parsed_time > stat->last_tx_time) {
-                stat->last_tx_time = records[i].parsed_time;
-            }
+        s->offset += line_len;
+        if (parse_csv_line(line, &record) == 0) {
+            tx_stream_add(s, &record, now);
+            s->record_count++;
+            new_records++;
         }
     }
-    
-    printf("[CLUSTERING] 共统计 %d 个唯一地址\n", count);
-    *address_stats = (address_stat_t*)malloc(count * sizeof(address_stat_t));
-    memcpy(*address_stats, stats, count * sizeof(address_stat_t));
-    *address_count = count;
+
+    free(line);
+    fclose(file);
+
+    tx_stream_expire(s, now);
+    printf("[CLUSTERING] 步骤1: 增量统计地址信息（新增 %d 条交易，累计 %lld 条，%d 个唯一地址）\n",
+           new_records, s->record_count, s->count);
     return 0;
 }
 
+// ========== 信号处理函数 ==========
+static void cleanup_and_exit(int sig) {
+    printf("\n[DETECTION] 收到退出信号 (%d)，正在清理...\n", sig);
+    
+    // 清理延迟队列
+    free(g_delay_queue.items);
+    g_delay_queue.items = NULL;
+    g_delay_queue.count = 0;
+    tx_stream_reset(&g_tx_stream);
+    
+    printf("[DETECTION] 清理完成，程序退出\n");
+    exit(0);
+}
+
 // ========== 步骤2：特征工程 - 计算特征向量 ==========
 static int extract_features(address_stat_t *address_stats, int address_count,
                             address_feature_t **features, double *feature_min, double *feature_max) {
@@ -985,9 +926,7 @@ static int extract_features(address_stat_t *address_stats, int address_count,
         feature_max[i] = -1e10;
     }
     
-    time_t current_time = time(NULL);
-    
-    // 为每个地址计算特征
+    // 为每个地址计算特征（统计量已随交易流增量维护，这里只是 O(地址数) 的读取）
     for (int i = 0; i < address_count; i++) {
         address_stat_t *stat = &address_stats[i];
         strncpy(feat[i].address, stat->address, sizeof(feat[i].address) - 1);
@@ -1000,49 +939,19 @@ static int extract_features(address_stat_t *address_stats, int address_count,
         feat[i].features[0] = (double)stat->tx_count;
         
         // 特征1: 平均交易间隔（秒）
-        double avg_interval = 0.0;
-        if (stat->tx_count > 1 && stat->tx_times_size > 1) {
-            double total_interval = 0.0;
-            for (int j = 1; j < stat->tx_times_size; j++) {
-                total_interval += (double)(stat->tx_times[j] - stat->tx_times[j-1]);
-            }
-            avg_interval = total_interval / (stat->tx_times_size - 1);
-        }
-        feat[i].features[1] = avg_interval;
+        feat[i].features[1] = stat->tx_count > 1 ? stat->interval_mean : 0.0;
         
         // 特征2: 交易间隔标准差
         double interval_std = 0.0;
-        if (stat->tx_count > 1 && stat->tx_times_size > 1) {
-            double sum_sq_diff = 0.0;
-            for (int j = 1; j < stat->tx_times_size; j++) {
-                double interval = (double)(stat->tx_times[j] - stat->tx_times[j-1]);
-                double diff = interval - avg_interval;
-                sum_sq_diff += diff * diff;
-            }
-            interval_std = sqrt(sum_sq_diff / (stat->tx_times_size - 1));
+        if (stat->tx_count > 1 && stat->interval_m2 > 0) {
+            interval_std = sqrt(stat->interval_m2 / (stat->tx_count - 1));
         }
         feat[i].features[2] = interval_std;
         
-        // 特征3: 1分钟内交易数
-        int tx_1min = 0;
-        for (int j = 0; j < stat->tx_times_size; j++) {
-            if (current_time - stat->tx_times[j] <= 60) tx_1min++;
-        }
-        feat[i].features[3] = (double)tx_1min;
-        
-        // 特征4: 5分钟内交易数
-        int tx_5min = 0;
-        for (int j = 0; j < stat->tx_times_size; j++) {
-            if (current_time - stat->tx_times[j] <= 300) tx_5min++;
-        }
-        feat[i].features[4] = (double)tx_5min;
-        
-        // 特征5: 1小时内交易数
-        int tx_1hour = 0;
-        for (int j = 0; j < stat->tx_times_size; j++) {
-            if (current_time - stat->tx_times[j] <= 3600) tx_1hour++;
-        }
-        feat[i].features[5] = (double)tx_1hour;
+        // 特征3-5: 1分钟 / 5分钟 / 1小时内交易数
+        feat[i].features[3] = (double)stat->window_counts[0];
+        feat[i].features[4] = (double)stat->window_counts[1];
+        feat[i].features[5] = (double)stat->window_counts[2];
         
         // 特征6: 总交易金额（保留，但不使用平均金额）
         feat[i].features[6] = stat->total_value;
@@ -1084,206 +993,47 @@ static void normalize_features(address_feature_t *features, int count,
     }
 }
 
-// ========== 辅助函数：解析JSON中的cluster_labels数组 ==========
-static int parse_cluster_labels(const char *json_str, int *cluster_labels, int count) {
-    // 查找 "cluster_labels": [ 的位置
-    const char *labels_start = strstr(json_str, "\"cluster_labels\"");
-    if (!labels_start) {
-        printf("[CLUSTERING ERROR] 未找到cluster_labels字段\n");
-        printf("[CLUSTERING DEBUG] JSON内容: %.500s\n", json_str);
-        return -1;
-    }
-    
-    // 找到数组开始位置 [
-    const char *array_start = strchr(labels_start, '[');
-    if (!array_start) {
-        printf("[CLUSTERING ERROR] 未找到数组开始标记\n");
-        return -1;
-    }
-    
-    array_start++; // 跳过 [
-    
-    // 解析数组中的每个数字
-    int idx = 0;
-    const char *p = array_start;
-    
-    while (*p && idx < count) {
-        // 跳过空格、逗号、换行符
-        while (*p == ' ' || *p == ',' || *p == '\n' || *p == '\r' || *p == '\t') p++;
-        
-        if (*p == ']') break; // 数组结束
-        
-        // 解析数字（可能是负数）
-        int sign = 1;
-        if (*p == '-') {
-            sign = -1;
-            p++;
-        }
-        
-        if (*p >= '0' && *p <= '9') {
-            int value = 0;
-            while (*p >= '0' && *p <= '9') {
-                value = value * 10 + (*p - '0');
-                p++;
-            }
-            cluster_labels[idx++] = value * sign;
-        } else if (*p != ']' && *p != '\0') {
-            // 跳过非数字字符（可能是JSON的其他部分）
-            p++;
-        } else {
-            break;
-        }
-    }
-    
-    if (idx != count) {
-        printf("[CLUSTERING WARNING] 解析了 %d 个标签，期望 %d 个\n", idx, count);
-    }
-    
-    return idx;
-}
-
-// ========== 步骤3：DBSCAN聚类（调用Python脚本） ==========
+// ========== 步骤3：DBSCAN聚类（进程内，k-d 树邻域索引） ==========
 static void dbscan_clustering(address_feature_t *features, int count) {
-    printf("[CLUSTERING] 步骤3: DBSCAN聚类分析（使用Python scikit-learn）\n");
+    printf("[CLUSTERING] 步骤3: DBSCAN聚类分析（进程内 k-d 树）\n");
     printf("[CLUSTERING] 参数: eps=%.2f, min_samples=%d\n", DBSCAN_EPS, DBSCAN_MIN_SAMPLES);
     
-    if (count == 0) {
+    if (count <= 0) {
         printf("[CLUSTERING WARNING] 没有特征数据需要聚类\n");
         return;
     }
     
-    // 构建JSON输入数据
-    char json_input[1024 * 1024] = {0}; // 1MB缓冲区
-    int json_len = 0;
-    
-    // 开始JSON对象
-    json_len += snprintf(json_input + json_len, sizeof(json_input) - json_len, 
-                        "{\"features\":[");
-    
-    // 写入特征向量
-    for (int i = 0; i < count; i++) {
-        if (i > 0) json_len += snprintf(json_input + json_len, sizeof(json_input) - json_len, ",");
-        json_len += snprintf(json_input + json_len, sizeof(json_input) - json_len, "[");
-        
-        for (int j = 0; j < FEATURE_DIM; j++) {
-            if (j > 0) json_len += snprintf(json_input + json_len, sizeof(json_input) - json_len, ",");
-            json_len += snprintf(json_input + json_len, sizeof(json_input) - json_len, 
-                               "%.10f", features[i].features[j]);
-        }
-        json_len += snprintf(json_input + json_len, sizeof(json_input) - json_len, "]");
-    }
-    
-    // 写入地址列表
-    json_len += snprintf(json_input + json_len, sizeof(json_input) - json_len, 
-                        "],\"addresses\":[");
-    for (int i = 0; i < count; i++) {
-        if (i > 0) json_len += snprintf(json_input + json_len, sizeof(json_input) - json_len, ",");
-        json_len += snprintf(json_input + json_len, sizeof(json_input) - json_len, 
-                           "\"%s\"", features[i].address);
-    }
-    
-    // 写入参数
-    json_len += snprintf(json_input + json_len, sizeof(json_input) - json_len, 
-                        "],\"eps\":%.2f,\"min_samples\":%d}", 
-                        DBSCAN_EPS, DBSCAN_MIN_SAMPLES);
-    
-    // 使用临时文件方式传递数据（popen只能单向通信）
-    char temp_input_file[512];
-    char temp_output_file[512];
-    snprintf(temp_input_file, sizeof(temp_input_file), "/tmp/dbscan_input_%d.json", getpid());
-    snprintf(temp_output_file, sizeof(temp_output_file), "/tmp/dbscan_output_%d.json", getpid());
-    
-    // 写入输入文件
-    FILE *input_file = fopen(temp_input_file, "w");
-    if (!input_file) {
-        printf("[CLUSTERING ERROR] 无法创建临时输入文件\n");
-        return;
-    }
-    fprintf(input_file, "%s", json_input);
-    fclose(input_file);
-    
-    // 调用Python脚本（从文件读取，输出到文件）
-    char python_cmd[2048];
-    snprintf(python_cmd, sizeof(python_cmd), 
-             "python3 %s < %s > %s 2>&1", 
-             PYTHON_DBSCAN_SCRIPT, temp_input_file, temp_output_file);
-    
-    int ret = system(python_cmd);
-    if (ret != 0) {
-        printf("[CLUSTERING ERROR] Python脚本执行失败，返回码: %d\n", ret);
-        // 读取错误输出
-        FILE *err_file = fopen(temp_output_file, "r");
-        if (err_file) {
-            char err_buf[1024];
-            while (fgets(err_buf, sizeof(err_buf), err_file)) {
-                printf("[CLUSTERING ERROR] %s", err_buf);
-            }
-            fclose(err_file);
-        }
-        unlink(temp_input_file);
-        unlink(temp_output_file);
-        return;
-    }
-    
-    // 读取Python脚本的输出
-    FILE *output_file = fopen(temp_output_file, "r");
-    if (!output_file) {
-        printf("[CLUSTERING ERROR] 无法读取Python脚本输出\n");
-        unlink(temp_input_file);
-        unlink(temp_output_file);
-        return;
-    }
-    
-    char json_output[1024 * 1024] = {0};
-    size_t output_len = 0;
-    char line[4096];
-    
-    while (fgets(line, sizeof(line), output_file) && output_len < sizeof(json_output) - 1) {
-        size_t line_len = strlen(line);
-        if (output_len + line_len < sizeof(json_output) - 1) {
-            strcat(json_output, line);
-            output_len += line_len;
-        }
-    }
-    fclose(output_file);
-    
-    // 清理临时文件
-    unlink(temp_input_file);
-    unlink(temp_output_file);
-    
-    // 解析cluster_labels
+    double *points = (double*)malloc((size_t)count * FEATURE_DIM * sizeof(double));
     int *cluster_labels = (int*)malloc(count * sizeof(int));
-    if (!cluster_labels) {
+    if (!points || !cluster_labels) {
         printf("[CLUSTERING ERROR] 内存分配失败\n");
+        free(points);
+        free(cluster_labels);
         return;
     }
     
-    int parsed_count = parse_cluster_labels(json_output, cluster_labels, count);
-    if (parsed_count != count) {
-        printf("[CLUSTERING ERROR] 解析的标签数量 (%d) 与特征数量 (%d) 不匹配\n", 
-               parsed_count, count);
+    for (int i = 0; i < count; i++) {
+        memcpy(&points[(size_t)i * FEATURE_DIM], features[i].features, FEATURE_DIM * sizeof(double));
+    }
+    
+    int n_clusters = dbscan_fit(points, count, FEATURE_DIM, DBSCAN_EPS, DBSCAN_MIN_SAMPLES, cluster_labels);
+    if (n_clusters < 0) {
+        printf("[CLUSTERING ERROR] DBSCAN聚类失败\n");
+        free(points);
         free(cluster_labels);
         return;
     }
     
     // 将聚类结果赋值给features
-    int n_clusters = 0;
     int n_noise = 0;
-    int max_cluster_id = -1;
-    
     for (int i = 0; i < count; i++) {
         features[i].cluster_id = cluster_labels[i];
-        if (cluster_labels[i] == -1) {
+        if (cluster_labels[i] == DBSCAN_NOISE) {
             n_noise++;
-        } else {
-            if (cluster_labels[i] > max_cluster_id) {
-                max_cluster_id = cluster_labels[i];
-            }
         }
     }
     
-    n_clusters = max_cluster_id + 1;
-    
+    free(points);
     free(cluster_labels);
     
     printf("[CLUSTERING] 聚类完成: 共 %d 个簇, %d 个离群点\n", n_clusters, n_noise);
@@ -1292,86 +1042,141 @@ static void dbscan_clustering(address_feature_t *features, int count) {
 // ========== 步骤4：可疑判定 ==========
 static int identify_suspicious_addresses(address_feature_t *features, int count,
                                          address_stat_t *address_stats,
-                                         transaction_record_t *records, int record_count,
-                                         char suspicious_addresses[][43], char suspicious_hashes[][67],
-                                         time_t *suspicious_times, int *suspicious_count) {
+                                         suspicious_address_t **suspicious_list, int *suspicious_count) {
     printf("[CLUSTERING] 步骤4: 可疑判定\n");
     
-    // 统计每个簇的大小
-    int cluster_sizes[1000] = {0};
-    int max_cluster_id = -1;
+    *suspicious_list = NULL;
+    *suspicious_count = 0;
     
+    // 异常分数由 dbscan_anomaly_scores 按聚类标签计算（离群点 / 小簇），与 dbscan_vector_check 的夹具一致
+    int *labels = (int*)malloc((count > 0 ? count : 1) * sizeof(int));
+    double *scores = (double*)malloc((count > 0 ? count : 1) * sizeof(double));
+    suspicious_address_t *list = (suspicious_address_t*)calloc(count > 0 ? count : 1, sizeof(suspicious_address_t));
+    if (!labels || !scores || !list) {
+        printf("[CLUSTERING ERROR] 内存分配失败\n");
+        free(labels);
+        free(scores);
+        free(list);
+        return 0;
+    }
     for (int i = 0; i < count; i++) {
-        if (features[i].cluster_id >= 0 && features[i].cluster_id < 1000) {
-            cluster_sizes[features[i].cluster_id]++;
-            if (features[i].cluster_id > max_cluster_id) {
-                max_cluster_id = features[i].cluster_id;
-            }
-        }
+        labels[i] = features[i].cluster_id;
+    }
+    if (dbscan_anomaly_scores(labels, count, scores) < 0) {
+        printf("[CLUSTERING ERROR] 内存分配失败\n");
+        free(labels);
+        free(scores);
+        free(list);
+        return 0;
     }
-    
-    // 计算异常簇阈值（小于总地址数的5%）
-    int anomaly_cluster_threshold = count * 0.05;
-    if (anomaly_cluster_threshold < 1) anomaly_cluster_threshold = 1;
     
     int suspicious_idx = 0;
     
     // 判定可疑地址
     for (int i = 0; i < count; i++) {
-        int is_suspicious = 0;
-        double anomaly_score = 0.0;
+        double anomaly_score = scores[i];
+        if (anomaly_score <= 0.0) {
+            continue;
+        }
         
-        // 规则1: 离群点 → 高度可疑
-        if (features[i].cluster_id == -1) {
-            is_suspicious = 1;
-            anomaly_score = 1.0;  // 最高异常分数
+        if (features[i].cluster_id == DBSCAN_NOISE) {
             printf("[CLUSTERING] 离群点地址: %s (异常分数: %.2f)\n", 
                    features[i].address, anomaly_score);
-        }
-        // 规则2: 异常簇（小簇）→ 可疑
-        else if (features[i].cluster_id >= 0 && 
-                 cluster_sizes[features[i].cluster_id] < anomaly_cluster_threshold) {
-            is_suspicious = 1;
-            anomaly_score = 0.7;  // 较高异常分数
-            printf("[CLUSTERING] 异常簇地址: %s (簇ID: %d, 簇大小: %d, 异常分数: %.2f)\n",
-                   features[i].address, features[i].cluster_id, 
-                   cluster_sizes[features[i].cluster_id], anomaly_score);
+        } else {
+            printf("[CLUSTERING] 异常簇地址: %s (簇ID: %d, 异常分数: %.2f)\n",
+                   features[i].address, features[i].cluster_id, anomaly_score);
         }
         
-        if (is_suspicious && suspicious_idx < 1000) {
-            features[i].is_suspicious = 1;
-            features[i].anomaly_score = anomaly_score;
-            
-            // 找到该地址的最新交易
-            time_t latest_time = 0;
-            char latest_hash[67] = {0};
-            
-            for (int j = 0; j < record_count; j++) {
-                if (strcmp(records[j].from_address, features[i].address) == 0) {
-                    if (records[j].parsed_time > latest_time) {
-                        latest_time = records[j].parsed_time;
-                        strncpy(latest_hash, records[j].tx_hash, sizeof(latest_hash) - 1);
-                        latest_hash[sizeof(latest_hash) - 1] = '\0';
-                    }
-                }
-            }
-            
-            if (latest_time > 0) {
-                strncpy(suspicious_addresses[suspicious_idx], features[i].address, 42);
-                suspicious_addresses[suspicious_idx][42] = '\0';
-                strncpy(suspicious_hashes[suspicious_idx], latest_hash, 66);
-                suspicious_hashes[suspicious_idx][66] = '\0';
-                suspicious_times[suspicious_idx] = latest_time;
-                suspicious_idx++;
-            }
+        features[i].is_suspicious = 1;
+        features[i].anomaly_score = anomaly_score;
+        
+        // 该地址的最新交易（统计时已记录），features 与 address_stats 下标一一对应
+        if (address_stats[i].last_tx_time > 0) {
+            suspicious_address_t *item = &list[suspicious_idx++];
+            strncpy(item->address, features[i].address, sizeof(item->address) - 1);
+            strncpy(item->tx_hash, address_stats[i].latest_tx_hash, sizeof(item->tx_hash) - 1);
+            item->timestamp = address_stats[i].last_tx_time;
+            item->anomaly_score = anomaly_score;
+            item->cluster_id = features[i].cluster_id;
         }
     }
     
+    free(labels);
+    free(scores);
+    *suspicious_list = list;
     *suspicious_count = suspicious_idx;
     printf("[CLUSTERING] 共识别 %d 个可疑地址\n", suspicious_idx);
     return suspicious_idx;
 }
 
+// ========== 聚类分析检测函数（进程内 DBSCAN） ==========
+static int detect_high_frequency_transactions(const char *csv_file) {
+    printf("\n[DETECTION] ========== 开始聚类分析检测 ==========\n");
+    printf("[DETECTION] CSV文件: %s\n", csv_file);
+    
+    address_stat_t *address_stats = NULL;
+    int address_count = 0;
+    address_feature_t *features = NULL;
+    double feature_min[FEATURE_DIM], feature_max[FEATURE_DIM];
+    suspicious_address_t *suspicious_list = NULL;
+    int suspicious_count = 0;
+    int saved_count = 0;
+    
+    // 步骤1: 增量读取新交易，更新地址统计和时间窗口
+    if (tx_stream_update(&g_tx_stream, csv_file, time(NULL)) != 0 || g_tx_stream.count == 0) {
+        printf("[DETECTION] 没有可分析的交易记录\n");
+        goto done;
+    }
+    address_stats = g_tx_stream.stats;
+    address_count = g_tx_stream.count;
+    
+    // 步骤2-4: 特征 -> 归一化 -> DBSCAN -> 可疑判定
+    if (extract_features(address_stats, address_count, &features, feature_min, feature_max) != 0) {
+        goto done;
+    }
+    normalize_features(features, address_count, feature_min, feature_max);
+    dbscan_clustering(features, address_count);
+    identify_suspicious_addresses(features, address_count, address_stats, &suspicious_list, &suspicious_count);
+    
+    if (suspicious_count == 0) {
+        printf("[DETECTION] 未检测到可疑地址\n");
+        goto done;
+    }
+    
+    printf("[DETECTION] 聚类分析识别了 %d 个可疑地址\n", suspicious_count);
+    
+    // ========== 处理可疑交易 ==========
+    for (int i = 0; i < suspicious_count; i++) {
+        printf("\n[DETECTION] ⚠️  检测到可疑地址（聚类分析）!\n");
+        printf("[DETECTION] 地址: %s\n", suspicious_list[i].address);
+        printf("[DETECTION] 最新交易哈希: %s\n", suspicious_list[i].tx_hash);
+        printf("[DETECTION] 异常分数: %.2f\n", suspicious_list[i].anomaly_score);
+        printf("[DETECTION] 簇ID: %d\n", suspicious_list[i].cluster_id);
+        char time_str[64];
+        strftime(time_str, sizeof(time_str), "%Y-%m-%d %H:%M:%S", 
+                localtime(&suspicious_list[i].timestamp));
+        printf("[DETECTION] 最新交易时间: %s\n", time_str);
+        
+        // 直接处理可疑交易（加入延迟队列）
+        if (handle_suspicious_transaction(suspicious_list[i].tx_hash, 
+                                         suspicious_list[i].address, 
+                                         0,  // count参数不再使用
+                                         suspicious_list[i].timestamp) == 0) {
+            saved_count++;
+        }
+    }
+    
+    printf("[DETECTION] 共检测到 %d 个可疑地址，全部已处理\n", suspicious_count);
+    
+done:
+    printf("[DETECTION] ========== 聚类分析检测完成 ==========\n\n");
+    
+    free(suspicious_list);
+    free(features);
+    
+    return saved_count;
+}
+
 // ========== 主程序 ==========
 int main(int argc, char* argv[]) {
     // 初始化随机数种子（基于当前时间）
@@ -1393,8 +1198,7 @@ int main(int argc, char* argv[]) {
     printf("[DETECTION] 交易文件路径: %s\n", csv_file);
     printf("[DETECTION] 可疑交易保存路径: %s/suspicious_transactions.csv\n", detect_dir);
     printf("[DETECTION] 检测间隔: %d 秒\n", detection_interval);
-    printf("[DETECTION] 检测方法: DBSCAN聚类分析（Python scikit-learn）\n");
-    printf("[DETECTION] Python脚本: %s\n", PYTHON_DBSCAN_SCRIPT);
+    printf("[DETECTION] 检测方法: DBSCAN聚类分析（进程内 k-d 树）\n");
     printf("[DETECTION] DBSCAN参数: eps=%.2f, min_samples=%d\n", DBSCAN_EPS, DBSCAN_MIN_SAMPLES);
     printf("[DETECTION] 特征维度: 8 维\n");
     printf("[DETECTION] 延迟时间: %d 秒\n", DELAY_SECONDS);
@@ -1424,13 +1228,10 @@ int main(int argc, char* argv[]) {
             printf("[DETECTION] 处理队列... (时间: %s, 周期: %d)\n", time_str, cycle_count);
         }
         
-        // 2. 处理延迟队列中已到时的项目（每次都处理）
+        // 2. 处理延迟队列中已到时的项目（只取出到期项，处理完即出队）
         process_ready_items();
         
-        // 3. 清理已完成的队列项
-        cleanup_expired_items();
-        
-        // 4. 显示队列状态
+        // 3. 显示队列状态
         if (g_delay_queue.count > 0) {
             print_queue_status();
         }
@@ -0,0 +1,709 @@
+/**
+ * BN254 群运算与最优 ate 配对实现
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <gmp.h>
+#include "/home/zxx/Config/relic/include/relic.h"
+#include "bn254.h"
+
+typedef bn254_fp_t fq_t;
+typedef bn254_fp2_t fq2_t;
+
+typedef struct {
+  fq2_t c0, c1, c2;
+} fq6_t;
+
+typedef struct {
+  fq6_t c0, c1;
+} fq12_t;
+
+typedef unsigned __int128 u128;
+
+// p、-p^-1 mod 2^64、R^2 mod p（R = 2^256），小端 64 位字
+static const fq_t FQ_P = {{ 0x3c208c16d87cfd47ULL, 0x97816a916871ca8dULL, 0xb85045b68181585dULL, 0x30644e72e131a029ULL }};
+static const uint64_t FQ_PINV = 0x87d20782e4866389ULL;
+static const fq_t FQ_R2 = {{ 0xf32cfc5b538afa89ULL, 0xb5e71911d44501fbULL, 0x47ab1eff0a417ff6ULL, 0x06d89f71cab8351fULL }};
+static const fq_t FQ_ONE = {{ 0xd35d438dc58f0d9dULL, 0x0a78eb28f5c70b3dULL, 0x666ea36f7879462cULL, 0x0e0a77c19a07df2fULL }};
+// 曲线参数 x = 4965661367192848881，最优 ate 的循环次数 6x+2
+static const uint64_t ATE_LOOP = 0x9d797039be763ba8ULL;   // 6x+2 的低 64 位，最高位（第 64 位）为 1
+
+static const char *const BN254_P_DEC = "21888242871839275222246405745257275088696311157297823662689037894645226208583";
+static const char *const BN254_R_DEC = "21888242871839275222246405745257275088548364400416034343698204186575808495617";
+
+static pthread_once_t bn254_once = PTHREAD_ONCE_INIT;
+static struct {
+  mpz_t p, r;
+  mpz_t p2;               // p^2，用于 Fp12 的二次 Frobenius
+  mpz_t hard;             // 最终幂的困难部分 (p^4 - p^2 + 1) / r
+  fq_t r3;                // R^3 mod p，用于从普通表示的逆转回 Montgomery 表示
+  fq2_t twist_b;          // 3 / (9+u)
+  fq2_t frob_x, frob_y;   // (9+u)^((p-1)/3)，(9+u)^((p-1)/2)
+} bn254;
+
+/* ---------------- Fp ---------------- */
+
+static int fq_geq_p(const fq_t *a) {
+  for (int i = 3; i >= 0; i--) {
+    if (a->v[i] != FQ_P.v[i]) return a->v[i] > FQ_P.v[i];
+  }
+  return 1;
+}
+
+static void fq_sub_p(fq_t *a) {
+  uint64_t borrow = 0;
+  for (int i = 0; i < 4; i++) {
+    u128 d = (u128) a->v[i] - FQ_P.v[i] - borrow;
+    a->v[i] = (uint64_t) d;
+    borrow = (uint64_t) (d >> 64) & 1;
+  }
+}
+
+static void fq_add(fq_t *c, const fq_t *a, const fq_t *b) {
+  u128 carry = 0;
+  for (int i = 0; i < 4; i++) {
+    carry += (u128) a->v[i] + b->v[i];
+    c->v[i] = (uint64_t) carry;
+    carry >>= 64;
+  }
+  // p < 2^254，和不会溢出 256 位
+  if (fq_geq_p(c)) fq_sub_p(c);
+}
+
+static void fq_sub(fq_t *c, const fq_t *a, const fq_t *b) {
+  uint64_t borrow = 0;
+  for (int i = 0; i < 4; i++) {
+    u128 d = (u128) a->v[i] - b->v[i] - borrow;
+    c->v[i] = (uint64_t) d;
+    borrow = (uint64_t) (d >> 64) & 1;
+  }
+  if (borrow) {
+    u128 carry = 0;
+    for (int i = 0; i < 4; i++) {
+      carry += (u128) c->v[i] + FQ_P.v[i];
+      c->v[i] = (uint64_t) carry;
+      carry >>= 64;
+    }
+  }
+}
+
+static int fq_is_zero(const fq_t *a) {
+  return (a->v[0] | a->v[1] | a->v[2] | a->v[3]) == 0;
+}
+
+static int fq_eq(const fq_t *a, const fq_t *b) {
+  return memcmp(a->v, b->v, sizeof(a->v)) == 0;
+}
+
+static void fq_neg(fq_t *c, const fq_t *a) {
+  if (fq_is_zero(a)) {
+    *c = *a;
+  } else {
+    fq_t zero = {{0}};
+    fq_sub(c, &zero, a);
+  }
+}
+
+// Montgomery 乘法（CIOS）：c = a * b / R mod p
+static void fq_mul(fq_t *c, const fq_t *a, const fq_t *b) {
+  uint64_t t[6] = {0};
+  for (int i = 0; i < 4; i++) {
+    u128 acc = 0;
+    for (int j = 0; j < 4; j++) {
+      acc = (u128) a->v[j] * b->v[i] + t[j] + (uint64_t) (acc >> 64);
+      t[j] = (uint64_t) acc;
+    }
+    acc = (u128) t[4] + (uint64_t) (acc >> 64);
+    t[4] = (uint64_t) acc;
+    t[5] = (uint64_t) (acc >> 64);
+
+    uint64_t m = t[0] * FQ_PINV;
+    acc = (u128) m * FQ_P.v[0] + t[0];
+    for (int j = 1; j < 4; j++) {
+      acc = (u128) m * FQ_P.v[j] + t[j] + (uint64_t) (acc >> 64);
+      t[j - 1] = (uint64_t) acc;
+    }
+    acc = (u128) t[4] + (uint64_t) (acc >> 64);
+    t[3] = (uint64_t) acc;
+    t[4] = t[5] + (uint64_t) (acc >> 64);
+  }
+  memcpy(c->v, t, sizeof(c->v));
+  if (t[4] != 0 || fq_geq_p(c)) fq_sub_p(c);
+}
+
+static void fq_sqr(fq_t *c, const fq_t *a) {
+  fq_mul(c, a, a);
+}
+
+// 用 GMP 的扩展欧几里得求逆：(aR)^-1 再乘 R^3/R 得到 a^-1 R；0 的逆定义为 0
+static void fq_inv(fq_t *c, const fq_t *a) {
+  mpz_t z;
+  fq_t raw = {{0}};
+  size_t count = 0;
+  mpz_init(z);
+  mpz_import(z, 4, -1, sizeof(uint64_t), 0, 0, a->v);
+  if (mpz_invert(z, z, bn254.p)) mpz_export(raw.v, &count, -1, sizeof(uint64_t), 0, 0, z);
+  mpz_clear(z);
+  fq_mul(c, &raw, &bn254.r3);
+}
+
+static void fq_from_small(fq_t *c, uint64_t v) {
+  fq_t raw = {{ v, 0, 0, 0 }};
+  fq_mul(c, &raw, &FQ_R2);
+}
+
+// 十进制转 Montgomery 表示，要求数值小于 p
+static int fq_from_dec(fq_t *c, const char *dec) {
+  mpz_t z;
+  int result_status = RLC_ERR;
+  if (dec == NULL) return RLC_ERR;
+  mpz_init(z);
+  if (mpz_set_str(z, dec, 10) == 0 && mpz_sgn(z) >= 0 && mpz_cmp(z, bn254.p) < 0) {
+    fq_t raw = {{0}};
+    size_t count = 0;
+    mpz_export(raw.v, &count, -1, sizeof(uint64_t), 0, 0, z);
+    fq_mul(c, &raw, &FQ_R2);
+    result_status = RLC_OK;
+  }
+  mpz_clear(z);
+  return result_status;
+}
+
+/* ---------------- Fp2 ---------------- */
+
+static void fq2_add(fq2_t *c, const fq2_t *a, const fq2_t *b) {
+  fq_add(&c->c0, &a->c0, &b->c0);
+  fq_add(&c->c1, &a->c1, &b->c1);
+}
+
+static void fq2_sub(fq2_t *c, const fq2_t *a, const fq2_t *b) {
+  fq_sub(&c->c0, &a->c0, &b->c0);
+  fq_sub(&c->c1, &a->c1, &b->c1);
+}
+
+static void fq2_neg(fq2_t *c, const fq2_t *a) {
+  fq_neg(&c->c0, &a->c0);
+  fq_neg(&c->c1, &a->c1);
+}
+
+static void fq2_conj(fq2_t *c, const fq2_t *a) {
+  c->c0 = a->c0;
+  fq_neg(&c->c1, &a->c1);
+}
+
+static void fq2_mul(fq2_t *c, const fq2_t *a, const fq2_t *b) {
+  fq_t t0, t1, t2, t3;
+  fq_mul(&t0, &a->c0, &b->c0);
+  fq_mul(&t1, &a->c1, &b->c1);
+  fq_mul(&t2, &a->c0, &b->c1);
+  fq_mul(&t3, &a->c1, &b->c0);
+  fq_sub(&c->c0, &t0, &t1);
+  fq_add(&c->c1, &t2, &t3);
+}
+
+static void fq2_sqr(fq2_t *c, const fq2_t *a) {
+  fq2_mul(c, a, a);
+}
+
+static void fq2_mul_fp(fq2_t *c, const fq2_t *a, const fq_t *b) {
+  fq_mul(&c->c0, &a->c0, b);
+  fq_mul(&c->c1, &a->c1, b);
+}
+
+// 乘以 ξ = 9 + u：(a + bu)(9 + u) = (9a - b) + (a + 9b)u
+static void fq2_mul_xi(fq2_t *c, const fq2_t *a) {
+  fq_t a2, a4, a8, a9, b2, b4, b8, b9, r0, r1;
+  fq_add(&a2, &a->c0, &a->c0);
+  fq_add(&a4, &a2, &a2);
+  fq_add(&a8, &a4, &a4);
+  fq_add(&a9, &a8, &a->c0);
+  fq_add(&b2, &a->c1, &a->c1);
+  fq_add(&b4, &b2, &b2);
+  fq_add(&b8, &b4, &b4);
+  fq_add(&b9, &b8, &a->c1);
+  fq_sub(&r0, &a9, &a->c1);
+  fq_add(&r1, &a->c0, &b9);
+  c->c0 = r0;
+  c->c1 = r1;
+}
+
+static int fq2_is_zero(const fq2_t *a) {
+  return fq_is_zero(&a->c0) && fq_is_zero(&a->c1);
+}
+
+static int fq2_eq(const fq2_t *a, const fq2_t *b) {
+  return fq_eq(&a->c0, &b->c0) && fq_eq(&a->c1, &b->c1);
+}
+
+static void fq2_inv(fq2_t *c, const fq2_t *a) {
+  fq_t t0, t1, norm;
+  fq_sqr(&t0, &a->c0);
+  fq_sqr(&t1, &a->c1);
+  fq_add(&norm, &t0, &t1);
+  fq_inv(&norm, &norm);
+  fq_mul(&c->c0, &a->c0, &norm);
+  fq_mul(&t1, &a->c1, &norm);
+  fq_neg(&c->c1, &t1);
+}
+
+static void fq2_pow(fq2_t *c, const fq2_t *a, const mpz_t e) {
+  fq2_t base = *a, acc;
+  acc.c0 = FQ_ONE;
+  memset(&acc.c1, 0, sizeof(acc.c1));
+  for (long i = (long) mpz_sizeinbase(e, 2) - 1; i >= 0; i--) {
+    fq2_sqr(&acc, &acc);
+    if (mpz_tstbit(e, (mp_bitcnt_t) i)) fq2_mul(&acc, &acc, &base);
+  }
+  *c = acc;
+}
+
+/* ---------------- Fp6 / Fp12 ---------------- */
+
+static void fq6_add(fq6_t *c, const fq6_t *a, const fq6_t *b) {
+  fq2_add(&c->c0, &a->c0, &b->c0);
+  fq2_add(&c->c1, &a->c1, &b->c1);
+  fq2_add(&c->c2, &a->c2, &b->c2);
+}
+
+static void fq6_sub(fq6_t *c, const fq6_t *a, const fq6_t *b) {
+  fq2_sub(&c->c0, &a->c0, &b->c0);
+  fq2_sub(&c->c1, &a->c1, &b->c1);
+  fq2_sub(&c->c2, &a->c2, &b->c2);
+}
+
+static void fq6_neg(fq6_t *c, const fq6_t *a) {
+  fq2_neg(&c->c0, &a->c0);
+  fq2_neg(&c->c1, &a->c1);
+  fq2_neg(&c->c2, &a->c2);
+}
+
+static void fq6_mul(fq6_t *c, const fq6_t *a, const fq6_t *b) {
+  fq2_t a0b0, a0b1, a0b2, a1b0, a1b1, a1b2, a2b0, a2b1, a2b2, t;
+  fq6_t r;
+  fq2_mul(&a0b0, &a->c0, &b->c0);
+  fq2_mul(&a0b1, &a->c0, &b->c1);
+  fq2_mul(&a0b2, &a->c0, &b->c2);
+  fq2_mul(&a1b0, &a->c1, &b->c0);
+  fq2_mul(&a1b1, &a->c1, &b->c1);
+  fq2_mul(&a1b2, &a->c1, &b->c2);
+  fq2_mul(&a2b0, &a->c2, &b->c0);
+  fq2_mul(&a2b1, &a->c2, &b->c1);
+  fq2_mul(&a2b2, &a->c2, &b->c2);
+  // c0 = a0b0 + ξ(a1b2 + a2b1)，c1 = a0b1 + a1b0 + ξ a2b2，c2 = a0b2 + a1b1 + a2b0
+  fq2_add(&t, &a1b2, &a2b1);
+  fq2_mul_xi(&t, &t);
+  fq2_add(&r.c0, &a0b0, &t);
+  fq2_mul_xi(&t, &a2b2);
+  fq2_add(&r.c1, &a0b1, &a1b0);
+  fq2_add(&r.c1, &r.c1, &t);
+  fq2_add(&r.c2, &a0b2, &a1b1);
+  fq2_add(&r.c2, &r.c2, &a2b0);
+  *c = r;
+}
+
+// 乘以 v：(c0 + c1 v + c2 v^2) v = ξ c2 + c0 v + c1 v^2
+static void fq6_mul_v(fq6_t *c, const fq6_t *a) {
+  fq6_t r;
+  fq2_mul_xi(&r.c0, &a->c2);
+  r.c1 = a->c0;
+  r.c2 = a->c1;
+  *c = r;
+}
+
+static void fq6_inv(fq6_t *c, const fq6_t *a) {
+  fq2_t t0, t1, t2, tmp, norm;
+  fq6_t r;
+  // t0 = a0^2 - ξ a1 a2，t1 = ξ a2^2 - a0 a1，t2 = a1^2 - a0 a2
+  fq2_sqr(&t0, &a->c0);
+  fq2_mul(&tmp, &a->c1, &a->c2);
+  fq2_mul_xi(&tmp, &tmp);
+  fq2_sub(&t0, &t0, &tmp);
+  fq2_sqr(&t1, &a->c2);
+  fq2_mul_xi(&t1, &t1);
+  fq2_mul(&tmp, &a->c0, &a->c1);
+  fq2_sub(&t1, &t1, &tmp);
+  fq2_sqr(&t2, &a->c1);
+  fq2_mul(&tmp, &a->c0, &a->c2);
+  fq2_sub(&t2, &t2, &tmp);
+  // norm = a0 t0 + ξ(a2 t1 + a1 t2)
+  fq2_mul(&norm, &a->c2, &t1);
+  fq2_mul(&tmp, &a->c1, &t2);
+  fq2_add(&norm, &norm, &tmp);
+  fq2_mul_xi(&norm, &norm);
+  fq2_mul(&tmp, &a->c0, &t0);
+  fq2_add(&norm, &norm, &tmp);
+  fq2_inv(&norm, &norm);
+  fq2_mul(&r.c0, &t0, &norm);
+  fq2_mul(&r.c1, &t1, &norm);
+  fq2_mul(&r.c2, &t2, &norm);
+  *c = r;
+}
+
+static void fq12_one(fq12_t *a) {
+  memset(a, 0, sizeof(*a));
+  a->c0.c0.c0 = FQ_ONE;
+}
+
+static int fq12_is_one(const fq12_t *a) {
+  fq12_t one;
+  fq12_one(&one);
+  return memcmp(a, &one, sizeof(one)) == 0;
+}
+
+// (a0 + a1 w)(b0 + b1 w) = (a0 b0 + a1 b1 v) + (a0 b1 + a1 b0) w
+static void fq12_mul(fq12_t *c, const fq12_t *a, const fq12_t *b) {
+  fq6_t t0, t1, t2, t3;
+  fq6_mul(&t0, &a->c0, &b->c0);
+  fq6_mul(&t1, &a->c1, &b->c1);
+  fq6_mul(&t2, &a->c0, &b->c1);
+  fq6_mul(&t3, &a->c1, &b->c0);
+  fq6_mul_v(&t1, &t1);
+  fq6_add(&c->c0, &t0, &t1);
+  fq6_add(&c->c1, &t2, &t3);
+}
+
+static void fq12_sqr(fq12_t *c, const fq12_t *a) {
+  fq12_mul(c, a, a);
+}
+
+// a^(p^6)：w^(p^6) = -w
+static void fq12_conj(fq12_t *c, const fq12_t *a) {
+  c->c0 = a->c0;
+  fq6_neg(&c->c1, &a->c1);
+}
+
+// (a0 + a1 w)^-1 = (a0 - a1 w) / (a0^2 - a1^2 v)
+static void fq12_inv(fq12_t *c, const fq12_t *a) {
+  fq6_t t0, t1;
+  fq6_mul(&t0, &a->c0, &a->c0);
+  fq6_mul(&t1, &a->c1, &a->c1);
+  fq6_mul_v(&t1, &t1);
+  fq6_sub(&t0, &t0, &t1);
+  fq6_inv(&t0, &t0);
+  fq6_mul(&c->c0, &a->c0, &t0);
+  fq6_mul(&t1, &a->c1, &t0);
+  fq6_neg(&c->c1, &t1);
+}
+
+static void fq12_pow(fq12_t *c, const fq12_t *a, const mpz_t e) {
+  fq12_t base = *a, acc;
+  fq12_one(&acc);
+  for (long i = (long) mpz_sizeinbase(e, 2) - 1; i >= 0; i--) {
+    fq12_sqr(&acc, &acc);
+    if (mpz_tstbit(e, (mp_bitcnt_t) i)) fq12_mul(&acc, &acc, &base);
+  }
+  *c = acc;
+}
+
+/* ---------------- 初始化 ---------------- */
+
+static void bn254_init(void) {
+  mpz_t e, t;
+  fq2_t xi, three;
+
+  mpz_inits(bn254.p, bn254.r, bn254.p2, bn254.hard, NULL);
+  mpz_set_str(bn254.p, BN254_P_DEC, 10);
+  mpz_set_str(bn254.r, BN254_R_DEC, 10);
+  fq_mul(&bn254.r3, &FQ_R2, &FQ_R2);
+  mpz_mul(bn254.p2, bn254.p, bn254.p);
+  // (p^4 - p^2 + 1) / r
+  mpz_mul(bn254.hard, bn254.p2, bn254.p2);
+  mpz_sub(bn254.hard, bn254.hard, bn254.p2);
+  mpz_add_ui(bn254.hard, bn254.hard, 1);
+  mpz_divexact(bn254.hard, bn254.hard, bn254.r);
+
+  fq_from_small(&xi.c0, 9);
+  fq_from_small(&xi.c1, 1);
+  fq_from_small(&three.c0, 3);
+  memset(&three.c1, 0, sizeof(three.c1));
+  fq2_inv(&bn254.twist_b, &xi);
+  fq2_mul(&bn254.twist_b, &bn254.twist_b, &three);
+
+  mpz_inits(e, t, NULL);
+  mpz_sub_ui(t, bn254.p, 1);
+  mpz_divexact_ui(e, t, 3);
+  fq2_pow(&bn254.frob_x, &xi, e);
+  mpz_divexact_ui(e, t, 2);
+  fq2_pow(&bn254.frob_y, &xi, e);
+  mpz_clears(e, t, NULL);
+}
+
+static void bn254_ensure_init(void) {
+  pthread_once(&bn254_once, bn254_init);
+}
+
+/* ---------------- G1 ---------------- */
+
+static int e1_on_curve(const bn254_g1_t *p) {
+  fq_t lhs, rhs, three;
+  if (p->inf) return 1;
+  fq_sqr(&lhs, &p->y);
+  fq_sqr(&rhs, &p->x);
+  fq_mul(&rhs, &rhs, &p->x);
+  fq_from_small(&three, 3);
+  fq_add(&rhs, &rhs, &three);
+  return fq_eq(&lhs, &rhs);
+}
+
+static void e1_double(bn254_g1_t *r, const bn254_g1_t *a) {
+  fq_t lambda, t, x3, y3;
+  if (a->inf || fq_is_zero(&a->y)) {
+    r->inf = 1;
+    return;
+  }
+  // λ = 3x^2 / 2y
+  fq_sqr(&t, &a->x);
+  fq_add(&lambda, &t, &t);
+  fq_add(&lambda, &lambda, &t);
+  fq_add(&t, &a->y, &a->y);
+  fq_inv(&t, &t);
+  fq_mul(&lambda, &lambda, &t);
+  fq_sqr(&x3, &lambda);
+  fq_sub(&x3, &x3, &a->x);
+  fq_sub(&x3, &x3, &a->x);
+  fq_sub(&t, &a->x, &x3);
+  fq_mul(&y3, &lambda, &t);
+  fq_sub(&y3, &y3, &a->y);
+  r->x = x3;
+  r->y = y3;
+  r->inf = 0;
+}
+
+void bn254_g1_add(bn254_g1_t *r, const bn254_g1_t *a, const bn254_g1_t *b) {
+  fq_t lambda, t, x3, y3;
+  bn254_ensure_init();
+  if (a->inf) {
+    *r = *b;
+    return;
+  }
+  if (b->inf) {
+    *r = *a;
+    return;
+  }
+  if (fq_eq(&a->x, &b->x)) {
+    if (fq_eq(&a->y, &b->y)) {
+      e1_double(r, a);
+    } else {
+      r->inf = 1;
+    }
+    return;
+  }
+  fq_sub(&lambda, &b->y, &a->y);
+  fq_sub(&t, &b->x, &a->x);
+  fq_inv(&t, &t);
+  fq_mul(&lambda, &lambda, &t);
+  fq_sqr(&x3, &lambda);
+  fq_sub(&x3, &x3, &a->x);
+  fq_sub(&x3, &x3, &b->x);
+  fq_sub(&t, &a->x, &x3);
+  fq_mul(&y3, &lambda, &t);
+  fq_sub(&y3, &y3, &a->y);
+  r->x = x3;
+  r->y = y3;
+  r->inf = 0;
+}
+
+void bn254_g1_neg(bn254_g1_t *r, const bn254_g1_t *a) {
+  r->x = a->x;
+  fq_neg(&r->y, &a->y);
+  r->inf = a->inf;
+}
+
+void bn254_g1_mul(bn254_g1_t *r, const bn254_g1_t *a, const uint8_t k[BN254_BYTES]) {
+  bn254_g1_t acc = { .inf = 1 };
+  bn254_ensure_init();
+  for (int i = 0; i < 8 * BN254_BYTES; i++) {
+    e1_double(&acc, &acc);
+    if ((k[i / 8] >> (7 - i % 8)) & 1) bn254_g1_add(&acc, &acc, a);
+  }
+  *r = acc;
+}
+
+int bn254_g1_from_dec(bn254_g1_t *p, const char *x, const char *y) {
+  bn254_ensure_init();
+  if (fq_from_dec(&p->x, x) != RLC_OK || fq_from_dec(&p->y, y) != RLC_OK) return RLC_ERR;
+  p->inf = fq_is_zero(&p->x) && fq_is_zero(&p->y);
+  return e1_on_curve(p) ? RLC_OK : RLC_ERR;
+}
+
+int bn254_scalar_from_dec(uint8_t out[BN254_BYTES], const char *dec, int below_r) {
+  mpz_t z;
+  int result_status = RLC_ERR;
+  if (dec == NULL) return RLC_ERR;
+  bn254_ensure_init();
+  mpz_init(z);
+  int is_hex = (dec[0] == '0' && (dec[1] == 'x' || dec[1] == 'X'));
+  if (mpz_set_str(z, is_hex ? dec + 2 : dec, is_hex ? 16 : 10) == 0 && mpz_sgn(z) >= 0
+   && mpz_sizeinbase(z, 2) <= 8 * BN254_BYTES
+   && (!below_r || mpz_cmp(z, bn254.r) < 0)) {
+    uint8_t buf[BN254_BYTES];
+    size_t count = 0;
+    mpz_export(buf, &count, 1, 1, 1, 0, z);
+    memset(out, 0, BN254_BYTES);
+    memcpy(out + BN254_BYTES - count, buf, count);
+    result_status = RLC_OK;
+  }
+  mpz_clear(z);
+  return result_status;
+}
+
+/* ---------------- G2 ---------------- */
+
+static int e2_on_curve(const bn254_g2_t *q) {
+  fq2_t lhs, rhs;
+  if (q->inf) return 1;
+  fq2_sqr(&lhs, &q->y);
+  fq2_sqr(&rhs, &q->x);
+  fq2_mul(&rhs, &rhs, &q->x);
+  fq2_add(&rhs, &rhs, &bn254.twist_b);
+  return fq2_eq(&lhs, &rhs);
+}
+
+// T = T + Q 或 T = 2T（Q == NULL）；返回斜率，T 或结果为无穷远点时返回 0
+static int e2_step(bn254_g2_t *t, const bn254_g2_t *q, fq2_t *lambda) {
+  fq2_t num, den, x3, y3;
+  if (t->inf) {
+    if (q != NULL) *t = *q;
+    return 0;
+  }
+  if (q != NULL && q->inf) return 0;
+  if (q == NULL || fq2_eq(&t->x, &q->x)) {
+    if (q != NULL && !fq2_eq(&t->y, &q->y)) {
+      t->inf = 1;
+      return 0;
+    }
+    if (fq2_is_zero(&t->y)) {
+      t->inf = 1;
+      return 0;
+    }
+    // 切线：λ = 3x^2 / 2y
+    fq2_sqr(&den, &t->x);
+    fq2_add(&num, &den, &den);
+    fq2_add(&num, &num, &den);
+    fq2_add(&den, &t->y, &t->y);
+    q = t;
+  } else {
+    fq2_sub(&num, &q->y, &t->y);
+    fq2_sub(&den, &q->x, &t->x);
+  }
+  fq2_inv(&den, &den);
+  fq2_mul(lambda, &num, &den);
+  fq2_sqr(&x3, lambda);
+  fq2_sub(&x3, &x3, &t->x);
+  fq2_sub(&x3, &x3, &q->x);
+  fq2_sub(&den, &t->x, &x3);
+  fq2_mul(&y3, lambda, &den);
+  fq2_sub(&y3, &y3, &t->y);
+  t->x = x3;
+  t->y = y3;
+  return 1;
+}
+
+static void e2_mul_r(bn254_g2_t *r, const bn254_g2_t *a) {
+  bn254_g2_t acc = { .inf = 1 };
+  fq2_t lambda;
+  for (long i = (long) mpz_sizeinbase(bn254.r, 2) - 1; i >= 0; i--) {
+    e2_step(&acc, NULL, &lambda);
+    if (mpz_tstbit(bn254.r, (mp_bitcnt_t) i)) e2_step(&acc, a, &lambda);
+  }
+  *r = acc;
+}
+
+int bn254_g2_from_dec(bn254_g2_t *q, const char *x0, const char *x1, const char *y0, const char *y1) {
+  bn254_ensure_init();
+  if (fq_from_dec(&q->x.c0, x0) != RLC_OK || fq_from_dec(&q->x.c1, x1) != RLC_OK
+   || fq_from_dec(&q->y.c0, y0) != RLC_OK || fq_from_dec(&q->y.c1, y1) != RLC_OK) {
+    return RLC_ERR;
+  }
+  q->inf = fq2_is_zero(&q->x) && fq2_is_zero(&q->y);
+  if (!e2_on_curve(q)) return RLC_ERR;
+  if (!q->inf) {
+    bn254_g2_t check;
+    e2_mul_r(&check, q);
+    if (!check.inf) return RLC_ERR;
+  }
+  return RLC_OK;
+}
+
+// 扭曲线上的 Frobenius：(conj(x) ξ^((p-1)/3), conj(y) ξ^((p-1)/2))
+static void e2_frobenius(bn254_g2_t *r, const bn254_g2_t *a) {
+  fq2_t x, y;
+  fq2_conj(&x, &a->x);
+  fq2_conj(&y, &a->y);
+  fq2_mul(&r->x, &x, &bn254.frob_x);
+  fq2_mul(&r->y, &y, &bn254.frob_y);
+  r->inf = a->inf;
+}
+
+/* ---------------- 配对 ---------------- */
+
+// 过 T（斜率 λ）的直线在 P 处的取值：yP - λ xP w + (λ xT - yT) v w
+static void line_eval(fq12_t *l, const fq2_t *lambda, const bn254_g2_t *t, const bn254_g1_t *p) {
+  fq2_t tmp;
+  memset(l, 0, sizeof(*l));
+  l->c0.c0.c0 = p->y;
+  fq2_mul_fp(&tmp, lambda, &p->x);
+  fq2_neg(&l->c1.c0, &tmp);
+  fq2_mul(&tmp, lambda, &t->x);
+  fq2_sub(&l->c1.c1, &tmp, &t->y);
+}
+
+// T 沿 Q（NULL 为倍点）走一步，并把直线值乘入 f
+static void miller_step(fq12_t *f, bn254_g2_t *t, const bn254_g2_t *q, const bn254_g1_t *p) {
+  fq2_t lambda;
+  bn254_g2_t before = *t;
+  fq12_t l;
+  if (e2_step(t, q, &lambda)) {
+    line_eval(&l, &lambda, &before, p);
+    fq12_mul(f, f, &l);
+  }
+}
+
+static void final_exponentiation(fq12_t *r, const fq12_t *f) {
+  fq12_t t0, t1;
+  // 简单部分：f^((p^6 - 1)(p^2 + 1))
+  fq12_conj(&t0, f);
+  fq12_inv(&t1, f);
+  fq12_mul(&t0, &t0, &t1);
+  fq12_pow(&t1, &t0, bn254.p2);
+  fq12_mul(&t0, &t1, &t0);
+  // 困难部分：(p^4 - p^2 + 1) / r
+  fq12_pow(r, &t0, bn254.hard);
+}
+
+int bn254_pairing_check(const bn254_g1_t *p, const bn254_g2_t *q, size_t n) {
+  bn254_ensure_init();
+  if (n == 0) return 1;
+
+  bn254_g2_t *t = malloc(n * sizeof(bn254_g2_t));
+  if (t == NULL) return 0;
+  for (size_t k = 0; k < n; k++) t[k] = q[k];
+
+  fq12_t f;
+  fq12_one(&f);
+  // 6x+2 共 65 位，最高位为第 64 位
+  for (int i = 63; i >= 0; i--) {
+    fq12_sqr(&f, &f);
+    for (size_t k = 0; k < n; k++) {
+      if (p[k].inf || q[k].inf) continue;
+      miller_step(&f, &t[k], NULL, &p[k]);
+      if ((ATE_LOOP >> i) & 1) miller_step(&f, &t[k], &q[k], &p[k]);
+    }
+  }
+  for (size_t k = 0; k < n; k++) {
+    if (p[k].inf || q[k].inf) continue;
+    bn254_g2_t q1, q2;
+    e2_frobenius(&q1, &q[k]);
+    e2_frobenius(&q2, &q1);
+    fq2_neg(&q2.y, &q2.y);
+    miller_step(&f, &t[k], &q1, &p[k]);
+    miller_step(&f, &t[k], &q2, &p[k]);
+  }
+  free(t);
+
+  fq12_t r;
+  final_exponentiation(&r, &f);
+  return fq12_is_one(&r);
+}
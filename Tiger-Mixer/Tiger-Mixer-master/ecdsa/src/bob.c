@@ -10,6 +10,9 @@
 #include "bob.h"
 #include "util.h"
 #include "composite_malleable_proof.h"
+#include "mix_session.h"
+#include "escrow_client.h"
+#include "share_dispatch.h"
 
 // IO控制宏 - 根据环境变量A2L_DISABLE_IO控制输出
 #define CONDITIONAL_PRINTF(...) do { \
@@ -307,169 +310,26 @@ static int release_escrow_for_bob(bob_state_t state, const char *escrow_id) {
   printf("[ESCROW DEBUG] Bob signature r (first 20 chars): %.20s\n", bob_r_hex);
   printf("[ESCROW DEBUG] Bob signature s (first 20 chars): %.20s\n", bob_s_hex);
   
-  bn_free(bob_r);
-  bn_free(bob_s);
-  
-  // 构建命令调用 confirm 函数，传递签名参数
-  char *cmd = malloc(8192);
-  if (!cmd) return -1;
-  
-  // 使用 --pool 参数，让脚本从地址簿解析固定面额池合约地址
-  // 传递两个签名：Tumbler 的签名 (r1, s1, v1) 和 Bob 的签名 (r2, s2, v2)
-  // 注意：v 值需要在 JS 脚本中计算，这里先传 0 或占位值
-  printf("[ESCROW DEBUG] Building command with:\n");
-  printf("  pool_label: %s\n", state->pool_label);
-  printf("  escrow_id: %s\n", escrow_id_to_use);
-  printf("  tumbler_r_hex length: %zu\n", strlen(tumbler_r_hex));
-  printf("  tumbler_s_hex length: %zu\n", strlen(tumbler_s_hex));
-  printf("  bob_r_hex length: %zu\n", strlen(bob_r_hex));
-  printf("  bob_s_hex length: %zu\n", strlen(bob_s_hex));
-  
-  int cmd_len = snprintf(cmd, 8192,
-           "cd /home/zxx/Config/truffleProject/truffletest && npx truffle exec scripts/confirmEscrow.js --network private "
-           "--pool %s --id %s --from %s "
-           "--r1 0x%s --s1 0x%s --v1 0 "
-           "--r2 0x%s --s2 0x%s --v2 0 2>&1 | cat",
-           state->pool_label, escrow_id_to_use, bob_from,
-           tumbler_r_hex, tumbler_s_hex,
-           bob_r_hex, bob_s_hex);
-  
-  printf("[ESCROW DEBUG] Command length: %d (max 8192)\n", cmd_len);
-  CONDITIONAL_PRINTF("[ESCROW] Bob confirm escrow cmd: %s\n", cmd);
-  
-  // 测量区块链交互时间
+  // 直接经 JSON-RPC 调用 confirm；v 值由客户端根据链上记录的双方公钥在本地恢复
+  printf("[ESCROW] confirm: pool=%s id=%s from=%s\n", state->pool_label, escrow_id_to_use, bob_from);
   START_TIMER(bob_blockchain_escrow_interaction)
-  // 执行命令并捕获输出
-  FILE *fp = popen(cmd, "r");
-  if (!fp) {
-    fprintf(stderr, "[ESCROW] Failed to execute command\n");
-    free(cmd);
-    return -1;
-  }
-  
-  char buffer[1024];
-  char tx_hash[67] = {0};
-  int tx_found = 0;
-  
-  // 读取命令输出，寻找交易哈希
-  while (fgets(buffer, sizeof(buffer), fp) != NULL) {
-    const char *disable_io = getenv("A2L_DISABLE_IO");
-    if (!disable_io || strcmp(disable_io, "1") != 0) {
-      printf("[ESCROW] Output: %s", buffer);
-    }
-    
-    // 查找包含交易哈希的行（多策略）
-    if (strstr(buffer, "Transaction hash:") != NULL || strstr(buffer, "txHash:") != NULL) {
-      // 提取交易哈希
-      char *hash_start = strstr(buffer, "0x");
-      if (hash_start) {
-        strncpy(tx_hash, hash_start, 66);
-        tx_hash[66] = '\0';
-        printf("[ESCROW] Captured transaction hash: %s\n", tx_hash);
-        tx_found = 1;
-        break;
-      }
-    }
-    
-    // 查找JSON格式的交易哈希 {"txHash":"0x..."}
-    if (strstr(buffer, "\"txHash\"") != NULL) {
-      printf("[ESCROW] Found JSON txHash line, attempting to extract...\n");
-      char *hash_start = strstr(buffer, "\"0x");
-      if (hash_start) {
-        printf("[ESCROW] Found 0x pattern at position %ld\n", hash_start - buffer);
-        // 跳过开头的引号
-        hash_start += 1;
-        
-        // 找到哈希的结束位置（下一个引号）
-        char *hash_end = strchr(hash_start, '"');
-        if (hash_end) {
-          int hash_len = hash_end - hash_start;
-          printf("[ESCROW] Hash length: %d\n", hash_len);
-          if (hash_len <= 66) {
-            strncpy(tx_hash, hash_start, hash_len);
-            tx_hash[hash_len] = '\0';
-            printf("[ESCROW] Captured JSON transaction hash: %s\n", tx_hash);
-            tx_found = 1;
-            break;
-          } else {
-            printf("[ESCROW] Hash too long: %d > 66\n", hash_len);
-          }
-        } else {
-          printf("[ESCROW] Could not find closing quote\n");
-        }
-      } else {
-        printf("[ESCROW] Could not find 0x pattern in JSON line\n");
-      }
-    }
-
-    // 查找 tx: 或 transaction: 开头的行中的交易哈希
-    if (!tx_found && (strstr(buffer, "tx:") != NULL || strstr(buffer, "transaction:") != NULL)) {
-      char *hash_start = strstr(buffer, "0x");
-      if (hash_start) {
-        strncpy(tx_hash, hash_start, 66);
-        tx_hash[66] = '\0';
-        printf("[ESCROW] Captured tx hash from tx/transaction line: %s\n", tx_hash);
-        tx_found = 1;
-        break;
-      }
-    }
-    
-    // 通用兜底：在任意输出行中查找 0x + 64 个十六进制字符
-    // 但要排除包含参数名的行（escrowId, contractAddr等）
-    if (!tx_found && 
-        strstr(buffer, "escrowId") == NULL && 
-        strstr(buffer, "contractAddr") == NULL &&
-        strstr(buffer, "params:") == NULL) {
-      for (size_t i = 0; buffer[i] && buffer[i+1]; i++) {
-        if (buffer[i] == '0' && buffer[i+1] == 'x') {
-          // 统计后续十六进制字符个数
-          size_t j = i + 2; size_t hex_cnt = 0;
-          while (buffer[j]) {
-            char c = buffer[j];
-            if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F')) {
-              hex_cnt++; j++;
-            } else {
-              break;
-            }
-          }
-          if (hex_cnt >= 64) {
-            // 截取标准长度 0x + 64
-            strncpy(tx_hash, buffer + i, 66);
-            tx_hash[66] = '\0';
-            printf("[ESCROW] Captured fallback tx hash: %s\n", tx_hash);
-            tx_found = 1;
-            break;
-          }
-        }
-      }
-      if (tx_found) break;
-    }
-  }
-  
-  int rc = pclose(fp);
+  escrow_client_t client = escrow_client_shared();
+  char tx_hash[ESCROW_HASH_STR_LEN] = {0};
+  const int rc = (client != NULL
+                  && escrow_confirm(client, state->pool_label, escrow_id_to_use, state->sigma_t->r, state->sigma_t->s,
+                                    bob_r, bob_s, bob_from, state->bob_ec_sk->sk, tx_hash) == RLC_OK) ? 0 : -1;
   END_TIMER(bob_blockchain_escrow_interaction)
-  free(cmd);
+  bn_free(bob_r);
+  bn_free(bob_s);
   
-  if (tx_found || rc == 0) {
-    // 如果成功捕获到交易哈希，存储到state中
-    if (strlen(tx_hash) > 0) {
-      strncpy(state->confirm_escrow_tx_hash, tx_hash, sizeof(state->confirm_escrow_tx_hash) - 1);
-      state->confirm_escrow_tx_hash[sizeof(state->confirm_escrow_tx_hash) - 1] = '\0';
-      printf("[ESCROW] Stored confirmEscrow transaction hash: %s\n", state->confirm_escrow_tx_hash);
-      
-      // 注意: Bob 托管成功的交易 hash 不需要记录到文件
-      // （已按要求移除文件写入代码）
-    } else {
-      // 如果没有捕获到，使用默认值
-      strncpy(state->confirm_escrow_tx_hash, "0x0000000000000000000000000000000000000000000000000000000000000000", sizeof(state->confirm_escrow_tx_hash) - 1);
-      printf("[ESCROW] No transaction hash captured, using default\n");
-    }
-    
-    printf("[ESCROW] Bob confirmed escrow successfully (tx_found=%d, rc=%d)\n", tx_found, rc);
-    // 统一返回 0 表示成功
-    rc = 0;
+  if (rc == 0) {
+    strncpy(state->confirm_escrow_tx_hash, tx_hash, sizeof(state->confirm_escrow_tx_hash) - 1);
+    state->confirm_escrow_tx_hash[sizeof(state->confirm_escrow_tx_hash) - 1] = '\0';
+    printf("[ESCROW] Stored confirmEscrow transaction hash: %s\n", state->confirm_escrow_tx_hash);
+    // 注意: Bob 托管成功的交易 hash 不需要记录到文件
+    printf("[ESCROW] Bob confirmed escrow successfully\n");
   } else {
-    fprintf(stderr, "[ESCROW] Bob confirm escrow failed with code %d.\n", rc);
+    fprintf(stderr, "[ESCROW] Bob confirm escrow failed.\n");
   }
   
   return rc;
@@ -586,6 +446,7 @@ int token_share_handler(bob_state_t state, void *socket, uint8_t *data, transact
     // 4. escrow_tx_hash (null-terminated string)
     // 5. pool_label (null-terminated string)
     // 6. pool_contract (null-terminated string)
+    // 7. alice_escrow_id (null-terminated string)，即 Tumbler 侧的会话 ID
     size_t offset = 0;
     
     // 1. 读取 nullifier (31 bytes)
@@ -618,12 +479,19 @@ int token_share_handler(bob_state_t state, void *socket, uint8_t *data, transact
     const char *pool_contract_ptr = (const char*)(data + offset);
     memset(state->pool_contract, 0, sizeof(state->pool_contract));
     strncpy(state->pool_contract, pool_contract_ptr, sizeof(state->pool_contract) - 1);
+    offset += strlen(pool_contract_ptr) + 1;
+    
+    // 7. 读取会话 ID
+    const char *session_id_ptr = (const char*)(data + offset);
+    memset(state->mix_session_id, 0, sizeof(state->mix_session_id));
+    strncpy(state->mix_session_id, session_id_ptr, sizeof(state->mix_session_id) - 1);
     
     printf("[TORNADO] Bob: Received nullifier and secret from Alice\n");
     printf("[TORNADO] Bob: commitment=%s\n", state->commitment);
     printf("[TORNADO] Bob: escrow_tx_hash=%s\n", state->escrow_tx_hash);
     printf("[TORNADO] Bob: pool_label=%s\n", state->pool_label);
     printf("[TORNADO] Bob: pool_contract=%s\n", state->pool_contract);
+    printf("[BOB] mix session id=%s\n", state->mix_session_id);
     
     // 现在 Bob 需要生成 zk 证明
     printf("[TORNADO] Bob: Starting withdraw proof generation...\n");
@@ -968,6 +836,10 @@ int promise_init(bob_state_t state, void *socket, transaction_t* tx_data) {
 
     memcpy(zmq_msg_data(&promise_init), serialized_message, total_msg_length);
     printf("[BOB] 发送 promise_init 消息到 Tumbler...\n");
+    if (mix_session_send_id(socket, state->mix_session_id) != RLC_OK) {
+      fprintf(stderr, "Error: could not send the session id (%s).\n", msg_type);
+      RLC_THROW(ERR_CAUGHT);
+    }
     rc = zmq_msg_send(&promise_init, socket, 0);  // 阻塞发送
     if (rc != total_msg_length) {
       fprintf(stderr, "Error: could not send the message (%s). Sent %d, expected %d\n", msg_type, rc, total_msg_length);
@@ -1010,27 +882,13 @@ int promise_done_handler(bob_state_t state, void *socket, uint8_t *data, transac
     bn_read_bin(state->sigma_t->pi->z, data + (4 * RLC_EC_SIZE_COMPRESSED) + (2 * RLC_BN_SIZE), RLC_BN_SIZE);
 
     size_t offset = (4 * RLC_EC_SIZE_COMPRESSED) + (3 * RLC_BN_SIZE);
-    char ctx_str[RLC_CL_CIPHERTEXT_SIZE + 1];
-    memcpy(ctx_str, data + offset, RLC_CL_CIPHERTEXT_SIZE);
-    ctx_str[RLC_CL_CIPHERTEXT_SIZE] = 0;
-    state->ctx_alpha->c1 = gp_read_str(ctx_str);
-    offset += RLC_CL_CIPHERTEXT_SIZE;
-    memcpy(ctx_str, data + offset, RLC_CL_CIPHERTEXT_SIZE);
-    ctx_str[RLC_CL_CIPHERTEXT_SIZE] = 0;
-    state->ctx_alpha->c2 = gp_read_str(ctx_str);
-    offset += RLC_CL_CIPHERTEXT_SIZE;
+    if (cl_codec_read_ct(state->ctx_alpha, data, &offset, state->cl_params) != RLC_OK) {
+      RLC_THROW(ERR_CAUGHT);
+    }
     // 解析auditor密文（按照Tumbler端的序列化顺序）
-    char auditor_ctx_str[RLC_CL_CIPHERTEXT_SIZE + 1];
-    memcpy(auditor_ctx_str, data + offset, RLC_CL_CIPHERTEXT_SIZE);
-    auditor_ctx_str[RLC_CL_CIPHERTEXT_SIZE] = 0;
-    
-    state->auditor_ctx_alpha->c1 = gp_read_str(auditor_ctx_str);
-    offset += RLC_CL_CIPHERTEXT_SIZE;
-    memcpy(auditor_ctx_str, data + offset, RLC_CL_CIPHERTEXT_SIZE);
-    auditor_ctx_str[RLC_CL_CIPHERTEXT_SIZE] = 0;
-    
-    state->auditor_ctx_alpha->c2 = gp_read_str(auditor_ctx_str);
-    offset += RLC_CL_CIPHERTEXT_SIZE;
+    if (cl_codec_read_ct(state->auditor_ctx_alpha, data, &offset, state->cl_params) != RLC_OK) {
+      RLC_THROW(ERR_CAUGHT);
+    }
     printf("[DEBUG] auditor_ctx_alpha fields deserialized\n");
     
     char *debug_c1 = GENtostr(state->auditor_ctx_alpha->c1);
@@ -1054,7 +912,7 @@ int promise_done_handler(bob_state_t state, void *socket, uint8_t *data, transac
     // 解析综合零知识证明
     printf("[BOB] 开始解析综合零知识证明...\n");
     size_t zk_read;
-    if (zk_comprehensive_puzzle_deserialize(state->received_puzzle_zk_proof, data + after_id, &zk_read) != RLC_OK) {
+    if (zk_comprehensive_puzzle_deserialize(state->received_puzzle_zk_proof, data + after_id, &zk_read, state->cl_params) != RLC_OK) {
       printf("[ERROR] 零知识证明反序列化失败!\n");
       RLC_THROW(ERR_CAUGHT);
     }
@@ -1306,39 +1164,23 @@ int puzzle_share(bob_state_t state, void *socket, transaction_t* tx_data) {
     ec_write_bin(puzzle_share_msg->data + offset, RLC_EC_SIZE_COMPRESSED, g_to_the_alpha_times_beta, 1);
     offset += RLC_EC_SIZE_COMPRESSED;
     
-    // 使用字符串形式序列化CL密文
-    const char *ctx_c1_str = GENtostr(ctx_alpha_times_beta->c1);
-    const char *ctx_c2_str = GENtostr(ctx_alpha_times_beta->c2);
-    memcpy(puzzle_share_msg->data + offset, ctx_c1_str, RLC_CL_CIPHERTEXT_SIZE);
-    offset += RLC_CL_CIPHERTEXT_SIZE;
-    memcpy(puzzle_share_msg->data + offset, ctx_c2_str, RLC_CL_CIPHERTEXT_SIZE);
-    offset += RLC_CL_CIPHERTEXT_SIZE;
+    if (cl_codec_write_ct(puzzle_share_msg->data, &offset, ctx_alpha_times_beta) != RLC_OK) {
+      RLC_THROW(ERR_CAUGHT);
+    }
     
     // 附加auditor密文
-    const char *aud_c1_str = GENtostr(auditor_ctx_alpha_times_beta->c1);
-    const char *aud_c2_str = GENtostr(auditor_ctx_alpha_times_beta->c2);
-    memcpy(puzzle_share_msg->data + offset, aud_c1_str, RLC_CL_CIPHERTEXT_SIZE);
-    offset += RLC_CL_CIPHERTEXT_SIZE;
-    memcpy(puzzle_share_msg->data + offset, aud_c2_str, RLC_CL_CIPHERTEXT_SIZE);
-    offset += RLC_CL_CIPHERTEXT_SIZE;
+    if (cl_codec_write_ct(puzzle_share_msg->data, &offset, auditor_ctx_alpha_times_beta) != RLC_OK) {
+      RLC_THROW(ERR_CAUGHT);
+    }
     
     // 2. 序列化原始谜题数据（Alice需要这些来验证）
     ec_write_bin(puzzle_share_msg->data + offset, RLC_EC_SIZE_COMPRESSED, state->g_to_the_alpha, 1);
     offset += RLC_EC_SIZE_COMPRESSED;
     
-    const char *orig_ctx_c1_str = GENtostr(state->ctx_alpha->c1);
-    const char *orig_ctx_c2_str = GENtostr(state->ctx_alpha->c2);
-    memcpy(puzzle_share_msg->data + offset, orig_ctx_c1_str, RLC_CL_CIPHERTEXT_SIZE);
-    offset += RLC_CL_CIPHERTEXT_SIZE;
-    memcpy(puzzle_share_msg->data + offset, orig_ctx_c2_str, RLC_CL_CIPHERTEXT_SIZE);
-    offset += RLC_CL_CIPHERTEXT_SIZE;
-    
-    const char *orig_aud_c1_str = GENtostr(state->auditor_ctx_alpha->c1);
-    const char *orig_aud_c2_str = GENtostr(state->auditor_ctx_alpha->c2);
-    memcpy(puzzle_share_msg->data + offset, orig_aud_c1_str, RLC_CL_CIPHERTEXT_SIZE);
-    offset += RLC_CL_CIPHERTEXT_SIZE;
-    memcpy(puzzle_share_msg->data + offset, orig_aud_c2_str, RLC_CL_CIPHERTEXT_SIZE);
-    offset += RLC_CL_CIPHERTEXT_SIZE;
+    if (cl_codec_write_ct(puzzle_share_msg->data, &offset, state->ctx_alpha) != RLC_OK
+        || cl_codec_write_ct(puzzle_share_msg->data, &offset, state->auditor_ctx_alpha) != RLC_OK) {
+      RLC_THROW(ERR_CAUGHT);
+    }
     
     // 生成谜题关系零知识证明
     printf("[BOB] 开始生成谜题关系零知识证明...\n");
@@ -1441,19 +1283,19 @@ static int send_layered_proof_to_tumbler(bob_state_t state,
   bn_write_bin(m->data + off, RLC_BN_SIZE, proof->pedersen_proof->u); off += RLC_BN_SIZE;
   bn_write_bin(m->data + off, RLC_BN_SIZE, proof->pedersen_proof->v); off += RLC_BN_SIZE;
   // outer proof
-  memcpy(m->data + off, GENtostr(proof->outer_proof->t1), RLC_CLDL_PROOF_T1_SIZE); off += RLC_CLDL_PROOF_T1_SIZE;
+  cl_codec_write(m->data + off, RLC_CLDL_PROOF_T1_SIZE, proof->outer_proof->t1); off += RLC_CLDL_PROOF_T1_SIZE;
   ec_write_bin(m->data + off, RLC_EC_SIZE_COMPRESSED, proof->outer_proof->t2, 1); off += RLC_EC_SIZE_COMPRESSED;
-  memcpy(m->data + off, GENtostr(proof->outer_proof->t3), RLC_CLDL_PROOF_T3_SIZE); off += RLC_CLDL_PROOF_T3_SIZE;
-  memcpy(m->data + off, GENtostr(proof->outer_proof->u1), RLC_CLDL_PROOF_U1_SIZE); off += RLC_CLDL_PROOF_U1_SIZE;
-  memcpy(m->data + off, GENtostr(proof->outer_proof->u2), RLC_CLDL_PROOF_U2_SIZE); off += RLC_CLDL_PROOF_U2_SIZE;
+  cl_codec_write(m->data + off, RLC_CLDL_PROOF_T3_SIZE, proof->outer_proof->t3); off += RLC_CLDL_PROOF_T3_SIZE;
+  cl_codec_write(m->data + off, RLC_CLDL_PROOF_U1_SIZE, proof->outer_proof->u1); off += RLC_CLDL_PROOF_U1_SIZE;
+  cl_codec_write(m->data + off, RLC_CLDL_PROOF_U2_SIZE, proof->outer_proof->u2); off += RLC_CLDL_PROOF_U2_SIZE;
   // tag_hash
   memcpy(m->data + off, proof->tag_hash, RLC_MD_LEN); off += RLC_MD_LEN;
   // inner (auditor) ciphertext alpha*beta
-  memcpy(m->data + off, GENtostr(inner_auditor_beta->c1), RLC_CL_CIPHERTEXT_SIZE); off += RLC_CL_CIPHERTEXT_SIZE;
-  memcpy(m->data + off, GENtostr(inner_auditor_beta->c2), RLC_CL_CIPHERTEXT_SIZE); off += RLC_CL_CIPHERTEXT_SIZE;
+  cl_codec_write(m->data + off, RLC_CL_CIPHERTEXT_SIZE, inner_auditor_beta->c1); off += RLC_CL_CIPHERTEXT_SIZE;
+  cl_codec_write(m->data + off, RLC_CL_CIPHERTEXT_SIZE, inner_auditor_beta->c2); off += RLC_CL_CIPHERTEXT_SIZE;
   // outer (auditor2) ciphertext Enc_aud2(H(inner))
-  memcpy(m->data + off, GENtostr(outer_auditor2_beta->c1), RLC_CL_CIPHERTEXT_SIZE); off += RLC_CL_CIPHERTEXT_SIZE;
-  memcpy(m->data + off, GENtostr(outer_auditor2_beta->c2), RLC_CL_CIPHERTEXT_SIZE); off += RLC_CL_CIPHERTEXT_SIZE;
+  cl_codec_write(m->data + off, RLC_CL_CIPHERTEXT_SIZE, outer_auditor2_beta->c1); off += RLC_CL_CIPHERTEXT_SIZE;
+  cl_codec_write(m->data + off, RLC_CL_CIPHERTEXT_SIZE, outer_auditor2_beta->c2); off += RLC_CL_CIPHERTEXT_SIZE;
 
   memcpy(m->type, msg_type, msg_type_length);
   uint8_t *serialized = NULL; serialize_message(&serialized, m, msg_type_length, msg_data_length);
@@ -1461,6 +1303,14 @@ static int send_layered_proof_to_tumbler(bob_state_t state,
   zmq_msg_init_size(&z, total_len);
   memcpy(zmq_msg_data(&z), serialized, total_len);
   printf("[BOB DEBUG] 即将发送 ZK 证明给 Tumbler，消息大小: %d\n", total_len);
+  if (mix_session_send_id(socket, state->mix_session_id) != RLC_OK) {
+    fprintf(stderr, "Error: could not send the session id (%s).\n", msg_type);
+    zmq_msg_close(&z);
+    free(serialized);
+    message_free(m);
+    zmq_close(socket); zmq_ctx_term(context);
+    return RLC_ERR;
+  }
   int send_result = zmq_msg_send(&z, socket, 0);
   printf("[BOB DEBUG] zmq_msg_send 返回值: %d\n", send_result);
   zmq_msg_close(&z);
@@ -1588,7 +1438,7 @@ static int send_layered_proof_to_tumbler_with_complete_proof(bob_state_t state,
   off += RLC_BN_SIZE;
   
   // outer proof (使用完整证明中的proof_encryption)
-  memcpy(m->data + off, GENtostr(proof->proof_encryption->t1), RLC_CLDL_PROOF_T1_SIZE); 
+  cl_codec_write(m->data + off, RLC_CLDL_PROOF_T1_SIZE, proof->proof_encryption->t1); 
   off += RLC_CLDL_PROOF_T1_SIZE;
   {
     uint8_t t2_bytes[33];
@@ -1599,11 +1449,11 @@ static int send_layered_proof_to_tumbler_with_complete_proof(bob_state_t state,
   }
   ec_write_bin(m->data + off, RLC_EC_SIZE_COMPRESSED, proof->proof_encryption->t2, 1); 
   off += RLC_EC_SIZE_COMPRESSED;
-  memcpy(m->data + off, GENtostr(proof->proof_encryption->t3), RLC_CLDL_PROOF_T3_SIZE); 
+  cl_codec_write(m->data + off, RLC_CLDL_PROOF_T3_SIZE, proof->proof_encryption->t3); 
   off += RLC_CLDL_PROOF_T3_SIZE;
-  memcpy(m->data + off, GENtostr(proof->proof_encryption->u1), RLC_CLDL_PROOF_U1_SIZE); 
+  cl_codec_write(m->data + off, RLC_CLDL_PROOF_U1_SIZE, proof->proof_encryption->u1); 
   off += RLC_CLDL_PROOF_U1_SIZE;
-  memcpy(m->data + off, GENtostr(proof->proof_encryption->u2), RLC_CLDL_PROOF_U2_SIZE); 
+  cl_codec_write(m->data + off, RLC_CLDL_PROOF_U2_SIZE, proof->proof_encryption->u2); 
   off += RLC_CLDL_PROOF_U2_SIZE;
   
   // tag_hash (使用完整证明中的inner_hash)
@@ -1612,22 +1462,22 @@ static int send_layered_proof_to_tumbler_with_complete_proof(bob_state_t state,
 
   // 新增：ct_beta（β = Enc(pk1, r0)）
   if (state->auditor_ctx_alpha && state->auditor_ctx_alpha->c1 && state->auditor_ctx_alpha->c2) {
-    memcpy(m->data + off, GENtostr(state->auditor_ctx_alpha->c1), RLC_CL_CIPHERTEXT_SIZE);
+    cl_codec_write(m->data + off, RLC_CL_CIPHERTEXT_SIZE, state->auditor_ctx_alpha->c1);
   } else {
     memset(m->data + off, 0, RLC_CL_CIPHERTEXT_SIZE);
   }
   off += RLC_CL_CIPHERTEXT_SIZE;
   if (state->auditor_ctx_alpha && state->auditor_ctx_alpha->c1 && state->auditor_ctx_alpha->c2) {
-    memcpy(m->data + off, GENtostr(state->auditor_ctx_alpha->c2), RLC_CL_CIPHERTEXT_SIZE);
+    cl_codec_write(m->data + off, RLC_CL_CIPHERTEXT_SIZE, state->auditor_ctx_alpha->c2);
   } else {
     memset(m->data + off, 0, RLC_CL_CIPHERTEXT_SIZE);
   }
   off += RLC_CL_CIPHERTEXT_SIZE;
   
   // inner c1,c2 (ct_beta_prime)
-  memcpy(m->data + off, GENtostr(inner_auditor_beta->c1), RLC_CL_CIPHERTEXT_SIZE); 
+  cl_codec_write(m->data + off, RLC_CL_CIPHERTEXT_SIZE, inner_auditor_beta->c1); 
   off += RLC_CL_CIPHERTEXT_SIZE;
-  memcpy(m->data + off, GENtostr(inner_auditor_beta->c2), RLC_CL_CIPHERTEXT_SIZE); 
+  cl_codec_write(m->data + off, RLC_CL_CIPHERTEXT_SIZE, inner_auditor_beta->c2); 
   off += RLC_CL_CIPHERTEXT_SIZE;
   
   // outer c1,c2 (隐藏outer：发送全0占位，长度对齐)
@@ -1676,6 +1526,14 @@ static int send_layered_proof_to_tumbler_with_complete_proof(bob_state_t state,
   zmq_msg_t z;
   zmq_msg_init_size(&z, total_len);
   memcpy(zmq_msg_data(&z), serialized, total_len);
+  if (mix_session_send_id(socket, state->mix_session_id) != RLC_OK) {
+    fprintf(stderr, "Error: could not send the session id (%s).\n", msg_type);
+    zmq_msg_close(&z);
+    free(serialized);
+    message_free(m);
+    zmq_close(socket); zmq_ctx_term(context);
+    return RLC_ERR;
+  }
   int send_result = zmq_msg_send(&z, socket, 0);
   printf("[BOB DEBUG] zmq_msg_send 返回值: %d\n", send_result);
   zmq_msg_close(&z);
@@ -1871,7 +1729,8 @@ int puzzle_solution_share_handler(bob_state_t state, void *socet, uint8_t *data,
           zmq_msg_t z; int rcz = zmq_msg_init_size(&z, total_msg_length);
           if (rcz == 0) {
             memcpy(zmq_msg_data(&z), serialized, total_msg_length);
-            int sz = zmq_msg_send(&z, sock2, ZMQ_DONTWAIT);
+            int sz = (mix_session_send_id(sock2, state->mix_session_id) == RLC_OK)
+                ? zmq_msg_send(&z, sock2, ZMQ_DONTWAIT) : -1;
             if (sz != total_msg_length) {
               printf("[BOB->TUMBLER] send bob_confirm_done failed (sz=%d)\n", sz);
             } else {
@@ -1899,27 +1758,27 @@ int puzzle_solution_share_handler(bob_state_t state, void *socet, uint8_t *data,
     uint8_t tumbler_g_to_the_alpha[RLC_EC_SIZE_COMPRESSED];
     ec_write_bin(tumbler_g_to_the_alpha, RLC_EC_SIZE_COMPRESSED, state->g_to_the_alpha, 1);
     uint8_t tumbler_ctx[2 * RLC_CL_CIPHERTEXT_SIZE];
-    memcpy(tumbler_ctx, GENtostr(state->ctx_alpha->c1), RLC_CL_CIPHERTEXT_SIZE);
-    memcpy(tumbler_ctx + RLC_CL_CIPHERTEXT_SIZE, GENtostr(state->ctx_alpha->c2), RLC_CL_CIPHERTEXT_SIZE);
+    cl_codec_write(tumbler_ctx, RLC_CL_CIPHERTEXT_SIZE, state->ctx_alpha->c1);
+    cl_codec_write(tumbler_ctx + RLC_CL_CIPHERTEXT_SIZE, RLC_CL_CIPHERTEXT_SIZE, state->ctx_alpha->c2);
     
     // 2. bob puzzle（g_to_the_alpha_times_beta, ctx_alpha_times_beta）
     uint8_t bob_g_to_the_alpha_times_beta[RLC_EC_SIZE_COMPRESSED];
     ec_write_bin(bob_g_to_the_alpha_times_beta, RLC_EC_SIZE_COMPRESSED, state->g_to_the_alpha_times_beta, 1);
     uint8_t bob_ctx[2 * RLC_CL_CIPHERTEXT_SIZE];
-    memcpy(bob_ctx, GENtostr(state->ctx_alpha_times_beta->c1), RLC_CL_CIPHERTEXT_SIZE);
-    memcpy(bob_ctx + RLC_CL_CIPHERTEXT_SIZE, GENtostr(state->ctx_alpha_times_beta->c2), RLC_CL_CIPHERTEXT_SIZE);
+    cl_codec_write(bob_ctx, RLC_CL_CIPHERTEXT_SIZE, state->ctx_alpha_times_beta->c1);
+    cl_codec_write(bob_ctx + RLC_CL_CIPHERTEXT_SIZE, RLC_CL_CIPHERTEXT_SIZE, state->ctx_alpha_times_beta->c2);
     
     // 3. auditor ctx_alpha
     printf("[DEBUG] Bob: 准备auditor_ctx_alpha数据...\n");
     uint8_t auditor_ctx_alpha[2 * RLC_CL_CIPHERTEXT_SIZE];
-    memcpy(auditor_ctx_alpha, GENtostr(state->auditor_ctx_alpha->c1), RLC_CL_CIPHERTEXT_SIZE);
-    memcpy(auditor_ctx_alpha + RLC_CL_CIPHERTEXT_SIZE, GENtostr(state->auditor_ctx_alpha->c2), RLC_CL_CIPHERTEXT_SIZE);
+    cl_codec_write(auditor_ctx_alpha, RLC_CL_CIPHERTEXT_SIZE, state->auditor_ctx_alpha->c1);
+    cl_codec_write(auditor_ctx_alpha + RLC_CL_CIPHERTEXT_SIZE, RLC_CL_CIPHERTEXT_SIZE, state->auditor_ctx_alpha->c2);
     
     // 4. auditor ctx_alpha_times_beta
     printf("[DEBUG] Bob: 准备auditor_ctx_alpha_times_beta数据...\n");
     uint8_t auditor_ctx_alpha_times_beta[2 * RLC_CL_CIPHERTEXT_SIZE];
-    memcpy(auditor_ctx_alpha_times_beta, GENtostr(state->auditor_ctx_alpha_times_beta->c1), RLC_CL_CIPHERTEXT_SIZE);
-    memcpy(auditor_ctx_alpha_times_beta + RLC_CL_CIPHERTEXT_SIZE, GENtostr(state->auditor_ctx_alpha_times_beta->c2), RLC_CL_CIPHERTEXT_SIZE);
+    cl_codec_write(auditor_ctx_alpha_times_beta, RLC_CL_CIPHERTEXT_SIZE, state->auditor_ctx_alpha_times_beta->c1);
+    cl_codec_write(auditor_ctx_alpha_times_beta + RLC_CL_CIPHERTEXT_SIZE, RLC_CL_CIPHERTEXT_SIZE, state->auditor_ctx_alpha_times_beta->c2);
     
     
     // 5. bob presignature (使用保存的预签名) - 完整结构体
@@ -1971,52 +1830,32 @@ int puzzle_solution_share_handler(bob_state_t state, void *socet, uint8_t *data,
                                RLC_EC_SIZE_COMPRESSED + RLC_CLDL_PROOF_U1_SIZE + RLC_CLDL_PROOF_U2_SIZE + RLC_CLDL_PROOF_U1_SIZE];
     size_t malleability_offset = 0;
     
-    // 保存 t1_c1 (大整数)
-    char t1_c1_str[RLC_CLDL_PROOF_T1_SIZE + 1];
-    const char* t1_c1_gen_str = GENtostr(state->malleability_proof->t1_c1);
-    size_t t1_c1_len = strlen(t1_c1_gen_str);
-    if (t1_c1_len > RLC_CLDL_PROOF_T1_SIZE) {
-        printf("[ERROR] Bob: t1_c1字符串长度 %zu 超过限制 %d\n", t1_c1_len, RLC_CLDL_PROOF_T1_SIZE);
+    // 保存 t1_c1 (二次型)
+    if (cl_codec_write(malleability_proof + malleability_offset, RLC_CLDL_PROOF_T1_SIZE, state->malleability_proof->t1_c1) != RLC_OK) {
+        printf("[ERROR] Bob: t1_c1 编码失败，超过槽位 %d\n", RLC_CLDL_PROOF_T1_SIZE);
         RLC_THROW(ERR_CAUGHT);
     }
-    sprintf(t1_c1_str, "%s", t1_c1_gen_str);
-    memcpy(malleability_proof + malleability_offset, t1_c1_str, RLC_CLDL_PROOF_T1_SIZE);
     malleability_offset += RLC_CLDL_PROOF_T1_SIZE;
     
-    // 保存 t1_c2 (大整数)
-    char t1_c2_str[RLC_CLDL_PROOF_T1_SIZE + 1];
-    const char* t1_c2_gen_str = GENtostr(state->malleability_proof->t1_c2);
-    size_t t1_c2_len = strlen(t1_c2_gen_str);
-    if (t1_c2_len > RLC_CLDL_PROOF_T1_SIZE) {
-        printf("[ERROR] Bob: t1_c2字符串长度 %zu 超过限制 %d\n", t1_c2_len, RLC_CLDL_PROOF_T1_SIZE);
+    // 保存 t1_c2 (二次型)
+    if (cl_codec_write(malleability_proof + malleability_offset, RLC_CLDL_PROOF_T1_SIZE, state->malleability_proof->t1_c2) != RLC_OK) {
+        printf("[ERROR] Bob: t1_c2 编码失败，超过槽位 %d\n", RLC_CLDL_PROOF_T1_SIZE);
         RLC_THROW(ERR_CAUGHT);
     }
-    sprintf(t1_c2_str, "%s", t1_c2_gen_str);
-    memcpy(malleability_proof + malleability_offset, t1_c2_str, RLC_CLDL_PROOF_T1_SIZE);
     malleability_offset += RLC_CLDL_PROOF_T1_SIZE;
     
-    // 保存 t2_c1 (大整数) - 使用T1_SIZE因为实际长度接近1070字节
-    char t2_c1_str[RLC_CLDL_PROOF_T1_SIZE + 1];
-    const char* t2_c1_gen_str = GENtostr(state->malleability_proof->t2_c1);
-    size_t t2_c1_len = strlen(t2_c1_gen_str);
-    if (t2_c1_len > RLC_CLDL_PROOF_T1_SIZE) {
-        printf("[ERROR] Bob: t2_c1字符串长度 %zu 超过限制 %d\n", t2_c1_len, RLC_CLDL_PROOF_T1_SIZE);
+    // 保存 t2_c1 (二次型)
+    if (cl_codec_write(malleability_proof + malleability_offset, RLC_CLDL_PROOF_T1_SIZE, state->malleability_proof->t2_c1) != RLC_OK) {
+        printf("[ERROR] Bob: t2_c1 编码失败，超过槽位 %d\n", RLC_CLDL_PROOF_T1_SIZE);
         RLC_THROW(ERR_CAUGHT);
     }
-    sprintf(t2_c1_str, "%s", t2_c1_gen_str);
-    memcpy(malleability_proof + malleability_offset, t2_c1_str, RLC_CLDL_PROOF_T1_SIZE);
     malleability_offset += RLC_CLDL_PROOF_T1_SIZE;
     
-    // 保存 t2_c2 (大整数) - 使用T1_SIZE因为实际长度接近1070字节
-    char t2_c2_str[RLC_CLDL_PROOF_T1_SIZE + 1];
-    const char* t2_c2_gen_str = GENtostr(state->malleability_proof->t2_c2);
-    size_t t2_c2_len = strlen(t2_c2_gen_str);
-    if (t2_c2_len > RLC_CLDL_PROOF_T1_SIZE) {
-        printf("[ERROR] Bob: t2_c2字符串长度 %zu 超过限制 %d\n", t2_c2_len, RLC_CLDL_PROOF_T1_SIZE);
+    // 保存 t2_c2 (二次型)
+    if (cl_codec_write(malleability_proof + malleability_offset, RLC_CLDL_PROOF_T1_SIZE, state->malleability_proof->t2_c2) != RLC_OK) {
+        printf("[ERROR] Bob: t2_c2 编码失败，超过槽位 %d\n", RLC_CLDL_PROOF_T1_SIZE);
         RLC_THROW(ERR_CAUGHT);
     }
-    sprintf(t2_c2_str, "%s", t2_c2_gen_str);
-    memcpy(malleability_proof + malleability_offset, t2_c2_str, RLC_CLDL_PROOF_T1_SIZE);
     malleability_offset += RLC_CLDL_PROOF_T1_SIZE;
     
     // 保存 t3 (椭圆曲线点)
@@ -2024,39 +1863,24 @@ int puzzle_solution_share_handler(bob_state_t state, void *socet, uint8_t *data,
     malleability_offset += RLC_EC_SIZE_COMPRESSED;
     
     // 保存 u1 (大整数)
-    char malleability_u1_str[RLC_CLDL_PROOF_U1_SIZE + 1];
-    const char* u1_gen_str = GENtostr(state->malleability_proof->u1);
-    size_t u1_len = strlen(u1_gen_str);
-    if (u1_len > RLC_CLDL_PROOF_U1_SIZE) {
-        printf("[ERROR] Bob: u1字符串长度 %zu 超过限制 %d\n", u1_len, RLC_CLDL_PROOF_U1_SIZE);
+    if (cl_codec_write(malleability_proof + malleability_offset, RLC_CLDL_PROOF_U1_SIZE, state->malleability_proof->u1) != RLC_OK) {
+        printf("[ERROR] Bob: u1 编码失败，超过槽位 %d\n", RLC_CLDL_PROOF_U1_SIZE);
         RLC_THROW(ERR_CAUGHT);
     }
-    sprintf(malleability_u1_str, "%s", u1_gen_str);
-    memcpy(malleability_proof + malleability_offset, malleability_u1_str, RLC_CLDL_PROOF_U1_SIZE);
     malleability_offset += RLC_CLDL_PROOF_U1_SIZE;
     
     // 保存 u2 (大整数)
-    char malleability_u2_str[RLC_CLDL_PROOF_U2_SIZE + 1];
-    const char* u2_gen_str = GENtostr(state->malleability_proof->u2);
-    size_t u2_len = strlen(u2_gen_str);
-    if (u2_len > RLC_CLDL_PROOF_U2_SIZE) {
-        printf("[ERROR] Bob: u2字符串长度 %zu 超过限制 %d\n", u2_len, RLC_CLDL_PROOF_U2_SIZE);
+    if (cl_codec_write(malleability_proof + malleability_offset, RLC_CLDL_PROOF_U2_SIZE, state->malleability_proof->u2) != RLC_OK) {
+        printf("[ERROR] Bob: u2 编码失败，超过槽位 %d\n", RLC_CLDL_PROOF_U2_SIZE);
         RLC_THROW(ERR_CAUGHT);
     }
-    sprintf(malleability_u2_str, "%s", u2_gen_str);
-    memcpy(malleability_proof + malleability_offset, malleability_u2_str, RLC_CLDL_PROOF_U2_SIZE);
     malleability_offset += RLC_CLDL_PROOF_U2_SIZE;
     
-    // 保存 u3 (大整数) - 使用U1_SIZE因为实际长度是77字节
-    char u3_str[RLC_CLDL_PROOF_U1_SIZE + 1];
-    const char* u3_gen_str = GENtostr(state->malleability_proof->u3);
-    size_t u3_len = strlen(u3_gen_str);
-    if (u3_len > RLC_CLDL_PROOF_U1_SIZE) {
-        printf("[ERROR] Bob: u3字符串长度 %zu 超过限制 %d\n", u3_len, RLC_CLDL_PROOF_U1_SIZE);
+    // 保存 u3 (大整数)
+    if (cl_codec_write(malleability_proof + malleability_offset, RLC_CLDL_PROOF_U1_SIZE, state->malleability_proof->u3) != RLC_OK) {
+        printf("[ERROR] Bob: u3 编码失败，超过槽位 %d\n", RLC_CLDL_PROOF_U1_SIZE);
         RLC_THROW(ERR_CAUGHT);
     }
-    sprintf(u3_str, "%s", u3_gen_str);
-    memcpy(malleability_proof + malleability_offset, u3_str, RLC_CLDL_PROOF_U1_SIZE);
     malleability_offset += RLC_CLDL_PROOF_U1_SIZE;
     
     printf("[DEBUG] Bob: 可延展性零知识证明数据准备完成，大小: %zu字节\n", malleability_offset);
@@ -2157,6 +1981,9 @@ int puzzle_solution_share_handler(bob_state_t state, void *socet, uint8_t *data,
     printf("[DEBUG] Bob: 调用create_secret_shares...\n");
     // 计算需要的分享数组大小（num_blocks * SECRET_SHARES）
     size_t num_blocks = (total_len + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    // 混合模式（A2L_SHARE_MODE=hybrid）只分享对称密钥，载荷加密后随分片发送
+    int hybrid = share_mode_hybrid();
+    if (hybrid && num_blocks < SHARE_KEY_BLOCKS) num_blocks = SHARE_KEY_BLOCKS;
     size_t max_shares = num_blocks * SECRET_SHARES;
     secret_share_t* shares = (secret_share_t*)malloc(sizeof(secret_share_t) * max_shares);
     if (shares == NULL) {
@@ -2166,7 +1993,11 @@ int puzzle_solution_share_handler(bob_state_t state, void *socet, uint8_t *data,
     }
     
     size_t num_shares = 0;
-    int share_result = create_secret_shares(packed, total_len, shares, &num_shares);
+    uint8_t* envelope = NULL;
+    size_t envelope_len = 0;
+    int share_result = hybrid
+        ? create_hybrid_shares(packed, total_len, msg_id, shares, &num_shares, NULL, &envelope, &envelope_len)
+        : create_secret_shares(packed, total_len, shares, &num_shares);
     printf("[DEBUG] Bob: create_secret_shares返回: %d, num_shares: %zu\n", share_result, num_shares);
     
     if (share_result == 0) {
@@ -2186,8 +2017,13 @@ int puzzle_solution_share_handler(bob_state_t state, void *socet, uint8_t *data,
           endpoint_ptrs[i] = RECEIVER_ENDPOINTS[i];
         }
         
-        send_shares_to_receivers(shares, num_shares, msg_id, endpoint_ptrs);
+        if (hybrid) {
+          send_hybrid_shares_to_receivers(shares, num_shares, envelope, envelope_len, msg_id, endpoint_ptrs);
+        } else {
+          send_shares_to_receivers(shares, num_shares, msg_id, endpoint_ptrs);
+        }
         printf("[DEBUG] Bob: 秘密分享发送完成\n");
+        free(envelope);
         free(shares);
     } else {
         printf("[DEBUG] Bob: 秘密分享创建失败！\n");
@@ -2420,6 +2256,12 @@ int main(int argc, char* argv[])
       }
       END_TIMER(bob_initialization_computation)
 
+      // 为 Tumbler 与审计员公钥预计算 CL 加密随机数（beta 的两次 cl_enc）
+      if (cl_enc_pool_start(state->cl_params) == RLC_OK) {
+        cl_enc_pool_register(state->tumbler_cl_pk);
+        cl_enc_pool_register(state->auditor_cl_pk);
+      }
+
       // ========== 本地同态自测（可选） ==========
       // 若需要同时测试 CL 同态，请确保 Bob 持有对应私钥；
       // 否则可传 NULL 跳过 CL 测试，仅测试 EC 群律。
@@ -2541,6 +2383,7 @@ int main(int argc, char* argv[])
     } RLC_CATCH_ANY {
       result_status = RLC_ERR;
     } RLC_FINALLY {
+      cl_enc_pool_stop();
       bob_state_free(state);
       
       rc = zmq_close(socket);
@@ -2569,6 +2412,9 @@ int main(int argc, char* argv[])
       double pure_computation_time = (get_timer_value("bob_total_computation_time") - get_timer_value("bob_blockchain_escrow_interaction")) / 1000.0;
       printf("Bob 纯计算时间（排除区块链交互）: %.5f 秒\n", pure_computation_time);
       
+      escrow_client_shared_close();
+      share_dispatch_shutdown(0);
+      
       // 输出时间测量结果
       print_timing_summary();
       
@@ -1,10 +1,12 @@
 /**
  * 计算声誉统计数据的独立程序
  * 从决策记录中计算准确率和一致性，并保存到CSV文件
+ * 带 --verify 参数时额外用全量重算校验增量聚合，不一致时返回非零
  */
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "reputation_tracker.h"
 
 int main(int argc, char* argv[]) {
@@ -27,6 +29,16 @@ int main(int argc, char* argv[]) {
         return 1;
     }
     
+    if (argc > 1 && strcmp(argv[1], "--verify") == 0) {
+        int mismatches = reputation_tracker_verify_stats();
+        if (mismatches != 0) {
+            fprintf(stderr, "❌ 增量统计与全量重算不一致\n");
+            reputation_tracker_cleanup();
+            return 1;
+        }
+        printf("✅ 增量统计与全量重算一致\n");
+    }
+    
     printf("\n✅ 统计数据计算完成\n");
     printf("========================================\n");
     
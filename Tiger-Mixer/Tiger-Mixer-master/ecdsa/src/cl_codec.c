@@ -0,0 +1,192 @@
+/**
+ * Class Group 元素与整数的二进制线格式编码实现
+ */
+
+#include <string.h>
+#include "/home/zxx/Config/relic/include/relic.h"
+#include "pari/pari.h"
+#include "types.h"
+#include "cl_codec.h"
+
+// |x| 的大端字节数
+static size_t int_magnitude_size(GEN x) {
+  if (signe(x) == 0) return 0;
+  return (size_t) ((expi(x) >> 3) + 1);
+}
+
+static size_t int_encoded_size(GEN x) {
+  return CL_CODEC_INT_BYTES(int_magnitude_size(x));
+}
+
+static int int_put(uint8_t *dst, size_t cap, size_t *off, GEN x) {
+  size_t n = int_magnitude_size(x);
+  if (n > 0xFFFF || *off + CL_CODEC_INT_BYTES(n) > cap) {
+    return RLC_ERR;
+  }
+
+  uint8_t *p = dst + *off;
+  p[0] = (signe(x) < 0) ? 1 : 0;
+  p[1] = (uint8_t) (n >> 8);
+  p[2] = (uint8_t) n;
+  p += 3;
+
+  // 从最低位字开始，从后往前填充大端字节
+  if (n > 0) {
+    long words = lgefint(x) - 2;
+    GEN w = int_LSW(x);
+    size_t pos = n;
+    for (long i = 0; i < words && pos > 0; i++, w = int_nextW(w)) {
+      ulong limb = (ulong) *w;
+      for (size_t j = 0; j < sizeof(ulong) && pos > 0; j++) {
+        p[--pos] = (uint8_t) (limb & 0xFF);
+        limb >>= 8;
+      }
+    }
+  }
+
+  *off += CL_CODEC_INT_BYTES(n);
+  return RLC_OK;
+}
+
+static GEN int_get(const uint8_t *src, size_t len, size_t *off) {
+  if (*off + 3 > len) return NULL;
+
+  const uint8_t *p = src + *off;
+  int negative = p[0];
+  size_t n = ((size_t) p[1] << 8) | p[2];
+  if (negative > 1 || *off + CL_CODEC_INT_BYTES(n) > len) return NULL;
+  p += 3;
+  *off += CL_CODEC_INT_BYTES(n);
+
+  if (n == 0) return gen_0;
+
+  long words = (long) ((n + sizeof(ulong) - 1) / sizeof(ulong));
+  GEN z = cgeti(words + 2);
+  z[1] = evalsigne(1) | evallgefint(words + 2);
+
+  GEN w = int_LSW(z);
+  size_t pos = n;
+  for (long i = 0; i < words; i++, w = int_nextW(w)) {
+    ulong limb = 0;
+    for (size_t j = 0; j < sizeof(ulong) && pos > 0; j++) {
+      limb |= ((ulong) p[--pos]) << (8 * j);
+    }
+    *w = (long) limb;
+  }
+
+  z = int_normalize(z, 0);
+  if (signe(z) != 0 && negative) setsigne(z, -1);
+  return z;
+}
+
+size_t cl_codec_size(GEN x) {
+  if (x == NULL) return 1;
+  switch (typ(x)) {
+    case t_INT:
+      return 1 + int_encoded_size(x);
+    case t_QFB:
+      return 1 + int_encoded_size(gel(x, 1)) + int_encoded_size(gel(x, 2));
+    default:
+      return 0;
+  }
+}
+
+int cl_codec_put(uint8_t *dst, size_t cap, size_t *off, GEN x) {
+  if (*off + 1 > cap) return RLC_ERR;
+
+  size_t pos = *off + 1;
+  if (x == NULL) {
+    dst[*off] = CL_CODEC_TAG_NONE;
+  } else if (typ(x) == t_INT) {
+    dst[*off] = CL_CODEC_TAG_INT;
+    if (int_put(dst, cap, &pos, x) != RLC_OK) return RLC_ERR;
+  } else if (typ(x) == t_QFB) {
+    dst[*off] = CL_CODEC_TAG_QFB;
+    if (int_put(dst, cap, &pos, gel(x, 1)) != RLC_OK
+        || int_put(dst, cap, &pos, gel(x, 2)) != RLC_OK) {
+      return RLC_ERR;
+    }
+  } else {
+    return RLC_ERR;
+  }
+
+  *off = pos;
+  return RLC_OK;
+}
+
+GEN cl_codec_get(const uint8_t *src, size_t len, size_t *off, const cl_params_t params) {
+  if (*off + 1 > len) return NULL;
+
+  const uint8_t tag = src[*off];
+  size_t pos = *off + 1;
+  GEN result = NULL;
+
+  switch (tag) {
+    case CL_CODEC_TAG_INT:
+      result = int_get(src, len, &pos);
+      break;
+
+    case CL_CODEC_TAG_QFB: {
+      pari_sp av = avma;
+      GEN a = int_get(src, len, &pos);
+      GEN b = (a != NULL) ? int_get(src, len, &pos) : NULL;
+      if (a == NULL || b == NULL || signe(a) <= 0 || params == NULL) {
+        set_avma(av);
+        return NULL;
+      }
+      // c = (b^2 - Delta_K * q^2) / (4a)，必须整除，否则不是合法的二次型
+      GEN disc = mulii(params->Delta_K, sqri(params->q));
+      GEN rem;
+      GEN c = dvmdii(subii(sqri(b), disc), shifti(a, 2), &rem);
+      if (signe(rem) != 0) {
+        set_avma(av);
+        return NULL;
+      }
+      result = gerepileupto(av, Qfb0(a, b, c));
+      break;
+    }
+
+    case CL_CODEC_TAG_NONE:
+    default:
+      return NULL;
+  }
+
+  if (result != NULL) *off = pos;
+  return result;
+}
+
+int cl_codec_write(uint8_t *dst, size_t slot, GEN x) {
+  size_t off = 0;
+
+  memset(dst, 0, slot);
+  if (x != NULL && typ(x) == t_QFB && cl_codec_size(x) > slot) {
+    // 未约化的形式可能超出槽位，约化后表示同一个类群元素
+    x = qfbred(x);
+  }
+  if (cl_codec_put(dst, slot, &off, x) != RLC_OK) {
+    memset(dst, 0, slot);
+    return RLC_ERR;
+  }
+  return RLC_OK;
+}
+
+GEN cl_codec_read(const uint8_t *src, size_t slot, const cl_params_t params) {
+  size_t off = 0;
+  return cl_codec_get(src, slot, &off, params);
+}
+
+int cl_codec_write_ct(uint8_t *dst, size_t *off, const cl_ciphertext_t ct) {
+  if (cl_codec_write(dst + *off, CL_CODEC_QFB_SIZE, ct->c1) != RLC_OK
+      || cl_codec_write(dst + *off + CL_CODEC_QFB_SIZE, CL_CODEC_QFB_SIZE, ct->c2) != RLC_OK) {
+    return RLC_ERR;
+  }
+  *off += 2 * CL_CODEC_QFB_SIZE;
+  return RLC_OK;
+}
+
+int cl_codec_read_ct(cl_ciphertext_t ct, const uint8_t *src, size_t *off, const cl_params_t params) {
+  ct->c1 = cl_codec_read(src + *off, CL_CODEC_QFB_SIZE, params);
+  ct->c2 = cl_codec_read(src + *off + CL_CODEC_QFB_SIZE, CL_CODEC_QFB_SIZE, params);
+  *off += 2 * CL_CODEC_QFB_SIZE;
+  return (ct->c1 != NULL && ct->c2 != NULL) ? RLC_OK : RLC_ERR;
+}
@@ -0,0 +1,216 @@
+/**
+ * CL 加密后台随机数池实现
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include "/home/zxx/Config/relic/include/relic.h"
+#include "pari/pari.h"
+#include "types.h"
+#include "cl_fixed_base.h"
+#include "cl_enc_pool.h"
+#include "util.h"
+
+typedef struct {
+  GENbin *key;                            // 公钥的二进制副本
+  GENbin *items[CL_ENC_POOL_DEPTH];       // 每项为 [r, g_q^r, pk^r]
+  size_t count;
+} cl_enc_pool_slot_t;
+
+static struct {
+  pthread_mutex_t mutex;
+  pthread_cond_t refill;                  // 有槽位需要补充或需要退出
+  pthread_t thread;
+  int running;
+  int stop;
+  cl_params_t params;
+  cl_enc_pool_slot_t slots[CL_ENC_POOL_MAX_KEYS];
+  size_t n_slots;
+#if TIGER_MT_ENABLED
+  struct pari_thread pari_thread;
+#endif
+} g_enc_pool = {
+  .mutex = PTHREAD_MUTEX_INITIALIZER,
+  .refill = PTHREAD_COND_INITIALIZER,
+};
+
+#if TIGER_MT_ENABLED
+// 调用方持有锁：返回最缺三元组的槽位，全部已满返回 NULL
+static cl_enc_pool_slot_t *pool_emptiest_slot(void) {
+  cl_enc_pool_slot_t *best = NULL;
+  for (size_t i = 0; i < g_enc_pool.n_slots; i++) {
+    cl_enc_pool_slot_t *slot = &g_enc_pool.slots[i];
+    if (slot->count < CL_ENC_POOL_DEPTH && (best == NULL || slot->count < best->count)) {
+      best = slot;
+    }
+  }
+  return best;
+}
+
+// 计算一个三元组 [r, g_q^r, pk^r] 并复制成二进制副本；PARI 出错时返回 NULL
+static GENbin *pool_precompute(GEN key, const cl_params_t params) {
+  GENbin *item = NULL;
+  pari_sp av = avma;
+  pari_CATCH(CATCH_ALL) {
+    item = NULL;
+  } pari_TRY {
+    cl_public_key_st public_key = { .pk = key };
+    GEN r = randomi(params->bound);
+    GEN g_q_r = cl_gq_pow(params, r);
+    GEN pk_r = cl_pk_pow(&public_key, r, params);
+    item = copy_bin(mkvec3(r, g_q_r, pk_r));
+  } pari_ENDCATCH;
+  set_avma(av);
+  return item;
+}
+
+static void *pool_main(void *arg) {
+  (void) arg;
+
+  pari_thread_start(&g_enc_pool.pari_thread);
+  core_init();
+  {
+    uint8_t seed[sizeof(ulong)];
+    ulong s;
+    rand_bytes(seed, sizeof(seed));
+    memcpy(&s, seed, sizeof(s));
+    setrand(utoi(s));
+  }
+
+  const cl_params_t params = g_enc_pool.params;
+
+  pthread_mutex_lock(&g_enc_pool.mutex);
+  while (!g_enc_pool.stop) {
+    cl_enc_pool_slot_t *slot = pool_emptiest_slot();
+    if (slot == NULL) {
+      pthread_cond_wait(&g_enc_pool.refill, &g_enc_pool.mutex);
+      continue;
+    }
+    // 槽位只在 cl_enc_pool_stop 中释放，锁外读取 key 是安全的
+    GEN key = slot->key->x;
+    pthread_mutex_unlock(&g_enc_pool.mutex);
+
+    GENbin *item = pool_precompute(key, params);
+
+    pthread_mutex_lock(&g_enc_pool.mutex);
+    if (item == NULL) {
+      fprintf(stderr, "[CL_POOL] 预计算失败，后台线程退出\n");
+      break;
+    }
+    slot->items[slot->count++] = item;
+  }
+  pthread_mutex_unlock(&g_enc_pool.mutex);
+
+  core_clean();
+  pari_thread_close();
+  return NULL;
+}
+#endif
+
+int cl_enc_pool_start(const cl_params_t params) {
+#if TIGER_MT_ENABLED
+  if (params == NULL) return RLC_ERR;
+
+  pthread_mutex_lock(&g_enc_pool.mutex);
+  if (g_enc_pool.running) {
+    pthread_mutex_unlock(&g_enc_pool.mutex);
+    return RLC_OK;
+  }
+  g_enc_pool.params = params;
+  g_enc_pool.stop = 0;
+  pari_thread_alloc(&g_enc_pool.pari_thread, CL_ENC_POOL_PARI_STACK, NULL);
+  if (pthread_create(&g_enc_pool.thread, NULL, pool_main, NULL) != 0) {
+    pari_thread_free(&g_enc_pool.pari_thread);
+    pthread_mutex_unlock(&g_enc_pool.mutex);
+    return RLC_ERR;
+  }
+  g_enc_pool.running = 1;
+  pthread_mutex_unlock(&g_enc_pool.mutex);
+  return RLC_OK;
+#else
+  (void) params;
+  tiger_mt_warn("CL 加密池不启用");
+  return RLC_ERR;
+#endif
+}
+
+void cl_enc_pool_stop(void) {
+  pthread_mutex_lock(&g_enc_pool.mutex);
+  if (!g_enc_pool.running) {
+    pthread_mutex_unlock(&g_enc_pool.mutex);
+    return;
+  }
+  g_enc_pool.stop = 1;
+  pthread_cond_broadcast(&g_enc_pool.refill);
+  pthread_mutex_unlock(&g_enc_pool.mutex);
+
+  pthread_join(g_enc_pool.thread, NULL);
+#if TIGER_MT_ENABLED
+  pari_thread_free(&g_enc_pool.pari_thread);
+#endif
+
+  pthread_mutex_lock(&g_enc_pool.mutex);
+  for (size_t i = 0; i < g_enc_pool.n_slots; i++) {
+    cl_enc_pool_slot_t *slot = &g_enc_pool.slots[i];
+    for (size_t j = 0; j < slot->count; j++) {
+      pari_free(slot->items[j]);
+    }
+    pari_free(slot->key);
+    memset(slot, 0, sizeof(*slot));
+  }
+  g_enc_pool.n_slots = 0;
+  g_enc_pool.params = NULL;
+  g_enc_pool.running = 0;
+  pthread_mutex_unlock(&g_enc_pool.mutex);
+}
+
+int cl_enc_pool_register(const cl_public_key_t public_key) {
+  if (public_key == NULL || typ(public_key->pk) != t_QFB) return RLC_ERR;
+
+  int result_status = RLC_ERR;
+  pthread_mutex_lock(&g_enc_pool.mutex);
+  if (g_enc_pool.running) {
+    for (size_t i = 0; i < g_enc_pool.n_slots; i++) {
+      if (gequal(g_enc_pool.slots[i].key->x, public_key->pk)) {
+        result_status = RLC_OK;
+        break;
+      }
+    }
+    if (result_status != RLC_OK && g_enc_pool.n_slots < CL_ENC_POOL_MAX_KEYS) {
+      g_enc_pool.slots[g_enc_pool.n_slots++].key = copy_bin(public_key->pk);
+      pthread_cond_signal(&g_enc_pool.refill);
+      result_status = RLC_OK;
+    }
+  }
+  pthread_mutex_unlock(&g_enc_pool.mutex);
+  return result_status;
+}
+
+int cl_enc_pool_take(GEN *r, GEN *g_q_r, GEN *pk_r, const cl_public_key_t public_key) {
+  GENbin *item = NULL;
+
+  pthread_mutex_lock(&g_enc_pool.mutex);
+  if (g_enc_pool.running) {
+    for (size_t i = 0; i < g_enc_pool.n_slots; i++) {
+      cl_enc_pool_slot_t *slot = &g_enc_pool.slots[i];
+      if (gequal(slot->key->x, public_key->pk)) {
+        if (slot->count > 0) {
+          item = slot->items[--slot->count];
+          pthread_cond_signal(&g_enc_pool.refill);
+        }
+        break;
+      }
+    }
+  }
+  pthread_mutex_unlock(&g_enc_pool.mutex);
+
+  if (item == NULL) return RLC_ERR;
+
+  // bin_copy 把三元组搬到当前线程的 PARI 栈上并释放二进制副本
+  GEN triple = bin_copy(item);
+  *r = gel(triple, 1);
+  *g_q_r = gel(triple, 2);
+  *pk_r = gel(triple, 3);
+  return RLC_OK;
+}
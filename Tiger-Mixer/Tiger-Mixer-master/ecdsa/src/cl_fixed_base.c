@@ -0,0 +1,307 @@
+/**
+ * Class Group 固定基幂运算（Lim–Lee 梳形法）实现
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include "/home/zxx/Config/relic/include/relic.h"
+#include "pari/pari.h"
+#include "types.h"
+#include "cl_codec.h"
+#include "cl_fixed_base.h"
+
+#define CL_FIXED_BASE_MAGIC "CLFB"
+
+#define fb_L(table)       gel((table)->data->x, 1)
+#define fb_base(table)    gel((table)->data->x, 2)
+#define fb_entry(table, s) gel((table)->data->x, 2 + (s))
+
+static cl_fixed_base_t fixed_base_alloc(GEN data, long window, long spacing) {
+  cl_fixed_base_t table = malloc(sizeof(cl_fixed_base_st));
+  if (table == NULL) return NULL;
+  table->data = copy_bin(data);
+  table->window = window;
+  table->spacing = spacing;
+  return table;
+}
+
+int cl_fixed_base_build(cl_fixed_base_t *out, GEN base, long bits, long window) {
+  if (out == NULL || base == NULL || typ(base) != t_QFB || bits <= 0 || window < 1 || window > 16) {
+    return RLC_ERR;
+  }
+
+  pari_sp av = avma;
+  const long spacing = (bits + window - 1) / window;
+  const long count = 1L << window;
+  // L = floor(|D|^(1/4))，与 nupow 内部使用的 NUCOMP 参数一致
+  GEN L = sqrtnint(absi(qfb_disc(base)), 4);
+
+  // 梳齿 G_j = base^(2^(j*d))
+  GEN teeth = cgetg(window + 1, t_VEC);
+  gel(teeth, 1) = base;
+  for (long j = 1; j < window; j++) {
+    GEN x = gel(teeth, j);
+    for (long i = 0; i < spacing; i++) {
+      x = nudupl(x, L);
+    }
+    gel(teeth, j + 1) = x;
+  }
+
+  // T[s] = T[s 去掉最高位] * G_{最高位}
+  GEN data = cgetg(count + 2, t_VEC);
+  gel(data, 1) = L;
+  gel(data, 2) = base;
+  for (long s = 1; s < count; s++) {
+    long top = 63 - __builtin_clzl((unsigned long) s);
+    long rest = s & ~(1L << top);
+    gel(data, 2 + s) = (rest == 0) ? gel(teeth, top + 1)
+                                   : nucomp(gel(data, 2 + rest), gel(teeth, top + 1), L);
+  }
+
+  *out = fixed_base_alloc(data, window, spacing);
+  set_avma(av);
+  return (*out != NULL) ? RLC_OK : RLC_ERR;
+}
+
+GEN cl_fixed_base_pow(const cl_fixed_base_t table, GEN base, GEN e) {
+  if (table == NULL || signe(e) == 0 || !gequal(fb_base(table), base)
+      || expi(e) >= table->window * table->spacing) {
+    return nupow(base, e, NULL);
+  }
+
+  pari_sp av = avma;
+  GEN L = fb_L(table);
+  GEN result = NULL;
+  // bittest 按补码读取负数，梳形法只用 |e| 的比特，负指数在最后取逆（与 cl_multiexp 一致）
+  GEN abs_e = absi(e);
+
+  // 按列从高到低：每列先平方，再乘上该列 w 个比特选出的子集乘积
+  for (long i = table->spacing - 1; i >= 0; i--) {
+    if (result != NULL) result = nudupl(result, L);
+
+    long s = 0;
+    for (long j = 0; j < table->window; j++) {
+      if (bittest(abs_e, j * table->spacing + i)) s |= 1L << j;
+    }
+    if (s != 0) {
+      result = (result == NULL) ? fb_entry(table, s) : nucomp(result, fb_entry(table, s), L);
+    }
+  }
+
+  if (signe(e) < 0) result = ginv(result);
+  return gerepileupto(av, gcopy(result));
+}
+
+GEN cl_gq_pow(const cl_params_t params, GEN e) {
+  return cl_fixed_base_pow(params->g_q_table, params->g_q, e);
+}
+
+typedef struct {
+  GENbin *key;              // 公钥的二进制副本，NULL 表示空槽
+  cl_fixed_base_t table;    // 达到阈值前为 NULL
+  unsigned hits;            // 命中次数
+  unsigned refs;            // 正在使用该表的调用数
+  int building;             // 是否有线程正在构建该表
+  unsigned long last_use;   // LRU 时钟
+} cl_pk_cache_entry_t;
+
+static cl_pk_cache_entry_t pk_cache[CL_PK_CACHE_CAPACITY];
+static unsigned long pk_cache_clock = 0;
+static pthread_mutex_t pk_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void pk_cache_entry_reset(cl_pk_cache_entry_t *entry) {
+  if (entry->key != NULL) pari_free(entry->key);
+  cl_fixed_base_free(entry->table);
+  memset(entry, 0, sizeof(*entry));
+}
+
+// 调用方持有锁：查找公钥；不存在时占用空槽或淘汰最久未用且空闲的槽位
+static cl_pk_cache_entry_t *pk_cache_lookup(GEN pk) {
+  cl_pk_cache_entry_t *victim = NULL;
+
+  for (size_t i = 0; i < CL_PK_CACHE_CAPACITY; i++) {
+    cl_pk_cache_entry_t *entry = &pk_cache[i];
+    if (entry->key != NULL && gequal(entry->key->x, pk)) {
+      return entry;
+    }
+    if (entry->refs != 0 || entry->building) continue;
+    if (victim == NULL
+        || (victim->key != NULL && (entry->key == NULL || entry->last_use < victim->last_use))) {
+      victim = entry;
+    }
+  }
+
+  if (victim != NULL) {
+    pk_cache_entry_reset(victim);
+    victim->key = copy_bin(pk);
+  }
+  return victim;
+}
+
+GEN cl_pk_pow(const cl_public_key_t public_key, GEN e, const cl_params_t params) {
+  GEN pk = public_key->pk;
+  if (params == NULL || typ(pk) != t_QFB) {
+    return nupow(pk, e, NULL);
+  }
+
+  cl_fixed_base_t table = NULL;
+  int build = 0;
+
+  pthread_mutex_lock(&pk_cache_mutex);
+  cl_pk_cache_entry_t *entry = pk_cache_lookup(pk);
+  if (entry != NULL) {
+    entry->hits++;
+    entry->last_use = ++pk_cache_clock;
+    if (entry->table != NULL) {
+      entry->refs++;
+      table = entry->table;
+    } else if (entry->hits >= CL_PK_CACHE_THRESHOLD && !entry->building) {
+      entry->building = 1;
+      build = 1;
+    }
+  }
+  pthread_mutex_unlock(&pk_cache_mutex);
+
+  if (build) {
+    // 构建在锁外进行；building 标记保证该槽位不会被淘汰
+    long bits = expi(params->bound) + 1 + CL_FIXED_BASE_MARGIN;
+    cl_fixed_base_t built = NULL;
+    if (cl_fixed_base_build(&built, pk, bits, CL_FIXED_BASE_WINDOW) != RLC_OK) {
+      built = NULL;
+    }
+
+    pthread_mutex_lock(&pk_cache_mutex);
+    entry->building = 0;
+    entry->table = built;
+    if (built != NULL) {
+      entry->refs++;
+      table = built;
+    }
+    pthread_mutex_unlock(&pk_cache_mutex);
+  }
+
+  if (table == NULL) {
+    return nupow(pk, e, NULL);
+  }
+
+  GEN result = cl_fixed_base_pow(table, pk, e);
+
+  pthread_mutex_lock(&pk_cache_mutex);
+  entry->refs--;
+  pthread_mutex_unlock(&pk_cache_mutex);
+  return result;
+}
+
+void cl_pk_cache_clear(void) {
+  pthread_mutex_lock(&pk_cache_mutex);
+  for (size_t i = 0; i < CL_PK_CACHE_CAPACITY; i++) {
+    if (pk_cache[i].refs == 0 && !pk_cache[i].building) {
+      pk_cache_entry_reset(&pk_cache[i]);
+    }
+  }
+  pthread_mutex_unlock(&pk_cache_mutex);
+}
+
+int cl_params_precompute(cl_params_t params, const char *path) {
+  if (params == NULL || params->g_q == NULL || typ(params->g_q) != t_QFB) {
+    return RLC_ERR;
+  }
+  if (params->g_q_table != NULL) {
+    return RLC_OK;
+  }
+
+  if (path != NULL && cl_fixed_base_load(&params->g_q_table, params->g_q, path, params) == RLC_OK) {
+    return RLC_OK;
+  }
+
+  long bits = expi(params->bound) + 1 + CL_FIXED_BASE_MARGIN;
+  if (cl_fixed_base_build(&params->g_q_table, params->g_q, bits, CL_FIXED_BASE_WINDOW) != RLC_OK) {
+    return RLC_ERR;
+  }
+
+  if (path != NULL && cl_fixed_base_save(params->g_q_table, path) != RLC_OK) {
+    fprintf(stderr, "[CL] 警告: 无法写入固定基表 %s\n", path);
+  }
+  return RLC_OK;
+}
+
+static void put_u32(uint8_t *p, uint32_t v) {
+  p[0] = (uint8_t) (v >> 24); p[1] = (uint8_t) (v >> 16);
+  p[2] = (uint8_t) (v >> 8);  p[3] = (uint8_t) v;
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+  return ((uint32_t) p[0] << 24) | ((uint32_t) p[1] << 16) | ((uint32_t) p[2] << 8) | p[3];
+}
+
+int cl_fixed_base_save(const cl_fixed_base_t table, const char *path) {
+  if (table == NULL || path == NULL) return RLC_ERR;
+
+  FILE *file = fopen(path, "wb");
+  if (file == NULL) return RLC_ERR;
+
+  int result_status = RLC_OK;
+  const uint32_t count = (uint32_t) (1L << table->window);  // base + 2^w - 1 项
+  uint8_t header[14];
+  memcpy(header, CL_FIXED_BASE_MAGIC, 4);
+  header[4] = 0;
+  header[5] = (uint8_t) table->window;
+  put_u32(header + 6, (uint32_t) table->spacing);
+  put_u32(header + 10, count);
+
+  uint8_t slot[CL_CODEC_QFB_SIZE];
+  if (fwrite(header, 1, sizeof(header), file) != sizeof(header)) {
+    result_status = RLC_ERR;
+  }
+  for (uint32_t k = 0; k < count && result_status == RLC_OK; k++) {
+    // k = 0 为底本身，之后为 T[1..2^w-1]
+    if (cl_codec_write(slot, sizeof(slot), fb_entry(table, k)) != RLC_OK
+        || fwrite(slot, 1, sizeof(slot), file) != sizeof(slot)) {
+      result_status = RLC_ERR;
+    }
+  }
+
+  if (fclose(file) != 0) result_status = RLC_ERR;
+  return result_status;
+}
+
+int cl_fixed_base_load(cl_fixed_base_t *out, GEN base, const char *path, const cl_params_t params) {
+  if (out == NULL || path == NULL) return RLC_ERR;
+
+  FILE *file = fopen(path, "rb");
+  if (file == NULL) return RLC_ERR;
+
+  pari_sp av = avma;
+  int result_status = RLC_ERR;
+  uint8_t header[14];
+  uint8_t slot[CL_CODEC_QFB_SIZE];
+
+  if (fread(header, 1, sizeof(header), file) == sizeof(header)
+      && memcmp(header, CL_FIXED_BASE_MAGIC, 4) == 0) {
+    long window = header[5];
+    long spacing = (long) get_u32(header + 6);
+    uint32_t count = get_u32(header + 10);
+
+    if (window >= 1 && window <= 16 && spacing > 0 && count == (uint32_t) (1L << window)) {
+      GEN data = cgetg(count + 2, t_VEC);
+      gel(data, 1) = sqrtnint(absi(qfb_disc(base)), 4);
+      uint32_t k;
+      for (k = 0; k < count; k++) {
+        if (fread(slot, 1, sizeof(slot), file) != sizeof(slot)) break;
+        GEN form = cl_codec_read(slot, sizeof(slot), params);
+        if (form == NULL) break;
+        gel(data, 2 + k) = form;
+      }
+      // 表必须属于同一个底
+      if (k == count && gequal(gel(data, 2), base)) {
+        *out = fixed_base_alloc(data, window, spacing);
+        result_status = (*out != NULL) ? RLC_OK : RLC_ERR;
+      }
+    }
+  }
+
+  fclose(file);
+  set_avma(av);
+  return result_status;
+}
@@ -0,0 +1,134 @@
+/**
+ * Class Group 多重幂运算实现（Straus / Pippenger）
+ */
+
+#include "pari/pari.h"
+#include "cl_multiexp.h"
+
+// 取 |e| 从第 pos 位开始的 w 位
+static long window_digit(GEN e, long pos, long w) {
+  long digit = 0;
+  for (long j = w - 1; j >= 0; j--) {
+    digit = (digit << 1) | bittest(e, pos + j);
+  }
+  return digit;
+}
+
+static GEN comp_or_set(GEN acc, GEN x, GEN L) {
+  return (acc == NULL) ? x : nucomp(acc, x, L);
+}
+
+// Straus 的窗口宽度：预计算 2^w - 2 次合成，平均每个窗口省下 w - 1 次合成
+static long straus_window(long bits) {
+  if (bits <= 64) return 2;
+  if (bits <= 256) return 3;
+  if (bits <= 1024) return 4;
+  return 5;
+}
+
+// Pippenger 的窗口宽度：大约 log2(n) - 2，每个窗口需要 n + 2^(c+1) 次合成
+static long pippenger_window(long n) {
+  long c = 2;
+  while (c < 12 && (1L << (c + 2)) <= n) c++;
+  return c;
+}
+
+static GEN straus(GEN bases, GEN exps, long n, long bits, GEN L) {
+  const long w = straus_window(bits);
+  const long size = (1L << w) - 1;
+
+  // tables[i][d] = b_i^d，d = 1..2^w - 1
+  GEN tables = cgetg(n + 1, t_VEC);
+  for (long i = 1; i <= n; i++) {
+    GEN table = cgetg(size + 1, t_VEC);
+    gel(table, 1) = gel(bases, i);
+    if (size >= 2) gel(table, 2) = nudupl(gel(bases, i), L);
+    for (long d = 3; d <= size; d++) {
+      gel(table, d) = nucomp(gel(table, d - 1), gel(bases, i), L);
+    }
+    gel(tables, i) = table;
+  }
+
+  pari_sp av = avma;
+  GEN result = NULL;
+  for (long pos = ((bits + w - 1) / w - 1) * w; pos >= 0; pos -= w) {
+    if (result != NULL) {
+      for (long j = 0; j < w; j++) result = nudupl(result, L);
+    }
+    for (long i = 1; i <= n; i++) {
+      long digit = window_digit(gel(exps, i), pos, w);
+      if (digit != 0) result = comp_or_set(result, gmael(tables, i, digit), L);
+    }
+    if (result != NULL) result = gerepilecopy(av, result);
+  }
+  return result;
+}
+
+static GEN pippenger(GEN bases, GEN exps, long n, long bits, GEN L) {
+  const long c = pippenger_window(n);
+  const long size = (1L << c) - 1;
+
+  pari_sp av = avma;
+  GEN result = NULL;
+  for (long pos = ((bits + c - 1) / c - 1) * c; pos >= 0; pos -= c) {
+    if (result != NULL) {
+      for (long j = 0; j < c; j++) result = nudupl(result, L);
+    }
+
+    GEN buckets = cgetg(size + 1, t_VEC);
+    for (long d = 1; d <= size; d++) gel(buckets, d) = NULL;
+    for (long i = 1; i <= n; i++) {
+      long digit = window_digit(gel(exps, i), pos, c);
+      if (digit != 0) gel(buckets, digit) = comp_or_set(gel(buckets, digit), gel(bases, i), L);
+    }
+
+    // sum_d d * B_d = sum_{d} (B_size + ... + B_d)
+    GEN running = NULL, sum = NULL;
+    for (long d = size; d >= 1; d--) {
+      if (gel(buckets, d) != NULL) running = comp_or_set(running, gel(buckets, d), L);
+      if (running != NULL) sum = comp_or_set(sum, running, L);
+    }
+    if (sum != NULL) result = comp_or_set(result, sum, L);
+    if (result != NULL) result = gerepilecopy(av, result);
+    else set_avma(av);
+  }
+  return result;
+}
+
+GEN cl_multiexp(GEN bases, GEN exps) {
+  const long n = lg(bases) - 1;
+  if (n < 1 || lg(exps) - 1 != n) {
+    pari_err_DIM("cl_multiexp");
+  }
+
+  pari_sp av = avma;
+  GEN L = sqrtnint(absi(qfb_disc(gel(bases, 1))), 4);
+
+  // 负指数：改用逆元与 |e|；零指数的底直接丢弃
+  GEN b = cgetg(n + 1, t_VEC);
+  GEN e = cgetg(n + 1, t_VEC);
+  long m = 0, bits = 0;
+  for (long i = 1; i <= n; i++) {
+    GEN ei = gel(exps, i);
+    if (signe(ei) == 0) continue;
+    m++;
+    gel(b, m) = (signe(ei) < 0) ? ginv(gel(bases, i)) : gel(bases, i);
+    gel(e, m) = absi(ei);
+    if (expi(ei) + 1 > bits) bits = expi(ei) + 1;
+  }
+  if (m == 0) {
+    return gerepileupto(av, qfb_1(gel(bases, 1)));
+  }
+  setlg(b, m + 1);
+  setlg(e, m + 1);
+
+  GEN result = (m >= CL_MULTIEXP_PIPPENGER_MIN) ? pippenger(b, e, m, bits, L)
+                                                : straus(b, e, m, bits, L);
+  return gerepilecopy(av, result);
+}
+
+GEN cl_multiexp2(GEN b1, GEN e1, GEN b2, GEN e2) {
+  pari_sp av = avma;
+  GEN result = cl_multiexp(mkvec2(b1, b2), mkvec2(e1, e2));
+  return gerepileupto(av, result);
+}
@@ -0,0 +1,135 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/time.h>
+#include "util.h"
+
+// 测试配置
+#define BENCHMARK_RUNS 10
+#define EXP_BITS_SMALL 40   // 批量验证中的随机系数 / 挑战
+#define EXP_BITS_LARGE 0    // 0 表示使用 bound 的位数（CL 加密随机数）
+
+static const long BASE_COUNTS[] = { 2, 4, 8, 16, 32, 64 };
+
+#define START_BENCHMARK_TIMER() \
+    struct timeval start_time, end_time; \
+    gettimeofday(&start_time, NULL);
+
+#define END_BENCHMARK_TIMER() \
+    gettimeofday(&end_time, NULL); \
+    elapsed = (end_time.tv_sec - start_time.tv_sec) * 1000.0 + \
+              (end_time.tv_usec - start_time.tv_usec) / 1000.0;
+
+// 现有代码的做法：逐项 nupow 再 gmul
+static GEN naive_multiexp(GEN bases, GEN exps) {
+    GEN result = NULL;
+    for (long i = 1; i < lg(bases); i++) {
+        GEN term = nupow(gel(bases, i), gel(exps, i), NULL);
+        result = (result == NULL) ? term : gmul(result, term);
+    }
+    return result;
+}
+
+static void benchmark_case(const cl_params_t params, long n, long bits) {
+    double naive_total = 0, multi_total = 0;
+    int mismatches = 0;
+
+    for (int run = 0; run < BENCHMARK_RUNS; run++) {
+        pari_sp av = avma;
+        double elapsed = 0;
+
+        GEN bases = cgetg(n + 1, t_VEC);
+        GEN exps = cgetg(n + 1, t_VEC);
+        for (long i = 1; i <= n; i++) {
+            gel(bases, i) = nupow(params->g_q, randomi(params->bound), NULL);
+            gel(exps, i) = randomi(int2n(bits));
+        }
+
+        GEN expected, actual;
+        {
+            START_BENCHMARK_TIMER();
+            expected = naive_multiexp(bases, exps);
+            END_BENCHMARK_TIMER();
+            naive_total += elapsed;
+        }
+        {
+            START_BENCHMARK_TIMER();
+            actual = cl_multiexp(bases, exps);
+            END_BENCHMARK_TIMER();
+            multi_total += elapsed;
+        }
+        if (!gequal(expected, actual)) mismatches++;
+
+        set_avma(av);
+    }
+
+    printf("  n=%-3ld bits=%-5ld  逐项 nupow: %9.3f ms  多重幂: %9.3f ms  加速比: %5.2fx%s\n",
+           n, bits, naive_total / BENCHMARK_RUNS, multi_total / BENCHMARK_RUNS,
+           naive_total / multi_total, mismatches ? "  [结果不一致!]" : "");
+}
+
+// g_q 固定基表与 nupow 的一致性：正负指数、小指数和 bound 位数的指数
+static int check_fixed_base(const cl_params_t params) {
+    int mismatches = 0;
+    const long exp_bits[] = { EXP_BITS_SMALL, expi(params->bound) + 1 };
+
+    for (size_t b = 0; b < sizeof(exp_bits) / sizeof(exp_bits[0]); b++) {
+        for (int run = 0; run < BENCHMARK_RUNS; run++) {
+            pari_sp av = avma;
+            GEN e = randomi(int2n(exp_bits[b]));
+            GEN neg_e = negi(e);
+            if (!gequal(cl_gq_pow(params, e), nupow(params->g_q, e, NULL))) mismatches++;
+            if (!gequal(cl_gq_pow(params, neg_e), nupow(params->g_q, neg_e, NULL))) mismatches++;
+            set_avma(av);
+        }
+    }
+
+    printf("\n固定基表 g_q^e（含负指数）与 nupow 对照: %s\n", mismatches ? "[结果不一致!]" : "一致");
+    return mismatches;
+}
+
+int main() {
+    printf("========== Class Group 多重幂运算性能测试 ==========\n");
+    printf("测试时间: %s\n", ctime(&(time_t){time(NULL)}));
+    printf("测试次数: 每个配置 %d 次\n", BENCHMARK_RUNS);
+    printf("Pippenger 阈值: %d 个底\n", CL_MULTIEXP_PIPPENGER_MIN);
+    printf("=====================================\n");
+
+    if (init() != RLC_OK) {
+        printf("初始化失败\n");
+        return 1;
+    }
+
+    int result_status = 0;
+    cl_params_t params;
+    cl_params_null(params);
+
+    RLC_TRY {
+        cl_params_new(params);
+        if (generate_cl_params(params) != RLC_OK) {
+            RLC_THROW(ERR_CAUGHT);
+        }
+
+        if (check_fixed_base(params) != 0) {
+            result_status = 1;
+        }
+
+        const long large_bits = EXP_BITS_LARGE ? EXP_BITS_LARGE : expi(params->bound) + 1;
+        const long exp_bits[] = { EXP_BITS_SMALL, large_bits };
+
+        for (size_t b = 0; b < sizeof(exp_bits) / sizeof(exp_bits[0]); b++) {
+            printf("\n指数位数 %ld:\n", exp_bits[b]);
+            for (size_t i = 0; i < sizeof(BASE_COUNTS) / sizeof(BASE_COUNTS[0]); i++) {
+                benchmark_case(params, BASE_COUNTS[i], exp_bits[b]);
+            }
+        }
+    } RLC_CATCH_ANY {
+        result_status = 1;
+    } RLC_FINALLY {
+        cl_params_free(params);
+    }
+
+    clean();
+    return result_status;
+}
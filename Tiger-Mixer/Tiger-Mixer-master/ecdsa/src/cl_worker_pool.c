@@ -0,0 +1,219 @@
+/**
+ * 类群运算工作线程池实现
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include "/home/zxx/Config/relic/include/relic.h"
+#include "pari/pari.h"
+#include "cl_worker_pool.h"
+#include "util.h"
+
+// 一次 cl_worker_run 调用；位于调用方的栈上，直到所有任务完成
+typedef struct cl_worker_job_st {
+  cl_worker_task_t *tasks;
+  size_t n;
+  size_t claimed;                 // 已被领取的任务数
+  size_t pending;                 // 尚未完成的任务数
+  struct cl_worker_job_st *next;
+} cl_worker_job_t;
+
+static struct {
+  pthread_mutex_t mutex;
+  pthread_cond_t work;            // 有新任务或需要退出
+  pthread_cond_t done;            // 某个任务完成
+  int running;
+  int stop;
+  size_t n_threads;
+  cl_worker_job_t *jobs;          // 仍有未领取任务的作业（先进先出）
+  pthread_t threads[CL_WORKER_POOL_MAX_THREADS];
+#if TIGER_MT_ENABLED
+  struct pari_thread pari_threads[CL_WORKER_POOL_MAX_THREADS];
+#endif
+} g_worker_pool = {
+  .mutex = PTHREAD_MUTEX_INITIALIZER,
+  .work = PTHREAD_COND_INITIALIZER,
+  .done = PTHREAD_COND_INITIALIZER,
+};
+
+// 执行一个任务；remote 为真时结果复制成二进制副本，本线程的 PARI 栈随即回收
+static void pool_execute(cl_worker_task_t *task, int remote) {
+  pari_sp av = avma;
+  pari_CATCH(CATCH_ALL) {
+    task->result = NULL;
+    set_avma(av);
+  } pari_TRY {
+    task->result = task->fn(task->arg);
+    if (remote && task->result != NULL) {
+      task->bin = copy_bin(task->result);
+    }
+  } pari_ENDCATCH;
+  if (remote) {
+    task->result = NULL;
+    set_avma(av);
+  }
+}
+
+// 调用方持有锁：领取 job 的下一个任务，领完后把 job 移出队列
+static cl_worker_task_t *pool_claim(cl_worker_job_t *job) {
+  cl_worker_task_t *task = &job->tasks[job->claimed++];
+  if (job->claimed == job->n) {
+    for (cl_worker_job_t **it = &g_worker_pool.jobs; *it != NULL; it = &(*it)->next) {
+      if (*it == job) {
+        *it = job->next;
+        break;
+      }
+    }
+  }
+  return task;
+}
+
+#if TIGER_MT_ENABLED
+static void *pool_main(void *arg) {
+  pari_thread_start((struct pari_thread *) arg);
+  core_init();
+  pc_param_set_any();
+  ec_param_set_any();
+  ep_param_set(SECG_K256);
+  {
+    uint8_t seed[sizeof(ulong)];
+    ulong s;
+    rand_bytes(seed, sizeof(seed));
+    memcpy(&s, seed, sizeof(s));
+    setrand(utoi(s));
+  }
+
+  pthread_mutex_lock(&g_worker_pool.mutex);
+  while (!g_worker_pool.stop) {
+    cl_worker_job_t *job = g_worker_pool.jobs;
+    if (job == NULL) {
+      pthread_cond_wait(&g_worker_pool.work, &g_worker_pool.mutex);
+      continue;
+    }
+    cl_worker_task_t *task = pool_claim(job);
+    pthread_mutex_unlock(&g_worker_pool.mutex);
+
+    pool_execute(task, 1);
+
+    pthread_mutex_lock(&g_worker_pool.mutex);
+    if (--job->pending == 0) {
+      pthread_cond_broadcast(&g_worker_pool.done);
+    }
+  }
+  pthread_mutex_unlock(&g_worker_pool.mutex);
+
+  core_clean();
+  pari_thread_close();
+  return NULL;
+}
+#endif
+
+int cl_worker_pool_start(size_t n_threads) {
+#if TIGER_MT_ENABLED
+  if (n_threads == 0 || n_threads > CL_WORKER_POOL_MAX_THREADS) return RLC_ERR;
+
+  int result_status = RLC_OK;
+  pthread_mutex_lock(&g_worker_pool.mutex);
+  if (!g_worker_pool.running) {
+    g_worker_pool.stop = 0;
+    g_worker_pool.n_threads = 0;
+    for (size_t i = 0; i < n_threads; i++) {
+      pari_thread_alloc(&g_worker_pool.pari_threads[i], CL_WORKER_POOL_PARI_STACK, NULL);
+      if (pthread_create(&g_worker_pool.threads[i], NULL, pool_main, &g_worker_pool.pari_threads[i]) != 0) {
+        pari_thread_free(&g_worker_pool.pari_threads[i]);
+        result_status = RLC_ERR;
+        break;
+      }
+      g_worker_pool.n_threads++;
+    }
+    g_worker_pool.running = 1;
+  }
+  pthread_mutex_unlock(&g_worker_pool.mutex);
+
+  if (result_status != RLC_OK) {
+    cl_worker_pool_stop();
+  }
+  return result_status;
+#else
+  (void) n_threads;
+  tiger_mt_warn("类群运算线程池不启用");
+  return RLC_ERR;
+#endif
+}
+
+void cl_worker_pool_stop(void) {
+  pthread_mutex_lock(&g_worker_pool.mutex);
+  if (!g_worker_pool.running) {
+    pthread_mutex_unlock(&g_worker_pool.mutex);
+    return;
+  }
+  g_worker_pool.stop = 1;
+  pthread_cond_broadcast(&g_worker_pool.work);
+  pthread_mutex_unlock(&g_worker_pool.mutex);
+
+  for (size_t i = 0; i < g_worker_pool.n_threads; i++) {
+    pthread_join(g_worker_pool.threads[i], NULL);
+#if TIGER_MT_ENABLED
+    pari_thread_free(&g_worker_pool.pari_threads[i]);
+#endif
+  }
+
+  pthread_mutex_lock(&g_worker_pool.mutex);
+  g_worker_pool.n_threads = 0;
+  g_worker_pool.jobs = NULL;
+  g_worker_pool.running = 0;
+  pthread_mutex_unlock(&g_worker_pool.mutex);
+}
+
+size_t cl_worker_pool_size(void) {
+  pthread_mutex_lock(&g_worker_pool.mutex);
+  size_t n = g_worker_pool.running ? g_worker_pool.n_threads : 0;
+  pthread_mutex_unlock(&g_worker_pool.mutex);
+  return n;
+}
+
+int cl_worker_run(cl_worker_task_t *tasks, size_t n) {
+  if (n > 0 && tasks == NULL) return RLC_ERR;
+
+  for (size_t i = 0; i < n; i++) {
+    tasks[i].result = NULL;
+    tasks[i].bin = NULL;
+  }
+
+  cl_worker_job_t job = { .tasks = tasks, .n = n, .claimed = 0, .pending = n, .next = NULL };
+
+  pthread_mutex_lock(&g_worker_pool.mutex);
+  const int parallel = g_worker_pool.running && g_worker_pool.n_threads > 0 && n > 1;
+  if (parallel) {
+    cl_worker_job_t **tail = &g_worker_pool.jobs;
+    while (*tail != NULL) tail = &(*tail)->next;
+    *tail = &job;
+    pthread_cond_broadcast(&g_worker_pool.work);
+  }
+
+  // 调用线程也领取自己的任务；池线程忙时所有任务都在这里执行
+  while (job.claimed < job.n) {
+    cl_worker_task_t *task = parallel ? pool_claim(&job) : &tasks[job.claimed++];
+    pthread_mutex_unlock(&g_worker_pool.mutex);
+    pool_execute(task, 0);
+    pthread_mutex_lock(&g_worker_pool.mutex);
+    job.pending--;
+  }
+  while (job.pending > 0) {
+    pthread_cond_wait(&g_worker_pool.done, &g_worker_pool.mutex);
+  }
+  pthread_mutex_unlock(&g_worker_pool.mutex);
+
+  int result_status = RLC_OK;
+  for (size_t i = 0; i < n; i++) {
+    if (tasks[i].bin != NULL) {
+      tasks[i].result = bin_copy(tasks[i].bin);
+      tasks[i].bin = NULL;
+    }
+    if (tasks[i].result == NULL) {
+      result_status = RLC_ERR;
+    }
+  }
+  return result_status;
+}
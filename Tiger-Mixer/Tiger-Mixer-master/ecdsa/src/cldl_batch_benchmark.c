@@ -0,0 +1,208 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/time.h>
+#include "util.h"
+
+// CLDL 批量验证：与逐个验证的耗时对比，以及混入一个被篡改的证明时，
+// 批量验证必须拒绝、逐个回退必须准确定位到被篡改的下标。任何一项不符合预期时返回非 0
+
+// 测试配置
+#define BENCHMARK_RUNS 3
+
+static const size_t PROOF_COUNTS[] = { 2, 4, 8, 16 };
+
+#define START_BENCHMARK_TIMER() \
+    struct timeval start_time, end_time; \
+    gettimeofday(&start_time, NULL);
+
+#define END_BENCHMARK_TIMER() \
+    gettimeofday(&end_time, NULL); \
+    elapsed = (end_time.tv_sec - start_time.tv_sec) * 1000.0 + \
+              (end_time.tv_usec - start_time.tv_usec) / 1000.0;
+
+typedef struct {
+    size_t n;
+    zk_proof_cldl_t *proofs;
+    cl_ciphertext_t *ciphertexts;
+    cl_public_key_t *public_keys;
+    ec_t *Qs;
+} cldl_batch_t;
+
+// 生成 n 个有效证明，偶数下标针对 pk_a，奇数下标针对 pk_b（模拟 Tumbler/Auditor 两把公钥）
+static void batch_prepare(cldl_batch_t *batch, size_t n, const cl_public_key_t pk_a,
+                          const cl_public_key_t pk_b, const cl_params_t params) {
+    batch->n = n;
+    batch->proofs = calloc(n, sizeof(zk_proof_cldl_t));
+    batch->ciphertexts = calloc(n, sizeof(cl_ciphertext_t));
+    batch->public_keys = calloc(n, sizeof(cl_public_key_t));
+    batch->Qs = calloc(n, sizeof(ec_t));
+    if (batch->proofs == NULL || batch->ciphertexts == NULL || batch->public_keys == NULL || batch->Qs == NULL) {
+        RLC_THROW(ERR_NO_MEMORY);
+    }
+
+    bn_t x_bn;
+    bn_null(x_bn);
+    bn_new(x_bn);
+    for (size_t i = 0; i < n; i++) {
+        batch->public_keys[i] = (i % 2 == 0) ? pk_a : pk_b;
+
+        GEN x = randomi(params->q);
+        char *x_str = GENtostr(x);
+        bn_read_str(x_bn, x_str, strlen(x_str), 10);
+        pari_free(x_str);
+        ec_null(batch->Qs[i]);
+        ec_new(batch->Qs[i]);
+        ec_mul_gen(batch->Qs[i], x_bn);
+
+        cl_ciphertext_new(batch->ciphertexts[i]);
+        zk_proof_cldl_new(batch->proofs[i]);
+        if (cl_enc(batch->ciphertexts[i], x, batch->public_keys[i], params) != RLC_OK
+            || zk_cldl_prove(batch->proofs[i], x, batch->ciphertexts[i], batch->public_keys[i], params) != RLC_OK) {
+            bn_free(x_bn);
+            RLC_THROW(ERR_CAUGHT);
+        }
+    }
+    bn_free(x_bn);
+}
+
+static void batch_free(cldl_batch_t *batch) {
+    for (size_t i = 0; i < batch->n; i++) {
+        if (batch->proofs != NULL && batch->proofs[i] != NULL) zk_proof_cldl_free(batch->proofs[i]);
+        if (batch->ciphertexts != NULL && batch->ciphertexts[i] != NULL) cl_ciphertext_free(batch->ciphertexts[i]);
+        if (batch->Qs != NULL) {
+            ec_free(batch->Qs[i]);
+        }
+    }
+    free(batch->proofs);
+    free(batch->ciphertexts);
+    free(batch->public_keys);
+    free(batch->Qs);
+    memset(batch, 0, sizeof(*batch));
+}
+
+// 有效证明：批量验证与逐个验证都应通过，返回不符合预期的次数
+static int benchmark_valid(const cldl_batch_t *batch, const cl_params_t params) {
+    double single_total = 0, batch_total = 0;
+    int mismatches = 0;
+
+    for (int run = 0; run < BENCHMARK_RUNS; run++) {
+        double elapsed = 0;
+        int single_ok = 1;
+        {
+            START_BENCHMARK_TIMER();
+            for (size_t i = 0; i < batch->n; i++) {
+                if (zk_cldl_verify(batch->proofs[i], batch->Qs[i], batch->ciphertexts[i],
+                                   batch->public_keys[i], params) != RLC_OK) {
+                    single_ok = 0;
+                }
+            }
+            END_BENCHMARK_TIMER();
+            single_total += elapsed;
+        }
+        int batch_ok;
+        {
+            START_BENCHMARK_TIMER();
+            batch_ok = zk_cldl_verify_batch(batch->proofs, batch->Qs, batch->ciphertexts, batch->n,
+                                            batch->public_keys, params, NULL) == RLC_OK;
+            END_BENCHMARK_TIMER();
+            batch_total += elapsed;
+        }
+        if (!single_ok || !batch_ok) mismatches++;
+    }
+
+    printf("  n=%-3zu  逐个验证: %9.3f ms  批量验证: %9.3f ms  加速比: %5.2fx%s\n",
+           batch->n, single_total / BENCHMARK_RUNS, batch_total / BENCHMARK_RUNS,
+           single_total / batch_total, mismatches ? "  [有效证明未通过!]" : "");
+    return mismatches;
+}
+
+// 篡改第 bad 个证明：批量验证必须拒绝，results 中只有 bad 失败
+static int check_tampered(const cldl_batch_t *batch, size_t bad, const cl_params_t params) {
+    GEN saved_u1 = batch->proofs[bad]->u1;
+    batch->proofs[bad]->u1 = addii(saved_u1, gen_1);
+
+    int *results = calloc(batch->n, sizeof(int));
+    if (results == NULL) {
+        batch->proofs[bad]->u1 = saved_u1;
+        return 1;
+    }
+    int rc = zk_cldl_verify_batch(batch->proofs, batch->Qs, batch->ciphertexts, batch->n,
+                                  batch->public_keys, params, results);
+    batch->proofs[bad]->u1 = saved_u1;
+
+    int failures = 0;
+    if (rc == RLC_OK) {
+        printf("  [FAIL] n=%zu 篡改下标 %zu：批量验证没有拒绝\n", batch->n, bad);
+        failures++;
+    }
+    for (size_t i = 0; i < batch->n; i++) {
+        int expected = (i == bad) ? RLC_ERR : RLC_OK;
+        if (results[i] != expected) {
+            printf("  [FAIL] n=%zu 篡改下标 %zu：下标 %zu 的结果为 %s\n", batch->n, bad, i,
+                   results[i] == RLC_OK ? "通过" : "失败");
+            failures++;
+        }
+    }
+    if (failures == 0) {
+        printf("  [OK]   n=%zu 篡改下标 %zu：批量拒绝，逐个回退定位正确\n", batch->n, bad);
+    }
+    free(results);
+    return failures;
+}
+
+int main() {
+    printf("========== CLDL 批量验证测试 ==========\n");
+    printf("测试时间: %s\n", ctime(&(time_t){time(NULL)}));
+    printf("测试次数: 每个配置 %d 次\n", BENCHMARK_RUNS);
+    printf("=====================================\n");
+
+    if (init() != RLC_OK) {
+        printf("初始化失败\n");
+        return 1;
+    }
+
+    int failures = 0;
+    cl_params_t params;
+    cl_public_key_t pk_a, pk_b;
+    cldl_batch_t batch;
+    memset(&batch, 0, sizeof(batch));
+    cl_params_null(params);
+    cl_public_key_null(pk_a);
+    cl_public_key_null(pk_b);
+
+    RLC_TRY {
+        cl_params_new(params);
+        if (generate_cl_params(params) != RLC_OK) {
+            RLC_THROW(ERR_CAUGHT);
+        }
+        cl_public_key_new(pk_a);
+        cl_public_key_new(pk_b);
+        pk_a->pk = cl_gq_pow(params, randomi(params->bound));
+        pk_b->pk = cl_gq_pow(params, randomi(params->bound));
+
+        for (size_t c = 0; c < sizeof(PROOF_COUNTS) / sizeof(PROOF_COUNTS[0]); c++) {
+            pari_sp av = avma;
+            batch_prepare(&batch, PROOF_COUNTS[c], pk_a, pk_b, params);
+            failures += benchmark_valid(&batch, params);
+            // 篡改首个、末个与中间一个证明，覆盖两把公钥
+            failures += check_tampered(&batch, 0, params);
+            failures += check_tampered(&batch, batch.n - 1, params);
+            failures += check_tampered(&batch, batch.n / 2, params);
+            batch_free(&batch);
+            set_avma(av);
+        }
+    } RLC_CATCH_ANY {
+        failures++;
+    } RLC_FINALLY {
+        batch_free(&batch);
+        if (pk_a != NULL) cl_public_key_free(pk_a);
+        if (pk_b != NULL) cl_public_key_free(pk_b);
+        cl_params_free(params);
+    }
+
+    clean();
+    printf("%s（%d 项失败）\n", failures == 0 ? "全部通过" : "存在失败", failures);
+    return failures == 0 ? 0 : 1;
+}
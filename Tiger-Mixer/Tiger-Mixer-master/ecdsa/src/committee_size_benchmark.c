@@ -150,11 +150,11 @@ int create_secret_shares_dynamic_committee(const uint8_t* secret, size_t secret_
             shares[share_idx].block_index = block_idx;
             shares[share_idx].data_length = secret_len;
             shares[share_idx].block_size = block_size;
-            memset(shares[share_idx].y, 0, SHARE_SIZE);
+            memset(shares[share_idx].y, 0, sizeof(shares[share_idx].y));
             
             // 序列化分享值到y数组
             size_t share_size = bn_size_bin(share_value);
-            if (share_size + 4 > SHARE_SIZE) {
+            if (share_size > SHARE_VALUE_MAX) {
                 fprintf(stderr, "Error: Share value too large to serialize\n");
                 // 清理资源
                 for (int i = 0; i < THRESHOLD; i++) {
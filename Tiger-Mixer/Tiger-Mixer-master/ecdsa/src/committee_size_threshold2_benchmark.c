@@ -26,6 +26,15 @@
 #define MAX_COMMITTEE_SIZE 20
 #define BENCHMARK_RUNS 50
 
+// 按字节做 GF(256) 分享，每个分片保存整段秘密长度的 y（与 secret_share_t 的标量分享不同）
+#define GF256_SHARE_SIZE 100000
+
+typedef struct {
+    int x;
+    uint8_t y[GF256_SHARE_SIZE];
+    size_t data_length;
+} gf256_share_t;
+
 // 统计结构
 typedef struct {
     double min_time;
@@ -60,8 +69,8 @@ uint8_t gf256_inv(uint8_t a) {
 
 // 动态创建秘密分享函数（支持不同的委员会大小）
 int create_secret_shares_dynamic_committee(const uint8_t* secret, size_t secret_len, 
-                                         secret_share_t* shares, int committee_size, int threshold) {
-    if (secret_len > SHARE_SIZE) {
+                                         gf256_share_t* shares, int committee_size, int threshold) {
+    if (secret_len > GF256_SHARE_SIZE) {
         fprintf(stderr, "Error: Secret too large for sharing\n");
         return -1;
     }
@@ -91,7 +100,7 @@ int create_secret_shares_dynamic_committee(const uint8_t* secret, size_t secret_
 }
 
 // 动态重构秘密函数（支持不同的委员会大小，使用固定阈值）
-int reconstruct_secret_dynamic_committee(const secret_share_t* shares, int threshold, 
+int reconstruct_secret_dynamic_committee(const gf256_share_t* shares, int threshold, 
                                         uint8_t* secret, size_t* secret_len, int total_shares) {
     if (threshold <= 0 || threshold > total_shares) {
         fprintf(stderr, "Error: Invalid threshold %d (total shares: %d)\n", threshold, total_shares);
@@ -204,7 +213,7 @@ void benchmark_committee_size_reconstruction() {
         printf("\n--- 测试委员会大小: %d 个分片 (阈值=%d) ---\n", committee_size, FIXED_THRESHOLD);
         
         // 创建分片数组（根据委员会大小动态分配）
-        secret_share_t* shares = malloc(committee_size * sizeof(secret_share_t));
+        gf256_share_t* shares = malloc(committee_size * sizeof(gf256_share_t));
         if (!shares) {
             printf("错误: 无法分配分片内存\n");
             continue;
@@ -214,7 +223,7 @@ void benchmark_committee_size_reconstruction() {
         for (int i = 0; i < committee_size; i++) {
             shares[i].x = i + 1;
             shares[i].data_length = 0; // 初始化为无效
-            memset(shares[i].y, 0, SHARE_SIZE);
+            memset(shares[i].y, 0, GF256_SHARE_SIZE);
         }
         
         benchmark_stats_t reconstruction_stats = {0};
@@ -0,0 +1,300 @@
+/**
+ * 进程内 DBSCAN 聚类（k-d 树邻域索引）
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "dbscan.h"
+
+// 隐式 k-d 树：对下标数组 idx 原地划分，区间 [lo, hi) 的中点 mid 是划分点，
+// 左半区间坐标 <= 划分值，右半区间坐标 >= 划分值；split[mid] 记录划分维度。
+// remaining 记录每个子树中尚未归类的点数（内部节点存在 mid 处，叶子存在 lo 处），
+// 扩展簇时跳过已全部归类的子树，稠密簇内的扩展不再对每个核心点重复访问整个簇
+typedef struct {
+  const double *points;
+  size_t dim;
+  size_t n;
+  size_t *idx;
+  size_t *pos;          // 点 -> 在 idx 中的位置
+  size_t *remaining;
+  unsigned char *split;
+} kd_tree_t;
+
+// 半径查询的上下文：计数模式在达到 limit 时停止；扩展模式把未归类的邻居归入当前簇并压栈
+typedef struct {
+  const double *q;
+  double eps2;
+  size_t count;
+  size_t limit;
+  int *labels;        // 非 NULL 时为扩展模式
+  int cluster;
+  kd_tree_t *tree;
+  size_t *stack;
+  size_t stack_size;
+  size_t stack_capacity;
+  int failed;
+} kd_query_t;
+
+static inline double coord(const kd_tree_t *t, size_t i, size_t d) {
+  return t->points[i * t->dim + d];
+}
+
+// 三路划分的快速选择：使 idx[k] 为第 k 小（按维度 d），重复值多时不退化
+static void kd_select(kd_tree_t *t, size_t lo, size_t hi, size_t k, size_t d) {
+  size_t *idx = t->idx;
+  while (hi - lo > 1) {
+    double pivot = coord(t, idx[lo + (hi - lo) / 2], d);
+    size_t lt = lo, i = lo, gt = hi;
+    while (i < gt) {
+      double v = coord(t, idx[i], d);
+      if (v < pivot) {
+        size_t tmp = idx[lt]; idx[lt] = idx[i]; idx[i] = tmp;
+        lt++;
+        i++;
+      } else if (v > pivot) {
+        gt--;
+        size_t tmp = idx[gt]; idx[gt] = idx[i]; idx[i] = tmp;
+      } else {
+        i++;
+      }
+    }
+    if (k < lt) {
+      hi = lt;
+    } else if (k >= gt) {
+      lo = gt;
+    } else {
+      return;
+    }
+  }
+}
+
+static void kd_build(kd_tree_t *t, size_t lo, size_t hi) {
+  if (hi - lo <= DBSCAN_LEAF_SIZE) {
+    if (hi > lo) t->remaining[lo] = hi - lo;
+    return;
+  }
+
+  // 按跨度最大的维度划分
+  size_t best = 0;
+  double best_spread = -1.0;
+  for (size_t d = 0; d < t->dim; d++) {
+    double lo_v = coord(t, t->idx[lo], d), hi_v = lo_v;
+    for (size_t i = lo + 1; i < hi; i++) {
+      double v = coord(t, t->idx[i], d);
+      if (v < lo_v) lo_v = v;
+      if (v > hi_v) hi_v = v;
+    }
+    if (hi_v - lo_v > best_spread) {
+      best_spread = hi_v - lo_v;
+      best = d;
+    }
+  }
+
+  size_t mid = lo + (hi - lo) / 2;
+  kd_select(t, lo, hi, mid, best);
+  t->split[mid] = (unsigned char)best;
+  t->remaining[mid] = hi - lo;
+  kd_build(t, lo, mid);
+  kd_build(t, mid + 1, hi);
+}
+
+// 点 p 被归类：沿根到 p 的路径减少未归类计数
+static void kd_mark_labeled(kd_tree_t *t, size_t p) {
+  size_t target = t->pos[p];
+  size_t lo = 0, hi = t->n;
+  while (hi - lo > DBSCAN_LEAF_SIZE) {
+    size_t mid = lo + (hi - lo) / 2;
+    t->remaining[mid]--;
+    if (target == mid) {
+      return;
+    }
+    if (target < mid) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
+    }
+  }
+  t->remaining[lo]--;
+}
+
+// 归入当前簇并压栈等待扩展
+static int kd_assign(kd_query_t *qc, size_t p) {
+  if (qc->stack_size == qc->stack_capacity) {
+    size_t capacity = qc->stack_capacity ? qc->stack_capacity * 2 : 64;
+    size_t *grown = realloc(qc->stack, capacity * sizeof(size_t));
+    if (grown == NULL) {
+      qc->failed = 1;
+      return -1;
+    }
+    qc->stack = grown;
+    qc->stack_capacity = capacity;
+  }
+  qc->labels[p] = qc->cluster;
+  kd_mark_labeled(qc->tree, p);
+  qc->stack[qc->stack_size++] = p;
+  return 0;
+}
+
+// 检查一个点是否在邻域内；返回非 0 表示查询可以停止
+static int kd_visit(const kd_tree_t *t, kd_query_t *qc, size_t p) {
+  const double *a = qc->q;
+  const double *b = t->points + p * t->dim;
+  double dist2 = 0.0;
+  for (size_t d = 0; d < t->dim; d++) {
+    double diff = a[d] - b[d];
+    dist2 += diff * diff;
+  }
+  if (dist2 > qc->eps2) {
+    return 0;
+  }
+
+  if (qc->labels == NULL) {
+    return ++qc->count >= qc->limit;
+  }
+  // 簇内的归类顺序不影响结果：扩展期间只有当前簇在增长，
+  // sklearn 在出栈时才归类，但入栈的点最终同样归入当前簇
+  if (qc->labels[p] == DBSCAN_NOISE && kd_assign(qc, p) != 0) {
+    return 1;
+  }
+  return 0;
+}
+
+static int kd_query(const kd_tree_t *t, kd_query_t *qc, size_t lo, size_t hi) {
+  if (hi == lo || (qc->labels != NULL && t->remaining[lo + (hi - lo > DBSCAN_LEAF_SIZE ? (hi - lo) / 2 : 0)] == 0)) {
+    return 0;
+  }
+  if (hi - lo <= DBSCAN_LEAF_SIZE) {
+    for (size_t i = lo; i < hi; i++) {
+      if (kd_visit(t, qc, t->idx[i])) {
+        return 1;
+      }
+    }
+    return 0;
+  }
+
+  size_t mid = lo + (hi - lo) / 2;
+  size_t d = t->split[mid];
+  double diff = qc->q[d] - coord(t, t->idx[mid], d);
+
+  if (kd_visit(t, qc, t->idx[mid])) {
+    return 1;
+  }
+  if (diff <= 0) {
+    if (kd_query(t, qc, lo, mid)) return 1;
+    if (diff * diff <= qc->eps2 && kd_query(t, qc, mid + 1, hi)) return 1;
+  } else {
+    if (kd_query(t, qc, mid + 1, hi)) return 1;
+    if (diff * diff <= qc->eps2 && kd_query(t, qc, lo, mid)) return 1;
+  }
+  return 0;
+}
+
+int dbscan_fit(const double *points, size_t n, size_t dim, double eps, size_t min_samples, int *labels) {
+  if ((n > 0 && (points == NULL || labels == NULL)) || dim == 0 || dim > 255 || eps < 0) {
+    return -1;
+  }
+
+  kd_tree_t tree = { points, dim, n, NULL, NULL, NULL, NULL };
+  unsigned char *is_core = NULL;
+  kd_query_t qc;
+  memset(&qc, 0, sizeof(qc));
+  int n_clusters = -1;
+
+  tree.idx = malloc((n ? n : 1) * sizeof(size_t));
+  tree.pos = malloc((n ? n : 1) * sizeof(size_t));
+  tree.remaining = calloc(n ? n : 1, sizeof(size_t));
+  tree.split = calloc(n ? n : 1, 1);
+  is_core = calloc(n ? n : 1, 1);
+  if (tree.idx == NULL || tree.pos == NULL || tree.remaining == NULL || tree.split == NULL || is_core == NULL) {
+    goto cleanup;
+  }
+  for (size_t i = 0; i < n; i++) {
+    tree.idx[i] = i;
+    labels[i] = DBSCAN_NOISE;
+  }
+  kd_build(&tree, 0, n);
+  for (size_t i = 0; i < n; i++) {
+    tree.pos[tree.idx[i]] = i;
+  }
+  qc.eps2 = eps * eps;
+
+  // 第一遍：判定核心点（邻居数含自身，达到 min_samples 即停止计数）
+  for (size_t i = 0; i < n; i++) {
+    if (min_samples <= 1) {
+      is_core[i] = 1;
+      continue;
+    }
+    qc.q = points + i * dim;
+    qc.count = 0;
+    qc.limit = min_samples;
+    kd_query(&tree, &qc, 0, n);
+    is_core[i] = qc.count >= min_samples;
+  }
+
+  // 第二遍：按下标顺序从未归类的核心点扩展簇（与 sklearn 的 dbscan_inner 相同）
+  n_clusters = 0;
+  qc.labels = labels;
+  qc.tree = &tree;
+  for (size_t i = 0; i < n; i++) {
+    if (labels[i] != DBSCAN_NOISE || !is_core[i]) {
+      continue;
+    }
+    qc.cluster = n_clusters;
+    qc.stack_size = 0;
+    if (kd_assign(&qc, i) != 0) {
+      n_clusters = -1;
+      goto cleanup;
+    }
+    while (qc.stack_size > 0) {
+      size_t p = qc.stack[--qc.stack_size];
+      if (!is_core[p]) {
+        continue;  // 边界点只归类，不扩展
+      }
+      qc.q = points + p * dim;
+      kd_query(&tree, &qc, 0, n);
+      if (qc.failed) {
+        n_clusters = -1;
+        goto cleanup;
+      }
+    }
+    n_clusters++;
+  }
+
+cleanup:
+  free(qc.stack);
+  free(is_core);
+  free(tree.split);
+  free(tree.remaining);
+  free(tree.pos);
+  free(tree.idx);
+  return n_clusters;
+}
+
+int dbscan_anomaly_scores(const int *labels, size_t n, double *scores) {
+  int max_label = DBSCAN_NOISE;
+  for (size_t i = 0; i < n; i++) {
+    if (labels[i] > max_label) max_label = labels[i];
+  }
+  size_t *sizes = calloc((size_t) (max_label + 1) + 1, sizeof(size_t));
+  if (sizes == NULL) return -1;
+  for (size_t i = 0; i < n; i++) {
+    if (labels[i] >= 0) sizes[labels[i]]++;
+  }
+
+  size_t threshold = (size_t) (n * DBSCAN_SMALL_CLUSTER_RATIO);
+  if (threshold < 1) threshold = 1;
+
+  int suspicious = 0;
+  for (size_t i = 0; i < n; i++) {
+    if (labels[i] == DBSCAN_NOISE) {
+      scores[i] = DBSCAN_NOISE_SCORE;
+    } else if (labels[i] >= 0 && sizes[labels[i]] < threshold) {
+      scores[i] = DBSCAN_SMALL_CLUSTER_SCORE;
+    } else {
+      scores[i] = 0.0;
+    }
+    if (scores[i] > 0.0) suspicious++;
+  }
+  free(sizes);
+  return suspicious;
+}
@@ -0,0 +1,141 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dbscan.h"
+#include "check.h"
+
+// DBSCAN 聚类与可疑判定的对照检查：test_vectors/dbscan 下的夹具由 scripts/gen_dbscan_vectors.py
+// 生成，期望标签来自 sklearn.cluster.DBSCAN，期望异常分数按 auditor_detection 的判定规则计算。
+// 逐个比较 dbscan_fit 的簇标签、dbscan_anomaly_scores 的异常分数和可疑地址列表。
+// 用法：dbscan_vector_check [夹具目录]，任何一项不符合预期时返回非 0
+
+#define DEFAULT_VECTOR_DIR "../test_vectors/dbscan"
+#define ADDRESS_LEN 64
+
+static const char *VECTORS[] = {
+    "blobs_small.txt",
+    "blobs_kdtree.txt",
+    "duplicates.txt",
+};
+
+typedef struct {
+  size_t n;
+  size_t dim;
+  double eps;
+  size_t min_samples;
+  char (*addresses)[ADDRESS_LEN];
+  int *labels;
+  double *scores;
+  double *points;
+} dbscan_vector_t;
+
+static void vector_free(dbscan_vector_t *v) {
+  free(v->addresses);
+  free(v->labels);
+  free(v->scores);
+  free(v->points);
+}
+
+// 跳过 # 开头的注释行
+static int skip_comments(FILE *fp) {
+  int c;
+  while ((c = fgetc(fp)) == '#') {
+    while ((c = fgetc(fp)) != '\n' && c != EOF);
+  }
+  if (c == EOF) return 0;
+  ungetc(c, fp);
+  return 1;
+}
+
+static int vector_load(dbscan_vector_t *v, const char *path) {
+  memset(v, 0, sizeof(*v));
+  FILE *fp = fopen(path, "r");
+  if (fp == NULL) return 0;
+  int ok = skip_comments(fp) && fscanf(fp, "%zu %zu %lf %zu", &v->n, &v->dim, &v->eps, &v->min_samples) == 4
+           && v->n > 0 && v->dim > 0;
+  if (ok) {
+    v->addresses = calloc(v->n, ADDRESS_LEN);
+    v->labels = malloc(v->n * sizeof(int));
+    v->scores = malloc(v->n * sizeof(double));
+    v->points = malloc(v->n * v->dim * sizeof(double));
+    ok = v->addresses != NULL && v->labels != NULL && v->scores != NULL && v->points != NULL;
+  }
+  for (size_t i = 0; ok && i < v->n; i++) {
+    ok = fscanf(fp, "%63s %d %lf", v->addresses[i], &v->labels[i], &v->scores[i]) == 3;
+    for (size_t j = 0; ok && j < v->dim; j++) {
+      ok = fscanf(fp, "%lf", &v->points[i * v->dim + j]) == 1;
+    }
+  }
+  fclose(fp);
+  if (!ok) vector_free(v);
+  return ok;
+}
+
+static void check_vector(const char *dir, const char *file) {
+  char path[512], what[256];
+  dbscan_vector_t v;
+  snprintf(path, sizeof(path), "%s/%s", dir, file);
+  printf("%s:\n", file);
+  if (!vector_load(&v, path)) {
+    EXPECT(0, "读取夹具");
+    return;
+  }
+
+  int *labels = malloc(v.n * sizeof(int));
+  double *scores = malloc(v.n * sizeof(double));
+  if (labels == NULL || scores == NULL) {
+    EXPECT(0, "分配内存");
+    goto out;
+  }
+
+  int expected_clusters = 0, expected_suspicious = 0;
+  for (size_t i = 0; i < v.n; i++) {
+    if (v.labels[i] + 1 > expected_clusters) expected_clusters = v.labels[i] + 1;
+    if (v.scores[i] > 0.0) expected_suspicious++;
+  }
+
+  int n_clusters = dbscan_fit(v.points, v.n, v.dim, v.eps, v.min_samples, labels);
+  snprintf(what, sizeof(what), "%zu 个点聚为 %d 个簇（预期 %d）", v.n, n_clusters, expected_clusters);
+  EXPECT(n_clusters == expected_clusters, what);
+
+  size_t label_mismatch = 0;
+  for (size_t i = 0; i < v.n; i++) {
+    if (labels[i] != v.labels[i]) {
+      if (label_mismatch++ < 5) printf("         %s: 标签 %d，预期 %d\n", v.addresses[i], labels[i], v.labels[i]);
+    }
+  }
+  snprintf(what, sizeof(what), "簇标签与 sklearn 一致（%zu 个不符）", label_mismatch);
+  EXPECT(label_mismatch == 0, what);
+
+  // 异常分数按期望标签计算，与聚类是否一致分开判断
+  int suspicious = dbscan_anomaly_scores(v.labels, v.n, scores);
+  size_t score_mismatch = 0;
+  for (size_t i = 0; i < v.n; i++) {
+    if (scores[i] != v.scores[i]) {
+      if (score_mismatch++ < 5) printf("         %s: 异常分数 %.2f，预期 %.2f\n", v.addresses[i], scores[i], v.scores[i]);
+    }
+  }
+  snprintf(what, sizeof(what), "异常分数一致（%zu 个不符）", score_mismatch);
+  EXPECT(score_mismatch == 0, what);
+
+  // 可疑地址列表：按下标顺序取分数大于 0 的地址，与 auditor_detection 生成列表的方式相同
+  int list_ok = (suspicious == expected_suspicious);
+  for (size_t i = 0; list_ok && i < v.n; i++) {
+    list_ok = ((scores[i] > 0.0) == (v.scores[i] > 0.0));
+  }
+  snprintf(what, sizeof(what), "可疑地址列表一致（%d 个，预期 %d 个）", suspicious, expected_suspicious);
+  EXPECT(list_ok, what);
+
+out:
+  free(labels);
+  free(scores);
+  vector_free(&v);
+}
+
+int main(int argc, char *argv[]) {
+  const char *dir = (argc > 1) ? argv[1] : DEFAULT_VECTOR_DIR;
+  for (size_t i = 0; i < sizeof(VECTORS) / sizeof(VECTORS[0]); i++) {
+    check_vector(dir, VECTORS[i]);
+  }
+  return check_summary();
+}
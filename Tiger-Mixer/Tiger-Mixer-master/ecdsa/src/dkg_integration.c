@@ -1401,6 +1401,7 @@ int dkg_negotiate_cl_params(int participant_id, void *pub_socket, void *sub_sock
         params->q = gen_0;
         params->G = gen_0;
         params->g_q = gen_0;
+        params->g_q_table = NULL;
         params->bound = gen_0;
         
         if (generate_cl_params(params) != RLC_OK) {
@@ -1557,6 +1558,7 @@ int dkg_negotiate_cl_params(int participant_id, void *pub_socket, void *sub_sock
                     params->E = gen_0;
                     params->G = gen_0;
                     params->bound = gen_0;
+                    params->g_q_table = NULL;
                     avma = av;
                     
                     // 打印生成元前100字符用于对比
@@ -1595,6 +1597,7 @@ int dkg_negotiate_cl_params(int participant_id, void *pub_socket, void *sub_sock
         params->q = gen_0;
         params->G = gen_0;
         params->g_q = gen_0;
+        params->g_q_table = NULL;
         params->bound = gen_0;
         
         if (generate_cl_params(params) != RLC_OK) {
@@ -0,0 +1,1213 @@
+/**
+ * FixedMixerEscrow 合约 JSON-RPC 客户端实现
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#include <curl/curl.h>
+#include "/home/zxx/Config/relic/include/relic.h"
+#include "escrow_client.h"
+
+#define ESCROW_WORD                32
+#define ESCROW_RPC_TIMEOUT_S       30L
+#define ESCROW_KECCAK_RATE         136
+
+// 合约函数签名（选择器取 keccak256 的前 4 字节）
+#define SIG_OPEN_ESCROW    "openEscrow(bytes32,address,address,uint256,bytes32,bytes,bytes,bytes32)"
+#define SIG_CONFIRM        "confirm(bytes32,bytes32,bytes32,uint8,bytes32,bytes32,uint8,address,address)"
+#define SIG_SET_DATA_HASH  "setDataHash(bytes32,bytes32)"
+#define SIG_ESCROWS        "escrows(bytes32)"
+#define SIG_DENOMINATION   "denomination()"
+
+struct escrow_client_st {
+  CURL *curl;                   // 复用的连接（keep-alive）
+  struct curl_slist *headers;
+  pthread_mutex_t mutex;        // 串行化请求与 nonce 分配
+  char *url;
+  long next_id;
+  int local_sign;               // A2L_ESCROW_LOCAL_SIGN=1
+  uint64_t chain_id;            // 本地签名时首次使用查询，0 表示未知
+  char *response;
+  size_t response_len;
+};
+
+typedef struct {
+  uint8_t *data;
+  size_t len;
+  size_t cap;
+  int failed;
+} escrow_buf_t;
+
+static pthread_once_t shared_once = PTHREAD_ONCE_INIT;
+static escrow_client_t shared_client = NULL;
+
+/* ---------------- keccak256 ---------------- */
+
+static const uint64_t keccak_rc[24] = {
+  0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+  0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+  0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+  0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+  0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+  0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL,
+};
+static const unsigned keccak_rotc[24] = {
+  1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14, 27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44,
+};
+static const unsigned keccak_piln[24] = {
+  10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4, 15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1,
+};
+
+#define ROTL64(x, y) (((x) << (y)) | ((x) >> (64 - (y))))
+
+static void keccakf(uint64_t st[25]) {
+  uint64_t bc[5], t;
+  for (int round = 0; round < 24; round++) {
+    for (int i = 0; i < 5; i++) {
+      bc[i] = st[i] ^ st[i + 5] ^ st[i + 10] ^ st[i + 15] ^ st[i + 20];
+    }
+    for (int i = 0; i < 5; i++) {
+      t = bc[(i + 4) % 5] ^ ROTL64(bc[(i + 1) % 5], 1);
+      for (int j = 0; j < 25; j += 5) st[j + i] ^= t;
+    }
+    t = st[1];
+    for (int i = 0; i < 24; i++) {
+      unsigned j = keccak_piln[i];
+      bc[0] = st[j];
+      st[j] = ROTL64(t, keccak_rotc[i]);
+      t = bc[0];
+    }
+    for (int j = 0; j < 25; j += 5) {
+      for (int i = 0; i < 5; i++) bc[i] = st[j + i];
+      for (int i = 0; i < 5; i++) st[j + i] ^= (~bc[(i + 1) % 5]) & bc[(i + 2) % 5];
+    }
+    st[0] ^= keccak_rc[round];
+  }
+}
+
+// 以太坊使用的 Keccak-256（填充 0x01，不是 SHA3-256 的 0x06）
+void escrow_keccak256(uint8_t out[32], const uint8_t *in, size_t len) {
+  uint64_t st[25] = {0};
+  uint8_t block[ESCROW_KECCAK_RATE];
+
+  while (len >= ESCROW_KECCAK_RATE) {
+    for (size_t i = 0; i < ESCROW_KECCAK_RATE; i++) st[i / 8] ^= (uint64_t) in[i] << (8 * (i % 8));
+    keccakf(st);
+    in += ESCROW_KECCAK_RATE;
+    len -= ESCROW_KECCAK_RATE;
+  }
+  memset(block, 0, sizeof(block));
+  memcpy(block, in, len);
+  block[len] ^= 0x01;
+  block[ESCROW_KECCAK_RATE - 1] ^= 0x80;
+  for (size_t i = 0; i < ESCROW_KECCAK_RATE; i++) st[i / 8] ^= (uint64_t) block[i] << (8 * (i % 8));
+  keccakf(st);
+  for (size_t i = 0; i < 32; i++) out[i] = (uint8_t) (st[i / 8] >> (8 * (i % 8)));
+}
+
+/* ---------------- 十六进制与缓冲区 ---------------- */
+
+static int hex_value(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+static void hex_encode(char *out, const uint8_t *in, size_t len) {
+  static const char digits[] = "0123456789abcdef";
+  out[0] = '0';
+  out[1] = 'x';
+  for (size_t i = 0; i < len; i++) {
+    out[2 + 2 * i] = digits[in[i] >> 4];
+    out[3 + 2 * i] = digits[in[i] & 0x0f];
+  }
+  out[2 + 2 * len] = '\0';
+}
+
+// 0x 开头的十六进制串转成 len 字节大端数：不足左补零，过长取末尾 len 字节（与脚本的 toBytes32 一致）
+static int hex_to_fixed(uint8_t *out, size_t len, const char *hex) {
+  if (hex == NULL || hex[0] != '0' || (hex[1] != 'x' && hex[1] != 'X')) return RLC_ERR;
+  hex += 2;
+  size_t n = strlen(hex);
+  if (n == 0) return RLC_ERR;
+  for (size_t i = 0; i < n; i++) {
+    if (hex_value(hex[i]) < 0) return RLC_ERR;
+  }
+  if (n > 2 * len) {
+    hex += n - 2 * len;
+    n = 2 * len;
+  }
+  memset(out, 0, len);
+  for (size_t i = 0; i < n; i++) {
+    size_t nibble = 2 * len - n + i;
+    int v = hex_value(hex[i]);
+    out[nibble / 2] |= (uint8_t) ((nibble % 2 == 0) ? v << 4 : v);
+  }
+  return RLC_OK;
+}
+
+static int parse_address(uint8_t out[20], const char *addr) {
+  if (addr == NULL || strlen(addr) != 42) return RLC_ERR;
+  return hex_to_fixed(out, 20, addr);
+}
+
+// RPC 返回的字节串（0x 开头，偶数位）；*out 由调用方 free
+static int hex_to_bytes(uint8_t **out, size_t *len, const char *hex) {
+  if (hex == NULL || hex[0] != '0' || hex[1] != 'x') return RLC_ERR;
+  hex += 2;
+  size_t n = strlen(hex);
+  if (n % 2 != 0) return RLC_ERR;
+  *out = malloc(n / 2 + 1);
+  if (*out == NULL) return RLC_ERR;
+  for (size_t i = 0; i < n / 2; i++) {
+    int hi = hex_value(hex[2 * i]), lo = hex_value(hex[2 * i + 1]);
+    if (hi < 0 || lo < 0) {
+      free(*out);
+      *out = NULL;
+      return RLC_ERR;
+    }
+    (*out)[i] = (uint8_t) (hi << 4 | lo);
+  }
+  *len = n / 2;
+  return RLC_OK;
+}
+
+// JSON-RPC 数量：0x 开头、无前导零
+static void quantity_hex(char *out, const uint8_t *be, size_t len) {
+  while (len > 0 && be[0] == 0) {
+    be++;
+    len--;
+  }
+  if (len == 0) {
+    strcpy(out, "0x0");
+    return;
+  }
+  hex_encode(out, be, len);
+  if (out[2] == '0') memmove(out + 2, out + 3, strlen(out + 3) + 1);
+}
+
+static int parse_quantity(uint64_t *out, const char *hex) {
+  if (hex == NULL || hex[0] != '0' || hex[1] != 'x' || hex[2] == '\0' || strlen(hex) > 18) return RLC_ERR;
+  char *end = NULL;
+  *out = strtoull(hex + 2, &end, 16);
+  return (end != NULL && *end == '\0') ? RLC_OK : RLC_ERR;
+}
+
+static void buf_put(escrow_buf_t *b, const void *data, size_t len) {
+  if (b->failed) return;
+  if (b->len + len > b->cap) {
+    size_t cap = b->cap ? b->cap : 256;
+    while (cap < b->len + len) cap *= 2;
+    uint8_t *p = realloc(b->data, cap);
+    if (p == NULL) {
+      b->failed = 1;
+      return;
+    }
+    b->data = p;
+    b->cap = cap;
+  }
+  if (len > 0) memcpy(b->data + b->len, data, len);
+  b->len += len;
+}
+
+static void buf_put_byte(escrow_buf_t *b, uint8_t v) {
+  buf_put(b, &v, 1);
+}
+
+static void buf_free(escrow_buf_t *b) {
+  free(b->data);
+  memset(b, 0, sizeof(*b));
+}
+
+/* ---------------- ABI 编码 ---------------- */
+
+void escrow_selector(uint8_t out[4], const char *signature) {
+  uint8_t h[32];
+  escrow_keccak256(h, (const uint8_t *) signature, strlen(signature));
+  memcpy(out, h, 4);
+}
+
+static void abi_selector(escrow_buf_t *b, const char *signature) {
+  uint8_t selector[4];
+  escrow_selector(selector, signature);
+  buf_put(b, selector, sizeof(selector));
+}
+
+static void abi_put_uint(escrow_buf_t *b, uint64_t v) {
+  uint8_t word[ESCROW_WORD] = {0};
+  for (int i = 0; i < 8; i++) word[ESCROW_WORD - 1 - i] = (uint8_t) (v >> (8 * i));
+  buf_put(b, word, sizeof(word));
+}
+
+// 右对齐放入一个字（address、bytes32 均适用）
+static void abi_put_right(escrow_buf_t *b, const uint8_t *data, size_t len) {
+  uint8_t word[ESCROW_WORD] = {0};
+  memcpy(word + ESCROW_WORD - len, data, len);
+  buf_put(b, word, sizeof(word));
+}
+
+static void abi_put_bn(escrow_buf_t *b, const bn_t v) {
+  uint8_t word[ESCROW_WORD];
+  bn_write_bin(word, ESCROW_WORD, v);
+  buf_put(b, word, sizeof(word));
+}
+
+// 动态 bytes 的尾部：长度字 + 右补零到整字
+static void abi_put_bytes_tail(escrow_buf_t *b, const uint8_t *data, size_t len) {
+  static const uint8_t zero[ESCROW_WORD] = {0};
+  abi_put_uint(b, len);
+  buf_put(b, data, len);
+  buf_put(b, zero, (ESCROW_WORD - len % ESCROW_WORD) % ESCROW_WORD);
+}
+
+static size_t abi_tail_size(size_t len) {
+  return ESCROW_WORD + (len + ESCROW_WORD - 1) / ESCROW_WORD * ESCROW_WORD;
+}
+
+static const uint8_t *abi_word(const uint8_t *data, size_t len, size_t index) {
+  return (index + 1) * ESCROW_WORD <= len ? data + index * ESCROW_WORD : NULL;
+}
+
+static int abi_word_u64(uint64_t *out, const uint8_t *word) {
+  if (word == NULL) return RLC_ERR;
+  for (int i = 0; i < ESCROW_WORD - 8; i++) {
+    if (word[i] != 0) return RLC_ERR;
+  }
+  *out = 0;
+  for (int i = ESCROW_WORD - 8; i < ESCROW_WORD; i++) *out = *out << 8 | word[i];
+  return RLC_OK;
+}
+
+// 取返回数据中第 index 个头部字指向的动态 bytes
+static int abi_read_bytes(const uint8_t **out, size_t *out_len, const uint8_t *data, size_t len, size_t index) {
+  uint64_t offset, n;
+  if (abi_word_u64(&offset, abi_word(data, len, index)) != RLC_OK || offset % ESCROW_WORD != 0) return RLC_ERR;
+  if (abi_word_u64(&n, abi_word(data, len, offset / ESCROW_WORD)) != RLC_OK) return RLC_ERR;
+  if (offset + ESCROW_WORD + n > len) return RLC_ERR;
+  *out = data + offset + ESCROW_WORD;
+  *out_len = n;
+  return RLC_OK;
+}
+
+/* ---------------- RLP 编码（EIP-155 交易） ---------------- */
+
+static void rlp_put_header(escrow_buf_t *b, uint8_t short_base, size_t len) {
+  if (len <= 55) {
+    buf_put_byte(b, (uint8_t) (short_base + len));
+    return;
+  }
+  uint8_t be[sizeof(size_t)];
+  size_t n = 0;
+  for (size_t v = len; v > 0; v >>= 8) n++;
+  for (size_t i = 0; i < n; i++) be[i] = (uint8_t) (len >> (8 * (n - 1 - i)));
+  buf_put_byte(b, (uint8_t) (short_base + 55 + n));
+  buf_put(b, be, n);
+}
+
+static void rlp_put_string(escrow_buf_t *b, const uint8_t *data, size_t len) {
+  if (len == 1 && data[0] < 0x80) {
+    buf_put_byte(b, data[0]);
+    return;
+  }
+  rlp_put_header(b, 0x80, len);
+  buf_put(b, data, len);
+}
+
+// 整数按最短大端编码，0 为空串
+static void rlp_put_be(escrow_buf_t *b, const uint8_t *be, size_t len) {
+  while (len > 0 && be[0] == 0) {
+    be++;
+    len--;
+  }
+  rlp_put_string(b, be, len);
+}
+
+static void rlp_put_uint(escrow_buf_t *b, uint64_t v) {
+  uint8_t be[8];
+  for (int i = 0; i < 8; i++) be[i] = (uint8_t) (v >> (8 * (7 - i)));
+  rlp_put_be(b, be, sizeof(be));
+}
+
+static void rlp_put_bn(escrow_buf_t *b, const bn_t v) {
+  uint8_t be[ESCROW_WORD];
+  bn_write_bin(be, sizeof(be), v);
+  rlp_put_be(b, be, sizeof(be));
+}
+
+static void rlp_wrap_list(escrow_buf_t *out, const escrow_buf_t *items) {
+  rlp_put_header(out, 0xc0, items->len);
+  buf_put(out, items->data, items->len);
+}
+
+/* ---------------- ECDSA 公钥恢复 ---------------- */
+
+static void pubkey_address(uint8_t addr[20], const uint8_t key[ESCROW_PUBKEY_LEN]) {
+  uint8_t h[32];
+  escrow_keccak256(h, key + 1, ESCROW_PUBKEY_LEN - 1);
+  memcpy(addr, h + 12, 20);
+}
+
+// 由 (r, s, recid) 恢复签名公钥：Q = r^-1 (sR - eG)，R 的横坐标为 r、纵坐标奇偶为 recid
+static int ecdsa_recover(ec_t q, const uint8_t hash[32], const bn_t r, const bn_t s, int recid) {
+  int result_status = RLC_OK;
+  uint8_t packed[1 + RLC_FP_BYTES];
+  bn_t n, e, rinv, u1, u2;
+  ec_t point;
+
+  bn_null(n);
+  bn_null(e);
+  bn_null(rinv);
+  bn_null(u1);
+  bn_null(u2);
+  ec_null(point);
+
+  RLC_TRY {
+    bn_new(n);
+    bn_new(e);
+    bn_new(rinv);
+    bn_new(u1);
+    bn_new(u2);
+    ec_new(point);
+
+    ec_curve_get_ord(n);
+    if (bn_is_zero(r) || bn_cmp(r, n) != RLC_LT || bn_is_zero(s) || bn_cmp(s, n) != RLC_LT) {
+      RLC_THROW(ERR_CAUGHT);
+    }
+
+    packed[0] = 0x02;
+    bn_write_bin(packed + 1, RLC_FP_BYTES, r);
+    ec_read_bin(point, packed, sizeof(packed));
+    // RELIC 解压时按 y 的 Montgomery 内部表示取最低位，不是 SEC1 的 y 奇偶；这里按 y 的真实值选取
+    fp_prime_back(e, point->y);
+    if (bn_is_even(e) == (recid & 1)) {
+      ec_neg(point, point);
+    }
+
+    bn_read_bin(e, hash, 32);
+    bn_mod(e, e, n);
+    bn_mod_inv(rinv, r, n);
+    bn_mul(u1, e, rinv);
+    bn_mod(u1, u1, n);
+    if (!bn_is_zero(u1)) bn_sub(u1, n, u1);
+    bn_mul(u2, s, rinv);
+    bn_mod(u2, u2, n);
+
+    ec_mul_sim_gen(q, u1, point, u2);
+    ec_norm(q, q);
+    if (ec_is_infty(q)) {
+      RLC_THROW(ERR_CAUGHT);
+    }
+  } RLC_CATCH_ANY {
+    result_status = RLC_ERR;
+  } RLC_FINALLY {
+    bn_free(n);
+    bn_free(e);
+    bn_free(rinv);
+    bn_free(u1);
+    bn_free(u2);
+    ec_free(point);
+  }
+  return result_status;
+}
+
+// 找出使签名恢复出 expected 的 recid（0/1），都不匹配返回 -1
+static int ecdsa_recid(const uint8_t hash[32], const bn_t r, const bn_t s, const ec_t expected) {
+  int recid = -1;
+  ec_t q;
+  ec_null(q);
+  ec_new(q);
+  for (int id = 0; id < 2 && recid < 0; id++) {
+    if (ecdsa_recover(q, hash, r, s, id) == RLC_OK && ec_cmp(q, expected) == RLC_EQ) {
+      recid = id;
+    }
+  }
+  ec_free(q);
+  return recid;
+}
+
+// 以太坊只接受低 s
+static void normalize_low_s(bn_t s) {
+  bn_t n, half;
+  bn_null(n);
+  bn_null(half);
+  RLC_TRY {
+    bn_new(n);
+    bn_new(half);
+    ec_curve_get_ord(n);
+    bn_hlv(half, n);
+    if (bn_cmp(s, half) == RLC_GT) {
+      bn_sub(s, n, s);
+    }
+  } RLC_CATCH_ANY {
+    RLC_THROW(ERR_CAUGHT);
+  } RLC_FINALLY {
+    bn_free(n);
+    bn_free(half);
+  }
+}
+
+/* ---------------- EIP-155 交易 ---------------- */
+
+// [nonce, gasPrice, gas, to, value, data]，签名时之后附 [chainId, 0, 0]，发送时附 [v, r, s]
+static void tx_put_fields(escrow_buf_t *items, const escrow_tx_t *tx) {
+  rlp_put_uint(items, tx->nonce);
+  rlp_put_uint(items, tx->gas_price);
+  rlp_put_uint(items, tx->gas);
+  rlp_put_string(items, tx->to, sizeof(tx->to));
+  rlp_put_be(items, tx->value, sizeof(tx->value));
+  rlp_put_string(items, tx->data, tx->data_len);
+}
+
+int escrow_tx_signing_hash(uint8_t digest[32], const escrow_tx_t *tx) {
+  escrow_buf_t items = {0}, unsigned_tx = {0};
+  int result_status = RLC_ERR;
+
+  tx_put_fields(&items, tx);
+  rlp_put_uint(&items, tx->chain_id);
+  rlp_put_uint(&items, 0);
+  rlp_put_uint(&items, 0);
+  rlp_wrap_list(&unsigned_tx, &items);
+  if (!items.failed && !unsigned_tx.failed) {
+    escrow_keccak256(digest, unsigned_tx.data, unsigned_tx.len);
+    result_status = RLC_OK;
+  }
+  buf_free(&items);
+  buf_free(&unsigned_tx);
+  return result_status;
+}
+
+int escrow_tx_encode_signed(uint8_t **out, size_t *out_len, const escrow_tx_t *tx,
+                            const bn_t r, const bn_t s, const ec_t pk) {
+  int result_status = RLC_OK;
+  uint8_t digest[32];
+  escrow_buf_t items = {0}, signed_tx = {0};
+  bn_t low_s;
+
+  *out = NULL;
+  *out_len = 0;
+  bn_null(low_s);
+
+  RLC_TRY {
+    bn_new(low_s);
+    if (escrow_tx_signing_hash(digest, tx) != RLC_OK) {
+      RLC_THROW(ERR_NO_MEMORY);
+    }
+    bn_copy(low_s, s);
+    normalize_low_s(low_s);
+    const int recid = ecdsa_recid(digest, r, low_s, pk);
+    if (recid < 0) {
+      printf("[ESCROW] 交易签名与发送方公钥不匹配\n");
+      RLC_THROW(ERR_CAUGHT);
+    }
+
+    tx_put_fields(&items, tx);
+    rlp_put_uint(&items, tx->chain_id * 2 + 35 + (uint64_t) recid);
+    rlp_put_bn(&items, r);
+    rlp_put_bn(&items, low_s);
+    rlp_wrap_list(&signed_tx, &items);
+    if (items.failed || signed_tx.failed) RLC_THROW(ERR_NO_MEMORY);
+
+    // 所有权交给调用方
+    *out = signed_tx.data;
+    *out_len = signed_tx.len;
+    signed_tx.data = NULL;
+  } RLC_CATCH_ANY {
+    result_status = RLC_ERR;
+  } RLC_FINALLY {
+    buf_free(&items);
+    buf_free(&signed_tx);
+    bn_free(low_s);
+  }
+  return result_status;
+}
+
+/* ---------------- JSON ---------------- */
+
+// 返回 JSON 值之后的位置，格式错误返回 NULL
+static const char *json_value_end(const char *p) {
+  if (*p == '"') {
+    for (p++; *p != '\0'; p++) {
+      if (*p == '\\' && p[1] != '\0') p++;
+      else if (*p == '"') return p + 1;
+    }
+    return NULL;
+  }
+  if (*p == '{' || *p == '[') {
+    int depth = 0;
+    for (; *p != '\0'; p++) {
+      if (*p == '"') {
+        p = json_value_end(p);
+        if (p == NULL) return NULL;
+        p--;
+      } else if (*p == '{' || *p == '[') {
+        depth++;
+      } else if (*p == '}' || *p == ']') {
+        if (--depth == 0) return p + 1;
+      }
+    }
+    return NULL;
+  }
+  while (*p != '\0' && *p != ',' && *p != '}' && *p != ']' && *p != ' ' && *p != '\n' && *p != '\r') p++;
+  return p;
+}
+
+// 在 JSON 文本中取 "key": 之后的值（原样），找不到返回 NULL；结果由调用方 free
+static char *json_field(const char *json, const char *key) {
+  char pattern[64];
+  snprintf(pattern, sizeof(pattern), "\"%s\"", key);
+  const char *p = strstr(json, pattern);
+  if (p == NULL) return NULL;
+  p += strlen(pattern);
+  while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r') p++;
+  if (*p++ != ':') return NULL;
+  while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r') p++;
+  const char *end = json_value_end(p);
+  if (end == NULL) return NULL;
+  // 字符串去掉引号（RPC 返回的字符串都是十六进制，不含转义）
+  if (*p == '"') {
+    p++;
+    end--;
+  }
+  char *value = malloc((size_t) (end - p) + 1);
+  if (value == NULL) return NULL;
+  memcpy(value, p, (size_t) (end - p));
+  value[end - p] = '\0';
+  return value;
+}
+
+/* ---------------- JSON-RPC ---------------- */
+
+static size_t rpc_write(void *contents, size_t size, size_t nmemb, void *userp) {
+  escrow_client_t client = (escrow_client_t) userp;
+  size_t total = size * nmemb;
+  char *p = realloc(client->response, client->response_len + total + 1);
+  if (p == NULL) return 0;
+  client->response = p;
+  memcpy(client->response + client->response_len, contents, total);
+  client->response_len += total;
+  client->response[client->response_len] = '\0';
+  return total;
+}
+
+// 调用方持有锁；*result 为 result 字段的值（字符串去引号，null 为 "null"），由调用方 free
+static int rpc_call(escrow_client_t client, const char *method, const char *params, char **result) {
+  *result = NULL;
+  size_t body_len = strlen(method) + strlen(params) + 96;
+  char *body = malloc(body_len);
+  if (body == NULL) return RLC_ERR;
+  snprintf(body, body_len, "{\"jsonrpc\":\"2.0\",\"id\":%ld,\"method\":\"%s\",\"params\":%s}",
+           client->next_id++, method, params);
+
+  client->response_len = 0;
+  if (client->response != NULL) client->response[0] = '\0';
+  curl_easy_setopt(client->curl, CURLOPT_POSTFIELDS, body);
+  curl_easy_setopt(client->curl, CURLOPT_POSTFIELDSIZE, (long) strlen(body));
+  CURLcode res = curl_easy_perform(client->curl);
+  free(body);
+
+  if (res != CURLE_OK) {
+    printf("[ESCROW] RPC %s 请求失败: %s\n", method, curl_easy_strerror(res));
+    return RLC_ERR;
+  }
+  if (client->response == NULL || client->response_len == 0) {
+    printf("[ESCROW] RPC %s 无响应\n", method);
+    return RLC_ERR;
+  }
+
+  char *error = json_field(client->response, "error");
+  if (error != NULL) {
+    char *message = json_field(error, "message");
+    printf("[ESCROW] RPC %s 返回错误: %s\n", method, message != NULL ? message : error);
+    free(message);
+    free(error);
+    return RLC_ERR;
+  }
+  *result = json_field(client->response, "result");
+  if (*result == NULL) {
+    printf("[ESCROW] RPC %s 响应无法解析: %s\n", method, client->response);
+    return RLC_ERR;
+  }
+  return RLC_OK;
+}
+
+static int rpc_eth_call(escrow_client_t client, const char *to, const escrow_buf_t *call,
+                        uint8_t **out, size_t *out_len) {
+  char *data_hex = malloc(2 * call->len + 3);
+  if (data_hex == NULL) return RLC_ERR;
+  hex_encode(data_hex, call->data, call->len);
+  size_t params_len = strlen(data_hex) + 128;
+  char *params = malloc(params_len);
+  if (params == NULL) {
+    free(data_hex);
+    return RLC_ERR;
+  }
+  snprintf(params, params_len, "[{\"to\":\"%s\",\"data\":\"%s\"},\"latest\"]", to, data_hex);
+  free(data_hex);
+
+  char *result = NULL;
+  int result_status = rpc_call(client, "eth_call", params, &result);
+  free(params);
+  if (result_status == RLC_OK) {
+    result_status = hex_to_bytes(out, out_len, result);
+  }
+  free(result);
+  return result_status;
+}
+
+static int rpc_quantity(escrow_client_t client, const char *method, const char *params, uint64_t *out) {
+  char *result = NULL;
+  int result_status = rpc_call(client, method, params, &result);
+  if (result_status == RLC_OK) {
+    result_status = parse_quantity(out, result);
+  }
+  free(result);
+  return result_status;
+}
+
+// 调用方持有锁；每次查询回执时持有锁，两次查询之间释放锁，
+// 等待回执（可能长达 ESCROW_CLIENT_RECEIPT_TIMEOUT_MS）期间其它线程的请求不会被阻塞
+static int wait_receipt(escrow_client_t client, const char *tx_hash) {
+  char params[96];
+  snprintf(params, sizeof(params), "[\"%s\"]", tx_hash);
+  struct timespec poll = { ESCROW_CLIENT_RECEIPT_POLL_MS / 1000, (ESCROW_CLIENT_RECEIPT_POLL_MS % 1000) * 1000000L };
+
+  for (long waited = 0; waited <= ESCROW_CLIENT_RECEIPT_TIMEOUT_MS; waited += ESCROW_CLIENT_RECEIPT_POLL_MS) {
+    char *receipt = NULL;
+    if (rpc_call(client, "eth_getTransactionReceipt", params, &receipt) != RLC_OK) return RLC_ERR;
+    if (strcmp(receipt, "null") != 0) {
+      char *status = json_field(receipt, "status");
+      int ok = (status == NULL || strcmp(status, "0x1") == 0);
+      if (!ok) printf("[ESCROW] 交易 %s 执行失败（revert），status=%s\n", tx_hash, status);
+      free(status);
+      free(receipt);
+      return ok ? RLC_OK : RLC_ERR;
+    }
+    free(receipt);
+    pthread_mutex_unlock(&client->mutex);
+    nanosleep(&poll, NULL);
+    pthread_mutex_lock(&client->mutex);
+  }
+  printf("[ESCROW] 等待交易 %s 回执超时\n", tx_hash);
+  return RLC_ERR;
+}
+
+static int copy_tx_hash(char tx_hash[ESCROW_HASH_STR_LEN], const char *result) {
+  if (result == NULL || strlen(result) != ESCROW_HASH_STR_LEN - 1) return RLC_ERR;
+  memcpy(tx_hash, result, ESCROW_HASH_STR_LEN);
+  return RLC_OK;
+}
+
+// 节点已解锁账户发送
+static int send_unlocked(escrow_client_t client, const char *to, const char *data_hex, const char *value,
+                         const char *from, char tx_hash[ESCROW_HASH_STR_LEN]) {
+  uint8_t from_bin[20];
+  if (parse_address(from_bin, from) != RLC_OK) {
+    printf("[ESCROW] 发送方地址无效: %s\n", from != NULL ? from : "(null)");
+    return RLC_ERR;
+  }
+  size_t params_len = strlen(data_hex) + 256;
+  char *params = malloc(params_len);
+  if (params == NULL) return RLC_ERR;
+  snprintf(params, params_len,
+           "[{\"from\":\"%s\",\"to\":\"%s\",\"gas\":\"0x%x\",\"gasPrice\":\"0x%x\",\"value\":\"%s\",\"data\":\"%s\"}]",
+           from, to, ESCROW_CLIENT_GAS, ESCROW_CLIENT_GAS_PRICE, value, data_hex);
+  char *result = NULL;
+  int result_status = rpc_call(client, "eth_sendTransaction", params, &result);
+  free(params);
+  if (result_status == RLC_OK) result_status = copy_tx_hash(tx_hash, result);
+  free(result);
+  return result_status;
+}
+
+static int send_raw(escrow_client_t client, const uint8_t *raw, size_t raw_len, char tx_hash[ESCROW_HASH_STR_LEN]) {
+  char *raw_hex = malloc(2 * raw_len + 3);
+  char *params = malloc(2 * raw_len + 8);
+  char *result = NULL;
+  int result_status = RLC_ERR;
+  if (raw_hex != NULL && params != NULL) {
+    hex_encode(raw_hex, raw, raw_len);
+    snprintf(params, 2 * raw_len + 8, "[\"%s\"]", raw_hex);
+    if (rpc_call(client, "eth_sendRawTransaction", params, &result) == RLC_OK) {
+      result_status = copy_tx_hash(tx_hash, result);
+    }
+  }
+  free(result);
+  free(params);
+  free(raw_hex);
+  return result_status;
+}
+
+// 本地签名 EIP-155 交易后发送
+static int send_signed(escrow_client_t client, const uint8_t to[20], const escrow_buf_t *data,
+                       const uint8_t value[ESCROW_WORD], const bn_t sk, char tx_hash[ESCROW_HASH_STR_LEN]) {
+  int result_status = RLC_OK;
+  uint8_t key[ESCROW_PUBKEY_LEN], from[20], digest[32];
+  uint8_t *raw = NULL;
+  size_t raw_len = 0;
+  char from_hex[ESCROW_ADDRESS_STR_LEN], params[96];
+  escrow_tx_t tx;
+  bn_t r, s;
+  ec_t pk;
+
+  bn_null(r);
+  bn_null(s);
+  ec_null(pk);
+
+  RLC_TRY {
+    bn_new(r);
+    bn_new(s);
+    ec_new(pk);
+
+    ec_mul_gen(pk, sk);
+    ec_norm(pk, pk);
+    ec_write_bin(key, sizeof(key), pk, 0);
+    pubkey_address(from, key);
+    hex_encode(from_hex, from, sizeof(from));
+
+    memset(&tx, 0, sizeof(tx));
+    if (client->chain_id == 0 && rpc_quantity(client, "eth_chainId", "[]", &client->chain_id) != RLC_OK) {
+      RLC_THROW(ERR_CAUGHT);
+    }
+    snprintf(params, sizeof(params), "[\"%s\",\"pending\"]", from_hex);
+    if (rpc_quantity(client, "eth_getTransactionCount", params, &tx.nonce) != RLC_OK) {
+      RLC_THROW(ERR_CAUGHT);
+    }
+    tx.gas_price = ESCROW_CLIENT_GAS_PRICE;
+    tx.gas = ESCROW_CLIENT_GAS;
+    memcpy(tx.to, to, sizeof(tx.to));
+    memcpy(tx.value, value, sizeof(tx.value));
+    tx.data = data->data;
+    tx.data_len = data->len;
+    tx.chain_id = client->chain_id;
+
+    if (escrow_tx_signing_hash(digest, &tx) != RLC_OK) {
+      RLC_THROW(ERR_NO_MEMORY);
+    }
+    if (cp_ecdsa_sig(r, s, digest, sizeof(digest), 1, sk) != RLC_OK) {
+      RLC_THROW(ERR_CAUGHT);
+    }
+    if (escrow_tx_encode_signed(&raw, &raw_len, &tx, r, s, pk) != RLC_OK) {
+      RLC_THROW(ERR_CAUGHT);
+    }
+    if (send_raw(client, raw, raw_len, tx_hash) != RLC_OK) {
+      RLC_THROW(ERR_CAUGHT);
+    }
+  } RLC_CATCH_ANY {
+    result_status = RLC_ERR;
+  } RLC_FINALLY {
+    free(raw);
+    bn_free(r);
+    bn_free(s);
+    ec_free(pk);
+  }
+  return result_status;
+}
+
+// 调用方持有锁：发送一笔合约调用并等待回执（等待期间会暂时释放锁，见 wait_receipt）
+static int send_transaction(escrow_client_t client, const char *to, const escrow_buf_t *data,
+                            const uint8_t value[ESCROW_WORD], const char *from, const bn_t sk,
+                            char tx_hash[ESCROW_HASH_STR_LEN]) {
+  uint8_t to_bin[20];
+  int result_status;
+
+  if (data->failed || parse_address(to_bin, to) != RLC_OK) return RLC_ERR;
+  if (client->local_sign && sk != NULL) {
+    result_status = send_signed(client, to_bin, data, value, sk, tx_hash);
+  } else {
+    char value_hex[2 * ESCROW_WORD + 3];
+    char *data_hex = malloc(2 * data->len + 3);
+    if (data_hex == NULL) return RLC_ERR;
+    quantity_hex(value_hex, value, ESCROW_WORD);
+    hex_encode(data_hex, data->data, data->len);
+    result_status = send_unlocked(client, to, data_hex, value_hex, from, tx_hash);
+    free(data_hex);
+  }
+  if (result_status != RLC_OK) return RLC_ERR;
+  printf("[ESCROW] 交易已发送: %s\n", tx_hash);
+  return wait_receipt(client, tx_hash);
+}
+
+/* ---------------- 地址簿与 deposit 记录 ---------------- */
+
+static char *read_file(const char *path) {
+  FILE *fp = fopen(path, "r");
+  if (fp == NULL) return NULL;
+  char *content = NULL;
+  size_t len = 0, cap = 0;
+  char chunk[4096];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), fp)) > 0) {
+    if (len + n + 1 > cap) {
+      cap = (len + n + 1) * 2;
+      char *p = realloc(content, cap);
+      if (p == NULL) {
+        free(content);
+        fclose(fp);
+        return NULL;
+      }
+      content = p;
+    }
+    memcpy(content + len, chunk, n);
+    len += n;
+  }
+  fclose(fp);
+  if (content == NULL) content = calloc(1, 1);
+  else content[len] = '\0';
+  return content;
+}
+
+int escrow_pool_address(char out[ESCROW_ADDRESS_STR_LEN], const char *pool_label) {
+  uint8_t check[20];
+  const char *book_path = getenv("A2L_ESCROW_ADDRESS_BOOK");
+  if (book_path == NULL || book_path[0] == '\0') book_path = ESCROW_CLIENT_ADDRESS_BOOK;
+  char *book = read_file(book_path);
+  if (book == NULL) {
+    printf("[ESCROW] 地址簿不存在: %s\n", book_path);
+    return RLC_ERR;
+  }
+  char *pools = json_field(book, "pools");
+  free(book);
+  if (pools == NULL) return RLC_ERR;
+
+  // 兼容 0.1 与 0_1；找不到时退回 0_1 池（与脚本一致）
+  const char *label = (pool_label != NULL && strcmp(pool_label, "0_1") == 0) ? "0.1" : pool_label;
+  char *addr = (label != NULL) ? json_field(pools, label) : NULL;
+  if (addr == NULL) addr = json_field(pools, "0_1");
+  free(pools);
+
+  int result_status = RLC_ERR;
+  if (addr != NULL && parse_address(check, addr) == RLC_OK) {
+    memcpy(out, addr, ESCROW_ADDRESS_STR_LEN);
+    result_status = RLC_OK;
+  } else {
+    printf("[ESCROW] 地址簿中没有池: %s\n", pool_label != NULL ? pool_label : "(null)");
+  }
+  free(addr);
+  return result_status;
+}
+
+// 追加到 JSON 数组文件（已存在则跳过），格式与 JSON.stringify(arr, null, 2) 相同
+static void record_deposit_tx(const char *tx_hash) {
+  char *content = read_file(ESCROW_CLIENT_DEPOSIT_TX_FILE);
+  if (content != NULL && strstr(content, tx_hash) != NULL) {
+    free(content);
+    return;
+  }
+  char *close = (content != NULL) ? strrchr(content, ']') : NULL;
+  FILE *fp = fopen(ESCROW_CLIENT_DEPOSIT_TX_FILE, "w");
+  if (fp == NULL) {
+    printf("[ESCROW] Warning: 无法写入 %s\n", ESCROW_CLIENT_DEPOSIT_TX_FILE);
+    free(content);
+    return;
+  }
+  if (close != NULL && strchr(content, '"') != NULL && strchr(content, '"') < close) {
+    // 去掉 ']' 前的空白，接在最后一项之后
+    char *end = close;
+    while (end > content && (end[-1] == ' ' || end[-1] == '\n' || end[-1] == '\r' || end[-1] == '\t')) end--;
+    fwrite(content, 1, (size_t) (end - content), fp);
+    fprintf(fp, ",\n  \"%s\"\n]", tx_hash);
+  } else {
+    fprintf(fp, "[\n  \"%s\"\n]", tx_hash);
+  }
+  fclose(fp);
+  printf("[DEPOSIT] Saved txHash to deposit_tx_hashes.json: %s\n", tx_hash);
+  free(content);
+}
+
+/* ---------------- 客户端 ---------------- */
+
+escrow_client_t escrow_client_new(const char *rpc_url) {
+  if (rpc_url == NULL) rpc_url = getenv("A2L_ESCROW_RPC");
+  if (rpc_url == NULL || rpc_url[0] == '\0') rpc_url = ESCROW_CLIENT_DEFAULT_RPC;
+
+  escrow_client_t client = calloc(1, sizeof(struct escrow_client_st));
+  if (client == NULL) return NULL;
+  // 先初始化互斥锁：之后任何失败路径都经 escrow_client_free 销毁它
+  pthread_mutex_init(&client->mutex, NULL);
+  client->url = strdup(rpc_url);
+  client->curl = curl_easy_init();
+  client->headers = curl_slist_append(NULL, "Content-Type: application/json");
+  if (client->url == NULL || client->curl == NULL || client->headers == NULL) {
+    escrow_client_free(client);
+    return NULL;
+  }
+  client->next_id = 1;
+  const char *local_sign = getenv("A2L_ESCROW_LOCAL_SIGN");
+  client->local_sign = (local_sign != NULL && strcmp(local_sign, "1") == 0);
+
+  curl_easy_setopt(client->curl, CURLOPT_URL, client->url);
+  curl_easy_setopt(client->curl, CURLOPT_HTTPHEADER, client->headers);
+  curl_easy_setopt(client->curl, CURLOPT_WRITEFUNCTION, rpc_write);
+  curl_easy_setopt(client->curl, CURLOPT_WRITEDATA, client);
+  curl_easy_setopt(client->curl, CURLOPT_TIMEOUT, ESCROW_RPC_TIMEOUT_S);
+  curl_easy_setopt(client->curl, CURLOPT_NOSIGNAL, 1L);
+  curl_easy_setopt(client->curl, CURLOPT_TCP_KEEPALIVE, 1L);
+
+  printf("[ESCROW] JSON-RPC 客户端: %s（%s）\n", client->url,
+         client->local_sign ? "本地签名" : "节点账户发送");
+  return client;
+}
+
+void escrow_client_free(escrow_client_t client) {
+  if (client == NULL) return;
+  if (client->curl != NULL) curl_easy_cleanup(client->curl);
+  pthread_mutex_destroy(&client->mutex);
+  curl_slist_free_all(client->headers);
+  free(client->response);
+  free(client->url);
+  free(client);
+}
+
+static void shared_init(void) {
+  curl_global_init(CURL_GLOBAL_DEFAULT);
+  shared_client = escrow_client_new(NULL);
+}
+
+escrow_client_t escrow_client_shared(void) {
+  pthread_once(&shared_once, shared_init);
+  return shared_client;
+}
+
+void escrow_client_shared_close(void) {
+  escrow_client_free(shared_client);
+  shared_client = NULL;
+}
+
+int escrow_open(escrow_client_t client, const escrow_open_args_t *args, const char *from, const bn_t sk,
+                char tx_hash[ESCROW_HASH_STR_LEN]) {
+  uint8_t escrow_id[32], meta[32], commitment[32], party1[20], party2[20];
+  char contract[ESCROW_ADDRESS_STR_LEN], params[64];
+  uint8_t *denom = NULL;
+  size_t denom_len = 0;
+  char *block = NULL, *timestamp = NULL;
+  escrow_buf_t call = {0};
+  int result_status = RLC_ERR;
+
+  if (client == NULL || args == NULL) return RLC_ERR;
+  if (hex_to_fixed(escrow_id, sizeof(escrow_id), args->escrow_id) != RLC_OK
+   || hex_to_fixed(meta, sizeof(meta), args->meta_hash) != RLC_OK
+   || parse_address(party1, args->party1) != RLC_OK
+   || parse_address(party2, args->party2) != RLC_OK) {
+    printf("[ESCROW] openEscrow 参数无效\n");
+    return RLC_ERR;
+  }
+  if (args->commitment == NULL || strlen(args->commitment) != ESCROW_HASH_STR_LEN - 1
+   || hex_to_fixed(commitment, sizeof(commitment), args->commitment) != RLC_OK) {
+    printf("[ESCROW] invalid commitment (must be 0x + 64 hex chars)\n");
+    return RLC_ERR;
+  }
+  if (args->party1_key[0] != 0x04 || args->party2_key[0] != 0x04) {
+    printf("[ESCROW] uncompressed pubkey must start with 0x04\n");
+    return RLC_ERR;
+  }
+  if (escrow_pool_address(contract, args->pool_label) != RLC_OK) return RLC_ERR;
+
+  pthread_mutex_lock(&client->mutex);
+
+  // 截止时间不晚于链上时间 + 5 秒时改为链上时间 + 3600
+  long deadline = args->deadline;
+  uint64_t chain_now = 0;
+  snprintf(params, sizeof(params), "[\"latest\",false]");
+  if (rpc_call(client, "eth_getBlockByNumber", params, &block) != RLC_OK
+   || (timestamp = json_field(block, "timestamp")) == NULL
+   || parse_quantity(&chain_now, timestamp) != RLC_OK) {
+    goto done;
+  }
+  if (!(deadline > (long) chain_now + 5)) {
+    printf("[ESCROW] Adjust deadline: input=%ld, chainNow=%llu -> use %llu\n",
+           deadline, (unsigned long long) chain_now, (unsigned long long) chain_now + 3600);
+    deadline = (long) chain_now + 3600;
+  }
+
+  abi_selector(&call, SIG_DENOMINATION);
+  if (rpc_eth_call(client, contract, &call, &denom, &denom_len) != RLC_OK || denom_len != ESCROW_WORD) {
+    printf("[ESCROW] 读取 denomination 失败\n");
+    goto done;
+  }
+
+  call.len = 0;
+  abi_selector(&call, SIG_OPEN_ESCROW);
+  abi_put_right(&call, escrow_id, sizeof(escrow_id));
+  abi_put_right(&call, party1, sizeof(party1));
+  abi_put_right(&call, party2, sizeof(party2));
+  abi_put_uint(&call, (uint64_t) deadline);
+  abi_put_right(&call, meta, sizeof(meta));
+  abi_put_uint(&call, 8 * ESCROW_WORD);
+  abi_put_uint(&call, 8 * ESCROW_WORD + abi_tail_size(ESCROW_PUBKEY_LEN));
+  abi_put_right(&call, commitment, sizeof(commitment));
+  abi_put_bytes_tail(&call, args->party1_key, ESCROW_PUBKEY_LEN);
+  abi_put_bytes_tail(&call, args->party2_key, ESCROW_PUBKEY_LEN);
+
+  if (send_transaction(client, contract, &call, denom, from, sk, tx_hash) != RLC_OK) goto done;
+  record_deposit_tx(tx_hash);
+  printf("{\"txHash\":\"%s\",\"contract\":\"%s\"}\n", tx_hash, contract);
+  result_status = RLC_OK;
+
+done:
+  pthread_mutex_unlock(&client->mutex);
+  buf_free(&call);
+  free(denom);
+  free(timestamp);
+  free(block);
+  return result_status;
+}
+
+int escrow_set_data_hash(escrow_client_t client, const char *pool_label, const char *escrow_id,
+                         const char *data_hash, const char *from, const bn_t sk,
+                         char tx_hash[ESCROW_HASH_STR_LEN]) {
+  uint8_t id[32], hash[32], value[ESCROW_WORD] = {0};
+  char contract[ESCROW_ADDRESS_STR_LEN], sent[ESCROW_HASH_STR_LEN];
+  escrow_buf_t call = {0};
+
+  if (client == NULL) return RLC_ERR;
+  if (hex_to_fixed(id, sizeof(id), escrow_id) != RLC_OK
+   || data_hash == NULL || strlen(data_hash) != ESCROW_HASH_STR_LEN - 1
+   || hex_to_fixed(hash, sizeof(hash), data_hash) != RLC_OK) {
+    printf("[ESCROW] setDataHash 参数无效\n");
+    return RLC_ERR;
+  }
+  if (escrow_pool_address(contract, pool_label) != RLC_OK) return RLC_ERR;
+
+  abi_selector(&call, SIG_SET_DATA_HASH);
+  abi_put_right(&call, id, sizeof(id));
+  abi_put_right(&call, hash, sizeof(hash));
+
+  pthread_mutex_lock(&client->mutex);
+  int result_status = send_transaction(client, contract, &call, value, from, sk, sent);
+  pthread_mutex_unlock(&client->mutex);
+  buf_free(&call);
+
+  if (result_status == RLC_OK && tx_hash != NULL) memcpy(tx_hash, sent, ESCROW_HASH_STR_LEN);
+  return result_status;
+}
+
+// 读取托管记录中的签名消息与双方公钥
+static int read_escrow(escrow_client_t client, const char *contract, const uint8_t id[32],
+                       uint8_t message[64], uint8_t key1[ESCROW_PUBKEY_LEN], uint8_t key2[ESCROW_PUBKEY_LEN]) {
+  escrow_buf_t call = {0};
+  uint8_t *ret = NULL;
+  size_t ret_len = 0;
+  const uint8_t *k1, *k2;
+  size_t k1_len, k2_len;
+  int result_status = RLC_ERR;
+
+  abi_selector(&call, SIG_ESCROWS);
+  abi_put_right(&call, id, 32);
+  if (rpc_eth_call(client, contract, &call, &ret, &ret_len) == RLC_OK
+   && abi_word(ret, ret_len, 9) != NULL
+   && abi_read_bytes(&k1, &k1_len, ret, ret_len, 6) == RLC_OK
+   && abi_read_bytes(&k2, &k2_len, ret, ret_len, 7) == RLC_OK) {
+    // 公钥可能带多余字节，截取前 65 字节（与 confirmEscrow.js 一致）
+    if (k1_len >= ESCROW_PUBKEY_LEN && k2_len >= ESCROW_PUBKEY_LEN && k1[0] == 0x04 && k2[0] == 0x04) {
+      memcpy(message, abi_word(ret, ret_len, 8), ESCROW_WORD);
+      memcpy(message + ESCROW_WORD, abi_word(ret, ret_len, 9), ESCROW_WORD);
+      memcpy(key1, k1, ESCROW_PUBKEY_LEN);
+      memcpy(key2, k2, ESCROW_PUBKEY_LEN);
+      result_status = RLC_OK;
+    } else {
+      printf("[ESCROW] 托管记录中的公钥格式异常（len=%zu/%zu）\n", k1_len, k2_len);
+    }
+  } else {
+    printf("[ESCROW] 读取 escrows 失败\n");
+  }
+  buf_free(&call);
+  free(ret);
+  return result_status;
+}
+
+// 调用方持有锁
+static int confirm_locked(escrow_client_t client, const char *contract, const uint8_t id[32],
+                          const bn_t r1, const bn_t s1, const bn_t r2, const bn_t s2,
+                          const char *from, const bn_t sk, char tx_hash[ESCROW_HASH_STR_LEN]) {
+  int result_status = RLC_OK;
+  uint8_t message[64], digest[RLC_MD_LEN], value[ESCROW_WORD] = {0};
+  uint8_t key1[ESCROW_PUBKEY_LEN], key2[ESCROW_PUBKEY_LEN], addr1[20], addr2[20];
+  escrow_buf_t call = {0};
+  bn_t ls1, ls2;
+  ec_t q1, q2;
+
+  bn_null(ls1);
+  bn_null(ls2);
+  ec_null(q1);
+  ec_null(q2);
+
+  RLC_TRY {
+    bn_new(ls1);
+    bn_new(ls2);
+    ec_new(q1);
+    ec_new(q2);
+
+    if (read_escrow(client, contract, id, message, key1, key2) != RLC_OK) {
+      RLC_THROW(ERR_CAUGHT);
+    }
+    ec_read_bin(q1, key1, ESCROW_PUBKEY_LEN);
+    ec_read_bin(q2, key2, ESCROW_PUBKEY_LEN);
+    pubkey_address(addr1, key1);
+    pubkey_address(addr2, key2);
+
+    // 合约以 sha256(escrowIdCopy || dataHash) 验签
+    md_map_sh256(digest, message, sizeof(message));
+    bn_copy(ls1, s1);
+    bn_copy(ls2, s2);
+    normalize_low_s(ls1);
+    normalize_low_s(ls2);
+    const int recid1 = ecdsa_recid(digest, r1, ls1, q1);
+    const int recid2 = ecdsa_recid(digest, r2, ls2, q2);
+    if (recid1 < 0 || recid2 < 0) {
+      printf("[ESCROW] Could not find valid v%s for party%s signature\n",
+             recid1 < 0 ? "1" : "2", recid1 < 0 ? "1" : "2");
+      RLC_THROW(ERR_CAUGHT);
+    }
+
+    abi_selector(&call, SIG_CONFIRM);
+    abi_put_right(&call, id, 32);
+    abi_put_bn(&call, r1);
+    abi_put_bn(&call, ls1);
+    abi_put_uint(&call, 27 + (uint64_t) recid1);
+    abi_put_bn(&call, r2);
+    abi_put_bn(&call, ls2);
+    abi_put_uint(&call, 27 + (uint64_t) recid2);
+    abi_put_right(&call, addr1, sizeof(addr1));
+    abi_put_right(&call, addr2, sizeof(addr2));
+    printf("[ESCROW] confirm v1=%d v2=%d\n", 27 + recid1, 27 + recid2);
+
+    if (send_transaction(client, contract, &call, value, from, sk, tx_hash) != RLC_OK) {
+      RLC_THROW(ERR_CAUGHT);
+    }
+  } RLC_CATCH_ANY {
+    result_status = RLC_ERR;
+  } RLC_FINALLY {
+    buf_free(&call);
+    bn_free(ls1);
+    bn_free(ls2);
+    ec_free(q1);
+    ec_free(q2);
+  }
+  return result_status;
+}
+
+int escrow_confirm(escrow_client_t client, const char *pool_label, const char *escrow_id,
+                   const bn_t r1, const bn_t s1, const bn_t r2, const bn_t s2,
+                   const char *from, const bn_t sk, char tx_hash[ESCROW_HASH_STR_LEN]) {
+  uint8_t id[32];
+  char contract[ESCROW_ADDRESS_STR_LEN], sent[ESCROW_HASH_STR_LEN];
+
+  if (client == NULL) return RLC_ERR;
+  if (hex_to_fixed(id, sizeof(id), escrow_id) != RLC_OK) {
+    printf("[ESCROW] invalid escrow id: %s\n", escrow_id != NULL ? escrow_id : "(null)");
+    return RLC_ERR;
+  }
+  if (escrow_pool_address(contract, pool_label) != RLC_OK) return RLC_ERR;
+
+  pthread_mutex_lock(&client->mutex);
+  int result_status = confirm_locked(client, contract, id, r1, s1, r2, s2, from, sk, sent);
+  pthread_mutex_unlock(&client->mutex);
+
+  if (result_status == RLC_OK && tx_hash != NULL) memcpy(tx_hash, sent, ESCROW_HASH_STR_LEN);
+  return result_status;
+}
@@ -0,0 +1,373 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include "util.h"
+#include "escrow_client.h"
+#include "check.h"
+
+// escrow_client 的已知答案与模拟节点检查：
+//   1. keccak256、函数选择器、EIP-155 规范中的签名交易（签名哈希与 RLP 字节）；
+//   2. 在本地起一个模拟 JSON-RPC 节点，检查 setDataHash 的 ABI 编码、revert 的处理，
+//      以及一个会话等待回执时另一个会话的交易不被阻塞。
+// 用法：escrow_client_check，任何一项不符合预期时返回非 0
+
+// 模拟节点让第一笔交易的回执一直为 null，直到第二笔交易确认；最多拖延这么多次查询
+#define MOCK_SLOW_RECEIPT_POLLS  25
+#define MOCK_BUF_LEN             65536
+
+static void to_hex(char *out, const uint8_t *in, size_t len) {
+  for (size_t i = 0; i < len; i++) sprintf(out + 2 * i, "%02x", in[i]);
+  out[2 * len] = '\0';
+}
+
+static size_t from_hex(uint8_t *out, const char *hex) {
+  size_t n = strlen(hex) / 2;
+  for (size_t i = 0; i < n; i++) sscanf(hex + 2 * i, "%2hhx", &out[i]);
+  return n;
+}
+
+/* ---------------- 已知答案 ---------------- */
+
+static void check_keccak_and_selector(void) {
+  printf("keccak256 与函数选择器:\n");
+  uint8_t h[32], sel[4];
+  char hex[65];
+
+  escrow_keccak256(h, (const uint8_t *) "", 0);
+  to_hex(hex, h, sizeof(h));
+  EXPECT(strcmp(hex, "c5d2460186f7233c927e7db2dcc703c0e500b653ca82273b7bfad8045d85a470") == 0,
+         "keccak256(\"\")");
+
+  escrow_selector(sel, "transfer(address,uint256)");
+  to_hex(hex, sel, sizeof(sel));
+  EXPECT(strcmp(hex, "a9059cbb") == 0, "transfer(address,uint256) 的选择器为 a9059cbb");
+}
+
+// EIP-155 规范中的示例：nonce 9、gasPrice 20 gwei、gas 21000、to 0x3535...35、value 1 ether、chainId 1，
+// 私钥 0x4646...46
+static void check_eip155_vector(void) {
+  printf("EIP-155 签名交易:\n");
+  static const char *SIGNING_HASH = "daf5a779ae972f972197303d7b574746c7ef83eadac0f2791ad23db92e4c8e53";
+  static const char *SIGNED_TX =
+      "f86c098504a817c800825208943535353535353535353535353535353535353535880de0b6b3a7640000"
+      "8025a028ef61340bd939bc2195fe537567866003e1a15d3c71ff63e1590620aa636276"
+      "a067cbe9d8997f761aecb703304b3800ccf555c9f3dc64214b297fb1966a3b6d83";
+  static const char *R_HEX = "28ef61340bd939bc2195fe537567866003e1a15d3c71ff63e1590620aa636276";
+  static const char *S_HEX = "67cbe9d8997f761aecb703304b3800ccf555c9f3dc64214b297fb1966a3b6d83";
+
+  escrow_tx_t tx;
+  memset(&tx, 0, sizeof(tx));
+  tx.nonce = 9;
+  tx.gas_price = 20000000000ULL;
+  tx.gas = 21000;
+  memset(tx.to, 0x35, sizeof(tx.to));
+  from_hex(tx.value + 24, "0de0b6b3a7640000");
+  tx.chain_id = 1;
+
+  uint8_t digest[32], buf[32];
+  char hex[2 * 256 + 1];
+  EXPECT(escrow_tx_signing_hash(digest, &tx) == RLC_OK, "计算签名哈希");
+  to_hex(hex, digest, sizeof(digest));
+  EXPECT(strcmp(hex, SIGNING_HASH) == 0, "签名哈希与规范一致");
+
+  bn_t sk, r, s, n;
+  ec_t pk;
+  bn_null(sk); bn_null(r); bn_null(s); bn_null(n);
+  ec_null(pk);
+  RLC_TRY {
+    bn_new(sk); bn_new(r); bn_new(s); bn_new(n);
+    ec_new(pk);
+    memset(buf, 0x46, sizeof(buf));
+    bn_read_bin(sk, buf, sizeof(buf));
+    ec_mul_gen(pk, sk);
+    ec_norm(pk, pk);
+    from_hex(buf, R_HEX);
+    bn_read_bin(r, buf, sizeof(buf));
+    from_hex(buf, S_HEX);
+    bn_read_bin(s, buf, sizeof(buf));
+
+    uint8_t *raw = NULL;
+    size_t raw_len = 0;
+    int rc = escrow_tx_encode_signed(&raw, &raw_len, &tx, r, s, pk);
+    if (rc == RLC_OK && raw_len <= 256) to_hex(hex, raw, raw_len);
+    else hex[0] = '\0';
+    EXPECT(rc == RLC_OK && strcmp(hex, SIGNED_TX) == 0, "签名交易的 RLP 字节与规范一致（v = 37）");
+    free(raw);
+
+    // 高 s 的等价签名：编码时归一化为低 s，结果相同
+    ec_curve_get_ord(n);
+    bn_sub(s, n, s);
+    rc = escrow_tx_encode_signed(&raw, &raw_len, &tx, r, s, pk);
+    if (rc == RLC_OK && raw_len <= 256) to_hex(hex, raw, raw_len);
+    else hex[0] = '\0';
+    EXPECT(rc == RLC_OK && strcmp(hex, SIGNED_TX) == 0, "高 s 签名归一化后字节相同");
+    free(raw);
+
+    // 签名与公钥不匹配时拒绝
+    ec_dbl(pk, pk);
+    ec_norm(pk, pk);
+    EXPECT(escrow_tx_encode_signed(&raw, &raw_len, &tx, r, s, pk) == RLC_ERR, "公钥不匹配时拒绝编码");
+  } RLC_CATCH_ANY {
+    EXPECT(0, "EIP-155 检查中的 RELIC 运算");
+  } RLC_FINALLY {
+    bn_free(sk); bn_free(r); bn_free(s); bn_free(n);
+    ec_free(pk);
+  }
+}
+
+/* ---------------- 模拟 JSON-RPC 节点 ---------------- */
+
+typedef struct {
+  int listen_fd;
+  int port;
+  pthread_mutex_t mutex;
+  int tx_count;
+  int slow_polls;           // 第一笔交易的回执已被查询的次数
+  int release_first;        // 第二笔交易确认后放行第一笔
+  char data[4][512];        // 每笔 eth_sendTransaction 的 data 字段
+} mock_node_t;
+
+static mock_node_t mock;
+
+// 取 "key":"value" 中的 value
+static int json_string(char *out, size_t cap, const char *json, const char *key) {
+  char pattern[64];
+  snprintf(pattern, sizeof(pattern), "\"%s\":\"", key);
+  const char *p = strstr(json, pattern);
+  if (p == NULL) return 0;
+  p += strlen(pattern);
+  const char *end = strchr(p, '"');
+  if (end == NULL || (size_t) (end - p) >= cap) return 0;
+  memcpy(out, p, end - p);
+  out[end - p] = '\0';
+  return 1;
+}
+
+static void mock_handle(const char *body, char *reply, size_t cap) {
+  char method[64] = "", hash[80] = "";
+  long id = 0;
+  const char *id_pos = strstr(body, "\"id\":");
+  if (id_pos != NULL) id = strtol(id_pos + 5, NULL, 10);
+  json_string(method, sizeof(method), body, "method");
+
+  pthread_mutex_lock(&mock.mutex);
+  if (strcmp(method, "eth_sendTransaction") == 0) {
+    int n = ++mock.tx_count;
+    if (n < 4) json_string(mock.data[n], sizeof(mock.data[n]), body, "data");
+    snprintf(reply, cap, "{\"jsonrpc\":\"2.0\",\"id\":%ld,\"result\":\"0x%064x\"}", id, n);
+  } else if (strcmp(method, "eth_getTransactionReceipt") == 0) {
+    const char *p = strstr(body, "\"params\":[\"");
+    if (p != NULL) sscanf(p + 11, "%79[^\"]", hash);
+    int n = (int) strtol(hash + 2, NULL, 16);
+    const char *status = "0x1";
+    if (n == 1 && !mock.release_first && ++mock.slow_polls < MOCK_SLOW_RECEIPT_POLLS) {
+      status = NULL;
+    } else if (n == 2) {
+      mock.release_first = 1;
+    } else if (n == 3) {
+      status = "0x0";
+    }
+    if (status == NULL) {
+      snprintf(reply, cap, "{\"jsonrpc\":\"2.0\",\"id\":%ld,\"result\":null}", id);
+    } else {
+      snprintf(reply, cap, "{\"jsonrpc\":\"2.0\",\"id\":%ld,\"result\":{\"transactionHash\":\"%s\",\"status\":\"%s\"}}",
+               id, hash, status);
+    }
+  } else {
+    snprintf(reply, cap, "{\"jsonrpc\":\"2.0\",\"id\":%ld,\"error\":{\"code\":-32601,\"message\":\"method not found\"}}", id);
+  }
+  pthread_mutex_unlock(&mock.mutex);
+}
+
+static int write_all(int fd, const char *data, size_t len) {
+  while (len > 0) {
+    ssize_t n = send(fd, data, len, MSG_NOSIGNAL);
+    if (n <= 0) return 0;
+    data += n;
+    len -= (size_t) n;
+  }
+  return 1;
+}
+
+// 一个 keep-alive 连接上依次处理请求
+static void *mock_conn_main(void *arg) {
+  int fd = (int) (intptr_t) arg;
+  char *buf = malloc(MOCK_BUF_LEN), *reply = malloc(MOCK_BUF_LEN), header[128];
+  size_t len = 0;
+
+  while (buf != NULL && reply != NULL) {
+    char *end = NULL;
+    while ((end = strstr(buf, "\r\n\r\n")) == NULL) {
+      ssize_t n = recv(fd, buf + len, MOCK_BUF_LEN - 1 - len, 0);
+      if (n <= 0) goto out;
+      len += (size_t) n;
+      buf[len] = '\0';
+    }
+    size_t header_len = (size_t) (end - buf) + 4, body_len = 0;
+    for (char *line = buf; line < end; line = strstr(line, "\r\n") + 2) {
+      if (strncasecmp(line, "Content-Length:", 15) == 0) body_len = strtoul(line + 15, NULL, 10);
+      if (strncasecmp(line, "Expect: 100-continue", 20) == 0) write_all(fd, "HTTP/1.1 100 Continue\r\n\r\n", 25);
+    }
+    if (header_len + body_len >= MOCK_BUF_LEN) goto out;
+    while (len < header_len + body_len) {
+      ssize_t n = recv(fd, buf + len, MOCK_BUF_LEN - 1 - len, 0);
+      if (n <= 0) goto out;
+      len += (size_t) n;
+      buf[len] = '\0';
+    }
+    char saved = buf[header_len + body_len];
+    buf[header_len + body_len] = '\0';
+    mock_handle(buf + header_len, reply, MOCK_BUF_LEN);
+    buf[header_len + body_len] = saved;
+
+    int hl = snprintf(header, sizeof(header),
+                      "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: %zu\r\n\r\n", strlen(reply));
+    if (!write_all(fd, header, (size_t) hl) || !write_all(fd, reply, strlen(reply))) goto out;
+
+    // 保留已收到的下一个请求的字节
+    len -= header_len + body_len;
+    memmove(buf, buf + header_len + body_len, len);
+    buf[len] = '\0';
+  }
+out:
+  free(buf);
+  free(reply);
+  close(fd);
+  return NULL;
+}
+
+static void *mock_accept_main(void *arg) {
+  (void) arg;
+  for (;;) {
+    int fd = accept(mock.listen_fd, NULL, NULL);
+    if (fd < 0) return NULL;
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, mock_conn_main, (void *) (intptr_t) fd) == 0) {
+      pthread_detach(thread);
+    } else {
+      close(fd);
+    }
+  }
+}
+
+static int mock_start(void) {
+  struct sockaddr_in addr;
+  socklen_t addr_len = sizeof(addr);
+  pthread_t thread;
+
+  memset(&mock, 0, sizeof(mock));
+  pthread_mutex_init(&mock.mutex, NULL);
+  mock.listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (mock.listen_fd < 0 || bind(mock.listen_fd, (struct sockaddr *) &addr, sizeof(addr)) != 0
+      || listen(mock.listen_fd, 8) != 0 || getsockname(mock.listen_fd, (struct sockaddr *) &addr, &addr_len) != 0) {
+    return RLC_ERR;
+  }
+  mock.port = ntohs(addr.sin_port);
+  if (pthread_create(&thread, NULL, mock_accept_main, NULL) != 0) return RLC_ERR;
+  pthread_detach(thread);
+  return RLC_OK;
+}
+
+/* ---------------- 模拟节点上的托管操作 ---------------- */
+
+#define MOCK_POOL      "0x1111111111111111111111111111111111111111"
+#define MOCK_FROM      "0x2222222222222222222222222222222222222222"
+#define MOCK_ESCROW_ID "0x00000000000000000000000000000000000000000000000000000000000000e1"
+#define MOCK_DATA_HASH "0xabababababababababababababababababababababababababababababababab"
+
+typedef struct {
+  escrow_client_t client;
+  int result;
+  struct timespec done;
+} session_t;
+
+static void *session_main(void *arg) {
+  session_t *session = (session_t *) arg;
+  session->result = escrow_set_data_hash(session->client, "0.1", MOCK_ESCROW_ID, MOCK_DATA_HASH, MOCK_FROM, NULL, NULL);
+  clock_gettime(CLOCK_MONOTONIC, &session->done);
+  return NULL;
+}
+
+static int before(const struct timespec *a, const struct timespec *b) {
+  return a->tv_sec < b->tv_sec || (a->tv_sec == b->tv_sec && a->tv_nsec < b->tv_nsec);
+}
+
+static void check_mock_node(const char *book_path) {
+  printf("模拟 JSON-RPC 节点:\n");
+  char url[64];
+  EXPECT(mock_start() == RLC_OK, "启动模拟节点");
+  snprintf(url, sizeof(url), "http://127.0.0.1:%d", mock.port);
+
+  FILE *fp = fopen(book_path, "w");
+  if (fp != NULL) {
+    fprintf(fp, "{\n  \"pools\": {\n    \"0.1\": \"%s\"\n  }\n}\n", MOCK_POOL);
+    fclose(fp);
+  }
+  setenv("A2L_ESCROW_ADDRESS_BOOK", book_path, 1);
+  unsetenv("A2L_ESCROW_LOCAL_SIGN");
+
+  escrow_client_t client = escrow_client_new(url);
+  EXPECT(client != NULL, "创建客户端");
+  if (client == NULL) return;
+
+  // 会话 A 的交易回执迟迟不出，会话 B 在 A 等待期间发送并确认
+  session_t a = { client, RLC_ERR, {0, 0} }, b = { client, RLC_ERR, {0, 0} };
+  pthread_t ta, tb;
+  pthread_create(&ta, NULL, session_main, &a);
+  for (int i = 0; i < 500; i++) {
+    pthread_mutex_lock(&mock.mutex);
+    int sent = mock.tx_count;
+    pthread_mutex_unlock(&mock.mutex);
+    if (sent >= 1) break;
+    usleep(10000);
+  }
+  pthread_create(&tb, NULL, session_main, &b);
+  pthread_join(ta, NULL);
+  pthread_join(tb, NULL);
+
+  EXPECT(a.result == RLC_OK && b.result == RLC_OK, "两个会话的 setDataHash 都成功");
+  EXPECT(before(&b.done, &a.done), "会话 A 等待回执时会话 B 没有被阻塞");
+  EXPECT(mock.release_first, "会话 A 的回执在会话 B 确认之后才出现");
+
+  // setDataHash(bytes32,bytes32) 的 ABI 编码：选择器 + escrowId + dataHash
+  uint8_t sel[4];
+  char expected[2 + 8 + 128 + 1], sel_hex[9];
+  escrow_selector(sel, "setDataHash(bytes32,bytes32)");
+  to_hex(sel_hex, sel, sizeof(sel));
+  snprintf(expected, sizeof(expected), "0x%s%s%s", sel_hex, MOCK_ESCROW_ID + 2, MOCK_DATA_HASH + 2);
+  EXPECT(strcmp(mock.data[1], expected) == 0 && strcmp(mock.data[2], expected) == 0, "setDataHash 的 calldata");
+
+  // 第三笔交易 status 为 0x0（revert）
+  EXPECT(escrow_set_data_hash(client, "0.1", MOCK_ESCROW_ID, MOCK_DATA_HASH, MOCK_FROM, NULL, NULL) == RLC_ERR,
+         "revert 的交易返回失败");
+
+  escrow_client_free(client);
+  unlink(book_path);
+}
+
+int main(void) {
+  if (init() != RLC_OK) {
+    printf("初始化失败\n");
+    return 1;
+  }
+
+  char book_path[64];
+  snprintf(book_path, sizeof(book_path), "/tmp/escrow_client_check_%d.json", (int) getpid());
+
+  check_keccak_and_selector();
+  check_eip155_vector();
+  check_mock_node(book_path);
+
+  clean();
+  return check_summary();
+}
@@ -0,0 +1,213 @@
+/**
+ * Groth16 验证：snarkjs JSON 解析与配对检查
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "/home/zxx/Config/relic/include/relic.h"
+#include "groth16.h"
+
+// 一个数值字符串的最大长度（256 位十进制为 78 位，留出 0x 十六进制的余量）
+#define GROTH16_NUM_LEN  96
+// 单个字段内数值个数上限（IC 为 3 * (GROTH16_MAX_PUBLIC + 1)）
+#define GROTH16_MAX_NUMS  (3 * (GROTH16_MAX_PUBLIC + 1))
+
+typedef char groth16_num_t[GROTH16_NUM_LEN];
+
+// 定位 "key": 之后的值
+static const char *json_value(const char *json, const char *key) {
+  char pattern[64];
+  snprintf(pattern, sizeof(pattern), "\"%s\"", key);
+  const char *p = strstr(json, pattern);
+  if (p == NULL) return NULL;
+  p += strlen(pattern);
+  while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r') p++;
+  if (*p != ':') return NULL;
+  p++;
+  while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r') p++;
+  return p;
+}
+
+/**
+ * 按出现顺序展开（可嵌套的）数组中的数值，数值可以带引号也可以不带
+ * @return 数值个数，格式错误或超过 max 时返回 -1
+ */
+static int json_numbers(const char *json, const char *key, groth16_num_t *out, int max) {
+  const char *p = json_value(json, key);
+  int depth = 0, count = 0;
+  if (p == NULL || *p != '[') return -1;
+  do {
+    if (*p == '[') {
+      depth++;
+      p++;
+    } else if (*p == ']') {
+      depth--;
+      p++;
+    } else if (*p == '"' || (*p >= '0' && *p <= '9')) {
+      int quoted = (*p == '"');
+      const char *start = quoted ? p + 1 : p;
+      const char *end = start;
+      while (*end != '\0' && (quoted ? *end != '"' : ((*end >= '0' && *end <= '9') || *end == 'x' || *end == 'X'
+                                                     || (*end >= 'a' && *end <= 'f') || (*end >= 'A' && *end <= 'F')))) {
+        end++;
+      }
+      if (*end == '\0' || count >= max || (size_t) (end - start) >= GROTH16_NUM_LEN || end == start) return -1;
+      memcpy(out[count], start, end - start);
+      out[count][end - start] = '\0';
+      count++;
+      p = quoted ? end + 1 : end;
+    } else if (*p == ',' || *p == ' ' || *p == '\t' || *p == '\n' || *p == '\r') {
+      p++;
+    } else {
+      return -1;
+    }
+  } while (depth > 0);
+  return count;
+}
+
+// 射影坐标 [x, y, z]，要求 z == 1
+static int parse_g1(bn254_g1_t *p, const char *json, const char *key) {
+  groth16_num_t nums[3];
+  if (json_numbers(json, key, nums, 3) != 3 || strcmp(nums[2], "1") != 0) return RLC_ERR;
+  return bn254_g1_from_dec(p, nums[0], nums[1]);
+}
+
+// [[x0, x1], [y0, y1], ["1", "0"]]
+static int parse_g2(bn254_g2_t *q, const char *json, const char *key) {
+  groth16_num_t nums[6];
+  if (json_numbers(json, key, nums, 6) != 6 || strcmp(nums[4], "1") != 0 || strcmp(nums[5], "0") != 0) {
+    return RLC_ERR;
+  }
+  return bn254_g2_from_dec(q, nums[0], nums[1], nums[2], nums[3]);
+}
+
+int groth16_vk_parse(groth16_vk_t vk, const char *json) {
+  groth16_num_t *nums = NULL;
+  int result_status = RLC_ERR;
+
+  if (vk == NULL || json == NULL) return RLC_ERR;
+  memset(vk, 0, sizeof(*vk));
+
+  const char *alpha_key = json_value(json, "vk_alpha_1") != NULL ? "vk_alpha_1" : "vk_alfa_1";
+  if (parse_g1(&vk->alpha, json, alpha_key) != RLC_OK
+   || parse_g2(&vk->beta, json, "vk_beta_2") != RLC_OK
+   || parse_g2(&vk->gamma, json, "vk_gamma_2") != RLC_OK
+   || parse_g2(&vk->delta, json, "vk_delta_2") != RLC_OK) {
+    fprintf(stderr, "[GROTH16] 验证密钥缺少字段或点不合法\n");
+    return RLC_ERR;
+  }
+
+  nums = malloc(GROTH16_MAX_NUMS * sizeof(groth16_num_t));
+  if (nums == NULL) return RLC_ERR;
+  int count = json_numbers(json, "IC", nums, GROTH16_MAX_NUMS);
+  if (count < 3 || count % 3 != 0) {
+    fprintf(stderr, "[GROTH16] 验证密钥的 IC 格式错误或公开输入超过 %d 个\n", GROTH16_MAX_PUBLIC);
+    goto out;
+  }
+  vk->n_public = (size_t) count / 3 - 1;
+  for (size_t i = 0; i <= vk->n_public; i++) {
+    if (strcmp(nums[3 * i + 2], "1") != 0
+     || bn254_g1_from_dec(&vk->ic[i], nums[3 * i], nums[3 * i + 1]) != RLC_OK) {
+      fprintf(stderr, "[GROTH16] 验证密钥 IC[%zu] 不合法\n", i);
+      goto out;
+    }
+  }
+  result_status = RLC_OK;
+
+out:
+  free(nums);
+  return result_status;
+}
+
+int groth16_vk_load(groth16_vk_t vk, const char *path) {
+  FILE *fp = fopen(path, "rb");
+  char *json = NULL;
+  long size;
+  int result_status = RLC_ERR;
+
+  if (fp == NULL) {
+    fprintf(stderr, "[GROTH16] 无法打开验证密钥 %s\n", path);
+    return RLC_ERR;
+  }
+  if (fseek(fp, 0, SEEK_END) == 0 && (size = ftell(fp)) > 0 && fseek(fp, 0, SEEK_SET) == 0
+   && (json = malloc((size_t) size + 1)) != NULL && fread(json, 1, (size_t) size, fp) == (size_t) size) {
+    json[size] = '\0';
+    result_status = groth16_vk_parse(vk, json);
+  } else {
+    fprintf(stderr, "[GROTH16] 读取验证密钥 %s 失败\n", path);
+  }
+  free(json);
+  fclose(fp);
+  return result_status;
+}
+
+int groth16_proof_parse(groth16_proof_st *proof, const char *json) {
+  groth16_num_t signals[GROTH16_MAX_PUBLIC];
+
+  if (proof == NULL || json == NULL) return RLC_ERR;
+  memset(proof, 0, sizeof(*proof));
+
+  if (parse_g1(&proof->a, json, "pi_a") != RLC_OK
+   || parse_g2(&proof->b, json, "pi_b") != RLC_OK
+   || parse_g1(&proof->c, json, "pi_c") != RLC_OK) {
+    fprintf(stderr, "[GROTH16] 证明缺少 pi_a/pi_b/pi_c 或点不合法\n");
+    return RLC_ERR;
+  }
+
+  int count = json_numbers(json, "publicSignals", signals, GROTH16_MAX_PUBLIC);
+  if (count < 0) {
+    fprintf(stderr, "[GROTH16] publicSignals 格式错误或超过 %d 个\n", GROTH16_MAX_PUBLIC);
+    return RLC_ERR;
+  }
+  proof->n_public = (size_t) count;
+  for (int i = 0; i < count; i++) {
+    if (bn254_scalar_from_dec(proof->signals[i], signals[i], 1) != RLC_OK) {
+      fprintf(stderr, "[GROTH16] publicSignals[%d] 不是小于 r 的整数\n", i);
+      return RLC_ERR;
+    }
+  }
+  return RLC_OK;
+}
+
+int groth16_signal_hex(char out[2 * BN254_BYTES + 3], const groth16_proof_st *proof, size_t i) {
+  static const char digits[] = "0123456789abcdef";
+  if (proof == NULL || i >= proof->n_public) return RLC_ERR;
+  out[0] = '0';
+  out[1] = 'x';
+  for (int j = 0; j < BN254_BYTES; j++) {
+    out[2 + 2 * j] = digits[proof->signals[i][j] >> 4];
+    out[3 + 2 * j] = digits[proof->signals[i][j] & 0x0F];
+  }
+  out[2 + 2 * BN254_BYTES] = '\0';
+  return RLC_OK;
+}
+
+int groth16_verify(const groth16_vk_st *vk, const groth16_proof_st *proof) {
+  bn254_g1_t g1[4], term;
+  bn254_g2_t g2[4];
+
+  if (vk == NULL || proof == NULL) return RLC_ERR;
+  if (proof->n_public != vk->n_public) {
+    fprintf(stderr, "[GROTH16] 公开输入个数不符：%zu，验证密钥要求 %zu\n", proof->n_public, vk->n_public);
+    return RLC_ERR;
+  }
+
+  // vk_x = IC[0] + Σ s_i · IC[i+1]
+  bn254_g1_t vk_x = vk->ic[0];
+  for (size_t i = 0; i < proof->n_public; i++) {
+    bn254_g1_mul(&term, &vk->ic[i + 1], proof->signals[i]);
+    bn254_g1_add(&vk_x, &vk_x, &term);
+  }
+
+  bn254_g1_neg(&g1[0], &proof->a);
+  g2[0] = proof->b;
+  g1[1] = vk->alpha;
+  g2[1] = vk->beta;
+  g1[2] = vk_x;
+  g2[2] = vk->gamma;
+  g1[3] = proof->c;
+  g2[3] = vk->delta;
+
+  return bn254_pairing_check(g1, g2, 4) ? RLC_OK : RLC_ERR;
+}
@@ -0,0 +1,74 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include "/home/zxx/Config/relic/include/relic.h"
+#include "groth16.h"
+
+// 测试配置
+#define BENCHMARK_RUNS 20
+
+#define START_BENCHMARK_TIMER() \
+    struct timeval start_time, end_time; \
+    gettimeofday(&start_time, NULL);
+
+#define END_BENCHMARK_TIMER() \
+    gettimeofday(&end_time, NULL); \
+    elapsed = (end_time.tv_sec - start_time.tv_sec) * 1000.0 + \
+              (end_time.tv_usec - start_time.tv_usec) / 1000.0;
+
+static char *read_file(const char *path) {
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL) return NULL;
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    char *buf = (size > 0) ? malloc((size_t) size + 1) : NULL;
+    if (buf != NULL && fread(buf, 1, (size_t) size, fp) == (size_t) size) {
+        buf[size] = '\0';
+    } else {
+        free(buf);
+        buf = NULL;
+    }
+    fclose(fp);
+    return buf;
+}
+
+// 用法：groth16_benchmark <verification_key.json> <proof.json>...
+// 每个证明文件为 {"proof": ..., "publicSignals": [...]}，输出验证结果与平均耗时
+int main(int argc, char *argv[]) {
+    groth16_vk_st vk;
+    int failures = 0;
+
+    if (argc < 3) {
+        fprintf(stderr, "用法: %s <verification_key.json> <proof.json>...\n", argv[0]);
+        return 1;
+    }
+    if (groth16_vk_load(&vk, argv[1]) != RLC_OK) {
+        fprintf(stderr, "验证密钥载入失败: %s\n", argv[1]);
+        return 1;
+    }
+    printf("验证密钥: %s（%zu 个公开输入）\n", argv[1], vk.n_public);
+
+    for (int i = 2; i < argc; i++) {
+        char *json = read_file(argv[i]);
+        groth16_proof_st proof;
+        double elapsed = 0, total = 0;
+        int valid = 0;
+
+        if (json == NULL) {
+            fprintf(stderr, "无法读取证明文件: %s\n", argv[i]);
+            failures++;
+            continue;
+        }
+        for (int run = 0; run < BENCHMARK_RUNS; run++) {
+            START_BENCHMARK_TIMER();
+            valid = groth16_proof_parse(&proof, json) == RLC_OK && groth16_verify(&vk, &proof) == RLC_OK;
+            END_BENCHMARK_TIMER();
+            total += elapsed;
+        }
+        printf("%-40s %s  平均 %.3f ms（%d 次）\n", argv[i], valid ? "有效" : "无效", total / BENCHMARK_RUNS, BENCHMARK_RUNS);
+        free(json);
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,71 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "/home/zxx/Config/relic/include/relic.h"
+#include "groth16.h"
+#include "check.h"
+
+// Groth16 验证的已知答案检查：test_vectors/groth16 下的验证密钥与三个证明
+// （有效、证明被篡改、公开输入被篡改），由 scripts/gen_groth16_vectors.py 生成。
+// 用法：groth16_vector_check [向量目录]，任何一项结果与预期不符时返回非 0
+
+#define DEFAULT_VECTOR_DIR "../test_vectors/groth16"
+
+typedef struct {
+    const char *file;
+    int expect_valid;
+} groth16_vector_t;
+
+static const groth16_vector_t VECTORS[] = {
+    { "proof_valid.json",          1 },
+    { "proof_tampered_proof.json", 0 },
+    { "proof_tampered_input.json", 0 },
+};
+
+static char *read_file(const char *path) {
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL) return NULL;
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    char *buf = (size > 0) ? malloc((size_t) size + 1) : NULL;
+    if (buf != NULL && fread(buf, 1, (size_t) size, fp) == (size_t) size) {
+        buf[size] = '\0';
+    } else {
+        free(buf);
+        buf = NULL;
+    }
+    fclose(fp);
+    return buf;
+}
+
+int main(int argc, char *argv[]) {
+    const char *dir = (argc > 1) ? argv[1] : DEFAULT_VECTOR_DIR;
+    char path[512], what[640];
+    groth16_vk_st vk;
+
+    snprintf(path, sizeof(path), "%s/verification_key.json", dir);
+    if (groth16_vk_load(&vk, path) != RLC_OK) {
+        fprintf(stderr, "验证密钥载入失败: %s\n", path);
+        return 1;
+    }
+    printf("验证密钥: %s（%zu 个公开输入）\n", path, vk.n_public);
+
+    for (size_t i = 0; i < sizeof(VECTORS) / sizeof(VECTORS[0]); i++) {
+        snprintf(path, sizeof(path), "%s/%s", dir, VECTORS[i].file);
+        char *json = read_file(path);
+        if (json == NULL) {
+            snprintf(what, sizeof(what), "无法读取 %s", path);
+            EXPECT(0, what);
+            continue;
+        }
+        groth16_proof_st proof;
+        int valid = groth16_proof_parse(&proof, json) == RLC_OK && groth16_verify(&vk, &proof) == RLC_OK;
+        snprintf(what, sizeof(what), "%-28s 结果 %s，预期 %s", VECTORS[i].file,
+                 valid ? "有效" : "无效", VECTORS[i].expect_valid ? "有效" : "无效");
+        EXPECT(valid == VECTORS[i].expect_valid, what);
+        free(json);
+    }
+
+    return check_summary();
+}
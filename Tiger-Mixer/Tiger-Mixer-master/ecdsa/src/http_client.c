@@ -0,0 +1,265 @@
+/**
+ * 共享异步 HTTP 客户端：后台线程驱动 curl multi
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <curl/curl.h>
+#include "/home/zxx/Config/relic/include/relic.h"
+#include "http_client.h"
+
+// 后台线程在没有事件时最长阻塞的时间
+#define HTTP_CLIENT_POLL_MS  1000
+
+struct http_request_st {
+  CURL *easy;
+  struct curl_slist *headers;
+  char *body;                     // 请求体副本（libcurl 不复制 POSTFIELDS）
+  char *data;                     // 响应体
+  size_t size, cap;
+  long status;
+  int ok, done;
+  struct http_request_st *next;   // 提交队列或进行中列表
+};
+
+static struct {
+  pthread_mutex_t lock;
+  pthread_cond_t done_cond;
+  pthread_t thread;
+  int running, stopping;
+  CURLM *multi;
+  http_request_t queue_head, queue_tail;   // 已提交、尚未交给 multi 的请求
+  http_request_t active;                    // 已交给 multi 的请求（只由后台线程访问）
+} http_client = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, 0, 0, 0, NULL, NULL, NULL, NULL };
+
+static pthread_once_t http_global_once = PTHREAD_ONCE_INIT;
+
+static void http_global_init(void) {
+  curl_global_init(CURL_GLOBAL_DEFAULT);
+}
+
+static size_t http_write(void *contents, size_t size, size_t nmemb, void *userp) {
+  http_request_t req = (http_request_t) userp;
+  size_t n = size * nmemb;
+  if (req->size + n + 1 > req->cap) {
+    size_t cap = req->cap ? req->cap : 1024;
+    while (cap < req->size + n + 1) cap *= 2;
+    char *grown = realloc(req->data, cap);
+    if (grown == NULL) return 0;
+    req->data = grown;
+    req->cap = cap;
+  }
+  memcpy(req->data + req->size, contents, n);
+  req->size += n;
+  req->data[req->size] = '\0';
+  return n;
+}
+
+static void http_request_free(http_request_t req) {
+  if (req == NULL) return;
+  if (req->easy != NULL) curl_easy_cleanup(req->easy);
+  curl_slist_free_all(req->headers);
+  free(req->body);
+  free(req->data);
+  free(req);
+}
+
+// 结束一个请求并唤醒等待者；easy 句柄此时已不在 multi 中
+static void http_request_finish(http_request_t req, int ok) {
+  if (ok) curl_easy_getinfo(req->easy, CURLINFO_RESPONSE_CODE, &req->status);
+  curl_easy_cleanup(req->easy);
+  req->easy = NULL;
+  curl_slist_free_all(req->headers);
+  req->headers = NULL;
+
+  pthread_mutex_lock(&http_client.lock);
+  req->ok = ok;
+  req->done = 1;
+  pthread_cond_broadcast(&http_client.done_cond);
+  pthread_mutex_unlock(&http_client.lock);
+}
+
+static void http_active_remove(http_request_t req) {
+  http_request_t *link = &http_client.active;
+  while (*link != NULL && *link != req) link = &(*link)->next;
+  if (*link == req) *link = req->next;
+  req->next = NULL;
+}
+
+static void *http_client_loop(void *arg) {
+  CURLM *multi = (CURLM *) arg;
+
+  for (;;) {
+    pthread_mutex_lock(&http_client.lock);
+    int stopping = http_client.stopping;
+    http_request_t queued = http_client.queue_head;
+    http_client.queue_head = http_client.queue_tail = NULL;
+    pthread_mutex_unlock(&http_client.lock);
+
+    while (queued != NULL) {
+      http_request_t req = queued;
+      queued = queued->next;
+      req->next = NULL;
+      if (stopping || curl_multi_add_handle(multi, req->easy) != CURLM_OK) {
+        http_request_finish(req, 0);
+        continue;
+      }
+      req->next = http_client.active;
+      http_client.active = req;
+    }
+    if (stopping) break;
+
+    int still_running = 0;
+    curl_multi_perform(multi, &still_running);
+
+    CURLMsg *msg;
+    int left = 0;
+    while ((msg = curl_multi_info_read(multi, &left)) != NULL) {
+      if (msg->msg != CURLMSG_DONE) continue;
+      http_request_t req = NULL;
+      curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, (char **) &req);
+      CURLcode result = msg->data.result;
+      curl_multi_remove_handle(multi, msg->easy_handle);
+      if (req == NULL) continue;
+      http_active_remove(req);
+      if (result != CURLE_OK) {
+        const char *url = NULL;
+        curl_easy_getinfo(req->easy, CURLINFO_EFFECTIVE_URL, &url);
+        fprintf(stderr, "[HTTP] 请求 %s 失败: %s\n", url ? url : "?", curl_easy_strerror(result));
+      }
+      http_request_finish(req, result == CURLE_OK);
+    }
+
+    curl_multi_poll(multi, NULL, 0, HTTP_CLIENT_POLL_MS, NULL);
+  }
+
+  // 关闭：未完成的请求全部以失败结束
+  while (http_client.active != NULL) {
+    http_request_t req = http_client.active;
+    http_client.active = req->next;
+    req->next = NULL;
+    curl_multi_remove_handle(multi, req->easy);
+    http_request_finish(req, 0);
+  }
+  return NULL;
+}
+
+// 调用时持有 http_client.lock
+static int http_client_start_locked(void) {
+  if (http_client.running) return http_client.stopping ? RLC_ERR : RLC_OK;
+
+  pthread_once(&http_global_once, http_global_init);
+  CURLM *multi = curl_multi_init();
+  if (multi == NULL) return RLC_ERR;
+
+  long per_host = HTTP_CLIENT_MAX_PER_HOST;
+  const char *env = getenv("A2L_HTTP_MAX_PER_HOST");
+  if (env != NULL && atol(env) > 0) per_host = atol(env);
+  curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, per_host);
+  curl_multi_setopt(multi, CURLMOPT_MAX_TOTAL_CONNECTIONS, (long) HTTP_CLIENT_MAX_TOTAL);
+  curl_multi_setopt(multi, CURLMOPT_MAXCONNECTS, (long) HTTP_CLIENT_MAX_TOTAL);
+
+  http_client.multi = multi;
+  http_client.stopping = 0;
+  if (pthread_create(&http_client.thread, NULL, http_client_loop, multi) != 0) {
+    curl_multi_cleanup(multi);
+    http_client.multi = NULL;
+    return RLC_ERR;
+  }
+  http_client.running = 1;
+  return RLC_OK;
+}
+
+http_request_t http_post_json_async(const char *url, const char *body, long timeout_ms) {
+  if (url == NULL || body == NULL) return NULL;
+  pthread_once(&http_global_once, http_global_init);
+
+  http_request_t req = calloc(1, sizeof(struct http_request_st));
+  if (req == NULL) return NULL;
+  req->body = strdup(body);
+  req->easy = curl_easy_init();
+  req->headers = curl_slist_append(NULL, "Content-Type: application/json");
+  if (req->body == NULL || req->easy == NULL || req->headers == NULL) {
+    http_request_free(req);
+    return NULL;
+  }
+
+  curl_easy_setopt(req->easy, CURLOPT_URL, url);
+  curl_easy_setopt(req->easy, CURLOPT_HTTPHEADER, req->headers);
+  curl_easy_setopt(req->easy, CURLOPT_POSTFIELDS, req->body);
+  curl_easy_setopt(req->easy, CURLOPT_POSTFIELDSIZE, (long) strlen(req->body));
+  curl_easy_setopt(req->easy, CURLOPT_WRITEFUNCTION, http_write);
+  curl_easy_setopt(req->easy, CURLOPT_WRITEDATA, req);
+  curl_easy_setopt(req->easy, CURLOPT_PRIVATE, req);
+  curl_easy_setopt(req->easy, CURLOPT_TIMEOUT_MS, timeout_ms > 0 ? timeout_ms : (long) HTTP_CLIENT_DEFAULT_TIMEOUT_MS);
+  curl_easy_setopt(req->easy, CURLOPT_CONNECTTIMEOUT_MS, (long) HTTP_CLIENT_CONNECT_TIMEOUT_MS);
+  curl_easy_setopt(req->easy, CURLOPT_NOSIGNAL, 1L);
+  curl_easy_setopt(req->easy, CURLOPT_TCP_KEEPALIVE, 1L);
+
+  pthread_mutex_lock(&http_client.lock);
+  if (http_client_start_locked() != RLC_OK) {
+    pthread_mutex_unlock(&http_client.lock);
+    http_request_free(req);
+    return NULL;
+  }
+  if (http_client.queue_tail != NULL) {
+    http_client.queue_tail->next = req;
+  } else {
+    http_client.queue_head = req;
+  }
+  http_client.queue_tail = req;
+  curl_multi_wakeup(http_client.multi);
+  pthread_mutex_unlock(&http_client.lock);
+  return req;
+}
+
+int http_request_wait(http_request_t req, long *status, char **response) {
+  if (status != NULL) *status = 0;
+  if (response != NULL) *response = NULL;
+  if (req == NULL) return RLC_ERR;
+
+  pthread_mutex_lock(&http_client.lock);
+  while (!req->done) pthread_cond_wait(&http_client.done_cond, &http_client.lock);
+  pthread_mutex_unlock(&http_client.lock);
+
+  int result_status = req->ok ? RLC_OK : RLC_ERR;
+  if (status != NULL) *status = req->status;
+  if (response != NULL && req->ok) {
+    *response = req->data != NULL ? req->data : strdup("");
+    req->data = NULL;
+  }
+  http_request_free(req);
+  return result_status;
+}
+
+int http_post_json(const char *url, const char *body, long timeout_ms, long *status, char **response) {
+  http_request_t req = http_post_json_async(url, body, timeout_ms);
+  if (req == NULL) {
+    if (status != NULL) *status = 0;
+    if (response != NULL) *response = NULL;
+    return RLC_ERR;
+  }
+  return http_request_wait(req, status, response);
+}
+
+void http_client_shutdown(void) {
+  pthread_mutex_lock(&http_client.lock);
+  if (!http_client.running || http_client.stopping) {
+    pthread_mutex_unlock(&http_client.lock);
+    return;
+  }
+  http_client.stopping = 1;
+  curl_multi_wakeup(http_client.multi);
+  pthread_mutex_unlock(&http_client.lock);
+
+  pthread_join(http_client.thread, NULL);
+
+  pthread_mutex_lock(&http_client.lock);
+  curl_multi_cleanup(http_client.multi);
+  http_client.multi = NULL;
+  http_client.running = 0;
+  http_client.stopping = 0;
+  pthread_mutex_unlock(&http_client.lock);
+}
@@ -0,0 +1,397 @@
+/**
+ * 已使用 nullifierHash 的内存索引实现
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "/home/zxx/Config/relic/include/relic.h"
+#include "nullifier_set.h"
+
+#define NULLIFIER_SNAPSHOT_MAGIC  "A2LNULL1"
+#define NULLIFIER_MIN_CAPACITY    1024
+
+typedef struct {
+  atomic_uchar used;                    // 以 release 语义置 1，读者看到 1 时 key 已写完
+  uint8_t key[NULLIFIER_SET_KEY_LEN];
+} nullifier_slot_t;
+
+// 容量固定的哈希表；扩容时整表替换，旧表挂在 retired 上直到关闭时释放（读者可能仍在访问）
+typedef struct nullifier_table_st {
+  size_t mask;
+  struct nullifier_table_st *retired;
+  nullifier_slot_t slots[];
+} nullifier_table_t;
+
+struct nullifier_set_st {
+  _Atomic(nullifier_table_t *) table;
+  pthread_mutex_t mutex;                // 写者互斥：插入、扩容、写日志、压缩
+  size_t count;
+  size_t log_entries;                   // 上次压缩以来日志中的条目数
+  int log_fd;
+  uint64_t seed;
+  char *log_path;
+  char *snapshot_path;
+};
+
+static int hex_value(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+// 解析为 32 字节大端整数；允许 0x 前缀、首尾空白，至多 64 位十六进制数字
+static int nullifier_parse(uint8_t key[NULLIFIER_SET_KEY_LEN], const char *hex) {
+  if (hex == NULL) return RLC_ERR;
+  while (*hex == ' ' || *hex == '\t') hex++;
+  if (hex[0] == '0' && (hex[1] == 'x' || hex[1] == 'X')) hex += 2;
+
+  size_t len = 0;
+  while (hex_value(hex[len]) >= 0) len++;
+  for (size_t i = len; hex[i] != '\0'; i++) {
+    if (hex[i] != ' ' && hex[i] != '\t' && hex[i] != '\r' && hex[i] != '\n') return RLC_ERR;
+  }
+  if (len == 0 || len > 2 * NULLIFIER_SET_KEY_LEN) return RLC_ERR;
+
+  memset(key, 0, NULLIFIER_SET_KEY_LEN);
+  for (size_t i = 0; i < len; i++) {
+    size_t nibble = 2 * NULLIFIER_SET_KEY_LEN - len + i;
+    int v = hex_value(hex[i]);
+    key[nibble / 2] |= (uint8_t) ((nibble % 2 == 0) ? v << 4 : v);
+  }
+  return RLC_OK;
+}
+
+static size_t nullifier_hash(const nullifier_set_t set, const uint8_t key[NULLIFIER_SET_KEY_LEN]) {
+  uint64_t x;
+  memcpy(&x, key + NULLIFIER_SET_KEY_LEN - sizeof(x), sizeof(x));
+  x ^= set->seed;
+  x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27; x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return (size_t) x;
+}
+
+static nullifier_table_t *nullifier_table_new(size_t capacity) {
+  nullifier_table_t *table = calloc(1, sizeof(nullifier_table_t) + capacity * sizeof(nullifier_slot_t));
+  if (table != NULL) table->mask = capacity - 1;
+  return table;
+}
+
+// 在 table 中查找 key：找到返回其槽位，否则返回探测序列上的第一个空槽
+static nullifier_slot_t *nullifier_probe(const nullifier_set_t set, nullifier_table_t *table,
+                                         const uint8_t key[NULLIFIER_SET_KEY_LEN], int *found) {
+  size_t i = nullifier_hash(set, key) & table->mask;
+  for (;;) {
+    nullifier_slot_t *slot = &table->slots[i];
+    if (!atomic_load_explicit(&slot->used, memory_order_acquire)) {
+      *found = 0;
+      return slot;
+    }
+    if (memcmp(slot->key, key, NULLIFIER_SET_KEY_LEN) == 0) {
+      *found = 1;
+      return slot;
+    }
+    i = (i + 1) & table->mask;
+  }
+}
+
+// 调用方持有锁：放入 key（调用方已确认不存在），装载因子超过 1/2 时先扩容
+static int nullifier_put(nullifier_set_t set, const uint8_t key[NULLIFIER_SET_KEY_LEN]) {
+  nullifier_table_t *table = atomic_load_explicit(&set->table, memory_order_relaxed);
+  int found;
+
+  if (2 * (set->count + 1) > table->mask + 1) {
+    nullifier_table_t *grown = nullifier_table_new(2 * (table->mask + 1));
+    if (grown == NULL) return RLC_ERR;
+    for (size_t i = 0; i <= table->mask; i++) {
+      if (atomic_load_explicit(&table->slots[i].used, memory_order_relaxed)) {
+        nullifier_slot_t *slot = nullifier_probe(set, grown, table->slots[i].key, &found);
+        memcpy(slot->key, table->slots[i].key, NULLIFIER_SET_KEY_LEN);
+        atomic_store_explicit(&slot->used, 1, memory_order_relaxed);
+      }
+    }
+    grown->retired = table;
+    atomic_store_explicit(&set->table, grown, memory_order_release);
+    table = grown;
+  }
+
+  nullifier_slot_t *slot = nullifier_probe(set, table, key, &found);
+  if (!found) {
+    memcpy(slot->key, key, NULLIFIER_SET_KEY_LEN);
+    atomic_store_explicit(&slot->used, 1, memory_order_release);
+    set->count++;
+  }
+  return RLC_OK;
+}
+
+static int nullifier_lookup(const nullifier_set_t set, const uint8_t key[NULLIFIER_SET_KEY_LEN]) {
+  int found;
+  nullifier_probe(set, atomic_load_explicit(&set->table, memory_order_acquire), key, &found);
+  return found;
+}
+
+static int write_all(int fd, const void *buf, size_t len) {
+  const uint8_t *p = (const uint8_t *) buf;
+  while (len > 0) {
+    ssize_t n = write(fd, p, len);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      return RLC_ERR;
+    }
+    p += n;
+    len -= (size_t) n;
+  }
+  return RLC_OK;
+}
+
+static int nullifier_compact_locked(nullifier_set_t set);
+
+static int nullifier_load_snapshot(nullifier_set_t set) {
+  FILE *fp = fopen(set->snapshot_path, "rb");
+  if (fp == NULL) return (errno == ENOENT) ? RLC_OK : RLC_ERR;
+
+  int result_status = RLC_ERR;
+  char magic[8];
+  uint64_t count;
+  if (fread(magic, 1, sizeof(magic), fp) == sizeof(magic)
+   && memcmp(magic, NULLIFIER_SNAPSHOT_MAGIC, sizeof(magic)) == 0
+   && fread(&count, sizeof(count), 1, fp) == 1) {
+    uint8_t key[NULLIFIER_SET_KEY_LEN];
+    uint64_t i;
+    for (i = 0; i < count && fread(key, NULLIFIER_SET_KEY_LEN, 1, fp) == 1; i++) {
+      if (!nullifier_lookup(set, key) && nullifier_put(set, key) != RLC_OK) break;
+    }
+    if (i == count) result_status = RLC_OK;
+  }
+  fclose(fp);
+  if (result_status != RLC_OK) {
+    fprintf(stderr, "[NULLIFIER] 快照 %s 损坏或读取失败\n", set->snapshot_path);
+  }
+  return result_status;
+}
+
+static int is_blank_line(const char *line) {
+  for (; *line != '\0'; line++) {
+    if (*line != ' ' && *line != '\t' && *line != '\r' && *line != '\n') return 0;
+  }
+  return 1;
+}
+
+// 重放日志。完整但无法解析的行说明日志损坏，返回 RLC_ERR（不能静默丢掉已使用的 nullifier）；
+// 末尾没有换行的行是写日志时崩溃留下的：能解析就保留并补上换行，否则截掉，之后的追加不会与它拼接
+static int nullifier_replay_log(nullifier_set_t set) {
+  FILE *fp = fopen(set->log_path, "r");
+  if (fp == NULL) return (errno == ENOENT) ? RLC_OK : RLC_ERR;
+
+  char *line = NULL;
+  size_t line_cap = 0;
+  ssize_t len;
+  off_t valid_end = 0;          // 最后一个完整行之后的偏移
+  int torn = 0;                 // 0 无半行，1 半行可解析（补换行），2 半行不可解析（截掉）
+  uint8_t key[NULLIFIER_SET_KEY_LEN];
+  int result_status = RLC_OK;
+  while ((len = getline(&line, &line_cap, fp)) > 0) {
+    int complete = (line[len - 1] == '\n');
+    if (is_blank_line(line)) {
+      if (complete) valid_end += len;
+      continue;
+    }
+    if (nullifier_parse(key, line) != RLC_OK) {
+      if (!complete) {
+        torn = 2;
+        break;
+      }
+      fprintf(stderr, "[NULLIFIER] 日志 %s 在偏移 %lld 处的记录损坏\n", set->log_path, (long long) valid_end);
+      result_status = RLC_ERR;
+      break;
+    }
+    set->log_entries++;
+    if (!nullifier_lookup(set, key) && nullifier_put(set, key) != RLC_OK) {
+      result_status = RLC_ERR;
+      break;
+    }
+    if (!complete) {
+      torn = 1;
+      break;
+    }
+    valid_end += len;
+  }
+  free(line);
+  fclose(fp);
+
+  if (result_status == RLC_OK && torn == 2) {
+    fprintf(stderr, "[NULLIFIER] 截掉日志 %s 末尾不完整的记录\n", set->log_path);
+    if (truncate(set->log_path, valid_end) != 0) result_status = RLC_ERR;
+  } else if (result_status == RLC_OK && torn == 1) {
+    int fd = open(set->log_path, O_WRONLY | O_APPEND | O_CLOEXEC);
+    if (fd < 0 || write_all(fd, "\n", 1) != RLC_OK || fsync(fd) != 0) result_status = RLC_ERR;
+    if (fd >= 0) close(fd);
+  }
+  return result_status;
+}
+
+nullifier_set_t nullifier_set_open(const char *log_path, const char *snapshot_path) {
+  if (log_path == NULL || snapshot_path == NULL) return NULL;
+
+  nullifier_set_t set = calloc(1, sizeof(struct nullifier_set_st));
+  if (set == NULL) return NULL;
+  pthread_mutex_init(&set->mutex, NULL);
+  set->log_fd = -1;
+  rand_bytes((uint8_t *) &set->seed, sizeof(set->seed));
+  set->log_path = strdup(log_path);
+  set->snapshot_path = strdup(snapshot_path);
+  atomic_init(&set->table, nullifier_table_new(NULLIFIER_MIN_CAPACITY));
+
+  if (set->log_path == NULL || set->snapshot_path == NULL || atomic_load(&set->table) == NULL
+   || nullifier_load_snapshot(set) != RLC_OK || nullifier_replay_log(set) != RLC_OK) {
+    nullifier_set_close(set);
+    return NULL;
+  }
+
+  set->log_fd = open(log_path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+  if (set->log_fd < 0) {
+    fprintf(stderr, "[NULLIFIER] 无法打开日志 %s: %s\n", log_path, strerror(errno));
+    nullifier_set_close(set);
+    return NULL;
+  }
+
+  if (set->log_entries >= NULLIFIER_SET_COMPACT_THRESHOLD) {
+    nullifier_set_compact(set);
+  }
+  return set;
+}
+
+void nullifier_set_close(nullifier_set_t set) {
+  if (set == NULL) return;
+  if (set->log_fd >= 0) close(set->log_fd);
+  nullifier_table_t *table = atomic_load(&set->table);
+  while (table != NULL) {
+    nullifier_table_t *retired = table->retired;
+    free(table);
+    table = retired;
+  }
+  pthread_mutex_destroy(&set->mutex);
+  free(set->log_path);
+  free(set->snapshot_path);
+  free(set);
+}
+
+int nullifier_set_contains(const nullifier_set_t set, const char *nullifier_hex) {
+  uint8_t key[NULLIFIER_SET_KEY_LEN];
+  if (set == NULL || nullifier_parse(key, nullifier_hex) != RLC_OK) return -1;
+  return nullifier_lookup(set, key);
+}
+
+int nullifier_set_insert(nullifier_set_t set, const char *nullifier_hex) {
+  uint8_t key[NULLIFIER_SET_KEY_LEN];
+  if (set == NULL || nullifier_parse(key, nullifier_hex) != RLC_OK) return -1;
+
+  int result = 1;
+  pthread_mutex_lock(&set->mutex);
+  if (nullifier_lookup(set, key)) {
+    result = 0;
+  } else {
+    // 先持久化再对查询可见：进程崩溃时不会丢失已接受的 nullifier
+    char line[2 * NULLIFIER_SET_KEY_LEN + 4];
+    line[0] = '0';
+    line[1] = 'x';
+    for (size_t i = 0; i < NULLIFIER_SET_KEY_LEN; i++) {
+      snprintf(line + 2 + 2 * i, 3, "%02x", key[i]);
+    }
+    line[2 + 2 * NULLIFIER_SET_KEY_LEN] = '\n';
+    off_t log_size = lseek(set->log_fd, 0, SEEK_END);
+    if (write_all(set->log_fd, line, 2 * NULLIFIER_SET_KEY_LEN + 3) != RLC_OK
+     || fsync(set->log_fd) != 0
+     || nullifier_put(set, key) != RLC_OK) {
+      fprintf(stderr, "[NULLIFIER] 写入日志 %s 失败: %s\n", set->log_path, strerror(errno));
+      // 截掉可能写了一半的行，避免与下一条记录拼接
+      if (log_size >= 0 && ftruncate(set->log_fd, log_size) != 0) {
+        fprintf(stderr, "[NULLIFIER] 无法回滚日志 %s\n", set->log_path);
+      }
+      result = -1;
+    } else if (++set->log_entries >= NULLIFIER_SET_COMPACT_THRESHOLD) {
+      nullifier_compact_locked(set);
+    }
+  }
+  pthread_mutex_unlock(&set->mutex);
+  return result;
+}
+
+static int key_cmp(const void *a, const void *b) {
+  return memcmp(a, b, NULLIFIER_SET_KEY_LEN);
+}
+
+// 调用方持有锁
+static int nullifier_compact_locked(nullifier_set_t set) {
+  nullifier_table_t *table = atomic_load_explicit(&set->table, memory_order_relaxed);
+  uint8_t *keys = malloc((set->count > 0 ? set->count : 1) * NULLIFIER_SET_KEY_LEN);
+  if (keys == NULL) return RLC_ERR;
+  size_t n = 0;
+  for (size_t i = 0; i <= table->mask && n < set->count; i++) {
+    if (atomic_load_explicit(&table->slots[i].used, memory_order_relaxed)) {
+      memcpy(keys + n * NULLIFIER_SET_KEY_LEN, table->slots[i].key, NULLIFIER_SET_KEY_LEN);
+      n++;
+    }
+  }
+  qsort(keys, n, NULLIFIER_SET_KEY_LEN, key_cmp);
+
+  size_t tmp_len = strlen(set->snapshot_path) + 5;
+  char *tmp_path = malloc(tmp_len);
+  if (tmp_path == NULL) {
+    free(keys);
+    return RLC_ERR;
+  }
+  snprintf(tmp_path, tmp_len, "%s.tmp", set->snapshot_path);
+
+  int result_status = RLC_ERR;
+  uint64_t count = n;
+  int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd >= 0) {
+    if (write_all(fd, NULLIFIER_SNAPSHOT_MAGIC, 8) == RLC_OK
+     && write_all(fd, &count, sizeof(count)) == RLC_OK
+     && write_all(fd, keys, n * NULLIFIER_SET_KEY_LEN) == RLC_OK
+     && fsync(fd) == 0) {
+      result_status = RLC_OK;
+    }
+    close(fd);
+  }
+
+  // 快照就位后才清空日志；两步之间崩溃只会在重启时重放重复条目
+  if (result_status == RLC_OK && rename(tmp_path, set->snapshot_path) == 0
+   && ftruncate(set->log_fd, 0) == 0 && fsync(set->log_fd) == 0) {
+    set->log_entries = 0;
+    printf("[NULLIFIER] 已压缩 %zu 个 nullifier 到快照 %s\n", n, set->snapshot_path);
+  } else {
+    fprintf(stderr, "[NULLIFIER] 压缩快照 %s 失败: %s\n", set->snapshot_path, strerror(errno));
+    unlink(tmp_path);
+    result_status = RLC_ERR;
+  }
+
+  free(tmp_path);
+  free(keys);
+  return result_status;
+}
+
+int nullifier_set_compact(nullifier_set_t set) {
+  if (set == NULL) return RLC_ERR;
+  pthread_mutex_lock(&set->mutex);
+  int result_status = nullifier_compact_locked(set);
+  pthread_mutex_unlock(&set->mutex);
+  return result_status;
+}
+
+size_t nullifier_set_size(const nullifier_set_t set) {
+  if (set == NULL) return 0;
+  pthread_mutex_lock(&set->mutex);
+  size_t n = set->count;
+  pthread_mutex_unlock(&set->mutex);
+  return n;
+}
@@ -0,0 +1,167 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "/home/zxx/Config/relic/include/relic.h"
+#include "nullifier_set.h"
+#include "check.h"
+
+// nullifier 索引的持久化检查：快照 + 日志重放、日志末尾半行修复，以及快照/日志损坏时拒绝打开。
+// 用法：nullifier_set_check [工作目录]，任何一项不符合预期时返回非 0
+
+#define CHECK_KEYS 64
+
+static char log_path[512];
+static char snapshot_path[512];
+
+static void key_hex(char out[67], int i) {
+  snprintf(out, 67, "0x%064x", 0x1000 + i);
+}
+
+static void reset_files(void) {
+  unlink(log_path);
+  unlink(snapshot_path);
+}
+
+// 插入 [from, to) 的 key
+static int insert_range(nullifier_set_t set, int from, int to) {
+  char hex[67];
+  for (int i = from; i < to; i++) {
+    key_hex(hex, i);
+    if (nullifier_set_insert(set, hex) != 1) return 0;
+  }
+  return 1;
+}
+
+static int contains_range(nullifier_set_t set, int from, int to) {
+  char hex[67];
+  for (int i = from; i < to; i++) {
+    key_hex(hex, i);
+    if (nullifier_set_contains(set, hex) != 1) return 0;
+  }
+  return 1;
+}
+
+static int append_raw(const char *path, const char *data) {
+  FILE *fp = fopen(path, "ab");
+  if (fp == NULL) return 0;
+  int ok = fputs(data, fp) >= 0;
+  fclose(fp);
+  return ok;
+}
+
+static long file_size(const char *path) {
+  FILE *fp = fopen(path, "rb");
+  if (fp == NULL) return -1;
+  fseek(fp, 0, SEEK_END);
+  long size = ftell(fp);
+  fclose(fp);
+  return size;
+}
+
+// 快照 + 日志：压缩前后插入的 key 在重新打开后都在
+static void check_snapshot_and_log(void) {
+  printf("快照与日志重放:\n");
+  reset_files();
+  nullifier_set_t set = nullifier_set_open(log_path, snapshot_path);
+  EXPECT(set != NULL, "打开空索引");
+  if (set == NULL) return;
+  EXPECT(insert_range(set, 0, CHECK_KEYS / 2), "插入前一半");
+  EXPECT(nullifier_set_compact(set) == RLC_OK, "压缩为快照");
+  EXPECT(insert_range(set, CHECK_KEYS / 2, CHECK_KEYS), "压缩后插入后一半");
+  nullifier_set_close(set);
+
+  set = nullifier_set_open(log_path, snapshot_path);
+  EXPECT(set != NULL, "重新打开");
+  if (set == NULL) return;
+  EXPECT(nullifier_set_size(set) == CHECK_KEYS, "重新打开后数量一致");
+  EXPECT(contains_range(set, 0, CHECK_KEYS), "快照与日志中的 key 都在");
+  char hex[67];
+  key_hex(hex, 0);
+  EXPECT(nullifier_set_insert(set, hex) == 0, "重复插入被拒绝");
+  nullifier_set_close(set);
+}
+
+// 快照被截断或魔数损坏：拒绝打开，不能只靠日志继续
+static void check_corrupt_snapshot(void) {
+  printf("快照损坏:\n");
+  long size = file_size(snapshot_path);
+  EXPECT(size > 16, "存在快照");
+  if (size <= 16) return;
+
+  EXPECT(truncate(snapshot_path, size - 7) == 0, "截断快照");
+  nullifier_set_t set = nullifier_set_open(log_path, snapshot_path);
+  EXPECT(set == NULL, "截断的快照拒绝打开");
+  nullifier_set_close(set);
+
+  FILE *fp = fopen(snapshot_path, "r+b");
+  if (fp != NULL) {
+    fputc('X', fp);
+    fclose(fp);
+  }
+  set = nullifier_set_open(log_path, snapshot_path);
+  EXPECT(set == NULL, "魔数损坏的快照拒绝打开");
+  nullifier_set_close(set);
+}
+
+// 日志末尾的半行：不可解析的截掉，可解析的保留；之后的追加不与它拼接
+static void check_torn_log_tail(void) {
+  printf("日志末尾半行:\n");
+  reset_files();
+  nullifier_set_t set = nullifier_set_open(log_path, snapshot_path);
+  EXPECT(set != NULL && insert_range(set, 0, 4), "写入 4 条日志");
+  nullifier_set_close(set);
+
+  long size = file_size(log_path);
+  EXPECT(append_raw(log_path, "0x00000000000000000000000000000000000000000000000000000000000000zz"),
+        "追加不可解析的半行");
+  set = nullifier_set_open(log_path, snapshot_path);
+  EXPECT(set != NULL, "打开时截掉不可解析的半行");
+  EXPECT(file_size(log_path) == size, "日志恢复到最后一个完整行");
+  EXPECT(set != NULL && insert_range(set, 4, 5), "继续插入");
+  nullifier_set_close(set);
+
+  char hex[67];
+  key_hex(hex, 5);
+  EXPECT(append_raw(log_path, hex), "追加可解析但没有换行的行");
+  set = nullifier_set_open(log_path, snapshot_path);
+  EXPECT(set != NULL && contains_range(set, 0, 6), "可解析的半行保留");
+  EXPECT(set != NULL && insert_range(set, 6, 7), "继续插入");
+  nullifier_set_close(set);
+
+  set = nullifier_set_open(log_path, snapshot_path);
+  EXPECT(set != NULL && nullifier_set_size(set) == 7 && contains_range(set, 0, 7), "重新打开后 7 条都在");
+  nullifier_set_close(set);
+}
+
+// 日志中间的完整行损坏：拒绝打开
+static void check_corrupt_log_line(void) {
+  printf("日志中间损坏:\n");
+  EXPECT(append_raw(log_path, "0xnot-a-nullifier\n"), "追加损坏的完整行");
+  char hex[67];
+  key_hex(hex, 7);
+  EXPECT(append_raw(log_path, hex) && append_raw(log_path, "\n"), "其后追加一条正常记录");
+  nullifier_set_t set = nullifier_set_open(log_path, snapshot_path);
+  EXPECT(set == NULL, "损坏的日志拒绝打开");
+  nullifier_set_close(set);
+}
+
+int main(int argc, char *argv[]) {
+  const char *dir = (argc > 1) ? argv[1] : "/tmp";
+  snprintf(log_path, sizeof(log_path), "%s/nullifier_set_check_%d.log", dir, (int) getpid());
+  snprintf(snapshot_path, sizeof(snapshot_path), "%s/nullifier_set_check_%d.snap", dir, (int) getpid());
+
+  if (core_init() != RLC_OK) {
+    fprintf(stderr, "RELIC 初始化失败\n");
+    return 1;
+  }
+
+  check_snapshot_and_log();
+  check_corrupt_snapshot();
+  check_torn_log_tail();
+  check_corrupt_log_line();
+
+  reset_files();
+  core_clean();
+  return check_summary();
+}
@@ -0,0 +1,35 @@
+/**
+ * 按请求回收 PARI 栈的实现
+ */
+
+#include "pari/pari.h"
+#include "pari_arena.h"
+
+void pari_arena_persist(GENbin **store, GEN *const slots[], size_t n) {
+  pari_sp av = avma;
+  GEN v = cgetg(n + 1, t_VEC);
+  for (size_t i = 0; i < n; i++) {
+    gel(v, i + 1) = (*slots[i] != NULL) ? *slots[i] : gen_0;
+  }
+
+  // 先复制再释放旧副本：槽位可能仍指向旧副本
+  GENbin *bin = copy_bin(v);
+  set_avma(av);
+  for (size_t i = 0; i < n; i++) {
+    if (*slots[i] != NULL) *slots[i] = gel(bin->x, i + 1);
+  }
+
+  pari_arena_release(store);
+  *store = bin;
+}
+
+void pari_arena_release(GENbin **store) {
+  if (*store != NULL) {
+    pari_free(*store);
+    *store = NULL;
+  }
+}
+
+size_t pari_arena_stack_used(void) {
+  return (size_t) (pari_mainstack->top - avma);
+}
@@ -0,0 +1,137 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/time.h>
+#include "util.h"
+
+// 测试配置
+#define DEFAULT_SESSIONS 10000
+#define REPORT_INTERVAL  1000
+#define LIVE_SESSIONS    64   // 同时存活的会话数（模拟 tumbler 工作线程持有的会话）
+
+// 与 tumbler 会话类似：跨请求保存密文与证明
+typedef struct {
+    cl_ciphertext_t ctx;
+    zk_proof_cldl_t proof;
+    GENbin *pari_store;
+} soak_session_t;
+
+static long current_rss_kb(void) {
+    FILE *fp = fopen("/proc/self/status", "r");
+    if (fp == NULL) return -1;
+    char line[256];
+    long rss = -1;
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        if (strncmp(line, "VmRSS:", 6) == 0) {
+            rss = strtol(line + 6, NULL, 10);
+            break;
+        }
+    }
+    fclose(fp);
+    return rss;
+}
+
+static void soak_session_persist(soak_session_t *session) {
+    GEN *const slots[] = {
+        &session->ctx->c1, &session->ctx->c2, &session->ctx->r,
+        &session->proof->t1, &session->proof->t3, &session->proof->u1, &session->proof->u2,
+    };
+    pari_arena_persist(&session->pari_store, slots, sizeof(slots) / sizeof(slots[0]));
+}
+
+int main(int argc, char *argv[]) {
+    const long sessions = (argc > 1 && atol(argv[1]) > 0) ? atol(argv[1]) : DEFAULT_SESSIONS;
+    const int reset = !(argc > 2 && strcmp(argv[2], "noreset") == 0);
+
+    printf("========== PARI 栈长期运行测试 ==========\n");
+    printf("测试时间: %s\n", ctime(&(time_t){time(NULL)}));
+    printf("会话数: %ld  同时存活: %d  每请求回收: %s\n", sessions, LIVE_SESSIONS, reset ? "是" : "否");
+    printf("=====================================\n");
+
+    if (init() != RLC_OK) {
+        printf("初始化失败\n");
+        return 1;
+    }
+
+    int result_status = 0;
+    cl_params_t params;
+    cl_public_key_t pk;
+    bn_t q, x;
+    soak_session_t live[LIVE_SESSIONS];
+    int pk_cloned = 0;
+
+    cl_params_null(params);
+    cl_public_key_null(pk);
+    bn_null(q);
+    bn_null(x);
+    for (int i = 0; i < LIVE_SESSIONS; i++) {
+        cl_ciphertext_null(live[i].ctx);
+        zk_proof_cldl_null(live[i].proof);
+        live[i].pari_store = NULL;
+    }
+
+    RLC_TRY {
+        cl_params_new(params);
+        cl_public_key_new(pk);
+        bn_new(q);
+        bn_new(x);
+        for (int i = 0; i < LIVE_SESSIONS; i++) {
+            cl_ciphertext_new(live[i].ctx);
+            zk_proof_cldl_new(live[i].proof);
+        }
+
+        if (generate_cl_params(params) != RLC_OK) {
+            RLC_THROW(ERR_CAUGHT);
+        }
+        pk->pk = gclone(nupow(params->g_q, randomi(params->bound), NULL));
+        pk_cloned = 1;
+        ec_curve_get_ord(q);
+
+        struct timeval start_time, now;
+        gettimeofday(&start_time, NULL);
+        printf("%10s %14s %12s %12s\n", "会话", "PARI 栈(字节)", "RSS(KB)", "耗时(s)");
+
+        for (long s = 1; s <= sessions; s++) {
+            soak_session_t *session = &live[s % LIVE_SESSIONS];
+            pari_sp av = avma;
+
+            char x_str[RLC_BN_BITS + 2];
+            bn_rand_mod(x, q);
+            bn_write_str(x_str, sizeof(x_str), x, 10);
+            GEN plain = strtoi(x_str);
+            if (cl_enc(session->ctx, plain, pk, params) != RLC_OK
+             || zk_cldl_prove(session->proof, plain, session->ctx, pk, params) != RLC_OK) {
+                RLC_THROW(ERR_CAUGHT);
+            }
+
+            if (reset) {
+                soak_session_persist(session);
+                set_avma(av);
+            }
+
+            if (s % REPORT_INTERVAL == 0 || s == sessions) {
+                gettimeofday(&now, NULL);
+                double elapsed = (now.tv_sec - start_time.tv_sec) + (now.tv_usec - start_time.tv_usec) / 1e6;
+                printf("%10ld %14zu %12ld %12.1f\n", s, pari_arena_stack_used(), current_rss_kb(), elapsed);
+                fflush(stdout);
+            }
+        }
+    } RLC_CATCH_ANY {
+        result_status = 1;
+    } RLC_FINALLY {
+        for (int i = 0; i < LIVE_SESSIONS; i++) {
+            pari_arena_release(&live[i].pari_store);
+            cl_ciphertext_free(live[i].ctx);
+            zk_proof_cldl_free(live[i].proof);
+        }
+        if (pk_cloned) gunclone(pk->pk);
+        cl_public_key_free(pk);
+        cl_params_free(params);
+        bn_free(q);
+        bn_free(x);
+    }
+
+    clean();
+    return result_status;
+}
@@ -63,6 +63,7 @@ int dkg_protocol_init_with_cl_params(dkg_protocol_t protocol, int n_participants
         protocol->cl_params->q = gen_0;
         protocol->cl_params->G = gen_0;
         protocol->cl_params->g_q = gen_0;
+        protocol->cl_params->g_q_table = NULL;
         protocol->cl_params->bound = gen_0;
         
         if (generate_cl_params(protocol->cl_params) != RLC_OK) {
@@ -191,7 +192,7 @@ int dkg_generate_polynomial_commitments_and_shares(dkg_protocol_t protocol, int
         
         // ⭐ 使用 nupow（与 util.c 一致），PARI 内部会自动约化  承诺是在class group上做的
         pari_sp av = avma;
-        GEN commitment_temp = nupow(protocol->generator_g, a_ij, NULL);
+        GEN commitment_temp = cl_fixed_base_pow(protocol->cl_params->g_q_table, protocol->generator_g, a_ij);
         p->commitments[j] = gclone(commitment_temp);
         avma = av;
         
@@ -237,7 +238,7 @@ int dkg_generate_polynomial_commitments_and_shares(dkg_protocol_t protocol, int
     
     // ⭐ 使用 nupow 重新计算
     pari_sp av_test = avma;
-    GEN recomputed_A0_temp = nupow(protocol->generator_g, a0_test_gen, NULL);
+    GEN recomputed_A0_temp = cl_fixed_base_pow(protocol->cl_params->g_q_table, protocol->generator_g, a0_test_gen);
     GEN recomputed_A0 = gclone(recomputed_A0_temp);
     avma = av_test;
     
@@ -482,69 +483,43 @@ int dkg_verify_share(dkg_protocol_t protocol, int verifier_id, int sender_id,
     
     // ⭐ 使用 nupow（PARI 内部会自动约化）
     pari_sp av_left = avma;
-    GEN left_side_temp = nupow(protocol->generator_g, s_ij, NULL);
+    GEN left_side_temp = cl_fixed_base_pow(protocol->cl_params->g_q_table, protocol->generator_g, s_ij);
     GEN left_side = gclone(left_side_temp);
     avma = av_left;
     
     // 计算右侧：∏_{k=0}^{t-1} (A_{i,k})^{j^k} (Class Group)
-    // 初始化：right_side = A_{i,0}^{j^0} = A_{i,0}^1 = A_{i,0}
-    GEN right_side = NULL;
-    
-    // 使用 GEN 类型计算 j^k，避免 bn_t 溢出
-    GEN j = stoi(verifier_id);  
-    GEN j_power = gen_1;         
-    
-    // 获取群阶 q（用于指数模运算）
-    char q_str[256];
-    bn_write_str(q_str, sizeof(q_str), protocol->order, 10);
-    GEN q_gen = strtoi(q_str);
-    
+    // 所有承诺一次多重幂运算，共享平方
+    if (sender->threshold < 1) {
+        gunclone(left_side);
+        return RLC_ERR;
+    }
     for (int k = 0; k < sender->threshold; k++) {
         // 确保承诺已初始化
         if (sender->commitments[k] == NULL || sender->commitments[k] == gen_0) {
-            // 清理已分配的资源
-            if (right_side != NULL) {
-                gunclone(right_side);
-            }
             gunclone(left_side);
             return RLC_ERR;
         }
-        
+    }
+    
+    // 获取群阶 q（用于指数模运算）
+    char q_str[256];
+    bn_write_str(q_str, sizeof(q_str), protocol->order, 10);
+    
+    pari_sp av_right = avma;
+    GEN q_gen = strtoi(q_str);
+    GEN j = stoi(verifier_id);
+    GEN bases = cgetg(sender->threshold + 1, t_VEC);
+    GEN exps = cgetg(sender->threshold + 1, t_VEC);
+    GEN j_power = gen_1;
+    for (int k = 0; k < sender->threshold; k++) {
         // ⭐ 关键修复：对指数做 mod q（参考BICYCL实现）
         // 数学原理：在阶为q的群中，g^m = g^{m mod q}
-        pari_sp av = avma;
-        GEN j_power_mod = gmod(j_power, q_gen);
-        GEN j_power_mod_copy = gclone(j_power_mod);
-        avma = av;
-        
-        // 计算 A_{i,k}^{j^k mod q}（⭐ 使用 nupow）
-        pari_sp av2 = avma;
-        GEN temp_pow = nupow(sender->commitments[k], j_power_mod_copy, NULL);
-        GEN temp = gclone(temp_pow);
-        avma = av2;
-        gunclone(j_power_mod_copy);
-        
-        // Class Group 群乘法（⭐ 使用 gmul，PARI 自动约化）
-        if (k == 0) {
-            right_side = temp;
-        } else {
-            pari_sp av3 = avma;
-            GEN new_right = gmul(right_side, temp);
-            GEN new_right_copy = gclone(new_right);
-            avma = av3;
-            
-            gunclone(right_side);
-            gunclone(temp);
-            right_side = new_right_copy;
-        }
-        
-        // 计算 j^(k+1)
-        pari_sp av4 = avma;
-        GEN j_power_next = gmul(j_power, j);
-        GEN j_power_next_copy = gclone(j_power_next);
-        avma = av4;
-        j_power = j_power_next_copy;
+        gel(bases, k + 1) = sender->commitments[k];
+        gel(exps, k + 1) = modii(j_power, q_gen);
+        j_power = mulii(j_power, j);
     }
+    GEN right_side = gclone(cl_multiexp(bases, exps));
+    avma = av_right;
     
     // ⭐ 直接使用 PARI 的 gequal 比较（不手动约化）
     int result = gequal(left_side, right_side);
@@ -564,7 +539,6 @@ int dkg_verify_share(dkg_protocol_t protocol, int verifier_id, int sender_id,
     // 清理 PARI 对象
     gunclone(left_side);
     gunclone(right_side);
-    gunclone(j_power);  // ⭐ 清理 j_power
     
     return result ? RLC_OK : RLC_ERR;
 }
@@ -766,7 +740,7 @@ int dkg_verify_final_public_key(dkg_protocol_t protocol) {
     GEN sk_gen = strtoi(sk_str);
     
     pari_sp av = avma;
-    GEN expected_pk_temp = nupow(protocol->generator_g, sk_gen, NULL);
+    GEN expected_pk_temp = cl_fixed_base_pow(protocol->cl_params->g_q_table, protocol->generator_g, sk_gen);
     GEN expected_pk = gclone(expected_pk_temp);
     avma = av;
     
@@ -11,6 +11,7 @@
 #include <unistd.h>
 #include <pthread.h>
 #include <ctype.h>
+#include <stdint.h>
 #include "reputation_tracker.h"
 
 #define MAX_LOG_ENTRIES 10000
@@ -18,16 +19,391 @@
 #define STATS_FILE "/home/zxx/A2L/A2L-master/ecdsa/log_game/reputation_stats.csv"
 #define ADDRESS_LABELS_FILE "/home/zxx/A2L/A2L-master/ecdsa/bin/address_labels.csv"
 #define COMMITTEE_MEMBERS_FILE "/home/zxx/A2L/A2L-master/ecdsa/committee_members.txt"
+#define AGGREGATES_FILE "/home/zxx/A2L/A2L-master/ecdsa/log_game/reputation_aggregates.bin"
+
+// ================= 增量聚合 =================
+// 聚合值始终等价于"决策文件前 csv_offset 字节"的统计结果：记录决策后从上次位置读到文件末尾
+// （包括其它 receiver 进程追加的行），每行 O(1) 更新按地址的计数和按 request_id 的分组；
+// 统计时直接读计数，与历史决策数无关。定期把聚合快照写到 AGGREGATES_FILE，重启时从快照续读。
+#define AGGREGATES_MAGIC "A2LREP01"
+#define AGGREGATES_SNAPSHOT_INTERVAL 256   // 每消费多少行写一次快照
+#define GROUP_MAX_MEMBERS 10               // 与全量计算一致：每个请求最多记录 10 个地址
+#define AGG_REQUEST_ID_MAX 128
+#define AGG_ADDRESS_MAX 64
+
+typedef struct {
+    char address[AGG_ADDRESS_MAX];  // 决策文件中的原始 participant_address
+    uint64_t total;                 // 决策总数
+    uint64_t correct;               // 正确决策数
+    uint64_t agreed;                // 与多数决策一致的请求数
+    uint64_t responded;             // 响应过的不同请求数
+    uint64_t completed;             // 其中提供了分片的请求数
+} address_aggregate_t;
+
+typedef struct {
+    char request_id[AGG_REQUEST_ID_MAX];
+    uint32_t members[GROUP_MAX_MEMBERS];    // 地址表下标
+    int8_t decisions[GROUP_MAX_MEMBERS];    // 最新决策：0=no_audit_needed, 1=provided_shares
+    uint8_t completed[GROUP_MAX_MEMBERS];   // 是否曾提供分片
+    uint8_t member_count;
+} request_aggregate_t;
+
+typedef struct {
+    uint64_t csv_offset;            // 已消费的决策文件长度
+    uint64_t csv_inode;             // 决策文件被替换或截断时从头重建
+    uint64_t majority_requests;     // 存在多数决策的请求数（一致性的分母）
+    address_aggregate_t* addresses;
+    size_t address_count;
+    size_t address_capacity;
+    request_aggregate_t* requests;
+    size_t request_count;
+    size_t request_capacity;
+    uint32_t* request_slots;        // request_id 哈希表，值为下标 + 1
+    size_t slot_capacity;
+    unsigned unsaved;               // 上次快照以来消费的行数
+} reputation_aggregates_t;
+
+// 快照文件头，后面依次是 address_count 个地址聚合和 request_count 个请求分组
+typedef struct {
+    char magic[8];
+    uint64_t csv_offset;
+    uint64_t csv_inode;
+    uint64_t majority_requests;
+    uint64_t address_count;
+    uint64_t request_count;
+} aggregates_snapshot_header_t;
 
 // 线程安全的决策记录
 typedef struct {
     pthread_mutex_t mutex;
     FILE* decisions_fp;  // 决策记录文件指针
     int initialized;
+    reputation_aggregates_t agg;
 } tracker_state_t;
 
 static tracker_state_t g_tracker_state = {0};
 
+static uint64_t aggregates_hash(const char* s) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (const unsigned char* p = (const unsigned char*)s; *p; p++) {
+        h ^= *p;
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+static void aggregates_reset(reputation_aggregates_t* agg) {
+    free(agg->addresses);
+    free(agg->requests);
+    free(agg->request_slots);
+    memset(agg, 0, sizeof(*agg));
+}
+
+// 地址按不区分大小写匹配（与全量计算的 strcasecmp 一致）；委员会规模很小，线性查找
+static long aggregates_find_address(const reputation_aggregates_t* agg, const char* address) {
+    for (size_t i = 0; i < agg->address_count; i++) {
+        if (strcasecmp(agg->addresses[i].address, address) == 0) {
+            return (long)i;
+        }
+    }
+    return -1;
+}
+
+static long aggregates_address(reputation_aggregates_t* agg, const char* address) {
+    long idx = aggregates_find_address(agg, address);
+    if (idx >= 0) {
+        return idx;
+    }
+    if (agg->address_count == agg->address_capacity) {
+        size_t capacity = agg->address_capacity ? agg->address_capacity * 2 : 16;
+        address_aggregate_t* grown = realloc(agg->addresses, capacity * sizeof(*grown));
+        if (!grown) {
+            return -1;
+        }
+        agg->addresses = grown;
+        agg->address_capacity = capacity;
+    }
+    address_aggregate_t* a = &agg->addresses[agg->address_count];
+    memset(a, 0, sizeof(*a));
+    snprintf(a->address, sizeof(a->address), "%s", address);
+    return (long)agg->address_count++;
+}
+
+static void aggregates_slot_insert(reputation_aggregates_t* agg, size_t request_idx) {
+    size_t mask = agg->slot_capacity - 1;
+    size_t i = (size_t)aggregates_hash(agg->requests[request_idx].request_id) & mask;
+    while (agg->request_slots[i] != 0) {
+        i = (i + 1) & mask;
+    }
+    agg->request_slots[i] = (uint32_t)request_idx + 1;
+}
+
+static int aggregates_rehash(reputation_aggregates_t* agg, size_t capacity) {
+    uint32_t* slots = calloc(capacity, sizeof(uint32_t));
+    if (!slots) {
+        return -1;
+    }
+    free(agg->request_slots);
+    agg->request_slots = slots;
+    agg->slot_capacity = capacity;
+    for (size_t i = 0; i < agg->request_count; i++) {
+        aggregates_slot_insert(agg, i);
+    }
+    return 0;
+}
+
+static request_aggregate_t* aggregates_request(reputation_aggregates_t* agg, const char* request_id) {
+    if (agg->slot_capacity > 0) {
+        size_t mask = agg->slot_capacity - 1;
+        for (size_t i = (size_t)aggregates_hash(request_id) & mask; agg->request_slots[i] != 0; i = (i + 1) & mask) {
+            request_aggregate_t* r = &agg->requests[agg->request_slots[i] - 1];
+            if (strcmp(r->request_id, request_id) == 0) {
+                return r;
+            }
+        }
+    }
+
+    if ((agg->request_count + 1) * 2 > agg->slot_capacity &&
+        aggregates_rehash(agg, agg->slot_capacity ? agg->slot_capacity * 2 : 1024) != 0) {
+        return NULL;
+    }
+    if (agg->request_count == agg->request_capacity) {
+        size_t capacity = agg->request_capacity ? agg->request_capacity * 2 : 256;
+        request_aggregate_t* grown = realloc(agg->requests, capacity * sizeof(*grown));
+        if (!grown) {
+            return NULL;
+        }
+        agg->requests = grown;
+        agg->request_capacity = capacity;
+    }
+    request_aggregate_t* r = &agg->requests[agg->request_count];
+    memset(r, 0, sizeof(*r));
+    snprintf(r->request_id, sizeof(r->request_id), "%s", request_id);
+    aggregates_slot_insert(agg, agg->request_count++);
+    return r;
+}
+
+// 多数决策：至少 2 个成员参与，且某一决策有至少 2 票；没有多数返回 -1
+static int request_majority(const request_aggregate_t* r) {
+    if (r->member_count < 2) {
+        return -1;
+    }
+    int no_audit_count = 0;
+    int provided_count = 0;
+    for (int j = 0; j < r->member_count; j++) {
+        if (r->decisions[j] == 0) {
+            no_audit_count++;
+        } else if (r->decisions[j] == 1) {
+            provided_count++;
+        }
+    }
+    if (no_audit_count >= 2) {
+        return 0;
+    }
+    if (provided_count >= 2) {
+        return 1;
+    }
+    return -1;
+}
+
+// 加上（sign > 0）或撤销（sign < 0）一个请求分组对一致性计数的贡献
+static void request_contribute(reputation_aggregates_t* agg, const request_aggregate_t* r, int sign) {
+    int majority = request_majority(r);
+    if (majority < 0) {
+        return;
+    }
+    agg->majority_requests += sign > 0 ? 1 : -1;
+    for (int j = 0; j < r->member_count; j++) {
+        if (r->decisions[j] == majority) {
+            agg->addresses[r->members[j]].agreed += sign > 0 ? 1 : -1;
+        }
+    }
+}
+
+// 按决策文件的一行更新聚合（列含义与全量计算相同）
+static void aggregates_apply_line(reputation_aggregates_t* agg, const char* line) {
+    char* fields[9];
+    int field_count = 0;
+    char line_copy[512];
+    strncpy(line_copy, line, sizeof(line_copy) - 1);
+    line_copy[sizeof(line_copy) - 1] = '\0';
+
+    char* token = strtok(line_copy, ",");
+    while (token && field_count < 9) {
+        fields[field_count++] = token;
+        token = strtok(NULL, ",");
+    }
+    if (field_count < 8) {
+        return;
+    }
+
+    const char* request_id = fields[1];
+    const char* participant_addr = fields[4];
+    int provided = strcmp(fields[6], "provided_shares") == 0;
+    int is_correct = atoi(fields[7]);
+
+    long addr_idx = aggregates_address(agg, participant_addr);
+    request_aggregate_t* r = aggregates_request(agg, request_id);
+    if (addr_idx < 0 || !r) {
+        fprintf(stderr, "[REPUTATION] 聚合内存不足，跳过一条决策\n");
+        return;
+    }
+    address_aggregate_t* a = &agg->addresses[addr_idx];
+    a->total++;
+    if (is_correct) {
+        a->correct++;
+    }
+
+    request_contribute(agg, r, -1);
+    int member = -1;
+    for (int j = 0; j < r->member_count; j++) {
+        if (r->members[j] == (uint32_t)addr_idx) {
+            member = j;
+            break;
+        }
+    }
+    if (member < 0 && r->member_count < GROUP_MAX_MEMBERS) {
+        member = r->member_count++;
+        r->members[member] = (uint32_t)addr_idx;
+        r->completed[member] = 0;
+        a->responded++;
+    }
+    if (member >= 0) {
+        r->decisions[member] = (int8_t)provided;
+        if (provided && !r->completed[member]) {
+            r->completed[member] = 1;
+            a->completed++;
+        }
+    }
+    request_contribute(agg, r, 1);
+}
+
+// 快照先写临时文件再 rename，多个 receiver 进程同时写时任一份都是某个文件前缀的完整聚合
+static int aggregates_save(reputation_aggregates_t* agg) {
+    char tmp_path[600];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.%d.tmp", AGGREGATES_FILE, (int)getpid());
+    FILE* fp = fopen(tmp_path, "wb");
+    if (!fp) {
+        fprintf(stderr, "[REPUTATION] 无法写入聚合快照: %s\n", tmp_path);
+        return -1;
+    }
+    aggregates_snapshot_header_t hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, AGGREGATES_MAGIC, sizeof(hdr.magic));
+    hdr.csv_offset = agg->csv_offset;
+    hdr.csv_inode = agg->csv_inode;
+    hdr.majority_requests = agg->majority_requests;
+    hdr.address_count = agg->address_count;
+    hdr.request_count = agg->request_count;
+
+    int ok = fwrite(&hdr, sizeof(hdr), 1, fp) == 1 &&
+             (agg->address_count == 0 ||
+              fwrite(agg->addresses, sizeof(address_aggregate_t), agg->address_count, fp) == agg->address_count) &&
+             (agg->request_count == 0 ||
+              fwrite(agg->requests, sizeof(request_aggregate_t), agg->request_count, fp) == agg->request_count);
+    ok = (fclose(fp) == 0) && ok;
+    if (!ok || rename(tmp_path, AGGREGATES_FILE) != 0) {
+        fprintf(stderr, "[REPUTATION] 保存聚合快照失败\n");
+        unlink(tmp_path);
+        return -1;
+    }
+    agg->unsaved = 0;
+    return 0;
+}
+
+// 读取快照；不存在或格式不符时返回 -1，调用方从决策文件开头重建
+static int aggregates_load(reputation_aggregates_t* agg) {
+    FILE* fp = fopen(AGGREGATES_FILE, "rb");
+    if (!fp) {
+        return -1;
+    }
+    aggregates_snapshot_header_t hdr;
+    int ok = fread(&hdr, sizeof(hdr), 1, fp) == 1 &&
+             memcmp(hdr.magic, AGGREGATES_MAGIC, sizeof(hdr.magic)) == 0 &&
+             hdr.address_count < (1u << 20) && hdr.request_count < (1u << 28);
+    if (ok) {
+        agg->addresses = malloc((hdr.address_count + 1) * sizeof(address_aggregate_t));
+        agg->requests = malloc((hdr.request_count + 1) * sizeof(request_aggregate_t));
+        ok = agg->addresses && agg->requests &&
+             fread(agg->addresses, sizeof(address_aggregate_t), hdr.address_count, fp) == hdr.address_count &&
+             fread(agg->requests, sizeof(request_aggregate_t), hdr.request_count, fp) == hdr.request_count;
+    }
+    fclose(fp);
+    if (ok) {
+        agg->address_count = hdr.address_count;
+        agg->address_capacity = hdr.address_count + 1;
+        agg->request_count = hdr.request_count;
+        agg->request_capacity = hdr.request_count + 1;
+        for (size_t i = 0; ok && i < agg->request_count; i++) {
+            request_aggregate_t* r = &agg->requests[i];
+            r->request_id[sizeof(r->request_id) - 1] = '\0';
+            ok = r->member_count <= GROUP_MAX_MEMBERS;
+            for (int j = 0; ok && j < r->member_count; j++) {
+                ok = r->members[j] < agg->address_count;
+            }
+        }
+        size_t capacity = 1024;
+        while (capacity < (agg->request_count + 1) * 2) {
+            capacity *= 2;
+        }
+        ok = ok && aggregates_rehash(agg, capacity) == 0;
+    }
+    if (!ok) {
+        fprintf(stderr, "[REPUTATION] 聚合快照无效，将从决策文件重建\n");
+        aggregates_reset(agg);
+        return -1;
+    }
+    agg->csv_offset = hdr.csv_offset;
+    agg->csv_inode = hdr.csv_inode;
+    agg->majority_requests = hdr.majority_requests;
+    return 0;
+}
+
+// 消费决策文件中 csv_offset 之后的完整行；只写了一半的行留到下次
+static int aggregates_catch_up(reputation_aggregates_t* agg) {
+    FILE* fp = fopen(DECISIONS_FILE, "r");
+    if (!fp) {
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fileno(fp), &st) != 0) {
+        fclose(fp);
+        return -1;
+    }
+    if ((uint64_t)st.st_ino != agg->csv_inode || (uint64_t)st.st_size < agg->csv_offset) {
+        if (agg->csv_offset > 0) {
+            printf("[REPUTATION] 决策文件已替换或截断，从头重建聚合\n");
+        }
+        aggregates_reset(agg);
+        agg->csv_inode = (uint64_t)st.st_ino;
+    }
+    if (fseeko(fp, (off_t)agg->csv_offset, SEEK_SET) != 0) {
+        fclose(fp);
+        return -1;
+    }
+
+    char* line = NULL;
+    size_t line_cap = 0;
+    ssize_t n;
+    while ((n = getline(&line, &line_cap, fp)) > 0) {
+        if (line[n - 1] != '\n') {
+            break;
+        }
+        if (agg->csv_offset > 0) {  // 第一行是表头
+            aggregates_apply_line(agg, line);
+            agg->unsaved++;
+        }
+        agg->csv_offset += (uint64_t)n;
+    }
+    free(line);
+    fclose(fp);
+
+    if (agg->unsaved >= AGGREGATES_SNAPSHOT_INTERVAL) {
+        aggregates_save(agg);
+    }
+    return 0;
+}
+
 /**
  * 初始化声誉跟踪系统
  */
@@ -78,6 +454,13 @@ int reputation_tracker_init(void) {
         fclose(test_fp);
     }
     
+    // 从快照恢复聚合并补上快照之后追加的决策
+    if (aggregates_load(&g_tracker_state.agg) == 0) {
+        printf("[REPUTATION] 已加载聚合快照: %zu 个地址, %zu 个请求\n",
+               g_tracker_state.agg.address_count, g_tracker_state.agg.request_count);
+    }
+    aggregates_catch_up(&g_tracker_state.agg);
+    
     g_tracker_state.initialized = 1;
     printf("[REPUTATION] 声誉跟踪系统初始化成功\n");
     
@@ -239,6 +622,9 @@ int reputation_tracker_record_decision(const char* request_id, const char* user_
             participant_address, judge_result, actual_decision, is_correct);
     fclose(fp);
     
+    // 增量更新聚合（同时吸收其它进程追加的决策）
+    aggregates_catch_up(&g_tracker_state.agg);
+    
     printf("[REPUTATION] 记录决策: request_id=%s, user_address=%s, label=%s, participant_address=%s, judge=%d, decision=%s, correct=%d\n",
            request_id, user_address, user_label, participant_address, judge_result, actual_decision, is_correct);
     
@@ -247,6 +633,8 @@ int reputation_tracker_record_decision(const char* request_id, const char* user_
     return 0;
 }
 
+// ================= 全量重算（逐地址扫描决策文件，仅用于校验增量聚合） =================
+
 /**
  * 计算准确率（基于address）
  */
@@ -511,8 +899,9 @@ static uint64_t calculate_participation_for_address(const char* address) {
         int found;
     } unique_request_t;
     
-    unique_request_t unique_requests[1000] = {0};
-    int unique_request_count = 0;
+    unique_request_t* unique_requests = NULL;
+    size_t unique_request_count = 0;
+    size_t unique_request_capacity = 0;
     
     char line[512];
     // 跳过表头
@@ -546,14 +935,24 @@ static uint64_t calculate_participation_for_address(const char* address) {
                 
                 // 检查是否已存在
                 int found = 0;
-                for (int i = 0; i < unique_request_count; i++) {
+                for (size_t i = 0; i < unique_request_count; i++) {
                     if (strcmp(unique_requests[i].request_id, request_id) == 0) {
                         found = 1;
                         break;
                     }
                 }
                 
-                if (!found && unique_request_count < 1000) {
+                if (!found && unique_request_count == unique_request_capacity) {
+                    size_t new_capacity = unique_request_capacity ? unique_request_capacity * 2 : 1000;
+                    unique_request_t* grown = (unique_request_t*)realloc(unique_requests, sizeof(unique_request_t) * new_capacity);
+                    if (grown == NULL) {
+                        break;
+                    }
+                    unique_requests = grown;
+                    unique_request_capacity = new_capacity;
+                }
+                
+                if (!found) {
                     strncpy(unique_requests[unique_request_count].request_id, request_id, 
                            sizeof(unique_requests[unique_request_count].request_id) - 1);
                     unique_requests[unique_request_count].request_id[sizeof(unique_requests[unique_request_count].request_id) - 1] = '\0';
@@ -628,6 +1027,7 @@ static uint64_t calculate_participation_for_address(const char* address) {
     
     // 计算参与度
     uint64_t total_requests = unique_request_count;  // 总请求数
+    free(unique_requests);
     uint64_t responded_requests = request_count;     // 该地址响应的请求数
     uint64_t completed_requests = 0;                 // 该地址完成的任务数
     
@@ -657,30 +1057,17 @@ static uint64_t calculate_participation_for_address(const char* address) {
 }
 
 /**
- * 计算并更新所有成员的声誉统计
+ * 全量计算决策总数和正确决策数（校验用）
  */
-int reputation_tracker_calculate_and_save_stats(void) {
-    if (!g_tracker_state.initialized) {
-        fprintf(stderr, "[REPUTATION] 跟踪系统未初始化\n");
-        return -1;
-    }
-    
-    pthread_mutex_lock(&g_tracker_state.mutex);
-    
-    // 从决策记录中提取所有唯一的地址
-    typedef struct {
-        char address[64];
-        int found;
-    } unique_address_t;
-    
-    unique_address_t unique_addresses[100] = {0};
-    int unique_count = 0;
+static void count_decisions_for_address(const char* addr, uint64_t* total_out, uint64_t* correct_out) {
+    uint64_t total = 0;
+    uint64_t correct = 0;
     
-    FILE* decisions_fp = fopen(DECISIONS_FILE, "r");
-    if (decisions_fp) {
+    FILE* decisions_fp2 = fopen(DECISIONS_FILE, "r");
+    if (decisions_fp2) {
         char line[512];
-        if (fgets(line, sizeof(line), decisions_fp)) {  // 跳过表头
-            while (fgets(line, sizeof(line), decisions_fp)) {
+        if (fgets(line, sizeof(line), decisions_fp2)) {  // 跳过表头
+            while (fgets(line, sizeof(line), decisions_fp2)) {
                 char* fields[9];
                 int field_count = 0;
                 char line_copy[512];
@@ -694,99 +1081,170 @@ int reputation_tracker_calculate_and_save_stats(void) {
                 }
                 
                 if (field_count >= 8) {
-                    // 新格式：participant_address在第4列（索引4）
-                    // 旧格式（兼容）：participant_address在第5列（索引5）
-                    const char* participant_addr = (field_count >= 8) ? fields[4] : fields[5];
-                    
-                    // 过滤无效地址：如果地址是纯数字（1, 2, 3）或不是0x开头，跳过
-                    // 这些可能是旧的格式错误或地址获取失败的情况
-                    if (participant_addr == NULL || strlen(participant_addr) == 0) {
-                        continue;  // 跳过空地址
-                    }
+                    // 新格式：participant_address在第4列，is_correct在第7列
+                    const char* participant_addr = fields[4];
+                    int is_correct = atoi(fields[7]);
                     
-                    // 检查是否是纯数字（可能是participant_id而不是address）
-                    int is_numeric = 1;
-                    for (size_t j = 0; j < strlen(participant_addr); j++) {
-                        if (!isdigit((unsigned char)participant_addr[j])) {
-                            is_numeric = 0;
-                            break;
+                    if (strcasecmp(participant_addr, addr) == 0) {
+                        total++;
+                        if (is_correct) {
+                            correct++;
                         }
                     }
-                    
-                    // 如果地址不是以0x开头，可能是格式错误
-                    int is_valid_address = (strlen(participant_addr) >= 2 && 
-                                           participant_addr[0] == '0' && 
-                                           (participant_addr[1] == 'x' || participant_addr[1] == 'X'));
-                    
-                    // 如果不是有效地址格式，尝试从committee_members.txt查找
-                    char actual_address[64] = {0};
-                    if (!is_valid_address) {
-                        // 如果是纯数字（1-3），尝试作为participant_id查找
-                        if (is_numeric && strlen(participant_addr) <= 3) {
-                            int pid = atoi(participant_addr);
-                            if (pid >= 1 && pid <= 3) {
-                                FILE* committee_fp = fopen(COMMITTEE_MEMBERS_FILE, "r");
-                                if (committee_fp) {
-                                    char line[256];
-                                    int line_num = 0;
-                                    while (fgets(line, sizeof(line), committee_fp) && line_num < 3) {
-                                        line_num++;
-                                        if (line_num == pid) {
-                                            size_t len = strlen(line);
-                                            while (len > 0 && (line[len-1] == '\n' || line[len-1] == '\r')) {
-                                                line[len-1] = '\0';
-                                                len--;
-                                            }
-                                            if (len > 0) {
-                                                strncpy(actual_address, line, sizeof(actual_address) - 1);
-                                                actual_address[sizeof(actual_address) - 1] = '\0';
-                                            }
-                                            break;
-                                        }
-                                    }
-                                    fclose(committee_fp);
-                                    
-                                    if (actual_address[0] != '\0') {
-                                        participant_addr = actual_address;  // 使用找到的地址
-                                        is_valid_address = 1;  // 现在有效了
-                                    } else {
-                                        fprintf(stderr, "[REPUTATION] 警告: 无法从committee_members.txt找到participant_id=%d对应的地址，跳过\n", pid);
-                                        continue;  // 找不到，跳过
-                                    }
-                                } else {
-                                    fprintf(stderr, "[REPUTATION] 警告: 无法打开committee_members.txt，跳过无效地址: %s\n", participant_addr);
-                                    continue;  // 无法打开文件，跳过
-                                }
-                            } else {
-                                fprintf(stderr, "[REPUTATION] 警告: 无效的participant_id: %s，跳过\n", participant_addr);
-                                continue;  // 无效的participant_id，跳过
-                            }
-                        } else {
-                            fprintf(stderr, "[REPUTATION] 警告: 无效的地址格式: %s，跳过\n", participant_addr);
-                            continue;  // 不是标准地址格式且不是有效的participant_id，跳过
-                        }
-                    }
-                    
-                    // 检查是否已存在
-                    int found = 0;
-                    for (int i = 0; i < unique_count; i++) {
-                        if (strcasecmp(unique_addresses[i].address, participant_addr) == 0) {
-                            found = 1;
-                            break;
-                        }
-                    }
-                    
-                    if (!found && unique_count < 100) {
-                        snprintf(unique_addresses[unique_count].address, 
-                                sizeof(unique_addresses[unique_count].address), 
-                                "%s", participant_addr);
-                        unique_count++;
-                    }
                 }
             }
         }
-        fclose(decisions_fp);
+        fclose(decisions_fp2);
+    }
+    *total_out = total;
+    *correct_out = correct;
+}
+
+/**
+ * 规范化决策文件中的 participant_address
+ * 0x 开头的地址原样返回；1-3 的纯数字视为 participant_id，从 committee_members.txt 查找对应地址
+ * 返回: 0=有效, -1=无效（跳过）
+ */
+static int resolve_participant_address(const char* participant_addr, char* address_out, size_t address_size) {
+    // 过滤无效地址：如果地址是纯数字（1, 2, 3）或不是0x开头，跳过
+    // 这些可能是旧的格式错误或地址获取失败的情况
+    if (participant_addr == NULL || strlen(participant_addr) == 0) {
+        return -1;  // 跳过空地址
+    }
+    
+    // 如果地址不是以0x开头，可能是格式错误
+    int is_valid_address = (strlen(participant_addr) >= 2 && 
+                           participant_addr[0] == '0' && 
+                           (participant_addr[1] == 'x' || participant_addr[1] == 'X'));
+    if (is_valid_address) {
+        snprintf(address_out, address_size, "%s", participant_addr);
+        return 0;
+    }
+    
+    // 检查是否是纯数字（可能是participant_id而不是address）
+    int is_numeric = 1;
+    for (size_t j = 0; j < strlen(participant_addr); j++) {
+        if (!isdigit((unsigned char)participant_addr[j])) {
+            is_numeric = 0;
+            break;
+        }
+    }
+    if (!is_numeric || strlen(participant_addr) > 3) {
+        fprintf(stderr, "[REPUTATION] 警告: 无效的地址格式: %s，跳过\n", participant_addr);
+        return -1;  // 不是标准地址格式且不是有效的participant_id，跳过
+    }
+    
+    // 如果是纯数字（1-3），尝试作为participant_id查找
+    int pid = atoi(participant_addr);
+    if (pid < 1 || pid > 3) {
+        fprintf(stderr, "[REPUTATION] 警告: 无效的participant_id: %s，跳过\n", participant_addr);
+        return -1;
+    }
+    FILE* committee_fp = fopen(COMMITTEE_MEMBERS_FILE, "r");
+    if (!committee_fp) {
+        fprintf(stderr, "[REPUTATION] 警告: 无法打开committee_members.txt，跳过无效地址: %s\n", participant_addr);
+        return -1;
+    }
+    char actual_address[64] = {0};
+    char line[256];
+    int line_num = 0;
+    while (fgets(line, sizeof(line), committee_fp) && line_num < 3) {
+        line_num++;
+        if (line_num == pid) {
+            size_t len = strlen(line);
+            while (len > 0 && (line[len-1] == '\n' || line[len-1] == '\r')) {
+                line[len-1] = '\0';
+                len--;
+            }
+            if (len > 0) {
+                strncpy(actual_address, line, sizeof(actual_address) - 1);
+                actual_address[sizeof(actual_address) - 1] = '\0';
+            }
+            break;
+        }
+    }
+    fclose(committee_fp);
+    
+    if (actual_address[0] == '\0') {
+        fprintf(stderr, "[REPUTATION] 警告: 无法从committee_members.txt找到participant_id=%d对应的地址，跳过\n", pid);
+        return -1;
+    }
+    snprintf(address_out, address_size, "%s", actual_address);
+    return 0;
+}
+
+#define MAX_STATS_ADDRESSES 100
+
+// 按首次出现顺序列出需要输出统计的地址（规范化并去重）
+static int collect_stats_addresses(const reputation_aggregates_t* agg, char addresses[][AGG_ADDRESS_MAX]) {
+    int unique_count = 0;
+    for (size_t i = 0; i < agg->address_count && unique_count < MAX_STATS_ADDRESSES; i++) {
+        char resolved[AGG_ADDRESS_MAX];
+        if (resolve_participant_address(agg->addresses[i].address, resolved, sizeof(resolved)) != 0) {
+            continue;
+        }
+        int found = 0;
+        for (int j = 0; j < unique_count; j++) {
+            if (strcasecmp(addresses[j], resolved) == 0) {
+                found = 1;
+                break;
+            }
+        }
+        if (!found) {
+            snprintf(addresses[unique_count++], AGG_ADDRESS_MAX, "%s", resolved);
+        }
+    }
+    return unique_count;
+}
+
+typedef struct {
+    uint64_t total;
+    uint64_t correct;
+    uint64_t accuracy;
+    uint64_t consistency;
+    uint64_t participation;
+} address_stats_t;
+
+/**
+ * 由聚合计数得到一个地址的统计，定义与全量计算相同，O(1)
+ */
+static void aggregates_address_stats(const reputation_aggregates_t* agg, const char* address, address_stats_t* out) {
+    long idx = aggregates_find_address(agg, address);
+    const address_aggregate_t* a = idx >= 0 ? &agg->addresses[idx] : NULL;
+    memset(out, 0, sizeof(*out));
+    
+    out->total = a ? a->total : 0;
+    out->correct = a ? a->correct : 0;
+    out->accuracy = out->total ? (out->correct * 100) / out->total : 50;
+    out->consistency = agg->majority_requests ? ((a ? a->agreed : 0) * 100) / agg->majority_requests : 50;
+    
+    // 参与度 = (响应率 + 任务完成率) / 2
+    if (agg->request_count == 0) {
+        out->participation = 50;
+    } else {
+        uint64_t responded = a ? a->responded : 0;
+        uint64_t response_rate = (responded * 100) / agg->request_count;
+        uint64_t completion_rate = responded > 0 ? (a->completed * 100) / responded : 0;
+        out->participation = (response_rate + completion_rate) / 2;
     }
+}
+
+/**
+ * 计算并更新所有成员的声誉统计
+ * 只读取决策文件中上次之后新增的行，统计本身由聚合计数得到，与历史决策数无关
+ */
+int reputation_tracker_calculate_and_save_stats(void) {
+    if (!g_tracker_state.initialized) {
+        fprintf(stderr, "[REPUTATION] 跟踪系统未初始化\n");
+        return -1;
+    }
+    
+    pthread_mutex_lock(&g_tracker_state.mutex);
+    reputation_aggregates_t* agg = &g_tracker_state.agg;
+    aggregates_catch_up(agg);
+    
+    char unique_addresses[MAX_STATS_ADDRESSES][AGG_ADDRESS_MAX];
+    int unique_count = collect_stats_addresses(agg, unique_addresses);
     
     // 计算每个地址的声誉
     FILE* stats_fp = fopen(STATS_FILE, "w");
@@ -802,66 +1260,21 @@ int reputation_tracker_calculate_and_save_stats(void) {
     time_t update_time = time(NULL);
     
     for (int i = 0; i < unique_count; i++) {
-        const char* addr = unique_addresses[i].address;
-        
-        // 计算准确率
-        uint64_t accuracy = calculate_accuracy_for_address(addr);
-        
-        // 计算一致性
-        uint64_t consistency = calculate_consistency_for_address(addr);
+        const char* addr = unique_addresses[i];
+        address_stats_t st;
+        aggregates_address_stats(agg, addr, &st);
         
-        // 计算参与度（新增）
-        uint64_t participation = calculate_participation_for_address(addr);
-        
-        // 计算总决策数和正确决策数
-        uint64_t total = 0;
-        uint64_t correct = 0;
-        
-        FILE* decisions_fp2 = fopen(DECISIONS_FILE, "r");
-        if (decisions_fp2) {
-            char line[512];
-            if (fgets(line, sizeof(line), decisions_fp2)) {  // 跳过表头
-                while (fgets(line, sizeof(line), decisions_fp2)) {
-                    char* fields[9];
-                    int field_count = 0;
-                    char line_copy[512];
-                    strncpy(line_copy, line, sizeof(line_copy) - 1);
-                    line_copy[sizeof(line_copy) - 1] = '\0';
-                    
-                    char* token = strtok(line_copy, ",");
-                    while (token && field_count < 9) {
-                        fields[field_count++] = token;
-                        token = strtok(NULL, ",");
-                    }
-                    
-                    if (field_count >= 8) {
-                        // 新格式：participant_address在第4列，is_correct在第7列
-                        // 旧格式（兼容）：participant_address在第5列，is_correct在第8列
-                        const char* participant_addr = (field_count >= 8) ? fields[4] : fields[5];
-                        int is_correct = (field_count >= 8) ? atoi(fields[7]) : atoi(fields[8]);
-                        
-                        if (strcasecmp(participant_addr, addr) == 0) {
-                            total++;
-                            if (is_correct) {
-                                correct++;
-                            }
-                        }
-                    }
-                }
-            }
-            fclose(decisions_fp2);
-        }
-        
-        uint64_t total_reputation = accuracy + consistency;
+        uint64_t total_reputation = st.accuracy + st.consistency;
         
         fprintf(stats_fp, "%s,%lu,%lu,%lu,%lu,%lu,%lu,%ld\n",
-                addr, total, correct, accuracy, consistency, participation, total_reputation, update_time);
+                addr, st.total, st.correct, st.accuracy, st.consistency, st.participation, total_reputation, update_time);
         
         printf("[REPUTATION] 地址 %s: 准确率=%lu%%, 一致性=%lu%%, 参与度=%lu%%, 综合声誉=%lu, 总决策=%lu, 正确决策=%lu\n",
-               addr, accuracy, consistency, participation, total_reputation, total, correct);
+               addr, st.accuracy, st.consistency, st.participation, total_reputation, st.total, st.correct);
     }
     
     fclose(stats_fp);
+    aggregates_save(agg);
     
     printf("[REPUTATION] 已保存声誉统计到: %s\n", STATS_FILE);
     
@@ -870,11 +1283,56 @@ int reputation_tracker_calculate_and_save_stats(void) {
     return 0;
 }
 
+/**
+ * 用全量重算（逐地址扫描决策文件）校验增量聚合
+ * 返回: 不一致的地址数，-1=未初始化
+ */
+int reputation_tracker_verify_stats(void) {
+    if (!g_tracker_state.initialized) {
+        fprintf(stderr, "[REPUTATION] 跟踪系统未初始化\n");
+        return -1;
+    }
+    
+    pthread_mutex_lock(&g_tracker_state.mutex);
+    reputation_aggregates_t* agg = &g_tracker_state.agg;
+    aggregates_catch_up(agg);
+    
+    char unique_addresses[MAX_STATS_ADDRESSES][AGG_ADDRESS_MAX];
+    int unique_count = collect_stats_addresses(agg, unique_addresses);
+    int mismatches = 0;
+    
+    for (int i = 0; i < unique_count; i++) {
+        const char* addr = unique_addresses[i];
+        address_stats_t inc, full;
+        aggregates_address_stats(agg, addr, &inc);
+        count_decisions_for_address(addr, &full.total, &full.correct);
+        full.accuracy = calculate_accuracy_for_address(addr);
+        full.consistency = calculate_consistency_for_address(addr);
+        full.participation = calculate_participation_for_address(addr);
+        
+        if (memcmp(&inc, &full, sizeof(inc)) != 0) {
+            mismatches++;
+            printf("[REPUTATION] 校验不一致 %s: 增量(总=%lu,正确=%lu,准确率=%lu,一致性=%lu,参与度=%lu) "
+                   "全量(总=%lu,正确=%lu,准确率=%lu,一致性=%lu,参与度=%lu)\n",
+                   addr, inc.total, inc.correct, inc.accuracy, inc.consistency, inc.participation,
+                   full.total, full.correct, full.accuracy, full.consistency, full.participation);
+        }
+    }
+    printf("[REPUTATION] 校验完成: %d 个地址, %d 个不一致\n", unique_count, mismatches);
+    
+    pthread_mutex_unlock(&g_tracker_state.mutex);
+    return mismatches;
+}
+
 /**
  * 清理资源
  */
 void reputation_tracker_cleanup(void) {
     if (g_tracker_state.initialized) {
+        if (g_tracker_state.agg.unsaved > 0) {
+            aggregates_save(&g_tracker_state.agg);
+        }
+        aggregates_reset(&g_tracker_state.agg);
         pthread_mutex_destroy(&g_tracker_state.mutex);
         g_tracker_state.initialized = 0;
     }
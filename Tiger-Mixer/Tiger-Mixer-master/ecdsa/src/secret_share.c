@@ -1,10 +1,13 @@
 #include "secret_share.h"
 #include "zmq.h"
+#include "share_dispatch.h"
+#include "vss_archive.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <errno.h>
+#include <sys/stat.h>
 #include "util.h"
 #include "types.h"
 
@@ -275,12 +278,12 @@ int create_secret_shares(const uint8_t* secret, size_t secret_len, secret_share_
             shares[share_idx].block_index = block_idx;
             shares[share_idx].data_length = secret_len;
             shares[share_idx].block_size = block_size;
-            memset(shares[share_idx].y, 0, SHARE_SIZE);
+            memset(shares[share_idx].y, 0, sizeof(shares[share_idx].y));
             
             // 序列化分享值到y数组
             // 格式：[长度(4字节)][大整数字节]
             size_t share_size = bn_size_bin(share_value);
-            if (share_size + 4 > SHARE_SIZE) {
+            if (share_size > SHARE_VALUE_MAX) {
                 fprintf(stderr, "Error: Share value too large to serialize\n");
                 // 清理资源
                 for (int i = 0; i < THRESHOLD; i++) {
@@ -330,9 +333,98 @@ int create_secret_shares(const uint8_t* secret, size_t secret_len, secret_share_
     return 0;
 }
 
+// ================= 信封尾部 =================
+size_t write_share_envelope_trailer(uint8_t* out, const uint8_t* envelope, size_t envelope_len) {
+    uint32_t magic = SHARE_ENVELOPE_MAGIC;
+    uint32_t len32 = (uint32_t)envelope_len;
+    memcpy(out, &magic, 4);
+    memcpy(out + 4, &len32, 4);
+    memcpy(out + SHARE_ENVELOPE_TRAILER_HDR, envelope, envelope_len);
+    return SHARE_ENVELOPE_TRAILER_HDR + envelope_len;
+}
+
+int parse_share_envelope_trailer(const uint8_t* data, size_t size, const uint8_t** envelope, size_t* envelope_len) {
+    uint32_t magic = 0, len32 = 0;
+    if (data == NULL || size < SHARE_ENVELOPE_TRAILER_HDR) return -1;
+    memcpy(&magic, data, 4);
+    memcpy(&len32, data + 4, 4);
+    if (magic != SHARE_ENVELOPE_MAGIC || len32 < SHARE_ENVELOPE_OVERHEAD ||
+        len32 > size - SHARE_ENVELOPE_TRAILER_HDR) {
+        return -1;
+    }
+    *envelope = data + SHARE_ENVELOPE_TRAILER_HDR;
+    *envelope_len = len32;
+    return 0;
+}
+
+// 为一个参与者打包其所有块的分享：x | num_blocks | (block_index | block_size | data_length | share_value)...
+// 返回序列化后的消息（调用方 free），该参与者没有分享时返回 NULL
+static uint8_t* serialize_participant_shares(const secret_share_t* shares, size_t num_shares, int participant,
+                                             const uint8_t* envelope, size_t envelope_len,
+                                             const char* msg_id, size_t* out_len, size_t* out_count) {
+    size_t participant_share_count = 0;
+    size_t total_data_size = sizeof(int) + sizeof(size_t);  // x + num_blocks
+    for (size_t share_idx = 0; share_idx < num_shares; share_idx++) {
+        if (shares[share_idx].x != participant) continue;
+        size_t share_data_size = shares[share_idx].y[0] |
+                               (shares[share_idx].y[1] << 8) |
+                               (shares[share_idx].y[2] << 16) |
+                               (shares[share_idx].y[3] << 24);
+        total_data_size += sizeof(size_t) + sizeof(size_t) + sizeof(size_t) + share_data_size + 4;  // block_index + block_size + data_length + share_value
+        participant_share_count++;
+    }
+    *out_count = participant_share_count;
+    if (participant_share_count == 0) return NULL;
+    if (envelope != NULL && envelope_len > 0) {
+        total_data_size += SHARE_ENVELOPE_TRAILER_HDR + envelope_len;
+    }
+    
+    const unsigned share_msg_type_length = strlen(msg_id) + 1;
+    message_t share_msg;
+    message_null(share_msg);
+    message_new(share_msg, share_msg_type_length, total_data_size);
+    
+    size_t data_offset = 0;
+    memcpy(share_msg->data + data_offset, &participant, sizeof(int));
+    data_offset += sizeof(int);
+    memcpy(share_msg->data + data_offset, &participant_share_count, sizeof(size_t));
+    data_offset += sizeof(size_t);
+    
+    for (size_t share_idx = 0; share_idx < num_shares; share_idx++) {
+        if (shares[share_idx].x != participant) continue;
+        size_t share_data_size = shares[share_idx].y[0] |
+                               (shares[share_idx].y[1] << 8) |
+                               (shares[share_idx].y[2] << 16) |
+                               (shares[share_idx].y[3] << 24);
+        memcpy(share_msg->data + data_offset, &shares[share_idx].block_index, sizeof(size_t));
+        data_offset += sizeof(size_t);
+        memcpy(share_msg->data + data_offset, &shares[share_idx].block_size, sizeof(size_t));
+        data_offset += sizeof(size_t);
+        memcpy(share_msg->data + data_offset, &shares[share_idx].data_length, sizeof(size_t));
+        data_offset += sizeof(size_t);
+        memcpy(share_msg->data + data_offset, shares[share_idx].y, share_data_size + 4);
+        data_offset += share_data_size + 4;
+    }
+    if (envelope != NULL && envelope_len > 0) {
+        data_offset += write_share_envelope_trailer(share_msg->data + data_offset, envelope, envelope_len);
+    }
+    memcpy(share_msg->type, msg_id, share_msg_type_length);
+    
+    uint8_t* serialized_share_message = NULL;
+    serialize_message(&serialized_share_message, share_msg, share_msg_type_length, total_data_size);
+    message_free(share_msg);
+    *out_len = share_msg_type_length + total_data_size + (2 * sizeof(unsigned));
+    return serialized_share_message;
+}
+
 // ================= 发送分享 =================
-int send_shares_to_receivers(secret_share_t* shares, size_t num_shares, const char* msg_id, const char** receiver_endpoints) {
-    printf("[VSS] send_shares_to_receivers called with msg_id: %s, num_shares: %zu\n", msg_id, num_shares);
+// 所有接收者并发发送（见 share_dispatch.h），收到 THRESHOLD 个 ACK 即返回，其余在后台完成
+// envelope 非空时作为尾部附在每个接收者的消息之后（混合模式）
+static int dispatch_shares_to_receivers(secret_share_t* shares, size_t num_shares,
+                                        const uint8_t* envelope, size_t envelope_len,
+                                        const char* msg_id, const char** receiver_endpoints) {
+    printf("[VSS] send_shares_to_receivers called with msg_id: %s, num_shares: %zu, envelope: %zu bytes\n",
+           msg_id, num_shares, envelope_len);
     
     // 检查参数有效性
     if (shares == NULL) {
@@ -344,190 +436,61 @@ int send_shares_to_receivers(secret_share_t* shares, size_t num_shares, const ch
         return -1;
     }
     
-    void* context = zmq_ctx_new();
-    if (!context) {
-        fprintf(stderr, "[VSS] Error: could not create context for secret sharing\n");
-        return -1;
-    }
-    
-    // 为每个参与者发送所有块的分享
-    int connected_count = 0;
-    int total_sent = 0;
+    const char* endpoints[SECRET_SHARES] = {0};
+    uint8_t* payloads[SECRET_SHARES] = {0};
+    size_t lens[SECRET_SHARES] = {0};
+    int targeted = 0;
     
     for (int participant = 1; participant <= SECRET_SHARES; participant++) {
-        // 检查端点
         int endpoint_idx = participant - 1;
-        if (receiver_endpoints[endpoint_idx] == NULL) {
-            printf("[VSS] Receiver endpoint[%d] is NULL, skipping\n", endpoint_idx);
-            continue;
-        }
-        
         const char* endpoint = receiver_endpoints[endpoint_idx];
-        if (endpoint[0] == '\0') {
+        if (endpoint == NULL || endpoint[0] == '\0') {
             printf("[VSS] Receiver endpoint[%d] is empty, skipping\n", endpoint_idx);
             continue;
         }
-        
-        void* socket = zmq_socket(context, ZMQ_REQ);
-        if (!socket) {
-            fprintf(stderr, "Error: could not create socket for receiver %d\n", endpoint_idx);
-            continue;
-        }
-        // 增加超时时间：处理531个块可能需要较长时间（保存到JSON文件）
-        int timeout = 30000;  // 30秒超时
-        zmq_setsockopt(socket, ZMQ_RCVTIMEO, &timeout, sizeof(timeout));
-        zmq_setsockopt(socket, ZMQ_SNDTIMEO, &timeout, sizeof(timeout));
-        
-        printf("[VSS] Attempting to connect to receiver %d at %s\n", endpoint_idx, endpoint);
-        int rc = zmq_connect(socket, endpoint);
-        if (rc != 0) {
-            fprintf(stderr, "Error: could not connect to receiver %d at %s (rc=%d, errno=%d: %s)\n", 
-                    endpoint_idx, endpoint, rc, errno, zmq_strerror(errno));
-            zmq_close(socket);
-            continue;
-        }
-        printf("[VSS] Successfully connected to receiver %d\n", endpoint_idx);
-        connected_count++;
-        
-        // 收集该参与者的所有块的分享
-        size_t participant_shares[1000];  // 存储该参与者的分享索引
         size_t participant_share_count = 0;
-        size_t secret_len = 0;
-        
-        for (size_t share_idx = 0; share_idx < num_shares; share_idx++) {
-            if (shares[share_idx].x == participant) {
-                participant_shares[participant_share_count++] = share_idx;
-                secret_len = shares[share_idx].data_length;  // 所有块都有相同的 data_length
-            }
-        }
-        
-        if (participant_share_count == 0) {
+        payloads[endpoint_idx] = serialize_participant_shares(shares, num_shares, participant,
+                                                              envelope, envelope_len, msg_id,
+                                                              &lens[endpoint_idx], &participant_share_count);
+        if (payloads[endpoint_idx] == NULL) {
             printf("[VSS] No shares found for participant %d, skipping\n", participant);
-            zmq_close(socket);
             continue;
         }
-        
-        // 计算打包消息的总大小
-        size_t total_data_size = sizeof(int) + sizeof(size_t);  // x + num_blocks
-        for (size_t i = 0; i < participant_share_count; i++) {
-            size_t share_idx = participant_shares[i];
-            size_t share_data_size = shares[share_idx].y[0] |
-                                   (shares[share_idx].y[1] << 8) |
-                                   (shares[share_idx].y[2] << 16) |
-                                   (shares[share_idx].y[3] << 24);
-            total_data_size += sizeof(size_t) + sizeof(size_t) + sizeof(size_t) + share_data_size + 4;  // block_index + block_size + data_length + share_value
-        }
-        
-        const char* share_msg_type = msg_id;
-        const unsigned share_msg_type_length = strlen(share_msg_type) + 1;
-        const int total_share_msg_length = share_msg_type_length + total_data_size + (2 * sizeof(unsigned));
-        
-        message_t share_msg;
-        message_null(share_msg);
-        message_new(share_msg, share_msg_type_length, total_data_size);
-        
-        // 序列化：x | num_blocks | (block_index | block_size | data_length | share_value)...
-        size_t data_offset = 0;
-        memcpy(share_msg->data + data_offset, &participant, sizeof(int));
-        data_offset += sizeof(int);
-        memcpy(share_msg->data + data_offset, &participant_share_count, sizeof(size_t));
-        data_offset += sizeof(size_t);
-        
-        // 序列化每个块的分享
-        for (size_t i = 0; i < participant_share_count; i++) {
-            size_t share_idx = participant_shares[i];
-            size_t share_data_size = shares[share_idx].y[0] |
-                                   (shares[share_idx].y[1] << 8) |
-                                   (shares[share_idx].y[2] << 16) |
-                                   (shares[share_idx].y[3] << 24);
-            
-            memcpy(share_msg->data + data_offset, &shares[share_idx].block_index, sizeof(size_t));
-            data_offset += sizeof(size_t);
-            memcpy(share_msg->data + data_offset, &shares[share_idx].block_size, sizeof(size_t));
-            data_offset += sizeof(size_t);
-            memcpy(share_msg->data + data_offset, &shares[share_idx].data_length, sizeof(size_t));
-            data_offset += sizeof(size_t);
-            memcpy(share_msg->data + data_offset, shares[share_idx].y, share_data_size + 4);
-            data_offset += share_data_size + 4;
-        }
-        
-        memcpy(share_msg->type, share_msg_type, share_msg_type_length);
-        
-        uint8_t* serialized_share_message = NULL;
-        serialize_message(&serialized_share_message, share_msg, share_msg_type_length, total_data_size);
-        zmq_msg_t share_zmq_msg;
-        rc = zmq_msg_init_size(&share_zmq_msg, total_share_msg_length);
-        if (rc == 0) {
-            memcpy(zmq_msg_data(&share_zmq_msg), serialized_share_message, total_share_msg_length);
-            rc = zmq_msg_send(&share_zmq_msg, socket, 0);
-            if (rc == total_share_msg_length) {
-                // REQ-REP 模式：必须等待响应才能发送下一条消息
-                printf("[VSS] Waiting for ACK from receiver %d (participant=%d, %zu blocks)...\n", 
-                       endpoint_idx, participant, participant_share_count);
-                zmq_msg_t reply;
-                zmq_msg_init(&reply);
-                rc = zmq_msg_recv(&reply, socket, 0);
-                if (rc >= 0) {
-                    // 收到响应，检查响应内容
-                    char* reply_data = (char*)zmq_msg_data(&reply);
-                    size_t reply_size = zmq_msg_size(&reply);
-                    if (reply_size > 0) {
-                        // 确保字符串以null结尾
-                        char reply_str[64] = {0};
-                        size_t copy_len = (reply_size < sizeof(reply_str) - 1) ? reply_size : sizeof(reply_str) - 1;
-                        memcpy(reply_str, reply_data, copy_len);
-                        reply_str[copy_len] = '\0';
-                        
-                        if (strcmp(reply_str, "ACK") == 0) {
-                            // 收到确认，发送成功
-                            total_sent += participant_share_count;
-                            printf("[VSS] Successfully sent %zu shares (participant=%d, blocks=0-%zu) to receiver at %s\n", 
-                                   participant_share_count, participant, participant_share_count - 1, endpoint);
-                        } else if (strcmp(reply_str, "SAVE_ERROR") == 0) {
-                            fprintf(stderr, "[VSS] Error: Receiver %d reported SAVE_ERROR for participant %d\n", 
-                                    endpoint_idx, participant);
-                        } else {
-                            printf("[VSS] Warning: Unexpected reply from receiver %d: %s\n", endpoint_idx, reply_str);
-                            // 仍然认为发送成功（可能是旧格式的响应）
-                            total_sent += participant_share_count;
-                        }
-                    } else {
-                        printf("[VSS] Warning: Empty reply from receiver %d, assuming success\n", endpoint_idx);
-                        total_sent += participant_share_count;
-                    }
-                    zmq_msg_close(&reply);
-                } else {
-                    // 接收响应失败（可能是超时）
-                    fprintf(stderr, "[VSS] Error: failed to receive reply for participant %d (rc=%d, errno=%d: %s)\n", 
-                            participant, rc, errno, zmq_strerror(errno));
-                    fprintf(stderr, "[VSS] This may indicate that receiver %d is not running or processing too slowly\n", endpoint_idx);
-                    zmq_msg_close(&reply);
-                }
-            } else {
-                fprintf(stderr, "[VSS] Error: failed to send shares for participant %d to receiver at %s (rc=%d, expected=%d, errno=%d: %s)\n", 
-                        participant, endpoint, rc, total_share_msg_length, errno, zmq_strerror(errno));
-            }
-            zmq_msg_close(&share_zmq_msg);
-        } else {
-            fprintf(stderr, "[VSS] Error: failed to initialize message for participant %d\n", participant);
-        }
-        if (share_msg != NULL) message_free(share_msg);
-        if (serialized_share_message != NULL) free(serialized_share_message);
-        
-        printf("[VSS] Sent %zu shares to receiver %d\n", participant_share_count, endpoint_idx);
-        zmq_close(socket);
+        endpoints[endpoint_idx] = endpoint;
+        targeted++;
+        printf("[VSS] Dispatching %zu shares (participant=%d) to receiver %d at %s\n",
+               participant_share_count, participant, endpoint_idx, endpoint);
+    }
+    
+    int acks = targeted > 0 ? share_dispatch(endpoints, payloads, lens, SECRET_SHARES, THRESHOLD) : 0;
+    for (int i = 0; i < SECRET_SHARES; i++) {
+        free(payloads[i]);
     }
-    zmq_ctx_destroy(context);
     
-    if (connected_count == 0) {
-        fprintf(stderr, "[VSS] Warning: No receivers connected successfully\n");
+    if (acks < THRESHOLD) {
+        fprintf(stderr, "[VSS] Warning: only %d of %d receivers acknowledged (threshold %d)\n",
+                acks < 0 ? 0 : acks, targeted, THRESHOLD);
         return -1;
     }
     
-    printf("[VSS] Successfully sent %d shares to %d out of %d receivers\n", total_sent, connected_count, SECRET_SHARES);
+    printf("[VSS] %d of %d receivers acknowledged, remaining deliveries continue in background\n", acks, targeted);
     return 0;
 }
 
+int send_shares_to_receivers(secret_share_t* shares, size_t num_shares, const char* msg_id, const char** receiver_endpoints) {
+    return dispatch_shares_to_receivers(shares, num_shares, NULL, 0, msg_id, receiver_endpoints);
+}
+
+int send_hybrid_shares_to_receivers(secret_share_t* shares, size_t num_shares,
+                                    const uint8_t* envelope, size_t envelope_len,
+                                    const char* msg_id, const char** receiver_endpoints) {
+    if (envelope == NULL || envelope_len < SHARE_ENVELOPE_OVERHEAD) {
+        fprintf(stderr, "[VSS] Error: invalid hybrid envelope\n");
+        return -1;
+    }
+    return dispatch_shares_to_receivers(shares, num_shares, envelope, envelope_len, msg_id, receiver_endpoints);
+}
+
 // ================= 解析分享消息 =================
 int parse_share_message(uint8_t* data, size_t data_size, secret_share_t* share, char* msg_type) {
     // 新格式：x | block_index | data_length | block_size | y
@@ -552,8 +515,8 @@ int parse_share_message(uint8_t* data, size_t data_size, secret_share_t* share,
                             (data[offset + 3] << 24);
     offset += 4;
     
-    if (share_data_size > SHARE_SIZE - 4) {
-        fprintf(stderr, "Error: share data size too large (%zu > %d)\n", share_data_size, SHARE_SIZE - 4);
+    if (share_data_size > SHARE_VALUE_MAX) {
+        fprintf(stderr, "Error: share data size too large (%zu > %d)\n", share_data_size, SHARE_VALUE_MAX);
         return -1;
     }
     
@@ -688,7 +651,7 @@ int reconstruct_secret(share_collector_t* collector, uint8_t* reconstructed_data
                                        (collector->shares[i].y[2] << 16) |
                                        (collector->shares[i].y[3] << 24);
                     
-                    if (share_size == 0 || share_size > SHARE_SIZE - 4) {
+                    if (share_size == 0 || share_size > SHARE_VALUE_MAX) {
                         fprintf(stderr, "Error: Invalid share size for block %zu: %zu\n", block_idx, share_size);
                         for (int j = 0; j < share_count; j++) {
                             bn_free(block_shares[j]);
@@ -838,7 +801,7 @@ int reconstruct_secret_from_shares(secret_share_t* shares, int share_count, uint
                                    (shares[i].y[2] << 16) |
                                    (shares[i].y[3] << 24);
                 
-                if (share_size == 0 || share_size > SHARE_SIZE - 4) {
+                if (share_size == 0 || share_size > SHARE_VALUE_MAX) {
                     fprintf(stderr, "Error: Invalid share size for block %zu: %zu\n", block_idx, share_size);
                     for (int j = 0; j < share_count_for_block; j++) {
                         bn_free(block_shares[j]);
@@ -929,12 +892,120 @@ int reconstruct_secret_from_shares(secret_share_t* shares, int share_count, uint
     return 0;
 }
 
+// ================= 混合模式 =================
+int share_mode_hybrid(void) {
+    const char* mode = getenv(SHARE_MODE_ENV);
+    return mode != NULL && strcmp(mode, "hybrid") == 0;
+}
+
+int create_hybrid_shares(const uint8_t* secret, size_t secret_len, const char* msgid,
+                         secret_share_t* shares, size_t* num_shares_out, vss_commitment_t* commitment,
+                         uint8_t** envelope_out, size_t* envelope_len_out) {
+    if (secret == NULL || secret_len == 0 || secret_len > MAX_MESSAGE_SIZE || msgid == NULL ||
+        shares == NULL || envelope_out == NULL || envelope_len_out == NULL) {
+        fprintf(stderr, "[VSS][Hybrid] Error: invalid arguments\n");
+        return -1;
+    }
+    *envelope_out = NULL;
+    *envelope_len_out = 0;
+
+    size_t envelope_len = AEAD_NONCE_SIZE + secret_len + AEAD_TAG_SIZE;
+    uint8_t* envelope = (uint8_t*)malloc(envelope_len);
+    if (envelope == NULL) {
+        fprintf(stderr, "[VSS][Hybrid] Error: failed to allocate envelope\n");
+        return -1;
+    }
+
+    uint8_t key[SHARE_KEY_SIZE];
+    rand_bytes(key, SHARE_KEY_SIZE);
+    rand_bytes(envelope, AEAD_NONCE_SIZE);
+    if (aead_encrypt(envelope + AEAD_NONCE_SIZE, secret, secret_len,
+                     (const uint8_t*)msgid, strlen(msgid), envelope, key) != RLC_OK) {
+        fprintf(stderr, "[VSS][Hybrid] Error: payload encryption failed\n");
+        memset(key, 0, sizeof(key));
+        free(envelope);
+        return -1;
+    }
+
+    // 承诺依赖 create_secret_shares 保存的系数，必须紧接着创建
+    int result = create_secret_shares(key, SHARE_KEY_SIZE, shares, num_shares_out);
+    if (result == 0 && commitment != NULL &&
+        create_vss_commitments(key, SHARE_KEY_SIZE, shares, commitment, msgid) != 0) {
+        fprintf(stderr, "[VSS][Hybrid] Error: failed to create key commitments\n");
+        result = -1;
+    }
+    memset(key, 0, sizeof(key));
+    if (result != 0) {
+        free(envelope);
+        return -1;
+    }
+
+    *envelope_out = envelope;
+    *envelope_len_out = envelope_len;
+    printf("[VSS][Hybrid] Shared %d-byte key, payload %zu bytes encrypted once (envelope %zu bytes)\n",
+           SHARE_KEY_SIZE, secret_len, envelope_len);
+    return 0;
+}
+
+int reconstruct_hybrid_secret(secret_share_t* shares, int share_count,
+                              const uint8_t* const* envelopes, const size_t* envelope_lens, int envelope_count,
+                              const char* msgid, uint8_t* reconstructed_data, size_t* data_length) {
+    uint8_t key[SHARE_KEY_SIZE];
+    size_t key_len = 0;
+
+    if (shares == NULL || envelopes == NULL || envelope_lens == NULL || envelope_count <= 0 || msgid == NULL ||
+        reconstructed_data == NULL || data_length == NULL) {
+        fprintf(stderr, "[VSS][Hybrid] Error: invalid arguments\n");
+        return -1;
+    }
+    // 分片描述的必须是一个密钥，否则重构会写出 key 缓冲区
+    for (int i = 0; i < share_count; i++) {
+        if (shares[i].data_length != SHARE_KEY_SIZE || shares[i].block_index >= SHARE_KEY_BLOCKS) {
+            fprintf(stderr, "[VSS][Hybrid] Error: share %d does not describe a %d-byte key\n", i, SHARE_KEY_SIZE);
+            return -1;
+        }
+    }
+    if (reconstruct_secret_from_shares(shares, share_count, key, &key_len) != 0 || key_len != SHARE_KEY_SIZE) {
+        fprintf(stderr, "[VSS][Hybrid] Error: key reconstruction failed\n");
+        memset(key, 0, sizeof(key));
+        return -1;
+    }
+
+    int result = RLC_ERR;
+    for (int e = 0; e < envelope_count && result != RLC_OK; e++) {
+        const uint8_t* envelope = envelopes[e];
+        size_t envelope_len = envelope_lens[e];
+        if (envelope == NULL || envelope_len < SHARE_ENVELOPE_OVERHEAD ||
+            envelope_len - SHARE_ENVELOPE_OVERHEAD > MAX_MESSAGE_SIZE) {
+            fprintf(stderr, "[VSS][Hybrid] Envelope %d: invalid length %zu, skipped\n", e, envelope_len);
+            continue;
+        }
+        size_t ct_len = envelope_len - AEAD_NONCE_SIZE;
+        result = aead_decrypt(reconstructed_data, envelope + AEAD_NONCE_SIZE, ct_len,
+                              (const uint8_t*)msgid, strlen(msgid), envelope, key);
+        if (result == RLC_OK) {
+            *data_length = ct_len - AEAD_TAG_SIZE;
+            printf("[VSS][Hybrid] Decrypted %zu-byte payload from envelope %d of %d with reconstructed key\n",
+                   *data_length, e + 1, envelope_count);
+        } else {
+            fprintf(stderr, "[VSS][Hybrid] Envelope %d of %d failed authentication for msgid %s\n",
+                    e + 1, envelope_count, msgid);
+        }
+    }
+    memset(key, 0, sizeof(key));
+    if (result != RLC_OK) {
+        fprintf(stderr, "[VSS][Hybrid] Error: no envelope authenticated for msgid %s\n", msgid);
+        return -1;
+    }
+    return 0;
+}
+
 // ================= VSS (Verifiable Secret Sharing) 实现 - Feldman VSS =================
 
 // 创建 VSS 承诺（Feldman VSS）
 int create_vss_commitments(const uint8_t* secret, size_t secret_len, 
                           secret_share_t* shares, vss_commitment_t* commitment, const char* msgid) {
-    if (secret_len > SHARE_SIZE) {
+    if (secret_len > MAX_MESSAGE_SIZE) {
         fprintf(stderr, "Error: Secret too large for VSS\n");
         return -1;
     }
@@ -1058,7 +1129,7 @@ int create_vss_commitments(const uint8_t* secret, size_t secret_len,
                             printf("[VSS][Feldman]   This position corresponds to: ctx_α+β area (offset %zu within ctx_α+β, range 0-2999)\n", offset_in_ctx);
                             if (offset_in_ctx >= 1500) {
                                 printf("[VSS][Feldman]   [DEBUG] This is LIKELY PADDING area (ctx_α+β data is only ~1500 bytes, rest is zero-padded to 3000 bytes)\n");
-                                printf("[VSS][Feldman]   [DEBUG] Conclusion: Zero bytes are due to SIZE ALLOCATION (RLC_CL_CIPHERTEXT_SIZE=1500, padded to 3000), not actual zero data\n");
+                                printf("[VSS][Feldman]   [DEBUG] Conclusion: Zero bytes are due to SIZE ALLOCATION (fixed RLC_CL_CIPHERTEXT_SIZE slots, zero padded), not actual zero data\n");
                             } else {
                                 printf("[VSS][Feldman]   [DEBUG] This is DATA area (should contain ctx_α+β ciphertext data)\n");
                                 if (all_bytes_zero) {
@@ -1070,7 +1141,7 @@ int create_vss_commitments(const uint8_t* secret, size_t secret_len,
                             printf("[VSS][Feldman]   This position corresponds to: auditor_ctx_α+β area (offset %zu within auditor_ctx_α+β, range 0-2999)\n", offset_in_auditor);
                             if (offset_in_auditor >= 1500) {
                                 printf("[VSS][Feldman]   [DEBUG] This is LIKELY PADDING area (auditor_ctx_α+β data is only ~1500 bytes, rest is zero-padded to 3000 bytes)\n");
-                                printf("[VSS][Feldman]   [DEBUG] Conclusion: Zero bytes are due to SIZE ALLOCATION (RLC_CL_CIPHERTEXT_SIZE=1500, padded to 3000), not actual zero data\n");
+                                printf("[VSS][Feldman]   [DEBUG] Conclusion: Zero bytes are due to SIZE ALLOCATION (fixed RLC_CL_CIPHERTEXT_SIZE slots, zero padded), not actual zero data\n");
                             } else {
                                 printf("[VSS][Feldman]   [DEBUG] This is DATA area (should contain auditor_ctx_α+β ciphertext data)\n");
                                 if (all_bytes_zero) {
@@ -1187,7 +1258,7 @@ int verify_share_with_commitment(const secret_share_t* share,
                        (share->y[2] << 16) |
                        (share->y[3] << 24);
     
-    if (share_size == 0 || share_size > SHARE_SIZE - 4) {
+    if (share_size == 0 || share_size > SHARE_VALUE_MAX) {
         fprintf(stderr, "[VSS][Feldman] Error: Invalid share size: %zu\n", share_size);
         ec_free(g);
         bn_free(order);
@@ -1385,6 +1456,190 @@ int verify_share_with_commitment(const secret_share_t* share,
     }
 }
 
+// 批量 Feldman 验证：对每个分片取随机权重 r_j，检查
+//   Σ_j r_j·(Σ_k x_j^k·C[b_j][k]) - (Σ_j r_j·y_j)·g == O
+// 同一块的承诺点只解压一次，系数按 (块, k) 合并后做一次多标量乘法。
+// 合并检查失败时逐个调用 verify_share_with_commitment 定位出错的分片。
+int verify_shares_with_commitment_batch(const secret_share_t* shares, size_t num_shares,
+                                        const vss_commitment_t* commitment, size_t* bad_index) {
+    if (bad_index) *bad_index = 0;
+    if (shares == NULL || commitment == NULL || num_shares == 0) {
+        return -1;
+    }
+    if (commitment->num_blocks == 0 || commitment->num_blocks > MAX_BLOCKS) {
+        fprintf(stderr, "[VSS][Feldman] Error: Invalid commitment block count %zu\n", commitment->num_blocks);
+        return -1;
+    }
+    
+    // 先检查元数据，不合法的分片直接报告，无需回退
+    for (size_t j = 0; j < num_shares; j++) {
+        size_t share_size = shares[j].y[0] |
+                           (shares[j].y[1] << 8) |
+                           (shares[j].y[2] << 16) |
+                           (shares[j].y[3] << 24);
+        if (shares[j].data_length != commitment->secret_len ||
+            shares[j].block_index >= commitment->num_blocks ||
+            shares[j].x <= 0 || share_size == 0 || share_size > SHARE_VALUE_MAX) {
+            fprintf(stderr, "[VSS][Feldman] Batch: share %zu has invalid metadata (x=%d, block_index=%zu)\n", 
+                    j, shares[j].x, shares[j].block_index);
+            if (bad_index) *bad_index = j;
+            return -1;
+        }
+    }
+    
+    // 本批用到的块 -> 点数组中的槽位
+    int* block_slot = malloc(commitment->num_blocks * sizeof(int));
+    if (block_slot == NULL) {
+        return -1;
+    }
+    for (size_t b = 0; b < commitment->num_blocks; b++) {
+        block_slot[b] = -1;
+    }
+    size_t used_blocks = 0;
+    for (size_t j = 0; j < num_shares; j++) {
+        if (block_slot[shares[j].block_index] < 0) {
+            block_slot[shares[j].block_index] = (int)used_blocks++;
+        }
+    }
+    
+    size_t num_points = used_blocks * THRESHOLD + 1;  // 最后一个是生成元
+    ec_t* points = malloc(num_points * sizeof(ec_t));
+    bn_t* coeffs = malloc(num_points * sizeof(bn_t));
+    if (points == NULL || coeffs == NULL) {
+        free(block_slot);
+        free(points);
+        free(coeffs);
+        return -1;
+    }
+    for (size_t i = 0; i < num_points; i++) {
+        ec_new(points[i]);
+        bn_new(coeffs[i]);
+        bn_zero(coeffs[i]);
+    }
+    
+    bn_t order, weight, term, x_power, y_sum, y_value;
+    ec_t acc;
+    bn_new(order);
+    bn_new(weight);
+    bn_new(term);
+    bn_new(x_power);
+    bn_new(y_sum);
+    bn_new(y_value);
+    ec_new(acc);
+    ec_curve_get_ord(order);
+    
+    // 解压承诺点；规则与 verify_share_with_commitment 相同：
+    // C[0] 全零或无穷远点表示块数据为零，C[1..] 必须是有限点
+    int points_valid = 1;
+    for (size_t b = 0; b < commitment->num_blocks && points_valid; b++) {
+        if (block_slot[b] < 0) continue;
+        for (int k = 0; k < THRESHOLD && points_valid; k++) {
+            const uint8_t* compressed = commitment->commitments[b][k];
+            ec_t* point = &points[(size_t)block_slot[b] * THRESHOLD + k];
+            int is_all_zero = 1;
+            for (int i = 0; i < RLC_EC_SIZE_COMPRESSED; i++) {
+                if (compressed[i] != 0) {
+                    is_all_zero = 0;
+                    break;
+                }
+            }
+            if (is_all_zero) {
+                ec_set_infty(*point);
+                if (k != 0) points_valid = 0;
+                continue;
+            }
+            RLC_TRY {
+                ec_read_bin(*point, compressed, RLC_EC_SIZE_COMPRESSED);
+                if (k != 0 && ec_is_infty(*point) == 1) points_valid = 0;
+            } RLC_CATCH_ANY {
+                ec_set_infty(*point);
+                points_valid = 0;
+            }
+        }
+    }
+    
+    int result = -1;
+    if (points_valid) {
+        bn_zero(y_sum);
+        for (size_t j = 0; j < num_shares; j++) {
+            size_t share_size = shares[j].y[0] |
+                               (shares[j].y[1] << 8) |
+                               (shares[j].y[2] << 16) |
+                               (shares[j].y[3] << 24);
+            bn_rand(weight, RLC_POS, VSS_BATCH_WEIGHT_BITS);
+            bn_read_bin(y_value, shares[j].y + 4, share_size);
+            bn_mod(y_value, y_value, order);
+            bn_mul(term, weight, y_value);
+            bn_add(y_sum, y_sum, term);
+            bn_mod(y_sum, y_sum, order);
+            
+            // 累加 r_j·x_j^k 到 (块, k) 的系数
+            size_t base = (size_t)block_slot[shares[j].block_index] * THRESHOLD;
+            bn_copy(x_power, weight);
+            for (int k = 0; k < THRESHOLD; k++) {
+                bn_add(coeffs[base + k], coeffs[base + k], x_power);
+                bn_mod(coeffs[base + k], coeffs[base + k], order);
+                if (k < THRESHOLD - 1) {
+                    bn_mul_dig(x_power, x_power, (dig_t)shares[j].x);
+                    bn_mod(x_power, x_power, order);
+                }
+            }
+        }
+        
+        // 生成元的系数为 -Σ r_j·y_j
+        ec_curve_get_gen(points[num_points - 1]);
+        bn_sub(coeffs[num_points - 1], order, y_sum);
+        bn_mod(coeffs[num_points - 1], coeffs[num_points - 1], order);
+        
+        // 去掉无穷远点和零系数后做一次多标量乘法
+        size_t live = 0;
+        for (size_t i = 0; i < num_points; i++) {
+            if (ec_is_infty(points[i]) == 1 || bn_is_zero(coeffs[i])) continue;
+            if (live != i) {
+                ec_copy(points[live], points[i]);
+                bn_copy(coeffs[live], coeffs[i]);
+            }
+            live++;
+        }
+        if (live == 0) {
+            ec_set_infty(acc);
+        } else {
+            ec_mul_sim_lot(acc, (const ec_t*)points, (const bn_t*)coeffs, (int)live);
+        }
+        result = ec_is_infty(acc) == 1 ? 0 : -1;
+    }
+    
+    for (size_t i = 0; i < num_points; i++) {
+        ec_free(points[i]);
+        bn_free(coeffs[i]);
+    }
+    free(points);
+    free(coeffs);
+    free(block_slot);
+    ec_free(acc);
+    bn_free(order);
+    bn_free(weight);
+    bn_free(term);
+    bn_free(x_power);
+    bn_free(y_sum);
+    bn_free(y_value);
+    
+    if (result == 0) {
+        printf("[VSS][Feldman] ✅ Batch verification of %zu shares (%zu blocks) successful\n", num_shares, used_blocks);
+        return 0;
+    }
+    
+    // 回退：逐个验证，找出第一个不合法的分片
+    fprintf(stderr, "[VSS][Feldman] Batch verification failed, falling back to per-block verification\n");
+    for (size_t j = 0; j < num_shares; j++) {
+        if (verify_share_with_commitment(&shares[j], commitment) != 0) {
+            if (bad_index) *bad_index = j;
+            return -1;
+        }
+    }
+    return 0;
+}
+
 // 发送 VSS 承诺给 Auditor
 int send_vss_commitment_to_auditor(const vss_commitment_t* commitment) {
     // 创建 ZMQ 上下文和套接字
@@ -1437,25 +1692,52 @@ int send_vss_commitment_to_auditor(const vss_commitment_t* commitment) {
 }
 
 // ================= 基于文件的 VSS 承诺存储 =================
+// 承诺写入二进制归档（见 vss_archive.h）；JSON 只作为导出格式，
+// 旧版本留下的 vss_commitments/vss_commitment_<msgid>.json 仍可加载
 
-// 将 VSS 承诺保存到文件
+// 将 VSS 承诺保存到归档；A2L_VSS_JSON_EXPORT=1 时额外导出 JSON
 int save_vss_commitment_to_file(const vss_commitment_t* commitment) {
     if (commitment == NULL) {
         printf("[VSS][File] Error: NULL commitment\n");
         return -1;
     }
+    if (vss_archive_put(commitment) != RLC_OK) {
+        printf("[VSS][File] Error: Cannot append commitment for msgid %s to archive\n", commitment->msgid);
+        return -1;
+    }
+    printf("[VSS][File] Saved commitment to archive: msgid=%s, num_blocks=%zu\n",
+           commitment->msgid, commitment->num_blocks);
+    
+    const char* export_json = getenv(VSS_JSON_EXPORT_ENV);
+    if (export_json != NULL && strcmp(export_json, "1") == 0) {
+        export_vss_commitment_json(commitment, NULL);
+    }
+    return 0;
+}
+
+// 将 VSS 承诺导出为 JSON；path 为 NULL 时使用 vss_commitments/vss_commitment_<msgid>.json
+int export_vss_commitment_json(const vss_commitment_t* commitment, const char* path) {
+    if (commitment == NULL) {
+        printf("[VSS][File] Error: NULL commitment\n");
+        return -1;
+    }
     
     // 创建文件名：vss_commitment_<msgid>.json
     char filename[256];
-    if (strlen(commitment->msgid) == 0) {
+    if (path != NULL) {
+        snprintf(filename, sizeof(filename), "%s", path);
+    } else if (strlen(commitment->msgid) == 0) {
         printf("[VSS][File] WARNING: msgid is empty, using timestamp as filename\n");
-        snprintf(filename, sizeof(filename), "vss_commitments/vss_commitment_empty_%ld.json", commitment->timestamp);
+        snprintf(filename, sizeof(filename), VSS_ARCHIVE_DIR "/vss_commitment_empty_%ld.json", commitment->timestamp);
     } else {
-        snprintf(filename, sizeof(filename), "vss_commitments/vss_commitment_%s.json", commitment->msgid);
+        snprintf(filename, sizeof(filename), VSS_ARCHIVE_DIR "/vss_commitment_%s.json", commitment->msgid);
     }
     
     // 确保目录存在
-    (void)system("mkdir -p vss_commitments");
+    if (path == NULL && mkdir(VSS_ARCHIVE_DIR, 0755) != 0 && errno != EEXIST) {
+        printf("[VSS][File] Error: Cannot create directory %s\n", VSS_ARCHIVE_DIR);
+        return -1;
+    }
     
     FILE* file = fopen(filename, "w");
     if (file == NULL) {
@@ -1494,20 +1776,31 @@ int save_vss_commitment_to_file(const vss_commitment_t* commitment) {
     fprintf(file, "}\n");
     
     fclose(file);
-    printf("[VSS][File] Successfully saved commitment to %s\n", filename);
+    printf("[VSS][File] Exported commitment to %s\n", filename);
     return 0;
 }
 
-// 从文件加载 VSS 承诺
+static int load_vss_commitment_from_json(const char* msgid, vss_commitment_t* commitment);
+
+// 加载 VSS 承诺：先查归档，未找到时回退到旧的 JSON 文件
 int load_vss_commitment_from_file(const char* msgid, vss_commitment_t* commitment) {
     if (msgid == NULL || commitment == NULL) {
         printf("[VSS][File] Error: NULL parameters\n");
         return -1;
     }
-    
+    if (vss_archive_get(msgid, commitment) == RLC_OK) {
+        printf("[VSS][File] Loaded commitment from archive: msgid=%s, num_blocks=%zu\n",
+               msgid, commitment->num_blocks);
+        return 0;
+    }
+    return load_vss_commitment_from_json(msgid, commitment);
+}
+
+// 旧格式：逐行解析 JSON 文件
+static int load_vss_commitment_from_json(const char* msgid, vss_commitment_t* commitment) {
     // 创建文件名
     char filename[256];
-    snprintf(filename, sizeof(filename), "vss_commitments/vss_commitment_%s.json", msgid);
+    snprintf(filename, sizeof(filename), VSS_ARCHIVE_DIR "/vss_commitment_%s.json", msgid);
     
     FILE* file = fopen(filename, "r");
     if (file == NULL) {
@@ -1680,12 +1973,13 @@ int load_vss_commitment_from_file(const char* msgid, vss_commitment_t* commitmen
     }
 }
 
-// 列出所有 VSS 承诺文件
+// 列出 VSS 承诺归档概况
 int list_vss_commitment_files(void) {
-    printf("[VSS][File] Listing VSS commitment files:\n");
-    
-    // 使用系统命令列出文件
-    (void)system("ls -la vss_commitments/ 2>/dev/null || echo 'No vss_commitments directory found'");
-    
+    size_t segments = 0, entries = 0;
+    if (vss_archive_stats(&segments, &entries) != RLC_OK) {
+        printf("[VSS][File] No %s archive available\n", VSS_ARCHIVE_DIR);
+        return -1;
+    }
+    printf("[VSS][File] %s archive: %zu commitments in %zu segments\n", VSS_ARCHIVE_DIR, entries, segments);
     return 0;
 } 
\ No newline at end of file
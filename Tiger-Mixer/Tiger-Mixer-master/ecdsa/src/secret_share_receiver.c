@@ -14,15 +14,18 @@
 #include "dkg_integration.h"
 #include "committee_integration.h"  // 恢复委员会集成
 #include "reputation_tracker.h"  // 声誉跟踪系统
+#include "http_client.h"
+#include "share_store.h"
 
 #define SECRET_SHARES 3
 #define THRESHOLD 2
-#define SHARE_SIZE 17000
 #define MAX_MESSAGE_SIZE 17000
 // MSG_ID_MAXLEN is already defined in secret_share.h
 #define SLICE_DIR "./SliceMessage"
 #define COMMITTEE_MEMBERS_FILE "/home/zxx/A2L/A2L-master/ecdsa/committee_members.txt"
 #define ADDRESS_CACHE_TTL 5  // 地址缓存时间（秒）
+#define JUDGE_API_URL "http://127.0.0.1:8001/judge"
+#define JUDGE_API_TIMEOUT_MS 10000
 
 // 委员会集成全局变量
 static char g_my_address[64] = {0};
@@ -168,237 +171,8 @@ int get_dynamic_endpoints_committee(char endpoints[SECRET_SHARES][64]) {
     return 0;
 }
 
-// 秘密分享结构体
-// typedef struct {
-//     int x;                          // 分享点的x坐标
-//     uint8_t y[SHARE_SIZE];         // 分享点的y坐标
-//     size_t data_length;            // 数据长度
-// } secret_share_t;
-
-// 将y转为十六进制字符串
-static void y_to_hex(const uint8_t* y, size_t len, char* out_hex, size_t out_size) {
-    size_t i;
-    for (i = 0; i < len && i * 2 + 1 < out_size; ++i) {
-        sprintf(out_hex + i * 2, "%02x", y[i]);
-    }
-    out_hex[i * 2] = '\0';
-}
-
-// 保存分片到JSON文件（包含地址信息）
-static int save_share_to_json_with_address(const char* json_filename, const char* msg_id, 
-                                           const secret_share_t* share, const char* address) {
-    printf("[SAVE] Attempting to save share to file: %s\n", json_filename);
-    printf("[SAVE] Message ID: %s, x: %d, data_length: %zu, address: %s\n", 
-           msg_id, share->x, share->data_length, address);
-    
-    FILE* fp = fopen(json_filename, "a");
-    if (!fp) {
-        fprintf(stderr, "[SAVE] Error: Could not open file %s for writing\n", json_filename);
-        perror("fopen error");
-        return -1;
-    }
-    
-    char y_hex[SHARE_SIZE * 2 + 1];
-    y_to_hex(share->y, share->data_length, y_hex, sizeof(y_hex));
-    
-    // 获取当前时间戳
-    time_t now = time(NULL);
-    
-    // 追加为一行一个JSON对象，包含地址、时间戳、block_index和block_size
-    int result = fprintf(fp, "{\"msg_id\":\"%s\",\"x\":%d,\"block_index\":%zu,\"block_size\":%zu,\"data_length\":%zu,\"y\":\"%s\",\"address\":\"%s\",\"timestamp\":%ld}\n", 
-                        msg_id, share->x, share->block_index, share->block_size, share->data_length, y_hex, address, (long)now);
-    
-    if (result < 0) {
-        fprintf(stderr, "[SAVE] Error: Failed to write to file\n");
-        fclose(fp);
-        return -1;
-    }
-    
-    // 强制刷新缓冲区
-    fflush(fp);
-    fclose(fp);
-    
-    printf("[SAVE] Successfully saved share to file (with address info)\n");
-    return 0;
-}
-
-// 保存分片到JSON文件（兼容旧版本，不包含地址）
-static int save_share_to_json(const char* json_filename, const char* msg_id, const secret_share_t* share) {
-    return save_share_to_json_with_address(json_filename, msg_id, share, "unknown");
-}
-
-// 从JSON文件查找分片（兼容旧格式，只加载第一个匹配的分享）
-static int load_share_from_json(const char* json_filename, const char* msg_id, secret_share_t* share) {
-    FILE* fp = fopen(json_filename, "r");
-    if (!fp) {
-        printf("[LOAD] Failed to open file: %s\n", json_filename);
-        return -1;
-    }
-    
-    printf("[LOAD] Looking for msgid: %s (length: %zu)\n", msg_id, strlen(msg_id));
-    
-    char line[65536];
-    int line_count = 0;
-    while (fgets(line, sizeof(line), fp)) {
-        line_count++;
-        char file_msgid[MSG_ID_MAXLEN] = {0};
-        int x = 0;
-        size_t block_index = 0;
-        size_t block_size = 0;
-        size_t data_length = 0;
-        char y_hex[SHARE_SIZE * 2 + 1] = {0};
-        
-        // 尝试新格式（包含block_index和block_size）
-        int scan_result = sscanf(line, "{\"msg_id\":\"%123[^\"]\",\"x\":%d,\"block_index\":%zu,\"block_size\":%zu,\"data_length\":%zu,\"y\":\"%[^\"]", 
-                                 file_msgid, &x, &block_index, &block_size, &data_length, y_hex);
-        
-        // 如果新格式失败，尝试旧格式（兼容性）
-        if (scan_result != 6) {
-            scan_result = sscanf(line, "{\"msg_id\":\"%123[^\"]\",\"x\":%d,\"data_length\":%zu,\"y\":\"%[^\"]", 
-                                 file_msgid, &x, &data_length, y_hex);
-            if (scan_result == 4) {
-                block_index = 0;  // 默认值
-                block_size = data_length;  // 默认值
-            }
-        }
-        
-        if (scan_result == 4 || scan_result == 6) {
-            // 只在前几行打印调试信息，避免输出太多
-            if (line_count <= 5) {
-                printf("[LOAD] Line %d: found msgid='%s' (len=%zu), x=%d\n", 
-                       line_count, file_msgid, strlen(file_msgid), x);
-            }
-            
-            if (strcmp(file_msgid, msg_id) == 0) {
-                printf("[LOAD] Found matching share! x=%d, block_index=%zu, data_length=%zu\n", x, block_index, data_length);
-                share->x = x;
-                share->block_index = block_index;
-                share->block_size = block_size;
-                share->data_length = data_length;
-                for (size_t i = 0; i < data_length && i < SHARE_SIZE; ++i) {
-                    unsigned int byte;
-                    sscanf(y_hex + i * 2, "%2x", &byte);
-                    share->y[i] = (uint8_t)byte;
-                }
-                fclose(fp);
-                return 0;
-            }
-        } else {
-            if (line_count <= 5) {
-                printf("[LOAD] Line %d: sscanf failed (result=%d)\n", line_count, scan_result);
-            }
-        }
-    }
-    
-    printf("[LOAD] Scanned %d lines, no match found\n", line_count);
-    fclose(fp);
-    return -1;
-}
-
-// 从JSON文件加载所有块的分享（对于给定的msg_id和x）
-static int load_all_shares_from_json(const char* json_filename, const char* msg_id, int x, 
-                                     secret_share_t* shares, size_t max_shares, size_t* num_shares_out) {
-    // 参数验证
-    if (!json_filename || !msg_id || !shares || !num_shares_out || max_shares == 0) {
-        printf("[LOAD_ALL] Error: Invalid parameters\n");
-        return -1;
-    }
-    
-    FILE* fp = fopen(json_filename, "r");
-    if (!fp) {
-        printf("[LOAD_ALL] Failed to open file: %s (errno=%d: %s)\n", json_filename, errno, strerror(errno));
-        return -1;
-    }
-    
-    printf("[LOAD_ALL] Looking for all shares with msgid: %s, x=%d in file: %s\n", msg_id, x, json_filename);
-    
-    char line[65536];
-    size_t found_count = 0;
-    int line_count = 0;
-    
-    while (fgets(line, sizeof(line), fp) && found_count < max_shares) {
-        line_count++;
-        
-        // 限制读取长度，防止缓冲区溢出
-        if (line_count % 1000 == 0) {
-            // printf("[LOAD_ALL] Processed %d lines, found %zu shares so far...\n", line_count, found_count);
-        }
-        
-        char file_msgid[MSG_ID_MAXLEN] = {0};
-        int file_x = 0;
-        size_t block_index = 0;
-        size_t block_size = 0;
-        size_t data_length = 0;
-        char y_hex[SHARE_SIZE * 2 + 1] = {0};  // 确保有足够的空间
-        
-        // 尝试新格式（包含block_index和block_size）
-        // 注意：限制y_hex的读取长度，防止缓冲区溢出（SHARE_SIZE * 2 = 34000）
-        // 使用%34000[^\"]来限制读取长度
-        int scan_result = sscanf(line, "{\"msg_id\":\"%123[^\"]\",\"x\":%d,\"block_index\":%zu,\"block_size\":%zu,\"data_length\":%zu,\"y\":\"%34000[^\"]", 
-                                 file_msgid, &file_x, &block_index, &block_size, &data_length, y_hex);
-        
-        // 如果新格式失败，尝试旧格式（兼容性）
-        if (scan_result != 6) {
-            scan_result = sscanf(line, "{\"msg_id\":\"%123[^\"]\",\"x\":%d,\"data_length\":%zu,\"y\":\"%34000[^\"]", 
-                                 file_msgid, &file_x, &data_length, y_hex);
-            if (scan_result == 4) {
-                block_index = found_count;  // 使用顺序索引
-                block_size = data_length;  // 默认值
-            }
-        }
-        
-        // 确保y_hex以null结尾，防止后续操作越界
-        y_hex[SHARE_SIZE * 2] = '\0';
-        
-        if ((scan_result == 4 || scan_result == 6) && 
-            strcmp(file_msgid, msg_id) == 0 && file_x == x) {
-            secret_share_t* share = &shares[found_count];
-            share->x = file_x;
-            share->block_index = block_index;
-            share->block_size = block_size;
-            share->data_length = data_length;
-            
-            // 解析y_hex：将hex字符串转换回字节数组
-            size_t hex_len = strlen(y_hex);
-            if (hex_len == 0 || hex_len % 2 != 0) {
-                printf("[LOAD_ALL] Warning: Invalid hex length %zu for block %zu, skipping\n", hex_len, block_index);
-                continue;
-            }
-            
-            size_t bytes_to_read = hex_len / 2;
-            if (bytes_to_read > SHARE_SIZE) {
-                printf("[LOAD_ALL] Warning: Hex data too large (%zu > %d) for block %zu, truncating\n", 
-                       bytes_to_read, SHARE_SIZE, block_index);
-                bytes_to_read = SHARE_SIZE;
-            }
-            
-            // 将hex字符串转换为字节数组
-            for (size_t i = 0; i < bytes_to_read; ++i) {
-                unsigned int byte;
-                if (sscanf(y_hex + i * 2, "%2x", &byte) == 1) {
-                    share->y[i] = (uint8_t)byte;
-                } else {
-                    printf("[LOAD_ALL] Warning: Failed to parse hex byte at position %zu for block %zu\n", i, block_index);
-                    share->y[i] = 0;
-                }
-            }
-            
-            found_count++;
-        }
-    }
-    
-    fclose(fp);
-    *num_shares_out = found_count;
-    
-    if (found_count == 0) {
-        printf("[LOAD_ALL] No shares found for msgid: %s, x=%d\n", msg_id, x);
-        return -1;
-    }
-    
-    printf("[LOAD_ALL] Loaded %zu shares for msgid: %s, x=%d\n", found_count, msg_id, x);
-    return 0;
-}
-
+// 分片文件中 y 的十六进制长度（SHARE_Y_SIZE * 2）；旧文件按 data_length 写入了补零的 y，
+// 读取时只取前 SHARE_Y_SIZE 字节，因此 sscanf 的宽度固定为 72
 // 解析接收到的分享消息
 static int parse_share_message(uint8_t* data, size_t data_size, secret_share_t* share, char* msg_type, char* out_msgid) {
     // 新格式：x | block_index | data_length | block_size | y
@@ -424,8 +198,8 @@ static int parse_share_message(uint8_t* data, size_t data_size, secret_share_t*
                             (data[offset + 3] << 24);
     offset += 4;
     
-    if (share_data_size > SHARE_SIZE - 4) {
-        fprintf(stderr, "Error: share data size too large (%zu > %d)\n", share_data_size, SHARE_SIZE - 4);
+    if (share_data_size > SHARE_VALUE_MAX) {
+        fprintf(stderr, "Error: share data size too large (%zu > %d)\n", share_data_size, SHARE_VALUE_MAX);
         return -1;
     }
     
@@ -455,57 +229,20 @@ static int call_judge_api(const char* pairs_summary_json) {
         return -1;
     }
     
-    // 使用临时文件存储JSON数据，避免shell命令注入问题
-    char tmp_file[256];
-    snprintf(tmp_file, sizeof(tmp_file), "/tmp/judge_api_%d_%ld.json", getpid(), time(NULL));
-    
-    // 将JSON写入临时文件
-    FILE* json_fp = fopen(tmp_file, "w");
-    if (!json_fp) {
-        fprintf(stderr, "[JUDGE_API] Error: 无法创建临时文件: %s\n", tmp_file);
-        return -1;
-    }
-    
-    fprintf(json_fp, "%s", pairs_summary_json);
-    fclose(json_fp);
-    
-    // 构造curl命令，使用 -d @filename 方式读取JSON文件
-    char curl_cmd[512];
-    snprintf(curl_cmd, sizeof(curl_cmd), 
-             "curl -s -X POST -H 'Content-Type: application/json' -d @%s http://127.0.0.1:8001/judge",
-             tmp_file);
-    
-    printf("[JUDGE_API] 执行命令: curl -s -X POST -H 'Content-Type: application/json' -d @%s http://127.0.0.1:8001/judge\n", tmp_file);
+    // 请求体直接在内存中发送（不经过 shell 与临时文件），连接由共享 HTTP 客户端复用
+    printf("[JUDGE_API] POST %s\n", JUDGE_API_URL);
     printf("[JUDGE_API] JSON数据: %s\n", pairs_summary_json);
     fflush(stdout);
     
-    // 使用popen执行命令并获取输出
-    FILE* fp = popen(curl_cmd, "r");
-    if (!fp) {
-        fprintf(stderr, "[JUDGE_API] Error: popen failed\n");
-        unlink(tmp_file);  // 清理临时文件
+    long http_code = 0;
+    char* response = NULL;
+    if (http_post_json(JUDGE_API_URL, pairs_summary_json, JUDGE_API_TIMEOUT_MS, &http_code, &response) != RLC_OK) {
+        fprintf(stderr, "[JUDGE_API] Error: 请求失败\n");
         return -1;
     }
-    
-    char response[1024] = {0};
-    size_t total_read = 0;
-    char buffer[256];
-    
-    while (fgets(buffer, sizeof(buffer), fp) != NULL && total_read < sizeof(response) - 1) {
-        size_t len = strlen(buffer);
-        if (total_read + len < sizeof(response) - 1) {
-            memcpy(response + total_read, buffer, len);
-            total_read += len;
-        }
-    }
-    
-    int status = pclose(fp);
-    
-    // 清理临时文件
-    unlink(tmp_file);
-    
-    if (status != 0) {
-        fprintf(stderr, "[JUDGE_API] Error: curl命令执行失败，返回码: %d\n", status);
+    if (http_code != 200) {
+        fprintf(stderr, "[JUDGE_API] Error: HTTP 状态码 %ld，响应: %s\n", http_code, response);
+        free(response);
         return -1;
     }
     
@@ -516,26 +253,27 @@ static int call_judge_api(const char* pairs_summary_json) {
     // 简单解析：查找 "message":" 后面的值
     const char* message_key = "\"message\":\"";
     char* message_pos = strstr(response, message_key);
+    int judge = -1;
     if (!message_pos) {
         fprintf(stderr, "[JUDGE_API] Error: 无法在响应中找到message字段\n");
-        return -1;
-    }
-    
-    message_pos += strlen(message_key);
-    if (*message_pos == '0') {
-        printf("[JUDGE_API] 判断结果: 0 (不需要审计)\n");
-        return 1;  // 返回1表示不需要审计
-    } else if (*message_pos == '1') {
-        printf("[JUDGE_API] 判断结果: 1 (需要审计)\n");
-        return 0;  // 返回0表示需要审计
     } else {
-        fprintf(stderr, "[JUDGE_API] Error: 未知的message值: %c\n", *message_pos);
-        return -1;
+        message_pos += strlen(message_key);
+        if (*message_pos == '0') {
+            printf("[JUDGE_API] 判断结果: 0 (不需要审计)\n");
+            judge = 1;  // 返回1表示不需要审计
+        } else if (*message_pos == '1') {
+            printf("[JUDGE_API] 判断结果: 1 (需要审计)\n");
+            judge = 0;  // 返回0表示需要审计
+        } else {
+            fprintf(stderr, "[JUDGE_API] Error: 未知的message值: %c\n", *message_pos);
+        }
     }
+    free(response);
+    return judge;
 }
 
 // 处理审计员请求
-static void handle_audit_request(void* socket, int tag, const char* msg_id, const char* pairs_summary_json, const char* json_filename, int participant_id) {
+static void handle_audit_request(void* socket, int tag, const char* msg_id, const char* pairs_summary_json, share_store_t store, int participant_id) {
     // tag: 0=第一个分片(Alice相关), 1=第二个分片(Bob相关)
     // pairs_summary_json: JSON格式的pairs_summary信息，格式为 {"id":"地址","record":"(0,1)(1,1)..."}
     // participant_id 由调用者传入（receiver的participant_id，1-based）
@@ -646,19 +384,16 @@ static void handle_audit_request(void* socket, int tag, const char* msg_id, cons
     printf("[AUDIT_REQUEST] DEBUG: msg_id is valid: %s\n", msg_id);
     fflush(stdout);
     
-    if (!json_filename) {
-        fprintf(stderr, "[AUDIT_REQUEST] Error: json_filename is NULL\n");
+    if (!store) {
+        fprintf(stderr, "[AUDIT_REQUEST] Error: share store is not open\n");
         fflush(stderr);
         if (socket) {
-            const char* response = "INVALID_PARAMS";
+            const char* response = "FILE_NOT_FOUND";
             zmq_send(socket, response, strlen(response), 0);
         }
         return;
     }
     
-    printf("[AUDIT_REQUEST] DEBUG: json_filename is valid: %s\n", json_filename);
-    fflush(stdout);
-    
     if (participant_id < 1 || participant_id > SECRET_SHARES) {
         fprintf(stderr, "[AUDIT_REQUEST] Error: Invalid participant_id: %d (must be 1-%d)\n", 
                 participant_id, SECRET_SHARES);
@@ -675,35 +410,13 @@ static void handle_audit_request(void* socket, int tag, const char* msg_id, cons
     
     printf("[AUDIT_REQUEST] Handling audit request: tag=%d, msg_id=%s, participant_id=%d\n", 
            tag, msg_id, participant_id);
-    printf("[AUDIT_REQUEST] JSON filename: %s\n", json_filename);
     if (pairs_summary_json != NULL && strlen(pairs_summary_json) > 0) {
         printf("[AUDIT_REQUEST] pairs_summary_json: %s\n", pairs_summary_json);
     }
     fflush(stdout);
     
-    // 验证文件是否存在
-    printf("[AUDIT_REQUEST] DEBUG: About to open file: %s\n", json_filename);
-    fflush(stdout);
-    
-    FILE* test_fp = fopen(json_filename, "r");
-    if (!test_fp) {
-        fprintf(stderr, "[AUDIT_REQUEST] Error: Cannot open file %s (errno=%d: %s)\n", 
-                json_filename, errno, strerror(errno));
-        fflush(stderr);
-        if (socket) {
-            const char* response = "FILE_NOT_FOUND";
-            zmq_send(socket, response, strlen(response), 0);
-        }
-        return;
-    }
-    fclose(test_fp);
-    
-    printf("[AUDIT_REQUEST] DEBUG: File exists and is readable\n");
-    fflush(stdout);
-    
     // 加载所有块的分享
-    // ⚠️ 重要：使用动态内存分配，避免栈溢出
-    // secret_share_t 很大（包含 100KB 的 y 数组），1000 个结构体约 100MB，栈上分配会导致段错误
+    // 使用动态内存分配：最多 1000 个块的分享
     const size_t max_shares = 1000;
     size_t share_array_size = sizeof(secret_share_t) * max_shares;
     printf("[AUDIT_REQUEST] DEBUG: Allocating shares array (size: %zu bytes = %.2f MB)...\n", 
@@ -730,14 +443,15 @@ static void handle_audit_request(void* socket, int tag, const char* msg_id, cons
     
     size_t num_shares = 0;
     
-    printf("[AUDIT_REQUEST] DEBUG: About to call load_all_shares_from_json\n");
-    printf("[AUDIT_REQUEST] DEBUG: Parameters: json_filename=%s, msg_id=%s, participant_id=%d\n", 
-           json_filename, msg_id, participant_id);
+    printf("[AUDIT_REQUEST] DEBUG: Loading shares: msg_id=%s, participant_id=%d\n", msg_id, participant_id);
     fflush(stdout);
     
-    int load_result = load_all_shares_from_json(json_filename, msg_id, participant_id, shares, max_shares, &num_shares);
+    uint8_t* envelope = NULL;
+    size_t envelope_len = 0;
+    int load_result = share_store_load(store, msg_id, participant_id, shares, max_shares, &num_shares,
+                                       &envelope, &envelope_len) == RLC_OK ? 0 : -1;
     
-    printf("[AUDIT_REQUEST] DEBUG: load_all_shares_from_json returned: %d, num_shares: %zu\n", load_result, num_shares);
+    printf("[AUDIT_REQUEST] DEBUG: share_store_load returned: %d, num_shares: %zu\n", load_result, num_shares);
     fflush(stdout);
     if (load_result == 0) {
         printf("[AUDIT_REQUEST] Successfully loaded %zu shares\n", num_shares);
@@ -750,6 +464,10 @@ static void handle_audit_request(void* socket, int tag, const char* msg_id, cons
                                     (shares[i].y[3] << 24);
             msg_size += sizeof(size_t) * 3 + 4 + share_data_size;  // block_index + block_size + data_length + 4字节长度 + share_value
         }
+        // 混合模式：信封作为尾部随分片返回给 Auditor
+        if (envelope != NULL) {
+            msg_size += SHARE_ENVELOPE_TRAILER_HDR + envelope_len;
+        }
         
         uint8_t* msg_data = malloc(msg_size);
         if (!msg_data) {
@@ -757,6 +475,7 @@ static void handle_audit_request(void* socket, int tag, const char* msg_id, cons
             zmq_send(socket, response, strlen(response), 0);
             printf("Memory allocation failed for audit request\n");
             free(shares);  // 释放 shares 内存
+            free(envelope);
             return;
         }
         
@@ -783,6 +502,9 @@ static void handle_audit_request(void* socket, int tag, const char* msg_id, cons
             memcpy(msg_data + offset, shares[i].y, 4 + share_data_size);
             offset += 4 + share_data_size;
         }
+        if (envelope != NULL) {
+            offset += write_share_envelope_trailer(msg_data + offset, envelope, envelope_len);
+        }
         
         int send_result = zmq_send(socket, msg_data, msg_size, 0);
         if (send_result == msg_size) {
@@ -814,6 +536,7 @@ static void handle_audit_request(void* socket, int tag, const char* msg_id, cons
     }
     
     // 释放动态分配的内存
+    free(envelope);
     if (shares) {
         free(shares);
         printf("[AUDIT_REQUEST] DEBUG: Freed shares array memory\n");
@@ -910,6 +633,8 @@ static void* receiver_thread(void* arg) {
     int port = RECEIVER_PORTS[receiver_id];
     int member_index = receiver_id + 1;  // receiver_id是0-2，member_index是1-3
     char json_filename[256];
+    char log_filename[256];
+    char index_filename[256];
     // 确保目录存在
     printf("[RECEIVER] Creating directory: %s\n", SLICE_DIR);
     if (mkdir(SLICE_DIR, 0777) != 0 && errno != EEXIST) {
@@ -918,11 +643,13 @@ static void* receiver_thread(void* arg) {
         printf("[RECEIVER] Directory ready: %s\n", SLICE_DIR);
     }
     
+    // 分片存入二进制日志 + 索引；旧的 JSON 文件在日志为空时导入一次
     snprintf(json_filename, sizeof(json_filename), SLICE_DIR "/receiver_%d.json", receiver_id + 1);
-    printf("[RECEIVER] Will save shares to: %s\n", json_filename);
+    snprintf(log_filename, sizeof(log_filename), SLICE_DIR "/receiver_%d.shares", receiver_id + 1);
+    snprintf(index_filename, sizeof(index_filename), SLICE_DIR "/receiver_%d.shares.idx", receiver_id + 1);
+    printf("[RECEIVER] Will save shares to: %s\n", log_filename);
     
     printf("Starting receiver %d on port %d\n", receiver_id + 1, port);
-    printf("Local JSON file: %s\n", json_filename);
     
     // 创建 ZeroMQ 上下文和套接字
     void* context = zmq_ctx_new();
@@ -947,6 +674,14 @@ static void* receiver_thread(void* arg) {
     }
     printf("Receiver %d listening on %s\n", receiver_id + 1, endpoint);
     
+    share_store_t store = share_store_open(log_filename, index_filename, json_filename);
+    if (!store) {
+        fprintf(stderr, "Error: could not open share store for receiver %d\n", receiver_id + 1);
+        zmq_close(socket);
+        zmq_ctx_destroy(context);
+        return NULL;
+    }
+    
     // 消息接收循环
     while (1) {
         // 每次处理新消息前，读取最新的地址（支持动态轮换）
@@ -962,6 +697,21 @@ static void* receiver_thread(void* arg) {
             fprintf(stderr, "Error: could not initialize message for receiver %d\n", receiver_id + 1);
             continue;
         }
+        // 已 ACK 但未 fsync 的分片最多等待 SHARE_STORE_SYNC_MS：空闲时等到期限就同步
+        zmq_pollitem_t item = { socket, 0, ZMQ_POLLIN, 0 };
+        rc = zmq_poll(&item, 1, share_store_sync_timeout(store));
+        if (rc == 0) {
+            if (share_store_sync(store) != RLC_OK) {
+                fprintf(stderr, "Receiver %d: failed to sync share log: %s\n", receiver_id + 1, strerror(errno));
+            }
+            zmq_msg_close(&zmq_message);
+            continue;
+        }
+        if (rc < 0) {
+            fprintf(stderr, "Error: poll failed on receiver %d\n", receiver_id + 1);
+            zmq_msg_close(&zmq_message);
+            continue;
+        }
         rc = zmq_msg_recv(&zmq_message, socket, 0);
         if (rc == -1) {
             fprintf(stderr, "Error: failed to receive message on receiver %d\n", receiver_id + 1);
@@ -1100,11 +850,11 @@ static void* receiver_thread(void* arg) {
             
             // 添加详细的调试信息
             printf("[RECEIVER %d] DEBUG: About to call handle_audit_request\n", receiver_id + 1);
-            printf("[RECEIVER %d] DEBUG: socket=%p, tag=%d, msg_id_buf=%p (\"%s\"), json_filename=%p (\"%s\"), member_index=%d\n", 
-                   receiver_id + 1, socket, tag, msg_id_buf, msg_id_buf, json_filename, json_filename ? json_filename : "(NULL)", member_index);
+            printf("[RECEIVER %d] DEBUG: socket=%p, tag=%d, msg_id_buf=%p (\"%s\"), store=%p, member_index=%d\n", 
+                   receiver_id + 1, socket, tag, msg_id_buf, msg_id_buf, (void*)store, member_index);
             fflush(stdout);  // 强制刷新输出缓冲区
             
-            handle_audit_request(socket, tag, msg_id_buf, pairs_summary_json, json_filename, member_index);  // member_index是1-based的participant_id
+            handle_audit_request(socket, tag, msg_id_buf, pairs_summary_json, store, member_index);  // member_index是1-based的participant_id
             
             printf("[RECEIVER %d] DEBUG: handle_audit_request returned\n", receiver_id + 1);
             fflush(stdout);
@@ -1150,6 +900,19 @@ static void* receiver_thread(void* arg) {
             int all_saved = 1;
             int saved_count = 0;
             
+            // 每块至少占 3 个 size_t 加 4 字节长度，块数不可能超过消息能容纳的数量
+            size_t min_block_size = sizeof(size_t) * 3 + 4;
+            secret_share_t* blocks = NULL;
+            if (num_blocks == 0 || num_blocks > (msg_data_length - offset) / min_block_size ||
+                (blocks = calloc(num_blocks, sizeof(secret_share_t))) == NULL) {
+                fprintf(stderr, "Receiver %d: Invalid block count %zu\n", receiver_id + 1, num_blocks);
+                const char* response = "PARSE_ERROR";
+                zmq_send(socket, response, strlen(response), 0);
+                message_free(received_msg);
+                zmq_msg_close(&zmq_message);
+                continue;
+            }
+            
             // 解析每个块的分享
             for (size_t block_idx = 0; block_idx < num_blocks; block_idx++) {
                 if (offset + sizeof(size_t) + sizeof(size_t) + sizeof(size_t) + 4 > msg_data_length) {
@@ -1182,7 +945,7 @@ static void* receiver_thread(void* arg) {
                     break;
                 }
                 
-                if (share_data_size + 4 > SHARE_SIZE) {
+                if (share_data_size > SHARE_VALUE_MAX) {
                     fprintf(stderr, "Receiver %d: Share value too large for block %zu\n", receiver_id + 1, block_idx);
                     all_saved = 0;
                     break;
@@ -1199,15 +962,29 @@ static void* receiver_thread(void* arg) {
                 printf("Receiver %d: Parsed block %zu (x=%d, block_size=%zu, secret_len=%zu)\n", 
                        receiver_id + 1, share.block_index, share.x, share.block_size, share.data_length);
                 
-                // 保存到本地JSON文件（使用当前地址）
-                int save_result = save_share_to_json_with_address(json_filename, msg_id_buf, &share, current_address);
-                if (save_result == 0) {
-                    saved_count++;
+                blocks[block_idx] = share;
+            }
+            
+            // 块之后的信封尾部（混合模式），没有则为普通分片消息
+            const uint8_t* envelope = NULL;
+            size_t envelope_len = 0;
+            if (all_saved && offset < msg_data_length &&
+                parse_share_envelope_trailer(received_msg->data + offset, msg_data_length - offset,
+                                             &envelope, &envelope_len) == 0) {
+                printf("Receiver %d: Message carries %zu-byte encrypted payload envelope\n", receiver_id + 1, envelope_len);
+            }
+            
+            // 整条消息作为一条记录写入分片日志（使用当前地址）
+            if (all_saved) {
+                if (share_store_append(store, msg_id_buf, current_address, blocks, num_blocks,
+                                       envelope, envelope_len) == RLC_OK) {
+                    saved_count = (int)num_blocks;
                 } else {
-                    fprintf(stderr, "Receiver %d: Failed to save block %zu\n", receiver_id + 1, block_idx);
+                    fprintf(stderr, "Receiver %d: Failed to save %zu blocks\n", receiver_id + 1, num_blocks);
                     all_saved = 0;
                 }
             }
+            free(blocks);
             
             if (all_saved && saved_count == num_blocks) {
                 printf("Receiver %d: All %zu shares saved successfully (委员会地址: %s)\n", 
@@ -1224,6 +1001,7 @@ static void* receiver_thread(void* arg) {
             message_free(received_msg);
         zmq_msg_close(&zmq_message);
     }
+    share_store_close(store);
     zmq_close(socket);
     zmq_ctx_destroy(context);
     return NULL;
@@ -0,0 +1,441 @@
+/**
+ * 秘密分享并发分发器：后台线程持有所有 DEALER 套接字
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include "zmq.h"
+#include "/home/zxx/Config/relic/include/relic.h"
+#include "share_dispatch.h"
+
+// 后台线程在没有事件时最长阻塞的时间
+#define SHARE_DISPATCH_POLL_MS  1000
+
+enum { DISPATCH_PENDING = 0, DISPATCH_ACKED, DISPATCH_FAILED };
+
+typedef struct share_job_st {
+  size_t n, quorum;
+  size_t acks, pending;           // 已确认数、尚未结束的发送数
+  int detached;                   // 调用方已返回，最后一个结束的发送负责释放
+  int *status;
+} share_job_st;
+
+typedef struct share_task_st {
+  share_job_st *job;
+  size_t idx;
+  char endpoint[64];
+  uint8_t *payload;
+  size_t len;
+  int attempts;
+  long long sent_at;
+  struct share_task_st *next;     // 提交队列或某个端点的在途队列
+} share_task_st;
+
+// 一个接收者端点；REP 按到达顺序应答，所以在途队列的队首就是下一条回复对应的任务
+typedef struct {
+  char endpoint[64];
+  void *socket;
+  share_task_st *head, *tail;
+} share_peer_st;
+
+static struct {
+  pthread_mutex_t lock;
+  pthread_cond_t done_cond;
+  pthread_t thread;
+  int running, stopping;
+  long long drain_deadline;
+  int wake_fd[2];                 // 提交方写入一个字节唤醒 zmq_poll
+  void *context;
+  share_task_st *queue_head, *queue_tail;
+  share_peer_st peers[SHARE_DISPATCH_MAX_PEERS];   // 只由后台线程访问
+  size_t num_peers;
+} dispatcher = { .lock = PTHREAD_MUTEX_INITIALIZER, .done_cond = PTHREAD_COND_INITIALIZER, .wake_fd = { -1, -1 } };
+
+static long long dispatch_now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long) ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void dispatch_job_free(share_job_st *job) {
+  free(job->status);
+  free(job);
+}
+
+// 结束一个发送并唤醒调用方；任务此时已不在任何队列中
+static void dispatch_task_finish(share_task_st *task, int ok) {
+  share_job_st *job = task->job;
+  pthread_mutex_lock(&dispatcher.lock);
+  job->status[task->idx] = ok ? DISPATCH_ACKED : DISPATCH_FAILED;
+  if (ok) job->acks++;
+  job->pending--;
+  int release = job->detached && job->pending == 0;
+  pthread_cond_broadcast(&dispatcher.done_cond);
+  pthread_mutex_unlock(&dispatcher.lock);
+
+  if (release) dispatch_job_free(job);
+  free(task->payload);
+  free(task);
+}
+
+static void *dispatch_socket_open(const char *endpoint) {
+  void *socket = zmq_socket(dispatcher.context, ZMQ_DEALER);
+  if (socket == NULL) return NULL;
+  int linger = 0;
+  zmq_setsockopt(socket, ZMQ_LINGER, &linger, sizeof(linger));
+  if (zmq_connect(socket, endpoint) != 0) {
+    fprintf(stderr, "[VSS] 无法连接接收者 %s: %s\n", endpoint, zmq_strerror(errno));
+    zmq_close(socket);
+    return NULL;
+  }
+  return socket;
+}
+
+static share_peer_st *dispatch_peer_get(const char *endpoint) {
+  for (size_t i = 0; i < dispatcher.num_peers; i++) {
+    share_peer_st *peer = &dispatcher.peers[i];
+    if (strcmp(peer->endpoint, endpoint) != 0) continue;
+    // 上次重建连接失败时再试一次
+    if (peer->socket == NULL) peer->socket = dispatch_socket_open(endpoint);
+    return peer->socket != NULL ? peer : NULL;
+  }
+
+  // 表满时回收一个空闲端点（委员会轮换后旧端点不再使用）
+  share_peer_st *peer = NULL;
+  if (dispatcher.num_peers < SHARE_DISPATCH_MAX_PEERS) {
+    peer = &dispatcher.peers[dispatcher.num_peers];
+  } else {
+    for (size_t i = 0; i < dispatcher.num_peers && peer == NULL; i++) {
+      if (dispatcher.peers[i].head == NULL) peer = &dispatcher.peers[i];
+    }
+    if (peer == NULL) return NULL;
+    if (peer->socket != NULL) zmq_close(peer->socket);
+    memset(peer, 0, sizeof(*peer));
+  }
+
+  if (snprintf(peer->endpoint, sizeof(peer->endpoint), "%s", endpoint) >= (int) sizeof(peer->endpoint)) {
+    peer->endpoint[0] = '\0';
+    return NULL;
+  }
+  void *socket = dispatch_socket_open(endpoint);
+  if (socket == NULL) {
+    peer->endpoint[0] = '\0';
+    return NULL;
+  }
+  peer->socket = socket;
+  if (peer == &dispatcher.peers[dispatcher.num_peers]) dispatcher.num_peers++;
+  return peer;
+}
+
+// REP 要求请求以空分隔帧开头
+static int dispatch_task_send(share_peer_st *peer, share_task_st *task) {
+  task->attempts++;
+  task->sent_at = dispatch_now_ms();
+  if (zmq_send(peer->socket, "", 0, ZMQ_SNDMORE | ZMQ_DONTWAIT) < 0) return RLC_ERR;
+  if (zmq_send(peer->socket, task->payload, task->len, ZMQ_DONTWAIT) != (int) task->len) return RLC_ERR;
+  return RLC_OK;
+}
+
+static void dispatch_peer_push(share_peer_st *peer, share_task_st *task) {
+  task->next = NULL;
+  if (peer->tail != NULL) {
+    peer->tail->next = task;
+  } else {
+    peer->head = task;
+  }
+  peer->tail = task;
+}
+
+static share_task_st *dispatch_peer_pop(share_peer_st *peer) {
+  share_task_st *task = peer->head;
+  if (task != NULL) {
+    peer->head = task->next;
+    if (peer->head == NULL) peer->tail = NULL;
+    task->next = NULL;
+  }
+  return task;
+}
+
+// 超时后 DEALER 与 REP 之间的应答顺序不再可信：重建连接，在途任务按序重发或放弃
+static void dispatch_peer_reset(share_peer_st *peer) {
+  share_task_st *inflight = peer->head;
+  peer->head = peer->tail = NULL;
+  zmq_close(peer->socket);
+  peer->socket = dispatch_socket_open(peer->endpoint);
+
+  while (inflight != NULL) {
+    share_task_st *task = inflight;
+    inflight = inflight->next;
+    if (peer->socket == NULL || task->attempts >= SHARE_DISPATCH_MAX_ATTEMPTS) {
+      fprintf(stderr, "[VSS] 接收者 %s 在 %d 次尝试后仍未应答，放弃\n", peer->endpoint, task->attempts);
+      dispatch_task_finish(task, 0);
+      continue;
+    }
+    fprintf(stderr, "[VSS] 接收者 %s 应答超时，重发（第 %d 次）\n", peer->endpoint, task->attempts + 1);
+    dispatch_peer_push(peer, task);
+    if (dispatch_task_send(peer, task) != RLC_OK) task->sent_at = 0;   // 下一轮按超时处理
+  }
+}
+
+static void dispatch_peer_recv(share_peer_st *peer) {
+  for (;;) {
+    zmq_msg_t frame;
+    zmq_msg_init(&frame);
+    if (zmq_msg_recv(&frame, peer->socket, ZMQ_DONTWAIT) < 0) {
+      zmq_msg_close(&frame);
+      return;
+    }
+    // 跳过空分隔帧，取最后一帧作为应答
+    while (zmq_msg_more(&frame)) {
+      zmq_msg_close(&frame);
+      zmq_msg_init(&frame);
+      if (zmq_msg_recv(&frame, peer->socket, 0) < 0) break;
+    }
+
+    char reply[64] = { 0 };
+    size_t size = zmq_msg_size(&frame);
+    memcpy(reply, zmq_msg_data(&frame), size < sizeof(reply) - 1 ? size : sizeof(reply) - 1);
+    zmq_msg_close(&frame);
+
+    share_task_st *task = dispatch_peer_pop(peer);
+    if (task == NULL) continue;
+
+    // 与旧实现一致：除 SAVE_ERROR 外的应答都视为已接收
+    int ok = strcmp(reply, "SAVE_ERROR") != 0;
+    if (!ok) {
+      fprintf(stderr, "[VSS] Error: Receiver %s reported SAVE_ERROR\n", peer->endpoint);
+    } else if (strcmp(reply, "ACK") != 0) {
+      printf("[VSS] Warning: Unexpected reply from receiver %s: %s\n", peer->endpoint, reply);
+    }
+    dispatch_task_finish(task, ok);
+  }
+}
+
+static size_t dispatch_inflight(void) {
+  size_t count = 0;
+  for (size_t i = 0; i < dispatcher.num_peers; i++) {
+    if (dispatcher.peers[i].head != NULL) count++;
+  }
+  return count;
+}
+
+static void *dispatch_loop(void *arg) {
+  (void) arg;
+  zmq_pollitem_t items[SHARE_DISPATCH_MAX_PEERS + 1];
+  share_peer_st *polled[SHARE_DISPATCH_MAX_PEERS];
+
+  for (;;) {
+    pthread_mutex_lock(&dispatcher.lock);
+    int stopping = dispatcher.stopping;
+    long long drain_deadline = dispatcher.drain_deadline;
+    share_task_st *queued = dispatcher.queue_head;
+    dispatcher.queue_head = dispatcher.queue_tail = NULL;
+    pthread_mutex_unlock(&dispatcher.lock);
+
+    while (queued != NULL) {
+      share_task_st *task = queued;
+      queued = queued->next;
+      share_peer_st *peer = dispatch_peer_get(task->endpoint);
+      if (peer == NULL) {
+        dispatch_task_finish(task, 0);
+        continue;
+      }
+      dispatch_peer_push(peer, task);
+      if (dispatch_task_send(peer, task) != RLC_OK) task->sent_at = 0;
+    }
+
+    long long now = dispatch_now_ms();
+    if (stopping && (dispatch_inflight() == 0 || now >= drain_deadline)) break;
+
+    size_t num_items = 0;
+    long timeout = SHARE_DISPATCH_POLL_MS;
+    items[num_items++] = (zmq_pollitem_t) { NULL, dispatcher.wake_fd[0], ZMQ_POLLIN, 0 };
+    for (size_t i = 0; i < dispatcher.num_peers; i++) {
+      share_peer_st *peer = &dispatcher.peers[i];
+      if (peer->head == NULL) continue;
+      long left = (long) (peer->head->sent_at + SHARE_DISPATCH_ACK_TIMEOUT_MS - now);
+      if (left < timeout) timeout = left > 0 ? left : 0;
+      polled[num_items - 1] = peer;
+      items[num_items++] = (zmq_pollitem_t) { peer->socket, 0, ZMQ_POLLIN, 0 };
+    }
+
+    if (zmq_poll(items, (int) num_items, timeout) < 0 && errno != EINTR) break;
+
+    if (items[0].revents & ZMQ_POLLIN) {
+      char drain[64];
+      while (read(dispatcher.wake_fd[0], drain, sizeof(drain)) > 0) {}
+    }
+    for (size_t i = 1; i < num_items; i++) {
+      if (items[i].revents & ZMQ_POLLIN) dispatch_peer_recv(polled[i - 1]);
+    }
+
+    now = dispatch_now_ms();
+    for (size_t i = 0; i < dispatcher.num_peers; i++) {
+      share_peer_st *peer = &dispatcher.peers[i];
+      if (peer->head != NULL && now - peer->head->sent_at >= SHARE_DISPATCH_ACK_TIMEOUT_MS) {
+        dispatch_peer_reset(peer);
+      }
+    }
+  }
+
+  // 关闭：提交队列与在途任务全部以失败结束
+  pthread_mutex_lock(&dispatcher.lock);
+  share_task_st *queued = dispatcher.queue_head;
+  dispatcher.queue_head = dispatcher.queue_tail = NULL;
+  pthread_mutex_unlock(&dispatcher.lock);
+  while (queued != NULL) {
+    share_task_st *task = queued;
+    queued = queued->next;
+    dispatch_task_finish(task, 0);
+  }
+  for (size_t i = 0; i < dispatcher.num_peers; i++) {
+    share_peer_st *peer = &dispatcher.peers[i];
+    share_task_st *task;
+    while ((task = dispatch_peer_pop(peer)) != NULL) dispatch_task_finish(task, 0);
+    if (peer->socket != NULL) zmq_close(peer->socket);
+    memset(peer, 0, sizeof(*peer));
+  }
+  dispatcher.num_peers = 0;
+  return NULL;
+}
+
+// 调用时持有 dispatcher.lock
+static int dispatch_start_locked(void) {
+  if (dispatcher.running) return dispatcher.stopping ? RLC_ERR : RLC_OK;
+
+  if (pipe(dispatcher.wake_fd) != 0) return RLC_ERR;
+  fcntl(dispatcher.wake_fd[0], F_SETFL, O_NONBLOCK);
+  fcntl(dispatcher.wake_fd[1], F_SETFL, O_NONBLOCK);
+
+  dispatcher.context = zmq_ctx_new();
+  if (dispatcher.context == NULL) goto fail;
+  dispatcher.stopping = 0;
+  if (pthread_create(&dispatcher.thread, NULL, dispatch_loop, NULL) != 0) {
+    zmq_ctx_term(dispatcher.context);
+    dispatcher.context = NULL;
+    goto fail;
+  }
+  dispatcher.running = 1;
+  return RLC_OK;
+
+fail:
+  close(dispatcher.wake_fd[0]);
+  close(dispatcher.wake_fd[1]);
+  dispatcher.wake_fd[0] = dispatcher.wake_fd[1] = -1;
+  return RLC_ERR;
+}
+
+static void dispatch_wake_locked(void) {
+  char byte = 1;
+  if (write(dispatcher.wake_fd[1], &byte, 1) < 0 && errno != EAGAIN) {
+    fprintf(stderr, "[VSS] 唤醒分发线程失败: %s\n", strerror(errno));
+  }
+}
+
+int share_dispatch(const char **endpoints, uint8_t **payloads, const size_t *lens, size_t n, size_t quorum) {
+  if (endpoints == NULL || payloads == NULL || lens == NULL || n == 0) return -1;
+
+  share_job_st *job = calloc(1, sizeof(share_job_st));
+  if (job == NULL) return -1;
+  job->status = calloc(n, sizeof(int));
+  if (job->status == NULL) {
+    free(job);
+    return -1;
+  }
+  job->n = n;
+  job->quorum = quorum;
+
+  // 先在锁外复制所有载荷
+  share_task_st *head = NULL, *tail = NULL;
+  for (size_t i = 0; i < n; i++) {
+    job->status[i] = DISPATCH_FAILED;
+    if (endpoints[i] == NULL || endpoints[i][0] == '\0' || payloads[i] == NULL) continue;
+    // 截断的端点会连到错误的地址，视为失败
+    if (strlen(endpoints[i]) >= sizeof(((share_task_st *) 0)->endpoint)) {
+      fprintf(stderr, "[VSS] 接收者端点过长（%zu 字节），跳过: %s\n", strlen(endpoints[i]), endpoints[i]);
+      continue;
+    }
+    share_task_st *task = calloc(1, sizeof(share_task_st));
+    if (task != NULL) task->payload = malloc(lens[i]);
+    if (task == NULL || task->payload == NULL) {
+      free(task);
+      continue;
+    }
+    memcpy(task->payload, payloads[i], lens[i]);
+    task->len = lens[i];
+    task->job = job;
+    task->idx = i;
+    memcpy(task->endpoint, endpoints[i], strlen(endpoints[i]) + 1);
+    job->status[i] = DISPATCH_PENDING;
+    job->pending++;
+    if (tail != NULL) {
+      tail->next = task;
+    } else {
+      head = task;
+    }
+    tail = task;
+  }
+
+  pthread_mutex_lock(&dispatcher.lock);
+  if (head != NULL && dispatch_start_locked() != RLC_OK) {
+    pthread_mutex_unlock(&dispatcher.lock);
+    while (head != NULL) {
+      share_task_st *task = head;
+      head = head->next;
+      free(task->payload);
+      free(task);
+    }
+    dispatch_job_free(job);
+    return -1;
+  }
+  if (head != NULL) {
+    if (dispatcher.queue_tail != NULL) {
+      dispatcher.queue_tail->next = head;
+    } else {
+      dispatcher.queue_head = head;
+    }
+    dispatcher.queue_tail = tail;
+    dispatch_wake_locked();
+  }
+
+  while (job->acks < quorum && job->pending > 0) {
+    pthread_cond_wait(&dispatcher.done_cond, &dispatcher.lock);
+  }
+  int acks = (int) job->acks;
+  job->detached = 1;
+  int release = job->pending == 0;
+  pthread_mutex_unlock(&dispatcher.lock);
+
+  if (release) dispatch_job_free(job);
+  return acks;
+}
+
+void share_dispatch_shutdown(long drain_ms) {
+  pthread_mutex_lock(&dispatcher.lock);
+  if (!dispatcher.running || dispatcher.stopping) {
+    pthread_mutex_unlock(&dispatcher.lock);
+    return;
+  }
+  dispatcher.stopping = 1;
+  dispatcher.drain_deadline = dispatch_now_ms() + (drain_ms > 0 ? drain_ms : SHARE_DISPATCH_DRAIN_MS);
+  dispatch_wake_locked();
+  pthread_mutex_unlock(&dispatcher.lock);
+
+  pthread_join(dispatcher.thread, NULL);
+
+  pthread_mutex_lock(&dispatcher.lock);
+  zmq_ctx_term(dispatcher.context);
+  dispatcher.context = NULL;
+  close(dispatcher.wake_fd[0]);
+  close(dispatcher.wake_fd[1]);
+  dispatcher.wake_fd[0] = dispatcher.wake_fd[1] = -1;
+  dispatcher.running = 0;
+  dispatcher.stopping = 0;
+  pthread_mutex_unlock(&dispatcher.lock);
+}
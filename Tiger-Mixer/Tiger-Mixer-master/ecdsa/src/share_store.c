@@ -0,0 +1,678 @@
+/**
+ * 接收者分片存储实现
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "/home/zxx/Config/relic/include/relic.h"
+#include "share_store.h"
+
+#define SHARE_INDEX_MAGIC    "A2LSIDX1"
+#define SHARE_RECORD_MAGIC   0x31524853u        // "SHR1"
+#define SHARE_RECORD_MAX     (64u << 20)
+#define SHARE_ADDRESS_MAXLEN 64
+
+// 索引文件头，后面紧跟 capacity 个槽位
+typedef struct {
+  char magic[8];
+  uint64_t capacity;                    // 槽位数，2 的幂
+  uint64_t count;                       // 已用槽位数
+  uint64_t log_size;                    // 已编入索引的日志长度
+  uint64_t clean;                       // 正常关闭时为 1，打开期间为 0
+} share_index_header_t;
+
+typedef struct {
+  uint64_t hash;
+  uint64_t head;                        // 最新记录偏移 + 1，0 表示空槽
+} share_index_slot_t;
+
+// 日志记录：头 | msg_id | address | count 个块 | 信封（混合模式，其余字节，可为空）
+typedef struct {
+  uint32_t magic;
+  uint32_t length;                      // 整条记录长度
+  uint64_t prev;                        // 同一哈希的上一条记录偏移 + 1
+  uint64_t hash;
+  int64_t timestamp;
+  int32_t x;
+  uint32_t count;
+  uint16_t msgid_len;
+  uint16_t address_len;
+  uint32_t checksum;                    // 整条记录（本字段置 0）的 FNV-1a
+} share_record_header_t;
+
+typedef struct {
+  uint64_t block_index;
+  uint64_t block_size;
+  uint64_t data_length;
+  uint8_t y[SHARE_Y_SIZE];
+  uint8_t reserved[4];
+} share_record_block_t;
+
+struct share_store_st {
+  pthread_mutex_t mutex;
+  int log_fd;
+  int index_fd;
+  uint64_t log_size;
+  share_index_header_t *index;          // mmap 的索引文件
+  size_t index_bytes;
+  unsigned unsynced;                    // 上次 fsync 以来追加的记录数
+  long long last_sync_ms;
+  char *index_path;
+};
+
+static long long share_now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long) ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static uint64_t share_hash(const char *msg_id) {
+  uint64_t h = 0xcbf29ce484222325ULL;
+  for (const unsigned char *p = (const unsigned char *) msg_id; *p != '\0'; p++) {
+    h ^= *p;
+    h *= 0x100000001b3ULL;
+  }
+  return h;
+}
+
+static uint32_t share_checksum(const uint8_t *record, size_t length) {
+  uint32_t h = 0x811c9dc5u;
+  for (size_t i = 0; i < length; i++) {
+    uint8_t b = record[i];
+    if (i >= offsetof(share_record_header_t, checksum) &&
+        i < offsetof(share_record_header_t, checksum) + sizeof(uint32_t)) {
+      b = 0;
+    }
+    h ^= b;
+    h *= 0x01000193u;
+  }
+  return h;
+}
+
+static share_index_slot_t *share_slots(share_index_header_t *index) {
+  return (share_index_slot_t *) (index + 1);
+}
+
+static size_t share_index_bytes(uint64_t capacity) {
+  return sizeof(share_index_header_t) + capacity * sizeof(share_index_slot_t);
+}
+
+// ================= 索引 =================
+
+// 新建空索引文件并映射
+static share_index_header_t *share_index_create(const char *path, uint64_t capacity, int *fd_out) {
+  size_t bytes = share_index_bytes(capacity);
+  int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) return NULL;
+  if (ftruncate(fd, (off_t) bytes) != 0) {
+    close(fd);
+    return NULL;
+  }
+  share_index_header_t *index = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (index == MAP_FAILED) {
+    close(fd);
+    return NULL;
+  }
+  memcpy(index->magic, SHARE_INDEX_MAGIC, sizeof(index->magic));
+  index->capacity = capacity;
+  *fd_out = fd;
+  return index;
+}
+
+// 映射已有索引；格式不符或上次未正常关闭时返回 NULL
+static share_index_header_t *share_index_map(const char *path, uint64_t log_size, int *fd_out, size_t *bytes_out) {
+  int fd = open(path, O_RDWR);
+  if (fd < 0) return NULL;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(share_index_header_t)) {
+    close(fd);
+    return NULL;
+  }
+  share_index_header_t *index = mmap(NULL, (size_t) st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (index == MAP_FAILED) {
+    close(fd);
+    return NULL;
+  }
+  uint64_t capacity = index->capacity;
+  if (memcmp(index->magic, SHARE_INDEX_MAGIC, sizeof(index->magic)) != 0 ||
+      capacity < SHARE_STORE_MIN_CAPACITY || (capacity & (capacity - 1)) != 0 ||
+      share_index_bytes(capacity) != (size_t) st.st_size ||
+      index->clean != 1 || index->log_size > log_size) {
+    munmap(index, (size_t) st.st_size);
+    close(fd);
+    return NULL;
+  }
+  *fd_out = fd;
+  *bytes_out = (size_t) st.st_size;
+  return index;
+}
+
+static uint64_t share_index_get(const share_store_t store, uint64_t hash) {
+  share_index_slot_t *slots = share_slots(store->index);
+  uint64_t mask = store->index->capacity - 1;
+  for (uint64_t i = hash & mask; slots[i].head != 0; i = (i + 1) & mask) {
+    if (slots[i].hash == hash) return slots[i].head;
+  }
+  return 0;
+}
+
+static void share_index_set(share_index_header_t *index, uint64_t hash, uint64_t head) {
+  share_index_slot_t *slots = share_slots(index);
+  uint64_t mask = index->capacity - 1;
+  uint64_t i = hash & mask;
+  while (slots[i].head != 0 && slots[i].hash != hash) i = (i + 1) & mask;
+  if (slots[i].head == 0) {
+    slots[i].hash = hash;
+    index->count++;
+  }
+  slots[i].head = head;
+}
+
+// 容量翻倍：写临时文件后 rename 替换
+static int share_index_grow(share_store_t store) {
+  uint64_t capacity = store->index->capacity * 2;
+  size_t len = strlen(store->index_path);
+  char *tmp_path = malloc(len + 5);
+  if (tmp_path == NULL) return RLC_ERR;
+  memcpy(tmp_path, store->index_path, len);
+  memcpy(tmp_path + len, ".tmp", 5);
+
+  int fd = -1;
+  share_index_header_t *grown = share_index_create(tmp_path, capacity, &fd);
+  if (grown == NULL) {
+    free(tmp_path);
+    return RLC_ERR;
+  }
+  share_index_slot_t *slots = share_slots(store->index);
+  for (uint64_t i = 0; i < store->index->capacity; i++) {
+    if (slots[i].head != 0) share_index_set(grown, slots[i].hash, slots[i].head);
+  }
+  grown->log_size = store->index->log_size;
+  if (rename(tmp_path, store->index_path) != 0) {
+    munmap(grown, share_index_bytes(capacity));
+    close(fd);
+    unlink(tmp_path);
+    free(tmp_path);
+    return RLC_ERR;
+  }
+  free(tmp_path);
+
+  munmap(store->index, store->index_bytes);
+  close(store->index_fd);
+  store->index = grown;
+  store->index_fd = fd;
+  store->index_bytes = share_index_bytes(capacity);
+  return RLC_OK;
+}
+
+static int share_index_put(share_store_t store, uint64_t hash, uint64_t head) {
+  if ((store->index->count + 1) * 4 > store->index->capacity * 3 && share_index_grow(store) != RLC_OK) {
+    return RLC_ERR;
+  }
+  share_index_set(store->index, hash, head);
+  return RLC_OK;
+}
+
+// ================= 日志 =================
+
+// 读取并校验 offset 处的完整记录；返回 malloc 的记录缓冲区，失败返回 NULL
+static uint8_t *share_record_read(const share_store_t store, uint64_t offset, uint64_t limit) {
+  share_record_header_t hdr;
+  if (offset + sizeof(hdr) > limit) return NULL;
+  if (pread(store->log_fd, &hdr, sizeof(hdr), (off_t) offset) != (ssize_t) sizeof(hdr)) return NULL;
+  if (hdr.magic != SHARE_RECORD_MAGIC || hdr.length > SHARE_RECORD_MAX || offset + hdr.length > limit) return NULL;
+  if (hdr.length < sizeof(hdr) + hdr.msgid_len + hdr.address_len + (size_t) hdr.count * sizeof(share_record_block_t)) {
+    return NULL;
+  }
+
+  uint8_t *record = malloc(hdr.length);
+  if (record == NULL) return NULL;
+  if (pread(store->log_fd, record, hdr.length, (off_t) offset) != (ssize_t) hdr.length ||
+      share_checksum(record, hdr.length) != hdr.checksum) {
+    free(record);
+    return NULL;
+  }
+  return record;
+}
+
+// 日志中无法编入索引的尾部的性质
+enum {
+  SHARE_TAIL_TORN,                      // 上次没写完的最后一条记录，可以截掉
+  SHARE_TAIL_CORRUPT,                   // 不是写到一半的记录，截掉会丢掉其后的分片
+  SHARE_TAIL_ERROR,                     // 读取失败或内存不足，无法判断
+};
+
+// offset 处的记录读取失败时判断原因（与 vss_archive 的尾部判定一致）：只有记录头声明的长度超过
+// 剩余字节（含头本身没写完、已写出的是魔数前缀），或到文件末尾的最后一条记录校验和不符，才算写到一半
+static int share_log_tail(const share_store_t store, uint64_t offset, uint64_t size) {
+  uint64_t remaining = size - offset;
+  share_record_header_t hdr;
+  const uint32_t magic = SHARE_RECORD_MAGIC;
+
+  if (remaining < sizeof(hdr)) {
+    uint8_t prefix[sizeof(hdr)];
+    size_t n = remaining < sizeof(magic) ? (size_t) remaining : sizeof(magic);
+    if (pread(store->log_fd, prefix, n, (off_t) offset) != (ssize_t) n) return SHARE_TAIL_ERROR;
+    return memcmp(prefix, &magic, n) == 0 ? SHARE_TAIL_TORN : SHARE_TAIL_CORRUPT;
+  }
+  if (pread(store->log_fd, &hdr, sizeof(hdr), (off_t) offset) != (ssize_t) sizeof(hdr)) return SHARE_TAIL_ERROR;
+  if (hdr.magic != SHARE_RECORD_MAGIC || hdr.length > SHARE_RECORD_MAX ||
+      hdr.length < sizeof(hdr) + hdr.msgid_len + hdr.address_len + (size_t) hdr.count * sizeof(share_record_block_t)) {
+    return SHARE_TAIL_CORRUPT;
+  }
+  if (hdr.length > remaining) return SHARE_TAIL_TORN;
+  if (hdr.length < remaining) return SHARE_TAIL_CORRUPT;
+
+  // 最后一条记录长度完整：校验和不符说明数据没有全部落盘
+  uint8_t *record = malloc(hdr.length);
+  if (record == NULL) return SHARE_TAIL_ERROR;
+  int tail = SHARE_TAIL_ERROR;
+  if (pread(store->log_fd, record, hdr.length, (off_t) offset) == (ssize_t) hdr.length) {
+    tail = share_checksum(record, hdr.length) != hdr.checksum ? SHARE_TAIL_TORN : SHARE_TAIL_ERROR;
+  }
+  free(record);
+  return tail;
+}
+
+// 从 offset 开始把日志记录编入索引；只截掉写到一半的最后一条记录，
+// 中间的记录损坏时拒绝打开，不改动日志
+static int share_log_scan(share_store_t store, uint64_t offset) {
+  struct stat st;
+  if (fstat(store->log_fd, &st) != 0) return RLC_ERR;
+  uint64_t size = (uint64_t) st.st_size;
+  size_t indexed = 0;
+
+  while (offset < size) {
+    uint8_t *record = share_record_read(store, offset, size);
+    if (record == NULL) break;
+    share_record_header_t hdr;
+    memcpy(&hdr, record, sizeof(hdr));
+    free(record);
+    if (share_index_put(store, hdr.hash, offset + 1) != RLC_OK) return RLC_ERR;
+    offset += hdr.length;
+    indexed++;
+  }
+
+  if (offset < size) {
+    switch (share_log_tail(store, offset, size)) {
+      case SHARE_TAIL_TORN:
+        fprintf(stderr, "[SHARE_STORE] 日志尾部 %llu 字节不完整，已截断\n", (unsigned long long) (size - offset));
+        if (ftruncate(store->log_fd, (off_t) offset) != 0) return RLC_ERR;
+        break;
+      case SHARE_TAIL_CORRUPT:
+        fprintf(stderr, "[SHARE_STORE] 日志偏移 %llu 处的记录损坏（其后还有 %llu 字节），拒绝打开，请人工检查\n",
+                (unsigned long long) offset, (unsigned long long) (size - offset));
+        return RLC_ERR;
+      default:
+        fprintf(stderr, "[SHARE_STORE] 无法读取日志偏移 %llu 处的记录\n", (unsigned long long) offset);
+        return RLC_ERR;
+    }
+  }
+  if (indexed > 0) printf("[SHARE_STORE] 从日志编入索引 %zu 条记录\n", indexed);
+  store->log_size = offset;
+  store->index->log_size = offset;
+  return RLC_OK;
+}
+
+static int share_log_sync(share_store_t store) {
+  if (fdatasync(store->log_fd) != 0) return RLC_ERR;
+  store->unsynced = 0;
+  store->last_sync_ms = share_now_ms();
+  return RLC_OK;
+}
+
+// 调用时持有 store->mutex
+static int share_append_locked(share_store_t store, const char *msg_id, const char *address,
+                               const secret_share_t *shares, size_t count,
+                               const uint8_t *envelope, size_t envelope_len, time_t timestamp) {
+  size_t msgid_len = strnlen(msg_id, MSG_ID_MAXLEN);
+  size_t address_len = address != NULL ? strnlen(address, SHARE_ADDRESS_MAXLEN) : 0;
+  if (envelope == NULL) envelope_len = 0;
+  if (envelope_len > SHARE_RECORD_MAX) return RLC_ERR;
+  size_t length = sizeof(share_record_header_t) + msgid_len + address_len + count * sizeof(share_record_block_t) + envelope_len;
+  if (length > SHARE_RECORD_MAX) return RLC_ERR;
+
+  uint8_t *record = calloc(1, length);
+  if (record == NULL) return RLC_ERR;
+
+  share_record_header_t hdr = { 0 };
+  hdr.magic = SHARE_RECORD_MAGIC;
+  hdr.length = (uint32_t) length;
+  hdr.hash = share_hash(msg_id);
+  hdr.prev = share_index_get(store, hdr.hash);
+  hdr.timestamp = (int64_t) timestamp;
+  hdr.x = shares[0].x;
+  hdr.count = (uint32_t) count;
+  hdr.msgid_len = (uint16_t) msgid_len;
+  hdr.address_len = (uint16_t) address_len;
+
+  uint8_t *p = record + sizeof(hdr);
+  memcpy(p, msg_id, msgid_len);
+  p += msgid_len;
+  if (address_len > 0) memcpy(p, address, address_len);
+  p += address_len;
+  for (size_t i = 0; i < count; i++, p += sizeof(share_record_block_t)) {
+    share_record_block_t block = { 0 };
+    block.block_index = shares[i].block_index;
+    block.block_size = shares[i].block_size;
+    block.data_length = shares[i].data_length;
+    memcpy(block.y, shares[i].y, SHARE_Y_SIZE);
+    memcpy(p, &block, sizeof(block));
+  }
+  if (envelope_len > 0) memcpy(p, envelope, envelope_len);
+  memcpy(record, &hdr, sizeof(hdr));
+  hdr.checksum = share_checksum(record, length);
+  memcpy(record + offsetof(share_record_header_t, checksum), &hdr.checksum, sizeof(hdr.checksum));
+
+  size_t written = 0;
+  while (written < length) {
+    ssize_t n = write(store->log_fd, record + written, length - written);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) break;
+    written += (size_t) n;
+  }
+  free(record);
+  if (written < length) {
+    fprintf(stderr, "[SHARE_STORE] 写日志失败: %s\n", strerror(errno));
+    if (ftruncate(store->log_fd, (off_t) store->log_size) != 0) {
+      fprintf(stderr, "[SHARE_STORE] 回滚日志失败: %s\n", strerror(errno));
+    }
+    return RLC_ERR;
+  }
+
+  uint64_t offset = store->log_size;
+  store->log_size += length;
+  if (share_index_put(store, hdr.hash, offset + 1) != RLC_OK) return RLC_ERR;
+  store->index->log_size = store->log_size;
+
+  store->unsynced++;
+  if (store->unsynced >= SHARE_STORE_SYNC_BATCH || share_now_ms() - store->last_sync_ms >= SHARE_STORE_SYNC_MS) {
+    return share_log_sync(store);
+  }
+  return RLC_OK;
+}
+
+// ================= 旧 JSON 导入 =================
+
+static void share_hex_decode(const char *hex, uint8_t *out, size_t out_size) {
+  memset(out, 0, out_size);
+  for (size_t i = 0; i < out_size && hex[i * 2] != '\0' && hex[i * 2 + 1] != '\0'; i++) {
+    unsigned int byte;
+    if (sscanf(hex + i * 2, "%2x", &byte) != 1) break;
+    out[i] = (uint8_t) byte;
+  }
+}
+
+// 连续的同一 msg_id、x 的行合并为一条记录
+static int share_import_json(share_store_t store, const char *json_path) {
+  FILE *fp = fopen(json_path, "r");
+  if (fp == NULL) return RLC_OK;
+
+  const size_t line_size = 65536;
+  size_t batch_cap = 1024;
+  char *line = malloc(line_size);
+  secret_share_t *batch = malloc(batch_cap * sizeof(secret_share_t));
+  if (line == NULL || batch == NULL) {
+    free(line);
+    free(batch);
+    fclose(fp);
+    return RLC_ERR;
+  }
+
+  int result = RLC_OK;
+  size_t batch_len = 0, imported = 0;
+  char batch_msgid[MSG_ID_MAXLEN] = { 0 };
+  char batch_address[SHARE_ADDRESS_MAXLEN] = { 0 };
+  time_t batch_time = 0;
+
+  for (;;) {
+    int eof = fgets(line, (int) line_size, fp) == NULL;
+    char msgid[MSG_ID_MAXLEN] = { 0 };
+    char y_hex[2 * SHARE_Y_SIZE + 1] = { 0 };
+    char address[SHARE_ADDRESS_MAXLEN] = { 0 };
+    secret_share_t share;
+    memset(&share, 0, sizeof(share));
+    int parsed = 0;
+
+    if (!eof) {
+      int n = sscanf(line, "{\"msg_id\":\"%127[^\"]\",\"x\":%d,\"block_index\":%zu,\"block_size\":%zu,\"data_length\":%zu,\"y\":\"%72[^\"]",
+                     msgid, &share.x, &share.block_index, &share.block_size, &share.data_length, y_hex);
+      if (n == 6) {
+        parsed = 1;
+      } else if (sscanf(line, "{\"msg_id\":\"%127[^\"]\",\"x\":%d,\"data_length\":%zu,\"y\":\"%72[^\"]",
+                        msgid, &share.x, &share.data_length, y_hex) == 4) {
+        parsed = 2;
+        share.block_size = share.data_length;
+      }
+      if (!parsed) continue;
+    }
+
+    int same = parsed && batch_len > 0 && strcmp(msgid, batch_msgid) == 0 && share.x == batch[0].x;
+    if (batch_len > 0 && (!same || batch_len == batch_cap)) {
+      if (share_append_locked(store, batch_msgid, batch_address, batch, batch_len, NULL, 0, batch_time) != RLC_OK) {
+        result = RLC_ERR;
+        break;
+      }
+      imported += batch_len;
+      batch_len = 0;
+    }
+    if (eof) break;
+
+    const char *addr = strstr(line, "\"address\":\"");
+    if (addr != NULL) sscanf(addr, "\"address\":\"%63[^\"]", address);
+    const char *ts = strstr(line, "\"timestamp\":");
+    long timestamp = 0;
+    if (ts != NULL) sscanf(ts, "\"timestamp\":%ld", &timestamp);
+
+    if (batch_len == 0) {
+      snprintf(batch_msgid, sizeof(batch_msgid), "%s", msgid);
+      snprintf(batch_address, sizeof(batch_address), "%s", address);
+      batch_time = (time_t) timestamp;
+    }
+    // 旧格式没有 block_index：按出现顺序编号
+    if (parsed == 2) share.block_index = batch_len;
+    share_hex_decode(y_hex, share.y, sizeof(share.y));
+    batch[batch_len++] = share;
+  }
+
+  free(line);
+  free(batch);
+  fclose(fp);
+  if (result == RLC_OK && imported > 0) {
+    result = share_log_sync(store);
+    printf("[SHARE_STORE] 已从 %s 导入 %zu 个分片\n", json_path, imported);
+  }
+  return result;
+}
+
+// ================= 接口 =================
+
+share_store_t share_store_open(const char *log_path, const char *index_path, const char *legacy_json_path) {
+  if (log_path == NULL || index_path == NULL) return NULL;
+
+  share_store_t store = calloc(1, sizeof(struct share_store_st));
+  if (store == NULL) return NULL;
+  pthread_mutex_init(&store->mutex, NULL);
+  store->index_fd = -1;
+  store->index_path = strdup(index_path);
+  store->log_fd = open(log_path, O_RDWR | O_CREAT | O_APPEND, 0644);
+  if (store->index_path == NULL || store->log_fd < 0) {
+    fprintf(stderr, "[SHARE_STORE] 无法打开日志 %s: %s\n", log_path, strerror(errno));
+    share_store_close(store);
+    return NULL;
+  }
+
+  struct stat st;
+  if (fstat(store->log_fd, &st) != 0) {
+    share_store_close(store);
+    return NULL;
+  }
+  uint64_t log_size = (uint64_t) st.st_size;
+
+  uint64_t scan_from = 0;
+  store->index = share_index_map(index_path, log_size, &store->index_fd, &store->index_bytes);
+  if (store->index != NULL) {
+    scan_from = store->index->log_size;
+  } else {
+    if (log_size > 0) printf("[SHARE_STORE] 索引 %s 缺失或上次未正常关闭，从日志重建\n", index_path);
+    store->index = share_index_create(index_path, SHARE_STORE_MIN_CAPACITY, &store->index_fd);
+    store->index_bytes = share_index_bytes(SHARE_STORE_MIN_CAPACITY);
+    if (store->index == NULL) {
+      fprintf(stderr, "[SHARE_STORE] 无法创建索引 %s: %s\n", index_path, strerror(errno));
+      share_store_close(store);
+      return NULL;
+    }
+  }
+
+  // 打开期间索引标记为未正常关闭，崩溃后下次打开会重建
+  store->index->clean = 0;
+  msync(store->index, sizeof(share_index_header_t), MS_SYNC);
+
+  store->last_sync_ms = share_now_ms();
+  if (share_log_scan(store, scan_from) != RLC_OK ||
+      (store->log_size == 0 && legacy_json_path != NULL && share_import_json(store, legacy_json_path) != RLC_OK)) {
+    fprintf(stderr, "[SHARE_STORE] 载入 %s 失败\n", log_path);
+    share_store_close(store);
+    return NULL;
+  }
+  return store;
+}
+
+void share_store_close(share_store_t store) {
+  if (store == NULL) return;
+  if (store->log_fd >= 0) {
+    if (fdatasync(store->log_fd) == 0 && store->index != NULL) {
+      store->index->log_size = store->log_size;
+      store->index->clean = 1;
+    }
+    close(store->log_fd);
+  }
+  if (store->index != NULL) {
+    msync(store->index, store->index_bytes, MS_SYNC);
+    munmap(store->index, store->index_bytes);
+  }
+  if (store->index_fd >= 0) close(store->index_fd);
+  pthread_mutex_destroy(&store->mutex);
+  free(store->index_path);
+  free(store);
+}
+
+int share_store_append(share_store_t store, const char *msg_id, const char *address,
+                       const secret_share_t *shares, size_t count,
+                       const uint8_t *envelope, size_t envelope_len) {
+  if (store == NULL || msg_id == NULL || shares == NULL || count == 0) return RLC_ERR;
+  for (size_t i = 1; i < count; i++) {
+    if (shares[i].x != shares[0].x) return RLC_ERR;
+  }
+  pthread_mutex_lock(&store->mutex);
+  int result = share_append_locked(store, msg_id, address, shares, count, envelope, envelope_len, time(NULL));
+  pthread_mutex_unlock(&store->mutex);
+  return result;
+}
+
+int share_store_load(share_store_t store, const char *msg_id, int x,
+                     secret_share_t *shares, size_t max_shares, size_t *num_shares_out,
+                     uint8_t **envelope_out, size_t *envelope_len_out) {
+  if (num_shares_out != NULL) *num_shares_out = 0;
+  if (envelope_out != NULL) *envelope_out = NULL;
+  if (envelope_len_out != NULL) *envelope_len_out = 0;
+  if (store == NULL || msg_id == NULL || shares == NULL || num_shares_out == NULL || max_shares == 0) return RLC_ERR;
+
+  uint8_t *filled = calloc(max_shares, 1);
+  if (filled == NULL) return RLC_ERR;
+  size_t msgid_len = strnlen(msg_id, MSG_ID_MAXLEN);
+  uint64_t hash = share_hash(msg_id);
+
+  pthread_mutex_lock(&store->mutex);
+  // 链从最新记录向前走，同一块以先看到的（最新的）为准
+  uint64_t link = share_index_get(store, hash);
+  while (link != 0) {
+    uint64_t offset = link - 1;
+    uint8_t *record = share_record_read(store, offset, store->log_size);
+    if (record == NULL) {
+      fprintf(stderr, "[SHARE_STORE] 偏移 %llu 处的记录损坏\n", (unsigned long long) offset);
+      break;
+    }
+    share_record_header_t hdr;
+    memcpy(&hdr, record, sizeof(hdr));
+
+    const uint8_t *p = record + sizeof(hdr);
+    if (hdr.x == x && hdr.msgid_len == msgid_len && memcmp(p, msg_id, msgid_len) == 0) {
+      p += hdr.msgid_len + hdr.address_len;
+      for (uint32_t i = 0; i < hdr.count; i++, p += sizeof(share_record_block_t)) {
+        share_record_block_t block;
+        memcpy(&block, p, sizeof(block));
+        if (block.block_index >= max_shares || filled[block.block_index]) continue;
+        secret_share_t *share = &shares[block.block_index];
+        memset(share, 0, sizeof(*share));
+        share->x = hdr.x;
+        share->block_index = (size_t) block.block_index;
+        share->block_size = (size_t) block.block_size;
+        share->data_length = (size_t) block.data_length;
+        memcpy(share->y, block.y, SHARE_Y_SIZE);
+        share->is_valid = 1;
+        strncpy(share->message_type, msg_id, sizeof(share->message_type) - 1);
+        share->received_time = (time_t) hdr.timestamp;
+        filled[block.block_index] = 1;
+      }
+      size_t envelope_len = hdr.length - (size_t) (p - record);
+      if (envelope_out != NULL && *envelope_out == NULL && envelope_len > 0) {
+        *envelope_out = malloc(envelope_len);
+        if (*envelope_out != NULL) {
+          memcpy(*envelope_out, p, envelope_len);
+          if (envelope_len_out != NULL) *envelope_len_out = envelope_len;
+        }
+      }
+    }
+    free(record);
+    // prev 只能指向更早的记录，防止损坏的链成环
+    link = hdr.prev != 0 && hdr.prev - 1 < offset ? hdr.prev : 0;
+  }
+  pthread_mutex_unlock(&store->mutex);
+
+  // 按 block_index 升序紧凑排列
+  size_t found = 0;
+  for (size_t i = 0; i < max_shares; i++) {
+    if (!filled[i]) continue;
+    if (found != i) shares[found] = shares[i];
+    found++;
+  }
+  free(filled);
+
+  *num_shares_out = found;
+  if (found == 0 && envelope_out != NULL) {
+    free(*envelope_out);
+    *envelope_out = NULL;
+    if (envelope_len_out != NULL) *envelope_len_out = 0;
+  }
+  return found > 0 ? RLC_OK : RLC_ERR;
+}
+
+int share_store_sync(share_store_t store) {
+  if (store == NULL) return RLC_ERR;
+  pthread_mutex_lock(&store->mutex);
+  int result = share_log_sync(store);
+  pthread_mutex_unlock(&store->mutex);
+  return result;
+}
+
+long share_store_sync_timeout(share_store_t store) {
+  if (store == NULL) return -1;
+  pthread_mutex_lock(&store->mutex);
+  long timeout = -1;
+  if (store->unsynced > 0) {
+    long long left = store->last_sync_ms + SHARE_STORE_SYNC_MS - share_now_ms();
+    timeout = left > 0 ? (long) left : 0;
+  }
+  pthread_mutex_unlock(&store->mutex);
+  return timeout;
+}
@@ -4,6 +4,7 @@
 #include <time.h>
 #include <sys/time.h>
 #include <unistd.h>
+#include <fcntl.h>
 #include "secret_share.h"
 #include "util.h"
 
@@ -127,11 +128,11 @@ int create_secret_shares_dynamic_threshold(const uint8_t* secret, size_t secret_
             shares[share_idx].block_index = block_idx;
             shares[share_idx].data_length = secret_len;
             shares[share_idx].block_size = block_size;
-            memset(shares[share_idx].y, 0, SHARE_SIZE);
+            memset(shares[share_idx].y, 0, sizeof(shares[share_idx].y));
             
             // 序列化分享值到y数组
             size_t share_size = bn_size_bin(share_value);
-            if (share_size + 4 > SHARE_SIZE) {
+            if (share_size > SHARE_VALUE_MAX) {
                 fprintf(stderr, "Error: Share value too large to serialize\n");
                 // 清理资源
                 for (int i = 0; i < threshold; i++) {
@@ -328,7 +329,7 @@ int reconstruct_secret_dynamic_threshold(const secret_share_t* shares, int thres
                                        (shares[i].y[2] << 16) |
                                        (shares[i].y[3] << 24);
                     
-                    if (share_size == 0 || share_size > SHARE_SIZE - 4) {
+                    if (share_size == 0 || share_size > SHARE_VALUE_MAX) {
                         fprintf(stderr, "Error: Invalid share size for block %zu: %zu\n", block_idx, share_size);
                         for (int j = 0; j < share_count; j++) {
                             bn_free(block_shares[j]);
@@ -570,11 +571,11 @@ double benchmark_vss_commitment_verification(size_t secret_len, int committee_si
             shares[share_idx].data_length = secret_len;
             shares[share_idx].block_size = (block_idx == num_blocks - 1) ? 
                                          (secret_len - block_idx * BLOCK_SIZE) : BLOCK_SIZE;
-            memset(shares[share_idx].y, 0, SHARE_SIZE);
+            memset(shares[share_idx].y, 0, sizeof(shares[share_idx].y));
             
             // 序列化分享值
             size_t share_size = bn_size_bin(share_value);
-            if (share_size + 4 > SHARE_SIZE) {
+            if (share_size > SHARE_VALUE_MAX) {
                 // 清理资源
                 for (size_t b = 0; b < num_blocks; b++) {
                     for (int i = 0; i < threshold; i++) {
@@ -638,7 +639,7 @@ double benchmark_vss_commitment_verification(size_t secret_len, int committee_si
                                (share->y[2] << 16) |
                                (share->y[3] << 24);
             
-            if (share_size == 0 || share_size > SHARE_SIZE - 4) {
+            if (share_size == 0 || share_size > SHARE_VALUE_MAX) {
                 verification_success = 0;
                 continue;
             }
@@ -976,6 +977,117 @@ void benchmark_auditor_workflow() {
     printf("结果已保存到: /home/zxx/A2L/A2L-master/ecdsa/bin/fig_test/auditor_benchmark.csv\n");
 }
 
+// 把 stdout 重定向到 /dev/null（per-block 验证每步都打印日志），返回原 fd
+static int silence_stdout(void) {
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    int devnull = open("/dev/null", O_WRONLY);
+    if (devnull >= 0) {
+        dup2(devnull, STDOUT_FILENO);
+        close(devnull);
+    }
+    return saved;
+}
+
+static void restore_stdout(int saved) {
+    fflush(stdout);
+    if (saved >= 0) {
+        dup2(saved, STDOUT_FILENO);
+        close(saved);
+    }
+}
+
+// 对比批量与逐块的 Feldman VSS 验证（库函数，固定 THRESHOLD、SECRET_SHARES）
+// 模拟 Auditor：验证全部参与者、全部块的分片
+void benchmark_vss_batch_verification() {
+    printf("\n========== Feldman VSS 批量验证 vs 逐块验证 ==========\n");
+    printf("VSS消息大小: %d 字节, 参与者: %d, 阈值: %d, 测试次数: %d\n",
+           VSS_MESSAGE_SIZE, SECRET_SHARES, THRESHOLD, BENCHMARK_RUNS);
+    
+    size_t num_blocks = (VSS_MESSAGE_SIZE + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    uint8_t* secret = malloc(VSS_MESSAGE_SIZE);
+    secret_share_t* shares = malloc(num_blocks * SECRET_SHARES * sizeof(secret_share_t));
+    vss_commitment_t* commitment = malloc(sizeof(vss_commitment_t));
+    if (!secret || !shares || !commitment) {
+        free(secret);
+        free(shares);
+        free(commitment);
+        return;
+    }
+    generate_test_data(secret, VSS_MESSAGE_SIZE);
+    
+    // 在计时前准备分片与承诺
+    size_t num_shares = 0;
+    int saved = silence_stdout();
+    int prepared = create_secret_shares(secret, VSS_MESSAGE_SIZE, shares, &num_shares) == 0 &&
+                   create_vss_commitments(secret, VSS_MESSAGE_SIZE, shares, commitment, "batch_benchmark") == 0;
+    restore_stdout(saved);
+    if (!prepared) {
+        printf("错误: 无法生成分片或承诺\n");
+        free(secret);
+        free(shares);
+        free(commitment);
+        return;
+    }
+    printf("分片数: %zu (%zu 块 × %d 参与者)\n", num_shares, num_blocks, SECRET_SHARES);
+    
+    benchmark_stats_t per_block_stats = {0};
+    benchmark_stats_t batch_stats = {0};
+    benchmark_stats_t tampered_stats = {0};
+    
+    for (int run = 0; run < BENCHMARK_RUNS; run++) {
+        double elapsed = 0;
+        int success = 1;
+        
+        saved = silence_stdout();
+        {
+            START_BENCHMARK_TIMER();
+            for (size_t i = 0; i < num_shares; i++) {
+                if (verify_share_with_commitment(&shares[i], commitment) != 0) {
+                    success = 0;
+                }
+            }
+            END_BENCHMARK_TIMER();
+        }
+        restore_stdout(saved);
+        update_stats(&per_block_stats, elapsed, success);
+        
+        {
+            size_t bad_index = 0;
+            START_BENCHMARK_TIMER();
+            success = verify_shares_with_commitment_batch(shares, num_shares, commitment, &bad_index) == 0;
+            END_BENCHMARK_TIMER();
+        }
+        update_stats(&batch_stats, elapsed, success);
+        
+        // 篡改一个分片：批量检查失败后回退逐块定位
+        size_t victim = (size_t)run * 97 % num_shares;
+        shares[victim].y[4] ^= 0x01;
+        saved = silence_stdout();
+        {
+            size_t bad_index = 0;
+            START_BENCHMARK_TIMER();
+            success = verify_shares_with_commitment_batch(shares, num_shares, commitment, &bad_index) != 0 &&
+                      bad_index == victim;
+            END_BENCHMARK_TIMER();
+        }
+        restore_stdout(saved);
+        shares[victim].y[4] ^= 0x01;
+        update_stats(&tampered_stats, elapsed, success);
+    }
+    
+    print_stats("逐块验证", &per_block_stats);
+    print_stats("批量验证", &batch_stats);
+    print_stats("批量验证（含一个错误分片，回退定位）", &tampered_stats);
+    if (batch_stats.success_count > 0 && batch_stats.avg_time > 0) {
+        printf("加速比: %.1fx\n", per_block_stats.avg_time / batch_stats.avg_time);
+    }
+    
+    free(secret);
+    free(shares);
+    free(commitment);
+}
+
 int main() {
     printf("========== Auditor工作流程性能测试工具 ==========\n");
     printf("测试时间: %s\n", ctime(&(time_t){time(NULL)}));
@@ -991,6 +1103,7 @@ int main() {
     ec_param_set_any();
     ep_param_set(SECG_K256);
     
+    benchmark_vss_batch_verification();
     benchmark_auditor_workflow();
     
     core_clean();
@@ -5,6 +5,8 @@
 #include <unistd.h>
 #include <sys/wait.h>
 #include <time.h>
+#include <signal.h>
+#include <pthread.h>
 #include "/home/zxx/Config/relic/include/relic.h"
 #include "pari/pari.h"
 #include "zmq.h"
@@ -14,6 +16,10 @@
 #include "secret_share.h"
 #include "composite_malleable_proof.h"
 #include "http_zk_client.h"
+#include "nullifier_set.h"
+#include "escrow_client.h"
+#include "share_dispatch.h"
+#include "groth16.h"
 
 // IO控制宏
 #define CONDITIONAL_PRINTF(...) do { \
@@ -27,8 +33,15 @@
 static struct timespec tumbler_start_time;
 static int tumbler_timing_initialized = 0;
 
-// 全局退出标志
-static int tumbler_should_exit = 0;
+// 全局退出标志（由 SIGINT/SIGTERM 置位）
+static volatile sig_atomic_t tumbler_should_exit = 0;
+
+// 已使用的 Tornado nullifierHash（所有工作线程共享，查询无锁）
+static nullifier_set_t tumbler_nullifiers = NULL;
+
+// Tornado 提款证明的验证密钥（启动时载入一次，之后只读）；载入失败时拒绝所有证明
+static groth16_vk_st tumbler_groth16_vk;
+static int tumbler_groth16_vk_loaded = 0;
 
 // 辅助函数：将bn_t转换为字符串
 static char* bn_to_string(const bn_t bn) {
@@ -39,57 +52,27 @@ static char* bn_to_string(const bn_t bn) {
 }
 
 // 调用 HTTP 零知识证明服务
+// 分片中的密文分量：[size_t 长度][cl_codec 编码]
+static size_t pack_ct_prefixed_size(const cl_ciphertext_t ct) {
+  return 2 * sizeof(size_t) + cl_codec_size(ct->c1) + cl_codec_size(ct->c2);
+}
+
+static int pack_ct_prefixed(uint8_t *dst, size_t cap, size_t *off, const cl_ciphertext_t ct) {
+  GEN parts[2] = { ct->c1, ct->c2 };
+  for (int i = 0; i < 2; i++) {
+    size_t n = cl_codec_size(parts[i]);
+    if (*off + sizeof(size_t) > cap) return RLC_ERR;
+    memcpy(dst + *off, &n, sizeof(size_t));
+    *off += sizeof(size_t);
+    if (cl_codec_put(dst, cap, off, parts[i]) != RLC_OK) return RLC_ERR;
+  }
+  return RLC_OK;
+}
+
 static int call_http_zk_service(const char* alpha_str, const char* g_alpha_x, const char* g_alpha_y, const char* proof_type) {
-    char curl_command[4096];
-    char response_file[] = "/tmp/zk_response.json";
-    
-    // 构建 curl 命令，添加超时和错误处理
-    snprintf(curl_command, sizeof(curl_command),
-        "curl -s --connect-timeout 5 --max-time 30 -X POST http://localhost:8080/generate-proof "
-        "-H \"Content-Type: application/json\" "
-        "-d '{\"alpha\":\"%s\",\"g_to_the_alpha_x\":\"%s\",\"g_to_the_alpha_y\":\"%s\",\"proof_type\":\"%s\"}' "
-        "-o %s -w \"%%{http_code}\"",
-        alpha_str, g_alpha_x, g_alpha_y, proof_type, response_file);
-    
-    printf("[DEBUG] 执行 curl 命令: %s\n", curl_command);
-    
-    // 执行 curl 命令并捕获 HTTP 状态码
-    FILE* pipe = popen(curl_command, "r");
-    if (pipe == NULL) {
-        printf("[ERROR] 无法执行 curl 命令\n");
-        return -1;
-    }
-    
-    char http_code[10];
-    if (fgets(http_code, sizeof(http_code), pipe) == NULL) {
-        printf("[ERROR] 无法读取 HTTP 状态码\n");
-        pclose(pipe);
-        return -1;
-    }
-    
-    int curl_result = pclose(pipe);
-    int http_status = atoi(http_code);
-    
-    printf("[DEBUG] HTTP 状态码: %d, curl 返回码: %d\n", http_status, curl_result);
-    
-    // 检查响应文件
-    FILE* response = fopen(response_file, "r");
-    if (response != NULL) {
-        char response_content[1024];
-        if (fgets(response_content, sizeof(response_content), response) != NULL) {
-            printf("[DEBUG] 服务响应: %s\n", response_content);
-        }
-        fclose(response);
-        unlink(response_file); // 删除临时文件
-    }
-    
-    if (http_status == 200 && curl_result == 0) {
-        printf("[SUCCESS] %s 零知识证明生成成功\n", proof_type);
-        return 0;
-    } else {
-        printf("[ERROR] %s 零知识证明生成失败 (HTTP: %d, curl: %d)\n", proof_type, http_status, curl_result);
-        return -1;
-    }
+    // 通过共享 HTTP 客户端发送（复用连接，请求与响应都在内存中）
+    http_request_t req = zk_proof_request_start(alpha_str, g_alpha_x, g_alpha_y, proof_type);
+    return zk_proof_request_wait(req, proof_type);
 }
 
 // bob_confirm_done_handler: Bob 在完成 confirmEscrow 后回传 txHash，Tumbler 以 auditor_ctx_alpha_times_beta.c1 作为 msgid 发送自身分片
@@ -233,7 +216,7 @@ int bob_confirm_done_handler(tumbler_state_t state, void *socket, uint8_t *data)
       // 编码为压缩点并转为十六进制字符串用作 msgid
       uint8_t id_bytes[RLC_EC_SIZE_COMPRESSED];
       ec_write_bin(id_bytes, RLC_EC_SIZE_COMPRESSED, id_point, 1);
-      static char msgid_ec_hex[2 * RLC_EC_SIZE_COMPRESSED + 3];
+      static _Thread_local char msgid_ec_hex[2 * RLC_EC_SIZE_COMPRESSED + 3];
       msgid_ec_hex[0] = '0'; msgid_ec_hex[1] = 'x';
       static const char *hexd_ec = "0123456789abcdef";
       for (int i = 0; i < RLC_EC_SIZE_COMPRESSED; i++) {
@@ -272,11 +255,6 @@ int bob_confirm_done_handler(tumbler_state_t state, void *socket, uint8_t *data)
     size_t confirm_len = strlen(bob_confirm_tx) + 1;
     
     // 计算实际需要的总长度（使用长度前缀格式）
-    char *ctx_alpha_c1 = GENtostr(state->ctx_alpha->c1);
-    char *ctx_alpha_c2 = GENtostr(state->ctx_alpha->c2);
-    char *ctx_r0_c1 = GENtostr(state->ctx_r0_auditor->c1);
-    char *ctx_r0_c2 = GENtostr(state->ctx_r0_auditor->c2);
-    
     // 计算 tumbler_escrow_id 和 tumbler_escrow_tx_hash 的长度
     size_t tumbler_escrow_id_len = strlen(state->tumbler_escrow_id) + 1; // 包含 '\0'
     size_t tumbler_escrow_tx_hash_len = strlen(state->tumbler_escrow_tx_hash) + 1; // 包含 '\0'
@@ -287,10 +265,8 @@ int bob_confirm_done_handler(tumbler_state_t state, void *socket, uint8_t *data)
     printf("[TUMBLER][SECRET_SHARE_2] Tumbler ZK证明估计大小: %zu bytes\n", tumbler_zk_size);
     total2 += tumbler_zk_size; // Tumbler综合谜题零知识证明
     total2 += RLC_EC_SIZE_COMPRESSED;        // g^alpha
-    total2 += sizeof(size_t) + strlen(ctx_alpha_c1);  // ctx_alpha c1 长度+数据
-    total2 += sizeof(size_t) + strlen(ctx_alpha_c2);  // ctx_alpha c2 长度+数据
-    total2 += sizeof(size_t) + strlen(ctx_r0_c1);    // auditor_enc(r0) c1 长度+数据
-    total2 += sizeof(size_t) + strlen(ctx_r0_c2);     // auditor_enc(r0) c2 长度+数据
+    total2 += pack_ct_prefixed_size(state->ctx_alpha);       // ctx_alpha c1|c2 长度+数据
+    total2 += pack_ct_prefixed_size(state->ctx_r0_auditor);  // auditor_enc(r0) c1|c2 长度+数据
     total2 += 2 * RLC_BN_SIZE;               // presig r|s (sigma_tr)
     total2 += RLC_EC_SIZE_COMPRESSED;        // presig R (sigma_tr)
     total2 += 2 * RLC_EC_SIZE_COMPRESSED;    // presig pi.a|pi.b (sigma_tr)
@@ -344,24 +320,11 @@ int bob_confirm_done_handler(tumbler_state_t state, void *socket, uint8_t *data)
     ec_write_bin(packed2 + off2, RLC_EC_SIZE_COMPRESSED, state->g_to_the_alpha, 1); off2 += RLC_EC_SIZE_COMPRESSED;
     printf("[TUMBLER][SECRET_SHARE_2] g^alpha 序列化完成，当前offset: %zu\n", off2);
     
-    // ctx_alpha (使用长度前缀格式)
-    {
-      size_t len1 = strlen(ctx_alpha_c1);
-      size_t len2 = strlen(ctx_alpha_c2);
-      memcpy(packed2 + off2, &len1, sizeof(size_t)); off2 += sizeof(size_t);
-      memcpy(packed2 + off2, ctx_alpha_c1, len1); off2 += len1;
-      memcpy(packed2 + off2, &len2, sizeof(size_t)); off2 += sizeof(size_t);
-      memcpy(packed2 + off2, ctx_alpha_c2, len2); off2 += len2;
-    }
-    
-    // auditor_enc(r0) (使用长度前缀格式)
-    {
-      size_t len1 = strlen(ctx_r0_c1);
-      size_t len2 = strlen(ctx_r0_c2);
-      memcpy(packed2 + off2, &len1, sizeof(size_t)); off2 += sizeof(size_t);
-      memcpy(packed2 + off2, ctx_r0_c1, len1); off2 += len1;
-      memcpy(packed2 + off2, &len2, sizeof(size_t)); off2 += sizeof(size_t);
-      memcpy(packed2 + off2, ctx_r0_c2, len2); off2 += len2;
+    // ctx_alpha 与 auditor_enc(r0) (使用长度前缀格式)
+    if (pack_ct_prefixed(packed2, total2, &off2, state->ctx_alpha) != RLC_OK
+        || pack_ct_prefixed(packed2, total2, &off2, state->ctx_r0_auditor) != RLC_OK) {
+      free(packed2);
+      RLC_THROW(ERR_CAUGHT);
     }
     // 预签 (sigma_tr) - 完整结构：r|s|R|pi.a|pi.b|pi.z
     printf("[TUMBLER-2][PACK] 打包Tumbler完整预签名结构:\n");
@@ -433,6 +396,9 @@ int bob_confirm_done_handler(tumbler_state_t state, void *socket, uint8_t *data)
     
     // 计算需要的分享数组大小（num_blocks * SECRET_SHARES）
     size_t num_blocks = (off2 + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    // 混合模式（A2L_SHARE_MODE=hybrid）只分享对称密钥，载荷加密后随分片发送
+    int hybrid2 = share_mode_hybrid();
+    if (hybrid2 && num_blocks < SHARE_KEY_BLOCKS) num_blocks = SHARE_KEY_BLOCKS;
     size_t max_shares = num_blocks * SECRET_SHARES;
     secret_share_t* shares2 = (secret_share_t*)malloc(sizeof(secret_share_t) * max_shares);
     if (shares2 == NULL) {
@@ -484,14 +450,18 @@ int bob_confirm_done_handler(tumbler_state_t state, void *socket, uint8_t *data)
     }
     
     size_t num_shares2 = 0;
-    int ss2 = create_secret_shares(packed2, off2, shares2, &num_shares2);
+    uint8_t* envelope2 = NULL;
+    size_t envelope2_len = 0;
+    vss_commitment_t commitment2;
+    int ss2 = hybrid2
+      ? create_hybrid_shares(packed2, off2, msgid, shares2, &num_shares2, &commitment2, &envelope2, &envelope2_len)
+      : create_secret_shares(packed2, off2, shares2, &num_shares2);
     if (ss2 != 0) {
       printf("[SecretShare][Tumbler-2] create_secret_shares failed=%d\n", ss2);
       free(shares2);
     } else {
       printf("[SecretShare][Tumbler-2] Created %zu shares\n", num_shares2);
-      // ===== VSS: 创建并发送承诺给 Auditor =====
-      vss_commitment_t commitment2;
+      // ===== VSS: 创建并发送承诺给 Auditor（混合模式下承诺已随密钥分享创建） =====
       printf("[VSS][Tumbler-2] DEBUG: msgid = '%s' (length: %zu)\n", msgid, strlen(msgid));
       
       // 检查msgid长度是否过长
@@ -508,7 +478,7 @@ int bob_confirm_done_handler(tumbler_state_t state, void *socket, uint8_t *data)
       commitment2.msgid[MSG_ID_MAXLEN - 1] = '\0';
       
       printf("[VSS][Tumbler-2] 开始创建VSS承诺\n");
-      if (create_vss_commitments(packed2, off2, shares2, &commitment2, msgid) == 0) {
+      if (hybrid2 || create_vss_commitments(packed2, off2, shares2, &commitment2, msgid) == 0) {
         printf("[VSS][Tumbler-2] Created VSS commitments for second share\n");
         if (save_vss_commitment_to_file(&commitment2) == 0) {
           printf("[VSS][Tumbler-2] Successfully saved VSS commitment to file\n");
@@ -536,17 +506,18 @@ int bob_confirm_done_handler(tumbler_state_t state, void *socket, uint8_t *data)
         endpoint_ptrs2[i] = RECEIVER_ENDPOINTS[i];
       }
       
-      if (send_shares_to_receivers(shares2, num_shares2, msgid, endpoint_ptrs2) != 0) {
+      int sent2 = hybrid2
+        ? send_hybrid_shares_to_receivers(shares2, num_shares2, envelope2, envelope2_len, msgid, endpoint_ptrs2)
+        : send_shares_to_receivers(shares2, num_shares2, msgid, endpoint_ptrs2);
+      if (sent2 != 0) {
         printf("[SecretShare][Tumbler-2] send_shares_to_receivers encountered warnings\n");
       } else {
         printf("[SecretShare][Tumbler-2] Shares sent using msgid(tag_plain) after Bob confirm\n");
       }
       printf("[VSS][Tumbler-2] 分片发送完成\n");
+      free(envelope2);
       free(shares2);
-      
-      // 设置退出标志，程序将在发送完分片后退出
-      tumbler_should_exit = 1;
-      printf("[TUMBLER] 设置退出标志，程序将在处理完当前消息后退出\n");
+      // 本会话到此结束，工作线程随后只回收该会话的状态，其它会话继续运行
     }
     END_TIMER(tumbler_secret_share_phase2)
     free(packed2);
@@ -605,30 +576,8 @@ int bob_confirm_done_handler(tumbler_state_t state, void *socket, uint8_t *data)
 
 // 在 registration_handler 函数之前添加
 static int open_escrow_sync_for_tumbler(tumbler_state_t state, const char *escrow_id) {
-    const char *truffle_project = "/home/zxx/Config/truffleProject/truffletest";
-    
     // 设置参与方地址（Tumbler 作为 party1，Bob 作为 party2）
-    const char *p1 = "0x9483ba82278fd651ed64d5b2cc2d4d2bbfa94025";  // Tumbler 地址
-    const char *p2 = state->bob_address;  // 使用存储的Bob地址
-    
-    // 设置截止时间
-    long deadline = (long)time(NULL) + 3600; // 1小时后过期
-    
-    // 使用 meta 字段存储 Tumbler 的标识
-    char meta_hash[67];
-    time_t now = time(NULL);
-    snprintf(meta_hash, sizeof(meta_hash), "0x%lx%08x", (unsigned long)now, (unsigned int)rand());
-    
-    // 获取 Tumbler 的账户地址
-    const char *tumbler_from = "0x9483ba82278fd651ed64d5b2cc2d4d2bbfa94025";
-    
-    // 生成未压缩公钥（0x04||X||Y）并转为十六进制字符串
-    // 从结构体中读取 tumbler_ec_pk 和 bob_ec_pk 的公钥点（通过 ->pk 字段访问）
-    uint8_t tumbler_pk_bytes[RLC_EC_SIZE_COMPRESSED * 2];
-    uint8_t bob_pk_bytes[RLC_EC_SIZE_COMPRESSED * 2];
-    char tumbler_pk_hex[(RLC_EC_SIZE_COMPRESSED * 2) * 2 + 1];
-    char bob_pk_hex[(RLC_EC_SIZE_COMPRESSED * 2) * 2 + 1];
-    size_t i_pk;
+    const char *tumbler_from = "0x9483ba82278fd651ed64d5b2cc2d4d2bbfa94025";  // Tumbler 地址
     
     // 检查公钥是否已初始化
     if (state->tumbler_ec_pk == NULL || state->bob_ec_pk == NULL) {
@@ -637,92 +586,52 @@ static int open_escrow_sync_for_tumbler(tumbler_state_t state, const char *escro
       return -1;
     }
     
-    ec_write_bin(tumbler_pk_bytes, RLC_EC_SIZE_COMPRESSED * 2, state->tumbler_ec_pk->pk, 0);
-    ec_write_bin(bob_pk_bytes, RLC_EC_SIZE_COMPRESSED * 2, state->bob_ec_pk->pk, 0);
-    // 生成纯十六进制字符串，不加 "0x" 前缀（JS 脚本会统一处理前缀）
-    for (i_pk = 0; i_pk < (size_t)(RLC_EC_SIZE_COMPRESSED * 2); i_pk++) {
-      sprintf(tumbler_pk_hex + 2*i_pk, "%02x", tumbler_pk_bytes[i_pk]);
-      sprintf(bob_pk_hex + 2*i_pk, "%02x", bob_pk_bytes[i_pk]);
-    }
-    tumbler_pk_hex[(RLC_EC_SIZE_COMPRESSED * 2) * 2] = '\0';
-    bob_pk_hex[(RLC_EC_SIZE_COMPRESSED * 2) * 2] = '\0';
-    
-    // 验证公钥字符串不为空
-    if (strlen(tumbler_pk_hex) == 0 || strlen(bob_pk_hex) == 0) {
-      fprintf(stderr, "[ESCROW] ERROR: Failed to generate public key hex strings! tumbler_len=%zu, bob_len=%zu\n",
-              strlen(tumbler_pk_hex), strlen(bob_pk_hex));
-      return -1;
-    }
-    
-    // 打印输出两个公钥（打印时加上前缀以便阅读）
-    printf("[ESCROW] Tumbler公钥 (未压缩): 0x%s (length: %zu)\n", tumbler_pk_hex, strlen(tumbler_pk_hex));
-    printf("[ESCROW] Bob公钥 (未压缩): 0x%s (length: %zu)\n", bob_pk_hex, strlen(bob_pk_hex));
-    
-    // 构建命令（固定面额池脚本，按 pool_label 自动选择合约与面额）
-    char *cmd = malloc(4096);
-    if (!cmd) return -1;
-    
-    // 修改命令：添加 --p1key 和 --p2key 参数，移除 --benef 和 --refund
-    int cmd_len = snprintf(cmd, 4096,
-                           "cd %s && npx truffle exec scripts/openEscrow_fixed.js --network private "
-                           "--pool %s --id %s --p1 %s --p2 %s --deadline %ld --meta %s --from %s --p1key %s --p2key %s 2>&1",
-                           truffle_project, state->pool_label, escrow_id, p1, p2, deadline, meta_hash, tumbler_from, tumbler_pk_hex, bob_pk_hex);
-    
-    if (cmd_len >= 4096) {
-      fprintf(stderr, "[ESCROW] WARNING: Command string was truncated! Required length: %d\n", cmd_len);
-    }
+    // 使用 meta 字段存储 Tumbler 的标识
+    char meta_hash[67];
+    time_t now = time(NULL);
+    snprintf(meta_hash, sizeof(meta_hash), "0x%lx%08x", (unsigned long)now, (unsigned int)rand());
     
-    printf("[ESCROW] Tumbler openEscrow sync cmd (length: %d): %s\n", cmd_len, cmd);
-    printf("[ESCROW] Debug - p1key value: %s (len: %zu)\n", tumbler_pk_hex, strlen(tumbler_pk_hex));
-    printf("[ESCROW] Debug - p2key value: %s (len: %zu)\n", bob_pk_hex, strlen(bob_pk_hex));
+    // Tumbler 一侧没有 Tornado commitment；openEscrow 要求 commitment，此时调用会失败并使用占位 txHash
+    escrow_open_args_t args;
+    memset(&args, 0, sizeof(args));
+    args.pool_label = state->pool_label;
+    args.escrow_id = escrow_id;
+    args.party1 = tumbler_from;
+    args.party2 = state->bob_address;  // 使用存储的Bob地址
+    args.deadline = (long)time(NULL) + 3600; // 1小时后过期
+    args.meta_hash = meta_hash;
+    args.commitment = NULL;
+    ec_write_bin(args.party1_key, ESCROW_PUBKEY_LEN, state->tumbler_ec_pk->pk, 0);
+    ec_write_bin(args.party2_key, ESCROW_PUBKEY_LEN, state->bob_ec_pk->pk, 0);
+    
+    char tumbler_pk_hex[2 * ESCROW_PUBKEY_LEN + 1];
+    char bob_pk_hex[2 * ESCROW_PUBKEY_LEN + 1];
+    for (size_t i_pk = 0; i_pk < ESCROW_PUBKEY_LEN; i_pk++) {
+      sprintf(tumbler_pk_hex + 2*i_pk, "%02x", args.party1_key[i_pk]);
+      sprintf(bob_pk_hex + 2*i_pk, "%02x", args.party2_key[i_pk]);
+    }
+    printf("[ESCROW] Tumbler公钥 (未压缩): 0x%s\n", tumbler_pk_hex);
+    printf("[ESCROW] Bob公钥 (未压缩): 0x%s\n", bob_pk_hex);
+    printf("[ESCROW] Tumbler openEscrow: pool=%s id=%s p2=%s\n", state->pool_label, escrow_id, state->bob_address);
 
-    // 执行命令并捕获输出，以解析 txHash
     START_TIMER(tumbler_blockchain_escrow_interaction)
-    FILE *fp = popen(cmd, "r");
-    if (!fp) {
-      fprintf(stderr, "[ESCROW] Failed to execute openEscrow command\n");
-      free(cmd);
-      return -1;
-    }
-    char buffer[1024];
-    char tx_hash[67] = {0};
-    while (fgets(buffer, sizeof(buffer), fp) != NULL) {
-      printf("[ESCROW] Output: %s", buffer);
-      if (strstr(buffer, "\"txHash\"") != NULL || strstr(buffer, "Transaction hash:") != NULL) {
-        char *hash_start = strstr(buffer, "0x");
-        if (hash_start) {
-          // 尝试截取 0x+64
-          strncpy(tx_hash, hash_start, 66);
-          tx_hash[66] = '\0';
-          printf("[ESCROW] Captured Tumbler txHash: %s\n", tx_hash);
-          break;
-        }
-      }
-    }
-    int rc = pclose(fp);
-    
-    free(cmd);
+    escrow_client_t client = escrow_client_shared();
+    char tx_hash[ESCROW_HASH_STR_LEN] = {0};
+    const int rc = (client != NULL
+                    && escrow_open(client, &args, tumbler_from, state->tumbler_ec_sk->sk, tx_hash) == RLC_OK) ? 0 : -1;
 
-    if (strlen(tx_hash) > 0) {
+    if (rc == 0) {
       memset(state->tumbler_escrow_tx_hash, 0, sizeof(state->tumbler_escrow_tx_hash));
       strncpy(state->tumbler_escrow_tx_hash, tx_hash, sizeof(state->tumbler_escrow_tx_hash) - 1);
       state->tumbler_escrow_tx_hash[sizeof(state->tumbler_escrow_tx_hash) - 1] = '\0';
       printf("[ESCROW] Stored Tumbler escrow txHash: %s\n", state->tumbler_escrow_tx_hash);
 
       // 将交易哈希作为 dataHash 写入合约（bytes32），便于后续签名校验使用
-      {
-        const char *from_addr = "0x9483ba82278fd651ed64d5b2cc2d4d2bbfa94025"; // Tumbler 地址
-        char cmd_set[4096];
-        snprintf(cmd_set, sizeof(cmd_set),
-                 "cd %s && npx truffle exec scripts/setDataHash.js --network private --pool %s --id %s --hash %s --from %s 2>&1",
-                 truffle_project, state->pool_label, escrow_id, state->tumbler_escrow_tx_hash, from_addr);
-        printf("[ESCROW] Tumbler setDataHash cmd: %s\n", cmd_set);
-        int rc_set = system(cmd_set);
-        if (rc_set == 0) {
-          printf("[ESCROW] Wrote dataHash (txHash) to escrow successfully.\n");
-        } else {
-          printf("[ESCROW] Failed to write dataHash to escrow, rc=%d.\n", rc_set);
-        }
+      if (escrow_set_data_hash(client, state->pool_label, escrow_id, state->tumbler_escrow_tx_hash,
+                               tumbler_from, state->tumbler_ec_sk->sk, NULL) == RLC_OK) {
+        printf("[ESCROW] Wrote dataHash (txHash) to escrow successfully.\n");
+      } else {
+        printf("[ESCROW] Failed to write dataHash to escrow.\n");
       }
     } else {
       // 未捕获到时写入占位，避免后续序列化空指针
@@ -852,45 +761,21 @@ static int release_escrow_for_alice(tumbler_state_t state, const char *escrow_id
   printf("[ESCROW DEBUG] Tumbler signature r (first 20 chars): %.20s\n", tumbler_r_hex);
   printf("[ESCROW DEBUG] Tumbler signature s (first 20 chars): %.20s\n", tumbler_s_hex);
   
-  bn_free(tumbler_r);
-  bn_free(tumbler_s);
-  
-  // 构建命令调用 confirm 函数，传递签名参数
-  char *cmd = malloc(8192);
-  if (!cmd) return -1;
-  
-  // 使用 --pool 参数，让脚本从地址簿解析固定面额池合约地址
-  // 传递两个签名：Alice 的签名 (r1, s1, v1) 和 Tumbler 的签名 (r2, s2, v2)
-  // 注意：v 值需要在 JS 脚本中计算，这里先传 0 或占位值
-  printf("[ESCROW DEBUG] Building command with:\n");
-  printf("  pool_label: %s\n", state->pool_label);
-  printf("  escrow_id: %s\n", escrow_id);
-  printf("  alice_r_hex length: %zu\n", strlen(alice_r_hex));
-  printf("  alice_s_hex length: %zu\n", strlen(alice_s_hex));
-  printf("  tumbler_r_hex length: %zu\n", strlen(tumbler_r_hex));
-  printf("  tumbler_s_hex length: %zu\n", strlen(tumbler_s_hex));
-  
-  int cmd_len = snprintf(cmd, 8192,
-           "cd /home/zxx/Config/truffleProject/truffletest && npx truffle exec scripts/confirmEscrow.js --network private "
-           "--pool %s --id %s --from %s "
-           "--r1 0x%s --s1 0x%s --v1 0 "
-           "--r2 0x%s --s2 0x%s --v2 0 2>&1 | cat",
-           state->pool_label, escrow_id, tumbler_from,
-           alice_r_hex, alice_s_hex,
-           tumbler_r_hex, tumbler_s_hex);
-  
-  printf("[ESCROW DEBUG] Command length: %d (max 8192)\n", cmd_len);
-  printf("[ESCROW] Tumbler confirm escrow cmd: %s\n", cmd);
-  
+  // 直接经 JSON-RPC 调用 confirm；v 值由客户端根据链上记录的双方公钥在本地恢复
+  printf("[ESCROW] confirm: pool=%s id=%s from=%s\n", state->pool_label, escrow_id, tumbler_from);
   START_TIMER(tumbler_blockchain_escrow_interaction)
-  int rc = system(cmd);
+  escrow_client_t client = escrow_client_shared();
+  const int rc = (client != NULL
+                  && escrow_confirm(client, state->pool_label, escrow_id, state->sigma_s->r, state->sigma_s->s,
+                                    tumbler_r, tumbler_s, tumbler_from, state->tumbler_ec_sk->sk, NULL) == RLC_OK) ? 0 : -1;
   END_TIMER(tumbler_blockchain_escrow_interaction)
-  free(cmd);
+  bn_free(tumbler_r);
+  bn_free(tumbler_s);
   
   if (rc == 0) {
       printf("[ESCROW] Tumbler confirmed escrow successfully\n");
   } else {
-      fprintf(stderr, "[ESCROW] Tumbler confirm escrow failed with code %d.\n", rc);
+      fprintf(stderr, "[ESCROW] Tumbler confirm escrow failed.\n");
   }
   
   return rc;
@@ -930,7 +815,7 @@ msg_handler_t get_message_handler(char *key) {
 
     default:
       fprintf(stderr, "Error: invalid message type.\n");
-      exit(1);
+      return NULL;
   }
 }
 
@@ -957,7 +842,7 @@ int handle_message(tumbler_state_t state, void *socket, zmq_msg_t message) {
     }
     
     msg_handler_t msg_handler = get_message_handler(msg->type);
-    if (msg_handler(state, socket, msg->data) != RLC_OK) {
+    if (msg_handler == NULL || msg_handler(state, socket, msg->data) != RLC_OK) {
       RLC_THROW(ERR_CAUGHT);
     }
     printf("Finished executing %s.\n\n", msg->type);
@@ -1006,6 +891,484 @@ int receive_message(tumbler_state_t state, void *socket) {
   return result_status;
 }
 
+// ===================== 多会话服务：ROUTER 前端 + 工作线程池 =====================
+//
+// 前端 ROUTER socket 接收 [identity][empty][session_id][message]（旧客户端没有 session_id 帧），
+// broker 按 hash(session_id) 把消息分派给固定的工作线程（会话亲和，会话表无需加锁）。
+// 工作线程与 broker 之间是 inproc PAIR 管道，工作线程发回三条消息：
+//   ["H"][identity]  —— 开始处理某个请求
+//   [reply]          —— handler 自己发送的单帧应答（原样转发给客户端）
+//   ["E"][status]    —— 处理结束；若 handler 未应答，broker 代发 "error" 消息，避免 REQ 客户端挂起
+//
+// 未启用多线程（TIGER_MT_ENABLED，见 util.h）时只启动一个工作线程，所有会话串行处理。
+
+typedef struct {
+  int index;
+  pthread_t thread;
+  char endpoint[64];
+  void *pipe;                 // 工作线程端 PAIR socket
+  void *broker_pipe;          // broker 端 PAIR socket
+  tumbler_state_t tmpl;       // 只读模板：长期密钥与 CL 参数
+  tumbler_session_t sessions; // 该线程负责的会话
+  size_t session_count;
+  // broker 侧的应答跟踪
+  uint8_t identity[256];
+  size_t identity_len;
+  int has_pending;
+  int replied;
+#if TIGER_MT_ENABLED
+  struct pari_thread pari_thread;
+#endif
+} tumbler_worker_t;
+
+static void tumbler_signal_handler(int sig) {
+  (void) sig;
+  tumbler_should_exit = 1;
+}
+
+// 为新会话创建状态：长期密钥从模板复制（GEN 只读共享），其余字段留给各 handler 填充
+static tumbler_state_t tumbler_session_state_new(const tumbler_state_t tmpl) {
+  // 在 RLC_TRY 中赋值、在 RLC_CATCH 中使用，必须是 volatile
+  tumbler_state_t volatile state;
+  tumbler_state_null(state);
+
+  RLC_TRY {
+    tumbler_state_new(state);
+
+    bn_copy(state->tumbler_ec_sk->sk, tmpl->tumbler_ec_sk->sk);
+    ec_copy(state->tumbler_ec_pk->pk, tmpl->tumbler_ec_pk->pk);
+    ec_copy(state->alice_ec_pk->pk, tmpl->alice_ec_pk->pk);
+    ec_copy(state->bob_ec_pk->pk, tmpl->bob_ec_pk->pk);
+    g1_copy(state->tumbler_ps_sk->X_1, tmpl->tumbler_ps_sk->X_1);
+    g1_copy(state->tumbler_ps_pk->Y_1, tmpl->tumbler_ps_pk->Y_1);
+    g2_copy(state->tumbler_ps_pk->X_2, tmpl->tumbler_ps_pk->X_2);
+    g2_copy(state->tumbler_ps_pk->Y_2, tmpl->tumbler_ps_pk->Y_2);
+    state->tumbler_cl_sk->sk = tmpl->tumbler_cl_sk->sk;
+    state->tumbler_cl_pk->pk = tmpl->tumbler_cl_pk->pk;
+    state->auditor_cl_pk->pk = tmpl->auditor_cl_pk->pk;
+    state->auditor2_cl_pk->pk = tmpl->auditor2_cl_pk->pk;
+    *state->cl_params = *tmpl->cl_params;  // g_q_table 为只读共享
+
+    state->alice_escrow_id[0] = '\0';
+    state->current_bob_escrow_id[0] = '\0';
+    state->tumbler_escrow_id[0] = '\0';
+    state->bob_address[0] = '\0';
+    state->pool_label[0] = '\0';
+    state->alice_escrow_tx_hash[0] = '\0';
+    state->tumbler_escrow_tx_hash[0] = '\0';
+    state->tornado_proof_data[0] = '\0';
+  } RLC_CATCH_ANY {
+    if (state != NULL) tumbler_state_free(state);
+  }
+
+  return state;
+}
+
+// 把 handler 写入会话状态、需要留到下一条消息的 GEN 复制到堆上，之后工作线程可回收本请求的 PARI 栈。
+// 新增保存 GEN 的会话字段时必须加入这里，否则请求结束后该字段悬空。
+static void tumbler_state_persist(tumbler_state_t state) {
+  zk_proof_cldl_st *alpha_enc = &state->comprehensive_puzzle_zk_proof->alpha_enc_proof;
+  zk_proof_cldl_st *r0_enc = &state->comprehensive_puzzle_zk_proof->r0_enc_proof;
+  zk_proof_cldl_t tumbler_proof = state->alice_puzzle_relation_zk_proof->tumbler_proof;
+  zk_proof_cldl_t auditor_proof = state->alice_puzzle_relation_zk_proof->auditor_proof;
+
+  GEN *const slots[] = {
+    &state->ctx_alpha->c1, &state->ctx_alpha->c2, &state->ctx_alpha->r,
+    &state->ctx_r0_auditor->c1, &state->ctx_r0_auditor->c2, &state->ctx_r0_auditor->r,
+    &state->pi0_cl->T1, &state->pi0_cl->T3, &state->pi0_cl->z_m,
+    &state->auditor_ctx_alpha_times_beta->c1, &state->auditor_ctx_alpha_times_beta->c2,
+    &state->auditor_ctx_alpha_times_beta->r,
+    &alpha_enc->t1, &alpha_enc->t3, &alpha_enc->u1, &alpha_enc->u2,
+    &r0_enc->t1, &r0_enc->t3, &r0_enc->u1, &r0_enc->u2,
+    &tumbler_proof->t1, &tumbler_proof->t3, &tumbler_proof->u1, &tumbler_proof->u2,
+    &auditor_proof->t1, &auditor_proof->t3, &auditor_proof->u1, &auditor_proof->u2,
+    &state->alice_ctx_alpha_times_beta->c1, &state->alice_ctx_alpha_times_beta->c2,
+    &state->alice_ctx_alpha_times_beta->r,
+    &state->alice_auditor_ctx_alpha_times_beta->c1, &state->alice_auditor_ctx_alpha_times_beta->c2,
+    &state->alice_auditor_ctx_alpha_times_beta->r,
+  };
+  pari_arena_persist(&state->pari_store, slots, sizeof(slots) / sizeof(slots[0]));
+}
+
+static void tumbler_session_free(tumbler_session_t session) {
+  if (session->state != NULL) {
+    // 固定基表借用自模板状态，不随会话释放
+    session->state->cl_params->g_q_table = NULL;
+    tumbler_state_free(session->state);
+  }
+  free(session);
+}
+
+// 查找（必要时创建）会话，并顺带回收空闲超时的会话
+static tumbler_state_t tumbler_worker_session(tumbler_worker_t *worker, const char *id) {
+  time_t now = time(NULL);
+  tumbler_session_t found = NULL;
+  tumbler_session_t *link = &worker->sessions;
+
+  while (*link != NULL) {
+    tumbler_session_t session = *link;
+    if (strcmp(session->id, id) == 0) {
+      found = session;
+      link = &session->next;
+    } else if (now - session->last_active > TUMBLER_SESSION_IDLE_TIMEOUT) {
+      printf("[TUMBLER][W%d] 会话 %s 空闲超时，回收\n", worker->index, session->id);
+      *link = session->next;
+      tumbler_session_free(session);
+      worker->session_count--;
+    } else {
+      link = &session->next;
+    }
+  }
+
+  if (found == NULL) {
+    found = calloc(1, sizeof(tumbler_session_st));
+    if (found == NULL) {
+      return NULL;
+    }
+    found->state = tumbler_session_state_new(worker->tmpl);
+    if (found->state == NULL) {
+      free(found);
+      return NULL;
+    }
+    strncpy(found->id, id, sizeof(found->id) - 1);
+    found->next = worker->sessions;
+    worker->sessions = found;
+    worker->session_count++;
+    printf("[TUMBLER][W%d] 新建会话 %s（当前 %zu 个）\n", worker->index, id, worker->session_count);
+  }
+
+  found->last_active = now;
+  return found->state;
+}
+
+static void tumbler_worker_session_close(tumbler_worker_t *worker, const char *id) {
+  for (tumbler_session_t *link = &worker->sessions; *link != NULL; link = &(*link)->next) {
+    tumbler_session_t session = *link;
+    if (strcmp(session->id, id) == 0) {
+      *link = session->next;
+      tumbler_session_free(session);
+      worker->session_count--;
+      printf("[TUMBLER][W%d] 会话 %s 完成，释放（剩余 %zu 个）\n", worker->index, id, worker->session_count);
+      return;
+    }
+  }
+}
+
+// 从序列化消息中取出类型字符串（不做完整反序列化）
+static const char *tumbler_peek_message_type(zmq_msg_t *message) {
+  size_t size = zmq_msg_size(message);
+  const uint8_t *data = zmq_msg_data(message);
+  unsigned type_length;
+
+  if (size <= sizeof(unsigned)) {
+    return NULL;
+  }
+  memcpy(&type_length, data, sizeof(unsigned));
+  if (type_length == 0 || type_length > size - sizeof(unsigned)
+      || data[sizeof(unsigned) + type_length - 1] != '\0') {
+    return NULL;
+  }
+  return (const char *) (data + sizeof(unsigned));
+}
+
+static void *tumbler_worker_main(void *arg) {
+  tumbler_worker_t *worker = (tumbler_worker_t *) arg;
+
+#if TIGER_MT_ENABLED
+  // 每个线程独立的 PARI 栈与 RELIC 上下文
+  pari_thread_start(&worker->pari_thread);
+  core_init();
+  pc_param_set_any();
+  ec_param_set_any();
+  ep_param_set(SECG_K256);
+  {
+    uint8_t seed[sizeof(ulong)];
+    ulong s;
+    rand_bytes(seed, sizeof(seed));
+    memcpy(&s, seed, sizeof(s));
+    setrand(utoi(s));
+  }
+#else
+  // 单工作线程：沿用主线程的 PARI 栈，只需重置 C 栈检查基址
+  int stack_base;
+  pari_stackcheck_init(&stack_base);
+#endif
+
+  printf("[TUMBLER][W%d] 工作线程启动\n", worker->index);
+
+  while (1) {
+    zmq_msg_t identity, session, payload;
+    char session_id[MIX_SESSION_ID_SIZE];
+    uint8_t status;
+
+    zmq_msg_init(&identity);
+    zmq_msg_init(&session);
+    zmq_msg_init(&payload);
+
+    if (zmq_msg_recv(&identity, worker->pipe, 0) == -1
+        || zmq_msg_recv(&session, worker->pipe, 0) == -1
+        || zmq_msg_recv(&payload, worker->pipe, 0) == -1) {
+      zmq_msg_close(&identity);
+      zmq_msg_close(&session);
+      zmq_msg_close(&payload);
+      break; // ETERM：上下文关闭
+    }
+
+    size_t id_len = zmq_msg_size(&session);
+    memcpy(session_id, zmq_msg_data(&session), id_len);
+    session_id[id_len] = '\0';
+
+    zmq_send(worker->pipe, "H", 1, ZMQ_SNDMORE);
+    zmq_send(worker->pipe, zmq_msg_data(&identity), zmq_msg_size(&identity), 0);
+
+    const char *type = tumbler_peek_message_type(&payload);
+    int done = (type != NULL && strcmp(type, "bob_confirm_done") == 0);
+
+    // 每个请求一个 PARI 栈区间：结束时只保留会话状态中的 GEN
+    pari_sp av = avma;
+    tumbler_state_t state = tumbler_worker_session(worker, session_id);
+    if (state == NULL) {
+      fprintf(stderr, "[TUMBLER][W%d] 无法为会话 %s 分配状态\n", worker->index, session_id);
+      status = 1;
+    } else {
+      status = (handle_message(state, worker->pipe, payload) == RLC_OK) ? 0 : 1;
+    }
+
+    if (done && status == 0) {
+      tumbler_worker_session_close(worker, session_id);
+    } else if (state != NULL) {
+      tumbler_state_persist(state);
+    }
+    set_avma(av);
+
+    zmq_send(worker->pipe, "E", 1, ZMQ_SNDMORE);
+    zmq_send(worker->pipe, &status, 1, 0);
+
+    zmq_msg_close(&identity);
+    zmq_msg_close(&session);
+    zmq_msg_close(&payload);
+  }
+
+  while (worker->sessions != NULL) {
+    tumbler_session_t next = worker->sessions->next;
+    tumbler_session_free(worker->sessions);
+    worker->sessions = next;
+  }
+  zmq_close(worker->pipe);
+
+#if TIGER_MT_ENABLED
+  core_clean();
+  pari_thread_close();
+#endif
+  return NULL;
+}
+
+// 代理线程不进入 RELIC：未以 MULTI 编译时 RELIC 的核心上下文（含 RLC_TRY 的 longjmp 状态）是全局的，
+// 工作线程可能正在使用。error 应答固定为 [type_len]["error\0"][data_len = 0]，
+// 与 serialize_message 的格式相同，直接在栈上拼出
+static void tumbler_broker_send_error(void *frontend, const uint8_t *identity, size_t identity_len) {
+  static const char msg_type[] = "error";
+  const unsigned msg_type_length = sizeof(msg_type);
+  const unsigned msg_data_length = 0;
+  uint8_t frame[sizeof(msg_type) + 2 * sizeof(unsigned)];
+
+  memcpy(frame, &msg_type_length, sizeof(unsigned));
+  memcpy(frame + sizeof(unsigned), msg_type, msg_type_length);
+  memcpy(frame + sizeof(unsigned) + msg_type_length, &msg_data_length, sizeof(unsigned));
+
+  zmq_send(frontend, identity, identity_len, ZMQ_SNDMORE);
+  zmq_send(frontend, "", 0, ZMQ_SNDMORE);
+  zmq_send(frontend, frame, sizeof(frame), 0);
+}
+
+static size_t tumbler_session_worker(const char *id, size_t len, size_t n_workers) {
+  // FNV-1a
+  uint64_t h = 1469598103934665603ULL;
+  for (size_t i = 0; i < len; i++) {
+    h ^= (uint8_t) id[i];
+    h *= 1099511628211ULL;
+  }
+  return (size_t) (h % n_workers);
+}
+
+// 前端 -> 工作线程：[identity][empty][session_id]?[message] => [identity][session_id][message]
+static void tumbler_broker_dispatch(void *frontend, tumbler_worker_t *workers, size_t n_workers) {
+  zmq_msg_t frames[4];
+  size_t count = 0;
+  int more = 1;
+
+  while (more) {
+    zmq_msg_t frame;
+    zmq_msg_init(&frame);
+    if (zmq_msg_recv(&frame, frontend, 0) == -1) {
+      zmq_msg_close(&frame);
+      break;
+    }
+    more = zmq_msg_more(&frame);
+    if (count < 4) {
+      frames[count++] = frame;
+    } else {
+      zmq_msg_close(&frame);
+      count = 5;
+    }
+  }
+
+  if (count < 3 || count > 4 || zmq_msg_size(&frames[1]) != 0
+      || (count == 4 && (zmq_msg_size(&frames[2]) == 0
+                         || zmq_msg_size(&frames[2]) >= MIX_SESSION_ID_SIZE))) {
+    fprintf(stderr, "[TUMBLER] 丢弃格式错误的请求（%zu 帧）\n", count);
+    if (count >= 1 && count <= 4) {
+      tumbler_broker_send_error(frontend, zmq_msg_data(&frames[0]), zmq_msg_size(&frames[0]));
+    }
+    for (size_t i = 0; i < count && i < 4; i++) zmq_msg_close(&frames[i]);
+    return;
+  }
+
+  const char *session_id = MIX_SESSION_DEFAULT_ID;
+  size_t session_len = strlen(MIX_SESSION_DEFAULT_ID);
+  if (count == 4) {
+    session_id = zmq_msg_data(&frames[2]);
+    session_len = zmq_msg_size(&frames[2]);
+  }
+
+  tumbler_worker_t *worker = &workers[tumbler_session_worker(session_id, session_len, n_workers)];
+  zmq_msg_send(&frames[0], worker->broker_pipe, ZMQ_SNDMORE);
+  zmq_send(worker->broker_pipe, session_id, session_len, ZMQ_SNDMORE);
+  zmq_msg_send(&frames[count - 1], worker->broker_pipe, 0);
+
+  for (size_t i = 0; i < count; i++) zmq_msg_close(&frames[i]);
+}
+
+// 工作线程 -> 前端：转发 handler 的应答，处理控制消息
+static void tumbler_broker_collect(void *frontend, tumbler_worker_t *worker) {
+  zmq_msg_t first;
+  zmq_msg_init(&first);
+  if (zmq_msg_recv(&first, worker->broker_pipe, 0) == -1) {
+    zmq_msg_close(&first);
+    return;
+  }
+
+  if (zmq_msg_more(&first)) {
+    zmq_msg_t second;
+    zmq_msg_init(&second);
+    zmq_msg_recv(&second, worker->broker_pipe, 0);
+    const char tag = zmq_msg_size(&first) > 0 ? *(char *) zmq_msg_data(&first) : '\0';
+    if (tag == 'H') {
+      worker->identity_len = zmq_msg_size(&second);
+      if (worker->identity_len > sizeof(worker->identity)) {
+        worker->identity_len = sizeof(worker->identity);
+      }
+      memcpy(worker->identity, zmq_msg_data(&second), worker->identity_len);
+      worker->has_pending = 1;
+      worker->replied = 0;
+    } else if (tag == 'E') {
+      if (worker->has_pending && !worker->replied) {
+        tumbler_broker_send_error(frontend, worker->identity, worker->identity_len);
+      }
+      worker->has_pending = 0;
+    }
+    zmq_msg_close(&second);
+  } else if (worker->has_pending && !worker->replied) {
+    zmq_send(frontend, worker->identity, worker->identity_len, ZMQ_SNDMORE);
+    zmq_send(frontend, "", 0, ZMQ_SNDMORE);
+    zmq_msg_send(&first, frontend, 0);
+    worker->replied = 1;
+  } else {
+    fprintf(stderr, "[TUMBLER][W%d] 丢弃多余的应答\n", worker->index);
+  }
+
+  zmq_msg_close(&first);
+}
+
+static int tumbler_serve(void *context, void *frontend, tumbler_state_t tmpl, size_t n_workers) {
+  int result_status = RLC_OK;
+  size_t started = 0;
+
+  tumbler_worker_t *workers = calloc(n_workers, sizeof(tumbler_worker_t));
+  zmq_pollitem_t *items = calloc(n_workers + 1, sizeof(zmq_pollitem_t));
+  if (workers == NULL || items == NULL) {
+    free(workers);
+    free(items);
+    return RLC_ERR;
+  }
+
+  for (size_t i = 0; i < n_workers; i++) {
+    tumbler_worker_t *worker = &workers[i];
+    worker->index = (int) i;
+    worker->tmpl = tmpl;
+    snprintf(worker->endpoint, sizeof(worker->endpoint), "inproc://tumbler-worker-%zu", i);
+
+    worker->broker_pipe = zmq_socket(context, ZMQ_PAIR);
+    worker->pipe = zmq_socket(context, ZMQ_PAIR);
+    if (worker->broker_pipe == NULL || worker->pipe == NULL
+        || zmq_bind(worker->broker_pipe, worker->endpoint) != 0
+        || zmq_connect(worker->pipe, worker->endpoint) != 0) {
+      fprintf(stderr, "Error: could not create the worker pipe %s.\n", worker->endpoint);
+      if (worker->broker_pipe != NULL) zmq_close(worker->broker_pipe);
+      if (worker->pipe != NULL) zmq_close(worker->pipe);
+      result_status = RLC_ERR;
+      break;
+    }
+
+#if TIGER_MT_ENABLED
+    pari_thread_alloc(&worker->pari_thread, TUMBLER_WORKER_PARI_STACK, NULL);
+#endif
+    if (pthread_create(&worker->thread, NULL, tumbler_worker_main, worker) != 0) {
+      fprintf(stderr, "Error: could not start worker thread %zu.\n", i);
+#if TIGER_MT_ENABLED
+      pari_thread_free(&worker->pari_thread);
+#endif
+      zmq_close(worker->broker_pipe);
+      zmq_close(worker->pipe);
+      result_status = RLC_ERR;
+      break;
+    }
+    started++;
+
+    items[i + 1].socket = worker->broker_pipe;
+    items[i + 1].events = ZMQ_POLLIN;
+  }
+
+  items[0].socket = frontend;
+  items[0].events = ZMQ_POLLIN;
+
+  if (result_status == RLC_OK) {
+    printf("[TUMBLER] 开始监听消息（%zu 个工作线程）...\n", n_workers);
+  }
+
+  while (result_status == RLC_OK && !tumbler_should_exit) {
+    int rc = zmq_poll(items, (int) (n_workers + 1), -1);
+    if (rc < 0) {
+      if (errno == EINTR) continue;
+      fprintf(stderr, "Error: zmq_poll failed with errno %d\n", errno);
+      result_status = RLC_ERR;
+      break;
+    }
+    for (size_t i = 0; i < n_workers; i++) {
+      if (items[i + 1].revents & ZMQ_POLLIN) {
+        tumbler_broker_collect(frontend, &workers[i]);
+      }
+    }
+    if (items[0].revents & ZMQ_POLLIN) {
+      tumbler_broker_dispatch(frontend, workers, n_workers);
+    }
+  }
+
+  // 关闭上下文使工作线程的阻塞接收返回 ETERM
+  zmq_ctx_shutdown(context);
+  for (size_t i = 0; i < started; i++) {
+    pthread_join(workers[i].thread, NULL);
+    zmq_close(workers[i].broker_pipe);
+#if TIGER_MT_ENABLED
+    pari_thread_free(&workers[i].pari_thread);
+#endif
+  }
+
+  free(items);
+  free(workers);
+  return result_status;
+}
+
 int registration_handler(tumbler_state_t state, void *socket, uint8_t *data) {
    if (state == NULL || data == NULL) {
     RLC_THROW(ERR_NO_VALID);
@@ -1181,385 +1544,60 @@ int promise_init_handler(tumbler_state_t state, void *socket, uint8_t *data) {
       RLC_THROW(ERR_CAUGHT);
     }
     
-    // 从 proofData JSON 中提取 nullifierHash（从 publicSignals 中）
-    // publicSignals 格式：[root, nullifierHash, recipient, relayer, fee, refund]
-    // nullifierHash 是 publicSignals[1]
-    // 注意：nullifierHash 在 publicSignals 中是十进制数字字符串，需要转换为十六进制
-    const char *tornado_project = "/home/zxx/tornado-core-master";
+    // 解析 proofData：{"proof": {pi_a, pi_b, pi_c}, "publicSignals": [root, nullifierHash, recipient, relayer, fee, refund]}
+    groth16_proof_st tornado_proof;
     char nullifier_hash[67] = {0}; // 0x + 64 hex chars + null terminator
-    const char *public_signals_start = strstr(state->tornado_proof_data, "\"publicSignals\":");
-    if (!public_signals_start) {
-      // 尝试不区分大小写
-      const char *p = state->tornado_proof_data;
-      while (*p) {
-        if (strncasecmp(p, "publicSignals", 13) == 0) {
-          public_signals_start = p;
-          break;
-        }
-        p++;
-      }
+    if (groth16_proof_parse(&tornado_proof, state->tornado_proof_data) != RLC_OK
+     || groth16_signal_hex(nullifier_hash, &tornado_proof, 1) != RLC_OK) {
+      fprintf(stderr, "[ERROR] Tumbler: Failed to parse proofData or extract nullifierHash\n");
+      fprintf(stderr, "[ERROR] Tumbler: proofData (first 500 chars): %.500s\n", state->tornado_proof_data);
+      RLC_THROW(ERR_CAUGHT);
     }
-    
-    if (public_signals_start) {
-      printf("[TORNADO] Tumbler: Found publicSignals field at offset %zu\n", public_signals_start - state->tornado_proof_data);
-      
-      // 找到 publicSignals 数组的开始
-      const char *array_start = strchr(public_signals_start, '[');
-      if (array_start) {
-        printf("[TORNADO] Tumbler: Found '[' at offset %zu\n", array_start - state->tornado_proof_data);
-        
-        // 跳过第一个元素（root），找到第二个元素（nullifierHash）
-        // 第一个元素可能是数字字符串（不带引号）
-        const char *first_comma = strchr(array_start + 1, ',');
-        if (first_comma) {
-          printf("[TORNADO] Tumbler: Found first comma at offset %zu\n", first_comma - state->tornado_proof_data);
-          
-          const char *second_start = first_comma + 1;
-          // 跳过空格和换行符
-          while (*second_start == ' ' || *second_start == '\t' || *second_start == '\n' || *second_start == '\r') {
-            second_start++;
-          }
-          
-          printf("[TORNADO] Tumbler: Second element starts at offset %zu, char: '%c'\n", second_start - state->tornado_proof_data, *second_start);
-          
-          // 找到第二个元素的结束（逗号或右括号）
-          const char *second_end = strchr(second_start, ',');
-          if (!second_end) {
-            second_end = strchr(second_start, ']');
-          }
-          if (second_end) {
-            printf("[TORNADO] Tumbler: Second element ends at offset %zu\n", second_end - state->tornado_proof_data);
-            
-            size_t nullifier_len = second_end - second_start;
-            // 去除末尾的空白字符
-            while (nullifier_len > 0 && (second_start[nullifier_len - 1] == ' ' || 
-                                         second_start[nullifier_len - 1] == '\t' ||
-                                         second_start[nullifier_len - 1] == '\n' ||
-                                         second_start[nullifier_len - 1] == '\r')) {
-              nullifier_len--;
-            }
-            
-            // 去除引号（如果有）
-            const char *value_start = second_start;
-            if (*value_start == '"') {
-              value_start++;
-              nullifier_len--;
-            }
-            if (nullifier_len > 0 && value_start[nullifier_len - 1] == '"') {
-              nullifier_len--;
-            }
-            
-            printf("[TORNADO] Tumbler: Extracted value length: %zu\n", nullifier_len);
-            
-            // publicSignals 中的值可能是十进制数字字符串（很长），需要转换为十六进制
-            // 使用临时缓冲区存储原始值（可能很长）
-            char raw_value[256] = {0};
-            if (nullifier_len > 0 && nullifier_len < sizeof(raw_value) - 1) {
-              strncpy(raw_value, value_start, nullifier_len);
-              raw_value[nullifier_len] = '\0';
-              
-              printf("[TORNADO] Tumbler: Raw extracted value: '%s' (length: %zu)\n", raw_value, nullifier_len);
-              
-              // 检查是否是十六进制格式（以 0x 开头）
-              if (strncmp(raw_value, "0x", 2) == 0) {
-                // 已经是十六进制格式
-                if (strlen(raw_value) < sizeof(nullifier_hash)) {
-                  strncpy(nullifier_hash, raw_value, sizeof(nullifier_hash) - 1);
-                  nullifier_hash[sizeof(nullifier_hash) - 1] = '\0';
-                  printf("[TORNADO] Tumbler: nullifierHash is already hex: %s\n", nullifier_hash);
-                } else {
-                  fprintf(stderr, "[ERROR] Tumbler: Hex nullifierHash too long: %zu\n", strlen(raw_value));
-                }
-              } else {
-                // 是十进制数字字符串，需要转换为十六进制
-                // 使用 Node.js 脚本转换（在 tornado-core-master 目录下）
-                char convert_cmd[1024];
-                snprintf(convert_cmd, sizeof(convert_cmd),
-                         "cd %s && node -e \"const bigInt = require('snarkjs').bigInt; console.log('0x' + bigInt('%s').toString(16));\"",
-                         tornado_project, raw_value);
-                
-                printf("[TORNADO] Tumbler: Converting decimal to hex using: %s\n", convert_cmd);
-                
-                FILE *fp_convert = popen(convert_cmd, "r");
-                if (fp_convert) {
-                  char hex_result[67] = {0};
-                  if (fgets(hex_result, sizeof(hex_result), fp_convert) != NULL) {
-                    // 去除换行符
-                    size_t hex_len = strlen(hex_result);
-                    if (hex_len > 0 && hex_result[hex_len - 1] == '\n') {
-                      hex_result[hex_len - 1] = '\0';
-                      hex_len--;
-                    }
-                    
-                    if (hex_len > 0 && hex_len < sizeof(nullifier_hash)) {
-                      strncpy(nullifier_hash, hex_result, sizeof(nullifier_hash) - 1);
-                      nullifier_hash[sizeof(nullifier_hash) - 1] = '\0';
-                      printf("[TORNADO] Tumbler: Converted nullifierHash: %s (length: %zu)\n", nullifier_hash, hex_len);
-                    } else {
-                      fprintf(stderr, "[ERROR] Tumbler: Converted hex length invalid: %zu (max: %zu)\n", 
-                              hex_len, sizeof(nullifier_hash) - 1);
-                    }
-                  } else {
-                    fprintf(stderr, "[ERROR] Tumbler: Failed to read conversion result\n");
-                  }
-                  pclose(fp_convert);
-                } else {
-                  fprintf(stderr, "[ERROR] Tumbler: Failed to execute conversion command\n");
-                }
-              }
-            } else {
-              fprintf(stderr, "[ERROR] Tumbler: Raw value length invalid: %zu (max: %zu)\n", 
-                      nullifier_len, sizeof(raw_value) - 1);
-            }
-          } else {
-            fprintf(stderr, "[ERROR] Tumbler: Could not find end of second element in publicSignals\n");
-          }
-        } else {
-          fprintf(stderr, "[ERROR] Tumbler: Could not find first comma in publicSignals array\n");
-          fprintf(stderr, "[ERROR] Tumbler: Array content: %.100s\n", array_start);
-        }
-      } else {
-        fprintf(stderr, "[ERROR] Tumbler: Could not find '[' in publicSignals\n");
-        fprintf(stderr, "[ERROR] Tumbler: Content after publicSignals: %.100s\n", public_signals_start);
-      }
-    } else {
-      fprintf(stderr, "[ERROR] Tumbler: Could not find 'publicSignals' field in proofData\n");
-      fprintf(stderr, "[ERROR] Tumbler: proofData preview: %.500s...\n", state->tornado_proof_data);
+    printf("[TORNADO] Tumbler: nullifierHash: %s\n", nullifier_hash);
+
+    // 检查 nullifierHash 是否已经被使用过（防止双重花费）；验证通过后的插入还会再检查一次。
+    // 索引不可用时无法判断是否重复使用，一律拒绝
+    if (tumbler_nullifiers == NULL) {
+      fprintf(stderr, "[ERROR] Tumbler: nullifier index unavailable, rejecting proof\n");
+      RLC_THROW(ERR_CAUGHT);
     }
-    
-    if (nullifier_hash[0] == '\0') {
-      fprintf(stderr, "[ERROR] Tumbler: Failed to extract nullifierHash from proofData\n");
-      fprintf(stderr, "[ERROR] Tumbler: proofData length: %zu\n", strlen(state->tornado_proof_data));
-      fprintf(stderr, "[ERROR] Tumbler: proofData (first 500 chars): %.500s\n", state->tornado_proof_data);
+    int used = nullifier_set_contains(tumbler_nullifiers, nullifier_hash);
+    if (used < 0) {
+      fprintf(stderr, "[ERROR] Tumbler: nullifierHash %s is not a valid hex value\n", nullifier_hash);
       RLC_THROW(ERR_CAUGHT);
     }
-    
-    // 检查 nullifierHash 是否已经被使用过（防止双重花费）
-    const char *nullifier_hash_file = "/home/zxx/Config/truffleProject/truffletest/nullifier_hashes.txt";
-    FILE *fp_check = fopen(nullifier_hash_file, "r");
-    if (fp_check) {
-      // 逐行读取文件，检查是否有匹配的 nullifierHash
-      char line[128];
-      int found = 0;
-      while (fgets(line, sizeof(line), fp_check) != NULL) {
-        // 去除换行符
-        size_t line_len = strlen(line);
-        if (line_len > 0 && line[line_len - 1] == '\n') {
-          line[line_len - 1] = '\0';
-          line_len--;
-        }
-        
-        // 比较 nullifierHash（精确匹配，因为都是十六进制）
-        if (strcmp(line, nullifier_hash) == 0) {
-          found = 1;
-          break;
-        }
-      }
-      fclose(fp_check);
-      
-      if (found) {
-        fprintf(stderr, "[ERROR] Tumbler: nullifierHash %s has already been used (double-spending attempt detected)\n", nullifier_hash);
-        RLC_THROW(ERR_CAUGHT);
-      }
+    if (used) {
+      fprintf(stderr, "[ERROR] Tumbler: nullifierHash %s has already been used (double-spending attempt detected)\n", nullifier_hash);
+      RLC_THROW(ERR_CAUGHT);
     }
     
     printf("[TORNADO] Tumbler: nullifierHash %s is not in the used list, proceeding with verification...\n", nullifier_hash);
     
-    // 验证 proofData（使用 tornado_generate_withdraw_proof.js 中的验证方式）
-    // 直接通过 stdin 传递 proofData，无需临时文件
-    // 使用 pipe + fork + exec 来同时写入 stdin 和读取 stdout
+    // 用启动时载入的验证密钥在进程内验证 Groth16 证明
     printf("[TORNADO] Tumbler: Starting proofData verification...\n");
-    // 注意：tornado_project 已在上面定义，这里不再重复定义
     START_TIMER(tumbler_proof_verification);
-    const char *verify_script_path = "/home/zxx/tornado-core-master/scripts/verify_proof_locally.js";
-    
-    // 创建两个管道：一个用于 stdin，一个用于 stdout
-    int stdin_pipe[2], stdout_pipe[2];
-    if (pipe(stdin_pipe) == -1 || pipe(stdout_pipe) == -1) {
-      fprintf(stderr, "[ERROR] Tumbler: Failed to create pipes\n");
+    if (!tumbler_groth16_vk_loaded) {
+      fprintf(stderr, "[ERROR] Tumbler: Groth16 verification key not loaded, rejecting proof\n");
       RLC_THROW(ERR_CAUGHT);
     }
-    
-    pid_t pid = fork();
-    if (pid == -1) {
-      fprintf(stderr, "[ERROR] Tumbler: Failed to fork\n");
-      close(stdin_pipe[0]);
-      close(stdin_pipe[1]);
-      close(stdout_pipe[0]);
-      close(stdout_pipe[1]);
+    if (groth16_verify(&tumbler_groth16_vk, &tornado_proof) != RLC_OK) {
+      fprintf(stderr, "[ERROR] Tumbler: Proof verification failed\n");
       RLC_THROW(ERR_CAUGHT);
     }
+    printf("[TORNADO] Tumbler: ✅ Proof verification passed!\n");
     
-    if (pid == 0) {
-      // 子进程：执行验证脚本
-      close(stdin_pipe[1]); // 关闭写端
-      close(stdout_pipe[0]); // 关闭读端
-      
-      // 重定向 stdin 和 stdout
-      // 注意：stderr 不重定向到 stdout_pipe，这样错误信息不会混入验证结果
-      dup2(stdin_pipe[0], STDIN_FILENO);
-      dup2(stdout_pipe[1], STDOUT_FILENO);
-      // stderr 保持原样，这样错误信息会输出到终端
-      close(stdin_pipe[0]);
-      close(stdout_pipe[1]);
-      
-      // 切换到 tornado 项目目录
-      if (chdir(tornado_project) != 0) {
-        fprintf(stderr, "[ERROR] Tumbler: Failed to chdir to %s\n", tornado_project);
-        exit(1);
-      }
-      
-      // 执行验证脚本
-      execlp("node", "node", verify_script_path, (char *)NULL);
-      
-      // 如果 execlp 失败
-      fprintf(stderr, "[ERROR] Tumbler: Failed to execute node\n");
-      exit(1);
+    // 验证成功后记录 nullifierHash（写日志并 fsync）。检查与插入是原子的：
+    // 并发会话用同一个 nullifier 同时通过了上面的检查时，只有一个能插入成功
+    // 没能持久化的 nullifier 在重启后会被遗忘，此时接受提款就可能被重放，因此拒绝
+    int stored = nullifier_set_insert(tumbler_nullifiers, nullifier_hash);
+    if (stored == 1) {
+      printf("[TORNADO] Tumbler: ✅ nullifierHash %s stored to prevent double-spending\n", nullifier_hash);
+    } else if (stored == 0) {
+      fprintf(stderr, "[ERROR] Tumbler: nullifierHash %s has already been used (double-spending attempt detected)\n", nullifier_hash);
+      RLC_THROW(ERR_CAUGHT);
     } else {
-      // 父进程：写入 JSON 并读取结果
-      close(stdin_pipe[0]); // 关闭读端
-      close(stdout_pipe[1]); // 关闭写端
-      
-      // 写入 JSON 到子进程的 stdin
-      size_t written_bytes = write(stdin_pipe[1], state->tornado_proof_data, strlen(state->tornado_proof_data));
-      if (written_bytes != strlen(state->tornado_proof_data)) {
-        fprintf(stderr, "[ERROR] Tumbler: Failed to write proofData to script\n");
-        close(stdin_pipe[1]);
-        close(stdout_pipe[0]);
-        RLC_THROW(ERR_CAUGHT);
-      }
-      close(stdin_pipe[1]); // 关闭写端，发送 EOF
-      
-      // 从子进程的 stdout 读取结果（包括时间信息和验证结果）
-      // 需要循环读取，直到管道关闭（EOF）
-      char verify_output[4096] = {0}; // 增大缓冲区以读取所有输出
-      size_t total_read = 0;
-      ssize_t read_bytes;
-      
-      // 循环读取直到 EOF（read 返回 0）或错误（返回 -1）
-      while (total_read < sizeof(verify_output) - 1) {
-        read_bytes = read(stdout_pipe[0], verify_output + total_read, sizeof(verify_output) - 1 - total_read);
-        if (read_bytes < 0) {
-          fprintf(stderr, "[ERROR] Tumbler: Failed to read verification result\n");
-          close(stdout_pipe[0]);
-          RLC_THROW(ERR_CAUGHT);
-        } else if (read_bytes == 0) {
-          // EOF，读取完成
-          break;
-        } else {
-          total_read += read_bytes;
-        }
-      }
-      
-      if (total_read == 0) {
-        fprintf(stderr, "[ERROR] Tumbler: No data read from verification script\n");
-        close(stdout_pipe[0]);
-        RLC_THROW(ERR_CAUGHT);
-      }
-      
-      verify_output[total_read] = '\0';
-      close(stdout_pipe[0]);
-      
-      // 等待子进程结束
-      int status;
-      waitpid(pid, &status, 0);
-      
-      // 解析验证时间信息（从脚本输出中提取）
-      long long verify_start_time = 0;
-      long long verify_end_time = 0;
-      long long verify_duration = 0;
-      int verify_timing_found = 0;
-      
-      // 逐行解析输出
-      char *line = verify_output;
-      char *verify_result = NULL;
-      while (*line != '\0') {
-        char *line_end = strchr(line, '\n');
-        if (line_end) {
-          *line_end = '\0';
-        }
-        
-        // 检查是否包含验证时间信息
-        if (strstr(line, "[VERIFY_TIMING]") != NULL) {
-          if (strstr(line, "START:") != NULL) {
-            sscanf(line, "[VERIFY_TIMING] START:%lld", &verify_start_time);
-          } else if (strstr(line, "END:") != NULL) {
-            sscanf(line, "[VERIFY_TIMING] END:%lld", &verify_end_time);
-          } else if (strstr(line, "DURATION:") != NULL) {
-            sscanf(line, "[VERIFY_TIMING] DURATION:%lld", &verify_duration);
-            verify_timing_found = 1;
-          }
-        } else if (strlen(line) == 1 && (line[0] == '1' || line[0] == '0')) {
-          // 找到验证结果（"1" 或 "0"）
-          verify_result = line;
-        }
-        
-        if (line_end) {
-          line = line_end + 1;
-        } else {
-          break;
-        }
-      }
-      
-      // 输出解析到的验证时间（仅 zkSNARK 验证部分）
-      if (verify_timing_found && verify_duration > 0) {
-        printf("[TORNADO] Tumbler: zkSNARK proof verification (core) took: %lld ms\n", verify_duration);
-      } else if (verify_start_time > 0 && verify_end_time > 0) {
-        verify_duration = verify_end_time - verify_start_time;
-        printf("[TORNADO] Tumbler: zkSNARK proof verification (core) took: %lld ms\n", verify_duration);
-      }
-      
-      // 提取验证结果
-      if (!verify_result) {
-        // 如果没有找到验证结果，尝试从最后一行提取
-        char *last_line = verify_output;
-        char *last_newline = strrchr(verify_output, '\n');
-        if (last_newline) {
-          last_line = last_newline + 1;
-        }
-        // 去除换行符和空白字符
-        size_t result_len = strlen(last_line);
-        while (result_len > 0 && (last_line[result_len - 1] == '\n' || 
-                                  last_line[result_len - 1] == '\r' || 
-                                  last_line[result_len - 1] == ' ')) {
-          last_line[result_len - 1] = '\0';
-          result_len--;
-        }
-        if (result_len == 1 && (last_line[0] == '1' || last_line[0] == '0')) {
-          verify_result = last_line;
-        }
-      }
-      
-      if (!verify_result || (verify_result[0] != '1' && verify_result[0] != '0')) {
-        fprintf(stderr, "[ERROR] Tumbler: Could not find verification result in output\n");
-        fprintf(stderr, "[ERROR] Tumbler: Output was: %s\n", verify_output);
-        RLC_THROW(ERR_CAUGHT);
-      }
-      
-      // 只取第一个字符（应该是 "1" 或 "0"）
-      char result_char = verify_result[0];
-      printf("[TORNADO] Tumbler: Verification result: %c\n", result_char);
-      
-      // 检查验证结果：应该是 "1" 表示成功，"0" 表示失败
-      if (result_char != '1') {
-        fprintf(stderr, "[ERROR] Tumbler: Proof verification failed (result=%s, first_char='%c', exit_status=%d)\n", 
-                verify_result, result_char, WEXITSTATUS(status));
-        RLC_THROW(ERR_CAUGHT);
-      }
-      
-      printf("[TORNADO] Tumbler: ✅ Proof verification passed!\n");
-      
-      // 验证成功后，将 nullifierHash 存储到文件中（防止双重花费）
-      // 使用简单的追加方式：每行一个 nullifierHash
-      FILE *fp_store = fopen(nullifier_hash_file, "a");
-      if (fp_store) {
-        fprintf(fp_store, "%s\n", nullifier_hash);
-        fclose(fp_store);
-        printf("[TORNADO] Tumbler: ✅ nullifierHash %s stored to prevent double-spending\n", nullifier_hash);
-      } else {
-        fprintf(stderr, "[WARNING] Tumbler: Failed to open nullifier hash file for writing: %s\n", nullifier_hash_file);
-        fprintf(stderr, "[WARNING] Tumbler: Double-spending protection may not work correctly\n");
-      }
+      fprintf(stderr, "[ERROR] Tumbler: Failed to record nullifierHash in %s, rejecting proof\n", TUMBLER_NULLIFIER_LOG);
+      RLC_THROW(ERR_CAUGHT);
     }
     END_TIMER(tumbler_proof_verification);
     // 注意：已移除 tid 和 sigma_tid，因此不再进行 PS 签名验证
@@ -1785,35 +1823,18 @@ int promise_init_handler(tumbler_state_t state, void *socket, uint8_t *data) {
     ec_write_bin(promise_done_msg->data + (3 * RLC_EC_SIZE_COMPRESSED) + (2 * RLC_BN_SIZE), RLC_EC_SIZE_COMPRESSED, state->sigma_tr->pi->b, 1);
     bn_write_bin(promise_done_msg->data + (4 * RLC_EC_SIZE_COMPRESSED) + (2 * RLC_BN_SIZE), RLC_BN_SIZE, state->sigma_tr->pi->z);   
     // 使用真实的 ctx_alpha 密文序列化
-    {
-      const char *c1_str = GENtostr(state->ctx_alpha->c1);
-      const char *c2_str = GENtostr(state->ctx_alpha->c2);
-      size_t base_off = (4 * RLC_EC_SIZE_COMPRESSED) + (3 * RLC_BN_SIZE);
-      memset(promise_done_msg->data + base_off, 0, RLC_CL_CIPHERTEXT_SIZE);
-      memcpy(promise_done_msg->data + base_off, c1_str, strnlen(c1_str, RLC_CL_CIPHERTEXT_SIZE - 1));
-      promise_done_msg->data[base_off + RLC_CL_CIPHERTEXT_SIZE - 1] = '\0';
-      memset(promise_done_msg->data + base_off + RLC_CL_CIPHERTEXT_SIZE, 0, RLC_CL_CIPHERTEXT_SIZE);
-      memcpy(promise_done_msg->data + base_off + RLC_CL_CIPHERTEXT_SIZE, c2_str, strnlen(c2_str, RLC_CL_CIPHERTEXT_SIZE - 1));
-      promise_done_msg->data[base_off + (2 * RLC_CL_CIPHERTEXT_SIZE) - 1] = '\0';
-    }
-
-    // 跳过CLDL证明的生成和序列化，直接计算偏移量
-    size_t off = (4 * RLC_EC_SIZE_COMPRESSED) + (3 * RLC_BN_SIZE) + (2 * RLC_CL_CIPHERTEXT_SIZE);
-  
+    size_t off = (4 * RLC_EC_SIZE_COMPRESSED) + (3 * RLC_BN_SIZE);
+    if (cl_codec_write_ct(promise_done_msg->data, &off, state->ctx_alpha) != RLC_OK) {
+      RLC_THROW(ERR_CAUGHT);
+    }
+
+    // 跳过CLDL证明的生成和序列化
     size_t auditor_offset = off;
     printf("  附加auditor密文 (偏移量: %zu):\n", auditor_offset);
     // 使用真正的 auditor 加密结果序列化
-    {
-      const char *c1_str = GENtostr(state->ctx_r0_auditor->c1);
-      const char *c2_str = GENtostr(state->ctx_r0_auditor->c2);
-      memset(promise_done_msg->data + auditor_offset, 0, RLC_CL_CIPHERTEXT_SIZE);
-      memcpy(promise_done_msg->data + auditor_offset, c1_str, strnlen(c1_str, RLC_CL_CIPHERTEXT_SIZE - 1));
-      promise_done_msg->data[auditor_offset + RLC_CL_CIPHERTEXT_SIZE - 1] = '\0';
-      memset(promise_done_msg->data + auditor_offset + RLC_CL_CIPHERTEXT_SIZE, 0, RLC_CL_CIPHERTEXT_SIZE);
-      memcpy(promise_done_msg->data + auditor_offset + RLC_CL_CIPHERTEXT_SIZE, c2_str, strnlen(c2_str, RLC_CL_CIPHERTEXT_SIZE - 1));
-      promise_done_msg->data[auditor_offset + (2 * RLC_CL_CIPHERTEXT_SIZE) - 1] = '\0';
-    }
-    off += 2 * RLC_CL_CIPHERTEXT_SIZE;
+    if (cl_codec_write_ct(promise_done_msg->data, &off, state->ctx_r0_auditor) != RLC_OK) {
+      RLC_THROW(ERR_CAUGHT);
+    }
    
   
     // 附加托管ID与 Tumbler 的开托管 txHash
@@ -1994,54 +2015,13 @@ int payment_init_handler(tumbler_state_t state, void *socket, uint8_t *data) {
     }
 
     // 现在读取密文数据
-    char ct_str[RLC_CL_CIPHERTEXT_SIZE + 1];
-    memcpy(ct_str, data + offset, RLC_CL_CIPHERTEXT_SIZE);
-    ct_str[RLC_CL_CIPHERTEXT_SIZE] = 0;
-    
     printf("\n[TUMBLER DEBUG] ========== 接收 ctx_alpha_times_beta_times_tau (Tumbler密文) ==========\n");
     printf("[TUMBLER DEBUG] 当前偏移量: %zu\n", offset);
-    printf("[TUMBLER DEBUG] c1 原始字符串长度: %zu\n", strlen(ct_str));
-    printf("[TUMBLER DEBUG] c1 原始内容（前100字符）: %.100s\n", ct_str);
-    
-    RLC_TRY {
-        ctx_alpha_times_beta_times_tau->c1 = gp_read_str(ct_str);
-        printf("[TUMBLER DEBUG] ✅ 密文 c1 读取成功\n");
-    } RLC_CATCH_ANY {
-        printf("[TUMBLER ERROR] ❌ 密文 c1 读取失败: %s\n", ct_str);
-        RLC_THROW(ERR_CAUGHT);
-    }
-    offset += RLC_CL_CIPHERTEXT_SIZE;  // 更新偏移量（c1读取后）
-    
-    // 读取c2
-    memcpy(ct_str, data + offset, RLC_CL_CIPHERTEXT_SIZE);
-    ct_str[RLC_CL_CIPHERTEXT_SIZE] = 0;
-    
-    printf("[TUMBLER DEBUG] c2 原始字符串长度: %zu\n", strlen(ct_str));
-    printf("[TUMBLER DEBUG] c2 原始内容（前100字符）: %.100s\n", ct_str);
-    
-    RLC_TRY {
-        ctx_alpha_times_beta_times_tau->c2 = gp_read_str(ct_str);
-        printf("[TUMBLER DEBUG] ✅ 密文 c2 读取成功\n");
-    } RLC_CATCH_ANY {
-        printf("[TUMBLER ERROR] ❌ 密文 c2 读取失败\n");
-        printf("[TUMBLER ERROR] 失败的字符串长度: %zu\n", strlen(ct_str));
-        printf("[TUMBLER ERROR] 失败的字符串内容: %s\n", ct_str);
-        RLC_THROW(ERR_CAUGHT);
-    }
-    offset += RLC_CL_CIPHERTEXT_SIZE;  // 更新偏移量（c2读取后）
-    
-    // 打印解析后的密文
-    {
-      char *parsed_c1_str = GENtostr(ctx_alpha_times_beta_times_tau->c1);
-      char *parsed_c2_str = GENtostr(ctx_alpha_times_beta_times_tau->c2);
-      printf("[TUMBLER DEBUG] 解析后 c1 长度: %zu\n", strlen(parsed_c1_str));
-      printf("[TUMBLER DEBUG] 解析后 c1 内容（前100字符）: %.100s\n", parsed_c1_str);
-      printf("[TUMBLER DEBUG] 解析后 c2 长度: %zu\n", strlen(parsed_c2_str));
-      printf("[TUMBLER DEBUG] 解析后 c2 内容（前100字符）: %.100s\n", parsed_c2_str);
-      printf("[TUMBLER DEBUG] ================================================================\n\n");
-      free(parsed_c1_str);
-      free(parsed_c2_str);
+    if (cl_codec_read_ct(ctx_alpha_times_beta_times_tau, data, &offset, state->cl_params) != RLC_OK) {
+      printf("[TUMBLER ERROR] ❌ 密文 ctx_alpha_times_beta_times_tau 解码失败\n");
+      RLC_THROW(ERR_CAUGHT);
     }
+    printf("[TUMBLER DEBUG] ✅ 密文 c1/c2 读取成功，新偏移: %zu\n", offset);
     // Decrypt the ciphertext.
     GEN gamma;
     if (cl_dec(&gamma, ctx_alpha_times_beta_times_tau, state->tumbler_cl_sk, state->cl_params) != RLC_OK) {
@@ -2059,38 +2039,17 @@ int payment_init_handler(tumbler_state_t state, void *socket, uint8_t *data) {
     bn_mod(state->sigma_s->s, state->sigma_s->s, q);
 
     // 解析auditor最终密文（+tau）- 使用offset而不是硬编码偏移
-    char auditor_c1_final_str[RLC_CL_CIPHERTEXT_SIZE + 1];
-    char auditor_c2_final_str[RLC_CL_CIPHERTEXT_SIZE + 1];
-    
     printf("\n[TUMBLER DEBUG] ========== 接收 auditor_ctx_alpha_times_beta_times_tau ==========\n");
     printf("[TUMBLER DEBUG] 当前偏移量: %zu\n", offset);
-    
-    memcpy(auditor_c1_final_str, data + offset, RLC_CL_CIPHERTEXT_SIZE);
-    auditor_c1_final_str[RLC_CL_CIPHERTEXT_SIZE] = 0;
-    printf("[TUMBLER DEBUG] auditor c1 原始字符串长度: %zu\n", strlen(auditor_c1_final_str));
-    printf("[TUMBLER DEBUG] auditor c1 原始内容（前100字符）: %.100s\n", auditor_c1_final_str);
-    auditor_ctx_alpha_times_beta_times_tau->c1 = gp_read_str(auditor_c1_final_str);
-    offset += RLC_CL_CIPHERTEXT_SIZE;
-    
-    memcpy(auditor_c2_final_str, data + offset, RLC_CL_CIPHERTEXT_SIZE);
-    auditor_c2_final_str[RLC_CL_CIPHERTEXT_SIZE] = 0;
-    printf("[TUMBLER DEBUG] auditor c2 原始字符串长度: %zu\n", strlen(auditor_c2_final_str));
-    printf("[TUMBLER DEBUG] auditor c2 原始内容（前100字符）: %.100s\n", auditor_c2_final_str);
-    auditor_ctx_alpha_times_beta_times_tau->c2 = gp_read_str(auditor_c2_final_str);
-    offset += RLC_CL_CIPHERTEXT_SIZE;
-    printf("[TUMBLER DEBUG] ================================================================\n\n");
-    
-    char *tumbler_c1_str = GENtostr(ctx_alpha_times_beta_times_tau->c1);
-    char *tumbler_c2_str = GENtostr(ctx_alpha_times_beta_times_tau->c2);
+    if (cl_codec_read_ct(auditor_ctx_alpha_times_beta_times_tau, data, &offset, state->cl_params) != RLC_OK) {
+      printf("[TUMBLER ERROR] auditor 密文解码失败\n");
+      RLC_THROW(ERR_CAUGHT);
+    }
     
     // 比较Tumbler密文和Auditor密文
     printf("\n[TUMBLER DEBUG] ========== 密文对比 ==========\n");
-    printf("[TUMBLER DEBUG] Tumbler c1 长度: %zu\n", strlen(tumbler_c1_str));
-    printf("[TUMBLER DEBUG] Auditor c1 长度: %zu\n", strlen(auditor_c1_final_str));
-    printf("[TUMBLER DEBUG] Tumbler c2 长度: %zu\n", strlen(tumbler_c2_str));
-    printf("[TUMBLER DEBUG] Auditor c2 长度: %zu\n", strlen(auditor_c2_final_str));
-    printf("[TUMBLER DEBUG] c1 相同？%s\n", strcmp(tumbler_c1_str, auditor_c1_final_str) == 0 ? "是" : "否");
-    printf("[TUMBLER DEBUG] c2 相同？%s\n", strcmp(tumbler_c2_str, auditor_c2_final_str) == 0 ? "是" : "否");
+    printf("[TUMBLER DEBUG] c1 相同？%s\n", gequal(ctx_alpha_times_beta_times_tau->c1, auditor_ctx_alpha_times_beta_times_tau->c1) ? "是" : "否");
+    printf("[TUMBLER DEBUG] c2 相同？%s\n", gequal(ctx_alpha_times_beta_times_tau->c2, auditor_ctx_alpha_times_beta_times_tau->c2) ? "是" : "否");
     printf("[TUMBLER DEBUG] ================================================================\n\n");
     // 解析tx_len和tx_buf
     int tx_len;
@@ -2206,7 +2165,7 @@ int payment_init_handler(tumbler_state_t state, void *socket, uint8_t *data) {
     // 接收和验证Alice的零知识证明
     printf("[TUMBLER] 开始接收Alice的零知识证明，当前offset: %zu\n", offset);
     size_t proof_read = 0;
-    if (zk_puzzle_relation_deserialize(state->alice_puzzle_relation_zk_proof, data + offset, &proof_read) != RLC_OK) {
+    if (zk_puzzle_relation_deserialize(state->alice_puzzle_relation_zk_proof, data + offset, &proof_read, state->cl_params) != RLC_OK) {
       printf("[ERROR] 无法反序列化Alice的puzzle_relation证明!\n");
       RLC_THROW(ERR_CAUGHT);
     }
@@ -2222,24 +2181,18 @@ int payment_init_handler(tumbler_state_t state, void *socket, uint8_t *data) {
     printf("[TUMBLER] 接收 g^(α+β)，当前offset: %zu\n", offset);
     
     // 2. 接收 ctx_α+β (从Bob收到的Tumbler密文)
-    {
-      char *s1 = (char*)(data + offset);
-      char *s2 = (char*)(data + offset + RLC_CL_CIPHERTEXT_SIZE);
-      state->alice_ctx_alpha_times_beta->c1 = gp_read_str(s1);
-      state->alice_ctx_alpha_times_beta->c2 = gp_read_str(s2);
-      offset += 2 * RLC_CL_CIPHERTEXT_SIZE;
-      printf("[TUMBLER] 接收 ctx_α+β，当前offset: %zu\n", offset);
+    if (cl_codec_read_ct(state->alice_ctx_alpha_times_beta, data, &offset, state->cl_params) != RLC_OK) {
+      printf("[ERROR] ctx_α+β 解码失败!\n");
+      RLC_THROW(ERR_CAUGHT);
     }
+    printf("[TUMBLER] 接收 ctx_α+β，当前offset: %zu\n", offset);
     
     // 3. 接收 auditor_ctx_α+β (从Bob收到的Auditor密文)
-    {
-      char *s1 = (char*)(data + offset);
-      char *s2 = (char*)(data + offset + RLC_CL_CIPHERTEXT_SIZE);
-      state->alice_auditor_ctx_alpha_times_beta->c1 = gp_read_str(s1);
-      state->alice_auditor_ctx_alpha_times_beta->c2 = gp_read_str(s2);
-      offset += 2 * RLC_CL_CIPHERTEXT_SIZE;
-      printf("[TUMBLER] 接收 auditor_ctx_α+β，最终offset: %zu\n", offset);
+    if (cl_codec_read_ct(state->alice_auditor_ctx_alpha_times_beta, data, &offset, state->cl_params) != RLC_OK) {
+      printf("[ERROR] auditor_ctx_α+β 解码失败!\n");
+      RLC_THROW(ERR_CAUGHT);
     }
+    printf("[TUMBLER] 接收 auditor_ctx_α+β，最终offset: %zu\n", offset);
     
     printf("[TUMBLER] 从Bob收到的原始谜题数据接收完成!\n");
     
@@ -2276,21 +2229,14 @@ int payment_init_handler(tumbler_state_t state, void *socket, uint8_t *data) {
     // ====== 构造并发送秘密分享分片（使用 alice_escrow_tx_hash 作为 msgid） ======
     {
       // 计算实际需要的总长度（使用长度前缀格式）
-      char *s1 = GENtostr(ctx_alpha_times_beta_times_tau->c1);
-      char *s2 = GENtostr(ctx_alpha_times_beta_times_tau->c2);
-      size_t aud_len1 = strlen(auditor_c1_final_str);
-      size_t aud_len2 = strlen(auditor_c2_final_str);
-      
       // 计算 alice_escrow_id 和 alice_escrow_tx_hash 的长度
       size_t alice_escrow_id_len = strlen(state->alice_escrow_id) + 1; // 包含 '\0'
       size_t alice_escrow_tx_hash_len = strlen(state->alice_escrow_tx_hash) + 1; // 包含 '\0'
       
       size_t total_len = 0;
       total_len += RLC_EC_SIZE_COMPRESSED;                 // g^(alpha+beta+tau)
-      total_len += sizeof(size_t) + strlen(s1);            // ctx c1 长度+数据
-      total_len += sizeof(size_t) + strlen(s2);            // ctx c2 长度+数据
-      total_len += sizeof(size_t) + aud_len1;              // auditor c1 长度+数据
-      total_len += sizeof(size_t) + aud_len2;              // auditor c2 长度+数据
+      total_len += pack_ct_prefixed_size(ctx_alpha_times_beta_times_tau);         // ctx c1|c2 长度+数据
+      total_len += pack_ct_prefixed_size(auditor_ctx_alpha_times_beta_times_tau); // auditor c1|c2 长度+数据
       total_len += 2 * RLC_BN_SIZE;                        // Alice 预签名 r|s
       total_len += RLC_EC_SIZE_COMPRESSED;                 // Alice 预签名 R
       total_len += 2 * RLC_EC_SIZE_COMPRESSED;             // Alice 预签名 pi.a|pi.b
@@ -2324,36 +2270,11 @@ int payment_init_handler(tumbler_state_t state, void *socket, uint8_t *data) {
       }
       ec_write_bin(packed + poff, RLC_EC_SIZE_COMPRESSED, g_alpha_beta_tau, 1); poff += RLC_EC_SIZE_COMPRESSED;
       // 2) ctx_alpha_times_beta_times_tau c1|c2 (使用长度前缀)
-      {
-        char *s1 = GENtostr(ctx_alpha_times_beta_times_tau->c1);
-        char *s2 = GENtostr(ctx_alpha_times_beta_times_tau->c2);
-        size_t len1 = strlen(s1);
-        size_t len2 = strlen(s2);
-        printf("[TUMBLER][PACK] ctx_alpha_times_beta_times_tau:\n");
-        printf("  - c1 len=%zu, head32: %.32s\n", len1, s1);
-        printf("  - c2 len=%zu, head32: %.32s\n", len2, s2);
-        
-        // 写入c1长度和数据
-        memcpy(packed + poff, &len1, sizeof(size_t)); poff += sizeof(size_t);
-        memcpy(packed + poff, s1, len1); poff += len1;
-        // 写入c2长度和数据
-        memcpy(packed + poff, &len2, sizeof(size_t)); poff += sizeof(size_t);
-        memcpy(packed + poff, s2, len2); poff += len2;
-      }
       // 3) auditor (+tau) (使用长度前缀)
-      {
-        size_t aud_len1 = strlen(auditor_c1_final_str);
-        size_t aud_len2 = strlen(auditor_c2_final_str);
-        printf("[TUMBLER][PACK] auditor_final:\n");
-        printf("  - c1 len=%zu, head32: %.32s\n", aud_len1, auditor_c1_final_str);
-        printf("  - c2 len=%zu, head32: %.32s\n", aud_len2, auditor_c2_final_str);
-        
-        // 写入auditor c1长度和数据
-        memcpy(packed + poff, &aud_len1, sizeof(size_t)); poff += sizeof(size_t);
-        memcpy(packed + poff, auditor_c1_final_str, aud_len1); poff += aud_len1;
-        // 写入auditor c2长度和数据
-        memcpy(packed + poff, &aud_len2, sizeof(size_t)); poff += sizeof(size_t);
-        memcpy(packed + poff, auditor_c2_final_str, aud_len2); poff += aud_len2;
+      if (pack_ct_prefixed(packed, total_len, &poff, ctx_alpha_times_beta_times_tau) != RLC_OK
+          || pack_ct_prefixed(packed, total_len, &poff, auditor_ctx_alpha_times_beta_times_tau) != RLC_OK) {
+        free(packed);
+        RLC_THROW(ERR_CAUGHT);
       }
       // 4) Alice 完整预签名结构：r|s|R|pi.a|pi.b|pi.z
       // 调试：检查完整预签名结构是否有效
@@ -2406,64 +2327,13 @@ int payment_init_handler(tumbler_state_t state, void *socket, uint8_t *data) {
       printf("[TUMBLER][SECRET_SHARE_1] 序列化 g^(α+β)，当前offset: %zu\n", poff);
       
       // 2. 序列化 ctx_α+β (从Bob收到的Tumbler密文)
-      {
-        char *s1 = GENtostr(state->alice_ctx_alpha_times_beta->c1);
-        char *s2 = GENtostr(state->alice_ctx_alpha_times_beta->c2);
-        size_t l1 = strlen(s1), l2 = strlen(s2);
-        size_t ctx_alpha_beta_start_offset = poff;
-        uint8_t *d1 = packed + poff;
-        uint8_t *d2 = packed + poff + RLC_CL_CIPHERTEXT_SIZE;
-        
-        printf("[TUMBLER][SECRET_SHARE_1][DEBUG] ctx_α+β serialization:\n");
-        printf("  - Actual data length: c1=%zu bytes, c2=%zu bytes\n", l1, l2);
-        printf("  - Allocated size: %d bytes per component (total %d bytes)\n", 
-               RLC_CL_CIPHERTEXT_SIZE, 2 * RLC_CL_CIPHERTEXT_SIZE);
-        printf("  - Padding size: c1=%zu bytes, c2=%zu bytes\n", 
-               (l1 < RLC_CL_CIPHERTEXT_SIZE) ? (RLC_CL_CIPHERTEXT_SIZE - l1) : 0,
-               (l2 < RLC_CL_CIPHERTEXT_SIZE) ? (RLC_CL_CIPHERTEXT_SIZE - l2) : 0);
-        
-        memset(d1, 0, RLC_CL_CIPHERTEXT_SIZE);
-        memset(d2, 0, RLC_CL_CIPHERTEXT_SIZE);
-        if (l1 > RLC_CL_CIPHERTEXT_SIZE - 1) l1 = RLC_CL_CIPHERTEXT_SIZE - 1;
-        if (l2 > RLC_CL_CIPHERTEXT_SIZE - 1) l2 = RLC_CL_CIPHERTEXT_SIZE - 1;
-        memcpy(d1, s1, l1);
-        memcpy(d2, s2, l2);
-        poff += 2 * RLC_CL_CIPHERTEXT_SIZE;
-        printf("[TUMBLER][SECRET_SHARE_1] 序列化 ctx_α+β，当前offset: %zu (start: %zu, allocated: %d bytes)\n", 
-               poff, ctx_alpha_beta_start_offset, 2 * RLC_CL_CIPHERTEXT_SIZE);
-        printf("[TUMBLER][SECRET_SHARE_1][DEBUG] ctx_α+β occupies bytes %zu-%zu (actual data: %zu bytes, padding: %zu bytes)\n",
-               ctx_alpha_beta_start_offset, poff - 1, l1 + l2, (2 * RLC_CL_CIPHERTEXT_SIZE) - (l1 + l2));
-      }
-      
       // 3. 序列化 auditor_ctx_α+β (从Bob收到的Auditor密文)
-      {
-        char *s1 = GENtostr(state->alice_auditor_ctx_alpha_times_beta->c1);
-        char *s2 = GENtostr(state->alice_auditor_ctx_alpha_times_beta->c2);
-        size_t l1 = strlen(s1), l2 = strlen(s2);
-        size_t auditor_ctx_alpha_beta_start_offset = poff;
-        uint8_t *d1 = packed + poff;
-        uint8_t *d2 = packed + poff + RLC_CL_CIPHERTEXT_SIZE;
-        
-        printf("[TUMBLER][SECRET_SHARE_1][DEBUG] auditor_ctx_α+β serialization:\n");
-        printf("  - Actual data length: c1=%zu bytes, c2=%zu bytes\n", l1, l2);
-        printf("  - Allocated size: %d bytes per component (total %d bytes)\n", 
-               RLC_CL_CIPHERTEXT_SIZE, 2 * RLC_CL_CIPHERTEXT_SIZE);
-        printf("  - Padding size: c1=%zu bytes, c2=%zu bytes\n", 
-               (l1 < RLC_CL_CIPHERTEXT_SIZE) ? (RLC_CL_CIPHERTEXT_SIZE - l1) : 0,
-               (l2 < RLC_CL_CIPHERTEXT_SIZE) ? (RLC_CL_CIPHERTEXT_SIZE - l2) : 0);
-        
-        memset(d1, 0, RLC_CL_CIPHERTEXT_SIZE);
-        memset(d2, 0, RLC_CL_CIPHERTEXT_SIZE);
-        if (l1 > RLC_CL_CIPHERTEXT_SIZE - 1) l1 = RLC_CL_CIPHERTEXT_SIZE - 1;
-        if (l2 > RLC_CL_CIPHERTEXT_SIZE - 1) l2 = RLC_CL_CIPHERTEXT_SIZE - 1;
-        memcpy(d1, s1, l1);
-        memcpy(d2, s2, l2);
-        poff += 2 * RLC_CL_CIPHERTEXT_SIZE;
-        printf("[TUMBLER][SECRET_SHARE_1] 序列化 auditor_ctx_α+β，当前offset: %zu (start: %zu, allocated: %d bytes)\n", 
-               poff, auditor_ctx_alpha_beta_start_offset, 2 * RLC_CL_CIPHERTEXT_SIZE);
-        printf("[TUMBLER][SECRET_SHARE_1][DEBUG] auditor_ctx_α+β occupies bytes %zu-%zu (actual data: %zu bytes, padding: %zu bytes)\n",
-               auditor_ctx_alpha_beta_start_offset, poff - 1, l1 + l2, (2 * RLC_CL_CIPHERTEXT_SIZE) - (l1 + l2));
+      if (cl_codec_write_ct(packed, &poff, state->alice_ctx_alpha_times_beta) != RLC_OK
+          || cl_codec_write_ct(packed, &poff, state->alice_auditor_ctx_alpha_times_beta) != RLC_OK) {
+        free(packed);
+        RLC_THROW(ERR_CAUGHT);
       }
+      printf("[TUMBLER][SECRET_SHARE_1] 序列化 ctx_α+β 与 auditor_ctx_α+β，当前offset: %zu\n", poff);
       
       // 4. 序列化Alice的零知识证明
       printf("[TUMBLER][SECRET_SHARE_1] 开始序列化Alice的零知识证明...\n");
@@ -2492,7 +2362,8 @@ int payment_init_handler(tumbler_state_t state, void *socket, uint8_t *data) {
       printf("\n");
       
       // 检查Alice预签名位置的数据
-      size_t presig_offset = 33 + 6000; // g^abt + 两个密文
+      size_t presig_offset = RLC_EC_SIZE_COMPRESSED + pack_ct_prefixed_size(ctx_alpha_times_beta_times_tau)
+                             + pack_ct_prefixed_size(auditor_ctx_alpha_times_beta_times_tau); // g^abt + 两个密文
       printf("  - Alice预签名偏移: %zu\n", presig_offset);
       printf("  - Alice预签名r位置数据: ");
       for (int i = 0; i < 16 && (presig_offset + i) < poff; i++) {
@@ -2502,6 +2373,9 @@ int payment_init_handler(tumbler_state_t state, void *socket, uint8_t *data) {
       
       // 计算需要的分享数组大小（num_blocks * SECRET_SHARES）
       size_t num_blocks = (poff + BLOCK_SIZE - 1) / BLOCK_SIZE;
+      // 混合模式（A2L_SHARE_MODE=hybrid）只分享对称密钥，载荷加密后随分片发送
+      int hybrid = share_mode_hybrid();
+      if (hybrid && num_blocks < SHARE_KEY_BLOCKS) num_blocks = SHARE_KEY_BLOCKS;
       size_t max_shares = num_blocks * SECRET_SHARES;
       secret_share_t* shares = (secret_share_t*)malloc(sizeof(secret_share_t) * max_shares);
       if (shares == NULL) {
@@ -2584,14 +2458,19 @@ int payment_init_handler(tumbler_state_t state, void *socket, uint8_t *data) {
       }
       
       size_t num_shares = 0;
-      int ss = create_secret_shares(packed, poff, shares, &num_shares);
+      uint8_t* envelope = NULL;
+      size_t envelope_len = 0;
+      vss_commitment_t commitment;
+      int ss = hybrid
+        ? create_hybrid_shares(packed, poff, state->alice_escrow_tx_hash, shares, &num_shares, &commitment,
+                               &envelope, &envelope_len)
+        : create_secret_shares(packed, poff, shares, &num_shares);
       if (ss != 0) {
         printf("[SecretShare][Tumbler] create_secret_shares failed=%d\n", ss);
         free(shares);
       } else {
         printf("[SecretShare][Tumbler] Created %zu shares\n", num_shares);
-        // ===== VSS: 创建并发送承诺给 Auditor =====
-        vss_commitment_t commitment;
+        // ===== VSS: 创建并发送承诺给 Auditor（混合模式下承诺已随密钥分享创建） =====
         printf("[VSS][Tumbler] DEBUG: state->alice_escrow_tx_hash = '%s' (length: %zu)\n", 
                state->alice_escrow_tx_hash, strlen(state->alice_escrow_tx_hash));
         
@@ -2603,7 +2482,7 @@ int payment_init_handler(tumbler_state_t state, void *socket, uint8_t *data) {
         }
         commitment.msgid[MSG_ID_MAXLEN - 1] = '\0';
         
-        if (create_vss_commitments(packed, poff, shares, &commitment, state->alice_escrow_tx_hash) == 0) {
+        if (hybrid || create_vss_commitments(packed, poff, shares, &commitment, state->alice_escrow_tx_hash) == 0) {
           printf("[VSS][Tumbler] Created VSS commitments for first share\n");
           if (save_vss_commitment_to_file(&commitment) == 0) {
             printf("[VSS][Tumbler] Successfully saved VSS commitment to file\n");
@@ -2629,11 +2508,16 @@ int payment_init_handler(tumbler_state_t state, void *socket, uint8_t *data) {
           endpoint_ptrs[i] = RECEIVER_ENDPOINTS[i];
         }
         
-        if (send_shares_to_receivers(shares, num_shares, state->alice_escrow_tx_hash, endpoint_ptrs) != 0) {
+        int sent = hybrid
+          ? send_hybrid_shares_to_receivers(shares, num_shares, envelope, envelope_len,
+                                            state->alice_escrow_tx_hash, endpoint_ptrs)
+          : send_shares_to_receivers(shares, num_shares, state->alice_escrow_tx_hash, endpoint_ptrs);
+        if (sent != 0) {
           printf("[SecretShare][Tumbler] send_shares_to_receivers encountered warnings\n");
         } else {
           printf("[SecretShare][Tumbler] Shares sent using msgid=%s\n", state->alice_escrow_tx_hash);
         }
+        free(envelope);
         free(shares);
       }
       free(packed);
@@ -2749,35 +2633,17 @@ int layered_proof_share_handler(tumbler_state_t state, void *socket, uint8_t *da
     // outer proof (CLDL)
     printf("[TUMBLER DEBUG] 开始读取 proof_encryption (CLDL)，偏移: %zu\n", off);
     {
-      char buf[RLC_CLDL_PROOF_T1_SIZE + 1];
-      printf("[TUMBLER DEBUG] 读取 proof_encryption->t1，偏移: %zu\n", off);
-      memcpy(buf, data + off, RLC_CLDL_PROOF_T1_SIZE); buf[RLC_CLDL_PROOF_T1_SIZE] = 0; off += RLC_CLDL_PROOF_T1_SIZE;
-      cp->proof_encryption->t1 = gp_read_str(buf);
-      printf("[TUMBLER DEBUG] proof_encryption->t1 读取成功，新偏移: %zu\n", off);
-      
-      printf("[TUMBLER DEBUG] 读取 proof_encryption->t2 (EC点)，偏移: %zu\n", off);
-      printf("[TUMBLER DEBUG] t2数据前16字节: ");
-      for (int i = 0; i < 16 && i < RLC_EC_SIZE_COMPRESSED; i++) {
-        printf("%02x", data[off + i]);
-      }
-      printf("\n");
+      cp->proof_encryption->t1 = cl_codec_read(data + off, RLC_CLDL_PROOF_T1_SIZE, state->cl_params); off += RLC_CLDL_PROOF_T1_SIZE;
       ec_read_bin(cp->proof_encryption->t2, data + off, RLC_EC_SIZE_COMPRESSED); off += RLC_EC_SIZE_COMPRESSED;
-      printf("[TUMBLER DEBUG] proof_encryption->t2 读取成功，新偏移: %zu\n", off);
-      
-      printf("[TUMBLER DEBUG] 读取 proof_encryption->t3，偏移: %zu\n", off);
-      memcpy(buf, data + off, RLC_CLDL_PROOF_T3_SIZE); buf[RLC_CLDL_PROOF_T3_SIZE] = 0; off += RLC_CLDL_PROOF_T3_SIZE;
-      cp->proof_encryption->t3 = gp_read_str(buf);
-      printf("[TUMBLER DEBUG] proof_encryption->t3 读取成功，新偏移: %zu\n", off);
-      
-      printf("[TUMBLER DEBUG] 读取 proof_encryption->u1，偏移: %zu\n", off);
-      memcpy(buf, data + off, RLC_CLDL_PROOF_U1_SIZE); buf[RLC_CLDL_PROOF_U1_SIZE] = 0; off += RLC_CLDL_PROOF_U1_SIZE;
-      cp->proof_encryption->u1 = gp_read_str(buf);
-      printf("[TUMBLER DEBUG] proof_encryption->u1 读取成功，新偏移: %zu\n", off);
-      
-      printf("[TUMBLER DEBUG] 读取 proof_encryption->u2，偏移: %zu\n", off);
-      memcpy(buf, data + off, RLC_CLDL_PROOF_U2_SIZE); buf[RLC_CLDL_PROOF_U2_SIZE] = 0; off += RLC_CLDL_PROOF_U2_SIZE;
-      cp->proof_encryption->u2 = gp_read_str(buf);
-      printf("[TUMBLER DEBUG] proof_encryption->u2 读取成功，新偏移: %zu\n", off);
+      cp->proof_encryption->t3 = cl_codec_read(data + off, RLC_CLDL_PROOF_T3_SIZE, state->cl_params); off += RLC_CLDL_PROOF_T3_SIZE;
+      cp->proof_encryption->u1 = cl_codec_read(data + off, RLC_CLDL_PROOF_U1_SIZE, state->cl_params); off += RLC_CLDL_PROOF_U1_SIZE;
+      cp->proof_encryption->u2 = cl_codec_read(data + off, RLC_CLDL_PROOF_U2_SIZE, state->cl_params); off += RLC_CLDL_PROOF_U2_SIZE;
+      if (cp->proof_encryption->t1 == NULL || cp->proof_encryption->t3 == NULL
+          || cp->proof_encryption->u1 == NULL || cp->proof_encryption->u2 == NULL) {
+        printf("[TUMBLER ERROR] proof_encryption 解码失败\n");
+        RLC_THROW(ERR_CAUGHT);
+      }
+      printf("[TUMBLER DEBUG] proof_encryption 读取成功，新偏移: %zu\n", off);
     }
 
     // tag_hash = H(inner)
@@ -2788,33 +2654,16 @@ int layered_proof_share_handler(tumbler_state_t state, void *socket, uint8_t *da
     // 新增：ct_beta（β）
     printf("[TUMBLER DEBUG] 读取 ct_beta，偏移: %zu\n", off);
     cl_ciphertext_t ct_beta; cl_ciphertext_new(ct_beta);
-    {
-      char buf[RLC_CL_CIPHERTEXT_SIZE + 1];
-      printf("[TUMBLER DEBUG] 读取 ct_beta->c1，偏移: %zu\n", off);
-      memcpy(buf, data + off, RLC_CL_CIPHERTEXT_SIZE); buf[RLC_CL_CIPHERTEXT_SIZE] = 0; off += RLC_CL_CIPHERTEXT_SIZE;
-      ct_beta->c1 = gp_read_str(buf);
-      printf("[TUMBLER DEBUG] ct_beta->c1 读取成功，新偏移: %zu\n", off);
-      
-      printf("[TUMBLER DEBUG] 读取 ct_beta->c2，偏移: %zu\n", off);
-      memcpy(buf, data + off, RLC_CL_CIPHERTEXT_SIZE); buf[RLC_CL_CIPHERTEXT_SIZE] = 0; off += RLC_CL_CIPHERTEXT_SIZE;
-      ct_beta->c2 = gp_read_str(buf);
-      printf("[TUMBLER DEBUG] ct_beta->c2 读取成功，新偏移: %zu\n", off);
-    }
+    cl_ciphertext_t ct_beta_prime; cl_ciphertext_new(ct_beta_prime);
+    int ct_ok = cl_codec_read_ct(ct_beta, data, &off, state->cl_params);
 
     // inner 密文（β'）
     printf("[TUMBLER DEBUG] 读取 ct_beta_prime，偏移: %zu\n", off);
-    cl_ciphertext_t ct_beta_prime; cl_ciphertext_new(ct_beta_prime);
-    {
-      char buf[RLC_CL_CIPHERTEXT_SIZE + 1];
-      printf("[TUMBLER DEBUG] 读取 ct_beta_prime->c1，偏移: %zu\n", off);
-      memcpy(buf, data + off, RLC_CL_CIPHERTEXT_SIZE); buf[RLC_CL_CIPHERTEXT_SIZE] = 0; off += RLC_CL_CIPHERTEXT_SIZE;
-      ct_beta_prime->c1 = gp_read_str(buf);
-      printf("[TUMBLER DEBUG] ct_beta_prime->c1 读取成功，新偏移: %zu\n", off);
-      
-      printf("[TUMBLER DEBUG] 读取 ct_beta_prime->c2，偏移: %zu\n", off);
-      memcpy(buf, data + off, RLC_CL_CIPHERTEXT_SIZE); buf[RLC_CL_CIPHERTEXT_SIZE] = 0; off += RLC_CL_CIPHERTEXT_SIZE;
-      ct_beta_prime->c2 = gp_read_str(buf);
-      printf("[TUMBLER DEBUG] ct_beta_prime->c2 读取成功，新偏移: %zu\n", off);
+    if (cl_codec_read_ct(ct_beta_prime, data, &off, state->cl_params) != RLC_OK || ct_ok != RLC_OK) {
+      printf("[TUMBLER ERROR] ct_beta / ct_beta_prime 解码失败\n");
+      cl_ciphertext_free(ct_beta);
+      cl_ciphertext_free(ct_beta_prime);
+      RLC_THROW(ERR_CAUGHT);
     }
 
     // 跳过 outer 占位符（不解析为密文）
@@ -2967,9 +2816,22 @@ int layered_proof_share_handler(tumbler_state_t state, void *socket, uint8_t *da
   return result_status;
 }
 
+static int tumbler_default_cl_threads(int tumbler_workers) {
+#if !TIGER_MT_ENABLED
+  // 池在这种构建下无法启动，默认不尝试，避免每次启动都打印告警
+  (void) tumbler_workers;
+  return 0;
+#else
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  long threads = (cpus > tumbler_workers) ? cpus - tumbler_workers : 0;
+  return (int) ((threads > CL_WORKER_POOL_MAX_THREADS) ? CL_WORKER_POOL_MAX_THREADS : threads);
+#endif
+}
+
 int main(int argc,char* argv[])
 {
   int tumbler_port = 8181;  // 默认端口
+  int tumbler_workers = TUMBLER_DEFAULT_WORKERS;
   char tumbler_endpoint[64];
 
   // 解析命令行参数
@@ -2977,11 +2839,34 @@ int main(int argc,char* argv[])
     tumbler_port = atoi(argv[1]);
     if (tumbler_port <= 0 || tumbler_port > 65535) {
       fprintf(stderr, "Error: Invalid port number. Port must be between 1 and 65535.\n");
-      fprintf(stderr, "Usage: %s [port]\n", argv[0]);
+      fprintf(stderr, "Usage: %s [port] [workers]\n", argv[0]);
       fprintf(stderr, "Default port: 8181\n");
       return 1;
     }
   }
+  if (argc > 2) {
+    tumbler_workers = atoi(argv[2]);
+    if (tumbler_workers <= 0 || tumbler_workers > TUMBLER_MAX_WORKERS) {
+      fprintf(stderr, "Error: Invalid worker count. Must be between 1 and %d.\n", TUMBLER_MAX_WORKERS);
+      fprintf(stderr, "Usage: %s [port] [workers] [cl_threads]\n", argv[0]);
+      return 1;
+    }
+  }
+  // 类群运算线程池大小，默认用满工作线程之外剩余的核
+  const int cl_threads = (argc > 3) ? atoi(argv[3]) : tumbler_default_cl_threads(tumbler_workers);
+  if (cl_threads < 0 || cl_threads > CL_WORKER_POOL_MAX_THREADS) {
+    fprintf(stderr, "Error: Invalid CL thread count. Must be between 0 and %d.\n", CL_WORKER_POOL_MAX_THREADS);
+    fprintf(stderr, "Usage: %s [port] [workers] [cl_threads]\n", argv[0]);
+    return 1;
+  }
+#if !TIGER_MT_ENABLED
+  if (tumbler_workers > 1) {
+    tiger_mt_warn("只使用 1 个工作线程");
+    tumbler_workers = 1;
+  }
+#endif
+  // 下面的 RLC_TRY 中只使用这个不再改变的副本（tumbler_workers 会被 longjmp 破坏）
+  const size_t n_workers = (size_t) tumbler_workers;
 
   // 构建端点字符串
   snprintf(tumbler_endpoint, sizeof(tumbler_endpoint), "tcp://*:%d", tumbler_port);
@@ -2989,6 +2874,8 @@ int main(int argc,char* argv[])
   printf("[TUMBLER] 启动参数:\n");
   printf("  port: %d\n", tumbler_port);
   printf("  endpoint: %s\n", tumbler_endpoint);
+  printf("  workers: %zu\n", n_workers);
+  printf("  cl_threads: %d\n", cl_threads);
   printf("[TUMBLER] 开始启动...\n");
   srand((unsigned int)time(NULL));
 
@@ -3005,7 +2892,7 @@ int main(int argc,char* argv[])
     exit(1);
   }
   
-  void *socket = zmq_socket(context, ZMQ_REP);
+  void *socket = zmq_socket(context, ZMQ_ROUTER);
   if (!socket) {
     fprintf(stderr, "Error: could not create a socket.\n");
     exit(1);
@@ -3017,6 +2904,9 @@ int main(int argc,char* argv[])
     exit(1);
   }
 
+  signal(SIGINT, tumbler_signal_handler);
+  signal(SIGTERM, tumbler_signal_handler);
+
   // 初始化全局时间测量
   if (!tumbler_timing_initialized) {
     clock_gettime(CLOCK_MONOTONIC, &tumbler_start_time);
@@ -3142,19 +3032,54 @@ int main(int argc,char* argv[])
     }
     END_TIMER(tumbler_initialization_computation)
 
-    printf("[TUMBLER] 开始监听消息...\n");
-    while (!tumbler_should_exit) {
-      printf("[TUMBLER] 等待消息...\n");
-      if (receive_message(state, socket) != RLC_OK) {
-        printf("[TUMBLER] 消息接收失败\n");
-        RLC_THROW(ERR_CAUGHT);
-      }
+    // 为 Tumbler 与审计员公钥预计算 CL 加密随机数，promise 阶段的 cl_enc 只剩一次合成
+    if (cl_enc_pool_start(state->cl_params) == RLC_OK) {
+      cl_enc_pool_register(state->tumbler_cl_pk);
+      cl_enc_pool_register(state->auditor_cl_pk);
+    }
+
+    // Groth16 验证密钥只在启动时载入一次
+    const char *vkey_path = getenv("A2L_GROTH16_VKEY");
+    if (vkey_path == NULL || vkey_path[0] == '\0') vkey_path = TUMBLER_GROTH16_VKEY;
+    if (groth16_vk_load(&tumbler_groth16_vk, vkey_path) == RLC_OK) {
+      tumbler_groth16_vk_loaded = 1;
+      printf("[TUMBLER] 已载入 Groth16 验证密钥 %s（%zu 个公开输入）\n", vkey_path, tumbler_groth16_vk.n_public);
+    } else {
+      fprintf(stderr, "[WARNING] 无法载入 Groth16 验证密钥 %s，所有提款证明都将被拒绝\n", vkey_path);
+    }
+
+    // 已使用的 nullifier 只在启动时载入一次
+    tumbler_nullifiers = nullifier_set_open(TUMBLER_NULLIFIER_LOG, TUMBLER_NULLIFIER_SNAPSHOT);
+    if (tumbler_nullifiers == NULL) {
+      // 没有可靠的已用 nullifier 集合就无法防止双重花费，拒绝启动
+      fprintf(stderr, "Error: could not open the nullifier index %s / %s.\n",
+              TUMBLER_NULLIFIER_LOG, TUMBLER_NULLIFIER_SNAPSHOT);
+      RLC_THROW(ERR_CAUGHT);
+    }
+    printf("[TUMBLER] 已载入 %zu 个已使用的 nullifierHash\n", nullifier_set_size(tumbler_nullifiers));
+
+    // 验证中互相独立的类群等式分发到线程池，工作线程不再独占一个核做全部类群运算
+    if (cl_threads > 0 && cl_worker_pool_start((size_t) cl_threads) != RLC_OK) {
+      printf("[WARN] 类群运算线程池启动失败，验证在工作线程内串行执行\n");
+    }
+
+    // state 作为只读模板，每个会话从中复制长期密钥
+    if (tumbler_serve(context, socket, state, n_workers) != RLC_OK) {
+      printf("[TUMBLER] 消息服务异常退出\n");
+      RLC_THROW(ERR_CAUGHT);
     }
     
     printf("[TUMBLER] 分片发送完成，程序即将退出\n");
   } RLC_CATCH_ANY {
     result_status = RLC_ERR;
   } RLC_FINALLY {
+    cl_worker_pool_stop();
+    cl_enc_pool_stop();
+    nullifier_set_close(tumbler_nullifiers);
+    tumbler_nullifiers = NULL;
+    escrow_client_shared_close();
+    http_client_shutdown();
+    share_dispatch_shutdown(0);
     tumbler_state_free(state);
   }
 
@@ -4,6 +4,7 @@
 #include <string.h>
 #include <time.h>
 #include <sys/time.h>
+#include <pthread.h>
 #include "/home/zxx/Config/relic/include/relic.h"
 #include "pari/pari.h"
 #include "types.h"
@@ -219,9 +220,18 @@ int zk_sigma_link_verify(
     printf("[ZK LINK] C_r2.c1 head: %.4s | C_r2.c2 head: %.4s\n", GENtostr(proof->C_r2->c1), GENtostr(proof->C_r2->c2));
     printf("[ZK LINK] sigma'.c1 head: %.4s | sigma'.c2 head: %.4s\n", GENtostr(sigma_prime->c1), GENtostr(sigma_prime->c2));
     printf("[ZK LINK] beta'' .c1 head: %.4s | beta'' .c2 head: %.4s\n", GENtostr(beta_double_prime->c1), GENtostr(beta_double_prime->c2));
-    if (zk_cldl_verify(proof->pi_m, NULL, proof->C_m, pk1, params) != RLC_OK) { printf("[ZK LINK] pi_m verify failed\n"); RLC_THROW(ERR_CAUGHT);} else { printf("[ZK LINK] pi_m OK\n"); }
-    if (zk_cldl_verify(proof->pi_r2, NULL, proof->C_r2, pk1, params) != RLC_OK) { printf("[ZK LINK] pi_r2 verify failed\n"); RLC_THROW(ERR_CAUGHT);} else { printf("[ZK LINK] pi_r2 OK\n"); }
-    if (zk_cldl_verify(proof->pi_sigma, NULL, sigma_prime, pk2, params) != RLC_OK) { printf("[ZK LINK] pi_sigma verify failed\n"); RLC_THROW(ERR_CAUGHT);} else { printf("[ZK LINK] pi_sigma OK\n"); }
+    // pi_m、pi_r2（针对 pk1）与 pi_sigma（针对 pk2）合并为一次批量验证
+    {
+      const zk_proof_cldl_t link_proofs[3] = { proof->pi_m, proof->pi_r2, proof->pi_sigma };
+      const cl_ciphertext_t link_cts[3] = { proof->C_m, proof->C_r2, sigma_prime };
+      const cl_public_key_t link_pks[3] = { pk1, pk1, pk2 };
+      int link_results[3];
+      if (zk_cldl_verify_batch(link_proofs, NULL, link_cts, 3, link_pks, params, link_results) != RLC_OK) {
+        printf("[ZK LINK] pi_m %s, pi_r2 %s, pi_sigma %s\n", link_results[0] == RLC_OK ? "OK" : "verify failed",
+               link_results[1] == RLC_OK ? "OK" : "verify failed", link_results[2] == RLC_OK ? "OK" : "verify failed");
+        RLC_THROW(ERR_CAUGHT);
+      } else { printf("[ZK LINK] pi_m OK\n"); printf("[ZK LINK] pi_r2 OK\n"); printf("[ZK LINK] pi_sigma OK\n"); }
+    }
     // 取消密文层等式校验：该关系改由承诺层 zk_commit_link 验证
     printf("[ZK LINK] verify OK (CLDL-only, relation checked by commitment layer)\n");
   } RLC_CATCH_ANY {
@@ -231,142 +241,48 @@ int zk_sigma_link_verify(
 }
 
 // ===== 序列化辅助 =====
+// 密文与 CLDL 证明都按 cl_codec 的固定槽位写入，接收方无需经过 PARI 解析器
 static inline void write_ct_fixed(uint8_t *dst, size_t *off, const cl_ciphertext_t ct) {
-  char *s1 = GENtostr(ct->c1); char *s2 = GENtostr(ct->c2);
-  size_t l1 = strlen(s1), l2 = strlen(s2);
-  memset(dst + *off, 0, RLC_CL_CIPHERTEXT_SIZE);
-  memcpy(dst + *off, s1, (l1 > RLC_CL_CIPHERTEXT_SIZE - 1) ? (RLC_CL_CIPHERTEXT_SIZE - 1) : l1);
-  *off += RLC_CL_CIPHERTEXT_SIZE;
-  memset(dst + *off, 0, RLC_CL_CIPHERTEXT_SIZE);
-  memcpy(dst + *off, s2, (l2 > RLC_CL_CIPHERTEXT_SIZE - 1) ? (RLC_CL_CIPHERTEXT_SIZE - 1) : l2);
-  *off += RLC_CL_CIPHERTEXT_SIZE;
+  cl_codec_write_ct(dst, off, ct);
 }
 
-static inline void read_ct_fixed(cl_ciphertext_t ct, const uint8_t *src, size_t *off) {
-  char b1[RLC_CL_CIPHERTEXT_SIZE + 1];
-  char b2[RLC_CL_CIPHERTEXT_SIZE + 1];
-  memcpy(b1, src + *off, RLC_CL_CIPHERTEXT_SIZE); b1[RLC_CL_CIPHERTEXT_SIZE] = 0; *off += RLC_CL_CIPHERTEXT_SIZE;
-  memcpy(b2, src + *off, RLC_CL_CIPHERTEXT_SIZE); b2[RLC_CL_CIPHERTEXT_SIZE] = 0; *off += RLC_CL_CIPHERTEXT_SIZE;
-  ct->c1 = gp_read_str(b1);
-  ct->c2 = gp_read_str(b2);
+static inline void read_ct_fixed(cl_ciphertext_t ct, const uint8_t *src, size_t *off, const cl_params_t params) {
+  cl_codec_read_ct(ct, src, off, params);
 }
 
 static inline size_t cldl_proof_size_fixed() {
-  // 注意：这个函数现在返回的是最小大小，实际大小可能更大
-  // 因为使用了长度前缀格式，实际大小取决于数据内容
-  return sizeof(size_t) * 4 + RLC_EC_SIZE_COMPRESSED; // 4个长度前缀 + 椭圆曲线点
+  return RLC_CLDL_PROOF_T1_SIZE + RLC_EC_SIZE_COMPRESSED + RLC_CLDL_PROOF_T3_SIZE
+       + RLC_CLDL_PROOF_U1_SIZE + RLC_CLDL_PROOF_U2_SIZE;
 }
 
 static inline void write_cldl_fixed(uint8_t *dst, size_t *off, const zk_proof_cldl_t pi) {
-  // 写入t1 (使用长度前缀格式)
-  const char *t1_str = GENtostr(pi->t1);
-  size_t t1_len = strlen(t1_str);
-  memcpy(dst + *off, &t1_len, sizeof(size_t)); *off += sizeof(size_t);
-  memcpy(dst + *off, t1_str, t1_len); *off += t1_len;
-  
-  // 写入t2 (椭圆曲线点)
-  ec_write_bin(dst + *off, RLC_EC_SIZE_COMPRESSED, pi->t2, 1); 
+  cl_codec_write(dst + *off, RLC_CLDL_PROOF_T1_SIZE, pi->t1);
+  *off += RLC_CLDL_PROOF_T1_SIZE;
+  ec_write_bin(dst + *off, RLC_EC_SIZE_COMPRESSED, pi->t2, 1);
   *off += RLC_EC_SIZE_COMPRESSED;
-  
-  // 写入t3 (使用长度前缀格式)
-  const char *t3_str = GENtostr(pi->t3);
-  size_t t3_len = strlen(t3_str);
-  memcpy(dst + *off, &t3_len, sizeof(size_t)); *off += sizeof(size_t);
-  memcpy(dst + *off, t3_str, t3_len); *off += t3_len;
-  
-  // 写入u1 (使用长度前缀格式)
-  const char *u1_str = GENtostr(pi->u1);
-  size_t u1_len = strlen(u1_str);
-  memcpy(dst + *off, &u1_len, sizeof(size_t)); *off += sizeof(size_t);
-  memcpy(dst + *off, u1_str, u1_len); *off += u1_len;
-  
-  // 写入u2 (使用长度前缀格式)
-  const char *u2_str = GENtostr(pi->u2);
-  size_t u2_len = strlen(u2_str);
-  memcpy(dst + *off, &u2_len, sizeof(size_t)); *off += sizeof(size_t);
-  memcpy(dst + *off, u2_str, u2_len); *off += u2_len;
+  cl_codec_write(dst + *off, RLC_CLDL_PROOF_T3_SIZE, pi->t3);
+  *off += RLC_CLDL_PROOF_T3_SIZE;
+  cl_codec_write(dst + *off, RLC_CLDL_PROOF_U1_SIZE, pi->u1);
+  *off += RLC_CLDL_PROOF_U1_SIZE;
+  cl_codec_write(dst + *off, RLC_CLDL_PROOF_U2_SIZE, pi->u2);
+  *off += RLC_CLDL_PROOF_U2_SIZE;
 }
 
-static inline void read_cldl_fixed(zk_proof_cldl_t pi, const uint8_t *src, size_t *off) {
-  // 读取t1 (使用长度前缀格式)
-  size_t t1_len;
-  memcpy(&t1_len, src + *off, sizeof(size_t)); *off += sizeof(size_t);
-  
-  // 检查长度是否合理（防止异常大的值）
-  if (t1_len > 10000) {
-    return;
-  }
-  
-  char *b1 = (char*)malloc(t1_len + 1);
-  if (!b1) {
-    return;
-  }
-  memcpy(b1, src + *off, t1_len); 
-  b1[t1_len] = 0; 
-  *off += t1_len; 
-  pi->t1 = gp_read_str(b1);
-  free(b1);
-  
-  // 读取t2 (椭圆曲线点)
-  ec_read_bin(pi->t2, src + *off, RLC_EC_SIZE_COMPRESSED); 
+static inline void read_cldl_fixed(zk_proof_cldl_t pi, const uint8_t *src, size_t *off, const cl_params_t params) {
+  pi->t1 = cl_codec_read(src + *off, RLC_CLDL_PROOF_T1_SIZE, params);
+  *off += RLC_CLDL_PROOF_T1_SIZE;
+  ec_read_bin(pi->t2, src + *off, RLC_EC_SIZE_COMPRESSED);
   *off += RLC_EC_SIZE_COMPRESSED;
-  
-  // 读取t3 (使用长度前缀格式)
-  size_t t3_len;
-  memcpy(&t3_len, src + *off, sizeof(size_t)); *off += sizeof(size_t);
-  
-  // 检查长度是否合理
-  if (t3_len > 10000) {
-    return;
-  }
-  
-  char *b3 = (char*)malloc(t3_len + 1);
-  if (!b3) {
-    return;
-  }
-  memcpy(b3, src + *off, t3_len); 
-  b3[t3_len] = 0; 
-  *off += t3_len; 
-  pi->t3 = gp_read_str(b3);
-  free(b3);
-  
-  // 读取u1 (使用长度前缀格式)
-  size_t u1_len;
-  memcpy(&u1_len, src + *off, sizeof(size_t)); *off += sizeof(size_t);
-  
-  // 检查长度是否合理
-  if (u1_len > 10000) {
-    return;
-  }
-  
-  char *bu1 = (char*)malloc(u1_len + 1);
-  if (!bu1) {
-    return;
-  }
-  memcpy(bu1, src + *off, u1_len); 
-  bu1[u1_len] = 0; 
-  *off += u1_len; 
-  pi->u1 = gp_read_str(bu1);
-  free(bu1);
-  
-  // 读取u2 (使用长度前缀格式)
-  size_t u2_len;
-  memcpy(&u2_len, src + *off, sizeof(size_t)); *off += sizeof(size_t);
-  
-  // 检查长度是否合理
-  if (u2_len > 10000) {
-    return;
-  }
-  
-  char *bu2 = (char*)malloc(u2_len + 1);
-  if (!bu2) {
-    return;
-  }
-  memcpy(bu2, src + *off, u2_len); 
-  bu2[u2_len] = 0; 
-  *off += u2_len; 
-  pi->u2 = gp_read_str(bu2);
-  free(bu2);
+  pi->t3 = cl_codec_read(src + *off, RLC_CLDL_PROOF_T3_SIZE, params);
+  *off += RLC_CLDL_PROOF_T3_SIZE;
+  pi->u1 = cl_codec_read(src + *off, RLC_CLDL_PROOF_U1_SIZE, params);
+  *off += RLC_CLDL_PROOF_U1_SIZE;
+  pi->u2 = cl_codec_read(src + *off, RLC_CLDL_PROOF_U2_SIZE, params);
+  *off += RLC_CLDL_PROOF_U2_SIZE;
+}
+
+static inline int cldl_fixed_complete(const zk_proof_cldl_t pi) {
+  return pi->t1 != NULL && pi->t3 != NULL && pi->u1 != NULL && pi->u2 != NULL;
 }
 
 size_t zk_sigma_link_serialized_size() {
@@ -385,15 +301,19 @@ int zk_sigma_link_serialize(uint8_t *dst, size_t *written, const zk_sigma_link_p
   return RLC_OK;
 }
 
-int zk_sigma_link_deserialize(zk_sigma_link_proof_t out, const uint8_t *src, size_t *read) {
+int zk_sigma_link_deserialize(zk_sigma_link_proof_t out, const uint8_t *src, size_t *read, const cl_params_t params) {
   if (!src || !out || !read) return RLC_ERR;
   size_t off = 0;
-  read_ct_fixed(out->C_m, src, &off);
-  read_ct_fixed(out->C_r2, src, &off);
-  zk_proof_cldl_new(out->pi_m); read_cldl_fixed(out->pi_m, src, &off);
-  zk_proof_cldl_new(out->pi_r2); read_cldl_fixed(out->pi_r2, src, &off);
-  zk_proof_cldl_new(out->pi_sigma); read_cldl_fixed(out->pi_sigma, src, &off);
+  read_ct_fixed(out->C_m, src, &off, params);
+  read_ct_fixed(out->C_r2, src, &off, params);
+  zk_proof_cldl_new(out->pi_m); read_cldl_fixed(out->pi_m, src, &off, params);
+  zk_proof_cldl_new(out->pi_r2); read_cldl_fixed(out->pi_r2, src, &off, params);
+  zk_proof_cldl_new(out->pi_sigma); read_cldl_fixed(out->pi_sigma, src, &off, params);
   *read = off;
+  if (out->C_m->c1 == NULL || out->C_m->c2 == NULL || out->C_r2->c1 == NULL || out->C_r2->c2 == NULL
+      || !cldl_fixed_complete(out->pi_m) || !cldl_fixed_complete(out->pi_r2) || !cldl_fixed_complete(out->pi_sigma)) {
+    return RLC_ERR;
+  }
   return RLC_OK;
 }
 
@@ -742,11 +662,11 @@ int generate_keys_and_write_to_file(const cl_params_t params) {
 
 		// Compute CL encryption secret/public key pair for the tumbler.
 		cl_sk_tumbler = randomi(params->bound);
-		cl_pk_tumbler = nupow(params->g_q, cl_sk_tumbler, NULL);
+		cl_pk_tumbler = cl_gq_pow(params, cl_sk_tumbler);
 
         		// Compute CL encryption secret/public key pair for the auditor.
         		cl_sk_auditor = randomi(params->bound);
-        		cl_pk_auditor = nupow(params->g_q, cl_sk_auditor, NULL);
+        		cl_pk_auditor = cl_gq_pow(params, cl_sk_auditor);
 
 		// Compute PS secret/public key pair for the tumbler.
 		pc_get_ord(q);
@@ -1338,7 +1258,7 @@ int generate_auditor_keypair_named(const cl_params_t params, const char *basenam
   RLC_TRY {
     // 生成随机 sk 并计算 pk = g_q^sk
     GEN sk = randomi(params->bound);
-    GEN pk = nupow(params->g_q, sk, NULL);
+    GEN pk = cl_gq_pow(params, sk);
     // 目标文件 ../keys/<basename>.key
     unsigned name_len = strlen(basename) + strlen(KEY_FILE_EXTENSION) + 10;
     char *out = (char *)malloc(name_len);
@@ -1432,6 +1352,11 @@ int generate_cl_params(cl_params_t params) {
 		GEN Gx = strtoi("0x79be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798");
 		GEN Gy = strtoi("0x483ada7726a3c4655da4fbfc0e1108a8fd17b448a68554199c47d08ffb10d4b8");
 		params->G = mkvecn(2, Gx, Gy);
+
+		// g_q 的固定基表：之后所有 g_q^r 走梳形法
+		if (cl_params_precompute(params, getenv(CL_FIXED_BASE_PATH_ENV)) != RLC_OK) {
+			RLC_THROW(ERR_CAUGHT);
+		}
 	} RLC_CATCH_ANY {
 		result_status = RLC_ERR;
 	}
@@ -1446,8 +1371,13 @@ int cl_enc(cl_ciphertext_t ciphertext,
   int result_status = RLC_OK;
 
   RLC_TRY {
-    ciphertext->r = randomi(params->bound);
-    ciphertext->c1 = nupow(params->g_q, ciphertext->r, NULL);
+    // 优先使用后台池预计算的 (r, g_q^r, pk^r)，池空时在线计算
+    GEN pk_r;
+    if (cl_enc_pool_take(&ciphertext->r, &ciphertext->c1, &pk_r, public_key) != RLC_OK) {
+      ciphertext->r = randomi(params->bound);
+      ciphertext->c1 = cl_gq_pow(params, ciphertext->r);
+      pk_r = cl_pk_pow(public_key, ciphertext->r, params);
+    }
 
     GEN L = Fp_inv(plaintext, params->q);
   
@@ -1458,7 +1388,7 @@ int cl_enc(cl_ciphertext_t ciphertext,
 		// f^plaintext = (q^2, Lq, (L - Delta_k) / 4)
     GEN fm = Qfb0(sqri(params->q), mulii(L, params->q), shifti(subii(sqri(L), params->Delta_K), -2));
     
-    ciphertext->c2 = gmul(nupow(public_key->pk, ciphertext->r, NULL), fm);
+    ciphertext->c2 = gmul(pk_r, fm);
    
   } RLC_CATCH_ANY {
     result_status = RLC_ERR;
@@ -1568,15 +1498,15 @@ int cl_mul_eq_prove(cl_mul_eq_proof_t proof,
     // T1 = pk^{w_r} * f^{w_m}
     GEN fm = Qfb0(sqri(params->q), mulii(w_m, params->q), 
                   shifti(subii(sqri(w_m), params->Delta_K), -2));
-    proof->T1 = gmul(nupow(pk->pk, w_r, NULL), fm);
+    proof->T1 = gmul(cl_pk_pow(pk, w_r, params), fm);
     
     // T3 = g_q^{w_r}
-    proof->T3 = nupow(params->g_q, w_r, NULL);
+    proof->T3 = cl_gq_pow(params, w_r);
     
     // 3. 生成Fiat-Shamir挑战
     uint8_t hash_input[2 * RLC_CL_CIPHERTEXT_SIZE];
-    memcpy(hash_input, GENtostr(ct->c1), RLC_CL_CIPHERTEXT_SIZE);
-    memcpy(hash_input + RLC_CL_CIPHERTEXT_SIZE, GENtostr(ct->c2), RLC_CL_CIPHERTEXT_SIZE);
+    cl_codec_write(hash_input, RLC_CL_CIPHERTEXT_SIZE, ct->c1);
+    cl_codec_write(hash_input + RLC_CL_CIPHERTEXT_SIZE, RLC_CL_CIPHERTEXT_SIZE, ct->c2);
     
     uint8_t hash[RLC_MD_LEN];
     md_map(hash, hash_input, 2 * RLC_CL_CIPHERTEXT_SIZE);
@@ -1708,17 +1638,17 @@ int zk_cl_homomorphic_prove(zk_proof_t proof,
     uint8_t *hash_input = malloc(hash_len);
     size_t offset = 0;
     
-    memcpy(hash_input + offset, GENtostr(ct_in->c1), RLC_CL_CIPHERTEXT_SIZE);
+    cl_codec_write(hash_input + offset, RLC_CL_CIPHERTEXT_SIZE, ct_in->c1);
     offset += RLC_CL_CIPHERTEXT_SIZE;
-    memcpy(hash_input + offset, GENtostr(ct_in->c2), RLC_CL_CIPHERTEXT_SIZE);
+    cl_codec_write(hash_input + offset, RLC_CL_CIPHERTEXT_SIZE, ct_in->c2);
     offset += RLC_CL_CIPHERTEXT_SIZE;
-    memcpy(hash_input + offset, GENtostr(ct_out->c1), RLC_CL_CIPHERTEXT_SIZE);
+    cl_codec_write(hash_input + offset, RLC_CL_CIPHERTEXT_SIZE, ct_out->c1);
     offset += RLC_CL_CIPHERTEXT_SIZE;
-    memcpy(hash_input + offset, GENtostr(ct_out->c2), RLC_CL_CIPHERTEXT_SIZE);
+    cl_codec_write(hash_input + offset, RLC_CL_CIPHERTEXT_SIZE, ct_out->c2);
     offset += RLC_CL_CIPHERTEXT_SIZE;
-    memcpy(hash_input + offset, GENtostr(T1), RLC_CL_CIPHERTEXT_SIZE);
+    cl_codec_write(hash_input + offset, RLC_CL_CIPHERTEXT_SIZE, T1);
     offset += RLC_CL_CIPHERTEXT_SIZE;
-    memcpy(hash_input + offset, GENtostr(T2), RLC_CL_CIPHERTEXT_SIZE);
+    cl_codec_write(hash_input + offset, RLC_CL_CIPHERTEXT_SIZE, T2);
     
     uint8_t hash[RLC_MD_LEN];
     md_map(hash, hash_input, hash_len);
@@ -1912,6 +1842,31 @@ int complete_nizk_prove(
   return result_status;
 }
 
+// complete_nizk_verify 的子证明参数，各子证明作为线程池任务并行验证
+typedef struct {
+  complete_nizk_proof_t proof;
+  cl_ciphertext_t ct_beta;
+  cl_ciphertext_t ct_beta_prime;
+  ps_public_key_t ps_pk;
+  cl_public_key_t cl_pk1;
+  cl_public_key_t cl_pk2;
+  cl_params_t params;
+} complete_nizk_verify_arg_t;
+
+// P1: β'与β的同态关系
+static GEN complete_nizk_p1_task(void *arg) {
+  const complete_nizk_verify_arg_t *a = (const complete_nizk_verify_arg_t *) arg;
+  return (zk_cl_homomorphic_verify(a->proof->proof_homomorphic, a->ct_beta, a->ct_beta_prime,
+                                   a->cl_pk1, a->params) == RLC_OK) ? gen_1 : gen_0;
+}
+
+// 联合证明：隐藏outer (替代 P2+P3)
+static GEN complete_nizk_outer_task(void *arg) {
+  const complete_nizk_verify_arg_t *a = (const complete_nizk_verify_arg_t *) arg;
+  return (zk_outer_link_verify(a->proof, a->ct_beta_prime, a->proof->commitment_c1, a->proof->commitment_c2,
+                               a->ps_pk, a->cl_pk2, a->params) == RLC_OK) ? gen_1 : gen_0;
+}
+
 int complete_nizk_verify(
   const complete_nizk_proof_t proof,
   const cl_ciphertext_t ct_beta,
@@ -1931,17 +1886,19 @@ int complete_nizk_verify(
   int result_status = RLC_OK;
   
   RLC_TRY {
-    // ========== 验证P1: β'与β的同态关系 ==========
-    printf("[DEBUG] 验证P1：β'与β的同态关系...\n");
-    if (zk_cl_homomorphic_verify(proof->proof_homomorphic, ct_beta, ct_beta_prime, 
-                                 cl_pk1, params) != RLC_OK) {
+    // ========== 并行验证 P1 与联合证明（隐藏outer，替代 P2+P3） ==========
+    printf("[DEBUG] 验证P1（β'与β的同态关系）与联合证明（隐藏outer）...\n");
+    complete_nizk_verify_arg_t arg = { proof, ct_beta, ct_beta_prime, ps_pk, cl_pk1, cl_pk2, params };
+    cl_worker_task_t subproofs[2] = {
+      { .fn = complete_nizk_p1_task, .arg = &arg },
+      { .fn = complete_nizk_outer_task, .arg = &arg },
+    };
+    cl_worker_run(subproofs, 2);
+    if (subproofs[0].result == NULL || !gequal1(subproofs[0].result)) {
       printf("[ERROR] P1证明验证失败\n");
       RLC_THROW(ERR_CAUGHT);
     }
-    
-    // ========== 联合证明验证：隐藏outer (替代 P2+P3) ==========
-    printf("[DEBUG] 验证联合证明：隐藏outer (P2+P3) ...\n");
-    if (zk_outer_link_verify(proof, ct_beta_prime, proof->commitment_c1, proof->commitment_c2, ps_pk, cl_pk2, params) != RLC_OK) {
+    if (subproofs[1].result == NULL || !gequal1(subproofs[1].result)) {
       printf("[ERROR] 联合证明（隐藏outer）验证失败\n");
       RLC_THROW(ERR_CAUGHT);
     }
@@ -1964,10 +1921,8 @@ int complete_nizk_verify(
  * C = G^m · H^r，其中 G/H 是类群基元
  */
 GEN cl_commit_qfb(const GEN message, const GEN randomness, const GEN base_g, const GEN base_h) {
-  // C = base_g^message * base_h^randomness
-  GEN gm = nupow(base_g, message, NULL);  // G^m
-  GEN hr = nupow(base_h, randomness, NULL); // H^r
-  return gmul(gm, hr);  // G^m · H^r
+  // C = base_g^message * base_h^randomness，两个底共享平方
+  return cl_multiexp2(base_g, message, base_h, randomness);
 }
 
 /*
@@ -1993,7 +1948,7 @@ void derive_qfb_bases(GEN *base_g, GEN *base_h, const cl_params_t params, const
   }
   
   // 通过对 g_q 进行幂运算生成第二个基元（确保在同一类群中）
-  *base_h = nupow(params->g_q, seed_num, NULL);
+  *base_h = cl_gq_pow(params, seed_num);
   
   printf("[DEBUG] derive_qfb_bases: 使用 g_q 作为 base_g，通过幂运算生成 base_h\n");
 }
@@ -2062,7 +2017,7 @@ int zk_outer_link_prove(
     
     // 计算承诺 T 值
     // T_enc = pk2^w_enc （用于 Enc 等式）
-    GEN T_enc = nupow(pk2->pk, w_enc, NULL);
+    GEN T_enc = cl_pk_pow(pk2, w_enc, params);
     
     // T_c1 = G^0 · H^w_r1 = H^w_r1 （用于 C1 开口）
     GEN T_c1 = nupow(base_h, w_r1, NULL);
@@ -2297,7 +2252,7 @@ int zk_outer_link_verify(
     // 5. 验证Σ等式（在可验证的范围内）
     // 验证 Enc 等式的结构一致性
     // 由于 σ'' 隐藏，我们验证 T_enc 与 z_enc 的数学关系
-    GEN verify_lhs = nupow(pk2->pk, z_enc, NULL);  // pk2^z_enc
+    GEN verify_lhs = cl_pk_pow(pk2, z_enc, params);  // pk2^z_enc
     
     // 验证 T_enc 是否与重建的挑战一致
     // 这是一个简化的验证，真正的验证需要完整的类群等式
@@ -2977,9 +2932,9 @@ int zk_cldl_prove(zk_proof_cldl_t proof,
 		// f^r_2 = (q^2, Lq, (L - Delta_k) / 4)
 		GEN fr2 = Qfb0(sqri(params->q), mulii(L, params->q), shifti(subii(sqri(L), params->Delta_K), -2));
 
-		proof->t1 = gmul(nupow(public_key->pk, r1, NULL), fr2); // pk^r_1 \cdot f^r_2
+		proof->t1 = gmul(cl_pk_pow(public_key, r1, params), fr2); // pk^r_1 \cdot f^r_2
 		ec_mul_gen(proof->t2, rlc_r2);													// g^r_2
-		proof->t3 = nupow(params->g_q, r1, NULL);								// g_q^r_1
+		proof->t3 = cl_gq_pow(params, r1);								// g_q^r_1
 
 		const unsigned SERIALIZED_LEN = RLC_EC_SIZE_COMPRESSED + strlen(GENtostr(proof->t1)) + strlen(GENtostr(proof->t3));
 		uint8_t serialized[SERIALIZED_LEN];
@@ -3062,14 +3017,14 @@ int zk_cldl_prove_cond1_only(zk_proof_cldl_t proof,
         GEN fr2 = Qfb0(sqri(params->q), mulii(L, params->q), shifti(subii(sqri(L), params->Delta_K), -2));
 
         // 只生成条件1所需的承诺
-        proof->t1 = gmul(nupow(public_key->pk, r1, NULL), fr2); // pk^r_1 \cdot f^r_2
+        proof->t1 = gmul(cl_pk_pow(public_key, r1, params), fr2); // pk^r_1 \cdot f^r_2
         // t2 和 t3 仍然需要生成，因为挑战计算需要它们
         // 将GEN类型的r2转换为bn_t类型用于ec_mul_gen
         bn_t rlc_r2;
         bn_new(rlc_r2);
         bn_read_str(rlc_r2, GENtostr(r2), strlen(GENtostr(r2)), 10);
         ec_mul_gen(proof->t2, rlc_r2); // g^r_2
-        proof->t3 = nupow(params->g_q, r1, NULL); // g_q^r_1
+        proof->t3 = cl_gq_pow(params, r1); // g_q^r_1
 
         const unsigned SERIALIZED_LEN = RLC_EC_SIZE_COMPRESSED + strlen(GENtostr(proof->t1)) + strlen(GENtostr(proof->t3));
         uint8_t serialized[SERIALIZED_LEN];
@@ -3115,6 +3070,22 @@ int zk_cldl_prove_cond1_only(zk_proof_cldl_t proof,
 
 
 
+// zk_cldl_verify 的一个类群等式 lhs * base^k == rhs，作为线程池任务执行
+typedef struct {
+	GEN lhs, base, k;
+	GEN u1, fu2;                      // 右侧：条件 1 为 pk^u1 * f^u2，条件 3 为 g_q^u1（fu2 为 NULL）
+	cl_public_key_t public_key;
+	cl_params_t params;
+} zk_cldl_cond_arg_t;
+
+static GEN zk_cldl_cond_task(void *arg) {
+	const zk_cldl_cond_arg_t *a = (const zk_cldl_cond_arg_t *) arg;
+	GEN left = gmul(a->lhs, nupow(a->base, a->k, NULL));
+	GEN right = (a->fu2 != NULL) ? gmul(cl_pk_pow(a->public_key, a->u1, a->params), a->fu2)
+	                             : cl_gq_pow(a->params, a->u1);
+	return gequal(left, right) ? gen_1 : gen_0;
+}
+
 int zk_cldl_verify(const zk_proof_cldl_t proof,
 									 const ec_t Q,
 									 const cl_ciphertext_t ciphertext,
@@ -3182,32 +3153,29 @@ int zk_cldl_verify(const zk_proof_cldl_t proof,
 		// f^u_2 = (q^2, Lq, (L - Delta_k) / 4)
 		GEN fu2 = Qfb0(sqri(params->q), mulii(L, params->q), shifti(subii(sqri(L), params->Delta_K), -2));
 
-		ec_mul_gen(g_to_the_u2, rlc_u2);
-		ec_mul(Q_to_the_k, Q, rlc_k);
-		ec_add(t2_times_Q_to_the_k, proof->t2, Q_to_the_k);
-		ec_norm(t2_times_Q_to_the_k, t2_times_Q_to_the_k);
-
-	
-		
-		// 验证条件1: gmul(proof->t1, nupow(ciphertext->c2, k, NULL)) == gmul(nupow(public_key->pk, proof->u1, NULL), fu2)
-		GEN left1 = gmul(proof->t1, nupow(ciphertext->c2, k, NULL));
-		GEN right1 = gmul(nupow(public_key->pk, proof->u1, NULL), fu2);
-		int cond1 = gequal(left1, right1);
-		// printf("[ZK_CLDL_VERIFY_DEBUG] 条件1 (CL密文验证): %s\n", cond1 ? "通过" : "失败");
-		// printf("[ZK_CLDL_VERIFY_DEBUG] left1: %s\n", GENtostr(left1));
-		// printf("[ZK_CLDL_VERIFY_DEBUG] right1: %s\n", GENtostr(right1));
-		
-		// 验证条件2: g_to_the_u2 == t2_times_Q_to_the_k
-		int cond2 = (ec_cmp(g_to_the_u2, t2_times_Q_to_the_k) == RLC_EQ);
+		// 验证条件2: g_to_the_u2 == t2_times_Q_to_the_k（Q 为 NULL 时调用方不知道 g^x，跳过）
+		int cond2 = 1;
+		if (Q != NULL) {
+			ec_mul_gen(g_to_the_u2, rlc_u2);
+			ec_mul(Q_to_the_k, Q, rlc_k);
+			ec_add(t2_times_Q_to_the_k, proof->t2, Q_to_the_k);
+			ec_norm(t2_times_Q_to_the_k, t2_times_Q_to_the_k);
+			cond2 = (ec_cmp(g_to_the_u2, t2_times_Q_to_the_k) == RLC_EQ);
+		}
 		// printf("[ZK_CLDL_VERIFY_DEBUG] 条件2 (椭圆曲线验证): %s\n", cond2 ? "通过" : "失败");
-		
-		// 验证条件3: gmul(proof->t3, nupow(ciphertext->c1, k, NULL)) == nupow(params->g_q, proof->u1, NULL)
-		GEN left3 = gmul(proof->t3, nupow(ciphertext->c1, k, NULL));
-		GEN right3 = nupow(params->g_q, proof->u1, NULL);
-		int cond3 = gequal(left3, right3);
-		// printf("[ZK_CLDL_VERIFY_DEBUG] 条件3 (g_q验证): %s\n", cond3 ? "通过" : "失败");
-		// printf("[ZK_CLDL_VERIFY_DEBUG] left3: %s\n", GENtostr(left3));
-		// printf("[ZK_CLDL_VERIFY_DEBUG] right3: %s\n", GENtostr(right3));
+
+		// 两个类群等式互相独立，交给线程池并行验证（池未启动时在本线程依次执行）
+		// 条件1: gmul(proof->t1, nupow(ciphertext->c2, k, NULL)) == gmul(nupow(public_key->pk, proof->u1, NULL), fu2)
+		// 条件3: gmul(proof->t3, nupow(ciphertext->c1, k, NULL)) == g_q^u1
+		zk_cldl_cond_arg_t cond1_arg = { proof->t1, ciphertext->c2, k, proof->u1, fu2, public_key, params };
+		zk_cldl_cond_arg_t cond3_arg = { proof->t3, ciphertext->c1, k, proof->u1, NULL, public_key, params };
+		cl_worker_task_t conds[2] = {
+			{ .fn = zk_cldl_cond_task, .arg = &cond1_arg },
+			{ .fn = zk_cldl_cond_task, .arg = &cond3_arg },
+		};
+		cl_worker_run(conds, 2);
+		int cond1 = (conds[0].result != NULL && gequal1(conds[0].result));
+		int cond3 = (conds[1].result != NULL && gequal1(conds[1].result));
 
 		if (cond1 && cond2 && cond3) {
 			printf("[ZK_CLDL_VERIFY_DEBUG] 所有验证条件都通过!\n");
@@ -3282,7 +3250,7 @@ int zk_cldl_verify_cond1_only(const zk_proof_cldl_t proof,
 
         // 只验证条件1: gmul(proof->t1, nupow(ciphertext->c2, k, NULL)) == gmul(nupow(public_key->pk, proof->u1, NULL), fu2)
         GEN left1 = gmul(proof->t1, nupow(ciphertext->c2, k, NULL));
-        GEN right1 = gmul(nupow(public_key->pk, proof->u1, NULL), fu2);
+        GEN right1 = gmul(cl_pk_pow(public_key, proof->u1, params), fu2);
         int cond1 = gequal(left1, right1);
         
 
@@ -3302,6 +3270,195 @@ int zk_cldl_verify_cond1_only(const zk_proof_cldl_t proof,
     return result_status;
 }
 
+// CLDL 证明的 Fiat-Shamir 挑战 k，由 H(t1 || t2 || t3) 导出，与 zk_cldl_prove 一致
+static GEN zk_cldl_challenge(const zk_proof_cldl_t proof) {
+	bn_t rlc_k;
+	bn_null(rlc_k);
+	bn_new(rlc_k);
+
+	char *t1_str = GENtostr(proof->t1);
+	char *t3_str = GENtostr(proof->t3);
+	const size_t t1_len = strlen(t1_str);
+	const size_t t3_len = strlen(t3_str);
+	const unsigned SERIALIZED_LEN = RLC_EC_SIZE_COMPRESSED + t1_len + t3_len;
+	uint8_t serialized[SERIALIZED_LEN];
+	uint8_t hash[RLC_MD_LEN];
+
+	memcpy(serialized, (uint8_t *) t1_str, t1_len);
+	ec_write_bin(serialized + t1_len, RLC_EC_SIZE_COMPRESSED, proof->t2, 1);
+	memcpy(serialized + t1_len + RLC_EC_SIZE_COMPRESSED, (uint8_t *) t3_str, t3_len);
+	md_map(hash, serialized, SERIALIZED_LEN);
+	pari_free(t1_str);
+	pari_free(t3_str);
+
+	// 与 zk_cldl_prove / zk_cldl_verify 的截断方式逐位一致（soundness 2^-40）
+	bn_t rlc_soundness;
+	bn_null(rlc_soundness);
+	bn_new(rlc_soundness);
+	bn_set_2b(rlc_soundness, 40);
+	if (8 * RLC_MD_LEN > bn_bits(rlc_soundness)) {
+		unsigned len = RLC_CEIL(bn_bits(rlc_soundness), 8);
+		bn_read_bin(rlc_k, hash, len);
+		bn_rsh(rlc_k, rlc_k, 8 * RLC_MD_LEN - bn_bits(rlc_soundness));
+	} else {
+		bn_read_bin(rlc_k, hash, RLC_MD_LEN);
+	}
+	bn_mod(rlc_k, rlc_k, rlc_soundness);
+	bn_free(rlc_soundness);
+
+	const unsigned K_STR_LEN = bn_size_str(rlc_k, 10);
+	char k_str[K_STR_LEN];
+	bn_write_str(k_str, K_STR_LEN, rlc_k, 10);
+	bn_free(rlc_k);
+	return strtoi(k_str);
+}
+
+// f^m = (q^2, Lq, (L^2 - Delta_K) / 4)，L = m^(-1) mod q 取奇数代表
+static GEN cl_f_pow(const GEN m, const cl_params_t params) {
+	GEN L = Fp_inv(m, params->q);
+	if (!mpodd(L)) {
+		L = subii(L, params->q);
+	}
+	return Qfb0(sqri(params->q), mulii(L, params->q), shifti(subii(sqri(L), params->Delta_K), -2));
+}
+
+int zk_cldl_verify_batch(const zk_proof_cldl_t *proofs,
+												 ec_t *Qs,
+												 const cl_ciphertext_t *ciphertexts,
+												 size_t n,
+												 const cl_public_key_t *public_keys,
+												 const cl_params_t params,
+												 int *results) {
+	if (proofs == NULL || ciphertexts == NULL || public_keys == NULL || params == NULL) {
+		return RLC_ERR;
+	}
+	if (n == 0) {
+		return RLC_OK;
+	}
+
+	int batch_ok = 1;
+	pari_sp av = avma;
+	bn_t rlc_k, rlc_u2;
+	ec_t g_to_the_u2, t2_times_Q_to_the_k;
+
+	bn_null(rlc_k);
+	bn_null(rlc_u2);
+	ec_null(g_to_the_u2);
+	ec_null(t2_times_Q_to_the_k);
+
+	RLC_TRY {
+		bn_new(rlc_k);
+		bn_new(rlc_u2);
+		ec_new(g_to_the_u2);
+		ec_new(t2_times_Q_to_the_k);
+
+		// 随机线性组合：prod (t1_i * c2_i^k_i)^rho_i == prod_j pk_j^(sum_{pk_i = pk_j} rho_i u1_i) * f^(sum rho_i u2_i)
+		//               prod (t3_i * c1_i^k_i)^rho_i == g_q^(sum rho_i u1_i)
+		// rho_i 取 40 位奇数，阶为 2 的元素（类群中可由亏格理论构造）无法在组合中抵消
+		// 同一把公钥（按指针区分）的证明共用一次 pk 幂，g_q 幂与公钥无关，所有证明只做一次
+		GEN bases1 = cgetg(2 * n + 1, t_VEC), bases3 = cgetg(2 * n + 1, t_VEC);
+		GEN exps = cgetg(2 * n + 1, t_VEC);
+		GEN sum_u1 = gen_0, sum_u2 = gen_0;
+		GEN key_u1 = cgetg(n + 1, t_VEC);
+		cl_public_key_t keys[n];
+		size_t n_keys = 0;
+
+		for (size_t i = 0; i < n && batch_ok; i++) {
+			const zk_proof_cldl_t proof = proofs[i];
+			GEN k = zk_cldl_challenge(proof);
+
+			// 椭圆曲线条件 g^u2 == t2 * Q^k 代价很低，逐个验证
+			if (Qs != NULL) {
+				char *u2_str = GENtostr(proof->u2);
+				bn_read_str(rlc_u2, u2_str, strlen(u2_str), 10);
+				pari_free(u2_str);
+				char *k_str = GENtostr(k);
+				bn_read_str(rlc_k, k_str, strlen(k_str), 10);
+				pari_free(k_str);
+
+				ec_mul_gen(g_to_the_u2, rlc_u2);
+				ec_mul(t2_times_Q_to_the_k, Qs[i], rlc_k);
+				ec_add(t2_times_Q_to_the_k, proof->t2, t2_times_Q_to_the_k);
+				ec_norm(t2_times_Q_to_the_k, t2_times_Q_to_the_k);
+				if (ec_cmp(g_to_the_u2, t2_times_Q_to_the_k) != RLC_EQ) {
+					batch_ok = 0;
+					break;
+				}
+			}
+
+			uint8_t rho_bytes[5];
+			rand_bytes(rho_bytes, sizeof(rho_bytes));
+			ulong rho_word = 1;
+			for (size_t j = 0; j < sizeof(rho_bytes); j++) {
+				rho_word = (rho_word << 8) | rho_bytes[j];
+			}
+			GEN rho = utoi(rho_word | 1);
+			GEN k_rho = mulii(k, rho);
+
+			gel(bases1, 2 * i + 1) = proof->t1;
+			gel(bases1, 2 * i + 2) = ciphertexts[i]->c2;
+			gel(bases3, 2 * i + 1) = proof->t3;
+			gel(bases3, 2 * i + 2) = ciphertexts[i]->c1;
+			gel(exps, 2 * i + 1) = rho;
+			gel(exps, 2 * i + 2) = k_rho;
+			GEN rho_u1 = mulii(rho, proof->u1);
+			sum_u1 = addii(sum_u1, rho_u1);
+			sum_u2 = addii(sum_u2, mulii(rho, proof->u2));
+
+			size_t j = 0;
+			while (j < n_keys && keys[j] != public_keys[i]) j++;
+			if (j == n_keys) {
+				keys[n_keys++] = public_keys[i];
+				gel(key_u1, j + 1) = rho_u1;
+			} else {
+				gel(key_u1, j + 1) = addii(gel(key_u1, j + 1), rho_u1);
+			}
+		}
+
+		if (batch_ok) {
+			sum_u2 = modii(sum_u2, params->q);
+			// f^0 是单位元，cl_f_pow 无法构造；这种情况极少出现，直接交给逐个验证
+			if (signe(sum_u2) == 0) {
+				batch_ok = 0;
+			} else {
+				GEN rhs1 = cl_f_pow(sum_u2, params);
+				for (size_t j = 0; j < n_keys; j++) {
+					rhs1 = gmul(rhs1, cl_pk_pow(keys[j], gel(key_u1, j + 1), params));
+				}
+				// 左侧 2n 个底一次多重幂运算
+				batch_ok = gequal(cl_multiexp(bases1, exps), rhs1)
+				           && gequal(cl_multiexp(bases3, exps), cl_gq_pow(params, sum_u1));
+			}
+		}
+	} RLC_CATCH_ANY {
+		batch_ok = 0;
+	} RLC_FINALLY {
+		bn_free(rlc_k);
+		bn_free(rlc_u2);
+		ec_free(g_to_the_u2);
+		ec_free(t2_times_Q_to_the_k);
+	}
+	set_avma(av);
+
+	if (batch_ok) {
+		printf("[ZK_CLDL_VERIFY_BATCH] %zu 个证明批量验证通过\n", n);
+		if (results != NULL) {
+			for (size_t i = 0; i < n; i++) results[i] = RLC_OK;
+		}
+		return RLC_OK;
+	}
+
+	// 批量验证失败：逐个验证以定位无效的证明
+	printf("[ZK_CLDL_VERIFY_BATCH] 批量验证失败，逐个验证 %zu 个证明\n", n);
+	int result_status = RLC_OK;
+	for (size_t i = 0; i < n; i++) {
+		int ok = zk_cldl_verify(proofs[i], (Qs != NULL) ? Qs[i] : NULL, ciphertexts[i], public_keys[i], params);
+		if (results != NULL) results[i] = ok;
+		if (ok != RLC_OK) result_status = RLC_ERR;
+	}
+	return result_status;
+}
+
 int zk_dlog_prove(zk_proof_t proof, const ec_t h, const bn_t w) {
 	int result_status = RLC_OK;
 
@@ -3775,14 +3932,9 @@ int zk_malleability_verify(const zk_proof_malleability_t proof,
         bn_write_str(k_str, 1024, k, 10);
         GEN k_gen = strtoi(k_str);
         
-        GEN lhs1_c1 = nupow(ctx_alpha->c1, proof->u1, NULL);
-        GEN lhs1_c2 = nupow(ctx_alpha->c2, proof->u1, NULL);
-        GEN rhs1_c1 = nupow(ctx_alpha_beta->c1, k_gen, NULL);
-        GEN rhs1_c2 = nupow(ctx_alpha_beta->c2, k_gen, NULL);
-
         // 检查: t1 == ctx_alpha^u1 / ctx_alpha_beta^k
-        GEN chk1_c1 = gdiv(lhs1_c1, rhs1_c1);
-        GEN chk1_c2 = gdiv(lhs1_c2, rhs1_c2);
+        GEN chk1_c1 = cl_multiexp2(ctx_alpha->c1, proof->u1, ctx_alpha_beta->c1, negi(k_gen));
+        GEN chk1_c2 = cl_multiexp2(ctx_alpha->c2, proof->u1, ctx_alpha_beta->c2, negi(k_gen));
 
         // 对于QFB对象，需要使用特殊的比较方法
         int cmp1_c1 = (typ(proof->t1_c1) == t_QFB && typ(chk1_c1) == t_QFB) ? 
@@ -3795,14 +3947,9 @@ int zk_malleability_verify(const zk_proof_malleability_t proof,
             goto cleanup;
         }
 
-        GEN lhs2_c1 = nupow(auditor_ctx_alpha->c1, proof->u2, NULL);
-        GEN lhs2_c2 = nupow(auditor_ctx_alpha->c2, proof->u2, NULL);
-        GEN rhs2_c1 = nupow(auditor_ctx_alpha_beta->c1, k_gen, NULL);
-        GEN rhs2_c2 = nupow(auditor_ctx_alpha_beta->c2, k_gen, NULL);
-
         // 检查: t2 == auditor_ctx_alpha^u2 / auditor_ctx_alpha_beta^k
-        GEN chk2_c1 = gdiv(lhs2_c1, rhs2_c1);
-        GEN chk2_c2 = gdiv(lhs2_c2, rhs2_c2);
+        GEN chk2_c1 = cl_multiexp2(auditor_ctx_alpha->c1, proof->u2, auditor_ctx_alpha_beta->c1, negi(k_gen));
+        GEN chk2_c2 = cl_multiexp2(auditor_ctx_alpha->c2, proof->u2, auditor_ctx_alpha_beta->c2, negi(k_gen));
 
         // 对于QFB对象，需要使用特殊的比较方法
         int cmp2_c1 = (typ(proof->t2_c1) == t_QFB && typ(chk2_c1) == t_QFB) ? 
@@ -4215,12 +4362,18 @@ int zk_puzzle_verify(const zk_proof_puzzle_t proof,
   int result_status = RLC_OK;
   RLC_TRY {
     if (proof == NULL) RLC_THROW(ERR_CAUGHT);
-    // alpha 侧验证
-    if (zk_cldl_verify(&proof->alpha_proof, g_alpha, ctx_alpha, pk_tumbler, params) != RLC_OK) {
-      RLC_THROW(ERR_CAUGHT);
-    }
-    // r0 侧验证
-    if (zk_cldl_verify(&proof->r0_proof, g_r0, ctx_r0_aud, pk_auditor, params) != RLC_OK) {
+    // alpha 侧（pk_tumbler）与 r0 侧（pk_auditor）合并为一次批量验证
+    const zk_proof_cldl_t proofs[2] = { (zk_proof_cldl_t) &proof->alpha_proof, (zk_proof_cldl_t) &proof->r0_proof };
+    ec_t Qs[2];
+    ec_null(Qs[0]); ec_null(Qs[1]);
+    ec_new(Qs[0]); ec_new(Qs[1]);
+    ec_copy(Qs[0], g_alpha);
+    ec_copy(Qs[1], g_r0);
+    const cl_ciphertext_t cts[2] = { ctx_alpha, ctx_r0_aud };
+    const cl_public_key_t pks[2] = { pk_tumbler, pk_auditor };
+    int batch_rc = zk_cldl_verify_batch(proofs, Qs, cts, 2, pks, params, NULL);
+    ec_free(Qs[0]); ec_free(Qs[1]);
+    if (batch_rc != RLC_OK) {
       RLC_THROW(ERR_CAUGHT);
     }
   } RLC_CATCH_ANY {
@@ -4317,11 +4470,8 @@ int zk_comprehensive_puzzle_verify(const zk_proof_comprehensive_puzzle_t proof,
 
 // 综合谜题零知识证明序列化函数
 size_t zk_comprehensive_puzzle_serialized_size() {
-  // 使用长度前缀格式，需要为每个变长字段预留足够空间
-  // 2个CLDL证明（alpha_enc_proof 和 r0_enc_proof）
-  // 根据实际序列化大小，使用更精确的估计
-  // 增加缓冲区大小以防止溢出
-  return 2 * (4 * sizeof(size_t) + RLC_EC_SIZE_COMPRESSED + 3000); // 2个CLDL证明，每个预留3000字节用于变长数据
+  // 2个CLDL证明（alpha_enc_proof 和 r0_enc_proof），固定槽位
+  return 2 * cldl_proof_size_fixed();
 }
 
 int zk_comprehensive_puzzle_serialize(uint8_t *dst, size_t *written, const zk_proof_comprehensive_puzzle_t proof) {
@@ -4344,7 +4494,7 @@ int zk_comprehensive_puzzle_serialize(uint8_t *dst, size_t *written, const zk_pr
   return RLC_OK;
 }
 
-int zk_comprehensive_puzzle_deserialize(zk_proof_comprehensive_puzzle_t proof, const uint8_t *src, size_t *read) {
+int zk_comprehensive_puzzle_deserialize(zk_proof_comprehensive_puzzle_t proof, const uint8_t *src, size_t *read, const cl_params_t params) {
   if (!proof || !src || !read) return RLC_ERR;
   
   printf("[ZK_DESERIALIZE] 开始反序列化综合零知识证明...\n");
@@ -4353,13 +4503,17 @@ int zk_comprehensive_puzzle_deserialize(zk_proof_comprehensive_puzzle_t proof, c
   
   // 反序列化alpha_enc_proof
   printf("[ZK_DESERIALIZE] 反序列化alpha_enc_proof...\n");
-  read_cldl_fixed(&proof->alpha_enc_proof, src, &off);
+  read_cldl_fixed(&proof->alpha_enc_proof, src, &off, params);
   
   // 反序列化r0_enc_proof
   printf("[ZK_DESERIALIZE] 反序列化r0_enc_proof...\n");
-  read_cldl_fixed(&proof->r0_enc_proof, src, &off);
+  read_cldl_fixed(&proof->r0_enc_proof, src, &off, params);
   
   *read = off;
+  if (!cldl_fixed_complete(&proof->alpha_enc_proof) || !cldl_fixed_complete(&proof->r0_enc_proof)) {
+    printf("[ZK_DESERIALIZE] 证明编码格式错误\n");
+    return RLC_ERR;
+  }
   printf("[ZK_DESERIALIZE] 反序列化完成，总读取: %zu 字节\n", off);
   return RLC_OK;
 }
@@ -4456,27 +4610,31 @@ int zk_puzzle_relation_verify(const zk_proof_puzzle_relation_t proof,
     // 直接使用proof中已有的CLDL证明进行验证
     printf("[ZK_VERIFY_DEBUG] 开始验证CLDL证明...\n");
     
-    // 验证Tumbler部分CLDL证明
-    printf("[ZK_VERIFY_DEBUG] 验证Tumbler部分CLDL证明...\n");
-    if (zk_cldl_verify(proof->tumbler_proof, g_beta, enc_beta, pk_tumbler, params) != RLC_OK) {
-      printf("[ERROR] Tumbler部分CLDL证明验证失败!\n");
-      cl_ciphertext_free(enc_beta);
-      cl_ciphertext_free(enc_beta_aud);
-      ec_free(g_beta);
-      RLC_THROW(ERR_CAUGHT);
-    }
-    printf("[ZK_VERIFY_DEBUG] Tumbler部分CLDL证明验证成功!\n");
-    
-    // 验证Auditor部分CLDL证明
-    printf("[ZK_VERIFY_DEBUG] 验证Auditor部分CLDL证明...\n");
-    if (zk_cldl_verify(proof->auditor_proof, g_beta, enc_beta_aud, pk_auditor, params) != RLC_OK) {
-      printf("[ERROR] Auditor部分CLDL证明验证失败!\n");
-      cl_ciphertext_free(enc_beta);
-      cl_ciphertext_free(enc_beta_aud);
-      ec_free(g_beta);
-      RLC_THROW(ERR_CAUGHT);
+    // Tumbler 部分（pk_tumbler）与 Auditor 部分（pk_auditor）共用 g_beta，合并为一次批量验证；
+    // 批量失败时逐个验证，定位是哪一部分出错
+    printf("[ZK_VERIFY_DEBUG] 批量验证Tumbler/Auditor部分CLDL证明...\n");
+    {
+      const zk_proof_cldl_t proofs[2] = { proof->tumbler_proof, proof->auditor_proof };
+      ec_t Qs[2];
+      ec_null(Qs[0]); ec_null(Qs[1]);
+      ec_new(Qs[0]); ec_new(Qs[1]);
+      ec_copy(Qs[0], g_beta);
+      ec_copy(Qs[1], g_beta);
+      const cl_ciphertext_t cts[2] = { enc_beta, enc_beta_aud };
+      const cl_public_key_t pks[2] = { pk_tumbler, pk_auditor };
+      int results[2];
+      int batch_rc = zk_cldl_verify_batch(proofs, Qs, cts, 2, pks, params, results);
+      ec_free(Qs[0]); ec_free(Qs[1]);
+      if (batch_rc != RLC_OK) {
+        if (results[0] != RLC_OK) printf("[ERROR] Tumbler部分CLDL证明验证失败!\n");
+        if (results[1] != RLC_OK) printf("[ERROR] Auditor部分CLDL证明验证失败!\n");
+        cl_ciphertext_free(enc_beta);
+        cl_ciphertext_free(enc_beta_aud);
+        ec_free(g_beta);
+        RLC_THROW(ERR_CAUGHT);
+      }
     }
-    printf("[ZK_VERIFY_DEBUG] Auditor部分CLDL证明验证成功!\n");
+    printf("[ZK_VERIFY_DEBUG] Tumbler/Auditor部分CLDL证明验证成功!\n");
     
     // 清理资源
     cl_ciphertext_free(enc_beta);
@@ -4496,13 +4654,22 @@ int zk_puzzle_relation_verify(const zk_proof_puzzle_relation_t proof,
 
 // ========== 时间测量功能实现 ==========
 
+// Tumbler 多个工作线程会并发记录
+static pthread_mutex_t timing_lock = PTHREAD_MUTEX_INITIALIZER;
+
+void tiger_mt_warn(const char *fallback) {
+	printf("[WARN] RELIC 未以 MULTI=PTHREAD 编译或 PARI 未以 --mt=pthread 编译，%s\n", fallback);
+}
+
 void record_timing(const char* name, double duration_ms) {
+    pthread_mutex_lock(&timing_lock);
     if (timing_count < 50) {
         strncpy(timing_records[timing_count].name, name, 127);
         timing_records[timing_count].name[127] = '\0';
         timing_records[timing_count].duration_ms = duration_ms;
         timing_count++;
     }
+    pthread_mutex_unlock(&timing_lock);
 }
 
 double get_timer_value(const char* timer_name) {
@@ -4669,8 +4836,8 @@ void output_timing_to_excel(const char* filename) {
 
 // 序列化puzzle_relation证明的大小
 size_t zk_puzzle_relation_serialized_size() {
-  // 两个CLDL证明的大小，使用长度前缀格式
-  return 2 * (4 * sizeof(size_t) + RLC_EC_SIZE_COMPRESSED + 3000); // 每个CLDL证明预留3000字节用于变长数据
+  // 两个CLDL证明，固定槽位
+  return 2 * cldl_proof_size_fixed();
 }
 
 // 序列化puzzle_relation证明
@@ -4699,17 +4866,21 @@ int zk_puzzle_relation_serialize(uint8_t *dst, size_t *written, const zk_proof_p
 }
 
 // 反序列化puzzle_relation证明
-int zk_puzzle_relation_deserialize(zk_proof_puzzle_relation_t out, const uint8_t *src, size_t *read) {
+int zk_puzzle_relation_deserialize(zk_proof_puzzle_relation_t out, const uint8_t *src, size_t *read, const cl_params_t params) {
   if (!out || !src || !read) {
     printf("[ERROR] zk_puzzle_relation_deserialize: 输入参数为NULL\n");
     return RLC_ERR;
   }
   size_t off = 0;
   // 反序列化Tumbler CLDL证明
-  read_cldl_fixed(out->tumbler_proof, src, &off);
+  read_cldl_fixed(out->tumbler_proof, src, &off, params);
   // 反序列化Auditor CLDL证明
-  read_cldl_fixed(out->auditor_proof, src, &off);
+  read_cldl_fixed(out->auditor_proof, src, &off, params);
   *read = off;
+  if (!cldl_fixed_complete(out->tumbler_proof) || !cldl_fixed_complete(out->auditor_proof)) {
+    printf("[ERROR] zk_puzzle_relation_deserialize: 证明编码格式错误\n");
+    return RLC_ERR;
+  }
   return RLC_OK;
 }
 
@@ -0,0 +1,445 @@
+/**
+ * VSS 承诺归档实现
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "/home/zxx/Config/relic/include/relic.h"
+#include "vss_archive.h"
+
+#define VSS_RECORD_MAGIC       0x31435356u      // "VSC1"
+#define VSS_INDEX_MIN_CAPACITY 1024
+
+// 记录：头 | msgid | num_blocks 个块（每块 THRESHOLD 个压缩点）
+typedef struct {
+  uint32_t magic;
+  uint32_t length;                      // 整条记录长度
+  int64_t timestamp;
+  uint64_t secret_len;
+  uint32_t num_blocks;
+  uint16_t msgid_len;
+  uint16_t threshold;                   // 写入时的 THRESHOLD
+  uint32_t point_size;                  // 写入时的 RLC_EC_SIZE_COMPRESSED
+  uint32_t checksum;                    // 整条记录（本字段置 0）的 FNV-1a
+} vss_record_header_t;
+
+typedef struct {
+  int fd;
+  const uint8_t *base;                  // 只读映射
+  size_t mapped;
+  size_t scanned;                       // 已编入索引的完整记录长度
+} vss_segment_t;
+
+typedef struct {
+  uint64_t hash;
+  uint32_t segment;                     // 分段下标 + 1，0 表示空槽
+  uint32_t reserved;
+  uint64_t offset;
+} vss_index_slot_t;
+
+static struct {
+  pthread_mutex_t mutex;
+  int opened;
+  vss_segment_t segments[VSS_ARCHIVE_MAX_SEGMENTS];
+  size_t num_segments;
+  vss_index_slot_t *slots;
+  size_t capacity;
+  size_t count;
+  int lock_fd;
+  int write_fd;
+  size_t write_segment;
+  unsigned unsynced;
+} g_archive = {
+  .mutex = PTHREAD_MUTEX_INITIALIZER,
+  .lock_fd = -1,
+  .write_fd = -1,
+};
+
+static const size_t VSS_BLOCK_BYTES = sizeof(((vss_commitment_t *) 0)->commitments[0]);
+
+static uint64_t vss_hash(const char *msgid, size_t len) {
+  uint64_t h = 0xcbf29ce484222325ULL;
+  for (size_t i = 0; i < len; i++) {
+    h ^= (unsigned char) msgid[i];
+    h *= 0x100000001b3ULL;
+  }
+  return h;
+}
+
+static uint32_t vss_checksum(const uint8_t *record, size_t length) {
+  uint32_t h = 0x811c9dc5u;
+  for (size_t i = 0; i < length; i++) {
+    uint8_t b = record[i];
+    if (i >= offsetof(vss_record_header_t, checksum) &&
+        i < offsetof(vss_record_header_t, checksum) + sizeof(uint32_t)) {
+      b = 0;
+    }
+    h ^= b;
+    h *= 0x01000193u;
+  }
+  return h;
+}
+
+static void vss_segment_path(char *path, size_t size, size_t index) {
+  snprintf(path, size, "%s/segment-%06zu.vss", VSS_ARCHIVE_DIR, index);
+}
+
+// 校验 record 处的记录头（最多 avail 字节），verify 非 0 时同时校验整条记录的校验和；
+// 返回记录长度，不完整或损坏返回 0
+static size_t vss_record_check(const uint8_t *record, size_t avail, vss_record_header_t *hdr, int verify) {
+  if (avail < sizeof(*hdr)) return 0;
+  memcpy(hdr, record, sizeof(*hdr));
+  if (hdr->magic != VSS_RECORD_MAGIC || hdr->length > avail ||
+      hdr->threshold != THRESHOLD || hdr->point_size != RLC_EC_SIZE_COMPRESSED ||
+      hdr->num_blocks > MAX_BLOCKS || hdr->msgid_len >= MSG_ID_MAXLEN ||
+      hdr->length != sizeof(*hdr) + hdr->msgid_len + (size_t) hdr->num_blocks * VSS_BLOCK_BYTES) {
+    return 0;
+  }
+  if (verify && vss_checksum(record, hdr->length) != hdr->checksum) return 0;
+  return hdr->length;
+}
+
+// ================= 索引 =================
+
+static const uint8_t *vss_slot_record(const vss_index_slot_t *slot) {
+  return g_archive.segments[slot->segment - 1].base + slot->offset;
+}
+
+static int vss_slot_matches(const vss_index_slot_t *slot, const char *msgid, size_t len) {
+  vss_record_header_t hdr;
+  const uint8_t *record = vss_slot_record(slot);
+  memcpy(&hdr, record, sizeof(hdr));
+  return hdr.msgid_len == len && memcmp(record + sizeof(hdr), msgid, len) == 0;
+}
+
+static int vss_index_grow(void) {
+  size_t capacity = g_archive.capacity == 0 ? VSS_INDEX_MIN_CAPACITY : g_archive.capacity * 2;
+  vss_index_slot_t *slots = calloc(capacity, sizeof(vss_index_slot_t));
+  if (slots == NULL) return RLC_ERR;
+  // 旧表中的 msgid 互不相同，直接放入空槽
+  for (size_t i = 0; i < g_archive.capacity; i++) {
+    vss_index_slot_t *old = &g_archive.slots[i];
+    if (old->segment == 0) continue;
+    size_t j = (size_t) old->hash & (capacity - 1);
+    while (slots[j].segment != 0) j = (j + 1) & (capacity - 1);
+    slots[j] = *old;
+  }
+  free(g_archive.slots);
+  g_archive.slots = slots;
+  g_archive.capacity = capacity;
+  return RLC_OK;
+}
+
+static int vss_index_put(const char *msgid, size_t len, size_t segment, uint64_t offset) {
+  if ((g_archive.count + 1) * 2 > g_archive.capacity && vss_index_grow() != RLC_OK) return RLC_ERR;
+  uint64_t hash = vss_hash(msgid, len);
+  size_t mask = g_archive.capacity - 1;
+  for (size_t i = (size_t) hash & mask;; i = (i + 1) & mask) {
+    vss_index_slot_t *slot = &g_archive.slots[i];
+    if (slot->segment == 0) {
+      g_archive.count++;
+    } else if (slot->hash != hash || !vss_slot_matches(slot, msgid, len)) {
+      continue;
+    }
+    slot->hash = hash;
+    slot->segment = (uint32_t) segment + 1;
+    slot->offset = offset;
+    return RLC_OK;
+  }
+}
+
+static const vss_index_slot_t *vss_index_get(const char *msgid, size_t len) {
+  if (g_archive.capacity == 0) return NULL;
+  uint64_t hash = vss_hash(msgid, len);
+  size_t mask = g_archive.capacity - 1;
+  for (size_t i = (size_t) hash & mask; g_archive.slots[i].segment != 0; i = (i + 1) & mask) {
+    const vss_index_slot_t *slot = &g_archive.slots[i];
+    if (slot->hash == hash && vss_slot_matches(slot, msgid, len)) return slot;
+  }
+  return NULL;
+}
+
+// ================= 分段 =================
+
+// 映射覆盖到当前文件长度，返回可安全访问的字节数
+static size_t vss_segment_map(vss_segment_t *seg) {
+  struct stat st;
+  if (fstat(seg->fd, &st) != 0) return 0;
+  size_t size = (size_t) st.st_size;
+  if (size > seg->mapped) {
+    void *base = mmap(NULL, size, PROT_READ, MAP_SHARED, seg->fd, 0);
+    if (base == MAP_FAILED) return seg->mapped < size ? seg->mapped : size;
+    if (seg->base != NULL) munmap((void *) seg->base, seg->mapped);
+    seg->base = base;
+    seg->mapped = size;
+  }
+  return size < seg->mapped ? size : seg->mapped;
+}
+
+// 把分段中新出现的完整记录编入索引，返回文件中未能解析的尾部字节数
+// 扫描只看记录头；写到一半的记录只可能在文件末尾，因此只对末尾那条校验整条记录，
+// 其余记录在读取时校验，冷启动不必读完整个归档
+static size_t vss_segment_scan(size_t index) {
+  vss_segment_t *seg = &g_archive.segments[index];
+  size_t avail = vss_segment_map(seg);
+  vss_record_header_t hdr;
+
+  while (seg->scanned < avail) {
+    size_t length = vss_record_check(seg->base + seg->scanned, avail - seg->scanned, &hdr, 0);
+    if (length == 0) break;
+    if (seg->scanned + length == avail &&
+        vss_record_check(seg->base + seg->scanned, avail - seg->scanned, &hdr, 1) == 0) {
+      break;
+    }
+    if (vss_index_put((const char *) seg->base + seg->scanned + sizeof(hdr), hdr.msgid_len,
+                      index, seg->scanned) != RLC_OK) {
+      break;
+    }
+    seg->scanned += length;
+  }
+  return avail - seg->scanned;
+}
+
+static int vss_segment_add(size_t index, int create) {
+  char path[256];
+  if (index >= VSS_ARCHIVE_MAX_SEGMENTS) return RLC_ERR;
+  vss_segment_path(path, sizeof(path), index);
+  int fd = open(path, create ? O_RDONLY | O_CREAT : O_RDONLY, 0644);
+  if (fd < 0) return RLC_ERR;
+  vss_segment_t *seg = &g_archive.segments[index];
+  memset(seg, 0, sizeof(*seg));
+  seg->fd = fd;
+  g_archive.num_segments = index + 1;
+  return RLC_OK;
+}
+
+// 增量扫描：先补扫最后一个已知分段，再发现其它进程新开的分段
+static void vss_archive_refresh(void) {
+  if (g_archive.num_segments == 0 && vss_segment_add(0, 0) != RLC_OK) return;
+  for (;;) {
+    vss_segment_scan(g_archive.num_segments - 1);
+    if (vss_segment_add(g_archive.num_segments, 0) != RLC_OK) break;
+  }
+}
+
+static int vss_archive_open_locked(void) {
+  if (g_archive.opened) return RLC_OK;
+  if (mkdir(VSS_ARCHIVE_DIR, 0755) != 0 && errno != EEXIST) {
+    fprintf(stderr, "[VSS][Archive] 无法创建目录 %s: %s\n", VSS_ARCHIVE_DIR, strerror(errno));
+    return RLC_ERR;
+  }
+  char path[256];
+  snprintf(path, sizeof(path), "%s/archive.lock", VSS_ARCHIVE_DIR);
+  g_archive.lock_fd = open(path, O_RDWR | O_CREAT, 0644);
+  if (g_archive.lock_fd < 0) {
+    fprintf(stderr, "[VSS][Archive] 无法打开锁文件 %s: %s\n", path, strerror(errno));
+    return RLC_ERR;
+  }
+  g_archive.opened = 1;
+  vss_archive_refresh();
+  if (g_archive.count > 0) {
+    printf("[VSS][Archive] 已编入索引 %zu 个承诺（%zu 个分段）\n", g_archive.count, g_archive.num_segments);
+  }
+  return RLC_OK;
+}
+
+// 分段中未编入索引的尾部字节的性质
+enum {
+  VSS_TAIL_CLEAN,                       // 没有尾部
+  VSS_TAIL_TORN,                        // 上一个写者没写完的最后一条记录，可以截掉
+  VSS_TAIL_CORRUPT,                     // 不是写到一半的记录，截掉会丢数据
+  VSS_TAIL_UNINDEXED,                   // 记录完整但索引内存不足，未能编入
+};
+
+// 只有两种情况算写到一半：记录头声明的长度超过剩余字节（含头本身没写完、已写出的是魔数前缀），
+// 或者恰好到文件末尾的最后一条记录校验和不符；其它情况都是损坏
+static int vss_segment_tail(const vss_segment_t *seg, size_t avail) {
+  const uint8_t *record = seg->base + seg->scanned;
+  size_t remaining = avail - seg->scanned;
+  vss_record_header_t hdr;
+
+  if (remaining == 0) return VSS_TAIL_CLEAN;
+  if (remaining < sizeof(hdr)) {
+    const uint32_t magic = VSS_RECORD_MAGIC;
+    size_t n = remaining < sizeof(magic) ? remaining : sizeof(magic);
+    return memcmp(record, &magic, n) == 0 ? VSS_TAIL_TORN : VSS_TAIL_CORRUPT;
+  }
+  if (vss_record_check(record, SIZE_MAX, &hdr, 0) == 0) return VSS_TAIL_CORRUPT;
+  if (hdr.length > remaining) return VSS_TAIL_TORN;
+  if (hdr.length == remaining) {
+    return vss_record_check(record, remaining, &hdr, 1) == 0 ? VSS_TAIL_TORN : VSS_TAIL_UNINDEXED;
+  }
+  return VSS_TAIL_UNINDEXED;
+}
+
+// 持有 flock 时调用：选定可追加的分段并截掉上一个写者留下的半条记录；
+// 尾部不是半条记录时拒绝追加，保留现场
+static int vss_archive_prepare_write(void) {
+  vss_archive_refresh();
+  size_t active = g_archive.num_segments > 0 ? g_archive.num_segments - 1 : 0;
+  if (g_archive.num_segments == 0 || g_archive.segments[active].scanned >= VSS_ARCHIVE_SEGMENT_MAX) {
+    if (g_archive.num_segments > 0) active++;
+    if (vss_segment_add(active, 1) != RLC_OK) return RLC_ERR;
+  }
+
+  if (g_archive.write_fd < 0 || g_archive.write_segment != active) {
+    char path[256];
+    vss_segment_path(path, sizeof(path), active);
+    if (g_archive.write_fd >= 0) {
+      fdatasync(g_archive.write_fd);
+      close(g_archive.write_fd);
+    }
+    g_archive.write_fd = open(path, O_WRONLY);
+    if (g_archive.write_fd < 0) return RLC_ERR;
+    g_archive.write_segment = active;
+    g_archive.unsynced = 0;
+  }
+
+  size_t tail = vss_segment_scan(active);
+  if (tail == 0) return RLC_OK;
+  vss_segment_t *seg = &g_archive.segments[active];
+  switch (vss_segment_tail(seg, seg->scanned + tail)) {
+    case VSS_TAIL_TORN:
+      fprintf(stderr, "[VSS][Archive] 分段 %zu 尾部记录不完整（%zu 字节），已截断\n", active, tail);
+      return ftruncate(g_archive.write_fd, (off_t) seg->scanned) == 0 ? RLC_OK : RLC_ERR;
+    case VSS_TAIL_UNINDEXED:
+      fprintf(stderr, "[VSS][Archive] 分段 %zu 偏移 %zu 处的记录未能编入索引，暂不追加\n", active, seg->scanned);
+      return RLC_ERR;
+    default:
+      fprintf(stderr, "[VSS][Archive] 分段 %zu 偏移 %zu 处损坏（其后 %zu 字节不是写到一半的记录），拒绝追加\n",
+              active, seg->scanned, tail);
+      return RLC_ERR;
+  }
+}
+
+// ================= 接口 =================
+
+int vss_archive_put(const vss_commitment_t *commitment) {
+  if (commitment == NULL || commitment->num_blocks > MAX_BLOCKS) return RLC_ERR;
+  size_t msgid_len = strnlen(commitment->msgid, MSG_ID_MAXLEN - 1);
+  size_t length = sizeof(vss_record_header_t) + msgid_len + commitment->num_blocks * VSS_BLOCK_BYTES;
+
+  uint8_t *record = malloc(length);
+  if (record == NULL) return RLC_ERR;
+  vss_record_header_t hdr = { 0 };
+  hdr.magic = VSS_RECORD_MAGIC;
+  hdr.length = (uint32_t) length;
+  hdr.timestamp = (int64_t) commitment->timestamp;
+  hdr.secret_len = commitment->secret_len;
+  hdr.num_blocks = (uint32_t) commitment->num_blocks;
+  hdr.msgid_len = (uint16_t) msgid_len;
+  hdr.threshold = THRESHOLD;
+  hdr.point_size = RLC_EC_SIZE_COMPRESSED;
+  memcpy(record, &hdr, sizeof(hdr));
+  memcpy(record + sizeof(hdr), commitment->msgid, msgid_len);
+  memcpy(record + sizeof(hdr) + msgid_len, commitment->commitments, commitment->num_blocks * VSS_BLOCK_BYTES);
+  hdr.checksum = vss_checksum(record, length);
+  memcpy(record + offsetof(vss_record_header_t, checksum), &hdr.checksum, sizeof(hdr.checksum));
+
+  int result = RLC_ERR;
+  pthread_mutex_lock(&g_archive.mutex);
+  if (vss_archive_open_locked() == RLC_OK && flock(g_archive.lock_fd, LOCK_EX) == 0) {
+    if (vss_archive_prepare_write() == RLC_OK) {
+      vss_segment_t *seg = &g_archive.segments[g_archive.write_segment];
+      size_t written = 0;
+      while (written < length) {
+        ssize_t n = pwrite(g_archive.write_fd, record + written, length - written, (off_t) (seg->scanned + written));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        written += (size_t) n;
+      }
+      if (written == length) {
+        result = RLC_OK;
+        if (++g_archive.unsynced >= VSS_ARCHIVE_SYNC_BATCH) {
+          fdatasync(g_archive.write_fd);
+          g_archive.unsynced = 0;
+        }
+      } else {
+        fprintf(stderr, "[VSS][Archive] 写入失败: %s\n", strerror(errno));
+        if (ftruncate(g_archive.write_fd, (off_t) seg->scanned) != 0) {
+          fprintf(stderr, "[VSS][Archive] 回滚失败: %s\n", strerror(errno));
+        }
+      }
+      vss_segment_scan(g_archive.write_segment);
+    }
+    flock(g_archive.lock_fd, LOCK_UN);
+  }
+  pthread_mutex_unlock(&g_archive.mutex);
+  free(record);
+  return result;
+}
+
+int vss_archive_get(const char *msgid, vss_commitment_t *commitment) {
+  if (msgid == NULL || commitment == NULL) return RLC_ERR;
+  size_t len = strnlen(msgid, MSG_ID_MAXLEN);
+  if (len >= MSG_ID_MAXLEN) return RLC_ERR;
+
+  int result = RLC_ERR;
+  pthread_mutex_lock(&g_archive.mutex);
+  if (vss_archive_open_locked() == RLC_OK) {
+    vss_archive_refresh();
+    const vss_index_slot_t *slot = vss_index_get(msgid, len);
+    vss_record_header_t hdr;
+    const uint8_t *record = slot != NULL ? vss_slot_record(slot) : NULL;
+    const vss_segment_t *seg = slot != NULL ? &g_archive.segments[slot->segment - 1] : NULL;
+    if (record != NULL && vss_record_check(record, seg->scanned - slot->offset, &hdr, 1) == 0) {
+      fprintf(stderr, "[VSS][Archive] 分段 %u 偏移 %llu 处的记录校验失败 (msgid=%s)\n",
+              slot->segment - 1, (unsigned long long) slot->offset, msgid);
+      record = NULL;
+    }
+    if (record != NULL) {
+      memcpy(commitment->msgid, msgid, len);
+      commitment->msgid[len] = '\0';
+      commitment->secret_len = (size_t) hdr.secret_len;
+      commitment->num_blocks = hdr.num_blocks;
+      commitment->timestamp = (time_t) hdr.timestamp;
+      memcpy(commitment->commitments, record + sizeof(hdr) + hdr.msgid_len, hdr.num_blocks * VSS_BLOCK_BYTES);
+      result = RLC_OK;
+    }
+  }
+  pthread_mutex_unlock(&g_archive.mutex);
+  return result;
+}
+
+int vss_archive_stats(size_t *segments, size_t *entries) {
+  pthread_mutex_lock(&g_archive.mutex);
+  int result = vss_archive_open_locked();
+  if (result == RLC_OK) vss_archive_refresh();
+  if (segments != NULL) *segments = g_archive.num_segments;
+  if (entries != NULL) *entries = g_archive.count;
+  pthread_mutex_unlock(&g_archive.mutex);
+  return result;
+}
+
+void vss_archive_close(void) {
+  pthread_mutex_lock(&g_archive.mutex);
+  if (g_archive.write_fd >= 0) {
+    fdatasync(g_archive.write_fd);
+    close(g_archive.write_fd);
+  }
+  for (size_t i = 0; i < g_archive.num_segments; i++) {
+    vss_segment_t *seg = &g_archive.segments[i];
+    if (seg->base != NULL) munmap((void *) seg->base, seg->mapped);
+    if (seg->fd >= 0) close(seg->fd);
+  }
+  if (g_archive.lock_fd >= 0) close(g_archive.lock_fd);
+  free(g_archive.slots);
+  g_archive.opened = 0;
+  g_archive.num_segments = 0;
+  g_archive.slots = NULL;
+  g_archive.capacity = 0;
+  g_archive.count = 0;
+  g_archive.lock_fd = -1;
+  g_archive.write_fd = -1;
+  g_archive.unsynced = 0;
+  pthread_mutex_unlock(&g_archive.mutex);
+}
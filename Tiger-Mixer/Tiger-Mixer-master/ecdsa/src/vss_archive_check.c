@@ -0,0 +1,140 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "/home/zxx/Config/relic/include/relic.h"
+#include "vss_archive.h"
+#include "check.h"
+
+// VSS 承诺归档的尾部修复检查：只有写到一半的最后一条记录（头声明的长度超过剩余字节，
+// 或到文件末尾的最后一条记录校验和不符）会被截掉；其它尾部视为损坏，拒绝追加且不改动文件。
+// 用法：vss_archive_check [工作目录]（在其下新建临时目录），任何一项不符合预期时返回非 0
+
+#define SEGMENT_PATH VSS_ARCHIVE_DIR "/segment-000000.vss"
+
+static void make_commitment(vss_commitment_t *commitment, int i) {
+  memset(commitment, 0, sizeof(*commitment));
+  snprintf(commitment->msgid, sizeof(commitment->msgid), "0x%064x", 0xa000 + i);
+  commitment->secret_len = 32;
+  commitment->num_blocks = 2;
+  commitment->timestamp = 1700000000 + i;
+  memset(commitment->commitments, 0x40 + i, 2 * sizeof(commitment->commitments[0]));
+}
+
+static int put(int i) {
+  vss_commitment_t commitment;
+  make_commitment(&commitment, i);
+  return vss_archive_put(&commitment);
+}
+
+// 重新打开归档后读取 [0, n) 的承诺并与写入的内容比较
+static int get_range(int n) {
+  vss_commitment_t expected, got;
+  vss_archive_close();
+  for (int i = 0; i < n; i++) {
+    make_commitment(&expected, i);
+    if (vss_archive_get(expected.msgid, &got) != RLC_OK || got.num_blocks != expected.num_blocks ||
+        memcmp(got.commitments, expected.commitments, 2 * sizeof(got.commitments[0])) != 0) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+static long file_size(const char *path) {
+  FILE *fp = fopen(path, "rb");
+  if (fp == NULL) return -1;
+  fseek(fp, 0, SEEK_END);
+  long size = ftell(fp);
+  fclose(fp);
+  return size;
+}
+
+static int append_raw(const uint8_t *data, size_t len) {
+  FILE *fp = fopen(SEGMENT_PATH, "ab");
+  if (fp == NULL) return 0;
+  int ok = fwrite(data, 1, len, fp) == len;
+  fclose(fp);
+  return ok;
+}
+
+// 读出分段文件末尾 len 字节（最后一条记录）
+static int read_tail(uint8_t *out, size_t len) {
+  FILE *fp = fopen(SEGMENT_PATH, "rb");
+  if (fp == NULL) return 0;
+  int ok = fseek(fp, -(long) len, SEEK_END) == 0 && fread(out, 1, len, fp) == len;
+  fclose(fp);
+  return ok;
+}
+
+int main(int argc, char *argv[]) {
+  char dir[512];
+  snprintf(dir, sizeof(dir), "%s/vss_archive_check_XXXXXX", (argc > 1) ? argv[1] : "/tmp");
+  if (mkdtemp(dir) == NULL || chdir(dir) != 0) {
+    fprintf(stderr, "无法创建工作目录 %s\n", dir);
+    return 1;
+  }
+
+  printf("追加与读取:\n");
+  EXPECT(put(0) == RLC_OK && put(1) == RLC_OK, "写入 2 条记录");
+  long two = file_size(SEGMENT_PATH);
+  EXPECT(put(2) == RLC_OK, "写入第 3 条记录");
+  long three = file_size(SEGMENT_PATH);
+  size_t record_len = (size_t) (three - two);
+  uint8_t *record = malloc(record_len);
+  EXPECT(record != NULL && read_tail(record, record_len), "读出最后一条记录的字节");
+  EXPECT(get_range(3), "重新打开后 3 条都能读取");
+  if (record == NULL) return 1;
+
+  printf("写到一半的尾部（截断后继续追加）:\n");
+  vss_archive_close();
+  EXPECT(append_raw(record, record_len / 2), "追加半条记录");
+  EXPECT(put(3) == RLC_OK, "追加时截掉半条记录");
+  long four = file_size(SEGMENT_PATH);
+  EXPECT(four == three + (long) record_len, "文件长度为 4 条完整记录");
+
+  vss_archive_close();
+  EXPECT(append_raw(record, 6), "追加只写了 6 字节的记录头（魔数前缀）");
+  EXPECT(put(4) == RLC_OK, "追加时截掉半个记录头");
+  long five = file_size(SEGMENT_PATH);
+  EXPECT(five == four + (long) record_len, "文件长度为 5 条完整记录");
+
+  vss_archive_close();
+  record[record_len - 1] ^= 0x01;
+  EXPECT(append_raw(record, record_len), "追加一条长度完整但校验和不符的最后记录");
+  record[record_len - 1] ^= 0x01;
+  EXPECT(put(5) == RLC_OK, "追加时截掉校验和不符的最后记录");
+  long six = file_size(SEGMENT_PATH);
+  EXPECT(six == five + (long) record_len, "文件长度为 6 条完整记录");
+  EXPECT(get_range(6), "6 条都能读取");
+
+  printf("损坏的尾部（拒绝追加）:\n");
+  vss_archive_close();
+  uint8_t garbage[96];
+  memset(garbage, 0xab, sizeof(garbage));
+  EXPECT(append_raw(garbage, sizeof(garbage)), "追加 96 字节魔数不符的数据");
+  EXPECT(put(6) == RLC_ERR, "拒绝追加");
+  EXPECT(file_size(SEGMENT_PATH) == six + (long) sizeof(garbage), "文件未被截断");
+  EXPECT(get_range(6), "已有记录仍能读取");
+
+  vss_archive_close();
+  EXPECT(truncate(SEGMENT_PATH, six) == 0, "去掉损坏数据");
+  // 记录头第 24 字节起是 num_blocks：改为 3 后与长度字段不符，记录头本身无效
+  record[24] ^= 0x01;
+  EXPECT(append_raw(record, record_len), "追加一条记录头字段自相矛盾的记录");
+  record[24] ^= 0x01;
+  EXPECT(put(6) == RLC_ERR && file_size(SEGMENT_PATH) == six + (long) record_len, "拒绝追加且文件未被截断");
+
+  vss_archive_close();
+  EXPECT(truncate(SEGMENT_PATH, six) == 0 && put(6) == RLC_OK, "修复后恢复追加");
+  EXPECT(get_range(7), "7 条都能读取");
+
+  vss_archive_close();
+  free(record);
+  unlink(SEGMENT_PATH);
+  unlink(VSS_ARCHIVE_DIR "/archive.lock");
+  rmdir(VSS_ARCHIVE_DIR);
+  if (chdir("..") == 0) rmdir(dir);
+
+  return check_summary();
+}